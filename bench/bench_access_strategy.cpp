@@ -0,0 +1,94 @@
+// Mixed workload: one thread does point lookups on a hot set that fits in the pool while another
+// scans the whole table, once with plain FetchPage and once with a BULK_READ ring. Reports the
+// hot-set hit rate seen by the lookup thread for each replacement policy.
+//
+//   bench/bin/bench_access_strategy [--pages=16384] [--frames=1024] [--hot=896] [--scans=2]
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BENCH_FILE = "data/bench_access_strategy.db";
+
+int main(int argc, char **argv)
+{
+    uint64_t pages = ArgOr(argc, argv, "pages", 16384);
+    int frames = static_cast<int>(ArgOr(argc, argv, "frames", 1024));
+    uint64_t hot = ArgOr(argc, argv, "hot", 896);
+    uint64_t scans = ArgOr(argc, argv, "scans", 2);
+
+    std::remove(BENCH_FILE);
+    DiskManager dm(BENCH_FILE);
+    {
+        Page frame;
+        for (uint64_t i = 0; i < pages; i++)
+        {
+            page_id_t pid = dm.AllocatePage();
+            snprintf(frame.GetData(), PAGE_SIZE, "page %lld", (long long)pid);
+            dm.WritePage(pid, frame.GetData());
+        }
+    }
+    std::printf("pages=%llu frames=%d hot=%llu scans=%llu\n", (unsigned long long)pages, frames,
+                (unsigned long long)hot, (unsigned long long)scans);
+    std::printf("%-8s %-10s %12s %12s %12s\n", "policy", "strategy", "lookups", "hot hit %", "scan MiB/s");
+
+    for (ReplacerPolicy policy : {ReplacerPolicy::LRU, ReplacerPolicy::CLOCK, ReplacerPolicy::LRU_K, ReplacerPolicy::ARC})
+    {
+        for (bool ring : {false, true})
+        {
+            buffer_pool pool(frames, &dm, policy);
+            for (uint64_t i = 0; i < hot; i++)
+            {
+                pool.FetchPage(static_cast<page_id_t>(i));
+                pool.UnpinPage(static_cast<page_id_t>(i), false);
+            }
+
+            std::atomic<bool> done{false};
+            uint64_t lookups = 0;
+            uint64_t hits = 0;
+            std::thread lookup([&]()
+                               {
+                Rng rng(42);
+                volatile char sink = 0;
+                while (!done.load(std::memory_order_relaxed))
+                {
+                    page_id_t pid = static_cast<page_id_t>(rng.Uniform(hot));
+                    hits += pool.IsResident(pid) ? 1 : 0;
+                    Page *page = pool.FetchPage(pid);
+                    sink = sink + page->GetData()[0];
+                    pool.UnpinPage(pid, false);
+                    lookups++;
+                } });
+
+            BufferAccessStrategy strategy(AccessType::BULK_READ);
+            volatile char sink = 0;
+            Timer timer;
+            for (uint64_t s = 0; s < scans; s++)
+            {
+                for (uint64_t i = hot; i < pages; i++)
+                {
+                    page_id_t pid = static_cast<page_id_t>(i);
+                    Page *page = pool.FetchPage(pid, ring ? &strategy : nullptr);
+                    sink = sink + page->GetData()[0];
+                    pool.UnpinPage(pid, false);
+                }
+            }
+            double seconds = timer.Seconds();
+            done = true;
+            lookup.join();
+
+            std::printf("%-8s %-10s %12llu %12.1f %12.1f\n", ReplacerPolicyName(policy), ring ? "bulk-read" : "none",
+                        (unsigned long long)lookups, lookups == 0 ? 0.0 : 100.0 * hits / lookups,
+                        scans * (pages - hot) * PAGE_SIZE / 1048576.0 / seconds);
+        }
+    }
+
+    std::remove(BENCH_FILE);
+    return 0;
+}
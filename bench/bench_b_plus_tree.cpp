@@ -0,0 +1,96 @@
+// Point lookups and range scans on a BPlusTree of int64 keys that is larger than its buffer pool,
+// so inner levels stay cached while leaves miss. Keys are inserted in shuffled order, then probed
+// uniformly at random; range scans start at a random key and walk --range keys along the leaf
+// chain.
+//
+//   bench/bin/bench_b_plus_tree [--keys=10000000] [--frames=4096] [--lookups=1000000] [--ranges=10000]
+//                               [--range=1000]
+
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+#include "disk_manager.h"
+#include "b_plus_tree.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BENCH_FILE = "data/bench_b_plus_tree.db";
+
+int main(int argc, char **argv)
+{
+    uint64_t keys = ArgOr(argc, argv, "keys", 10000000);
+    uint64_t frames = ArgOr(argc, argv, "frames", 4096);
+    uint64_t lookups = ArgOr(argc, argv, "lookups", 1000000);
+    uint64_t ranges = ArgOr(argc, argv, "ranges", 10000);
+    uint64_t range = ArgOr(argc, argv, "range", 1000);
+
+    std::remove(BENCH_FILE);
+    DiskManager dm(BENCH_FILE);
+    buffer_pool pool(static_cast<int>(frames), &dm);
+    BPlusTree<int64_t, Int64Comparator> tree(&pool);
+
+    std::vector<int64_t> order(keys);
+    for (uint64_t i = 0; i < keys; i++)
+    {
+        order[i] = static_cast<int64_t>(i);
+    }
+    Rng rng(11);
+    for (uint64_t i = keys; i > 1; i--)
+    {
+        std::swap(order[i - 1], order[rng.Uniform(i)]);
+    }
+
+    Timer insert_timer;
+    for (int64_t key : order)
+    {
+        tree.Insert(key, RID{key, 0});
+    }
+    double insert_s = insert_timer.Seconds();
+    std::vector<int64_t>().swap(order);
+
+    std::printf("keys=%llu frames=%llu height=%d pages=%lld (%.0f MiB index, %.0f MiB pool)\n",
+                (unsigned long long)keys, (unsigned long long)frames, tree.GetHeight(), (long long)dm.GetNumPages(),
+                dm.GetNumPages() * (double)PAGE_SIZE / 1048576.0, frames * (double)PAGE_SIZE / 1048576.0);
+    std::printf("%-12s %14s %14s\n", "operation", "ops/s", "keys/s");
+    std::printf("%-12s %14.0f %14.0f\n", "insert", keys / insert_s, keys / insert_s);
+
+    Timer lookup_timer;
+    uint64_t found = 0;
+    for (uint64_t i = 0; i < lookups; i++)
+    {
+        RID rid;
+        found += tree.GetValue(static_cast<int64_t>(rng.Uniform(keys)), &rid);
+    }
+    double lookup_s = lookup_timer.Seconds();
+    std::printf("%-12s %14.0f %14.0f\n", "lookup", lookups / lookup_s, found / lookup_s);
+
+    Timer range_timer;
+    uint64_t scanned = 0;
+    for (uint64_t i = 0; i < ranges; i++)
+    {
+        uint64_t n = 0;
+        for (auto it = tree.Begin(static_cast<int64_t>(rng.Uniform(keys))); it.Valid() && n < range; it.Next())
+        {
+            n++;
+        }
+        scanned += n;
+    }
+    double range_s = range_timer.Seconds();
+    std::printf("%-12s %14.0f %14.0f\n", "range", ranges / range_s, scanned / range_s);
+
+    Timer scan_timer;
+    int64_t checksum = 0;
+    for (auto it = tree.Begin(); it.Valid(); it.Next())
+    {
+        checksum += it.GetValue().page_id;
+    }
+    double scan_s = scan_timer.Seconds();
+    std::printf("%-12s %14.0f %14.0f  checksum=%lld\n", "full scan", 1 / scan_s, keys / scan_s, (long long)checksum);
+
+    std::remove(BENCH_FILE);
+    return 0;
+}
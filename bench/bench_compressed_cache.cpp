@@ -0,0 +1,153 @@
+// Compressed second-tier cache versus spending the same memory on more buffer pool frames. The
+// file holds table-like pages (fixed-size records of sequential keys, small integers and words
+// from a small vocabulary, some free space), which is what the tier is for; a Zipfian read
+// workload runs against three setups of equal or smaller memory:
+//   primary  --pool_pct of the file in frames
+//   +tier    the same frames plus a BasicCompressedCache of --tier_pct of the file's bytes
+//   +frames  the same frames plus --tier_pct of the file's bytes as extra frames
+// Each setup is warmed with --ops reads, then measured over --ops more. "pages" is how many
+// pages the setup holds in memory at the end, frames plus tier entries (a page can be in both).
+// With --direct=1 misses pay a real device read rather than a copy from the OS page cache.
+//
+//   bench/bin/bench_compressed_cache [--pages=32768] [--pool_pct=5] [--tier_pct=5]
+//                                    [--ops=200000] [--theta=0.9] [--direct=0]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+#include "compressed_cache.h"
+#include "disk_manager.h"
+#include "lz_codec.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BENCH_FILE = "data/bench_compressed_cache.db";
+
+/// @brief Bytes per generated record
+static const int RECORD_SIZE = 64;
+
+static const char *WORDS[] = {"alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel",
+                              "india", "juliet", "kilo", "lima", "mike", "november", "oscar", "papa"};
+
+/// @brief Fills a page with records, leaving the last fifth free like a partly filled heap page
+static void FillPage(char *data, page_id_t page_id, Rng &rng)
+{
+    memset(data, 0, PAGE_SIZE);
+    int records = (PAGE_SIZE - Page::HEADER_SIZE) / RECORD_SIZE * 4 / 5;
+    for (int r = 0; r < records; r++)
+    {
+        char *record = data + Page::HEADER_SIZE + r * RECORD_SIZE;
+        int64_t key = page_id * records + r;
+        int32_t quantity = static_cast<int32_t>(rng.Uniform(100));
+        memcpy(record, &key, sizeof(key));
+        memcpy(record + 8, &quantity, sizeof(quantity));
+        std::snprintf(record + 12, RECORD_SIZE - 12, "%s %s", WORDS[rng.Uniform(16)], WORDS[rng.Uniform(16)]);
+    }
+}
+
+struct Result
+{
+    double ops_per_sec;
+    LatencyHistogram latency;
+    double hit_ratio;
+    uint64_t disk_reads;
+    uint64_t memory_bytes;
+    uint64_t pages_in_memory;
+};
+
+static Result Run(DiskManager &dm, uint64_t pages, uint64_t frames, uint64_t tier_bytes, uint64_t ops, double theta)
+{
+    buffer_pool pool(static_cast<int>(frames), &dm);
+    std::unique_ptr<CompressedCache> tier;
+    if (tier_bytes > 0)
+    {
+        tier.reset(new CompressedCache(tier_bytes));
+        pool.SetSecondaryCache(tier.get());
+    }
+
+    Zipf zipf(pages, theta);
+    Rng rng(7);
+    for (uint64_t i = 0; i < ops; i++)
+    {
+        page_id_t page_id = static_cast<page_id_t>(zipf.Next(rng));
+        pool.FetchPage(page_id);
+        pool.UnpinPage(page_id, false);
+    }
+
+    Result result;
+    BufferPoolStats before = pool.GetStats();
+    DiskStats io_before = dm.GetStats();
+    Timer timer;
+    for (uint64_t i = 0; i < ops; i++)
+    {
+        page_id_t page_id = static_cast<page_id_t>(zipf.Next(rng));
+        Timer op;
+        pool.FetchPage(page_id);
+        pool.UnpinPage(page_id, false);
+        result.latency.Record(static_cast<uint64_t>(op.Seconds() * 1e9));
+    }
+    result.ops_per_sec = ops / timer.Seconds();
+
+    BufferPoolStats after = pool.GetStats();
+    result.hit_ratio = static_cast<double>(after.hits - before.hits) / ops;
+    result.disk_reads = dm.GetStats().read_page_latency.Count() - io_before.read_page_latency.Count();
+    result.memory_bytes = frames * PAGE_SIZE + (tier ? tier->GetStats().capacity_bytes : 0);
+    result.pages_in_memory = frames + (tier ? tier->GetStats().pages : 0);
+    pool.SetSecondaryCache(nullptr);
+    return result;
+}
+
+static void Print(const char *name, const Result &result)
+{
+    std::printf("%-8s %9.1f %9llu %9.1f %10.0f %8.2f %8.2f %8.2f %10llu\n", name,
+                result.memory_bytes / 1048576.0, (unsigned long long)result.pages_in_memory,
+                result.hit_ratio * 100, result.ops_per_sec, result.latency.Percentile(0.5) / 1000.0,
+                result.latency.Percentile(0.99) / 1000.0, result.latency.Percentile(0.999) / 1000.0,
+                (unsigned long long)result.disk_reads);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t pages = ArgOr(argc, argv, "pages", 32768);
+    uint64_t pool_pct = ArgOr(argc, argv, "pool_pct", 5);
+    uint64_t tier_pct = ArgOr(argc, argv, "tier_pct", 5);
+    uint64_t ops = ArgOr(argc, argv, "ops", 200000);
+    double theta = ArgDouble(argc, argv, "theta", 0.9);
+    bool direct = ArgOr(argc, argv, "direct", 0) != 0;
+
+    std::remove(BENCH_FILE);
+    {
+        DiskManager dm(BENCH_FILE);
+        Rng rng(1);
+        std::vector<char> data(PAGE_SIZE), packed(PAGE_SIZE);
+        uint64_t packed_bytes = 0;
+        for (uint64_t i = 0; i < pages; i++)
+        {
+            page_id_t page_id = dm.AllocatePage();
+            FillPage(data.data(), page_id, rng);
+            dm.WritePage(page_id, data.data());
+            packed_bytes += LzCodec::Compress(data.data(), PAGE_SIZE, packed.data(), PAGE_SIZE);
+        }
+        std::printf("pages=%llu (%llu MiB), compression ratio %.2f, zipf theta=%.2f, ops=%llu, direct=%d\n",
+                    (unsigned long long)pages, (unsigned long long)(pages * PAGE_SIZE >> 20),
+                    static_cast<double>(pages * PAGE_SIZE) / packed_bytes, theta, (unsigned long long)ops, direct);
+    }
+
+    DiskManager dm(BENCH_FILE, direct);
+    uint64_t frames = std::max<uint64_t>(2, pages * pool_pct / 100);
+    uint64_t extra_bytes = pages * tier_pct / 100 * PAGE_SIZE;
+    std::printf("%-8s %9s %9s %9s %10s %8s %8s %8s %10s\n", "setup", "MiB", "pages", "hit%", "ops/s", "p50 us",
+                "p99 us", "p999 us", "disk reads");
+    Print("primary", Run(dm, pages, frames, 0, ops, theta));
+    Print("+tier", Run(dm, pages, frames, extra_bytes, ops, theta));
+    Print("+frames", Run(dm, pages, frames + extra_bytes / PAGE_SIZE, 0, ops, theta));
+
+    std::remove(BENCH_FILE);
+    return 0;
+}
@@ -0,0 +1,147 @@
+// Scaling of the morsel-driven executor with worker threads. A fact table (k INT32 in 1000
+// groups, v INT64 random, d DOUBLE random), 20 bytes a row, lives in a PaxTable whose pool holds
+// only --ratio of its pages, so every pass also reads pages back through the pool. Two queries
+// per thread count, each run through one Pipeline on a WorkStealingPool:
+//   "agg"  scan -> filter d < 0.9 -> group by k: count(v), sum(v), max(v)
+//   "join" scan -> filter d < 0.9 -> probe a 1000-key dimension (k, region) -> group by region: sum(v)
+// Speedup is against the first thread count. Threads beyond the machine's cores only show
+// overhead.
+//
+//   bench/bin/bench_executor [--rows=4000000] [--threads=1,2,4,8,16] [--ratio=0.25] [--morsel=16] [--repeat=3]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+#include "disk_manager.h"
+#include "executor.h"
+#include "hash_operators.h"
+#include "pax_table.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BENCH_FILE = "data/bench_executor.db";
+
+static const uint32_t RECORD_BYTES = 20;
+static const int32_t GROUPS = 1000;
+static const int32_t REGIONS = 25;
+
+/// @brief Runs fn repeat times and gets the fastest pass
+static double Best(uint64_t repeat, const std::function<void()> &fn)
+{
+    double best = std::numeric_limits<double>::max();
+    for (uint64_t i = 0; i < repeat; i++)
+    {
+        Timer timer;
+        fn();
+        best = std::min(best, timer.Seconds());
+    }
+    return best;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t rows = ArgOr(argc, argv, "rows", 4000000);
+    double ratio = ArgDouble(argc, argv, "ratio", 0.25);
+    uint64_t morsel = ArgOr(argc, argv, "morsel", 16);
+    uint64_t repeat = ArgOr(argc, argv, "repeat", 3);
+    std::vector<std::string> thread_list = SplitList(ArgString(argc, argv, "threads", "1,2,4,8,16"));
+    uint64_t max_threads = 1;
+    for (const std::string &threads : thread_list)
+    {
+        max_threads = std::max<uint64_t>(max_threads, std::stoull(threads));
+    }
+
+    const std::vector<PaxType> fact_schema = {PaxType::INT32, PaxType::INT64, PaxType::DOUBLE};
+    const std::vector<PaxType> dim_schema = {PaxType::INT32, PaxType::INT32};
+    uint64_t fact_pages = rows / PaxPage::Capacity(fact_schema) + 1;
+    // Every worker pins a whole morsel, plus room for the dimension and the table directories
+    uint64_t frames = std::max<uint64_t>(static_cast<uint64_t>(fact_pages * ratio), max_threads * morsel + 64);
+
+    std::remove(BENCH_FILE);
+    DiskManager dm(BENCH_FILE);
+    buffer_pool pool(static_cast<int>(frames), &dm);
+    PaxTable fact(&pool, fact_schema);
+    PaxTable dim(&pool, dim_schema);
+
+    Rng rng(23);
+    char record[RECORD_BYTES];
+    for (uint64_t i = 0; i < rows; i++)
+    {
+        int32_t k = static_cast<int32_t>(rng.Uniform(GROUPS));
+        int64_t v = static_cast<int64_t>(rng.Uniform(2000001)) - 1000000;
+        double d = rng.NextDouble();
+        memcpy(record, &k, 4);
+        memcpy(record + 4, &v, 8);
+        memcpy(record + 12, &d, 8);
+        fact.Append(record);
+    }
+    for (int32_t k = 0; k < GROUPS; k++)
+    {
+        int32_t region = k % REGIONS;
+        memcpy(record, &k, 4);
+        memcpy(record + 4, &region, 4);
+        dim.Append(record);
+    }
+    pool.FlushAllPages();
+
+    std::printf("rows=%llu (%.1f MiB), fact pages=%llu, pool frames=%llu (%.0f%%), morsel=%llu pages, best of %llu\n",
+                (unsigned long long)rows, rows * (double)RECORD_BYTES / 1048576.0,
+                (unsigned long long)fact.GetPageCount(), (unsigned long long)frames,
+                100.0 * frames / fact.GetPageCount(), (unsigned long long)morsel, (unsigned long long)repeat);
+    std::printf("%-5s %7s %9s %10s %8s %8s %12s\n", "query", "threads", "ms", "Mrows/s", "speedup", "steals",
+                "checksum");
+
+    PaxScan fact_scan(&fact, &pool, morsel);
+    PaxScan dim_scan(&dim, &pool, 1);
+    const std::vector<PaxPredicate> predicates = {{2, CompareOp::LT, {0, 0.9}}};
+    double agg_base = 0, join_base = 0;
+    for (const std::string &threads : thread_list)
+    {
+        WorkStealingPool workers(std::stoull(threads));
+
+        Filter filter(predicates);
+        HashAggregate aggregate(0, {{AggregateFunc::COUNT, 1}, {AggregateFunc::SUM, 1}, {AggregateFunc::MAX, 1}});
+        Pipeline agg_pipeline(&fact_scan, {&filter}, &aggregate);
+        uint64_t steals = workers.GetSteals();
+        double seconds = Best(repeat, [&]()
+                              { agg_pipeline.Execute(&workers); });
+        int64_t checksum = 0;
+        for (const AggregateRow &row : aggregate.GetResults())
+        {
+            checksum += row.values[0].i + row.values[1].i;
+        }
+        agg_base = agg_base == 0 ? seconds : agg_base;
+        std::printf("%-5s %7s %9.2f %10.1f %8.2f %8llu %12lld\n", "agg", threads.c_str(), seconds * 1e3,
+                    rows / seconds / 1e6, agg_base / seconds,
+                    (unsigned long long)(workers.GetSteals() - steals) / repeat, (long long)checksum);
+
+        HashJoinBuild build(0, {1});
+        Pipeline build_pipeline(&dim_scan, {}, &build);
+        build_pipeline.Execute(&workers);
+        HashJoinProbe probe(&build, 0);
+        HashAggregate by_region(3, {{AggregateFunc::SUM, 1}});
+        Pipeline join_pipeline(&fact_scan, {&filter, &probe}, &by_region);
+        steals = workers.GetSteals();
+        seconds = Best(repeat, [&]()
+                       { join_pipeline.Execute(&workers); });
+        checksum = 0;
+        for (const AggregateRow &row : by_region.GetResults())
+        {
+            checksum += row.values[0].i;
+        }
+        join_base = join_base == 0 ? seconds : join_base;
+        std::printf("%-5s %7s %9.2f %10.1f %8.2f %8llu %12lld\n", "join", threads.c_str(), seconds * 1e3,
+                    rows / seconds / 1e6, join_base / seconds,
+                    (unsigned long long)(workers.GetSteals() - steals) / repeat, (long long)checksum);
+    }
+    std::remove(BENCH_FILE);
+    return 0;
+}
@@ -0,0 +1,166 @@
+// Point lookups per second through a pool much smaller than the file, so most lookups miss:
+// blocking FetchPage, one lookup at a time per thread, against coroutines on an AsyncContext per
+// thread, --depth lookups in flight each. A lookup fetches a page, reads a word and unpins it.
+// Keys are uniform, or Zipfian (theta 0.99) so concurrent misses on one hot page are common and
+// coalesce into a single read. Each run starts from an empty pool. Uses O_DIRECT by default so
+// misses reach the device rather than the page cache.
+//
+//   bench/bin/bench_fetch_async [--pages=65536] [--frames=2048] [--lookups=50000] [--depth=64]
+//                               [--threads=1,2,4] [--direct=1]
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "async_context.h"
+#include "bench_util.h"
+#include "buffer_pool.h"
+#include "disk_manager.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BENCH_FILE = "data/bench_fetch_async.db";
+
+struct Workload
+{
+    const char *name;
+    /// @brief Zipf over the pages, nullptr for uniform
+    const Zipf *zipf;
+    uint64_t pages;
+};
+
+static page_id_t NextPage(const Workload &workload, Rng &rng)
+{
+    if (workload.zipf == nullptr)
+    {
+        return static_cast<page_id_t>(rng.Uniform(workload.pages));
+    }
+    // Scatter the ranks so hot pages are not neighbours on disk
+    return static_cast<page_id_t>((workload.zipf->Next(rng) * 2654435761ull) % workload.pages);
+}
+
+static uint64_t ReadWord(Page *page)
+{
+    uint64_t word;
+    memcpy(&word, page->GetData(), sizeof(word));
+    return word;
+}
+
+static Task<void> Lookups(buffer_pool *pool, AsyncContext *context, const Workload *workload, uint64_t count,
+                          uint64_t seed, std::atomic<uint64_t> *checksum)
+{
+    Rng rng(seed);
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < count; i++)
+    {
+        page_id_t page_id = NextPage(*workload, rng);
+        Page *page = co_await pool->FetchPageAsync(page_id, context);
+        sum += ReadWord(page);
+        pool->UnpinPage(page_id, false);
+    }
+    *checksum += sum;
+}
+
+/// @brief Runs lookups on every thread against a fresh pool
+/// @return Lookups per second, all threads together
+static double Run(DiskManager &dm, uint64_t frames, const Workload &workload, uint64_t threads, uint64_t lookups,
+                  uint64_t depth, bool async, BufferPoolStats *stats)
+{
+    buffer_pool pool(static_cast<int>(frames), &dm);
+    std::atomic<uint64_t> checksum{0};
+    std::vector<std::thread> workers;
+    Timer timer;
+    for (uint64_t t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t]()
+                             {
+                                 if (async)
+                                 {
+                                     AsyncContext context(&pool, depth);
+                                     for (uint64_t c = 0; c < depth; c++)
+                                     {
+                                         uint64_t share = lookups / depth + (c < lookups % depth ? 1 : 0);
+                                         context.Spawn(Lookups(&pool, &context, &workload, share, t * depth + c + 1,
+                                                               &checksum));
+                                     }
+                                     context.Run();
+                                     return;
+                                 }
+                                 Rng rng(t + 1);
+                                 uint64_t sum = 0;
+                                 for (uint64_t i = 0; i < lookups; i++)
+                                 {
+                                     page_id_t page_id = NextPage(workload, rng);
+                                     sum += ReadWord(pool.FetchPage(page_id));
+                                     pool.UnpinPage(page_id, false);
+                                 }
+                                 checksum += sum;
+                             });
+    }
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    double seconds = timer.Seconds();
+    *stats = pool.GetStats();
+    return threads * lookups / seconds;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t pages = ArgOr(argc, argv, "pages", 65536);
+    uint64_t frames = ArgOr(argc, argv, "frames", 2048);
+    uint64_t lookups = ArgOr(argc, argv, "lookups", 50000);
+    uint64_t depth = std::max<uint64_t>(1, ArgOr(argc, argv, "depth", 64));
+    bool direct = ArgOr(argc, argv, "direct", 1) != 0;
+    std::vector<std::string> thread_list = SplitList(ArgString(argc, argv, "threads", "1,2,4"));
+
+    std::remove(BENCH_FILE);
+    {
+        DiskManager writer(BENCH_FILE);
+        Page page;
+        for (uint64_t i = 0; i < pages; i++)
+        {
+            page_id_t page_id = writer.AllocatePage(false);
+            uint64_t word = static_cast<uint64_t>(page_id);
+            memcpy(page.GetData(), &word, sizeof(word));
+            writer.WritePage(page_id, page.GetData());
+        }
+        writer.Sync();
+    }
+    DiskManager dm(BENCH_FILE, direct);
+
+    Zipf zipf(pages, 0.99);
+    std::vector<Workload> workloads = {{"uniform", nullptr, pages}, {"zipf", &zipf, pages}};
+
+    std::printf("pages=%llu frames=%llu lookups=%llu per thread, depth=%llu, direct=%d\n", (unsigned long long)pages,
+                (unsigned long long)frames, (unsigned long long)lookups, (unsigned long long)depth, direct ? 1 : 0);
+    std::printf("%-8s %7s %-9s %12s %14s %9s %10s\n", "keys", "threads", "mode", "lookups/s", "per thread", "miss %",
+                "coalesced");
+    for (const Workload &workload : workloads)
+    {
+        for (const std::string &threads_arg : thread_list)
+        {
+            uint64_t threads = std::stoull(threads_arg);
+            // Every coroutine may hold a frame
+            uint64_t run_frames = std::max<uint64_t>(frames, threads * depth + 64);
+            for (bool async : {false, true})
+            {
+                BufferPoolStats stats;
+                double rate = Run(dm, run_frames, workload, threads, lookups, depth, async, &stats);
+                uint64_t requests = stats.hits + stats.misses + stats.coalesced_misses;
+                std::printf("%-8s %7llu %-9s %12.0f %14.0f %8.1f%% %10llu\n", workload.name,
+                            (unsigned long long)threads, async ? "coroutine" : "blocking", rate, rate / threads,
+                            100.0 * (stats.misses + stats.coalesced_misses) / requests,
+                            (unsigned long long)stats.coalesced_misses);
+            }
+        }
+    }
+    std::remove(BENCH_FILE);
+    return 0;
+}
@@ -0,0 +1,102 @@
+// buffer_pool::FetchPages against a FetchPage loop on a cold pool, for batches of 64, 256 and
+// 1024 page IDs that are either uniformly random or clustered (short runs of adjacent pages, as
+// from an index leaf range or a sorted rid list). O_DIRECT by default.
+//
+//   bench/bin/bench_fetch_pages [--pages=65536] [--trials=20] [--run=8] [--direct=1]
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BENCH_FILE = "data/bench_fetch_pages.db";
+
+/// @brief Distinct page IDs in random order
+static std::vector<page_id_t> MakeIds(Rng *rng, uint64_t pages, size_t count, bool clustered, uint64_t run)
+{
+    std::vector<page_id_t> ids;
+    std::vector<bool> used(pages, false);
+    while (ids.size() < count)
+    {
+        uint64_t start = rng->Uniform(pages);
+        uint64_t length = clustered ? run : 1;
+        for (uint64_t p = start; p < start + length && p < pages && ids.size() < count; p++)
+        {
+            if (!used[p])
+            {
+                used[p] = true;
+                ids.push_back(static_cast<page_id_t>(p));
+            }
+        }
+    }
+    for (size_t i = ids.size() - 1; i > 0; i--)
+    {
+        std::swap(ids[i], ids[rng->Uniform(i + 1)]);
+    }
+    return ids;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t pages = ArgOr(argc, argv, "pages", 65536);
+    uint64_t trials = ArgOr(argc, argv, "trials", 20);
+    uint64_t run = ArgOr(argc, argv, "run", 8);
+    bool direct = ArgOr(argc, argv, "direct", 1) != 0;
+
+    std::remove(BENCH_FILE);
+    DiskManager dm(BENCH_FILE, direct);
+    {
+        Page frame;
+        for (uint64_t i = 0; i < pages; i++)
+        {
+            page_id_t pid = dm.AllocatePage();
+            snprintf(frame.GetData(), PAGE_SIZE, "page %lld", (long long)pid);
+            dm.WritePage(pid, frame.GetData());
+        }
+        dm.Sync();
+    }
+    std::printf("pages=%llu trials=%llu cluster run=%llu direct=%d\n", (unsigned long long)pages,
+                (unsigned long long)trials, (unsigned long long)run, direct);
+    std::printf("%-10s %6s %12s %12s %9s\n", "ids", "count", "loop us", "batch us", "speedup");
+
+    Rng rng(11);
+    for (bool clustered : {false, true})
+    {
+        for (size_t count : {64, 256, 1024})
+        {
+            double loop_seconds = 0;
+            double batch_seconds = 0;
+            for (uint64_t t = 0; t < trials; t++)
+            {
+                std::vector<page_id_t> ids = MakeIds(&rng, pages, count, clustered, run);
+                std::vector<Page *> out(count);
+
+                {
+                    buffer_pool pool(static_cast<int>(count), &dm);
+                    Timer timer;
+                    for (size_t i = 0; i < count; i++)
+                    {
+                        out[i] = pool.FetchPage(ids[i]);
+                    }
+                    loop_seconds += timer.Seconds();
+                }
+                {
+                    buffer_pool pool(static_cast<int>(count), &dm);
+                    Timer timer;
+                    pool.FetchPages(ids.data(), count, out.data());
+                    batch_seconds += timer.Seconds();
+                }
+            }
+            std::printf("%-10s %6zu %12.1f %12.1f %8.2fx\n", clustered ? "clustered" : "random", count,
+                        loop_seconds * 1e6 / trials, batch_seconds * 1e6 / trials, loop_seconds / batch_seconds);
+        }
+    }
+
+    std::remove(BENCH_FILE);
+    return 0;
+}
@@ -0,0 +1,151 @@
+// Victim-scan and flush-scan cost over frame metadata for two layouts: the old one, where each
+// frame interleaves PAGE_SIZE bytes of data with its metadata, and descriptors in a compact array
+// with data in a FrameArena. The inline layout touches one page per frame, so its frame count is
+// capped to fit in half of the available memory; compare the ns/frame columns.
+//
+//   bench/bin/bench_frame_layout [--frames=1048576] [--rounds=5]
+
+#include <atomic>
+#include <cstdio>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+/// @brief Frame layout before the arena: data and metadata in one object
+struct InlineFrame
+{
+    char data[PAGE_SIZE];
+    page_id_t page_id;
+    std::atomic<int> pin_count;
+    bool is_dirty;
+};
+
+/// @brief Every 20th frame pinned, every 97th dirty
+static bool IsPinned(size_t i) { return i % 20 == 0; }
+static bool IsDirtyFrame(size_t i) { return i % 97 == 0; }
+
+template <typename Frames>
+static void Measure(const char *layout, Frames &frames, size_t count, uint64_t rounds)
+{
+    // Victim scan: every unpinned clean frame, as a clock sweep over the whole pool would visit
+    size_t victims = 0;
+    Timer victim_timer;
+    for (uint64_t r = 0; r < rounds; r++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            victims += (frames.PinCount(i) == 0 && !frames.Dirty(i)) ? 1 : 0;
+        }
+    }
+    double victim_ns = victim_timer.Seconds() * 1e9 / (rounds * count);
+
+    // Flush scan: collect dirty page IDs like Checkpoint does
+    std::vector<page_id_t> dirty;
+    Timer flush_timer;
+    for (uint64_t r = 0; r < rounds; r++)
+    {
+        dirty.clear();
+        for (size_t i = 0; i < count; i++)
+        {
+            if (frames.PageId(i) != INVALID_PAGE_ID && frames.Dirty(i))
+            {
+                dirty.push_back(frames.PageId(i));
+            }
+        }
+    }
+    double flush_ns = flush_timer.Seconds() * 1e9 / (rounds * count);
+
+    std::printf("%-12s %10zu %14.2f %14.2f %12.1f %10zu %10zu\n", layout, count, victim_ns, flush_ns,
+                (victim_ns + flush_ns) * 1048576 / 1e6, victims / rounds, dirty.size());
+}
+
+struct InlineFrames
+{
+    InlineFrame *frames;
+    int PinCount(size_t i) { return frames[i].pin_count.load(std::memory_order_acquire); }
+    bool Dirty(size_t i) { return frames[i].is_dirty; }
+    page_id_t PageId(size_t i) { return frames[i].page_id; }
+};
+
+struct DescriptorFrames
+{
+    std::vector<Page> *pages;
+    int PinCount(size_t i) { return (*pages)[i].GetPinCount(); }
+    bool Dirty(size_t i) { return (*pages)[i].IsDirty(); }
+    page_id_t PageId(size_t i) { return (*pages)[i].GetPageId(); }
+};
+
+int main(int argc, char **argv)
+{
+    size_t frames = ArgOr(argc, argv, "frames", 1048576);
+    uint64_t rounds = ArgOr(argc, argv, "rounds", 5);
+
+    std::printf("frames=%zu rounds=%llu sizeof(Page)=%zu sizeof(InlineFrame)=%zu\n", frames,
+                (unsigned long long)rounds, sizeof(Page), sizeof(InlineFrame));
+    std::printf("%-12s %10s %14s %14s %12s %10s %10s\n", "layout", "frames", "victim ns/frm", "flush ns/frm",
+                "ms per 1M", "victims", "dirty");
+
+    // Before: data and metadata interleaved, one touched page per frame
+    {
+        size_t avail = static_cast<size_t>(sysconf(_SC_AVPHYS_PAGES)) * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t count = std::min(frames, avail / 2 / (2 * PAGE_SIZE));
+        size_t bytes = count * sizeof(InlineFrame);
+        void *memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+        {
+            std::perror("mmap");
+            return 1;
+        }
+        InlineFrame *inline_frames = static_cast<InlineFrame *>(memory);
+        for (size_t i = 0; i < count; i++)
+        {
+            inline_frames[i].page_id = static_cast<page_id_t>(i);
+            inline_frames[i].pin_count.store(IsPinned(i) ? 1 : 0);
+            inline_frames[i].is_dirty = IsDirtyFrame(i);
+        }
+        InlineFrames view{inline_frames};
+        Measure("inline", view, count, rounds);
+        munmap(memory, bytes);
+    }
+
+    // After: compact descriptors, data in an untouched arena
+    {
+        FrameArena arena(frames);
+        std::vector<Page> pages;
+        pages.reserve(frames);
+        for (size_t i = 0; i < frames; i++)
+        {
+            pages.emplace_back(arena.GetFrame(static_cast<frame_id_t>(i)));
+            pages[i].SetPageId(static_cast<page_id_t>(i));
+            if (IsPinned(i))
+            {
+                pages[i].IncrementPinCount();
+            }
+            pages[i].SetDirty(IsDirtyFrame(i));
+        }
+        DescriptorFrames view{&pages};
+        Measure("descriptor", view, frames, rounds);
+    }
+
+    // The real pool: Checkpoint with nothing dirty is a pure flush scan under the latch
+    {
+        const char *file = "data/bench_frame_layout.db";
+        std::remove(file);
+        DiskManager dm(file);
+        buffer_pool pool(static_cast<int>(frames), &dm);
+        Timer timer;
+        for (uint64_t r = 0; r < rounds; r++)
+        {
+            pool.Checkpoint();
+        }
+        std::printf("%-12s %10zu %14s %14.2f\n", "pool ckpt", frames, "-", timer.Seconds() * 1e9 / (rounds * frames));
+        std::remove(file);
+    }
+    return 0;
+}
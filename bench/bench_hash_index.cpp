@@ -0,0 +1,106 @@
+// Point lookups on ExtendibleHashTable against BPlusTree on the same pool and against an in-memory
+// std::unordered_map. The hash index keeps its directory in memory, so a lookup pins one bucket
+// page; the tree pins one page per level. Lookups alternate between present and absent keys to
+// show the fingerprint probe rejecting misses without key compares.
+//
+//   bench/bin/bench_hash_index [--keys=1000000] [--frames=16384] [--lookups=2000000]
+
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+#include "disk_manager.h"
+#include "b_plus_tree.h"
+#include "extendible_hash_table.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *HASH_FILE = "data/bench_hash_index.db";
+static const char *TREE_FILE = "data/bench_hash_index_tree.db";
+
+/// @brief Keys are spread out so absent keys interleave with present ones
+static inline int64_t KeyOf(uint64_t i)
+{
+    return static_cast<int64_t>(i * 2);
+}
+
+template <typename Lookup>
+static void Measure(const char *name, uint64_t keys, uint64_t lookups, double pins, double insert_s, Lookup lookup)
+{
+    Rng rng(5);
+    uint64_t found = 0;
+    Timer timer;
+    for (uint64_t i = 0; i < lookups; i++)
+    {
+        found += lookup(KeyOf(rng.Uniform(keys)) + static_cast<int64_t>(i & 1));
+    }
+    double lookup_s = timer.Seconds();
+    std::printf("%-16s %14.0f %14.0f %12.2f %10.1f%%\n", name, keys / insert_s, lookups / lookup_s, pins,
+                100.0 * found / lookups);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t keys = ArgOr(argc, argv, "keys", 1000000);
+    uint64_t frames = ArgOr(argc, argv, "frames", 16384);
+    uint64_t lookups = ArgOr(argc, argv, "lookups", 2000000);
+
+    std::printf("keys=%llu frames=%llu lookups=%llu (half of them misses)\n", (unsigned long long)keys,
+                (unsigned long long)frames, (unsigned long long)lookups);
+    std::printf("%-16s %14s %14s %12s %11s\n", "index", "inserts/s", "lookups/s", "pins/lookup", "found");
+
+    {
+        std::remove(HASH_FILE);
+        DiskManager dm(HASH_FILE);
+        buffer_pool pool(static_cast<int>(frames), &dm);
+        ExtendibleHashTable<int64_t, Int64Comparator, Int64Hash> table(&pool);
+        Timer timer;
+        for (uint64_t i = 0; i < keys; i++)
+        {
+            table.Insert(KeyOf(i), RID{static_cast<page_id_t>(i), 0});
+        }
+        double insert_s = timer.Seconds();
+        Measure("extendible hash", keys, lookups, 1.0, insert_s, [&table](int64_t key)
+                {
+            RID rid;
+            return table.GetValue(key, &rid); });
+        std::printf("  %zu buckets, global depth %u, %d entries per bucket\n", table.GetBucketCount(),
+                    table.GetGlobalDepth(), decltype(table)::BUCKET_CAPACITY);
+    }
+
+    {
+        std::remove(TREE_FILE);
+        DiskManager dm(TREE_FILE);
+        buffer_pool pool(static_cast<int>(frames), &dm);
+        BPlusTree<int64_t, Int64Comparator> tree(&pool);
+        Timer timer;
+        for (uint64_t i = 0; i < keys; i++)
+        {
+            tree.Insert(KeyOf(i), RID{static_cast<page_id_t>(i), 0});
+        }
+        double insert_s = timer.Seconds();
+        Measure("b+ tree", keys, lookups, tree.GetHeight(), insert_s, [&tree](int64_t key)
+                {
+            RID rid;
+            return tree.GetValue(key, &rid); });
+    }
+
+    {
+        std::unordered_map<int64_t, RID> map;
+        Timer timer;
+        for (uint64_t i = 0; i < keys; i++)
+        {
+            map.emplace(KeyOf(i), RID{static_cast<page_id_t>(i), 0});
+        }
+        double insert_s = timer.Seconds();
+        Measure("unordered_map", keys, lookups, 0.0, insert_s, [&map](int64_t key)
+                { return map.find(key) != map.end(); });
+    }
+
+    std::remove(HASH_FILE);
+    std::remove(TREE_FILE);
+    return 0;
+}
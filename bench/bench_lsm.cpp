@@ -0,0 +1,203 @@
+// Sustained random inserts into an LsmTree versus the in-place page path, a BPlusTree in a
+// buffer_pool, when the data is --ratio times the memory each gets. Both store the same entries:
+// an 8-byte key (big-endian in the LSM tree, so byte order is key order) and a 16-byte RID, in
+// shuffled key order. The pool gets (keys * 24 bytes / ratio) of frames; the LSM tree the same
+// memory split between its active and its immutable memtable. "ops/s" covers the inserts alone,
+// "2nd half" the second half of them once both are well past their memory, and "drained" adds
+// writing back dirty frames, or flushing the memtable and finishing compactions. Write
+// amplification is disk bytes written per user byte (24 per entry), from DiskStats, which counts
+// data, metadata and table pages alike. Lookups probe random keys after the inserts.
+//
+//   bench/bin/bench_lsm [--keys=1000000] [--ratio=10] [--lookups=100000] [--direct=0]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench_util.h"
+#include "b_plus_tree.h"
+#include "buffer_pool.h"
+#include "disk_manager.h"
+#include "lsm_tree.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BTREE_FILE = "data/bench_lsm_btree.db";
+static const char *LSM_FILE = "data/bench_lsm.db";
+
+/// @brief Key plus RID bytes per entry
+static const uint64_t ENTRY_BYTES = 24;
+
+struct Result
+{
+    double ops_per_sec;
+    double second_half_ops_per_sec;
+    double drained_ops_per_sec;
+    double lookups_per_sec;
+    uint64_t bytes_written;
+    uint64_t bytes_read;
+    std::string detail;
+};
+
+static void EncodeKey(int64_t key, char *out)
+{
+    for (int i = 0; i < 8; i++)
+    {
+        out[i] = static_cast<char>(static_cast<uint64_t>(key) >> (56 - 8 * i));
+    }
+}
+
+static Result RunBPlusTree(const std::vector<int64_t> &order, uint64_t frames, uint64_t lookups, bool direct)
+{
+    std::remove(BTREE_FILE);
+    DiskManager dm(BTREE_FILE, direct);
+    buffer_pool pool(static_cast<int>(frames), &dm);
+    BPlusTree<int64_t, Int64Comparator> tree(&pool);
+
+    Result result;
+    Timer timer;
+    double half_s = 0;
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        if (i == order.size() / 2)
+        {
+            half_s = timer.Seconds();
+        }
+        tree.Insert(order[i], RID{order[i], 0});
+    }
+    double insert_s = timer.Seconds();
+    pool.FlushAllPages();
+    double drained_s = timer.Seconds();
+
+    Rng rng(5);
+    Timer lookup_timer;
+    for (uint64_t i = 0; i < lookups; i++)
+    {
+        RID rid;
+        tree.GetValue(static_cast<int64_t>(rng.Uniform(order.size())), &rid);
+    }
+    result.lookups_per_sec = lookups / lookup_timer.Seconds();
+
+    result.ops_per_sec = order.size() / insert_s;
+    result.second_half_ops_per_sec = (order.size() - order.size() / 2) / (insert_s - half_s);
+    result.drained_ops_per_sec = order.size() / drained_s;
+    DiskStats io = dm.GetStats();
+    result.bytes_written = io.bytes_written;
+    result.bytes_read = io.bytes_read;
+    BufferPoolStats stats = pool.GetStats();
+    char detail[128];
+    std::snprintf(detail, sizeof(detail), "height=%d pages=%lld dirty_evictions=%llu", tree.GetHeight(),
+                  (long long)dm.GetNumPages(), (unsigned long long)stats.dirty_evictions);
+    result.detail = detail;
+    std::remove(BTREE_FILE);
+    return result;
+}
+
+static Result RunLsmTree(const std::vector<int64_t> &order, uint64_t memory_bytes, uint64_t lookups, bool direct)
+{
+    std::remove(LSM_FILE);
+    DiskManager dm(LSM_FILE, direct);
+    LsmOptions options;
+    options.memtable_bytes = memory_bytes / 2;
+    options.level1_bytes = 4 * options.memtable_bytes;
+
+    Result result;
+    {
+        LsmTree tree(&dm, options);
+        char key[8];
+        char value[16];
+        memset(value, 0, sizeof(value));
+        Timer timer;
+        double half_s = 0;
+        for (size_t i = 0; i < order.size(); i++)
+        {
+            if (i == order.size() / 2)
+            {
+                half_s = timer.Seconds();
+            }
+            EncodeKey(order[i], key);
+            memcpy(value, &order[i], sizeof(order[i]));
+            tree.Put(std::string_view(key, sizeof(key)), std::string_view(value, sizeof(value)));
+        }
+        double insert_s = timer.Seconds();
+        tree.Flush();
+        tree.WaitForCompaction();
+        double drained_s = timer.Seconds();
+
+        Rng rng(5);
+        std::string found;
+        Timer lookup_timer;
+        for (uint64_t i = 0; i < lookups; i++)
+        {
+            EncodeKey(static_cast<int64_t>(rng.Uniform(order.size())), key);
+            tree.Get(std::string_view(key, sizeof(key)), &found);
+        }
+        result.lookups_per_sec = lookups / lookup_timer.Seconds();
+
+        result.ops_per_sec = order.size() / insert_s;
+        result.second_half_ops_per_sec = (order.size() - order.size() / 2) / (insert_s - half_s);
+        result.drained_ops_per_sec = order.size() / drained_s;
+        DiskStats io = dm.GetStats();
+        result.bytes_written = io.bytes_written;
+        result.bytes_read = io.bytes_read;
+
+        LsmStats stats = tree.GetStats();
+        std::string levels;
+        for (int level = 0; level < LsmTree::NUM_LEVELS; level++)
+        {
+            if (stats.level_tables[level] > 0)
+            {
+                levels += (levels.empty() ? "" : ",") + std::to_string(stats.level_tables[level]);
+            }
+        }
+        char detail[160];
+        std::snprintf(detail, sizeof(detail), "tables=%s flushes=%llu compactions=%llu moves=%llu stalls=%llu (%.1f s)",
+                      levels.c_str(), (unsigned long long)stats.flushes, (unsigned long long)stats.compactions,
+                      (unsigned long long)stats.trivial_moves, (unsigned long long)stats.stalls,
+                      stats.stall_micros / 1e6);
+        result.detail = detail;
+    }
+    std::remove(LSM_FILE);
+    return result;
+}
+
+static void Print(const char *name, const Result &result, uint64_t user_bytes)
+{
+    std::printf("%-8s %10.0f %10.0f %10.0f %10.0f %8.2f %8.2f  %s\n", name, result.ops_per_sec,
+                result.second_half_ops_per_sec, result.drained_ops_per_sec, result.lookups_per_sec,
+                static_cast<double>(result.bytes_written) / user_bytes,
+                static_cast<double>(result.bytes_read) / user_bytes, result.detail.c_str());
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t keys = ArgOr(argc, argv, "keys", 1000000);
+    uint64_t ratio = ArgOr(argc, argv, "ratio", 10);
+    uint64_t lookups = ArgOr(argc, argv, "lookups", 100000);
+    bool direct = ArgOr(argc, argv, "direct", 0) != 0;
+
+    std::vector<int64_t> order(keys);
+    for (uint64_t i = 0; i < keys; i++)
+    {
+        order[i] = static_cast<int64_t>(i);
+    }
+    Rng rng(21);
+    for (uint64_t i = keys; i > 1; i--)
+    {
+        std::swap(order[i - 1], order[rng.Uniform(i)]);
+    }
+
+    uint64_t user_bytes = keys * ENTRY_BYTES;
+    uint64_t frames = std::max<uint64_t>(16, user_bytes / ratio / PAGE_SIZE);
+    std::printf("keys=%llu (%.1f MiB of entries), memory %.1f MiB (1/%llu), direct=%d\n", (unsigned long long)keys,
+                user_bytes / 1048576.0, frames * (double)PAGE_SIZE / 1048576.0, (unsigned long long)ratio, direct);
+    std::printf("%-8s %10s %10s %10s %10s %8s %8s\n", "engine", "ops/s", "2nd half", "drained", "lookups/s", "write amp",
+                "read amp");
+    Print("b+tree", RunBPlusTree(order, frames, lookups, direct), user_bytes);
+    Print("lsm", RunLsmTree(order, frames * PAGE_SIZE, lookups, direct), user_bytes);
+    return 0;
+}
@@ -0,0 +1,175 @@
+// Point-lookup latency and scan throughput of the read-only mmap pool against the buffer pool on
+// the same (buffered, not O_DIRECT) file. Lookups fetch a uniformly random page, read a word and
+// unpin it; the scan fetches every page in order and reads one word per cache line. "cold" drops
+// the file from the OS page cache before each run (posix_fadvise DONTNEED), "hot" runs after the
+// file was read once; the mmap pool additionally maps hot files with MAP_POPULATE. Every run gets
+// a fresh pool, so buffer pool lookups mostly miss its --frames frames and copy from the page cache.
+//
+//   bench/bin/bench_mmap [--pages=32768] [--frames=1024] [--lookups=20000]
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <string>
+#include <unistd.h>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+#include "disk_manager.h"
+#include "mmap_pool.h"
+#include "stats.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BENCH_FILE = "data/bench_mmap.db";
+
+struct Result
+{
+    LatencyHistogram latency;
+    double scan_bytes_per_sec = 0;
+    uint64_t checksum = 0;
+};
+
+/// @brief Evicts the file's pages from the OS page cache
+static void DropCache(DiskManager &dm)
+{
+    uint64_t segments = DiskManager::PhysicalPage(dm.GetNumPages() - 1) / (dm.GetSegmentBytes() / PAGE_SIZE) + 1;
+    for (uint64_t segment = 0; segment < segments; segment++)
+    {
+        std::string name = segment == 0 ? BENCH_FILE : std::string(BENCH_FILE) + "." + std::to_string(segment);
+        int fd = open(name.c_str(), O_RDONLY);
+        if (fd >= 0)
+        {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+            close(fd);
+        }
+    }
+}
+
+static uint64_t ReadWord(Page *page)
+{
+    uint64_t word;
+    memcpy(&word, page->GetData(), sizeof(word));
+    return word;
+}
+
+static uint64_t ReadLines(Page *page)
+{
+    uint64_t sum = 0;
+    for (int32_t offset = 0; offset < PAGE_SIZE; offset += 64)
+    {
+        uint64_t word;
+        memcpy(&word, page->GetData() + offset, sizeof(word));
+        sum += word;
+    }
+    return sum;
+}
+
+/// @brief Runs lookups then a scan against a pool made by make_pool, once for lookups and once
+/// for the scan so both start from the same cache state
+template <typename MakePool>
+static Result Run(DiskManager &dm, bool cold, uint64_t pages, uint64_t lookups, MakePool make_pool)
+{
+    Result result;
+    if (cold)
+    {
+        DropCache(dm);
+    }
+    {
+        auto pool = make_pool(false);
+        Rng rng(1);
+        for (uint64_t i = 0; i < lookups; i++)
+        {
+            page_id_t page_id = static_cast<page_id_t>(rng.Uniform(pages));
+            Timer op;
+            result.checksum += ReadWord(pool->FetchPage(page_id));
+            pool->UnpinPage(page_id, false);
+            result.latency.Record(static_cast<uint64_t>(op.Seconds() * 1e9));
+        }
+    }
+
+    if (cold)
+    {
+        DropCache(dm);
+    }
+    {
+        auto pool = make_pool(true);
+        Timer timer;
+        for (uint64_t i = 0; i < pages; i++)
+        {
+            page_id_t page_id = static_cast<page_id_t>(i);
+            result.checksum += ReadLines(pool->FetchPage(page_id));
+            pool->UnpinPage(page_id, false);
+        }
+        result.scan_bytes_per_sec = pages * PAGE_SIZE / timer.Seconds();
+    }
+    return result;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t pages = ArgOr(argc, argv, "pages", 32768);
+    uint64_t frames = ArgOr(argc, argv, "frames", 1024);
+    uint64_t lookups = ArgOr(argc, argv, "lookups", 20000);
+
+    std::remove(BENCH_FILE);
+    {
+        DiskManager writer(BENCH_FILE);
+        Page page;
+        for (uint64_t i = 0; i < pages; i++)
+        {
+            page_id_t page_id = writer.AllocatePage(false);
+            for (int32_t offset = 0; offset < PAGE_SIZE; offset += sizeof(uint64_t))
+            {
+                uint64_t word = static_cast<uint64_t>(page_id) * PAGE_SIZE + offset;
+                memcpy(page.GetData() + offset, &word, sizeof(word));
+            }
+            writer.WritePage(page_id, page.GetData());
+        }
+        writer.Sync();
+    }
+    DiskManager dm(BENCH_FILE);
+
+    std::printf("pages=%llu (%.0f MiB) frames=%llu lookups=%llu\n", (unsigned long long)pages,
+                pages * PAGE_SIZE / 1048576.0, (unsigned long long)frames, (unsigned long long)lookups);
+    std::printf("%-12s %-5s %10s %10s %10s %12s\n", "store", "cache", "p50 us", "p99 us", "mean us", "scan GB/s");
+    for (bool cold : {true, false})
+    {
+        if (!cold)
+        {
+            // Read the file once so it is in the page cache
+            Page page;
+            for (uint64_t i = 0; i < pages; i++)
+            {
+                dm.ReadPage(static_cast<page_id_t>(i), page.GetData());
+            }
+        }
+        for (bool mmap : {false, true})
+        {
+            Result result;
+            if (mmap)
+            {
+                result = Run(dm, cold, pages, lookups, [&](bool scan)
+                             {
+                                 MmapOptions options;
+                                 options.advice = scan ? MmapAdvice::SEQUENTIAL : MmapAdvice::RANDOM;
+                                 options.populate = !cold;
+                                 return std::make_unique<mmap_pool>(&dm, options);
+                             });
+            }
+            else
+            {
+                result = Run(dm, cold, pages, lookups, [&](bool)
+                             { return std::make_unique<buffer_pool>(static_cast<int>(frames), &dm); });
+            }
+            std::printf("%-12s %-5s %10.2f %10.2f %10.2f %12.2f\n", mmap ? "mmap_pool" : "buffer_pool",
+                        cold ? "cold" : "hot", result.latency.Percentile(0.5) / 1000.0,
+                        result.latency.Percentile(0.99) / 1000.0, result.latency.Mean() / 1000.0,
+                        result.scan_bytes_per_sec / 1e9);
+        }
+    }
+    std::remove(BENCH_FILE);
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Allocate/free churn on DiskManager: a live set of --live pages, then --cycles rounds that free
+// --batch random live pages and allocate as many. With DeallocatePage the freed pages are reused
+// and the file stays flat; without it every round extends the file. Also times reopening.
+//
+//   bench/bin/bench_page_churn [--live=16384] [--cycles=50] [--batch=1024]
+
+#include <algorithm>
+#include <cstdio>
+#include <sys/stat.h>
+#include <vector>
+
+#include "bench_util.h"
+#include "disk_manager.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BENCH_FILE = "data/bench_page_churn.db";
+
+static double FileMiB()
+{
+    struct stat st;
+    stat(BENCH_FILE, &st);
+    return st.st_size / 1048576.0;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t live = ArgOr(argc, argv, "live", 16384);
+    uint64_t cycles = ArgOr(argc, argv, "cycles", 50);
+    uint64_t batch = ArgOr(argc, argv, "batch", 1024);
+
+    std::printf("live=%llu cycles=%llu batch=%llu\n", (unsigned long long)live, (unsigned long long)cycles,
+                (unsigned long long)batch);
+    std::printf("%-8s %10s %10s %12s %12s %12s\n", "free", "pages", "file MiB", "alloc us avg", "alloc us p99",
+                "reopen us");
+
+    for (bool reuse : {false, true})
+    {
+        std::remove(BENCH_FILE);
+        std::vector<double> latencies;
+        {
+            DiskManager dm(BENCH_FILE);
+            std::vector<page_id_t> pages;
+            for (uint64_t i = 0; i < live; i++)
+            {
+                pages.push_back(dm.AllocatePage());
+            }
+
+            Rng rng(5);
+            for (uint64_t c = 0; c < cycles; c++)
+            {
+                for (uint64_t i = 0; i < batch; i++)
+                {
+                    size_t victim = rng.Uniform(pages.size());
+                    if (reuse)
+                    {
+                        dm.DeallocatePage(pages[victim]);
+                    }
+                    pages[victim] = pages.back();
+                    pages.pop_back();
+                }
+                for (uint64_t i = 0; i < batch; i++)
+                {
+                    Timer timer;
+                    pages.push_back(dm.AllocatePage());
+                    latencies.push_back(timer.Seconds() * 1e6);
+                }
+            }
+            dm.Sync();
+        }
+
+        Timer reopen_timer;
+        page_id_t num_pages = 0;
+        {
+            DiskManager reopened(BENCH_FILE);
+            num_pages = reopened.GetNumPages();
+        }
+        double reopen_us = reopen_timer.Seconds() * 1e6;
+
+        std::sort(latencies.begin(), latencies.end());
+        double total = 0;
+        for (double l : latencies)
+        {
+            total += l;
+        }
+        std::printf("%-8s %10lld %10.1f %12.2f %12.2f %12.1f\n", reuse ? "reuse" : "leak", (long long)num_pages, FileMiB(),
+                    total / latencies.size(), latencies[latencies.size() * 99 / 100], reopen_us);
+    }
+
+    std::remove(BENCH_FILE);
+    return 0;
+}
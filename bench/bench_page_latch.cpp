@@ -0,0 +1,160 @@
+// Reads of one hot page from 1 to 64 threads under each latch mode: exclusive (every reader
+// serialized), shared (readers share, but each bumps the reader count, bouncing its cache line
+// between cores) and optimistic (readers only load the version, no writes at all). The page is
+// pinned once up front, so only the latch protocol is measured; the "guard" column adds a
+// FetchPageOptimistic per read to show the pool lookup on top. With --write_pct some operations
+// increment the page under the exclusive latch instead, which makes optimistic readers retry.
+//
+//   bench/bin/bench_page_latch [--ops=200000] [--write_pct=0]
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+#include "disk_manager.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BENCH_FILE = "data/bench_page_latch.db";
+
+/// @brief Words read or incremented per operation, a cache line
+static const int WORDS = 8;
+
+enum class Mode
+{
+    EXCLUSIVE,
+    SHARED,
+    OPTIMISTIC,
+    GUARD
+};
+
+static inline int64_t ReadWords(const char *data)
+{
+    int64_t words[WORDS];
+    memcpy(words, data + Page::HEADER_SIZE, sizeof(words));
+    int64_t sum = 0;
+    for (int64_t word : words)
+    {
+        sum += word;
+    }
+    return sum;
+}
+
+static inline void WriteWords(char *data)
+{
+    int64_t words[WORDS];
+    memcpy(words, data + Page::HEADER_SIZE, sizeof(words));
+    for (int64_t &word : words)
+    {
+        word++;
+    }
+    memcpy(data + Page::HEADER_SIZE, words, sizeof(words));
+}
+
+static double RunThreads(buffer_pool &pool, Page *page, Mode mode, int threads, uint64_t ops, uint64_t write_pct,
+                         std::atomic<uint64_t> *retries)
+{
+    std::vector<std::thread> workers;
+    Timer timer;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&pool, page, mode, t, ops, write_pct, retries]()
+                             {
+            Rng rng(t + 1);
+            PageLatch &latch = page->GetLatch();
+            volatile int64_t sink = 0;
+            uint64_t local_retries = 0;
+            for (uint64_t i = 0; i < ops; i++)
+            {
+                if (write_pct > 0 && rng.Uniform(100) < write_pct)
+                {
+                    latch.LockExclusive();
+                    WriteWords(page->GetData());
+                    latch.UnlockExclusive();
+                    continue;
+                }
+                switch (mode)
+                {
+                case Mode::EXCLUSIVE:
+                    latch.LockExclusive();
+                    sink = sink + ReadWords(page->GetData());
+                    latch.UnlockExclusive();
+                    break;
+                case Mode::SHARED:
+                    latch.LockShared();
+                    sink = sink + ReadWords(page->GetData());
+                    latch.UnlockShared();
+                    break;
+                case Mode::OPTIMISTIC:
+                {
+                    uint64_t version = latch.ReadVersion();
+                    int64_t sum = ReadWords(page->GetData());
+                    while (!latch.Validate(version))
+                    {
+                        local_retries++;
+                        version = latch.ReadVersion();
+                        sum = ReadWords(page->GetData());
+                    }
+                    sink = sink + sum;
+                    break;
+                }
+                case Mode::GUARD:
+                {
+                    OptimisticPageGuard guard = pool.FetchPageOptimistic(page->GetPageId());
+                    int64_t sum = ReadWords(guard.GetData());
+                    while (!guard.Validate())
+                    {
+                        local_retries++;
+                        guard.Restart();
+                        sum = ReadWords(guard.GetData());
+                    }
+                    sink = sink + sum;
+                    break;
+                }
+                }
+            }
+            *retries += local_retries; });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    return static_cast<double>(threads) * ops / timer.Seconds();
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t ops = ArgOr(argc, argv, "ops", 200000);
+    uint64_t write_pct = ArgOr(argc, argv, "write_pct", 0);
+
+    std::remove(BENCH_FILE);
+    DiskManager dm(BENCH_FILE);
+    buffer_pool pool(16, &dm);
+    page_id_t pid;
+    Page *page = pool.NewPage(&pid);
+
+    std::printf("ops/thread=%llu write_pct=%llu hw threads=%u\n", (unsigned long long)ops,
+                (unsigned long long)write_pct, std::thread::hardware_concurrency());
+    std::printf("%8s %16s %16s %16s %16s %10s\n", "threads", "exclusive op/s", "shared op/s", "optimistic op/s",
+                "guard op/s", "retries");
+    for (int threads : {1, 2, 4, 8, 16, 32, 64})
+    {
+        std::atomic<uint64_t> retries{0};
+        double exclusive = RunThreads(pool, page, Mode::EXCLUSIVE, threads, ops, write_pct, &retries);
+        double shared = RunThreads(pool, page, Mode::SHARED, threads, ops, write_pct, &retries);
+        retries = 0;
+        double optimistic = RunThreads(pool, page, Mode::OPTIMISTIC, threads, ops, write_pct, &retries);
+        double guard = RunThreads(pool, page, Mode::GUARD, threads, ops, write_pct, &retries);
+        std::printf("%8d %16.0f %16.0f %16.0f %16.0f %10llu\n", threads, exclusive, shared, optimistic, guard,
+                    (unsigned long long)retries.load());
+    }
+
+    pool.UnpinPage(pid, true);
+    std::remove(BENCH_FILE);
+    return 0;
+}
@@ -0,0 +1,98 @@
+// The same table at 4, 8, 16 and 64 KiB pages: a full scan and random point lookups (one row of
+// --row bytes at a random offset) through a buffer pool of fixed byte size. O_DIRECT by default.
+//
+//   bench/bin/bench_page_size [--mib=128] [--pool_mib=16] [--lookups=200000] [--row=128] [--direct=1]
+
+#include <cstdio>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BENCH_FILE = "data/bench_page_size.db";
+
+template <int32_t PageSize>
+static void Run(uint64_t mib, uint64_t pool_mib, uint64_t lookups, uint64_t row, bool direct)
+{
+    uint64_t pages = mib * 1048576 / PageSize;
+    int frames = static_cast<int>(pool_mib * 1048576 / PageSize);
+
+    std::remove(BENCH_FILE);
+    BasicDiskManager<PageSize> dm(BENCH_FILE, direct);
+    {
+        BasicPage<PageSize> frame;
+        for (uint64_t i = 0; i < pages; i++)
+        {
+            page_id_t pid = dm.AllocatePage();
+            snprintf(frame.GetData(), PageSize, "page %lld", (long long)pid);
+            dm.WritePage(pid, frame.GetData());
+        }
+        dm.Sync();
+    }
+
+    // Scan
+    double scan_seconds = 0;
+    {
+        basic_buffer_pool<PageSize> pool(frames, &dm);
+        volatile char sink = 0;
+        Timer timer;
+        for (uint64_t i = 0; i < pages; i++)
+        {
+            BasicPage<PageSize> *page = pool.FetchPage(static_cast<page_id_t>(i));
+            sink = sink + page->GetData()[0];
+            pool.UnpinPage(static_cast<page_id_t>(i), false);
+        }
+        scan_seconds = timer.Seconds();
+    }
+
+    // Point lookups, pool warmed by the first pass
+    double lookup_seconds = 0;
+    uint64_t misses = 0;
+    {
+        basic_buffer_pool<PageSize> pool(frames, &dm);
+        uint64_t rows = mib * 1048576 / row;
+        uint64_t rows_per_page = PageSize / row;
+        volatile char sink = 0;
+        for (int pass = 0; pass < 2; pass++)
+        {
+            Rng rng(7 + pass);
+            Timer timer;
+            for (uint64_t i = 0; i < lookups; i++)
+            {
+                page_id_t pid = static_cast<page_id_t>(rng.Uniform(rows) / rows_per_page);
+                if (pass == 1)
+                {
+                    misses += pool.IsResident(pid) ? 0 : 1;
+                }
+                BasicPage<PageSize> *page = pool.FetchPage(pid);
+                sink = sink + page->GetData()[(i % rows_per_page) * row];
+                pool.UnpinPage(pid, false);
+            }
+            lookup_seconds = timer.Seconds();
+        }
+    }
+
+    std::printf("%8d %10llu %8d %12.1f %14.0f %10.1f\n", PageSize / 1024, (unsigned long long)pages, frames,
+                mib / scan_seconds, lookups / lookup_seconds, 100.0 * misses / lookups);
+    std::remove(BENCH_FILE);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t mib = ArgOr(argc, argv, "mib", 128);
+    uint64_t pool_mib = ArgOr(argc, argv, "pool_mib", 16);
+    uint64_t lookups = ArgOr(argc, argv, "lookups", 200000);
+    uint64_t row = ArgOr(argc, argv, "row", 128);
+    bool direct = ArgOr(argc, argv, "direct", 1) != 0;
+
+    std::printf("table=%llu MiB pool=%llu MiB lookups=%llu row=%llu direct=%d\n", (unsigned long long)mib,
+                (unsigned long long)pool_mib, (unsigned long long)lookups, (unsigned long long)row, direct);
+    std::printf("%8s %10s %8s %12s %14s %10s\n", "KiB", "pages", "frames", "scan MiB/s", "lookups/s", "miss %");
+    Run<4096>(mib, pool_mib, lookups, row, direct);
+    Run<8192>(mib, pool_mib, lookups, row, direct);
+    Run<16384>(mib, pool_mib, lookups, row, direct);
+    Run<65536>(mib, pool_mib, lookups, row, direct);
+    return 0;
+}
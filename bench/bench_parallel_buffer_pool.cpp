@@ -0,0 +1,82 @@
+// Throughput of FetchPage/UnpinPage on a hot, cache-resident working set, from 1 to 32 threads.
+// Compares one globally latched buffer_pool against parallel_buffer_pool shards.
+//
+//   bench/bin/bench_parallel_buffer_pool [--frames=4096] [--hot=1024] [--shards=16] [--ops=200000]
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+#include "parallel_buffer_pool.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+template <typename Pool>
+static double RunThreads(Pool &pool, const std::vector<page_id_t> &hot, int threads, uint64_t ops)
+{
+    std::vector<std::thread> workers;
+    Timer timer;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&pool, &hot, t, ops]()
+                             {
+            Rng rng(t + 1);
+            volatile char sink = 0;
+            for (uint64_t i = 0; i < ops; i++)
+            {
+                page_id_t pid = hot[rng.Uniform(hot.size())];
+                Page *page = pool.FetchPage(pid);
+                sink = sink + page->GetData()[0];
+                pool.UnpinPage(pid, false);
+            } });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    return static_cast<double>(threads) * ops / timer.Seconds();
+}
+
+template <typename Pool>
+static std::vector<page_id_t> Populate(Pool &pool, uint64_t hot)
+{
+    std::vector<page_id_t> pids(hot);
+    for (uint64_t i = 0; i < hot; i++)
+    {
+        Page *page = pool.NewPage(&pids[i]);
+        page->GetData()[0] = static_cast<char>(i);
+        pool.UnpinPage(pids[i], true);
+    }
+    return pids;
+}
+
+int main(int argc, char **argv)
+{
+    int frames = static_cast<int>(ArgOr(argc, argv, "frames", 4096));
+    uint64_t hot = ArgOr(argc, argv, "hot", 1024);
+    size_t shards = ArgOr(argc, argv, "shards", 16);
+    uint64_t ops = ArgOr(argc, argv, "ops", 200000);
+
+    DiskManager dm_single("data/bench_single_latch.db");
+    buffer_pool single(frames, &dm_single);
+    std::vector<page_id_t> single_pids = Populate(single, hot);
+
+    DiskManager dm_sharded("data/bench_sharded.db");
+    parallel_buffer_pool sharded(frames, shards, &dm_sharded);
+    std::vector<page_id_t> sharded_pids = Populate(sharded, hot);
+
+    std::printf("hot pages=%llu frames=%d shards=%zu ops/thread=%llu hw threads=%u\n",
+                (unsigned long long)hot, frames, shards, (unsigned long long)ops,
+                std::thread::hardware_concurrency());
+    std::printf("%8s %18s %18s %8s\n", "threads", "single latch op/s", "sharded op/s", "speedup");
+    for (int threads : {1, 2, 4, 8, 16, 32})
+    {
+        double single_rate = RunThreads(single, single_pids, threads, ops);
+        double sharded_rate = RunThreads(sharded, sharded_pids, threads, ops);
+        std::printf("%8d %18.0f %18.0f %7.2fx\n", threads, single_rate, sharded_rate, sharded_rate / single_rate);
+    }
+    return 0;
+}
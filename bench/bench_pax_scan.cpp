@@ -0,0 +1,169 @@
+// Analytic scan throughput of the same rows stored row-wise, as fixed-width tuples in a
+// TableHeap decoded one row at a time, and column-wise, in a PaxTable scanned through
+// ScanKernels at each SIMD level the CPU has. Rows are (a INT32 ascending, b INT64 random,
+// c DOUBLE random), 20 bytes. Two queries: "wide" aggregates b over c < 0.5, about half the rows
+// on every page; "range" aggregates b over a in a 1% window, which zone maps narrow to a few PAX
+// pages. Both pools hold every page, so the numbers are CPU cost: GB/s is table bytes (rows *
+// 20) over the best of --repeat passes on one thread, i.e. per core.
+//
+//   bench/bin/bench_pax_scan [--rows=2000000] [--repeat=5]
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+#include "disk_manager.h"
+#include "pax_table.h"
+#include "scan_kernels.h"
+#include "table_heap.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *HEAP_FILE = "data/bench_pax_heap.db";
+static const char *PAX_FILE = "data/bench_pax.db";
+
+static const uint32_t RECORD_BYTES = 20;
+
+struct Query
+{
+    const char *name;
+    std::vector<PaxPredicate> predicates;
+    /// @brief Row-at-a-time version of predicates: a_low <= a < a_high and c < c_below
+    int32_t a_low;
+    int32_t a_high;
+    double c_below;
+};
+
+/// @brief Runs fn repeat times and gets the fastest pass
+static double Best(uint64_t repeat, const std::function<void()> &fn)
+{
+    double best = std::numeric_limits<double>::max();
+    for (uint64_t i = 0; i < repeat; i++)
+    {
+        Timer timer;
+        fn();
+        best = std::min(best, timer.Seconds());
+    }
+    return best;
+}
+
+static void Print(const char *query, const char *method, double seconds, uint64_t rows, const PaxAggregate &result,
+                  bool pax)
+{
+    std::printf("%-6s %-10s %9.2f %10.1f %8.2f %10llu %12lld", query, method, seconds * 1e3, rows / seconds / 1e6,
+                rows * (double)RECORD_BYTES / seconds / 1e9, (unsigned long long)result.count,
+                (long long)result.sum.i);
+    if (pax)
+    {
+        std::printf("  pages scanned=%llu skipped=%llu", (unsigned long long)result.pages_scanned,
+                    (unsigned long long)result.pages_skipped);
+    }
+    std::printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t rows = ArgOr(argc, argv, "rows", 2000000);
+    uint64_t repeat = ArgOr(argc, argv, "repeat", 5);
+
+    const std::vector<PaxType> schema = {PaxType::INT32, PaxType::INT64, PaxType::DOUBLE};
+    uint64_t heap_pages = rows / ((PAGE_SIZE - TablePage::HEADER_SIZE) / (RECORD_BYTES + TablePage::SLOT_SIZE)) + 64;
+    uint64_t pax_pages = rows / PaxPage::Capacity(schema) + rows / 1000 + 64;
+
+    std::remove(HEAP_FILE);
+    std::remove(PAX_FILE);
+    DiskManager heap_dm(HEAP_FILE);
+    DiskManager pax_dm(PAX_FILE);
+    buffer_pool heap_pool(static_cast<int>(heap_pages), &heap_dm);
+    buffer_pool pax_pool(static_cast<int>(pax_pages), &pax_dm);
+    TableHeap heap(&heap_pool);
+    PaxTable pax(&pax_pool, schema);
+
+    Rng rng(22);
+    char record[RECORD_BYTES];
+    for (uint64_t i = 0; i < rows; i++)
+    {
+        int32_t a = static_cast<int32_t>(i);
+        int64_t b = static_cast<int64_t>(rng.Uniform(2000001)) - 1000000;
+        double c = rng.NextDouble();
+        memcpy(record, &a, 4);
+        memcpy(record + 4, &b, 8);
+        memcpy(record + 12, &c, 8);
+        heap.Insert(record, RECORD_BYTES);
+        pax.Append(record);
+    }
+
+    int32_t low = static_cast<int32_t>(rows / 2);
+    int32_t high = static_cast<int32_t>(rows / 2 + rows / 100);
+    std::vector<Query> queries = {
+        {"wide", {{2, CompareOp::LT, {0, 0.5}}}, 0, std::numeric_limits<int32_t>::max(), 0.5},
+        {"range", {{0, CompareOp::GE, {low, 0}}, {0, CompareOp::LT, {high, 0}}}, low, high, 2.0},
+    };
+
+    std::printf("rows=%llu (%.1f MiB), heap pages=%lld, pax pages=%llu (%u rows each), best of %llu\n",
+                (unsigned long long)rows, rows * (double)RECORD_BYTES / 1048576.0, (long long)heap_dm.GetNumPages(),
+                (unsigned long long)pax.GetPageCount(), PaxPage::Capacity(schema), (unsigned long long)repeat);
+    std::printf("%-6s %-10s %9s %10s %8s %10s %12s\n", "query", "method", "ms", "Mrows/s", "GB/s", "count", "sum(b)");
+
+    SimdLevel best_level = ScanKernels::DetectSimdLevel();
+    for (const Query &query : queries)
+    {
+        PaxAggregate row_result;
+        double seconds = Best(repeat, [&]() {
+            row_result = PaxAggregate();
+            int64_t min = std::numeric_limits<int64_t>::max();
+            int64_t max = std::numeric_limits<int64_t>::lowest();
+            for (TableHeap::Iterator it = heap.Begin(); it.Valid(); it.Next())
+            {
+                TupleView tuple = it.GetTuple();
+                int32_t a;
+                int64_t b;
+                double c;
+                memcpy(&a, tuple.data, 4);
+                memcpy(&c, tuple.data + 12, 8);
+                if (a < query.a_low || a >= query.a_high || !(c < query.c_below))
+                {
+                    continue;
+                }
+                memcpy(&b, tuple.data + 4, 8);
+                row_result.count++;
+                row_result.sum.i += b;
+                min = std::min(min, b);
+                max = std::max(max, b);
+            }
+            row_result.min.i = min;
+            row_result.max.i = max;
+        });
+        Print(query.name, "row", seconds, rows, row_result, false);
+
+        const std::pair<SimdLevel, const char *> levels[] = {
+            {SimdLevel::SCALAR, "pax scalar"}, {SimdLevel::SSE42, "pax sse4.2"}, {SimdLevel::AVX2, "pax avx2"}};
+        for (const auto &level : levels)
+        {
+            if (level.first > best_level)
+            {
+                continue;
+            }
+            ScanKernels::SetSimdLevel(level.first);
+            PaxAggregate result;
+            seconds = Best(repeat, [&]() { result = pax.Aggregate(query.predicates, 1); });
+            if (result.count != row_result.count || result.sum.i != row_result.sum.i)
+            {
+                std::printf("MISMATCH with the row-at-a-time answer\n");
+                return 1;
+            }
+            Print(query.name, level.second, seconds, rows, result, true);
+        }
+    }
+
+    std::remove(HEAP_FILE);
+    std::remove(PAX_FILE);
+    return 0;
+}
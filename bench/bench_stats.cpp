@@ -0,0 +1,97 @@
+// Cost of the statistics on the buffer pool hit path. Every thread increments a counter in a
+// loop, once through a single shared std::atomic (one cache line bouncing between all cores)
+// and once through a StripedCounter (a line per thread, summed on read); the last column is a
+// FetchPage + UnpinPage hit on a resident page, which includes one striped add, for scale.
+//
+//   bench/bin/bench_stats [--ops=2000000]
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+#include "disk_manager.h"
+#include "stats.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BENCH_FILE = "data/bench_stats.db";
+
+enum class Mode
+{
+    SHARED_ATOMIC,
+    STRIPED,
+    FETCH_HIT
+};
+
+/// @brief Runs ops operations on each thread
+/// @return Wall nanoseconds per operation, all threads together
+static double RunThreads(Mode mode, int threads, uint64_t ops, buffer_pool *pool, page_id_t page_id)
+{
+    std::atomic<uint64_t> shared{0};
+    StripedCounter striped;
+    std::vector<std::thread> workers;
+    Timer timer;
+    for (int t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, mode, ops]()
+                             {
+            for (uint64_t i = 0; i < ops; i++)
+            {
+                switch (mode)
+                {
+                case Mode::SHARED_ATOMIC:
+                    shared.fetch_add(1, std::memory_order_relaxed);
+                    break;
+                case Mode::STRIPED:
+                    striped.Add();
+                    break;
+                case Mode::FETCH_HIT:
+                    pool->FetchPage(page_id);
+                    pool->UnpinPage(page_id, false);
+                    break;
+                }
+            } });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    double seconds = timer.Seconds();
+    if (mode != Mode::FETCH_HIT && shared.load() + striped.Load() != threads * ops)
+    {
+        std::fprintf(stderr, "lost increments\n");
+    }
+    return seconds * 1e9 / (static_cast<double>(threads) * ops);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t ops = ArgOr(argc, argv, "ops", 2000000);
+
+    std::remove(BENCH_FILE);
+    DiskManager dm(BENCH_FILE);
+    buffer_pool pool(16, &dm);
+    page_id_t page_id;
+    pool.NewPage(&page_id);
+    pool.UnpinPage(page_id, true);
+
+    std::printf("ops/thread=%llu hw threads=%u, ns per op\n", (unsigned long long)ops,
+                std::thread::hardware_concurrency());
+    std::printf("%8s %14s %14s %14s\n", "threads", "shared atomic", "striped", "fetch hit");
+    for (int threads : {1, 2, 4, 8, 16})
+    {
+        double shared = RunThreads(Mode::SHARED_ATOMIC, threads, ops, &pool, page_id);
+        double striped = RunThreads(Mode::STRIPED, threads, ops, &pool, page_id);
+        double fetch = RunThreads(Mode::FETCH_HIT, threads, ops / 10, &pool, page_id);
+        std::printf("%8d %14.2f %14.2f %14.2f\n", threads, shared, striped, fetch);
+    }
+
+    BufferPoolStats stats = pool.GetStats();
+    std::printf("pool hits=%zu misses=%zu\n", stats.hits, stats.misses);
+    std::remove(BENCH_FILE);
+    return 0;
+}
@@ -0,0 +1,116 @@
+// Insert throughput and scan bandwidth of TableHeap (slotted pages) against the naive layout of one
+// record per page written with memcpy. Both run through the same buffer pool; the naive layout
+// touches one page per record, the heap packs PAGE_SIZE / (row + slot) records per page.
+//
+//   bench/bin/bench_table_heap [--rows=100000] [--row=100] [--frames=256]
+
+#include <cstdio>
+#include <vector>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+#include "disk_manager.h"
+#include "table_heap.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BENCH_FILE = "data/bench_table_heap.db";
+
+static void Report(const char *name, uint64_t rows, uint64_t row, page_id_t pages, double insert_s, double scan_s,
+                   uint64_t checksum)
+{
+    std::printf("%-10s %10lld %14.0f %14.1f %10llx\n", name, (long long)pages, rows / insert_s,
+                rows * row / scan_s / 1048576.0, (unsigned long long)checksum);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t rows = ArgOr(argc, argv, "rows", 100000);
+    uint64_t row = ArgOr(argc, argv, "row", 100);
+    uint64_t frames = ArgOr(argc, argv, "frames", 256);
+    if (row + sizeof(uint32_t) > PAGE_SIZE - Page::HEADER_SIZE || row > TablePage::MAX_TUPLE_SIZE)
+    {
+        std::fprintf(stderr, "row must fit in a page\n");
+        return 1;
+    }
+
+    std::printf("rows=%llu row=%llu bytes frames=%llu\n", (unsigned long long)rows, (unsigned long long)row,
+                (unsigned long long)frames);
+    std::printf("%-10s %10s %14s %14s %10s\n", "layout", "pages", "inserts/s", "scan MiB/s", "checksum");
+
+    std::vector<char> record(row);
+    Rng rng(3);
+    for (char &c : record)
+    {
+        c = static_cast<char>(rng.Uniform(256));
+    }
+
+    // Naive: [size][bytes] after the page header, one record per page
+    {
+        std::remove(BENCH_FILE);
+        DiskManager dm(BENCH_FILE);
+        buffer_pool pool(static_cast<int>(frames), &dm);
+        std::vector<page_id_t> pids;
+        pids.reserve(rows);
+
+        Timer insert_timer;
+        for (uint64_t i = 0; i < rows; i++)
+        {
+            page_id_t pid;
+            Page *page = pool.NewPage(&pid);
+            uint32_t size = static_cast<uint32_t>(row);
+            memcpy(page->GetData() + Page::HEADER_SIZE, &size, sizeof(size));
+            memcpy(page->GetData() + Page::HEADER_SIZE + sizeof(size), record.data(), row);
+            pool.UnpinPage(pid, true);
+            pids.push_back(pid);
+        }
+        double insert_s = insert_timer.Seconds();
+
+        Timer scan_timer;
+        uint64_t checksum = 0;
+        for (page_id_t pid : pids)
+        {
+            Page *page = pool.FetchPage(pid);
+            uint32_t size;
+            memcpy(&size, page->GetData() + Page::HEADER_SIZE, sizeof(size));
+            const char *data = page->GetData() + Page::HEADER_SIZE + sizeof(size);
+            for (uint32_t b = 0; b < size; b += 8)
+            {
+                checksum += static_cast<unsigned char>(data[b]);
+            }
+            pool.UnpinPage(pid, false);
+        }
+        Report("naive", rows, row, dm.GetNumPages(), insert_s, scan_timer.Seconds(), checksum);
+    }
+
+    // Slotted pages
+    {
+        std::remove(BENCH_FILE);
+        DiskManager dm(BENCH_FILE);
+        buffer_pool pool(static_cast<int>(frames), &dm);
+        TableHeap heap(&pool);
+
+        Timer insert_timer;
+        for (uint64_t i = 0; i < rows; i++)
+        {
+            heap.Insert(record.data(), static_cast<uint32_t>(row));
+        }
+        double insert_s = insert_timer.Seconds();
+
+        Timer scan_timer;
+        uint64_t checksum = 0;
+        for (auto it = heap.Begin(); it.Valid(); it.Next())
+        {
+            TupleView view = it.GetTuple();
+            for (uint32_t b = 0; b < view.size; b += 8)
+            {
+                checksum += static_cast<unsigned char>(view.data[b]);
+            }
+        }
+        Report("slotted", rows, row, dm.GetNumPages(), insert_s, scan_timer.Seconds(), checksum);
+    }
+
+    std::remove(BENCH_FILE);
+    return 0;
+}
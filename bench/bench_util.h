@@ -0,0 +1,177 @@
+#include <chrono>        // std::chrono
+#include <cmath>         // std::pow
+#include <cstdint>       // uint64_t
+#include <cstdlib>       // std::strtoull, std::strtod
+#include <cstring>       // strncmp
+#include <string>        // std::string
+#include <vector>        // std::vector
+#include "stats.h"
+
+#pragma once
+
+namespace minidb_bench
+{
+    /// @brief Wall-clock stopwatch started on construction
+    class Timer
+    {
+    public:
+        Timer() : start_(std::chrono::steady_clock::now()) {}
+
+        /// @brief Gets elapsed time since construction
+        /// @return Seconds elapsed
+        inline double Seconds() const
+        {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+        }
+
+    private:
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /// @brief Small xorshift generator, cheap enough to call inside measured loops
+    class Rng
+    {
+    public:
+        explicit Rng(uint64_t seed) : state_(seed * 0x9E3779B97F4A7C15ull + 1) {}
+
+        /// @brief Gets next pseudo-random value
+        /// @return 64 random bits
+        inline uint64_t Next()
+        {
+            state_ ^= state_ << 13;
+            state_ ^= state_ >> 7;
+            state_ ^= state_ << 17;
+            return state_;
+        }
+
+        /// @brief Gets a value in [0, bound)
+        /// @param bound Exclusive upper bound
+        /// @return Random value below bound
+        inline uint64_t Uniform(uint64_t bound)
+        {
+            return Next() % bound;
+        }
+
+        /// @brief Gets a value in [0, 1)
+        /// @return Random double with 53 random bits
+        inline double NextDouble()
+        {
+            return (Next() >> 11) * (1.0 / 9007199254740992.0);
+        }
+
+    private:
+        uint64_t state_;
+    };
+
+    /// @brief Zipfian ranks in [0, n): rank r is drawn with probability proportional to
+    /// 1 / (r + 1)^theta, so rank 0 is the hottest. Gray et al.'s generator as used by YCSB: an
+    /// O(n) setup, then O(1) per draw
+    class Zipf
+    {
+    public:
+        /// @param n Number of ranks
+        /// @param theta Skew in (0, 1); 0.99 is YCSB's default
+        Zipf(uint64_t n, double theta) : n_(n), theta_(theta)
+        {
+            double zeta2 = 1.0 + std::pow(0.5, theta);
+            zetan_ = 0;
+            for (uint64_t i = 1; i <= n; i++)
+            {
+                zetan_ += 1.0 / std::pow(static_cast<double>(i), theta);
+            }
+            alpha_ = 1.0 / (1.0 - theta);
+            eta_ = (1.0 - std::pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan_);
+            half_pow_theta_ = std::pow(0.5, theta);
+        }
+
+        /// @brief Draws a rank
+        /// @param rng Source of uniform numbers, one per thread
+        /// @return Rank in [0, n)
+        inline uint64_t Next(Rng &rng) const
+        {
+            double u = rng.NextDouble();
+            double uz = u * zetan_;
+            if (uz < 1.0)
+            {
+                return 0;
+            }
+            if (uz < 1.0 + half_pow_theta_)
+            {
+                return 1;
+            }
+            uint64_t rank = static_cast<uint64_t>(n_ * std::pow(eta_ * u - eta_ + 1.0, alpha_));
+            return rank < n_ ? rank : n_ - 1;
+        }
+
+    private:
+        uint64_t n_;
+        double theta_;
+        double zetan_;
+        double alpha_;
+        double eta_;
+        double half_pow_theta_;
+    };
+
+    /// @brief Finds "--name=value" in argv
+    /// @return Pointer to value, nullptr if absent
+    inline const char *FindArg(int argc, char **argv, const char *name)
+    {
+        std::string prefix = std::string("--") + name + "=";
+        for (int i = 1; i < argc; i++)
+        {
+            if (strncmp(argv[i], prefix.c_str(), prefix.size()) == 0)
+            {
+                return argv[i] + prefix.size();
+            }
+        }
+        return nullptr;
+    }
+
+    /// @brief Reads "--name=value" from argv
+    /// @param argc Argument count
+    /// @param argv Arguments
+    /// @param name Option name without dashes
+    /// @param fallback Value when option is absent
+    /// @return Parsed value
+    inline uint64_t ArgOr(int argc, char **argv, const char *name, uint64_t fallback)
+    {
+        const char *value = FindArg(argc, argv, name);
+        return value != nullptr ? std::strtoull(value, nullptr, 10) : fallback;
+    }
+
+    /// @brief Reads "--name=value" from argv as a double
+    inline double ArgDouble(int argc, char **argv, const char *name, double fallback)
+    {
+        const char *value = FindArg(argc, argv, name);
+        return value != nullptr ? std::strtod(value, nullptr) : fallback;
+    }
+
+    /// @brief Reads "--name=value" from argv as a string
+    inline std::string ArgString(int argc, char **argv, const char *name, const std::string &fallback)
+    {
+        const char *value = FindArg(argc, argv, name);
+        return value != nullptr ? std::string(value) : fallback;
+    }
+
+    /// @brief Splits a comma-separated option value, e.g. "--threads=1,4,16"
+    /// @return Non-empty items in order
+    inline std::vector<std::string> SplitList(const std::string &list)
+    {
+        std::vector<std::string> items;
+        size_t start = 0;
+        while (start <= list.size())
+        {
+            size_t end = list.find(',', start);
+            if (end == std::string::npos)
+            {
+                end = list.size();
+            }
+            if (end > start)
+            {
+                items.push_back(list.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+        return items;
+    }
+}
@@ -0,0 +1,88 @@
+// Commit throughput of the write-ahead log with 1, 8 and 64 concurrent committers. Each commit is
+// BEGIN, one 100-byte page update and COMMIT waiting for fdatasync. Group commit lets committers
+// that arrive during a sync share the next one, so commits per sync grows with concurrency.
+//
+//   bench/bin/bench_wal [--commits=4000] [--delay_us=0]
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+#include "disk_manager.h"
+#include "log_manager.h"
+#include "transaction_manager.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BENCH_FILE = "data/bench_wal.db";
+static const char *BENCH_LOG = "data/bench_wal.log";
+
+int main(int argc, char **argv)
+{
+    uint64_t commits = ArgOr(argc, argv, "commits", 4000);
+    uint64_t delay_us = ArgOr(argc, argv, "delay_us", 0);
+
+    std::printf("commits=%llu group commit delay=%llu us\n", (unsigned long long)commits,
+                (unsigned long long)delay_us);
+    std::printf("%-10s %12s %10s %14s %12s\n", "committers", "commits/s", "syncs", "commits/sync", "us/commit");
+
+    for (int committers : {1, 8, 64})
+    {
+        std::remove(BENCH_FILE);
+        std::remove(BENCH_LOG);
+        DiskManager dm(BENCH_FILE);
+        buffer_pool pool(128, &dm);
+        LogOptions options;
+        options.group_commit_delay = std::chrono::microseconds(delay_us);
+        LogManager log(BENCH_LOG, options);
+        TransactionManager txns(&pool, &log);
+
+        // One page per committer, so updates never touch the same bytes
+        std::vector<page_id_t> pages(committers);
+        for (int t = 0; t < committers; t++)
+        {
+            pool.NewPage(&pages[t]);
+        }
+
+        uint64_t per_thread = commits / committers;
+        Timer timer;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < committers; t++)
+        {
+            threads.emplace_back([&, t]()
+                                 {
+                Rng rng(t + 1);
+                Page *page = pool.FetchPage(pages[t]);
+                char row[100];
+                for (uint64_t i = 0; i < per_thread; i++)
+                {
+                    for (char &c : row)
+                    {
+                        c = static_cast<char>('a' + rng.Uniform(26));
+                    }
+                    Transaction txn = txns.Begin();
+                    txns.Update(&txn, page, Page::HEADER_SIZE, row, sizeof(row));
+                    txns.Commit(&txn);
+                }
+                pool.UnpinPage(pages[t], true); });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        double seconds = timer.Seconds();
+
+        uint64_t done = per_thread * committers;
+        LogStats stats = log.GetStats();
+        std::printf("%-10d %12.0f %10zu %14.2f %12.1f\n", committers, done / seconds, stats.syncs,
+                    static_cast<double>(done) / stats.syncs, seconds * 1e6 / done);
+    }
+
+    std::remove(BENCH_FILE);
+    std::remove(BENCH_LOG);
+    return 0;
+}
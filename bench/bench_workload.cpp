@@ -0,0 +1,338 @@
+// Workload driver for DiskManager + buffer_pool. Every combination of workload, pool size and
+// thread count is one run over the same data file; each run gets a fresh pool and reports
+// throughput, latency percentiles, hit ratio and disk traffic.
+//
+// Workloads, one page access per operation:
+//   uniform  every page equally likely
+//   zipf     page r with probability ~ 1 / (r + 1)^theta (--theta, default 0.99)
+//   scan     each thread walks the file sequentially from its own offset, wrapping
+//   hotset   --hot_ops% of accesses go to the first --hot_pages% of pages
+// A --write_pct share of operations modifies the page and unpins it dirty, so evictions write.
+//
+// Output is a table by default; --format=csv or --format=json prints one record per run for
+// scripts that track regressions across builds.
+//
+//   bench/bin/bench_workload [--workloads=uniform,zipf,scan,hotset] [--pages=16384]
+//                            [--pool_pct=10,50,100] [--threads=1,4] [--ops=100000] [--write_pct=0]
+//                            [--theta=0.99] [--hot_pages=10] [--hot_ops=90] [--direct=0]
+//                            [--format=table]
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench_util.h"
+#include "buffer_pool.h"
+#include "disk_manager.h"
+
+using namespace minidb;
+using namespace minidb_bench;
+
+static const char *BENCH_FILE = "data/bench_workload.db";
+
+/// @brief Parameters shared by every run
+struct Config
+{
+    uint64_t pages;
+    uint64_t ops;
+    uint64_t write_pct;
+    double theta;
+    uint64_t hot_pages_pct;
+    uint64_t hot_ops_pct;
+};
+
+/// @brief One row of output
+struct Result
+{
+    std::string workload;
+    uint64_t threads;
+    uint64_t pool_pct;
+    uint64_t frames;
+    uint64_t ops;
+    double seconds;
+    LatencyHistogram latency;
+    double hit_ratio;
+    DiskStats io;
+};
+
+enum class Workload
+{
+    UNIFORM,
+    ZIPF,
+    SCAN,
+    HOTSET
+};
+
+/// @brief Draws the pages one thread touches
+class PageChooser
+{
+public:
+    PageChooser(const std::string &workload, const Config &config, const Zipf *zipf, int thread, int threads)
+        : config_(config), zipf_(zipf), rng_(thread + 1), next_(config.pages * thread / threads)
+    {
+        workload_ = workload == "zipf"     ? Workload::ZIPF
+                    : workload == "scan"   ? Workload::SCAN
+                    : workload == "hotset" ? Workload::HOTSET
+                                           : Workload::UNIFORM;
+        hot_pages_ = std::max<uint64_t>(1, config.pages * config.hot_pages_pct / 100);
+    }
+
+    inline page_id_t Next()
+    {
+        switch (workload_)
+        {
+        case Workload::ZIPF:
+            return static_cast<page_id_t>(zipf_->Next(rng_));
+        case Workload::SCAN:
+        {
+            page_id_t page_id = static_cast<page_id_t>(next_);
+            next_ = (next_ + 1) % config_.pages;
+            return page_id;
+        }
+        case Workload::HOTSET:
+            if (rng_.Uniform(100) < config_.hot_ops_pct || hot_pages_ == config_.pages)
+            {
+                return static_cast<page_id_t>(rng_.Uniform(hot_pages_));
+            }
+            return static_cast<page_id_t>(hot_pages_ + rng_.Uniform(config_.pages - hot_pages_));
+        default:
+            return static_cast<page_id_t>(rng_.Uniform(config_.pages));
+        }
+    }
+
+    inline bool IsWrite()
+    {
+        return config_.write_pct > 0 && rng_.Uniform(100) < config_.write_pct;
+    }
+
+private:
+    Workload workload_;
+    const Config &config_;
+    const Zipf *zipf_;
+    Rng rng_;
+    uint64_t next_;
+    uint64_t hot_pages_;
+};
+
+static DiskStats Delta(const DiskStats &after, const DiskStats &before)
+{
+    DiskStats delta;
+    delta.reads = after.reads - before.reads;
+    delta.writes = after.writes - before.writes;
+    delta.bytes_read = after.bytes_read - before.bytes_read;
+    delta.bytes_written = after.bytes_written - before.bytes_written;
+    return delta;
+}
+
+static Result Run(DiskManager &dm, const Config &config, const Zipf &zipf, const std::string &workload,
+                  uint64_t threads, uint64_t pool_pct)
+{
+    Result result;
+    result.workload = workload;
+    result.threads = threads;
+    result.pool_pct = pool_pct;
+    result.frames = std::max<uint64_t>(threads + 1, config.pages * pool_pct / 100);
+    result.ops = threads * config.ops;
+
+    buffer_pool pool(static_cast<int>(result.frames), &dm);
+    DiskStats io_before = dm.GetStats();
+    std::vector<LatencyHistogram> latencies(threads);
+    std::vector<std::thread> workers;
+    Timer timer;
+    for (uint64_t t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t]()
+                             {
+            PageChooser chooser(workload, config, &zipf, static_cast<int>(t), static_cast<int>(threads));
+            LatencyHistogram &latency = latencies[t];
+            volatile char sink = 0;
+            for (uint64_t i = 0; i < config.ops; i++)
+            {
+                page_id_t page_id = chooser.Next();
+                bool write = chooser.IsWrite();
+                auto start = std::chrono::steady_clock::now();
+                Page *page = pool.FetchPage(page_id);
+                if (write)
+                {
+                    page->GetData()[Page::HEADER_SIZE + i % 64]++;
+                }
+                else
+                {
+                    sink = sink + page->GetData()[Page::HEADER_SIZE];
+                }
+                pool.UnpinPage(page_id, write);
+                latency.Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                         std::chrono::steady_clock::now() - start)
+                                                         .count()));
+            } });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    result.seconds = timer.Seconds();
+    result.io = Delta(dm.GetStats(), io_before);
+
+    for (const LatencyHistogram &latency : latencies)
+    {
+        result.latency.Merge(latency);
+    }
+    BufferPoolStats stats = pool.GetStats();
+    result.hit_ratio = stats.hits + stats.misses > 0 ? static_cast<double>(stats.hits) / (stats.hits + stats.misses) : 0;
+
+    // Leave the file clean for the next run, outside the measured window
+    pool.FlushAllPages();
+    return result;
+}
+
+static void PrintTableHeader()
+{
+    std::printf("%-8s %7s %5s %8s %12s %9s %9s %9s %7s %10s %10s\n", "workload", "threads", "pool%", "frames",
+                "ops/s", "p50 us", "p99 us", "p999 us", "hit%", "MiB read", "MiB write");
+}
+
+static void PrintTableRow(const Result &r)
+{
+    std::printf("%-8s %7llu %5llu %8llu %12.0f %9.2f %9.2f %9.2f %7.2f %10.1f %10.1f\n", r.workload.c_str(),
+                (unsigned long long)r.threads, (unsigned long long)r.pool_pct, (unsigned long long)r.frames,
+                r.ops / r.seconds, r.latency.Percentile(0.50) / 1000.0, r.latency.Percentile(0.99) / 1000.0,
+                r.latency.Percentile(0.999) / 1000.0, 100.0 * r.hit_ratio, r.io.bytes_read / 1048576.0,
+                r.io.bytes_written / 1048576.0);
+}
+
+static const char *CSV_COLUMNS = "workload,threads,pool_pct,frames,pages,write_pct,ops,seconds,ops_per_sec,"
+                                 "p50_ns,p99_ns,p999_ns,hit_ratio,reads,writes,bytes_read,bytes_written";
+
+static void PrintCsvRow(const Result &r, const Config &c)
+{
+    std::printf("%s,%llu,%llu,%llu,%llu,%llu,%llu,%.6f,%.0f,%llu,%llu,%llu,%.6f,%llu,%llu,%llu,%llu\n",
+                r.workload.c_str(), (unsigned long long)r.threads, (unsigned long long)r.pool_pct,
+                (unsigned long long)r.frames, (unsigned long long)c.pages, (unsigned long long)c.write_pct,
+                (unsigned long long)r.ops, r.seconds, r.ops / r.seconds,
+                (unsigned long long)r.latency.Percentile(0.50), (unsigned long long)r.latency.Percentile(0.99),
+                (unsigned long long)r.latency.Percentile(0.999), r.hit_ratio, (unsigned long long)r.io.reads,
+                (unsigned long long)r.io.writes, (unsigned long long)r.io.bytes_read,
+                (unsigned long long)r.io.bytes_written);
+}
+
+static void PrintJsonRow(const Result &r, const Config &c, bool last)
+{
+    std::printf("  {\"workload\": \"%s\", \"threads\": %llu, \"pool_pct\": %llu, \"frames\": %llu, "
+                "\"pages\": %llu, \"write_pct\": %llu, \"ops\": %llu, \"seconds\": %.6f, \"ops_per_sec\": %.0f, "
+                "\"p50_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"hit_ratio\": %.6f, \"reads\": %llu, "
+                "\"writes\": %llu, \"bytes_read\": %llu, \"bytes_written\": %llu}%s\n",
+                r.workload.c_str(), (unsigned long long)r.threads, (unsigned long long)r.pool_pct,
+                (unsigned long long)r.frames, (unsigned long long)c.pages, (unsigned long long)c.write_pct,
+                (unsigned long long)r.ops, r.seconds, r.ops / r.seconds,
+                (unsigned long long)r.latency.Percentile(0.50), (unsigned long long)r.latency.Percentile(0.99),
+                (unsigned long long)r.latency.Percentile(0.999), r.hit_ratio, (unsigned long long)r.io.reads,
+                (unsigned long long)r.io.writes, (unsigned long long)r.io.bytes_read,
+                (unsigned long long)r.io.bytes_written, last ? "" : ",");
+}
+
+int main(int argc, char **argv)
+{
+    Config config;
+    config.pages = ArgOr(argc, argv, "pages", 16384);
+    config.ops = ArgOr(argc, argv, "ops", 100000);
+    config.write_pct = ArgOr(argc, argv, "write_pct", 0);
+    config.theta = ArgDouble(argc, argv, "theta", 0.99);
+    config.hot_pages_pct = ArgOr(argc, argv, "hot_pages", 10);
+    config.hot_ops_pct = ArgOr(argc, argv, "hot_ops", 90);
+    bool direct = ArgOr(argc, argv, "direct", 0) != 0;
+    std::string format = ArgString(argc, argv, "format", "table");
+    std::vector<std::string> workloads = SplitList(ArgString(argc, argv, "workloads", "uniform,zipf,scan,hotset"));
+    std::vector<std::string> pool_pcts = SplitList(ArgString(argc, argv, "pool_pct", "10,50,100"));
+    std::vector<std::string> thread_counts = SplitList(ArgString(argc, argv, "threads", "1,4"));
+
+    for (const std::string &workload : workloads)
+    {
+        if (workload != "uniform" && workload != "zipf" && workload != "scan" && workload != "hotset")
+        {
+            std::fprintf(stderr, "unknown workload %s\n", workload.c_str());
+            return 1;
+        }
+    }
+    for (const std::string &threads : thread_counts)
+    {
+        if (std::strtoull(threads.c_str(), nullptr, 10) == 0)
+        {
+            std::fprintf(stderr, "thread counts must be positive\n");
+            return 1;
+        }
+    }
+    if (format != "table" && format != "csv" && format != "json")
+    {
+        std::fprintf(stderr, "format must be table, csv or json\n");
+        return 1;
+    }
+    if (config.pages == 0 || config.theta <= 0 || config.theta >= 1)
+    {
+        std::fprintf(stderr, "pages must be positive and theta in (0, 1)\n");
+        return 1;
+    }
+
+    // The data file: pages allocated once, shared by every run
+    std::remove(BENCH_FILE);
+    DiskManager dm(BENCH_FILE, direct);
+    for (uint64_t i = 0; i < config.pages; i++)
+    {
+        dm.AllocatePage();
+    }
+    Zipf zipf(config.pages, config.theta);
+
+    if (format == "table")
+    {
+        std::printf("pages=%llu (%.0f MiB) ops/thread=%llu write_pct=%llu theta=%.2f hot=%llu%% of ops on %llu%% of "
+                    "pages direct=%d hw threads=%u\n",
+                    (unsigned long long)config.pages, config.pages * (double)PAGE_SIZE / 1048576.0,
+                    (unsigned long long)config.ops, (unsigned long long)config.write_pct, config.theta,
+                    (unsigned long long)config.hot_ops_pct, (unsigned long long)config.hot_pages_pct, direct ? 1 : 0,
+                    std::thread::hardware_concurrency());
+        PrintTableHeader();
+    }
+    else if (format == "csv")
+    {
+        std::printf("%s\n", CSV_COLUMNS);
+    }
+    else
+    {
+        std::printf("[\n");
+    }
+
+    size_t runs = workloads.size() * pool_pcts.size() * thread_counts.size();
+    size_t run = 0;
+    for (const std::string &workload : workloads)
+    {
+        for (const std::string &pool_pct : pool_pcts)
+        {
+            for (const std::string &threads : thread_counts)
+            {
+                Result result = Run(dm, config, zipf, workload, std::strtoull(threads.c_str(), nullptr, 10),
+                                    std::strtoull(pool_pct.c_str(), nullptr, 10));
+                run++;
+                if (format == "table")
+                {
+                    PrintTableRow(result);
+                }
+                else if (format == "csv")
+                {
+                    PrintCsvRow(result, config);
+                }
+                else
+                {
+                    PrintJsonRow(result, config, run == runs);
+                }
+            }
+        }
+    }
+    if (format == "json")
+    {
+        std::printf("]\n");
+    }
+
+    std::remove(BENCH_FILE);
+    return 0;
+}
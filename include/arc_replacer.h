@@ -0,0 +1,62 @@
+#include <algorithm>     // std::min
+#include <list>          // std::list
+#include <unordered_map> // std::unordered_map
+#include <vector>        // std::vector
+#include "common.h"
+#include "replacer.h"
+#include "frame_list.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Adaptive Replacement Cache (Megiddo & Modha). T1 holds pages seen once recently, T2
+    /// pages seen at least twice; ghost lists B1/B2 remember page IDs recently evicted from each and
+    /// steer the target size of T1 towards whichever list would have produced the hit
+    class ARCReplacer : public Replacer
+    {
+    public:
+        /// @brief Creates replacer for num_frames frames
+        /// @param num_frames Number of frames in the pool
+        explicit ARCReplacer(size_t num_frames);
+
+        void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+        void SetEvictable(frame_id_t frame_id, bool evictable) override;
+        bool Evict(frame_id_t *frame_id_ptr) override;
+        void Remove(frame_id_t frame_id) override;
+        void GetCandidates(size_t count, std::vector<frame_id_t> *candidates) override;
+        size_t Size() override;
+
+    private:
+        /// @brief Cache size c
+        size_t capacity_;
+
+        /// @brief Target size of T1, adapted on ghost hits
+        size_t target_t1_ = 0;
+
+        /// @brief Resident frames, head is most recently used
+        FrameList t1_;
+        FrameList t2_;
+
+        /// @brief Evicted page IDs, front is most recent
+        std::list<page_id_t> b1_;
+        std::list<page_id_t> b2_;
+        std::unordered_map<page_id_t, std::list<page_id_t>::iterator> b1_index_;
+        std::unordered_map<page_id_t, std::list<page_id_t>::iterator> b2_index_;
+
+        /// @brief Page held by each resident frame
+        std::vector<page_id_t> frame_page_;
+
+        /// @brief Frames that may be evicted
+        std::vector<bool> evictable_;
+        size_t evictable_count_ = 0;
+
+        /// @brief Finds the least recently used evictable frame of a list
+        /// @param list T1 or T2
+        /// @return Frame or INVALID_FRAME_ID
+        frame_id_t OldestEvictable(const FrameList &list) const;
+
+        /// @brief Drops the oldest ghosts so |T1|+|B1| <= c and the directory stays within 2c
+        void TrimGhosts();
+    };
+}
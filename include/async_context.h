@@ -0,0 +1,174 @@
+#include <condition_variable> // std::condition_variable
+#include <coroutine>          // std::coroutine_handle
+#include <cstddef>            // size_t
+#include <cstdint>            // int32_t, uint64_t
+#include <deque>              // std::deque
+#include <exception>          // std::exception_ptr
+#include <memory>             // std::unique_ptr
+#include <mutex>              // std::mutex
+#include <vector>             // std::vector
+#include "common.h"
+#include "page.h"
+#include "buffer_pool.h"
+#include "io_engine.h"
+#include "task.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief One coroutine inside FetchPageAsync. Lives in the awaiting coroutine's frame and,
+    /// while its page is read, in the pool's list of waiters for that read
+    template <int32_t PageSize>
+    struct BasicFetchWaiter
+    {
+        std::coroutine_handle<> handle;
+        BasicAsyncContext<PageSize> *context = nullptr;
+        BasicPage<PageSize> *page = nullptr;
+        std::exception_ptr error;
+        BasicFetchWaiter *next = nullptr;
+    };
+
+    /// @brief Awaitable returned by basic_buffer_pool::FetchPageAsync
+    template <int32_t PageSize>
+    class BasicFetchAwaiter
+    {
+    public:
+        BasicFetchAwaiter(basic_buffer_pool<PageSize> *pool, page_id_t page_id, BasicAsyncContext<PageSize> *context)
+            : pool_(pool), page_id_(page_id)
+        {
+            waiter_.context = context;
+        }
+
+        bool await_ready() noexcept
+        {
+            return false;
+        }
+
+        /// @return False on a hit or an error, resuming the coroutine at once
+        bool await_suspend(std::coroutine_handle<> handle)
+        {
+            waiter_.handle = handle;
+            return pool_->StartFetchAsync(page_id_, &waiter_);
+        }
+
+        /// @return Pinned page
+        /// @throws std::runtime_error if no frame was free or the read failed
+        BasicPage<PageSize> *await_resume()
+        {
+            if (waiter_.error)
+            {
+                std::rethrow_exception(waiter_.error);
+            }
+            return waiter_.page;
+        }
+
+    private:
+        basic_buffer_pool<PageSize> *pool_;
+        page_id_t page_id_;
+        BasicFetchWaiter<PageSize> waiter_;
+    };
+
+    /// @brief Single-threaded event loop for coroutines using FetchPageAsync: runs spawned tasks,
+    /// batches the reads their misses queue into one IOEngine submission and resumes the waiters
+    /// as reads complete, so one thread keeps up to queue_depth reads in flight. Each thread
+    /// drives its own context. A coroutine that joins a read driven by another context is posted
+    /// back to its own context to resume, so a coroutine only ever runs on its context's thread;
+    /// such posts wait while the loop blocks on its own reads
+    /// @tparam PageSize Bytes per page, matching the pool
+    template <int32_t PageSize>
+    class BasicAsyncContext
+    {
+        friend class basic_buffer_pool<PageSize>;
+
+    public:
+        /// @brief Creates the context and its I/O engine
+        /// @param pool Pool to fetch from
+        /// @param queue_depth Maximum reads in flight; further misses queue until one completes
+        /// @param engine_type Backend, AUTO falls back to a thread pool without io_uring
+        BasicAsyncContext(basic_buffer_pool<PageSize> *pool, size_t queue_depth = 64,
+                          IOEngineType engine_type = IOEngineType::AUTO);
+
+        /// @brief Finishes reads still in flight so their frames return to the pool. Call only
+        /// after Run returned, or without ever running
+        ~BasicAsyncContext();
+
+        BasicAsyncContext(const BasicAsyncContext &) = delete;
+        BasicAsyncContext &operator=(const BasicAsyncContext &) = delete;
+
+        /// @brief Adds a task, started by the next Run
+        /// @param task Coroutine to run
+        void Spawn(Task<void> task);
+
+        /// @brief Runs until every spawned task ended
+        /// @throws The first exception a task threw, once all of them ended
+        void Run();
+
+        /// @brief Gets the pool
+        /// @return Pool
+        inline basic_buffer_pool<PageSize> *GetPool()
+        {
+            return pool_;
+        }
+
+        /// @brief Gets backend in use
+        /// @return Engine name
+        inline const char *GetEngineName()
+        {
+            return engine_->Name();
+        }
+
+        /// @brief Gets the reads this context issued
+        /// @return Reads submitted, re-reads of stale pages included
+        inline uint64_t GetReads()
+        {
+            return reads_;
+        }
+
+    private:
+        /// @brief Read queued by the pool, waiting for a free slot in the engine
+        struct QueuedRead
+        {
+            page_id_t page_id;
+            char *data;
+        };
+
+        basic_buffer_pool<PageSize> *pool_;
+        std::unique_ptr<IOEngine> engine_;
+        std::deque<QueuedRead> queued_;
+        std::vector<IOCompletion> completions_;
+        uint64_t reads_ = 0;
+
+        /// @brief Spawned tasks, each wrapped by Track
+        std::vector<Task<void>> tasks_;
+        size_t active_ = 0;
+        std::exception_ptr error_;
+
+        /// @brief Coroutines to resume, posted by this thread or by contexts finishing reads
+        std::mutex ready_latch_;
+        std::condition_variable ready_cv_;
+        std::deque<std::coroutine_handle<>> ready_;
+
+        /// @brief Runs a spawned task, keeping its exception and counting it finished
+        /// @param task Spawned task
+        /// @return Wrapper task
+        Task<void> Track(Task<void> task);
+
+        /// @brief Queues a read into a reserved frame. Called by the pool under its latch, from
+        /// this context's thread
+        /// @param page_id Page to read
+        /// @param data Frame to read into
+        void QueueRead(page_id_t page_id, char *data);
+
+        /// @brief Hands queued reads to the engine, as many as the queue depth allows, with one
+        /// Submit
+        void SubmitQueued();
+
+        /// @brief Schedules a coroutine to resume on this context. Thread-safe
+        /// @param handle Coroutine
+        void Post(std::coroutine_handle<> handle);
+    };
+
+    /// @brief Async context of the default PAGE_SIZE
+    using AsyncContext = BasicAsyncContext<PAGE_SIZE>;
+}
@@ -0,0 +1,91 @@
+#include <cstdint>       // uint64_t
+#include <memory>        // std::unique_ptr
+#include <string>        // std::string
+#include <vector>        // std::vector
+#include "common.h"
+#include "disk_manager.h"
+#include "io_engine.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief DiskManager with an asynchronous submit/complete interface on top of the blocking
+    /// one. Reads and writes are queued with SubmitRead/SubmitWrite, started together by Submit
+    /// (one syscall per batch) and reaped with Complete, so a single thread can keep many requests
+    /// in flight. The asynchronous calls must be driven by one thread at a time; the inherited
+    /// blocking calls stay thread-safe
+    class AsyncDiskManager : public DiskManager
+    {
+    public:
+        /// @brief Opens DB file and sets up the I/O engine
+        /// @param db_file DB file to open
+        /// @param queue_depth Maximum requests in flight
+        /// @param direct_io Open with O_DIRECT, buffers must be PAGE_ALIGNMENT aligned
+        /// @param engine_type Backend, AUTO falls back to a thread pool without io_uring
+        AsyncDiskManager(const std::string &db_file, size_t queue_depth = 64, bool direct_io = false,
+                         IOEngineType engine_type = IOEngineType::AUTO);
+
+        /// @brief Waits for outstanding requests, then closes DB file
+        ~AsyncDiskManager() override;
+
+        /// @brief Queues a page read into page_data, started by the next Submit
+        /// @param page_id Page to read
+        /// @param page_data Destination, PAGE_SIZE bytes
+        /// @param user_data Tag returned with the completion
+        /// @return False if the queue depth is exhausted (reap completions first)
+        bool SubmitRead(page_id_t page_id, char *page_data, uint64_t user_data);
+
+        /// @brief Queues a page write from page_data, started by the next Submit
+        /// @param page_id Page to write
+        /// @param page_data Source, PAGE_SIZE bytes, must stay valid until completed
+        /// @param user_data Tag returned with the completion
+        /// @return False if the queue depth is exhausted (reap completions first)
+        bool SubmitWrite(page_id_t page_id, const char *page_data, uint64_t user_data);
+
+        /// @brief Starts all queued requests with a single submission
+        /// @return Number of requests started
+        size_t Submit();
+
+        /// @brief Reaps finished requests, blocking until min_complete are available
+        /// @param completions Appended with finished requests (result is bytes or -errno)
+        /// @param min_complete Completions to wait for
+        /// @return Number of completions appended
+        size_t Complete(std::vector<IOCompletion> *completions, size_t min_complete);
+
+        /// @brief Registers memory (e.g. buffer_pool::GetFrameBuffers) with the engine so requests
+        /// into it skip per-request page pinning
+        /// @param buffers Regions to register
+        /// @return True if registered
+        bool RegisterBuffers(const std::vector<iovec> &buffers);
+
+        /// @brief Gets requests queued or started but not reaped
+        /// @return In-flight count
+        inline size_t InFlight()
+        {
+            return engine_->InFlight();
+        }
+
+        /// @brief Gets maximum requests in flight
+        /// @return Queue depth
+        inline size_t GetQueueDepth()
+        {
+            return engine_->QueueDepth();
+        }
+
+        /// @brief Gets backend in use
+        /// @return Engine name
+        inline const char *GetEngineName()
+        {
+            return engine_->Name();
+        }
+
+    private:
+        /// @brief Asynchronous backend
+        std::unique_ptr<IOEngine> engine_;
+
+        /// @brief Rejects page IDs outside the file
+        /// @param page_id Page to check
+        void CheckPageId(page_id_t page_id);
+    };
+}
@@ -0,0 +1,177 @@
+#include <cstdint>       // int32_t
+#include <utility>       // std::pair
+#include <vector>        // std::vector
+#include "common.h"
+#include "page.h"
+#include "buffer_pool.h"
+#include "index_key.h"
+#include "b_plus_tree_page.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Unique-key B+ tree index mapping keys to RIDs, with every node in a buffer pool page.
+    /// Leaves are searched by binary search over their key array; internal nodes store the prefix
+    /// their separators share once, so their fanout grows with it. Inserts split full nodes upward,
+    /// deletes borrow from or merge with a sibling when a node falls below half full, and merged
+    /// pages are freed. A header page records the root, so the tree can be reopened. Not
+    /// synchronized: callers keep writers and iterators of one tree apart. Compiled for int64_t
+    /// keys (Int64Comparator) and GenericKey<16>, <32> and <64> (GenericComparator)
+    /// @tparam KeyType Trivially copyable key with a KeyCodec
+    /// @tparam KeyComparator Functor returning <0, 0 or >0 like memcmp
+    /// @tparam PageSize Bytes per page, matching the pool
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    class BasicBPlusTree
+    {
+        using LeafNode = BPlusTreeLeafNode<KeyType, RID, PageSize>;
+        using InternalNode = BPlusTreeInternalNode<KeyType, PageSize>;
+
+    public:
+        /// @brief Forward iterator over leaf entries in key order, following sibling links. Keeps
+        /// the current leaf pinned. Move-only
+        class Iterator
+        {
+        public:
+            Iterator(Iterator &&other) noexcept;
+            Iterator(const Iterator &) = delete;
+            Iterator &operator=(const Iterator &) = delete;
+            Iterator &operator=(Iterator &&) = delete;
+
+            /// @brief Unpins the current leaf
+            ~Iterator();
+
+            /// @brief Checks for a current entry
+            /// @return False past the last key
+            inline bool Valid() const
+            {
+                return page_ != nullptr;
+            }
+
+            /// @brief Gets the current key
+            inline const KeyType &GetKey()
+            {
+                return LeafNode(page_->GetData()).KeyAt(index_);
+            }
+
+            /// @brief Gets the current value
+            inline const RID &GetValue()
+            {
+                return LeafNode(page_->GetData()).ValueAt(index_);
+            }
+
+            /// @brief Moves to the next key
+            void Next();
+
+        private:
+            friend class BasicBPlusTree;
+
+            /// @brief Starts at an entry of a pinned leaf, skipping to the next leaf if past its end
+            Iterator(basic_buffer_pool<PageSize> *pool, BasicPage<PageSize> *leaf, int index);
+
+            /// @brief Moves forward until index_ is inside a leaf, or becomes invalid
+            void SeekValid();
+
+            basic_buffer_pool<PageSize> *pool_;
+            BasicPage<PageSize> *page_;
+            int index_;
+        };
+
+        /// @brief Creates an empty tree: a header page and an empty root leaf
+        /// @param pool Pool to keep the nodes in
+        /// @param comparator Key order
+        explicit BasicBPlusTree(basic_buffer_pool<PageSize> *pool, const KeyComparator &comparator = KeyComparator());
+
+        /// @brief Opens an existing tree
+        /// @param pool Pool over the tree's database
+        /// @param header_page_id GetHeaderPageId of the tree when it was created
+        /// @param comparator Key order, the one the tree was built with
+        BasicBPlusTree(basic_buffer_pool<PageSize> *pool, page_id_t header_page_id,
+                       const KeyComparator &comparator = KeyComparator());
+
+        /// @brief Gets the page that identifies the tree
+        /// @return Header page ID
+        inline page_id_t GetHeaderPageId()
+        {
+            return header_page_id_;
+        }
+
+        /// @brief Point lookup
+        /// @param key Key to find
+        /// @param value Receives the RID
+        /// @return False if absent
+        bool GetValue(const KeyType &key, RID *value);
+
+        /// @brief Adds a key
+        /// @param key New key
+        /// @param value RID to map it to
+        /// @return False if the key exists
+        bool Insert(const KeyType &key, const RID &value);
+
+        /// @brief Removes a key
+        /// @param key Key to remove
+        /// @return False if absent
+        bool Remove(const KeyType &key);
+
+        /// @brief Starts a scan at the smallest key
+        /// @return Iterator, invalid for an empty tree
+        Iterator Begin();
+
+        /// @brief Starts a range scan
+        /// @param key Lower bound, inclusive
+        /// @return Iterator at the first key not less than key
+        Iterator Begin(const KeyType &key);
+
+        /// @brief Gets the number of levels
+        /// @return 1 for a tree that is a single leaf
+        int GetHeight();
+
+    private:
+        /// @brief Internal node visited on the way down and the child taken
+        using Path = std::vector<std::pair<page_id_t, int>>;
+
+        basic_buffer_pool<PageSize> *pool_;
+        KeyComparator comparator_;
+        page_id_t header_page_id_;
+        page_id_t root_page_id_;
+
+        /// @brief Descends to the leaf that covers a key
+        /// @param key Key to look for
+        /// @param path Receives the internal nodes visited, may be nullptr
+        /// @return Leaf, pinned
+        BasicPage<PageSize> *FindLeaf(const KeyType &key, Path *path);
+
+        /// @brief Position of the first key not less than key in a leaf
+        int LowerBound(LeafNode *leaf, const KeyType &key);
+
+        /// @brief Links a new right sibling into the parent, splitting upward as needed
+        /// @param path Ancestors of left, consumed
+        /// @param left Node that split
+        /// @param key Smallest key of right
+        /// @param right New node
+        void InsertIntoParent(Path *path, page_id_t left, const KeyType &key, page_id_t right);
+
+        /// @brief Writes edited entries back to an internal node, splitting it into a new right
+        /// sibling if they no longer fit, and unpins it
+        /// @param path Ancestors of the node, consumed
+        /// @param page_id Node
+        /// @param page Node's pinned page
+        /// @param keys Keys, key 0 ignored
+        /// @param children Child page IDs
+        void WriteInternal(Path *path, page_id_t page_id, BasicPage<PageSize> *page, const std::vector<KeyType> &keys,
+                           const std::vector<page_id_t> &children);
+
+        /// @brief Fixes an underfull node by borrowing from or merging with a sibling, then fixes
+        /// the parent if the merge left it underfull
+        /// @param path Ancestors of the node, consumed
+        /// @param page_id Underfull node
+        void Rebalance(Path *path, page_id_t page_id);
+
+        /// @brief Points the header page at a new root
+        void SetRoot(page_id_t page_id);
+    };
+
+    /// @brief B+ tree of the default PAGE_SIZE
+    template <typename KeyType, typename KeyComparator>
+    using BPlusTree = BasicBPlusTree<KeyType, KeyComparator, PAGE_SIZE>;
+}
@@ -0,0 +1,395 @@
+#include <cstddef>       // size_t
+#include <cstdint>       // uint8_t, uint16_t, uint32_t
+#include <cstring>       // memcpy, memmove
+#include <vector>        // std::vector
+#include "common.h"
+#include "page.h"
+#include "index_key.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Kind of B+ tree node
+    enum class BPlusTreeNodeType : uint32_t
+    {
+        INVALID = 0,
+        LEAF,
+        INTERNAL
+    };
+
+    /// @brief Bytes before a node's entries: the page header, then node type, entry count and a
+    /// few fields that depend on the kind of node
+    static constexpr uint32_t BPLUS_TREE_NODE_HEADER_SIZE = 32;
+
+    /// @brief B+ tree leaf layout over a page's data: after the page header the node type, entry
+    /// count and the next leaf, then all keys in one array and all RIDs in another, so a binary
+    /// search only touches key cache lines. Room is left for one entry past MAX_SIZE, so a leaf
+    /// can overflow before it splits. A view only: the caller pins the page and marks it dirty
+    /// @tparam KeyType Trivially copyable key
+    /// @tparam ValueType RID
+    /// @tparam PageSize Bytes per page
+    template <typename KeyType, typename ValueType, int32_t PageSize>
+    class BPlusTreeLeafNode
+    {
+    public:
+        /// @brief Views page data as a node
+        /// @param data PageSize bytes of a pinned frame
+        explicit BPlusTreeLeafNode(char *data) : data_(data) {}
+
+        /// @brief Formats an empty leaf, keeping the page LSN
+        inline void Init()
+        {
+            Write<uint32_t>(TYPE_OFFSET, static_cast<uint32_t>(BPlusTreeNodeType::LEAF));
+            SetSize(0);
+            SetNextPageId(INVALID_PAGE_ID);
+        }
+
+        inline BPlusTreeNodeType GetType()
+        {
+            return static_cast<BPlusTreeNodeType>(Read<uint32_t>(TYPE_OFFSET));
+        }
+
+        /// @brief Gets the entry count
+        inline int GetSize()
+        {
+            return static_cast<int>(Read<uint32_t>(SIZE_OFFSET));
+        }
+
+        inline void SetSize(int size)
+        {
+            Write<uint32_t>(SIZE_OFFSET, static_cast<uint32_t>(size));
+        }
+
+        /// @brief Gets the right sibling
+        inline page_id_t GetNextPageId()
+        {
+            return Read<page_id_t>(NEXT_PAGE_OFFSET);
+        }
+
+        inline void SetNextPageId(page_id_t page_id)
+        {
+            Write<page_id_t>(NEXT_PAGE_OFFSET, page_id);
+        }
+
+        /// @brief Gets the key array
+        inline KeyType *Keys()
+        {
+            return reinterpret_cast<KeyType *>(data_ + KEYS_OFFSET);
+        }
+
+        /// @brief Gets the value array
+        inline ValueType *Values()
+        {
+            return reinterpret_cast<ValueType *>(data_ + VALUES_OFFSET);
+        }
+
+        inline KeyType &KeyAt(int index)
+        {
+            return Keys()[index];
+        }
+
+        inline ValueType &ValueAt(int index)
+        {
+            return Values()[index];
+        }
+
+        /// @brief Inserts an entry, shifting later ones right
+        /// @param index Position of the new entry
+        inline void InsertAt(int index, const KeyType &key, const ValueType &value)
+        {
+            int size = GetSize();
+            memmove(Keys() + index + 1, Keys() + index, (size - index) * sizeof(KeyType));
+            memmove(Values() + index + 1, Values() + index, (size - index) * sizeof(ValueType));
+            memcpy(Keys() + index, &key, sizeof(KeyType));
+            memcpy(Values() + index, &value, sizeof(ValueType));
+            SetSize(size + 1);
+        }
+
+        /// @brief Removes an entry, shifting later ones left
+        /// @param index Entry to remove
+        inline void RemoveAt(int index)
+        {
+            int size = GetSize();
+            memmove(Keys() + index, Keys() + index + 1, (size - index - 1) * sizeof(KeyType));
+            memmove(Values() + index, Values() + index + 1, (size - index - 1) * sizeof(ValueType));
+            SetSize(size - 1);
+        }
+
+        /// @brief Moves entries [from, size) to the end of another leaf
+        /// @param to Receiving leaf
+        /// @param from First entry to move
+        inline void MoveTail(BPlusTreeLeafNode *to, int from)
+        {
+            int size = GetSize();
+            int to_size = to->GetSize();
+            memcpy(to->Keys() + to_size, Keys() + from, (size - from) * sizeof(KeyType));
+            memcpy(to->Values() + to_size, Values() + from, (size - from) * sizeof(ValueType));
+            to->SetSize(to_size + size - from);
+            SetSize(from);
+        }
+
+        /// @brief Entries that fit, one more than MAX_SIZE
+        static constexpr int CAPACITY = static_cast<int>(
+            (PageSize - BPLUS_TREE_NODE_HEADER_SIZE - alignof(ValueType)) / (sizeof(KeyType) + sizeof(ValueType)));
+
+        /// @brief Most entries a node keeps before it splits
+        static constexpr int MAX_SIZE = CAPACITY - 1;
+
+    private:
+        static constexpr uint32_t TYPE_OFFSET = BasicPage<PageSize>::HEADER_SIZE;
+        static constexpr uint32_t SIZE_OFFSET = TYPE_OFFSET + sizeof(uint32_t);
+        static constexpr uint32_t NEXT_PAGE_OFFSET = SIZE_OFFSET + sizeof(uint32_t);
+        static constexpr uint32_t KEYS_OFFSET = BPLUS_TREE_NODE_HEADER_SIZE;
+        static constexpr uint32_t VALUES_OFFSET =
+            (KEYS_OFFSET + CAPACITY * sizeof(KeyType) + alignof(ValueType) - 1) / alignof(ValueType) * alignof(ValueType);
+        static_assert(NEXT_PAGE_OFFSET + sizeof(page_id_t) <= KEYS_OFFSET, "B+ tree node header layout changed");
+        static_assert(CAPACITY >= 4, "Keys too large for the page size");
+
+        char *data_;
+
+        template <typename T>
+        inline T Read(uint32_t offset)
+        {
+            T value;
+            memcpy(&value, data_ + offset, sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        inline void Write(uint32_t offset, T value)
+        {
+            memcpy(data_ + offset, &value, sizeof(T));
+        }
+    };
+
+    /// @brief B+ tree internal node layout over a page's data, prefix compressed: the bytes every
+    /// separator key shares (KeyCodec encoding) are stored once, and each separator keeps only the
+    /// rest, length-prefixed and reached through an offset array. So keys with long common
+    /// prefixes, or GenericKeys much shorter than their slot, raise the fanout. After the common
+    /// header come the prefix, the child page IDs, the entry offsets, then the suffixes. Key 0 is
+    /// unused, and child i holds keys in [key i, key i+1). The entry count that fits depends on
+    /// the keys, so a node is read into vectors with Load, edited, and written back whole with
+    /// Store. A view only: the caller pins the page and marks it dirty
+    /// @tparam KeyType Key with a KeyCodec
+    /// @tparam PageSize Bytes per page
+    template <typename KeyType, int32_t PageSize>
+    class BPlusTreeInternalNode
+    {
+        using Codec = KeyCodec<KeyType>;
+
+    public:
+        /// @brief Views page data as a node
+        /// @param data PageSize bytes of a pinned frame
+        explicit BPlusTreeInternalNode(char *data) : data_(data) {}
+
+        /// @brief Formats an empty internal node, keeping the page LSN
+        inline void Init()
+        {
+            Write<uint32_t>(TYPE_OFFSET, static_cast<uint32_t>(BPlusTreeNodeType::INTERNAL));
+            Write<uint32_t>(SIZE_OFFSET, 0);
+            Write<uint16_t>(PREFIX_SIZE_OFFSET, 0);
+        }
+
+        inline BPlusTreeNodeType GetType()
+        {
+            return static_cast<BPlusTreeNodeType>(Read<uint32_t>(TYPE_OFFSET));
+        }
+
+        /// @brief Gets the number of children
+        inline int GetSize()
+        {
+            return static_cast<int>(Read<uint32_t>(SIZE_OFFSET));
+        }
+
+        inline page_id_t ChildAt(int index)
+        {
+            return Read<page_id_t>(ChildrenOffset(Read<uint16_t>(PREFIX_SIZE_OFFSET)) + index * sizeof(page_id_t));
+        }
+
+        /// @brief Decodes a separator key
+        /// @param index Entry, from 1
+        inline KeyType KeyAt(int index)
+        {
+            char bytes[Codec::MAX_BYTES];
+            size_t prefix_size = Read<uint16_t>(PREFIX_SIZE_OFFSET);
+            memcpy(bytes, data_ + PREFIX_OFFSET, prefix_size);
+            return DecodeSuffix(bytes, prefix_size, index);
+        }
+
+        /// @brief Finds the child that covers a key: the last whose separator is <= key, key 0
+        /// acting as minus infinity. Binary search, the prefix copied once
+        /// @param key Key to look for
+        /// @param comparator Key order
+        /// @return Child index
+        template <typename KeyComparator>
+        inline int ChildIndex(const KeyType &key, const KeyComparator &comparator)
+        {
+            char bytes[Codec::MAX_BYTES];
+            size_t prefix_size = Read<uint16_t>(PREFIX_SIZE_OFFSET);
+            memcpy(bytes, data_ + PREFIX_OFFSET, prefix_size);
+            int low = 1;
+            int high = GetSize();
+            while (low < high)
+            {
+                int mid = low + (high - low) / 2;
+                if (comparator(key, DecodeSuffix(bytes, prefix_size, mid)) < 0)
+                {
+                    high = mid;
+                }
+                else
+                {
+                    low = mid + 1;
+                }
+            }
+            return low - 1;
+        }
+
+        /// @brief Decodes every entry
+        /// @param keys Receives the keys, key 0 default constructed
+        /// @param children Receives the child page IDs
+        void Load(std::vector<KeyType> *keys, std::vector<page_id_t> *children)
+        {
+            int size = GetSize();
+            keys->resize(size);
+            children->resize(size);
+            for (int i = 0; i < size; i++)
+            {
+                (*children)[i] = ChildAt(i);
+                if (i > 0)
+                {
+                    (*keys)[i] = KeyAt(i);
+                }
+            }
+        }
+
+        /// @brief Replaces the node's entries
+        /// @param keys Keys, key 0 ignored
+        /// @param children Child page IDs
+        /// @param count Number of entries
+        /// @return False, leaving the node unchanged, if they do not fit in a page
+        bool Store(const KeyType *keys, const page_id_t *children, int count)
+        {
+            size_t prefix_size = 0;
+            if (Bytes(keys, count, &prefix_size) > static_cast<size_t>(PageSize))
+            {
+                return false;
+            }
+
+            char bytes[Codec::MAX_BYTES];
+            uint32_t children_offset = ChildrenOffset(prefix_size);
+            uint32_t slots_offset = children_offset + count * sizeof(page_id_t);
+            uint32_t entry_offset = slots_offset + count * sizeof(uint16_t);
+            for (int i = 0; i < count; i++)
+            {
+                size_t size = i > 0 ? Codec::Encode(keys[i], bytes) : prefix_size;
+                if (i == 1)
+                {
+                    memcpy(data_ + PREFIX_OFFSET, bytes, prefix_size);
+                }
+                Write<page_id_t>(children_offset + i * sizeof(page_id_t), children[i]);
+                Write<uint16_t>(slots_offset + i * sizeof(uint16_t), static_cast<uint16_t>(entry_offset));
+                data_[entry_offset] = static_cast<char>(size - prefix_size);
+                memcpy(data_ + entry_offset + 1, bytes + prefix_size, size - prefix_size);
+                entry_offset += static_cast<uint32_t>(1 + size - prefix_size);
+            }
+            Write<uint16_t>(PREFIX_SIZE_OFFSET, static_cast<uint16_t>(prefix_size));
+            Write<uint32_t>(SIZE_OFFSET, static_cast<uint32_t>(count));
+            return true;
+        }
+
+        /// @brief Gets the bytes a node holding some entries would use
+        /// @param keys Keys, key 0 ignored
+        /// @param count Number of entries
+        /// @param prefix_size Receives the bytes the keys share, may be nullptr
+        /// @return Bytes from the start of the page, more than PageSize if they do not fit
+        static size_t Bytes(const KeyType *keys, int count, size_t *prefix_size = nullptr)
+        {
+            char first[Codec::MAX_BYTES];
+            char bytes[Codec::MAX_BYTES];
+            size_t shared = count > 1 ? Codec::Encode(keys[1], first) : 0;
+            size_t total = 0;
+            for (int i = 1; i < count; i++)
+            {
+                size_t size = Codec::Encode(keys[i], bytes);
+                size_t common = 0;
+                while (common < shared && common < size && bytes[common] == first[common])
+                {
+                    common++;
+                }
+                shared = common;
+                total += size;
+            }
+            if (prefix_size != nullptr)
+            {
+                *prefix_size = shared;
+            }
+            // Every entry has a length byte, the prefix is dropped from all but key 0's (empty) one
+            return ChildrenOffset(shared) + count * (sizeof(page_id_t) + sizeof(uint16_t) + 1) + total -
+                   (count > 1 ? (count - 1) * shared : 0);
+        }
+
+        /// @brief Finds where to split entries into two nodes: near the middle, moved until both
+        /// halves fit. Entry split stays as key 0 of the right half and its key moves up
+        /// @param keys Keys, key 0 ignored
+        /// @param count Number of entries, more than fit in one node
+        /// @return Index of the first entry of the right half
+        static int SplitPoint(const KeyType *keys, int count)
+        {
+            int split = count / 2;
+            while (split > 2 && Bytes(keys, split) > static_cast<size_t>(PageSize))
+            {
+                split--;
+            }
+            while (split < count - 2 && Bytes(keys + split, count - split) > static_cast<size_t>(PageSize))
+            {
+                split++;
+            }
+            return split;
+        }
+
+    private:
+        static constexpr uint32_t TYPE_OFFSET = BasicPage<PageSize>::HEADER_SIZE;
+        static constexpr uint32_t SIZE_OFFSET = TYPE_OFFSET + sizeof(uint32_t);
+        static constexpr uint32_t PREFIX_SIZE_OFFSET = SIZE_OFFSET + sizeof(uint32_t);
+        static constexpr uint32_t PREFIX_OFFSET = BPLUS_TREE_NODE_HEADER_SIZE;
+        static constexpr size_t MAX_ENTRY_BYTES = sizeof(page_id_t) + sizeof(uint16_t) + 1 + Codec::MAX_BYTES;
+        static_assert(PREFIX_SIZE_OFFSET + sizeof(uint16_t) <= PREFIX_OFFSET, "B+ tree node header layout changed");
+        static_assert(Codec::MAX_BYTES <= 255, "Key suffix lengths are stored in one byte");
+        static_assert(PREFIX_OFFSET + Codec::MAX_BYTES + sizeof(page_id_t) + 8 * MAX_ENTRY_BYTES <= static_cast<size_t>(PageSize),
+                      "Keys too large for the page size");
+
+        char *data_;
+
+        /// @brief Child IDs start after the prefix, aligned
+        static inline uint32_t ChildrenOffset(size_t prefix_size)
+        {
+            return static_cast<uint32_t>((PREFIX_OFFSET + prefix_size + sizeof(page_id_t) - 1) / sizeof(page_id_t) *
+                                         sizeof(page_id_t));
+        }
+
+        /// @brief Completes a key from the prefix already in bytes and the suffix of an entry
+        inline KeyType DecodeSuffix(char *bytes, size_t prefix_size, int index)
+        {
+            uint32_t slots_offset = ChildrenOffset(prefix_size) + GetSize() * sizeof(page_id_t);
+            const char *entry = data_ + Read<uint16_t>(slots_offset + index * sizeof(uint16_t));
+            size_t suffix_size = static_cast<uint8_t>(entry[0]);
+            memcpy(bytes + prefix_size, entry + 1, suffix_size);
+            return Codec::Decode(bytes, prefix_size + suffix_size);
+        }
+
+        template <typename T>
+        inline T Read(uint32_t offset)
+        {
+            T value;
+            memcpy(&value, data_ + offset, sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        inline void Write(uint32_t offset, T value)
+        {
+            memcpy(data_ + offset, &value, sizeof(T));
+        }
+    };
+}
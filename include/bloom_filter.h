@@ -0,0 +1,37 @@
+#include <cstdint>       // uint32_t, uint64_t
+#include <string>        // std::string
+#include <string_view>   // std::string_view
+#include <vector>        // std::vector
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Blocked Bloom filter over key hashes, serialized as a string. Every key sets its
+    /// probes inside one 64-byte block picked by the hash, so a lookup touches a single cache line.
+    /// Probes are derived by double hashing from one 64-bit hash. The last byte records the probe
+    /// count, so readers need no parameters. At 10 bits per key about 1% of absent keys pass
+    class BloomFilter
+    {
+    public:
+        /// @brief Hashes a key for Build and MayContain
+        /// @param key Key bytes
+        /// @return 64-bit hash
+        static uint64_t Hash(std::string_view key);
+
+        /// @brief Builds a filter
+        /// @param hashes Hash of every key in the set
+        /// @param bits_per_key Filter size per key; the probe count follows from it
+        /// @return Serialized filter
+        static std::string Build(const std::vector<uint64_t> &hashes, int bits_per_key);
+
+        /// @brief Tests a key against a filter
+        /// @param filter Output of Build
+        /// @param hash Hash of the key
+        /// @return False if the key is certainly absent. An empty or malformed filter passes all
+        static bool MayContain(std::string_view filter, uint64_t hash);
+
+        /// @brief Bytes per block, one cache line
+        static constexpr uint32_t BLOCK_BYTES = 64;
+    };
+}
@@ -0,0 +1,73 @@
+#include <atomic>        // std::atomic
+#include <cstdint>       // uint64_t
+#include <vector>        // std::vector
+#include "common.h"
+
+#pragma once
+
+namespace minidb
+{
+    template <int32_t PageSize>
+    class basic_buffer_pool;
+
+    /// @brief Kinds of buffer access, after PostgreSQL's BufferAccessStrategy
+    enum class AccessType
+    {
+        NORMAL,     ///< Shared replacement, no ring
+        BULK_READ,  ///< Large scan: small ring, dirty ring frames are handed back instead of written
+        BULK_WRITE, ///< Bulk load: larger ring, dirty ring frames are written and reused
+        VACUUM      ///< Maintenance pass: small ring, dirty ring frames are written and reused
+    };
+
+    /// @brief Private ring of frames for one large sequential operation. Misses fetched through a
+    /// strategy recycle the ring's own frames instead of evicting from the rest of the pool, and hits
+    /// on ring frames are not recorded with the replacer, so a scan or bulk load cannot flush the hot
+    /// working set. Used by one operation (thread) against one buffer_pool at a time
+    class BufferAccessStrategy
+    {
+        template <int32_t PageSize>
+        friend class basic_buffer_pool;
+
+    public:
+        /// @brief Creates a strategy
+        /// @param type Access type
+        /// @param ring_size Frames in the ring, 0 picks the type's default for the pool's page size.
+        /// Capped at 1/8 of the pool
+        explicit BufferAccessStrategy(AccessType type, size_t ring_size = 0);
+
+        /// @brief Gets access type
+        /// @return Type
+        inline AccessType GetType()
+        {
+            return type_;
+        }
+
+        /// @brief Gets requested ring size
+        /// @return Ring size in frames, 0 for the type's default
+        inline size_t GetRingSize()
+        {
+            return ring_size_;
+        }
+
+        /// @brief Gets default ring size of a type (256 KiB for reads and vacuum, 16 MiB for writes)
+        /// @param type Access type
+        /// @param page_size Bytes per frame
+        /// @return Ring size in frames
+        static size_t DefaultRingSize(AccessType type, int32_t page_size = PAGE_SIZE);
+
+    private:
+        AccessType type_;
+        size_t ring_size_;
+
+        /// @brief Identifies ring ownership of frames, never reused
+        uint64_t id_;
+
+        /// @brief Frames in the ring, INVALID_FRAME_ID for slots not filled yet
+        std::vector<frame_id_t> ring_;
+
+        /// @brief Next slot to recycle
+        size_t current_ = 0;
+
+        static std::atomic<uint64_t> next_id_;
+    };
+}
@@ -7,41 +7,289 @@
 #include <fstream>       // std::fstream
 #include <stdexcept>     // std::runtime_error
 #include <iostream>      // std::cout
+#include <mutex>         // std::mutex, std::lock_guard
+#include <condition_variable> // std::condition_variable
+#include <deque>         // std::deque
+#include <thread>        // std::thread
+#include <unordered_set> // std::unordered_set
+#include <memory>        // std::unique_ptr
+#include <atomic>        // std::atomic
+#include <sys/uio.h>     // iovec
 #include "common.h"
 #include "page.h"
+#include "page_guard.h"
+#include "frame_arena.h"
 #include "disk_manager.h"
+#include "replacer.h"
+#include "stats.h"
+#include "rate_limiter.h"
+#include "buffer_access_strategy.h"
+#include "log_manager.h"
+#include "compressed_cache.h"
+
+#pragma once
+
 namespace minidb
 {
-    class buffer_pool
+    class parallel_buffer_pool;
+
+    template <int32_t PageSize>
+    class BasicAsyncContext;
+    template <int32_t PageSize>
+    class BasicFetchAwaiter;
+    template <int32_t PageSize>
+    struct BasicFetchWaiter;
+
+    /// @brief How dirty pages are written back by Checkpoint
+    struct CheckpointOptions
+    {
+        /// @brief Most adjacent pages merged into one vectored write
+        size_t max_pages_per_write = 64;
+
+        /// @brief Pages written between fdatasync calls, 0 syncs once after the last write
+        size_t pages_per_sync = 0;
+
+        /// @brief Write bandwidth cap in bytes per second, 0 for unlimited
+        uint64_t max_bytes_per_sec = 0;
+
+        /// @brief Issue fdatasync at all
+        bool sync = true;
+    };
+
+    /// @brief What a write-back pass did
+    struct WriteBackResult
+    {
+        size_t pages_written = 0;
+        size_t write_calls = 0;
+        size_t syncs = 0;
+    };
+
+    /// @brief Sequential read-ahead policy. The window starts at initial_window pages and doubles
+    /// on every sustained sequential step up to max_window, like Linux readahead; a random access
+    /// shrinks it back
+    struct ReadAheadOptions
+    {
+        bool enabled = false;
+        size_t initial_window = 4;
+        size_t max_window = 64;
+    };
+
+    /// @brief Prefetch effectiveness counters
+    struct ReadAheadStats
+    {
+        /// @brief Read-ahead windows triggered by sequential access
+        size_t windows_issued = 0;
+        /// @brief Pages loaded into frames by Prefetch or read-ahead
+        size_t pages_prefetched = 0;
+        /// @brief Prefetched pages later fetched
+        size_t prefetch_hits = 0;
+        /// @brief Prefetched pages evicted without ever being fetched
+        size_t prefetch_wasted = 0;
+    };
+
+    /// @brief Cache effectiveness counters, since the pool was created
+    struct BufferPoolStats
+    {
+        /// @brief FetchPage and FetchPages requests served from a frame
+        size_t hits = 0;
+        /// @brief Requests that read the page from disk
+        size_t misses = 0;
+        /// @brief Frames taken from another page
+        size_t evictions = 0;
+        /// @brief Evictions that had to write the victim first
+        size_t dirty_evictions = 0;
+        /// @brief Dirty pages written back by any path: eviction, FlushPage, Checkpoint,
+        /// CleanCandidates
+        size_t writebacks = 0;
+        /// @brief Requests that threw because every frame was pinned
+        size_t pin_failures = 0;
+        /// @brief FetchPageAsync misses that waited for a read already in flight instead of
+        /// issuing their own
+        size_t coalesced_misses = 0;
+        /// @brief Frames holding no page at the time of the snapshot
+        size_t free_frames = 0;
+        /// @brief Time FetchPage spent on misses: finding a frame, writing a dirty victim and
+        /// reading the page
+        LatencyHistogram fetch_miss_latency;
+    };
+
+    /// @brief Fixed-size page cache over a DiskManager. Every public method takes latch_,
+    /// so a single buffer_pool is safe to share between threads
+    /// @tparam PageSize Bytes per page, matching the disk manager
+    template <int32_t PageSize>
+    class basic_buffer_pool
     {
+        friend class parallel_buffer_pool;
+        friend class BasicAsyncContext<PageSize>;
+        friend class BasicFetchAwaiter<PageSize>;
+
     public:
-        buffer_pool(int frames, DiskManager *dm);
+        /// @brief Creates a pool of frames over a disk manager
+        /// @param frames Number of frames
+        /// @param dm Disk manager to read and write pages with
+        /// @param policy Page replacement policy
+        /// @param huge_pages Back frame data with explicit huge pages (MAP_HUGETLB) when reserved
+        basic_buffer_pool(int frames, BasicDiskManager<PageSize> *dm, ReplacerPolicy policy = ReplacerPolicy::LRU,
+                          bool huge_pages = false);
+
+        /// @brief Stops the prefetch thread
+        ~basic_buffer_pool();
 
         /// @brief Gets page from cache or disk (pins it)
         /// @param page_id Page ID to retrieve
+        /// @param strategy Optional ring for large sequential operations: a miss recycles a ring
+        /// frame instead of evicting from the shared pool
         /// @return Page with ID page_id
-        Page *FetchPage(page_id_t page_id);
+        BasicPage<PageSize> *FetchPage(page_id_t page_id, BufferAccessStrategy *strategy = nullptr);
+
+        /// @brief Gets many pages at once (pins each). Hits are resolved first, then frames are
+        /// reserved for all misses in one pass and the misses are read sorted by page ID, adjacent
+        /// pages merged into one vectored read. Does not feed sequential read-ahead. On failure no
+        /// page stays pinned
+        /// @param page_ids Page IDs to retrieve, duplicates are pinned once per occurrence
+        /// @param count Number of page IDs
+        /// @param pages Receives the page for each ID, in the same order
+        void FetchPages(const page_id_t *page_ids, size_t count, BasicPage<PageSize> **pages);
+
+        /// @brief Gets a page from a coroutine (pins it): co_await pool.FetchPageAsync(id, &context),
+        /// with async_context.h included. A hit resumes at once. A miss reserves a frame, queues
+        /// the read on the context and suspends without holding the latch; later requests for the
+        /// page, from any context, wait for that read instead of issuing their own, and all of
+        /// them resume when it completes. Does not feed sequential read-ahead
+        /// @param page_id Page ID to retrieve
+        /// @param context Event loop of the calling thread, which drives the read
+        /// @return Awaitable giving the page; throws std::runtime_error if every frame is pinned
+        /// or the read fails
+        BasicFetchAwaiter<PageSize> FetchPageAsync(page_id_t page_id, BasicAsyncContext<PageSize> *context);
 
         /// @brief Creates new page
         /// @param page_id page ID to assign
+        /// @param strategy Optional ring for bulk loads, see FetchPage
         /// @return Created Page
-        Page *NewPage(page_id_t *page_id);
+        BasicPage<PageSize> *NewPage(page_id_t *page_id, BufferAccessStrategy *strategy = nullptr);
+
+        /// @brief Fetches a page and takes its latch shared
+        /// @param page_id Page ID to retrieve
+        /// @return Guard that unlatches and unpins
+        BasicReadPageGuard<PageSize> FetchPageRead(page_id_t page_id);
+
+        /// @brief Fetches a page and takes its latch exclusive
+        /// @param page_id Page ID to retrieve
+        /// @return Guard that unlatches and unpins dirty
+        BasicWritePageGuard<PageSize> FetchPageWrite(page_id_t page_id);
+
+        /// @brief Fetches a page for an optimistic, latch-free read
+        /// @param page_id Page ID to retrieve
+        /// @return Guard holding the pin and the page version to validate against
+        BasicOptimisticPageGuard<PageSize> FetchPageOptimistic(page_id_t page_id);
+
+        /// @brief Creates a new page, latched exclusive
+        /// @param page_id page ID to assign
+        /// @return Guard that unlatches and unpins dirty
+        BasicWritePageGuard<PageSize> NewPageGuarded(page_id_t *page_id);
 
         /// @brief Decrements the page count and sets dirty flag
         /// @param page_id Page ID to decrement pin
         /// @param isDirty Set dirty
         void UnpinPage(page_id_t page_id, bool isDirty);
 
-        /// @brief Manually flush page
+        /// @brief Drops a page from the pool without writing it and frees it on disk for reuse
+        /// @param page_id Page to delete
+        /// @return False if the page is pinned
+        bool DeletePage(page_id_t page_id);
+
+        /// @brief Manually flush page. The page is pinned and latched shared while written, with
+        /// latch_ released, so do not call while holding its WritePageGuard
         /// @param page_id Page to flush
         void FlushPage(page_id_t page_id);
 
-        /// @brief Manuall flush all pages
+        /// @brief Manuall flush all pages. Only dirty pages are written, see Checkpoint
         void FlushAllPages();
 
+        /// @brief Writes every dirty page: sorted by page ID, adjacent pages merged into one
+        /// vectored write, clean frames skipped, one fdatasync per batch. The latch is only held
+        /// while collecting and releasing frames, which stay pinned during their write. Frames
+        /// are latched shared while written, so do not call while holding a WritePageGuard
+        /// @param options Batching, sync and rate limiting
+        /// @return Pages written, write calls and syncs
+        WriteBackResult Checkpoint(const CheckpointOptions &options = CheckpointOptions());
+
+        /// @brief Writes the dirty pages among the next count eviction candidates, so the
+        /// eviction path finds clean victims. Used by PageCleaner, does not sync
+        /// @param count Candidates to look at
+        /// @param limiter Optional bandwidth limiter
+        /// @return Pages written and write calls
+        WriteBackResult CleanCandidates(size_t count, RateLimiter *limiter = nullptr);
+
+        /// @brief Hints that pages [first, first + count) will be needed. They are read in the
+        /// background with vectored reads and placed in frames unpinned. Only free frames and clean
+        /// victims are used, and errors drop the pages rather than reaching anyone
+        /// @param first First page ID
+        /// @param count Number of pages
+        void Prefetch(page_id_t first, size_t count);
+
+        /// @brief Enables or disables sequential read-ahead on the FetchPage stream
+        /// @param options Window policy
+        void SetReadAhead(const ReadAheadOptions &options);
+
+        /// @brief Gets prefetch counters
+        /// @return Snapshot of counters
+        ReadAheadStats GetReadAheadStats();
+
+        /// @brief Gets hit, miss, eviction and write-back counters and the miss latency histogram.
+        /// Counters are striped per thread and summed here, so the hit path never shares a
+        /// cache line with other threads for them
+        /// @return Snapshot of counters
+        BufferPoolStats GetStats();
+
+        /// @brief Waits until queued prefetch requests are finished
+        void WaitForPrefetch();
+
+        /// @brief Enforces write-ahead logging: before a dirty page is written back (eviction,
+        /// FlushPage, Checkpoint, CleanCandidates) the log is flushed up to the page's LSN
+        /// @param log_manager Log to flush, nullptr to write pages without it
+        void SetLogManager(LogManager *log_manager);
+
+        /// @brief Adds a compressed second tier: evicted pages are stored in it once clean,
+        /// compressed with latch_ released, and a FetchPage or FetchPages miss looks there before
+        /// reading the disk. Writing a page back drops its copy. Strategy rings do not feed it, so large scans do not flush it
+        /// @param cache Cache to use, may be shared between pools of one disk manager; nullptr
+        /// to detach
+        void SetSecondaryCache(BasicCompressedCache<PageSize> *cache);
+
+        /// @brief Checks whether a page is cached, without pinning it or touching the replacer
+        /// @param page_id Page to look up
+        /// @return True if resident
+        bool IsResident(page_id_t page_id);
+
+        /// @brief Gets frame memory, e.g. to register with AsyncDiskManager::RegisterBuffers
+        /// @return One region per frame
+        std::vector<iovec> GetFrameBuffers();
+
+        /// @brief Gets number of frames in this pool
+        /// @return Pool size
+        inline size_t GetPoolSize()
+        {
+            return pool_size_;
+        }
+
+        /// @brief Gets bytes per page
+        /// @return PageSize
+        static constexpr int32_t GetPageSize()
+        {
+            return PageSize;
+        }
+
     private:
-        /// @brief Contiguous memory-list of pages. This is cache
-        std::vector<Page> pages_;
+        /// @brief Guards page_table_, free_list and replacer state. Not held while dirty pages are
+        /// written back, nor while taking a page latch
+        std::mutex latch_;
+
+        /// @brief Frame data, one aligned mapping for the whole pool. This is cache
+        BasicFrameArena<PageSize> arena_;
+
+        /// @brief Frame descriptors, indexed by frame ID and pointing into arena_
+        std::vector<BasicPage<PageSize>> pages_;
 
         /// @brief Lookup table to see if pages are in cache. Map pageID to frameID
         std::unordered_map<page_id_t, frame_id_t> page_table_;
@@ -49,75 +297,194 @@ namespace minidb
         /// @brief Tracks unused frames, or free frames
         std::list<frame_id_t> free_list;
 
-        /// @brief Tracks Least Recently Used, end node is candidate for removal
-        std::list<frame_id_t> lru_list_;
+        /// @brief Chooses eviction victims among unpinned frames
+        std::unique_ptr<Replacer> replacer_;
 
-        /// @brief Maps frame ID to position in LRU list
-        std::unordered_map<frame_id_t, std::list<frame_id_t>::iterator> lru_map_;
+        /// @brief How many frames in buffer pool
+        size_t pool_size_;
 
         /// @brief Pointer to a disk manager it will use
-        DiskManager *disk_manager_;
+        BasicDiskManager<PageSize> *disk_manager_;
 
-        /// @brief How many frames in buffer pool
-        size_t pool_size_;
+        /// @brief Log flushed before dirty pages are written, may be nullptr
+        std::atomic<LogManager *> log_manager_{nullptr};
 
-        /// @brief Eviction logic for FetchPage and NewPage
-        /// @param frame_id frame to evict
-        /// @return True if found, false if all pinned
-        bool FindVictim(frame_id_t *frame_id_ptr)
-        {
-            for (int i = lru_list_.size() - 1; i >= 0; i--)
-            {
-                if (pages_[i].GetPinCount() == 0) // No one is using this page
-                {
-                    *frame_id_ptr = i;
-                    return true;
-                }
-            }
-            return false;
-        }
+        /// @brief Compressed tier for evicted pages, may be nullptr. Its copies match the disk
+        std::atomic<BasicCompressedCache<PageSize> *> secondary_cache_{nullptr};
 
-        /// @brief Add frame to LRU to front
-        /// @param frame_id Frame to add
-        /// @return If success
-        bool AddToLRU(frame_id_t frame_id)
-        {
-            lru_list_.push_front(frame_id);
-            lru_map_[frame_id] = lru_list_.begin();
-            return true;
-        }
+        /// @brief Frames filled by prefetch and not fetched since. Guarded by latch_
+        std::vector<bool> prefetched_;
+
+        /// @brief Strategy ring owning each frame, 0 for shared frames. Guarded by latch_
+        std::vector<uint64_t> frame_ring_;
 
-        /// @brief Frame to remove from LRU
-        /// @param frame_id frame to remove
-        /// @return If success
-        bool RemoveFromLRU(frame_id_t frame_id)
+        /// @brief Pages being read by the prefetcher. Dropped when the page becomes resident or is
+        /// written, so a stale read is never installed. Guarded by latch_
+        std::unordered_set<page_id_t> prefetch_pending_;
+
+        /// @brief FetchPageAsync read of one page into a reserved frame, outside page_table_
+        /// until it completes
+        struct AsyncRead
         {
-            auto lru_position = lru_map_.find(frame_id);
-            if (lru_position != lru_map_.end()) // if lru_position was found
-            {
-                lru_list_.erase(lru_position->second);
-                lru_map_.erase(frame_id);
-                return true;
-            }
-            return false;
-        }
+            frame_id_t frame_id;
+            /// @brief Coroutines to resume, linked through BasicFetchWaiter::next
+            BasicFetchWaiter<PageSize> *waiters;
+            /// @brief Context driving the read
+            BasicAsyncContext<PageSize> *context;
+            /// @brief Another path loaded, created or deleted the page meanwhile, so the data read
+            /// may be older than the page
+            bool stale;
+        };
+
+        /// @brief Asynchronous reads in flight by page. Guarded by latch_
+        std::unordered_map<page_id_t, AsyncRead> async_reads_;
+
+        /// @brief Read-ahead policy and sequential detection state. Guarded by latch_
+        ReadAheadOptions read_ahead_;
+        page_id_t last_fetched_ = INVALID_PAGE_ID;
+        page_id_t read_ahead_next_ = INVALID_PAGE_ID;
+        size_t read_ahead_window_ = 0;
+        ReadAheadStats read_ahead_stats_;
+
+        /// @brief Counters behind GetStats, updated without latch_
+        StripedCounter hits_;
+        StripedCounter misses_;
+        StripedCounter evictions_;
+        StripedCounter dirty_evictions_;
+        StripedCounter writebacks_;
+        StripedCounter pin_failures_;
+        StripedCounter coalesced_;
+        ConcurrentLatencyHistogram fetch_miss_latency_;
+
+        /// @brief Prefetch request queue, guarded by prefetch_latch_
+        std::mutex prefetch_latch_;
+        std::condition_variable prefetch_cv_;
+        std::deque<std::pair<page_id_t, size_t>> prefetch_queue_;
+        size_t prefetch_active_ = 0;
+        bool prefetch_stop_ = false;
+        std::thread prefetch_thread_;
 
-        /// @brief Move frame ID to front of LRU (Recently used)
-        /// @param frame_id Frame that was used
-        /// @return If success
-        bool UpdateLRU(frame_id_t frame_id)
+        /// @brief Serves a FetchPageAsync request: pins a resident page, joins the read in flight
+        /// for it, or reserves a frame and queues a read on the waiter's context
+        /// @param page_id Page to fetch
+        /// @param waiter Request, with its coroutine and context set
+        /// @return True if the coroutine stays suspended, false if waiter has its page or error
+        bool StartFetchAsync(page_id_t page_id, BasicFetchWaiter<PageSize> *waiter);
+
+        /// @brief Installs a completed asynchronous read, pins the page once per waiter and posts
+        /// every waiter to its context. A stale read yields to the resident page, or is queued
+        /// again if the page is gone. Called by the context that drove the read
+        /// @param page_id Page that was read
+        /// @param result Bytes read, or -errno
+        void FinishFetchAsync(page_id_t page_id, int32_t result);
+
+        /// @brief Pins a resident page for a request. Caller must hold latch_
+        /// @param frame_id Frame of the page
+        /// @param page_id Page in the frame
+        /// @return Pinned page
+        BasicPage<PageSize> *PinResident(frame_id_t frame_id, page_id_t page_id);
+
+        /// @brief Keeps background and asynchronous reads of a page that another path just
+        /// loaded, created or deleted from installing their older copy. Caller must hold latch_
+        /// @param page_id Page concerned
+        void DropPendingReads(page_id_t page_id);
+
+        /// @brief Prefetch worker loop
+        void RunPrefetcher();
+
+        /// @brief Reads one prefetch request and installs the pages that are still wanted
+        /// @param first First page ID
+        /// @param count Number of pages
+        /// @param buffer Aligned scratch space for count pages
+        void LoadPrefetch(page_id_t first, size_t count, char *buffer);
+
+        /// @brief Updates sequential detection for a fetch and queues a window if needed.
+        /// Caller must hold latch_
+        /// @param page_id Page being fetched
+        void TrackSequential(page_id_t page_id);
+
+        /// @brief Queues a prefetch request, starting the worker on first use
+        /// @param first First page ID
+        /// @param count Number of pages
+        void QueuePrefetch(page_id_t first, size_t count);
+
+        /// @brief Places an already allocated page into a frame (pins it)
+        /// @param page_id Page ID returned by DiskManager::AllocatePage
+        /// @return Created Page
+        BasicPage<PageSize> *InstallNewPage(page_id_t page_id);
+
+        /// @brief Resets a frame and maps it to a new page (pins it). Caller must hold latch_
+        /// @param frame_id Unused frame
+        /// @param page_id Page ID to assign
+        /// @return Created Page
+        BasicPage<PageSize> *InitNewFrame(frame_id_t frame_id, page_id_t page_id);
+
+        /// @brief Gets a frame from the free list, or evicts a victim. A dirty victim is written
+        /// back with latch_ released, so callers must look up again whatever they found before
+        /// @param frame_id_ptr Frame that is now unused
+        /// @param lock Caller's hold on latch_
+        /// @param write_dirty Evict dirty pages too. Otherwise only a clean page among the next
+        /// eviction candidates is taken
+        /// @return True if found, false if all pinned (or, without write_dirty, all dirty)
+        /// @throws std::runtime_error if writing a victim or flushing the log for it fails
+        bool AcquireFrame(frame_id_t *frame_id_ptr, std::unique_lock<std::mutex> &lock, bool write_dirty = true);
+
+        /// @brief Gets a frame for a strategy miss: the ring's next slot if it is unpinned and still
+        /// owned by the ring, otherwise a frame from AcquireFrame that then joins the ring. May
+        /// release latch_ like AcquireFrame
+        /// @param strategy Ring to take the frame for
+        /// @param frame_id_ptr Frame that is now unused
+        /// @param lock Caller's hold on latch_
+        /// @return True if found, false if all pinned
+        bool AcquireRingFrame(BufferAccessStrategy *strategy, frame_id_t *frame_id_ptr,
+                              std::unique_lock<std::mutex> &lock);
+
+        /// @brief Writes an unpinned dirty frame that the replacer will not hand out, for eviction.
+        /// The frame is pinned and latch_ released while the log is flushed to the page LSN and the
+        /// page written under its shared latch, which is only tried: a latched page is skipped
+        /// @param frame_id Frame to write
+        /// @param lock Caller's hold on latch_, held again on return
+        /// @return True if written and still unpinned and clean, so the frame can be reused. On
+        /// false the caller makes an unpinned frame evictable again
+        /// @throws std::runtime_error if the write or the log flush fails; the frame is then dirty
+        /// and evictable again
+        bool WriteBackVictim(frame_id_t frame_id, std::unique_lock<std::mutex> &lock);
+
+        /// @brief Frame pinned for write-back and the page it held
+        struct WriteBackFrame
         {
-            auto lru_position = lru_map_.find(frame_id);
-            if (lru_position != lru_map_.end()) // if lru_position was found
-            {
-                lru_list_.erase(lru_position->second);
-                lru_map_.erase(frame_id);
-
-                lru_list_.push_front(frame_id);
-                lru_map_[frame_id] = lru_list_.begin();
-                return true;
-            }
-            return false;
-        }
+            page_id_t page_id;
+            frame_id_t frame_id;
+        };
+
+        /// @brief Pins a dirty frame and clears its dirty flag, so changes made during the write
+        /// re-dirty it. Caller must hold latch_
+        /// @param frame_id Frame to take
+        /// @param frames Appended with the frame
+        void PinForWriteBack(frame_id_t frame_id, std::vector<WriteBackFrame> *frames);
+
+        /// @brief Writes pinned frames sorted by page ID with coalesced vectored writes, then
+        /// unpins them. Called without latch_; on failure the frames are marked dirty again
+        /// @param frames Frames from PinForWriteBack
+        /// @param options Batching and sync
+        /// @param limiter Optional bandwidth limiter
+        /// @return Pages written, write calls and syncs
+        WriteBackResult WriteBack(std::vector<WriteBackFrame> *frames, const CheckpointOptions &options,
+                                  RateLimiter *limiter);
+
+        /// @brief Drops the shared latches WriteBack took on frames [start, end)
+        void UnlatchRun(const std::vector<WriteBackFrame> &frames, size_t start, size_t end);
+
+        /// @brief Releases frames pinned by PinForWriteBack
+        /// @param frames Frames to unpin
+        /// @param redirty Mark them dirty again (write failed)
+        void UnpinAfterWriteBack(const std::vector<WriteBackFrame> &frames, bool redirty);
+
+        /// @brief Drops a page from the compressed tier, if there is one
+        /// @param page_id Page that was written back, deleted or reallocated
+        void EraseFromSecondary(page_id_t page_id);
+
     };
+    /// @brief Buffer pool of the default PAGE_SIZE
+    using buffer_pool = basic_buffer_pool<PAGE_SIZE>;
 }
\ No newline at end of file
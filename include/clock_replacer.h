@@ -0,0 +1,43 @@
+#include <cstdint>       // uint8_t
+#include <vector>        // std::vector
+#include "common.h"
+#include "replacer.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Second-chance CLOCK. A hit only sets a reference bit; the hand clears bits as it
+    /// sweeps and stops at the first unreferenced evictable frame, amortized O(1) per eviction
+    class ClockReplacer : public Replacer
+    {
+    public:
+        /// @brief Creates replacer for num_frames frames
+        /// @param num_frames Number of frames in the pool
+        explicit ClockReplacer(size_t num_frames);
+
+        void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+        void SetEvictable(frame_id_t frame_id, bool evictable) override;
+        bool Evict(frame_id_t *frame_id_ptr) override;
+        void Remove(frame_id_t frame_id) override;
+        void GetCandidates(size_t count, std::vector<frame_id_t> *candidates) override;
+        size_t Size() override;
+
+    private:
+        /// @brief Per-frame state bits, one byte per frame keeps the sweep dense
+        enum : uint8_t
+        {
+            TRACKED = 1,
+            EVICTABLE = 2,
+            REFERENCED = 4
+        };
+
+        std::vector<uint8_t> state_;
+
+        /// @brief Next frame the hand looks at
+        size_t hand_ = 0;
+
+        /// @brief Number of tracked, evictable frames
+        size_t evictable_count_ = 0;
+    };
+}
@@ -12,18 +12,46 @@
 
 namespace minidb
 {
-    /// @brief Page identifier on disk memory
-    using page_id_t = int32_t;
+    /// @brief Page identifier on disk memory, 64-bit so databases are not capped at 2^31 pages
+    using page_id_t = int64_t;
 
     /// @brief Slot identifier in buffer pool
     using frame_id_t = int32_t;
 
-    /// @brief Bytes per page
+    /// @brief Bytes per page of the default Page, DiskManager and buffer_pool. The Basic* templates
+    /// take the page size as a parameter and are compiled for 4, 8, 16 and 64 KiB
     const int32_t PAGE_SIZE = 4096;
 
+    /// @brief Alignment of frame memory, required for O_DIRECT transfers
+    const int32_t PAGE_ALIGNMENT = 4096;
+
     /// @brief ERROR: No page found
-    const int32_t INVALID_PAGE_ID = -1;
+    const page_id_t INVALID_PAGE_ID = -1;
 
     /// @brief ERROR: No frame found
     const int32_t INVALID_FRAME_ID = -1;
+
+    /// @brief Log sequence number: byte offset of a record in the write-ahead log
+    using lsn_t = int64_t;
+
+    /// @brief Transaction identifier
+    using txn_id_t = int64_t;
+
+    /// @brief ERROR: No log record
+    const lsn_t INVALID_LSN = -1;
+
+    /// @brief ERROR: No transaction
+    const txn_id_t INVALID_TXN_ID = -1;
+
+    /// @brief Record identifier: page and slot of a tuple
+    struct RID
+    {
+        page_id_t page_id = INVALID_PAGE_ID;
+        uint32_t slot = 0;
+
+        inline bool operator==(const RID &other) const
+        {
+            return page_id == other.page_id && slot == other.slot;
+        }
+    };
 }
\ No newline at end of file
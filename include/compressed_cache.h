@@ -0,0 +1,182 @@
+#include <cstdint>       // int32_t, uint16_t, uint32_t, uint64_t
+#include <list>          // std::list
+#include <memory>        // std::unique_ptr
+#include <mutex>         // std::mutex
+#include <unordered_map> // std::unordered_map
+#include <vector>        // std::vector
+#include "common.h"
+#include "lz_codec.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief What the compressed cache holds and how well it does, since it was created
+    struct CompressedCacheStats
+    {
+        /// @brief Get calls that found the page
+        uint64_t hits = 0;
+        /// @brief Get calls that did not
+        uint64_t misses = 0;
+        /// @brief Pages compressed and stored by Put
+        uint64_t stores = 0;
+        /// @brief Evictions that found their page still cached and skipped compression
+        uint64_t touches = 0;
+        /// @brief Pages erased as stale, Puts voided by an Erase after BeginPut included
+        uint64_t invalidations = 0;
+        /// @brief Put calls whose page did not compress below MAX_STORED_BYTES
+        uint64_t rejected = 0;
+        /// @brief Pages dropped to make room
+        uint64_t evictions = 0;
+        /// @brief Pages currently stored
+        size_t pages = 0;
+        /// @brief Compressed bytes of the stored pages
+        uint64_t compressed_bytes = 0;
+        /// @brief Bytes of slabs handed out to size classes, slot rounding included
+        uint64_t slab_bytes = 0;
+        /// @brief Memory budget
+        uint64_t capacity_bytes = 0;
+    };
+
+    /// @brief Second cache tier for pages evicted from a buffer pool, kept LZ-compressed in
+    /// memory so a re-fetch decompresses instead of reading the disk. The budget is split into
+    /// slabs of SLAB_BYTES that are given to size classes (multiples of PageSize / 32) on demand;
+    /// a slab holds equal slots of its class and goes back to the shared pool once empty. When no
+    /// slot is free the least recently evicted page is dropped, whatever its class, until one is.
+    /// Entries are copies of the page on disk, so dropping one never loses data. Get leaves the
+    /// entry in place: a page that goes back to the pool and is evicted again unchanged only needs
+    /// Touch, not another compression. The pool must Erase a page whenever it writes it back.
+    /// Thread-safe, so shards of a parallel_buffer_pool can share one
+    /// @tparam PageSize Bytes per page, matching the pool
+    template <int32_t PageSize>
+    class BasicCompressedCache
+    {
+    public:
+        /// @brief Reserves the arena. Memory is only touched as slabs fill
+        /// @param capacity_bytes Budget for compressed pages, rounded down to whole slabs
+        explicit BasicCompressedCache(uint64_t capacity_bytes);
+
+        BasicCompressedCache(const BasicCompressedCache &) = delete;
+        BasicCompressedCache &operator=(const BasicCompressedCache &) = delete;
+
+        /// @brief Announces a Put the caller will make after releasing its own latch, e.g. a pool
+        /// compressing an evicted page outside its latch. Until then, an Erase of the page voids
+        /// that Put, so a copy older than a write-back is never stored
+        /// @param page_id Page ID
+        /// @return Ticket to pass to Put
+        uint64_t BeginPut(page_id_t page_id);
+
+        /// @brief Stores a clean copy of a page, replacing any older copy
+        /// @param page_id Page ID
+        /// @param data PageSize bytes, equal to the page on disk
+        /// @param ticket From BeginPut, or 0 when the copy is known to be current
+        /// @return False if the page did not compress well enough to keep (any older copy is
+        /// dropped too), or if it was erased since BeginPut
+        bool Put(page_id_t page_id, const char *data, uint64_t ticket = 0);
+
+        /// @brief Decompresses a cached page
+        /// @param page_id Page ID
+        /// @param data Receives PageSize bytes
+        /// @return False if the page is not cached
+        bool Get(page_id_t page_id, char *data);
+
+        /// @brief Marks a cached page as just evicted, so it is dropped last
+        /// @param page_id Page ID
+        /// @return False if the page is not cached and needs a Put
+        bool Touch(page_id_t page_id);
+
+        /// @brief Drops a page because its copy is stale (written back, deleted, reallocated)
+        /// @param page_id Page ID
+        void Erase(page_id_t page_id);
+
+        /// @brief Gets counters and occupancy
+        /// @return Snapshot
+        CompressedCacheStats GetStats();
+
+        /// @brief Bytes per slab, enough for 16 uncompressed pages
+        static constexpr uint64_t SLAB_BYTES = 16 * static_cast<uint64_t>(PageSize);
+
+        /// @brief Slot size step between size classes
+        static constexpr uint32_t CLASS_GRANULE = PageSize / 32;
+
+        /// @brief Largest compressed page kept; less than a 25% saving is not worth the CPU
+        static constexpr uint32_t MAX_STORED_BYTES = PageSize / 4 * 3;
+
+        static constexpr int NUM_CLASSES = MAX_STORED_BYTES / CLASS_GRANULE;
+
+    private:
+        static constexpr uint32_t NO_SLAB = UINT32_MAX;
+
+        struct Slab
+        {
+            /// @brief Size class, -1 while in free_slabs_
+            int size_class = -1;
+            uint32_t used = 0;
+            std::vector<uint16_t> free_slots;
+            /// @brief Neighbours in the class's list of slabs with free slots
+            uint32_t prev = NO_SLAB;
+            uint32_t next = NO_SLAB;
+        };
+
+        struct Entry
+        {
+            uint32_t slab;
+            uint16_t slot;
+            uint32_t size;
+            std::list<page_id_t>::iterator lru;
+        };
+
+        std::mutex latch_;
+        uint64_t capacity_bytes_;
+        std::unique_ptr<char[]> arena_;
+
+        std::vector<Slab> slabs_;
+        std::vector<uint32_t> free_slabs_;
+        /// @brief Per class, head of the list of slabs with a free slot
+        std::vector<uint32_t> partial_;
+
+        std::unordered_map<page_id_t, Entry> entries_;
+        /// @brief Most recently stored or touched first
+        std::list<page_id_t> lru_;
+
+        /// @brief Puts announced by BeginPut and not made yet
+        struct PendingPut
+        {
+            uint32_t count = 0;
+            /// @brief Ticket sequence at the last Erase of the page, 0 if none
+            uint64_t erased_at = 0;
+        };
+
+        std::unordered_map<page_id_t, PendingPut> pending_;
+        uint64_t sequence_ = 0;
+
+        CompressedCacheStats stats_;
+
+        static inline uint32_t ClassSize(int size_class)
+        {
+            return (static_cast<uint32_t>(size_class) + 1) * CLASS_GRANULE;
+        }
+
+        inline char *SlotData(uint32_t slab, uint16_t slot)
+        {
+            return arena_.get() + slab * SLAB_BYTES + static_cast<uint64_t>(slot) * ClassSize(slabs_[slab].size_class);
+        }
+
+        /// @brief Finds a slot of a class, taking a free slab or evicting as needed. Caller must
+        /// hold latch_
+        /// @return False if the budget is smaller than one slab
+        bool AllocateSlot(int size_class, uint32_t *slab_ptr, uint16_t *slot_ptr);
+
+        /// @brief Adds a slab to its class's list of slabs with free slots
+        void LinkPartial(uint32_t slab);
+
+        /// @brief Takes a slab off its class's list
+        void UnlinkPartial(uint32_t slab);
+
+        /// @brief Drops an entry and frees its slot. Caller must hold latch_
+        void RemoveEntry(typename std::unordered_map<page_id_t, Entry>::iterator entry);
+    };
+
+    /// @brief Compressed cache of the default PAGE_SIZE
+    using CompressedCache = BasicCompressedCache<PAGE_SIZE>;
+}
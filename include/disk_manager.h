@@ -7,21 +7,73 @@
 #include <fstream>       // std::fstream
 #include <stdexcept>     // std::runtime_error
 #include <iostream>      // std::cout
+#include <atomic>        // std::atomic
+#include <memory>        // std::unique_ptr
+#include <mutex>         // std::mutex
+#include <sys/types.h>   // off_t
+#include <sys/uio.h>     // iovec
 #include "common.h"
+#include "stats.h"
 
 #pragma once
 
 namespace minidb
 {
-    class DiskManager
+    /// @brief Layout choices fixed when a DB file is created
+    struct StorageOptions
     {
+        /// @brief Bytes per segment file, a multiple of the page size. Ignored when opening an
+        /// existing database, which keeps the size it was created with
+        uint64_t segment_bytes = 1ULL << 30;
+
+        /// @brief Reserve blocks with fallocate when growing. Off, segments grow as sparse files
+        bool preallocate = true;
+    };
+
+    /// @brief I/O counters of a disk manager since it was opened: one per read or write system
+    /// call, metadata pages included
+    struct DiskStats
+    {
+        uint64_t reads = 0;
+        uint64_t writes = 0;
+        uint64_t bytes_read = 0;
+        uint64_t bytes_written = 0;
+        /// @brief Duration of ReadPage calls; vectored reads are not included
+        LatencyHistogram read_page_latency;
+        /// @brief Duration of WritePage calls; vectored writes are not included
+        LatencyHistogram write_page_latency;
+    };
+
+    /// @brief Page store with positional I/O, split across segment files of equal size: the DB
+    /// file itself, then <db_file>.1, <db_file>.2, ... opened on first access, so each can be a
+    /// symlink to another device. Physical page 0 is a header (format, page and segment size, page
+    /// count, free-page hint) and every group of PageSize * 8 data pages is preceded by one bitmap
+    /// page marking which of them are allocated. Page IDs only count data pages, so they stay dense
+    /// from 0. Opening reads the header alone; bitmaps are loaded when allocation needs them.
+    /// Header and bitmaps are written back by Sync and on close. So that a crash of the process
+    /// neither hands out an ID twice nor loses freed pages, a bitmap page is also written whenever
+    /// a page is reused, bitmap and header whenever one is freed, and before appending past the
+    /// reserved page count the header is written with every page the file has room for reserved;
+    /// reopening after a crash marks the reserved pages past the page count allocated. Only that
+    /// reservation is synced; the other writes reach stable storage with the next Sync
+    /// @tparam PageSize Bytes per page
+    template <int32_t PageSize>
+    class BasicDiskManager
+    {
+        static_assert(PageSize > 0 && PageSize % PAGE_ALIGNMENT == 0, "Page size must be a multiple of PAGE_ALIGNMENT");
+
     public:
-        /// @brief Opens DB file and manages page ID with file sizes
-        /// @param db_file DB file to open
-        DiskManager(const std::string &db_file);
+        /// @brief Opens or creates DB file. All I/O is positional (pread/pwrite) so one
+        /// DiskManager can be used from many threads
+        /// @param db_file DB file to open, the first segment
+        /// @param direct_io Open with O_DIRECT, bypassing the OS page cache
+        /// @param options Segment size for new databases, and extension mode
+        /// @throws std::runtime_error if the file is not a DB file of this page size
+        BasicDiskManager(const std::string &db_file, bool direct_io = false,
+                         const StorageOptions &options = StorageOptions());
 
-        /// @brief Closes DB file
-        ~DiskManager();
+        /// @brief Writes back allocation metadata and closes segment files
+        virtual ~BasicDiskManager();
 
         /// @brief Reads page from disk into buffer pool. Called on cache miss
         /// @param page_id Page ID to insert into buffer pool
@@ -33,21 +85,233 @@ namespace minidb
         /// @param page_data Page to data to flush
         void WritePage(page_id_t page_id, const char *page_data);
 
-        /// @brief Returns next Page ID and extends file. Buffer pool calls this when creating new pages
-        /// @return Next page ID
-        page_id_t AllocatePage();
+        /// @brief Reads consecutive pages with vectored reads (preadv), one per bitmap group or
+        /// segment crossed. Pages past the end of the file read as zeros
+        /// @param first_page_id Page ID of pages[0], pages[i] gets first_page_id + i
+        /// @param pages One PageSize buffer per page
+        /// @param count Number of pages, at most IOV_MAX
+        void ReadPages(page_id_t first_page_id, const iovec *pages, size_t count);
+
+        /// @brief Writes consecutive pages with vectored writes (pwritev), one per bitmap group or
+        /// segment crossed
+        /// @param first_page_id Page ID of pages[0], pages[i] goes to first_page_id + i
+        /// @param pages One PageSize buffer per page
+        /// @param count Number of pages, at most IOV_MAX
+        void WritePages(page_id_t first_page_id, const iovec *pages, size_t count);
+
+        /// @brief Returns a zeroed page: the lowest freed page if any, else a new one at the end.
+        /// Segments grow in extents (fallocate, or sparse), not page by page
+        /// @param zero Clear a reused page. Callers that write the whole page before reading it
+        /// can skip the extra write
+        /// @return Page ID
+        page_id_t AllocatePage(bool zero = true);
+
+        /// @brief Marks a page free for reuse by AllocatePage, writing its bitmap page and the
+        /// header. Unallocated IDs are ignored
+        /// @param page_id Page to free
+        void DeallocatePage(page_id_t page_id);
+
+        /// @brief Marks a page allocated, extending the page count to cover it; pages skipped over
+        /// become free. Recovery uses it for pages the log refers to, whose allocation may not have
+        /// reached the metadata before a crash
+        /// @param page_id Page to mark
+        void MarkAllocated(page_id_t page_id);
+
+        /// @brief Writes back allocation metadata, then waits until written pages are on stable
+        /// storage (fdatasync of every open segment)
+        void Sync();
+
+        /// @brief Finds where a data page lives, opening its segment if needed. For callers that
+        /// issue their own I/O, e.g. through an IOEngine; the fd stays open until the manager closes
+        /// @param page_id Page ID
+        /// @param fd_ptr Segment file descriptor
+        /// @param offset_ptr Byte offset in the segment
+        void LocatePage(page_id_t page_id, int *fd_ptr, off_t *offset_ptr);
 
         /// @brief Returns next page ID
-        /// @return next_page_id_
+        /// @return next_page_id_, one past the highest page ever allocated
         inline page_id_t GetNumPages()
         {
-            return next_page_id_;
+            return next_page_id_.load(std::memory_order_acquire);
         }
 
-    private:
-        /// @brief DB file stream
-        std::fstream db_file_;
+        /// @brief Gets I/O counters and ReadPage/WritePage latency histograms
+        /// @return Snapshot of counters
+        DiskStats GetStats();
+
+        /// @brief Gets number of freed pages waiting for reuse
+        /// @return Free pages below GetNumPages
+        page_id_t GetFreePages();
+
+        /// @brief Checks if pages bypass the OS page cache
+        /// @return If opened with O_DIRECT
+        inline bool IsDirectIO()
+        {
+            return direct_io_;
+        }
+
+        /// @brief Gets bytes per page
+        /// @return PageSize
+        static constexpr int32_t GetPageSize()
+        {
+            return PageSize;
+        }
+
+        /// @brief Gets bytes per segment file
+        /// @return Segment size
+        inline uint64_t GetSegmentBytes()
+        {
+            return segment_bytes_;
+        }
+
+        /// @brief Physical page number of a data page, skipping the header and the bitmap pages.
+        /// Segment physical / (GetSegmentBytes() / PageSize) holds it, at that remainder
+        /// @param page_id Page ID
+        /// @return Page number in the database
+        static constexpr uint64_t PhysicalPage(page_id_t page_id)
+        {
+            return BitmapPageNumber(page_id / PAGES_PER_GROUP) + 1 + page_id % PAGES_PER_GROUP;
+        }
+
+        /// @brief Data pages covered by one bitmap page
+        static constexpr page_id_t PAGES_PER_GROUP = PageSize * 8;
+
+        /// @brief Most segment files per database
+        static constexpr size_t MAX_SEGMENTS = 1 << 16;
+
+    protected:
+        /// @brief DB file name, for error messages
+        std::string file_name_;
+        /// @brief Opened with O_DIRECT, buffers must be PAGE_ALIGNMENT aligned
+        bool direct_io_;
         /// @brief Next page ID
-        page_id_t next_page_id_;
+        std::atomic<page_id_t> next_page_id_;
+
+        /// @brief Data pages among the first physical pages of a database
+        /// @param physical_pages Physical page count, header and bitmaps included
+        /// @return Page IDs [0, result) that fit
+        static constexpr page_id_t DataPages(uint64_t physical_pages)
+        {
+            if (physical_pages < 2)
+            {
+                return 0;
+            }
+            uint64_t groups = (physical_pages - 1) / (static_cast<uint64_t>(PAGES_PER_GROUP) + 1);
+            uint64_t rest = (physical_pages - 1) % (static_cast<uint64_t>(PAGES_PER_GROUP) + 1);
+            return static_cast<page_id_t>(groups * PAGES_PER_GROUP + (rest > 0 ? rest - 1 : 0));
+        }
+
+        /// @brief Physical page number of a group's bitmap
+        /// @param group Bitmap group, covering page IDs [group * PAGES_PER_GROUP, ...)
+        /// @return Page number in the database
+        static constexpr uint64_t BitmapPageNumber(uint64_t group)
+        {
+            return 1 + group * (static_cast<uint64_t>(PAGES_PER_GROUP) + 1);
+        }
+
+    private:
+        /// @brief Allocation bitmap of one group, loaded on first use
+        struct Bitmap
+        {
+            char *data = nullptr;
+            bool dirty = false;
+        };
+
+        /// @brief Bytes and pages per segment
+        uint64_t segment_bytes_;
+        uint64_t segment_pages_;
+        /// @brief Extend with fallocate rather than ftruncate
+        bool preallocate_;
+
+        /// @brief Descriptor per segment, -1 until opened. Read without a lock, opened under
+        /// segment_latch_
+        std::unique_ptr<std::atomic<int>[]> fds_;
+        std::mutex segment_latch_;
+        /// @brief Segments opened so far, so Sync and close visit only those. Guarded by
+        /// segment_latch_
+        std::vector<uint64_t> open_segments_;
+
+        /// @brief Guards the bitmaps, free-page state, file extension and next_page_id_ updates
+        std::mutex alloc_latch_;
+        std::vector<Bitmap> bitmaps_;
+        page_id_t free_pages_ = 0;
+        /// @brief No page below this ID is free
+        page_id_t free_hint_ = 0;
+        /// @brief Pages the segments have room for, header and bitmaps included
+        uint64_t file_pages_ = 0;
+        /// @brief IDs below this may have been handed out. On disk before any ID past it is
+        page_id_t reserved_pages_ = 0;
+        bool header_dirty_ = false;
+
+        /// @brief I/O counters, striped per thread and updated without a lock
+        StripedCounter reads_;
+        StripedCounter writes_;
+        StripedCounter bytes_read_;
+        StripedCounter bytes_written_;
+        ConcurrentLatencyHistogram read_page_latency_;
+        ConcurrentLatencyHistogram write_page_latency_;
+
+        /// @brief Gets a segment's descriptor, opening (and creating) the file on first use
+        /// @param segment Segment number
+        /// @return File descriptor
+        int SegmentFd(uint64_t segment);
+
+        /// @brief Reads one physical page. Tail past the end of its segment reads as zeros
+        /// @param page_number Physical page number
+        /// @param buffer PageSize bytes
+        void ReadAt(uint64_t page_number, char *buffer);
+
+        /// @brief Writes one physical page
+        /// @param page_number Physical page number
+        /// @param buffer PageSize bytes
+        void WriteAt(uint64_t page_number, const char *buffer);
+
+        /// @brief Gets a group's bitmap, reading it on first use. Caller must hold alloc_latch_
+        /// @param group Bitmap group
+        /// @return Bitmap
+        Bitmap &GetBitmap(size_t group);
+
+        /// @brief Finds and claims the lowest free page. Caller must hold alloc_latch_
+        /// @param page_id_ptr Claimed page
+        /// @return True if a free page was found
+        bool ClaimFreePage(page_id_t *page_id_ptr);
+
+        /// @brief Grows the segments by at least one extent so they have room for a physical
+        /// page. Caller must hold alloc_latch_
+        /// @param page_number Physical page that must fit
+        void ExtendFile(uint64_t page_number);
+
+        /// @brief Makes a segment at least pages long, never shrinking it
+        /// @param segment Segment number
+        /// @param from First page of the segment that is new
+        /// @param pages Segment length in pages
+        void GrowSegment(uint64_t segment, uint64_t from, uint64_t pages);
+
+        /// @brief Reserves every page the segments have room for, at least up to page_id, and
+        /// syncs the header and bitmaps. Caller must hold alloc_latch_
+        /// @param page_id Page about to be appended
+        void ReservePages(page_id_t page_id);
+
+        /// @brief Writes a group's bitmap page now, for changes a crash must not lose. Not synced.
+        /// Caller must hold alloc_latch_
+        /// @param group Bitmap group
+        void WriteBitmap(size_t group);
+
+        /// @brief Writes the header and dirty bitmaps. Caller must hold alloc_latch_
+        void WriteMetadata();
+
+        /// @brief Closes every open segment
+        void CloseSegments();
+
+        /// @brief Gets the segments opened so far
+        /// @return Segment numbers, in opening order
+        std::vector<uint64_t> GetOpenSegments();
+
+        /// @brief Throws with the current errno
+        /// @param what Failed operation
+        [[noreturn]] void ThrowIOError(const std::string &what);
     };
-}
\ No newline at end of file
+
+    /// @brief Disk manager of the default PAGE_SIZE
+    using DiskManager = BasicDiskManager<PAGE_SIZE>;
+}
@@ -0,0 +1,211 @@
+#include <cstddef>       // size_t
+#include <cstdint>       // uint32_t, uint64_t
+#include <functional>    // std::function
+#include <memory>        // std::unique_ptr
+#include <vector>        // std::vector
+#include "common.h"
+#include "buffer_pool.h"
+#include "pax_page.h"
+#include "pax_table.h"
+#include "scan_kernels.h"
+#include "work_stealing_pool.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief A vector of rows moving through a pipeline, one array per column. Columns point
+    /// into a pinned page or into buffers of an operator state, and stay valid until the
+    /// producer moves on to its next chunk
+    struct DataChunk
+    {
+        /// @brief Rows in the column arrays, selected or not
+        size_t count = 0;
+        std::vector<PaxType> types;
+        /// @brief count values per column, 4 bytes for INT32 and 8 otherwise
+        std::vector<const char *> columns;
+        /// @brief Validity bitmap per column (bit set = not null), nullptr if it has no nulls
+        std::vector<const uint64_t *> validity;
+        /// @brief Rows still in play, in the ScanKernels selection format; nullptr for all
+        const uint64_t *selection = nullptr;
+
+        template <typename T>
+        inline const T *GetColumn(size_t column) const
+        {
+            return reinterpret_cast<const T *>(columns[column]);
+        }
+
+        inline bool IsSelected(size_t row) const
+        {
+            return selection == nullptr || ((selection[row / 64] >> (row % 64)) & 1) != 0;
+        }
+
+        inline bool IsValid(size_t column, size_t row) const
+        {
+            return validity[column] == nullptr || ((validity[column][row / 64] >> (row % 64)) & 1) != 0;
+        }
+
+        /// @brief Gets a value widened to a PaxValue
+        /// @param column Column index
+        /// @param row Row index
+        /// @return Value, i for INT32 and INT64 columns, d for DOUBLE
+        PaxValue GetValue(size_t column, size_t row) const;
+
+        /// @brief Gets the rows that are selected
+        /// @param rows Receives the row indices in order
+        void GetSelectedRows(std::vector<uint32_t> *rows) const;
+    };
+
+    /// @brief What one worker keeps for one operator across the chunks it processes, e.g.
+    /// scratch buffers or partial aggregates. Never shared between threads
+    class OperatorState
+    {
+    public:
+        virtual ~OperatorState() = default;
+    };
+
+    /// @brief Pipeline stage between the source and the sink, processing a chunk at a time
+    class Operator
+    {
+    public:
+        virtual ~Operator() = default;
+
+        /// @brief Creates a worker's state
+        /// @return State, nullptr if the operator needs none
+        virtual std::unique_ptr<OperatorState> NewState()
+        {
+            return nullptr;
+        }
+
+        /// @brief Processes a chunk
+        /// @param input Chunk from the previous stage, may be changed in place
+        /// @param state This worker's state
+        /// @return Chunk for the next stage, input or one owned by state; nullptr if no row is left
+        virtual DataChunk *Execute(DataChunk *input, OperatorState *state) = 0;
+    };
+
+    /// @brief End of a pipeline. Workers consume chunks into their own state; once every morsel
+    /// is done the states are combined one at a time and the sink is finalized
+    class Sink
+    {
+    public:
+        virtual ~Sink() = default;
+
+        /// @brief Creates a worker's state
+        /// @return State
+        virtual std::unique_ptr<OperatorState> NewState() = 0;
+
+        /// @brief Consumes the selected rows of a chunk
+        /// @param chunk Chunk from the last operator
+        /// @param state This worker's state
+        virtual void Consume(const DataChunk &chunk, OperatorState *state) = 0;
+
+        /// @brief Merges a finished worker's state. Calls are serialized
+        /// @param state State to merge
+        virtual void Combine(OperatorState *state) = 0;
+
+        /// @brief Called once after every Combine
+        virtual void Finalize() {}
+    };
+
+    /// @brief Start of a pipeline: its input split into morsels that workers scan independently
+    class ChunkSource
+    {
+    public:
+        virtual ~ChunkSource() = default;
+
+        /// @brief Gets the number of morsels
+        /// @return Morsels
+        virtual size_t GetMorselCount() = 0;
+
+        /// @brief Produces the chunks of one morsel. Called concurrently for different morsels
+        /// @param morsel Morsel index
+        /// @param consumer Called per chunk; the chunk is only valid during the call
+        virtual void Scan(size_t morsel, const std::function<void(DataChunk &)> &consumer) = 0;
+    };
+
+    /// @brief Scans a PaxTable, one chunk per page straight from the pinned frame, no copy. A
+    /// morsel is a run of consecutive pages fetched with one FetchPages call, so the pool needs
+    /// at least threads * pages_per_morsel frames. The table must not change during a scan
+    /// @tparam PageSize Bytes per page, matching the pool
+    template <int32_t PageSize>
+    class BasicPaxScan : public ChunkSource
+    {
+    public:
+        /// @param table Table to scan
+        /// @param pool The table's pool
+        /// @param pages_per_morsel Pages per morsel
+        BasicPaxScan(BasicPaxTable<PageSize> *table, basic_buffer_pool<PageSize> *pool, size_t pages_per_morsel = 16);
+
+        size_t GetMorselCount() override;
+        void Scan(size_t morsel, const std::function<void(DataChunk &)> &consumer) override;
+
+    private:
+        BasicPaxTable<PageSize> *table_;
+        basic_buffer_pool<PageSize> *pool_;
+        size_t pages_per_morsel_;
+    };
+
+    /// @brief Keeps the rows that pass every predicate, evaluated a column at a time with
+    /// ScanKernels. Null values fail every predicate
+    class Filter : public Operator
+    {
+    public:
+        /// @param predicates Conjunction of predicates on the input columns
+        explicit Filter(std::vector<PaxPredicate> predicates);
+
+        std::unique_ptr<OperatorState> NewState() override;
+
+        /// @throws std::invalid_argument for an unknown column or an INT32 operand out of range
+        DataChunk *Execute(DataChunk *input, OperatorState *state) override;
+
+    private:
+        std::vector<PaxPredicate> predicates_;
+    };
+
+    /// @brief Keeps a list of input columns, in the given order. Columns are not copied
+    class Project : public Operator
+    {
+    public:
+        /// @param columns Input column for each output column
+        explicit Project(std::vector<uint32_t> columns);
+
+        /// @throws std::invalid_argument for an unknown column
+        DataChunk *Execute(DataChunk *input, OperatorState *state) override;
+
+    private:
+        std::vector<uint32_t> columns_;
+    };
+
+    /// @brief A source, operators and a sink run as one push-based pipeline: every worker of a
+    /// WorkStealingPool takes morsels, pushes each chunk of a morsel through the operators into
+    /// the sink with its own operator states, and the states are combined at the end
+    class Pipeline
+    {
+    public:
+        /// @param source Input, outliving the pipeline
+        /// @param operators Stages in order, outliving the pipeline
+        /// @param sink Output, outliving the pipeline
+        Pipeline(ChunkSource *source, std::vector<Operator *> operators, Sink *sink);
+
+        /// @brief Runs every morsel, then combines the worker states and finalizes the sink
+        /// @param pool Workers to run on
+        void Execute(WorkStealingPool *pool);
+
+        /// @brief Gets how many chunks reached the sink in the last Execute
+        /// @return Chunks
+        inline uint64_t GetSinkChunks() const
+        {
+            return sink_chunks_;
+        }
+
+    private:
+        ChunkSource *source_;
+        std::vector<Operator *> operators_;
+        Sink *sink_;
+        uint64_t sink_chunks_ = 0;
+    };
+
+    /// @brief PAX scan of the default PAGE_SIZE
+    using PaxScan = BasicPaxScan<PAGE_SIZE>;
+}
@@ -0,0 +1,154 @@
+#include <cstdint>       // int32_t, uint8_t, uint64_t
+#include <vector>        // std::vector
+#include "common.h"
+#include "page.h"
+#include "buffer_pool.h"
+#include "index_key.h"
+#include "hash_bucket_page.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Unique-key extendible hash index mapping keys to RIDs, for point lookups that need
+    /// no order. The low global-depth bits of a key's hash pick a directory slot and the slot
+    /// names a bucket page. A full bucket splits on one more hash bit into a new page, and only
+    /// its entries move; the directory doubles by copying itself when the bucket was already at
+    /// global depth. Emptied buckets merge back into their split image and the directory halves
+    /// when it can. The directory is kept in memory and written through to directory pages
+    /// listed on a header page, so a lookup pins exactly one page, the bucket. Not synchronized.
+    /// Compiled for int64_t keys and GenericKey<16>, <32> and <64>
+    /// @tparam KeyType Trivially copyable key
+    /// @tparam KeyComparator Functor returning 0 for equal keys
+    /// @tparam KeyHasher Functor returning a 64-bit hash
+    /// @tparam PageSize Bytes per page, matching the pool
+    template <typename KeyType, typename KeyComparator, typename KeyHasher, int32_t PageSize>
+    class BasicExtendibleHashTable
+    {
+        using Bucket = HashBucketPage<KeyType, RID, PageSize>;
+
+    public:
+        /// @brief Creates an empty index: a header page, a directory page and one bucket
+        /// @param pool Pool to keep the pages in
+        /// @param comparator Key equality
+        /// @param hasher Key hash
+        explicit BasicExtendibleHashTable(basic_buffer_pool<PageSize> *pool,
+                                          const KeyComparator &comparator = KeyComparator(),
+                                          const KeyHasher &hasher = KeyHasher());
+
+        /// @brief Opens an existing index, reading its directory
+        /// @param pool Pool over the index's database
+        /// @param header_page_id GetHeaderPageId of the index when it was created
+        /// @param comparator Key equality
+        /// @param hasher Key hash, the one the index was built with
+        BasicExtendibleHashTable(basic_buffer_pool<PageSize> *pool, page_id_t header_page_id,
+                                 const KeyComparator &comparator = KeyComparator(),
+                                 const KeyHasher &hasher = KeyHasher());
+
+        /// @brief Gets the page that identifies the index
+        /// @return Header page ID
+        inline page_id_t GetHeaderPageId()
+        {
+            return header_page_id_;
+        }
+
+        /// @brief Point lookup, one page pin
+        /// @param key Key to find
+        /// @param value Receives the RID
+        /// @return False if absent
+        bool GetValue(const KeyType &key, RID *value);
+
+        /// @brief Adds a key, splitting its bucket while it is full
+        /// @param key New key
+        /// @param value RID to map it to
+        /// @return False if the key exists
+        /// @throws std::runtime_error if the directory is at MAX_GLOBAL_DEPTH and the bucket
+        /// still has no room
+        bool Insert(const KeyType &key, const RID &value);
+
+        /// @brief Removes a key, merging its bucket away if it becomes empty
+        /// @param key Key to remove
+        /// @return False if absent
+        bool Remove(const KeyType &key);
+
+        /// @brief Gets the number of hash bits the directory uses
+        /// @return Global depth
+        inline uint32_t GetGlobalDepth()
+        {
+            return global_depth_;
+        }
+
+        /// @brief Gets the number of bucket pages
+        /// @return Distinct buckets
+        size_t GetBucketCount();
+
+        /// @brief Entries per bucket page
+        static constexpr int BUCKET_CAPACITY = Bucket::CAPACITY;
+
+        /// @brief Directory slots per directory page: a page ID and a local depth byte each
+        static constexpr size_t SLOTS_PER_DIRECTORY_PAGE =
+            (PageSize - BasicPage<PageSize>::HEADER_SIZE) / (sizeof(page_id_t) + 1);
+
+        /// @brief Directory pages the header page can list
+        static constexpr size_t MAX_DIRECTORY_PAGES =
+            (PageSize - BasicPage<PageSize>::HEADER_SIZE - 2 * sizeof(uint32_t)) / sizeof(page_id_t);
+
+        /// @brief Largest global depth whose directory fits in MAX_DIRECTORY_PAGES
+        static constexpr uint32_t MAX_GLOBAL_DEPTH = []()
+        {
+            uint32_t depth = 0;
+            while ((size_t(2) << depth) <= SLOTS_PER_DIRECTORY_PAGE * MAX_DIRECTORY_PAGES && depth < 32)
+            {
+                depth++;
+            }
+            return depth;
+        }();
+
+    private:
+        basic_buffer_pool<PageSize> *pool_;
+        KeyComparator comparator_;
+        KeyHasher hasher_;
+        page_id_t header_page_id_;
+
+        /// @brief Directory copy: bucket page and local depth per slot, 2^global_depth_ slots
+        uint32_t global_depth_ = 0;
+        std::vector<page_id_t> buckets_;
+        std::vector<uint8_t> local_depths_;
+
+        /// @brief Pages the directory is stored in, and which of them differ from memory
+        std::vector<page_id_t> directory_pages_;
+        std::vector<bool> directory_dirty_;
+
+        /// @brief Fingerprint stored in the bucket: the hash byte farthest from the directory bits
+        static inline uint8_t Fingerprint(uint64_t hash)
+        {
+            return static_cast<uint8_t>(hash >> 56);
+        }
+
+        /// @brief Directory slot of a hash
+        inline size_t SlotOf(uint64_t hash)
+        {
+            return static_cast<size_t>(hash & ((uint64_t(1) << global_depth_) - 1));
+        }
+
+        /// @brief Points a slot at a bucket, marking its directory page for write-back
+        void SetSlot(size_t slot, page_id_t bucket, uint8_t local_depth);
+
+        /// @brief Doubles the directory: slot i + 2^g starts as a copy of slot i
+        void GrowDirectory();
+
+        /// @brief Halves the directory while no bucket uses the top bit
+        void ShrinkDirectory();
+
+        /// @brief Splits the bucket of a slot on its next hash bit
+        /// @param slot Any slot pointing at the bucket
+        void SplitBucket(size_t slot);
+
+        /// @brief Writes changed directory pages and the header, allocating pages as it grows
+        void FlushDirectory();
+    };
+
+    /// @brief Extendible hash table of the default PAGE_SIZE
+    template <typename KeyType, typename KeyComparator, typename KeyHasher>
+    using ExtendibleHashTable = BasicExtendibleHashTable<KeyType, KeyComparator, KeyHasher, PAGE_SIZE>;
+}
@@ -0,0 +1,66 @@
+#include <cstddef>       // size_t
+#include "common.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief One anonymous mapping holding the data of every frame of a pool, PageSize bytes
+    /// per frame and PAGE_ALIGNMENT aligned. Keeps frame data contiguous (few TLB entries, one
+    /// region to register for I/O) and out of the frame descriptors
+    /// @tparam PageSize Bytes per frame
+    template <int32_t PageSize>
+    class BasicFrameArena
+    {
+    public:
+        /// @brief Maps zeroed memory for frames. Arenas of 2 MiB or more are advised for
+        /// transparent huge pages (MADV_HUGEPAGE)
+        /// @param frames Number of frames
+        /// @param use_hugetlb Try explicit huge pages (MAP_HUGETLB) first, falling back to normal
+        /// pages when none are reserved
+        BasicFrameArena(size_t frames, bool use_hugetlb = false);
+
+        /// @brief Unmaps the arena
+        ~BasicFrameArena();
+
+        BasicFrameArena(const BasicFrameArena &) = delete;
+        BasicFrameArena &operator=(const BasicFrameArena &) = delete;
+
+        /// @brief Gets memory of a frame
+        /// @param frame_id Frame
+        /// @return PageSize bytes
+        inline char *GetFrame(frame_id_t frame_id)
+        {
+            return base_ + static_cast<size_t>(frame_id) * PageSize;
+        }
+
+        /// @brief Gets start of the arena
+        /// @return First frame
+        inline char *GetBase()
+        {
+            return base_;
+        }
+
+        /// @brief Gets mapped size, frames * PageSize rounded up to the mapping granularity
+        /// @return Bytes
+        inline size_t GetSize()
+        {
+            return size_;
+        }
+
+        /// @brief Whether the arena is backed by MAP_HUGETLB pages
+        /// @return True if explicit huge pages are in use
+        inline bool IsHugeTLB()
+        {
+            return huge_tlb_;
+        }
+
+    private:
+        char *base_ = nullptr;
+        size_t size_ = 0;
+        bool huge_tlb_ = false;
+    };
+
+    /// @brief Frame arena of the default PAGE_SIZE
+    using FrameArena = BasicFrameArena<PAGE_SIZE>;
+}
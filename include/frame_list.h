@@ -0,0 +1,154 @@
+#include <cstdint>       // int32_t
+#include <vector>        // std::vector
+#include "common.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Intrusive doubly linked list over frame IDs. Links live in flat arrays indexed by
+    /// frame ID, so push/erase/move are O(1) with no allocation or hashing. Head is the most
+    /// recently inserted end, tail the oldest
+    class FrameList
+    {
+    public:
+        /// @brief Creates an empty list able to hold frames [0, num_frames)
+        /// @param num_frames Number of frames in the pool
+        explicit FrameList(size_t num_frames)
+            : prev_(num_frames, INVALID_FRAME_ID), next_(num_frames, INVALID_FRAME_ID), linked_(num_frames, false)
+        {
+        }
+
+        /// @brief Checks membership
+        /// @param frame_id Frame to check
+        /// @return If frame is in the list
+        inline bool Contains(frame_id_t frame_id) const
+        {
+            return linked_[frame_id];
+        }
+
+        /// @brief Inserts frame at the head. Frame must not be linked
+        /// @param frame_id Frame to insert
+        inline void PushFront(frame_id_t frame_id)
+        {
+            prev_[frame_id] = INVALID_FRAME_ID;
+            next_[frame_id] = head_;
+            if (head_ != INVALID_FRAME_ID)
+            {
+                prev_[head_] = frame_id;
+            }
+            else
+            {
+                tail_ = frame_id;
+            }
+            head_ = frame_id;
+            linked_[frame_id] = true;
+            size_++;
+        }
+
+        /// @brief Inserts frame at the tail. Frame must not be linked
+        /// @param frame_id Frame to insert
+        inline void PushBack(frame_id_t frame_id)
+        {
+            next_[frame_id] = INVALID_FRAME_ID;
+            prev_[frame_id] = tail_;
+            if (tail_ != INVALID_FRAME_ID)
+            {
+                next_[tail_] = frame_id;
+            }
+            else
+            {
+                head_ = frame_id;
+            }
+            tail_ = frame_id;
+            linked_[frame_id] = true;
+            size_++;
+        }
+
+        /// @brief Unlinks frame if present
+        /// @param frame_id Frame to remove
+        /// @return If frame was linked
+        inline bool Erase(frame_id_t frame_id)
+        {
+            if (!linked_[frame_id])
+            {
+                return false;
+            }
+            if (prev_[frame_id] != INVALID_FRAME_ID)
+            {
+                next_[prev_[frame_id]] = next_[frame_id];
+            }
+            else
+            {
+                head_ = next_[frame_id];
+            }
+            if (next_[frame_id] != INVALID_FRAME_ID)
+            {
+                prev_[next_[frame_id]] = prev_[frame_id];
+            }
+            else
+            {
+                tail_ = prev_[frame_id];
+            }
+            linked_[frame_id] = false;
+            size_--;
+            return true;
+        }
+
+        /// @brief Moves a linked frame to the head
+        /// @param frame_id Frame to move
+        inline void MoveToFront(frame_id_t frame_id)
+        {
+            if (head_ != frame_id)
+            {
+                Erase(frame_id);
+                PushFront(frame_id);
+            }
+        }
+
+        /// @brief Gets newest frame
+        /// @return Head frame or INVALID_FRAME_ID
+        inline frame_id_t Front() const
+        {
+            return head_;
+        }
+
+        /// @brief Gets oldest frame
+        /// @return Tail frame or INVALID_FRAME_ID
+        inline frame_id_t Back() const
+        {
+            return tail_;
+        }
+
+        /// @brief Walks towards the head
+        /// @param frame_id Linked frame
+        /// @return Next newer frame or INVALID_FRAME_ID
+        inline frame_id_t Prev(frame_id_t frame_id) const
+        {
+            return prev_[frame_id];
+        }
+
+        /// @brief Walks towards the tail
+        /// @param frame_id Linked frame
+        /// @return Next older frame or INVALID_FRAME_ID
+        inline frame_id_t Next(frame_id_t frame_id) const
+        {
+            return next_[frame_id];
+        }
+
+        /// @brief Gets number of linked frames
+        /// @return List size
+        inline size_t Size() const
+        {
+            return size_;
+        }
+
+    private:
+        std::vector<frame_id_t> prev_;
+        std::vector<frame_id_t> next_;
+        std::vector<bool> linked_;
+        frame_id_t head_ = INVALID_FRAME_ID;
+        frame_id_t tail_ = INVALID_FRAME_ID;
+        size_t size_ = 0;
+    };
+}
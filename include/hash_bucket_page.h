@@ -0,0 +1,156 @@
+#include <cstdint>       // uint8_t, uint32_t
+#include <cstring>       // memcpy
+#if defined(__SSE2__)
+#include <emmintrin.h>   // _mm_cmpeq_epi8, _mm_movemask_epi8
+#endif
+#include "common.h"
+#include "page.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Hash bucket layout over a page's data: after the page header the entry count, then
+    /// one fingerprint byte per entry (the top byte of the key's hash), then the keys, then the
+    /// values. Entries are unordered. A probe compares 16 fingerprints per SSE2 instruction and
+    /// only compares keys whose fingerprint matches, so a miss usually touches no key at all. A
+    /// view only: the caller pins the page and marks it dirty
+    /// @tparam KeyType Trivially copyable key
+    /// @tparam ValueType Trivially copyable value
+    /// @tparam PageSize Bytes per page
+    template <typename KeyType, typename ValueType, int32_t PageSize>
+    class HashBucketPage
+    {
+    public:
+        /// @brief Views page data as a bucket
+        /// @param data PageSize bytes of a pinned frame
+        explicit HashBucketPage(char *data) : data_(data) {}
+
+        /// @brief Formats an empty bucket, keeping the page LSN
+        inline void Init()
+        {
+            SetSize(0);
+        }
+
+        inline int GetSize()
+        {
+            uint32_t size;
+            memcpy(&size, data_ + SIZE_OFFSET, sizeof(size));
+            return static_cast<int>(size);
+        }
+
+        inline bool IsFull()
+        {
+            return GetSize() == CAPACITY;
+        }
+
+        inline uint8_t FingerprintAt(int index)
+        {
+            return Fingerprints()[index];
+        }
+
+        inline KeyType &KeyAt(int index)
+        {
+            return reinterpret_cast<KeyType *>(data_ + KEYS_OFFSET)[index];
+        }
+
+        inline ValueType &ValueAt(int index)
+        {
+            return reinterpret_cast<ValueType *>(data_ + VALUES_OFFSET)[index];
+        }
+
+        /// @brief Finds a key
+        /// @param key Key to find
+        /// @param fingerprint Top byte of the key's hash
+        /// @param comparator Returns 0 for equal keys
+        /// @return Entry index, -1 if absent
+        template <typename KeyComparator>
+        inline int Find(const KeyType &key, uint8_t fingerprint, const KeyComparator &comparator)
+        {
+            int size = GetSize();
+            const uint8_t *fingerprints = Fingerprints();
+#if defined(__SSE2__)
+            __m128i needle = _mm_set1_epi8(static_cast<char>(fingerprint));
+            for (int base = 0; base < size; base += 16)
+            {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(fingerprints + base));
+                uint32_t matches = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+                if (size - base < 16)
+                {
+                    matches &= (1u << (size - base)) - 1;
+                }
+                while (matches != 0)
+                {
+                    int index = base + __builtin_ctz(matches);
+                    if (comparator(KeyAt(index), key) == 0)
+                    {
+                        return index;
+                    }
+                    matches &= matches - 1;
+                }
+            }
+#else
+            for (int index = 0; index < size; index++)
+            {
+                if (fingerprints[index] == fingerprint && comparator(KeyAt(index), key) == 0)
+                {
+                    return index;
+                }
+            }
+#endif
+            return -1;
+        }
+
+        /// @brief Adds an entry at the end. Caller checked IsFull
+        inline void Append(uint8_t fingerprint, const KeyType &key, const ValueType &value)
+        {
+            int size = GetSize();
+            Fingerprints()[size] = fingerprint;
+            memcpy(&KeyAt(size), &key, sizeof(KeyType));
+            memcpy(&ValueAt(size), &value, sizeof(ValueType));
+            SetSize(size + 1);
+        }
+
+        /// @brief Removes an entry by moving the last one into its place
+        /// @param index Entry to remove
+        inline void RemoveAt(int index)
+        {
+            int last = GetSize() - 1;
+            if (index != last)
+            {
+                Fingerprints()[index] = Fingerprints()[last];
+                memcpy(&KeyAt(index), &KeyAt(last), sizeof(KeyType));
+                memcpy(&ValueAt(index), &ValueAt(last), sizeof(ValueType));
+            }
+            SetSize(last);
+        }
+
+        /// @brief Entries per bucket, a multiple of 16 so probes read whole fingerprint vectors
+        static constexpr int CAPACITY = static_cast<int>(
+            (PageSize - 16 - alignof(KeyType) - alignof(ValueType)) / (1 + sizeof(KeyType) + sizeof(ValueType)) / 16 * 16);
+
+    private:
+        static constexpr uint32_t SIZE_OFFSET = BasicPage<PageSize>::HEADER_SIZE;
+        static constexpr uint32_t FINGERPRINTS_OFFSET = 16;
+        static constexpr uint32_t KEYS_OFFSET =
+            (FINGERPRINTS_OFFSET + CAPACITY + alignof(KeyType) - 1) / alignof(KeyType) * alignof(KeyType);
+        static constexpr uint32_t VALUES_OFFSET =
+            (KEYS_OFFSET + CAPACITY * sizeof(KeyType) + alignof(ValueType) - 1) / alignof(ValueType) * alignof(ValueType);
+        static_assert(SIZE_OFFSET + sizeof(uint32_t) <= FINGERPRINTS_OFFSET, "Hash bucket header layout changed");
+        static_assert(VALUES_OFFSET + CAPACITY * sizeof(ValueType) <= PageSize, "Hash bucket overflows the page");
+        static_assert(CAPACITY >= 16, "Keys too large for the page size");
+
+        char *data_;
+
+        inline uint8_t *Fingerprints()
+        {
+            return reinterpret_cast<uint8_t *>(data_ + FINGERPRINTS_OFFSET);
+        }
+
+        inline void SetSize(int size)
+        {
+            uint32_t value = static_cast<uint32_t>(size);
+            memcpy(data_ + SIZE_OFFSET, &value, sizeof(value));
+        }
+    };
+}
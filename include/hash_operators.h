@@ -0,0 +1,224 @@
+#include <cstddef>       // size_t
+#include <cstdint>       // int64_t, uint32_t, uint64_t
+#include <memory>        // std::unique_ptr
+#include <mutex>         // std::mutex
+#include <vector>        // std::vector
+#include "executor.h"
+#include "pax_page.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Open-addressing map from int64_t keys to dense indices 0, 1, 2... in insertion
+    /// order, probed linearly. Not synchronized
+    class KeyIndex
+    {
+    public:
+        KeyIndex();
+
+        /// @brief Finds a key, adding it if new
+        /// @param key Key
+        /// @param inserted Set if the key was new
+        /// @return Index of the key
+        uint32_t Insert(int64_t key, bool *inserted);
+
+        /// @brief Finds a key
+        /// @param key Key
+        /// @return Index of the key, NOT_FOUND if absent
+        uint32_t Find(int64_t key) const;
+
+        /// @brief Gets the number of keys
+        /// @return Keys
+        inline size_t GetCount() const
+        {
+            return keys_.size();
+        }
+
+        /// @brief Gets the key at an index
+        /// @param index Index below GetCount
+        /// @return Key
+        inline int64_t GetKey(uint32_t index) const
+        {
+            return keys_[index];
+        }
+
+        static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+    private:
+        std::vector<int64_t> keys_;
+        /// @brief Index + 1 per slot, 0 for an empty slot; a power of two, at most half full
+        std::vector<uint32_t> slots_;
+
+        /// @brief Doubles the slots and re-inserts every key
+        void Grow();
+    };
+
+    /// @brief Aggregate functions over the non-null values of a column
+    enum class AggregateFunc
+    {
+        COUNT,
+        SUM,
+        MIN,
+        MAX
+    };
+
+    /// @brief One aggregate of a group by
+    struct AggregateSpec
+    {
+        AggregateFunc func;
+        uint32_t column;
+    };
+
+    /// @brief One group of a HashAggregate result: the group key and a value per aggregate. COUNT
+    /// is in i, SUM, MIN and MAX in i or d by the column type; MIN and MAX of a group without
+    /// non-null values are the type's max and lowest
+    struct AggregateRow
+    {
+        int64_t key;
+        std::vector<PaxValue> values;
+    };
+
+    /// @brief Sink that groups rows by an INT32 or INT64 column and aggregates others. Each
+    /// worker builds its own hash table of partial aggregates, updated a whole chunk at a time:
+    /// first the group of every selected row, then one tight loop per aggregate. The partial
+    /// tables are merged when the pipeline ends. Rows with a null group key are dropped
+    class HashAggregate : public Sink
+    {
+    public:
+        /// @param group_column Column to group by
+        /// @param aggregates Aggregates to compute per group
+        HashAggregate(uint32_t group_column, std::vector<AggregateSpec> aggregates);
+        ~HashAggregate() override;
+
+        std::unique_ptr<OperatorState> NewState() override;
+
+        /// @throws std::invalid_argument for an unknown column or a DOUBLE group column
+        void Consume(const DataChunk &chunk, OperatorState *state) override;
+
+        void Combine(OperatorState *state) override;
+        void Finalize() override;
+
+        /// @brief Gets the groups once the pipeline ran
+        /// @return Groups sorted by key
+        inline const std::vector<AggregateRow> &GetResults() const
+        {
+            return results_;
+        }
+
+    private:
+        uint32_t group_column_;
+        std::vector<AggregateSpec> aggregates_;
+        /// @brief Guards merged_ during Combine
+        std::mutex latch_;
+        std::unique_ptr<OperatorState> merged_;
+        std::vector<AggregateRow> results_;
+    };
+
+    /// @brief Build side of a hash join: a sink that collects the key and payload columns of its
+    /// rows, each worker into its own buffers, then concatenates them and chains the rows of
+    /// each key behind a KeyIndex when the pipeline ends. Probe with HashJoinProbe once built.
+    /// Rows with a null key never match and are dropped
+    class HashJoinBuild : public Sink
+    {
+    public:
+        /// @param key_column INT32 or INT64 join key
+        /// @param payload_columns Columns the probe side gets for each match
+        HashJoinBuild(uint32_t key_column, std::vector<uint32_t> payload_columns);
+
+        std::unique_ptr<OperatorState> NewState() override;
+
+        /// @throws std::invalid_argument for an unknown column or a DOUBLE key column
+        void Consume(const DataChunk &chunk, OperatorState *state) override;
+
+        void Combine(OperatorState *state) override;
+        void Finalize() override;
+
+        /// @brief Finds the first row with a key
+        /// @param key Join key
+        /// @return Row, KeyIndex::NOT_FOUND if none
+        inline uint32_t Find(int64_t key) const
+        {
+            uint32_t index = index_.Find(key);
+            return index == KeyIndex::NOT_FOUND ? KeyIndex::NOT_FOUND : heads_[index];
+        }
+
+        /// @brief Gets the next row with the same key
+        /// @param row Row from Find or GetNext
+        /// @return Row, KeyIndex::NOT_FOUND after the last
+        inline uint32_t GetNext(uint32_t row) const
+        {
+            return next_[row];
+        }
+
+        /// @brief Gets a payload value: an INT32 or INT64 value as int64_t bits, a DOUBLE's bits
+        /// @param row Build row
+        /// @param payload Index into the payload columns
+        /// @return 8 bytes
+        inline uint64_t GetPayload(uint32_t row, size_t payload) const
+        {
+            return payload_[static_cast<size_t>(row) * payload_columns_.size() + payload];
+        }
+
+        /// @brief Checks whether a payload value is null
+        inline bool IsPayloadNull(uint32_t row, size_t payload) const
+        {
+            return ((null_masks_[row] >> payload) & 1) != 0;
+        }
+
+        /// @brief Checks whether any payload value of a column is null
+        inline bool HasNulls(size_t payload) const
+        {
+            return ((any_nulls_ >> payload) & 1) != 0;
+        }
+
+        /// @brief Gets the payload column types, known once a chunk was consumed
+        /// @return Types
+        inline const std::vector<PaxType> &GetPayloadTypes() const
+        {
+            return payload_types_;
+        }
+
+        /// @brief Gets the number of build rows
+        /// @return Rows
+        inline size_t GetRowCount() const
+        {
+            return keys_.size();
+        }
+
+    private:
+        uint32_t key_column_;
+        std::vector<uint32_t> payload_columns_;
+        std::mutex latch_;
+        std::vector<PaxType> payload_types_;
+        std::vector<int64_t> keys_;
+        std::vector<uint64_t> payload_;
+        std::vector<uint64_t> null_masks_;
+        uint64_t any_nulls_ = 0;
+        KeyIndex index_;
+        /// @brief First row per key index
+        std::vector<uint32_t> heads_;
+        /// @brief Next row with the same key per row
+        std::vector<uint32_t> next_;
+    };
+
+    /// @brief Probe side of a hash join: an operator that emits, for every selected row with a
+    /// match, the row's columns followed by the payload columns of each matching build row. The
+    /// output is gathered into buffers of the worker's state
+    class HashJoinProbe : public Operator
+    {
+    public:
+        /// @param build Finished build side, outliving the probe
+        /// @param key_column INT32 or INT64 join key of the probe rows
+        HashJoinProbe(const HashJoinBuild *build, uint32_t key_column);
+
+        std::unique_ptr<OperatorState> NewState() override;
+
+        /// @throws std::invalid_argument for an unknown column or a DOUBLE key column
+        DataChunk *Execute(DataChunk *input, OperatorState *state) override;
+
+    private:
+        const HashJoinBuild *build_;
+        uint32_t key_column_;
+    };
+}
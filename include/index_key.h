@@ -0,0 +1,195 @@
+#include <cstddef>       // size_t
+#include <cstdint>       // int64_t, uint8_t, uint64_t
+#include <cstring>       // memcmp, memcpy, memset
+#include <stdexcept>     // std::out_of_range
+#include <string>        // std::string, std::to_string
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Variable-length key of up to KeySize - 1 bytes in a fixed KeySize slot: the bytes,
+    /// zero-padded, then their length in the last byte. Compares bytewise, so a key orders before
+    /// the longer keys it is a prefix of, and trailing zero bytes are significant
+    /// @tparam KeySize Slot bytes, a multiple of 8 from 16 to 256
+    template <size_t KeySize>
+    struct GenericKey
+    {
+        static_assert(KeySize % 8 == 0, "Key size must be a multiple of 8");
+        static_assert(KeySize >= 16 && KeySize <= 256, "Key length must fit the last byte");
+
+        /// @brief Longest key
+        static constexpr size_t MAX_LENGTH = KeySize - 1;
+
+        char data[KeySize];
+
+        /// @brief Makes a key from bytes
+        /// @param bytes Key bytes
+        /// @param size Number of bytes
+        /// @return Key
+        /// @throws std::out_of_range if size exceeds MAX_LENGTH
+        static GenericKey FromBytes(const char *bytes, size_t size)
+        {
+            if (size > MAX_LENGTH)
+            {
+                throw std::out_of_range("Key of " + std::to_string(size) + " bytes exceeds " +
+                                        std::to_string(MAX_LENGTH));
+            }
+            GenericKey key;
+            memset(key.data, 0, KeySize);
+            memcpy(key.data, bytes, size);
+            key.data[MAX_LENGTH] = static_cast<char>(size);
+            return key;
+        }
+
+        /// @brief Makes a key from a string's bytes
+        /// @param bytes Key bytes
+        /// @return Key
+        /// @throws std::out_of_range if longer than MAX_LENGTH
+        static GenericKey FromString(const std::string &bytes)
+        {
+            return FromBytes(bytes.data(), bytes.size());
+        }
+
+        /// @brief Makes an 8-byte key whose byte order matches the integer order (big-endian)
+        /// @param value Integer
+        /// @return Key
+        static GenericKey FromInteger(uint64_t value)
+        {
+            char bytes[8];
+            for (size_t i = 0; i < 8; i++)
+            {
+                bytes[i] = static_cast<char>(value >> (56 - 8 * i));
+            }
+            return FromBytes(bytes, sizeof(bytes));
+        }
+
+        /// @brief Gets the number of key bytes
+        /// @return Length, at most MAX_LENGTH
+        inline size_t GetLength() const
+        {
+            return static_cast<uint8_t>(data[MAX_LENGTH]);
+        }
+
+        /// @brief Gets the key bytes
+        /// @return GetLength() bytes
+        std::string ToString() const
+        {
+            return std::string(data, GetLength());
+        }
+    };
+
+    /// @brief Orders GenericKeys bytewise, unsigned. The padding is zero, so equal padded bytes
+    /// leave the length byte to order a prefix before longer keys
+    template <size_t KeySize>
+    struct GenericComparator
+    {
+        inline int operator()(const GenericKey<KeySize> &a, const GenericKey<KeySize> &b) const
+        {
+            return memcmp(a.data, b.data, KeySize);
+        }
+    };
+
+    /// @brief Turns keys into bytes and back, so B+ tree internal nodes can store the leading
+    /// bytes their keys share once. Specialized for each key type the tree is compiled for
+    template <typename KeyType>
+    struct KeyCodec;
+
+    /// @brief Big-endian int64_t, so keys close in value share leading bytes
+    template <>
+    struct KeyCodec<int64_t>
+    {
+        static constexpr size_t MAX_BYTES = 8;
+
+        /// @brief Writes a key's bytes
+        /// @param key Key
+        /// @param bytes Receives up to MAX_BYTES bytes
+        /// @return Bytes written
+        static inline size_t Encode(int64_t key, char *bytes)
+        {
+            for (size_t i = 0; i < 8; i++)
+            {
+                bytes[i] = static_cast<char>(static_cast<uint64_t>(key) >> (56 - 8 * i));
+            }
+            return 8;
+        }
+
+        /// @brief Rebuilds a key from Encode's bytes
+        static inline int64_t Decode(const char *bytes, size_t)
+        {
+            uint64_t value = 0;
+            for (size_t i = 0; i < 8; i++)
+            {
+                value = value << 8 | static_cast<uint8_t>(bytes[i]);
+            }
+            return static_cast<int64_t>(value);
+        }
+    };
+
+    /// @brief The key's bytes without padding or length
+    template <size_t KeySize>
+    struct KeyCodec<GenericKey<KeySize>>
+    {
+        static constexpr size_t MAX_BYTES = GenericKey<KeySize>::MAX_LENGTH;
+
+        static inline size_t Encode(const GenericKey<KeySize> &key, char *bytes)
+        {
+            memcpy(bytes, key.data, key.GetLength());
+            return key.GetLength();
+        }
+
+        static inline GenericKey<KeySize> Decode(const char *bytes, size_t size)
+        {
+            return GenericKey<KeySize>::FromBytes(bytes, size);
+        }
+    };
+
+    /// @brief Final mix of MurmurHash3: every input bit affects every output bit
+    /// @param x Value to mix
+    /// @return Mixed value
+    inline uint64_t HashMix64(uint64_t x)
+    {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ull;
+        x ^= x >> 33;
+        return x;
+    }
+
+    /// @brief Hashes GenericKeys a word at a time
+    template <size_t KeySize>
+    struct GenericHash
+    {
+        inline uint64_t operator()(const GenericKey<KeySize> &key) const
+        {
+            uint64_t hash = KeySize;
+            for (size_t i = 0; i < KeySize; i += 8)
+            {
+                uint64_t word;
+                memcpy(&word, key.data + i, sizeof(word));
+                hash = (hash ^ word) * 0x9e3779b97f4a7c15ull;
+                hash ^= hash >> 29;
+            }
+            return HashMix64(hash);
+        }
+    };
+
+    /// @brief Hashes signed 64-bit keys
+    struct Int64Hash
+    {
+        inline uint64_t operator()(int64_t key) const
+        {
+            return HashMix64(static_cast<uint64_t>(key));
+        }
+    };
+
+    /// @brief Orders signed 64-bit keys
+    struct Int64Comparator
+    {
+        inline int operator()(int64_t a, int64_t b) const
+        {
+            return a < b ? -1 : (a > b ? 1 : 0);
+        }
+    };
+}
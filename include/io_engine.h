@@ -0,0 +1,88 @@
+#include <cstdint>       // uint64_t, int32_t
+#include <memory>        // std::unique_ptr
+#include <vector>        // std::vector
+#include <sys/types.h>   // off_t
+#include <sys/uio.h>     // iovec
+#include "common.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Finished asynchronous request
+    struct IOCompletion
+    {
+        /// @brief Tag passed when the request was prepared
+        uint64_t user_data;
+        /// @brief Bytes transferred, or -errno on failure
+        int32_t result;
+    };
+
+    /// @brief Asynchronous I/O backends
+    enum class IOEngineType
+    {
+        AUTO,       ///< io_uring when the kernel allows it, otherwise THREAD_POOL
+        IO_URING,   ///< Linux io_uring
+        THREAD_POOL ///< Worker threads issuing pread/pwrite
+    };
+
+    /// @brief Batched asynchronous positional I/O. Requests are queued with Prepare*, handed to the
+    /// kernel (or workers) together by one Submit call, and reaped with Complete. An engine instance
+    /// is driven by a single thread at a time
+    class IOEngine
+    {
+    public:
+        virtual ~IOEngine() = default;
+
+        /// @brief Queues a read, not started until Submit
+        /// @param fd File to read
+        /// @param buffer Destination
+        /// @param length Bytes to read
+        /// @param offset File offset
+        /// @param user_data Tag returned with the completion
+        /// @return False if the queue depth is exhausted
+        virtual bool PrepareRead(int fd, char *buffer, size_t length, off_t offset, uint64_t user_data) = 0;
+
+        /// @brief Queues a write, not started until Submit
+        /// @param fd File to write
+        /// @param buffer Source
+        /// @param length Bytes to write
+        /// @param offset File offset
+        /// @param user_data Tag returned with the completion
+        /// @return False if the queue depth is exhausted
+        virtual bool PrepareWrite(int fd, const char *buffer, size_t length, off_t offset, uint64_t user_data) = 0;
+
+        /// @brief Starts every prepared request with a single syscall (or queue hand-off)
+        /// @return Number of requests submitted
+        virtual size_t Submit() = 0;
+
+        /// @brief Reaps finished requests, blocking until at least min_complete are available
+        /// @param completions Appended with finished requests
+        /// @param min_complete Completions to wait for, clamped to the number in flight
+        /// @return Number of completions appended
+        virtual size_t Complete(std::vector<IOCompletion> *completions, size_t min_complete) = 0;
+
+        /// @brief Pins buffers with the engine so transfers into them skip per-request page mapping
+        /// @param buffers Memory regions, e.g. buffer pool frames
+        /// @return True if registered
+        virtual bool RegisterBuffers(const std::vector<iovec> &buffers) = 0;
+
+        /// @brief Gets number of prepared or submitted requests not yet completed
+        /// @return In-flight count
+        virtual size_t InFlight() = 0;
+
+        /// @brief Gets maximum number of requests in flight
+        /// @return Queue depth
+        virtual size_t QueueDepth() = 0;
+
+        /// @brief Gets backend name
+        /// @return Display name
+        virtual const char *Name() = 0;
+    };
+
+    /// @brief Creates an I/O engine
+    /// @param type Backend, AUTO falls back to THREAD_POOL when io_uring cannot be set up
+    /// @param queue_depth Maximum requests in flight
+    /// @return New engine
+    std::unique_ptr<IOEngine> MakeIOEngine(IOEngineType type, size_t queue_depth);
+}
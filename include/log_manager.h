@@ -0,0 +1,142 @@
+#include <chrono>             // std::chrono::microseconds
+#include <condition_variable> // std::condition_variable
+#include <cstdint>            // uint64_t
+#include <memory>             // std::unique_ptr
+#include <mutex>              // std::mutex
+#include <string>             // std::string
+#include <thread>             // std::thread
+#include "common.h"
+#include "log_record.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Log buffering and group commit policy
+    struct LogOptions
+    {
+        /// @brief Bytes per log buffer. There are two: one filling while the other is written
+        size_t buffer_bytes = 1 << 20;
+
+        /// @brief How long the flusher lingers after a flush request so more committers can join
+        /// the same fdatasync. 0 flushes as soon as asked; committers arriving during a sync
+        /// still share the next one
+        std::chrono::microseconds group_commit_delay{0};
+
+        /// @brief Issue fdatasync after each write. Off only for benchmarks
+        bool sync = true;
+    };
+
+    /// @brief Log flusher counters
+    struct LogStats
+    {
+        size_t records = 0;
+        size_t flushes = 0;
+        size_t syncs = 0;
+        uint64_t bytes_written = 0;
+    };
+
+    /// @brief Write-ahead log. Records are appended to an in-memory buffer and given their byte
+    /// offset in the log file as LSN; a flusher thread writes the buffer and fdatasyncs it, so
+    /// every Flush waiting at that time is satisfied by one sync (group commit). Opening an
+    /// existing log finds its end by scanning records and drops a torn tail
+    class LogManager
+    {
+    public:
+        /// @brief Opens or creates a log file and starts the flusher
+        /// @param log_file Log file
+        /// @param options Buffering and group commit policy
+        /// @throws std::runtime_error if the file is not a log file
+        explicit LogManager(const std::string &log_file, const LogOptions &options = LogOptions());
+
+        /// @brief Flushes every appended record, stops the flusher and closes the file
+        ~LogManager();
+
+        LogManager(const LogManager &) = delete;
+        LogManager &operator=(const LogManager &) = delete;
+
+        /// @brief Appends a record to the log buffer, waiting for space if both buffers are full
+        /// @param record Record to append, its lsn is set
+        /// @return LSN of the record
+        lsn_t Append(LogRecord *record);
+
+        /// @brief Waits until a record is on stable storage. LSNs past the end flush everything
+        /// @param lsn Record that must be durable
+        void Flush(lsn_t lsn);
+
+        /// @brief Waits until every appended record is on stable storage
+        void FlushAll();
+
+        /// @brief Reads a record back, from the log buffers or the file
+        /// @param lsn Record to read
+        /// @param record Filled in on success
+        /// @return False if no intact record starts at lsn
+        bool ReadRecord(lsn_t lsn, LogRecord *record);
+
+        /// @brief Gets the LSN of the first record
+        /// @return Offset after the file header
+        lsn_t GetFirstLSN();
+
+        /// @brief Gets where the next record will go
+        /// @return End of the log
+        lsn_t GetNextLSN();
+
+        /// @brief Gets the end of the durable log
+        /// @return Records below this LSN are on stable storage
+        lsn_t GetPersistentLSN();
+
+        /// @brief Gets flusher counters
+        /// @return Snapshot of counters
+        LogStats GetStats();
+
+    private:
+        std::string file_name_;
+        LogOptions options_;
+        int fd_ = -1;
+
+        /// @brief Guards everything below
+        std::mutex latch_;
+        /// @brief Wakes the flusher
+        std::condition_variable flush_cv_;
+        /// @brief Wakes appenders waiting for buffer space and committers waiting for durability
+        std::condition_variable done_cv_;
+
+        /// @brief Buffer being appended to, covering [buffer_lsn_, next_lsn_)
+        std::unique_ptr<char[]> buffer_;
+        lsn_t buffer_lsn_;
+        lsn_t next_lsn_;
+
+        /// @brief Buffer being written by the flusher, covering [flush_lsn_, buffer_lsn_)
+        std::unique_ptr<char[]> flush_buffer_;
+        lsn_t flush_lsn_;
+
+        /// @brief Log is durable below this LSN
+        lsn_t persistent_lsn_;
+        /// @brief Highest LSN a Flush is waiting for
+        lsn_t flush_requested_ = INVALID_LSN;
+
+        bool stop_ = false;
+        std::string io_error_;
+        LogStats stats_;
+        std::thread flusher_;
+
+        /// @brief Flusher loop
+        void RunFlusher();
+
+        /// @brief Finds the end of the intact records and cuts off anything after it
+        /// @param file_size Current file size
+        /// @return End of the log
+        lsn_t Scan(lsn_t file_size);
+
+        /// @brief Reads a record from the file
+        /// @param lsn Record to read
+        /// @param end The record must end at or before this offset
+        /// @param record Filled in on success
+        /// @return False if no intact record starts at lsn
+        bool ReadFromFile(lsn_t lsn, lsn_t end, LogRecord *record);
+
+        /// @brief Throws with the current errno
+        /// @param what Failed operation
+        [[noreturn]] void ThrowIOError(const std::string &what);
+    };
+}
@@ -0,0 +1,72 @@
+#include <cstdint>       // uint32_t, int64_t
+#include <cstring>       // memcpy
+#include <vector>        // std::vector
+#include "common.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Kind of write-ahead log record
+    enum class LogRecordType : uint32_t
+    {
+        INVALID = 0,
+        BEGIN,
+        COMMIT,
+        ABORT,
+        /// @brief Byte range of a page changed, with before and after images
+        UPDATE,
+        /// @brief Compensation record written while undoing an UPDATE. Redo-only, carries the
+        /// restored bytes as its after image and the next record to undo
+        CLR
+    };
+
+    /// @brief One write-ahead log record. On disk it is a fixed header followed by the before
+    /// and after images, and a checksum over everything after the checksum field so a torn
+    /// tail is detected
+    struct LogRecord
+    {
+        LogRecordType type = LogRecordType::INVALID;
+        /// @brief Assigned by LogManager::Append
+        lsn_t lsn = INVALID_LSN;
+        txn_id_t txn_id = INVALID_TXN_ID;
+        /// @brief Previous record of the same transaction
+        lsn_t prev_lsn = INVALID_LSN;
+
+        /// @brief UPDATE and CLR: changed page and byte range
+        page_id_t page_id = INVALID_PAGE_ID;
+        uint32_t offset = 0;
+
+        /// @brief CLR: next record of the transaction still to undo
+        lsn_t undo_next_lsn = INVALID_LSN;
+
+        std::vector<char> before_image;
+        std::vector<char> after_image;
+
+        /// @brief Bytes of the fixed header
+        static constexpr size_t HEADER_SIZE = 64;
+
+        /// @brief Gets serialized size
+        /// @return Header plus images
+        inline size_t GetSize() const
+        {
+            return HEADER_SIZE + before_image.size() + after_image.size();
+        }
+
+        /// @brief Writes the record in its on-disk format
+        /// @param out GetSize() bytes
+        void Serialize(char *out) const;
+
+        /// @brief Reads the size field of a serialized header
+        /// @param header HEADER_SIZE bytes
+        /// @return Total record size claimed by the header
+        static uint32_t PeekSize(const char *header);
+
+        /// @brief Parses a serialized record, checking its size and checksum
+        /// @param in Serialized bytes
+        /// @param available Bytes readable at in
+        /// @param record Filled in on success
+        /// @return False if the bytes are not a complete, intact record
+        static bool Deserialize(const char *in, size_t available, LogRecord *record);
+    };
+}
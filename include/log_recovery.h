@@ -0,0 +1,60 @@
+#include <cstddef>       // size_t
+#include "common.h"
+#include "disk_manager.h"
+#include "buffer_pool.h"
+#include "log_manager.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief What a recovery pass found and did
+    struct RecoveryStats
+    {
+        /// @brief Intact records scanned
+        size_t records = 0;
+        /// @brief UPDATE and CLR records applied because the page was older
+        size_t redone = 0;
+        /// @brief UPDATE records rolled back for losers
+        size_t undone = 0;
+        /// @brief Transactions without COMMIT or ABORT at the crash
+        size_t losers = 0;
+        /// @brief First unused transaction ID
+        txn_id_t next_txn_id = 0;
+    };
+
+    /// @brief ARIES-style restart: analysis and redo in one forward scan of the log, repeating
+    /// history for every UPDATE and CLR whose page LSN is older, then undo of the transactions
+    /// that never finished, newest record first across all of them, writing a compensation
+    /// record per undone update and ABORT once a chain is done. There are no checkpoint records
+    /// yet, so the scan starts at the first record
+    /// @tparam PageSize Bytes per page, matching the pool
+    template <int32_t PageSize>
+    class BasicLogRecovery
+    {
+    public:
+        /// @brief Prepares recovery of one database
+        /// @param dm Disk manager of the database
+        /// @param pool Pool over dm, pages are changed through it
+        /// @param log_manager Log of the database
+        BasicLogRecovery(BasicDiskManager<PageSize> *dm, basic_buffer_pool<PageSize> *pool, LogManager *log_manager);
+
+        /// @brief Brings the pages to the state of the committed transactions. Run before any new
+        /// transaction starts. Changed pages are left dirty in the pool
+        /// @return Counters and the next transaction ID
+        RecoveryStats Recover();
+
+    private:
+        BasicDiskManager<PageSize> *disk_manager_;
+        basic_buffer_pool<PageSize> *pool_;
+        LogManager *log_manager_;
+
+        /// @brief Applies an after image if the page has not seen the record yet
+        /// @param record UPDATE or CLR
+        /// @return True if the page changed
+        bool Redo(const LogRecord &record);
+    };
+
+    /// @brief Recovery of the default PAGE_SIZE
+    using LogRecovery = BasicLogRecovery<PAGE_SIZE>;
+}
@@ -0,0 +1,68 @@
+#include <cstdint>       // uint64_t
+#include <set>           // std::set
+#include <utility>       // std::pair
+#include <vector>        // std::vector
+#include "common.h"
+#include "replacer.h"
+#include "frame_list.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief LRU-K. Evicts the frame whose K-th most recent access is oldest; frames with fewer
+    /// than K accesses have infinite distance and go first, oldest first access first. A single
+    /// sequential scan therefore only displaces other once-touched pages
+    class LRUKReplacer : public Replacer
+    {
+    public:
+        /// @brief Creates replacer for num_frames frames
+        /// @param num_frames Number of frames in the pool
+        /// @param k Number of accesses remembered per frame
+        LRUKReplacer(size_t num_frames, size_t k = 2);
+
+        void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+        void SetEvictable(frame_id_t frame_id, bool evictable) override;
+        bool Evict(frame_id_t *frame_id_ptr) override;
+        void Remove(frame_id_t frame_id) override;
+        void GetCandidates(size_t count, std::vector<frame_id_t> *candidates) override;
+        size_t Size() override;
+
+    private:
+        /// @brief Accesses remembered per frame
+        size_t k_;
+
+        /// @brief Logical clock, bumped on every access
+        uint64_t current_timestamp_ = 0;
+
+        /// @brief Last k access timestamps per frame, a ring of k entries at frame_id * k
+        std::vector<uint64_t> history_;
+
+        /// @brief Number of accesses per tracked frame
+        std::vector<uint64_t> access_count_;
+
+        /// @brief Frames tracked, and frames that may be evicted
+        std::vector<bool> tracked_;
+        std::vector<bool> evictable_;
+        size_t evictable_count_ = 0;
+
+        /// @brief Frames with fewer than k accesses, head is the latest first access
+        FrameList young_;
+
+        /// @brief Frames with k or more accesses ordered by K-th most recent access
+        std::set<std::pair<uint64_t, frame_id_t>> old_;
+
+        /// @brief Gets K-th most recent access of a frame with at least k accesses
+        /// @param frame_id Frame to check
+        /// @return Timestamp
+        inline uint64_t KthTimestamp(frame_id_t frame_id) const
+        {
+            // The oldest ring slot is the one the next access overwrites
+            return history_[frame_id * k_ + access_count_[frame_id] % k_];
+        }
+
+        /// @brief Unlinks frame from young_ or old_
+        /// @param frame_id Frame to unlink
+        void Unlink(frame_id_t frame_id);
+    };
+}
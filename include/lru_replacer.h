@@ -0,0 +1,32 @@
+#include <vector>        // std::vector
+#include "common.h"
+#include "replacer.h"
+#include "frame_list.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Least recently used. Only evictable frames are linked, so Evict takes the tail in O(1)
+    class LRUReplacer : public Replacer
+    {
+    public:
+        /// @brief Creates replacer for num_frames frames
+        /// @param num_frames Number of frames in the pool
+        explicit LRUReplacer(size_t num_frames);
+
+        void RecordAccess(frame_id_t frame_id, page_id_t page_id) override;
+        void SetEvictable(frame_id_t frame_id, bool evictable) override;
+        bool Evict(frame_id_t *frame_id_ptr) override;
+        void Remove(frame_id_t frame_id) override;
+        void GetCandidates(size_t count, std::vector<frame_id_t> *candidates) override;
+        size_t Size() override;
+
+    private:
+        /// @brief Evictable frames, head is most recently used
+        FrameList lru_list_;
+
+        /// @brief Frames currently tracked
+        std::vector<bool> tracked_;
+    };
+}
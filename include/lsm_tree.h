@@ -0,0 +1,297 @@
+#include <atomic>              // std::atomic
+#include <condition_variable>  // std::condition_variable
+#include <cstdint>             // int32_t, uint64_t
+#include <memory>              // std::shared_ptr, std::unique_ptr
+#include <mutex>               // std::mutex
+#include <string>              // std::string
+#include <string_view>         // std::string_view
+#include <thread>              // std::thread
+#include <vector>              // std::vector
+#include "common.h"
+#include "disk_manager.h"
+#include "mem_table.h"
+#include "sstable.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Sizes and triggers of an LSM tree
+    struct LsmOptions
+    {
+        /// @brief Memtable arena size that makes it immutable and queues a flush
+        size_t memtable_bytes = 4 << 20;
+
+        /// @brief Compaction output is split into tables of about this size
+        uint64_t table_bytes = 2 << 20;
+
+        /// @brief Level-0 tables that start a compaction into level 1
+        int l0_compaction_trigger = 4;
+
+        /// @brief Level-0 tables at which writers wait for compaction
+        int l0_stop_writes_trigger = 12;
+
+        /// @brief Size target of level 1; each deeper level is level_multiplier times larger
+        uint64_t level1_bytes = 10 << 20;
+        int level_multiplier = 10;
+
+        /// @brief Bloom filter bits per key of every table
+        int bloom_bits_per_key = 10;
+    };
+
+    /// @brief Work done by an LSM tree since it was opened, and its current shape
+    struct LsmStats
+    {
+        /// @brief Key and value bytes passed to Put and Delete
+        uint64_t user_bytes = 0;
+        /// @brief Memtables written to level 0, and the bytes of their tables
+        uint64_t flushes = 0;
+        uint64_t flush_bytes = 0;
+        /// @brief Compactions that merged tables, and those that only moved one down a level
+        uint64_t compactions = 0;
+        uint64_t trivial_moves = 0;
+        /// @brief Table bytes compactions read and wrote
+        uint64_t compaction_bytes_read = 0;
+        uint64_t compaction_bytes_written = 0;
+        /// @brief Bytes of manifest pages written
+        uint64_t manifest_bytes = 0;
+        /// @brief Writes that waited for a flush or for level 0 to shrink, and the time spent
+        uint64_t stalls = 0;
+        uint64_t stall_micros = 0;
+        /// @brief Tables and table bytes per level
+        std::vector<size_t> level_tables;
+        std::vector<uint64_t> level_bytes;
+
+        /// @brief Bytes the tree wrote per byte it was given
+        /// @return Write amplification, 0 before any write
+        inline double WriteAmplification() const
+        {
+            return user_bytes == 0 ? 0.0
+                                   : static_cast<double>(flush_bytes + compaction_bytes_written + manifest_bytes) /
+                                         user_bytes;
+        }
+    };
+
+    /// @brief Sorted stream of entries with tombstones, what the tree merges
+    class LsmSource;
+
+    /// @brief Log-structured merge tree of byte-string keys and values, for write-heavy data next
+    /// to the page store. Writes go to a skiplist memtable; a full one becomes immutable and a
+    /// background thread writes it to level 0 as a sorted table. The same thread runs leveled
+    /// compaction: level 0 (overlapping tables) is merged into level 1 once it holds
+    /// l0_compaction_trigger tables, and level n >= 1 (disjoint tables) passes one table at a time,
+    /// round robin, into the tables of level n + 1 it overlaps once it outgrows its target. A
+    /// table with nothing to merge with is moved without rewriting, and tombstones are dropped once
+    /// no deeper level can hold the key. The set of tables is an immutable version swapped on
+    /// every change and recorded in a manifest the header page points to. Lookups and iterators
+    /// hold the memtables and version they started on, so they never block the writer or the
+    /// compactor, nor are disturbed by them. Writers stall while a flush is pending on a full memtable or level 0 reaches
+    /// l0_stop_writes_trigger. There is no log: writes not yet flushed are lost in a crash;
+    /// Flush and closing make them durable
+    /// @tparam PageSize Bytes per page, matching the disk manager
+    template <int32_t PageSize>
+    class BasicLsmTree
+    {
+        using Table = BasicSSTable<PageSize>;
+
+    public:
+        /// @brief Levels, 0 included
+        static constexpr int NUM_LEVELS = 7;
+
+        /// @brief Largest key plus value of one entry
+        static constexpr size_t MAX_ENTRY_BYTES = Table::MAX_ENTRY_BYTES;
+
+    private:
+        /// @brief Tables of every level; level 0 newest first, deeper levels by key
+        struct Version
+        {
+            std::vector<std::shared_ptr<Table>> levels[NUM_LEVELS];
+        };
+
+    public:
+        /// @brief Forward iterator over live keys in order, merging the memtables and every
+        /// table. Keeps the memtables and tables it started with alive, so flushes and
+        /// compactions do not disturb it; entries have no sequence numbers, so writes made after
+        /// it was created may or may not be seen. Move-only
+        class Iterator
+        {
+        public:
+            Iterator(Iterator &&other) noexcept;
+            Iterator(const Iterator &) = delete;
+            Iterator &operator=(const Iterator &) = delete;
+            Iterator &operator=(Iterator &&) = delete;
+            ~Iterator();
+
+            /// @brief Checks for a current entry
+            /// @return False past the last key
+            bool Valid() const;
+
+            /// @brief Moves to the smallest key
+            void SeekToFirst();
+
+            /// @brief Moves to the first key not less than key
+            /// @param key Lower bound
+            void Seek(std::string_view key);
+
+            /// @brief Moves to the next key
+            void Next();
+
+            /// @brief Gets the current key, valid until the iterator moves
+            std::string_view GetKey() const;
+
+            /// @brief Gets the current value, valid until the iterator moves
+            std::string_view GetValue() const;
+
+        private:
+            friend class BasicLsmTree;
+
+            Iterator(std::shared_ptr<MemTable> mem, std::shared_ptr<MemTable> imm,
+                     std::shared_ptr<const Version> version);
+
+            /// @brief Steps over tombstones
+            void SkipDeleted();
+
+            std::shared_ptr<MemTable> mem_;
+            std::shared_ptr<MemTable> imm_;
+            std::shared_ptr<const Version> version_;
+            std::unique_ptr<LsmSource> merged_;
+        };
+
+        /// @brief Creates an empty tree: a header page and an empty manifest
+        /// @param disk_manager Where tables and manifest live
+        /// @param options Sizes and triggers
+        explicit BasicLsmTree(BasicDiskManager<PageSize> *disk_manager, const LsmOptions &options = LsmOptions());
+
+        /// @brief Opens an existing tree
+        /// @param disk_manager Disk manager over the tree's database
+        /// @param header_page_id GetHeaderPageId of the tree when it was created
+        /// @param options Sizes and triggers, free to differ from the last run
+        /// @throws std::runtime_error if the page is not a tree header
+        BasicLsmTree(BasicDiskManager<PageSize> *disk_manager, page_id_t header_page_id,
+                     const LsmOptions &options = LsmOptions());
+
+        BasicLsmTree(const BasicLsmTree &) = delete;
+        BasicLsmTree &operator=(const BasicLsmTree &) = delete;
+
+        /// @brief Flushes the memtable and stops the background thread. Pending compactions are
+        /// left for the next open
+        ~BasicLsmTree();
+
+        /// @brief Gets the page that identifies the tree
+        /// @return Header page ID
+        inline page_id_t GetHeaderPageId()
+        {
+            return header_page_id_;
+        }
+
+        /// @brief Adds or replaces a key
+        /// @param key Key
+        /// @param value Value
+        /// @throws std::runtime_error if key and value exceed MAX_ENTRY_BYTES, or the background
+        /// thread failed
+        void Put(std::string_view key, std::string_view value);
+
+        /// @brief Removes a key, if present
+        /// @param key Key
+        /// @throws std::runtime_error if the key exceeds MAX_ENTRY_BYTES, or the background
+        /// thread failed
+        void Delete(std::string_view key);
+
+        /// @brief Point lookup: memtables first, then level 0 newest first, then one table per
+        /// deeper level
+        /// @param key Key to find
+        /// @param value Receives the value
+        /// @return False if absent or deleted
+        bool Get(std::string_view key, std::string *value);
+
+        /// @brief Starts a scan; call SeekToFirst or Seek on it
+        /// @return Iterator over the current state
+        Iterator NewIterator();
+
+        /// @brief Writes the memtable to level 0 and waits until it is on stable storage
+        void Flush();
+
+        /// @brief Waits until no level needs compaction
+        void WaitForCompaction();
+
+        /// @brief Gets counters and table counts
+        /// @return Snapshot
+        LsmStats GetStats();
+
+    private:
+        BasicDiskManager<PageSize> *disk_manager_;
+        LsmOptions options_;
+        page_id_t header_page_id_;
+        /// @brief Pages of the current manifest blob, freed when a new one is written
+        std::vector<page_id_t> manifest_pages_;
+
+        /// @brief Serializes writers; the memtable has one writer at a time
+        std::mutex write_latch_;
+
+        /// @brief Guards mem_, imm_, version_, stop_ and bg_error_
+        std::mutex latch_;
+        /// @brief Wakes the background thread
+        std::condition_variable work_cv_;
+        /// @brief Wakes writers and callers waiting for the background thread
+        std::condition_variable done_cv_;
+        std::shared_ptr<MemTable> mem_;
+        /// @brief Memtable being flushed, nullptr if none
+        std::shared_ptr<MemTable> imm_;
+        /// @brief Current tables. Only the background thread replaces it
+        std::shared_ptr<const Version> version_;
+        bool stop_ = false;
+        /// @brief Background thread is flushing or compacting
+        bool busy_ = false;
+        std::string bg_error_;
+
+        /// @brief Per level, largest key of the last table compacted out of it
+        std::string compact_pointer_[NUM_LEVELS];
+
+        std::atomic<uint64_t> user_bytes_{0};
+        LsmStats stats_;
+        std::thread thread_;
+
+        /// @brief Common setup of both constructors
+        void Start();
+
+        /// @brief Writes an entry, making room first
+        void Write(std::string_view key, std::string_view value, bool deleted);
+
+        /// @brief Swaps in a new memtable when the current one is full, stalling as needed.
+        /// Caller holds write_latch_ and lock on latch_
+        void MakeRoomForWrite(std::unique_lock<std::mutex> &lock);
+
+        /// @brief Background thread: flushes, then compacts, until stopped
+        void Run();
+
+        /// @brief Writes imm_ to a level-0 table and installs it
+        void FlushImmutable(std::unique_lock<std::mutex> &lock);
+
+        /// @brief Picks the level most over its target
+        /// @param version Tables
+        /// @return Level to compact, -1 if none needs it
+        int PickLevel(const Version &version);
+
+        /// @brief Compacts one level into the next and installs the result
+        void Compact(std::unique_lock<std::mutex> &lock, int level);
+
+        /// @brief Size target of a level >= 1
+        uint64_t MaxBytesForLevel(int level);
+
+        /// @brief Checks that no level below output_level may hold a key, so its tombstone can go
+        static bool IsBaseLevelForKey(const Version &version, int output_level, std::string_view key);
+
+        /// @brief Writes the manifest of a version and swaps it in. Tables are synced before the
+        /// header points at them. Caller must not hold latch_
+        void Install(std::shared_ptr<const Version> version);
+
+        /// @brief Reads the manifest into version_
+        void Recover();
+
+        /// @brief Sums a level's table bytes
+        static uint64_t LevelBytes(const Version &version, int level);
+    };
+
+    /// @brief LSM tree of the default PAGE_SIZE
+    using LsmTree = BasicLsmTree<PAGE_SIZE>;
+}
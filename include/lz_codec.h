@@ -0,0 +1,46 @@
+#include <cstddef>       // size_t
+#include <cstdint>       // uint8_t, uint32_t
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Byte-oriented LZ77 codec in the LZ4 style, for compressing pages in memory. A block
+    /// is a series of sequences, each a token byte (literal count in the high nibble, match length
+    /// minus 4 in the low one, 15 meaning more length bytes follow), the literals, and a 2-byte
+    /// little-endian match offset; the last sequence has literals only. The compressor is greedy
+    /// with one hash-table probe per position and skips ahead faster through data that does not
+    /// match. Blocks are at most 64 KiB, so offsets always fit. Not a stable on-disk format
+    class LzCodec
+    {
+    public:
+        /// @brief Compresses a block
+        /// @param src Input
+        /// @param size Input bytes, at most MAX_BLOCK_SIZE
+        /// @param dst Output buffer
+        /// @param capacity Output bytes available
+        /// @return Compressed size, 0 if it does not fit in capacity
+        static size_t Compress(const char *src, size_t size, char *dst, size_t capacity);
+
+        /// @brief Decompresses a block, checking every length and offset against the buffers
+        /// @param src Compressed block
+        /// @param size Compressed bytes
+        /// @param dst Output buffer
+        /// @param original_size Exact uncompressed size
+        /// @return False if the block is corrupt or does not expand to original_size
+        static bool Decompress(const char *src, size_t size, char *dst, size_t original_size);
+
+        /// @brief Largest block the codec accepts
+        static constexpr size_t MAX_BLOCK_SIZE = 65536;
+
+    private:
+        static constexpr size_t MIN_MATCH = 4;
+        static constexpr size_t MAX_OFFSET = 65535;
+        static constexpr int HASH_BITS = 12;
+
+        static inline uint32_t Hash(uint32_t sequence)
+        {
+            return (sequence * 2654435761u) >> (32 - HASH_BITS);
+        }
+    };
+}
@@ -0,0 +1,177 @@
+#include <atomic>        // std::atomic
+#include <cstddef>       // size_t
+#include <cstdint>       // uint32_t, uint64_t
+#include <memory>        // std::unique_ptr
+#include <string>        // std::string
+#include <string_view>   // std::string_view
+#include <vector>        // std::vector
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Sorted in-memory write buffer of an LSM tree: a skiplist of keys, each pointing to
+    /// its latest value or tombstone. Nodes and values are carved from an arena freed with the
+    /// table, so nothing is deleted while readers may hold a pointer. One writer at a time (the
+    /// caller serializes Put); readers and iterators run concurrently with it without locks. A
+    /// node is published with a release store once fully built, and an overwrite swaps the key's
+    /// value pointer, so readers always see a complete value
+    class MemTable
+    {
+    public:
+        /// @brief Key order of the table, lexicographic by unsigned byte
+        /// @param a First key
+        /// @param b Second key
+        /// @return <0, 0 or >0 like memcmp
+        static inline int Compare(std::string_view a, std::string_view b)
+        {
+            return a.compare(b);
+        }
+
+    private:
+        struct Value
+        {
+            uint32_t size;
+            bool deleted;
+            char data[1];
+        };
+
+        struct Node
+        {
+            const char *key;
+            uint32_t key_size;
+            int height;
+            std::atomic<const Value *> value;
+            /// @brief Successor per level, height entries allocated
+            std::atomic<Node *> next[1];
+
+            inline std::string_view GetKey() const
+            {
+                return std::string_view(key, key_size);
+            }
+        };
+
+    public:
+        /// @brief Forward iterator in key order. Sees entries added after it was created if it
+        /// has not passed them yet. The table must outlive it
+        class Iterator
+        {
+        public:
+            /// @brief Starts unpositioned; call SeekToFirst or Seek
+            /// @param table Table to iterate
+            explicit Iterator(const MemTable *table) : table_(table), node_(nullptr), value_(nullptr)
+            {
+            }
+
+            /// @brief Checks for a current entry
+            /// @return False past the last key
+            inline bool Valid() const
+            {
+                return node_ != nullptr;
+            }
+
+            /// @brief Moves to the smallest key
+            void SeekToFirst();
+
+            /// @brief Moves to the first key not less than key
+            /// @param key Lower bound
+            void Seek(std::string_view key);
+
+            /// @brief Moves to the next key
+            void Next();
+
+            /// @brief Gets the current key, valid while the table lives
+            inline std::string_view GetKey() const
+            {
+                return node_->GetKey();
+            }
+
+            /// @brief Gets the current value, empty for a tombstone
+            inline std::string_view GetValue() const
+            {
+                return std::string_view(value_->data, value_->size);
+            }
+
+            /// @brief Checks if the current entry is a tombstone
+            inline bool IsDeleted() const
+            {
+                return value_->deleted;
+            }
+
+        private:
+            /// @brief Pins the value of the new current node, so Key/Value stay consistent
+            void Load();
+
+            const MemTable *table_;
+            const Node *node_;
+            const Value *value_;
+        };
+
+        MemTable();
+        MemTable(const MemTable &) = delete;
+        MemTable &operator=(const MemTable &) = delete;
+
+        /// @brief Adds or replaces a key. Callers serialize writers
+        /// @param key Key
+        /// @param value Value, ignored for a tombstone
+        /// @param deleted Write a tombstone, hiding older versions of the key
+        void Put(std::string_view key, std::string_view value, bool deleted);
+
+        /// @brief Point lookup
+        /// @param key Key to find
+        /// @param value Receives the value if it is live
+        /// @param deleted Set if the key's latest entry is a tombstone
+        /// @return False if the table holds no entry for the key
+        bool Get(std::string_view key, std::string *value, bool *deleted) const;
+
+        /// @brief Gets bytes carved from the arena for nodes, keys and values (replaced values
+        /// included), the measure for when to flush
+        /// @return Bytes
+        inline size_t GetMemoryUsage() const
+        {
+            return memory_usage_.load(std::memory_order_relaxed);
+        }
+
+        /// @brief Gets the number of distinct keys
+        /// @return Entries
+        inline uint64_t GetCount() const
+        {
+            return count_.load(std::memory_order_relaxed);
+        }
+
+        /// @brief Tallest tower; 1/4 of nodes reach each level above the previous one
+        static constexpr int MAX_HEIGHT = 12;
+
+    private:
+        /// @brief Arena block size; larger allocations get a block of their own
+        static constexpr size_t BLOCK_BYTES = 64 * 1024;
+
+        std::vector<std::unique_ptr<char[]>> blocks_;
+        char *alloc_ptr_ = nullptr;
+        size_t alloc_remaining_ = 0;
+        std::atomic<size_t> memory_usage_{0};
+
+        Node *head_;
+        std::atomic<int> height_{1};
+        std::atomic<uint64_t> count_{0};
+        uint64_t random_state_ = 0x2545f4914f6cdd1dull;
+
+        /// @brief Carves pointer-aligned bytes from the arena. Writer only
+        char *Allocate(size_t bytes);
+
+        /// @brief Builds an unlinked node with an empty value
+        Node *NewNode(std::string_view key, int height);
+
+        /// @brief Copies a value into the arena
+        const Value *NewValue(std::string_view value, bool deleted);
+
+        /// @brief Draws a tower height
+        int RandomHeight();
+
+        /// @brief Finds the first node not less than key
+        /// @param key Key to look for
+        /// @param prev Receives the last node before it on each level, may be nullptr
+        /// @return Node, nullptr if every key is less
+        Node *FindGreaterOrEqual(std::string_view key, Node **prev) const;
+    };
+}
@@ -0,0 +1,191 @@
+#include <atomic>        // std::atomic
+#include <cstddef>       // size_t
+#include <cstdint>       // int32_t, uint64_t
+#include <memory>        // std::unique_ptr
+#include <mutex>         // std::mutex
+#include <vector>        // std::vector
+#include "common.h"
+#include "page.h"
+#include "disk_manager.h"
+#include "stats.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Expected access pattern of a mapping, passed to madvise
+    enum class MmapAdvice
+    {
+        NORMAL,    ///< Kernel default read-around
+        RANDOM,    ///< Point lookups: no read-around, fault in single pages
+        SEQUENTIAL ///< Scans: aggressive read-ahead, pages dropped soon after use
+    };
+
+    /// @brief How basic_mmap_pool maps the database
+    struct MmapOptions
+    {
+        /// @brief Map shared and writable: pages unpinned dirty are written by FlushPage and
+        /// FlushAllPages with msync. Read-only otherwise, and unpinning a page dirty throws
+        bool writable = false;
+
+        /// @brief Initial madvise hint for the whole mapping, see Advise
+        MmapAdvice advice = MmapAdvice::RANDOM;
+
+        /// @brief Fault every page in while mapping (MAP_POPULATE), so a warm file serves
+        /// lookups without page faults
+        bool populate = false;
+    };
+
+    /// @brief What a mmap pool did since it was created
+    struct MmapPoolStats
+    {
+        size_t fetches = 0;
+        /// @brief Pages written back through msync
+        size_t pages_synced = 0;
+        size_t msync_calls = 0;
+        /// @brief Pages with a descriptor, i.e. fetched at least once
+        size_t pages_touched = 0;
+    };
+
+    /// @brief Read-mostly alternative to basic_buffer_pool: the data pages of a DiskManager's
+    /// file are mapped once and FetchPage returns a Page whose data points into the mapping, so
+    /// there is no frame to fill, no copy out of the OS page cache and no eviction; the kernel
+    /// pages the file in and out. Descriptors are created on first fetch and kept, for pin counts
+    /// and page latches. Covers the pages allocated when it was created: it cannot create, delete
+    /// or grow pages. Writes are visible to other readers of the file at once but only durable
+    /// after an explicit flush, and the kernel may write a dirty page back earlier, so it is no
+    /// place for pages that rely on write-ahead logging. FetchPage and UnpinPage take no lock
+    /// once a page has its descriptor
+    /// @tparam PageSize Bytes per page, matching the disk manager
+    template <int32_t PageSize>
+    class basic_mmap_pool
+    {
+    public:
+        /// @brief Maps every segment holding the allocated pages
+        /// @param dm Disk manager whose file is mapped; should not use O_DIRECT when writable,
+        /// as direct writes bypass the mapped pages
+        /// @param options Write mode, access hint and warmup
+        /// @throws std::runtime_error if mapping fails
+        basic_mmap_pool(BasicDiskManager<PageSize> *dm, const MmapOptions &options = MmapOptions());
+
+        /// @brief Flushes dirty pages if writable, then unmaps
+        ~basic_mmap_pool();
+
+        basic_mmap_pool(const basic_mmap_pool &) = delete;
+        basic_mmap_pool &operator=(const basic_mmap_pool &) = delete;
+
+        /// @brief Gets a page (pins it). The first touch of a page not in the OS page cache
+        /// faults it in from disk
+        /// @param page_id Page ID to retrieve
+        /// @return Page with ID page_id, its data inside the mapping
+        /// @throws std::out_of_range for a page outside the mapping
+        BasicPage<PageSize> *FetchPage(page_id_t page_id);
+
+        /// @brief Decrements the page's pin count and marks it dirty
+        /// @param page_id Page to unpin
+        /// @param is_dirty Page was changed
+        /// @throws std::runtime_error if is_dirty and the pool is read-only
+        void UnpinPage(page_id_t page_id, bool is_dirty);
+
+        /// @brief Writes a dirty page back with msync and waits for it
+        /// @param page_id Page to flush
+        void FlushPage(page_id_t page_id);
+
+        /// @brief Writes every dirty page back, adjacent pages merged into one msync
+        void FlushAllPages();
+
+        /// @brief Changes the access hint of a range of pages, e.g. SEQUENTIAL before a scan
+        /// @param advice Hint
+        /// @param first First page ID
+        /// @param count Number of pages, clamped to the mapping
+        void Advise(MmapAdvice advice, page_id_t first, size_t count);
+
+        /// @brief Starts reading pages [first, first + count) into the OS page cache in the
+        /// background (MADV_WILLNEED)
+        /// @param first First page ID
+        /// @param count Number of pages, clamped to the mapping
+        void Prefetch(page_id_t first, size_t count);
+
+        /// @brief Checks whether a page is in the OS page cache, so fetching it will not fault to
+        /// disk (mincore)
+        /// @param page_id Page to look up
+        /// @return True if resident
+        bool IsResident(page_id_t page_id);
+
+        /// @brief Gets counters
+        /// @return Snapshot of counters
+        MmapPoolStats GetStats();
+
+        /// @brief Gets the number of mapped pages
+        /// @return Pages, IDs [0, GetPageCount())
+        inline size_t GetPageCount()
+        {
+            return page_count_;
+        }
+
+        /// @brief Checks whether pages can be written
+        /// @return MmapOptions::writable
+        inline bool IsWritable()
+        {
+            return writable_;
+        }
+
+        /// @brief Gets bytes per page
+        /// @return PageSize
+        static constexpr int32_t GetPageSize()
+        {
+            return PageSize;
+        }
+
+    private:
+        /// @brief Descriptors per chunk, created together on first fetch of any of them
+        static constexpr size_t CHUNK_PAGES = 1024;
+
+        /// @brief One mapped segment file
+        struct Segment
+        {
+            char *data = nullptr;
+            size_t length = 0;
+        };
+
+        BasicDiskManager<PageSize> *disk_manager_;
+        bool writable_;
+        size_t page_count_;
+        uint64_t segment_pages_;
+        std::vector<Segment> segments_;
+
+        /// @brief Descriptor chunk per CHUNK_PAGES page IDs, nullptr until first fetched
+        std::unique_ptr<std::atomic<BasicPage<PageSize> *>[]> chunks_;
+
+        /// @brief Owns the descriptor chunks, and guards creating them and dirty_
+        std::mutex latch_;
+        std::vector<std::vector<BasicPage<PageSize>>> chunk_storage_;
+        /// @brief Pages unpinned dirty since their last flush. Guarded by latch_
+        std::vector<page_id_t> dirty_;
+
+        StripedCounter fetches_;
+        StripedCounter pages_synced_;
+        StripedCounter msync_calls_;
+
+        /// @brief Gets the mapped address of a page
+        /// @param page_id Page below page_count_
+        /// @return PageSize bytes
+        char *PageAddress(page_id_t page_id);
+
+        /// @brief Creates the descriptor chunk of a page if needed
+        /// @param chunk Chunk index
+        /// @return Chunk's descriptors
+        BasicPage<PageSize> *LoadChunk(size_t chunk);
+
+        /// @brief Syncs pages with msync, one call per run of pages adjacent in one segment,
+        /// and clears their dirty flags
+        /// @param page_ids Pages to write, sorted
+        void SyncPages(const std::vector<page_id_t> &page_ids);
+
+        /// @brief Calls madvise for every segment piece of a page range
+        void AdviseRange(int advice, page_id_t first, size_t count);
+    };
+
+    /// @brief mmap pool of the default PAGE_SIZE
+    using mmap_pool = basic_mmap_pool<PAGE_SIZE>;
+}
@@ -7,15 +7,57 @@
 #include <fstream>       // std::fstream
 #include <stdexcept>     // std::runtime_error
 #include <iostream>      // std::cout
+#include <atomic>        // std::atomic
 #include "common.h"
+#include "page_latch.h"
 
 #pragma once
 
 namespace minidb
 {
-    class Page
+    /// @brief Frame descriptor: page metadata plus a pointer to the frame's data. Pools keep
+    /// descriptors in one compact array and the data in a FrameArena, so metadata scans touch
+    /// consecutive cache lines instead of one line per frame
+    /// @tparam PageSize Bytes per page, a multiple of PAGE_ALIGNMENT
+    template <int32_t PageSize>
+    class BasicPage
     {
+        static_assert(PageSize > 0 && PageSize % PAGE_ALIGNMENT == 0, "Page size must be a multiple of PAGE_ALIGNMENT");
+
     public:
+        /// @brief Allocates zeroed, PAGE_ALIGNMENT aligned frame memory so pages can be
+        /// transferred with O_DIRECT
+        BasicPage();
+
+        /// @brief Uses frame memory owned by someone else, e.g. a FrameArena
+        /// @param data PageSize bytes, PAGE_ALIGNMENT aligned, outliving the Page
+        explicit BasicPage(char *data);
+
+        /// @brief Frees frame memory if owned
+        ~BasicPage();
+
+        BasicPage(const BasicPage &) = delete;
+        BasicPage &operator=(const BasicPage &) = delete;
+
+        /// @brief Takes over the frame memory and metadata of another page, so descriptors can
+        /// live in a std::vector. Only for pages no other thread is using
+        /// @param other Page left without memory
+        BasicPage(BasicPage &&other) noexcept;
+
+        /// @brief Gets bytes per page
+        /// @return PageSize
+        static constexpr int32_t GetPageSize()
+        {
+            return PageSize;
+        }
+
+        /// @brief Byte offset of the page LSN within the page data
+        static constexpr uint32_t LSN_OFFSET = 0;
+
+        /// @brief Bytes at the start of the page reserved for the header (the page LSN). Logged
+        /// updates go after it
+        static constexpr uint32_t HEADER_SIZE = sizeof(lsn_t);
+
         /// @brief Gets data from page
         /// @return data from page
         inline char *GetData()
@@ -41,19 +83,19 @@ namespace minidb
         /// @return Pin count - Number of operations using page
         inline int GetPinCount()
         {
-            return pin_count_;
+            return pin_count_.load(std::memory_order_acquire);
         }
 
         /// @brief Increases pin count by 1
         inline void IncrementPinCount()
         {
-            pin_count_++;
+            pin_count_.fetch_add(1, std::memory_order_acq_rel);
         }
 
         /// @brief Decreases pin count by 1
         inline void DecrementPinCount()
         {
-            pin_count_--;
+            pin_count_.fetch_sub(1, std::memory_order_acq_rel);
         }
 
         /// @brief Gets dirty status
@@ -70,20 +112,55 @@ namespace minidb
             is_dirty_ = is_dirty;
         }
 
+        /// @brief Gets the LSN of the last logged update, stored in the page header so it reaches
+        /// disk with the page. Zero for never logged pages
+        /// @return Page LSN
+        inline lsn_t GetLSN()
+        {
+            lsn_t lsn;
+            memcpy(&lsn, data_ + LSN_OFFSET, sizeof(lsn));
+            return lsn;
+        }
+
+        /// @brief Sets the page LSN
+        /// @param lsn LSN of the update just applied
+        inline void SetLSN(lsn_t lsn)
+        {
+            memcpy(data_ + LSN_OFFSET, &lsn, sizeof(lsn));
+        }
+
+        /// @brief Gets the frame's reader-writer latch. Pinning keeps the frame from being reused;
+        /// the latch orders access to its contents. Usually taken through the page guards
+        /// @return Latch
+        inline PageLatch &GetLatch()
+        {
+            return latch_;
+        }
+
         /// @brief Resets page for when frame is used for another page
         void Reset();
 
     private:
-        /// @brief Data stored within page. Defaulted to zeros
-        char data_[PAGE_SIZE] = {};
+        /// @brief Data stored within page, PageSize bytes. Defaulted to zeros
+        char *data_;
 
         /// @brief Page ID. Defaulted to -1, Invalid Page ID
         page_id_t page_id_ = INVALID_PAGE_ID;
 
-        /// @brief Tracks how many operations are using this page. Cannot evict if > 0
-        int pin_count_ = 0;
+        /// @brief Tracks how many operations are using this page. Cannot evict if > 0.
+        /// Atomic so pin state can be read without holding the owning pool's latch
+        std::atomic<int> pin_count_{0};
 
         /// @brief Tracks if page was modified. Write to disk if modified.
         bool is_dirty_ = false;
+
+        /// @brief data_ was allocated by this page
+        bool owns_data_ = true;
+
+        /// @brief Orders readers and writers of data_. Not moved: only idle pages are moved
+        PageLatch latch_;
     };
+
+    /// @brief Page of the default PAGE_SIZE
+    using Page = BasicPage<PAGE_SIZE>;
 }
\ No newline at end of file
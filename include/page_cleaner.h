@@ -0,0 +1,76 @@
+#include <atomic>             // std::atomic
+#include <chrono>             // std::chrono::milliseconds
+#include <condition_variable> // std::condition_variable
+#include <mutex>              // std::mutex
+#include <thread>             // std::thread
+#include <vector>             // std::vector
+#include "common.h"
+#include "buffer_pool.h"
+#include "rate_limiter.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief How aggressively PageCleaner writes ahead of eviction
+    struct CleanerOptions
+    {
+        /// @brief Fraction of each pool's frames, taken from the front of the replacement order,
+        /// kept clean so evictions do not have to write
+        double clean_fraction = 0.1;
+
+        /// @brief Time between passes
+        std::chrono::milliseconds interval{100};
+
+        /// @brief Write bandwidth cap shared by all pools, 0 for unlimited
+        uint64_t max_bytes_per_sec = 0;
+    };
+
+    /// @brief Background thread that periodically writes back dirty replacement candidates
+    /// (buffer_pool::CleanCandidates), taking write latency off the FetchPage/NewPage miss path.
+    /// Starts on construction, stops on destruction
+    class PageCleaner
+    {
+    public:
+        /// @brief Starts cleaning one pool
+        /// @param pool Pool to clean, must outlive the cleaner
+        /// @param options Cleaning policy
+        explicit PageCleaner(buffer_pool *pool, const CleanerOptions &options = CleanerOptions());
+
+        /// @brief Starts cleaning several pools, e.g. parallel_buffer_pool::GetShards
+        /// @param pools Pools to clean, must outlive the cleaner
+        /// @param options Cleaning policy
+        PageCleaner(std::vector<buffer_pool *> pools, const CleanerOptions &options = CleanerOptions());
+
+        /// @brief Stops the thread
+        ~PageCleaner();
+
+        PageCleaner(const PageCleaner &) = delete;
+        PageCleaner &operator=(const PageCleaner &) = delete;
+
+        /// @brief Stops the thread, idempotent
+        void Stop();
+
+        /// @brief Gets pages written by the cleaner so far
+        /// @return Page count
+        inline size_t GetPagesCleaned()
+        {
+            return pages_cleaned_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::vector<buffer_pool *> pools_;
+        CleanerOptions options_;
+        RateLimiter limiter_;
+
+        std::mutex latch_;
+        std::condition_variable stop_cv_;
+        bool stop_ = false;
+
+        std::atomic<size_t> pages_cleaned_{0};
+        std::thread thread_;
+
+        /// @brief Cleaner loop
+        void Run();
+    };
+}
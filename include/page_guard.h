@@ -0,0 +1,187 @@
+#include <cstdint>       // int32_t, uint64_t
+#include "common.h"
+#include "page.h"
+
+#pragma once
+
+namespace minidb
+{
+    template <int32_t PageSize>
+    class basic_buffer_pool;
+
+    template <int32_t PageSize>
+    class BasicOptimisticPageGuard;
+
+    /// @brief Pinned page held with a shared latch. Releasing unlatches, then unpins clean.
+    /// Move-only; an empty guard (default-constructed or moved from) holds nothing
+    /// @tparam PageSize Bytes per page
+    template <int32_t PageSize>
+    class BasicReadPageGuard
+    {
+    public:
+        BasicReadPageGuard() = default;
+
+        /// @brief Latches a page the caller has pinned, taking over the pin
+        /// @param pool Pool to unpin in
+        /// @param page Pinned page
+        BasicReadPageGuard(basic_buffer_pool<PageSize> *pool, BasicPage<PageSize> *page);
+
+        BasicReadPageGuard(BasicReadPageGuard &&other) noexcept;
+        BasicReadPageGuard &operator=(BasicReadPageGuard &&other) noexcept;
+        BasicReadPageGuard(const BasicReadPageGuard &) = delete;
+        BasicReadPageGuard &operator=(const BasicReadPageGuard &) = delete;
+
+        /// @brief Releases the page if still held
+        ~BasicReadPageGuard();
+
+        /// @brief Unlatches and unpins early. No-op on an empty guard
+        void Release();
+
+        /// @brief Checks whether a page is held
+        inline bool Valid() const
+        {
+            return page_ != nullptr;
+        }
+
+        inline page_id_t GetPageId()
+        {
+            return page_->GetPageId();
+        }
+
+        inline const char *GetData()
+        {
+            return page_->GetData();
+        }
+
+    private:
+        basic_buffer_pool<PageSize> *pool_ = nullptr;
+        BasicPage<PageSize> *page_ = nullptr;
+    };
+
+    /// @brief Pinned page held with an exclusive latch. Releasing unlatches, then unpins dirty.
+    /// Move-only
+    /// @tparam PageSize Bytes per page
+    template <int32_t PageSize>
+    class BasicWritePageGuard
+    {
+        friend class BasicOptimisticPageGuard<PageSize>;
+
+    public:
+        BasicWritePageGuard() = default;
+
+        /// @brief Latches a page the caller has pinned, taking over the pin
+        /// @param pool Pool to unpin in
+        /// @param page Pinned page
+        BasicWritePageGuard(basic_buffer_pool<PageSize> *pool, BasicPage<PageSize> *page);
+
+        BasicWritePageGuard(BasicWritePageGuard &&other) noexcept;
+        BasicWritePageGuard &operator=(BasicWritePageGuard &&other) noexcept;
+        BasicWritePageGuard(const BasicWritePageGuard &) = delete;
+        BasicWritePageGuard &operator=(const BasicWritePageGuard &) = delete;
+
+        /// @brief Releases the page if still held
+        ~BasicWritePageGuard();
+
+        /// @brief Unlatches and unpins early, marking the page dirty. No-op on an empty guard
+        void Release();
+
+        inline bool Valid() const
+        {
+            return page_ != nullptr;
+        }
+
+        inline page_id_t GetPageId()
+        {
+            return page_->GetPageId();
+        }
+
+        inline char *GetData()
+        {
+            return page_->GetData();
+        }
+
+        /// @brief Gets the page itself, e.g. to set its LSN
+        inline BasicPage<PageSize> *GetPage()
+        {
+            return page_;
+        }
+
+    private:
+        basic_buffer_pool<PageSize> *pool_ = nullptr;
+        BasicPage<PageSize> *page_ = nullptr;
+    };
+
+    /// @brief Pinned page read without a latch. The guard records the page version; reads are
+    /// only trustworthy once Validate confirms no writer came in between, so copy what you need
+    /// first and never follow a pointer read from the page before validating. Releasing only
+    /// unpins. Move-only
+    /// @tparam PageSize Bytes per page
+    template <int32_t PageSize>
+    class BasicOptimisticPageGuard
+    {
+    public:
+        BasicOptimisticPageGuard() = default;
+
+        /// @brief Records the version of a page the caller has pinned, taking over the pin.
+        /// Waits if a writer holds it
+        /// @param pool Pool to unpin in
+        /// @param page Pinned page
+        BasicOptimisticPageGuard(basic_buffer_pool<PageSize> *pool, BasicPage<PageSize> *page);
+
+        BasicOptimisticPageGuard(BasicOptimisticPageGuard &&other) noexcept;
+        BasicOptimisticPageGuard &operator=(BasicOptimisticPageGuard &&other) noexcept;
+        BasicOptimisticPageGuard(const BasicOptimisticPageGuard &) = delete;
+        BasicOptimisticPageGuard &operator=(const BasicOptimisticPageGuard &) = delete;
+
+        /// @brief Releases the page if still held
+        ~BasicOptimisticPageGuard();
+
+        /// @brief Unpins early. No-op on an empty guard
+        void Release();
+
+        inline bool Valid() const
+        {
+            return page_ != nullptr;
+        }
+
+        inline page_id_t GetPageId()
+        {
+            return page_->GetPageId();
+        }
+
+        /// @brief Gets the page data, possibly mid-write until validated
+        inline const char *GetData()
+        {
+            return page_->GetData();
+        }
+
+        /// @brief Checks that no writer latched the page since the version was recorded
+        /// @return True if everything read so far is consistent
+        inline bool Validate()
+        {
+            return page_->GetLatch().Validate(version_);
+        }
+
+        /// @brief Records the current version again, to retry a read that failed validation
+        inline void Restart()
+        {
+            version_ = page_->GetLatch().ReadVersion();
+        }
+
+        /// @brief Takes the exclusive latch if the page is unchanged since the recorded version.
+        /// On success the pin moves to the write guard and this guard becomes empty
+        /// @param write Receives the page
+        /// @return False if a writer came in between; this guard is unchanged
+        bool TryUpgrade(BasicWritePageGuard<PageSize> *write);
+
+    private:
+        basic_buffer_pool<PageSize> *pool_ = nullptr;
+        BasicPage<PageSize> *page_ = nullptr;
+        uint64_t version_ = 0;
+    };
+
+    /// @brief Guards of the default PAGE_SIZE
+    using ReadPageGuard = BasicReadPageGuard<PAGE_SIZE>;
+    using WritePageGuard = BasicWritePageGuard<PAGE_SIZE>;
+    using OptimisticPageGuard = BasicOptimisticPageGuard<PAGE_SIZE>;
+}
@@ -0,0 +1,99 @@
+#include <atomic>        // std::atomic, std::atomic_thread_fence
+#include <cstdint>       // uint32_t, uint64_t
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Reader-writer latch on one frame with an optimistic read mode. The version word is
+    /// odd while a writer holds the latch and grows by two per exclusive section. Shared holders
+    /// are counted apart from it; optimistic readers only load the version before and after
+    /// reading, so a page read by many threads at once sees no cache-line writes at all. Writers
+    /// take precedence over new shared holders, so the latch is not reentrant
+    class PageLatch
+    {
+    public:
+        /// @brief Takes the latch shared, waiting while a writer holds it
+        inline void LockShared()
+        {
+            while (!TryLockShared())
+            {
+                WaitUnlocked();
+            }
+        }
+
+        /// @brief Takes the latch shared unless a writer holds it
+        /// @return False, without waiting, if write-latched
+        inline bool TryLockShared()
+        {
+            // Announce first, then look for a writer; the writer does the reverse
+            readers_.fetch_add(1, std::memory_order_seq_cst);
+            if ((version_.load(std::memory_order_seq_cst) & 1) == 0)
+            {
+                return true;
+            }
+            readers_.fetch_sub(1, std::memory_order_release);
+            return false;
+        }
+
+        /// @brief Releases a shared hold
+        inline void UnlockShared()
+        {
+            readers_.fetch_sub(1, std::memory_order_release);
+        }
+
+        /// @brief Takes the latch exclusive: makes the version odd, then waits out shared holders
+        void LockExclusive();
+
+        /// @brief Upgrades an optimistic read to an exclusive hold if no writer came in between
+        /// @param version From ReadVersion
+        /// @return False, without waiting, if the version moved on
+        bool TryLockExclusive(uint64_t version);
+
+        /// @brief Releases an exclusive hold. The version is even again and differs from every
+        /// version read before the section
+        inline void UnlockExclusive()
+        {
+            version_.fetch_add(1, std::memory_order_release);
+        }
+
+        /// @brief Starts an optimistic read, waiting while a writer holds the latch
+        /// @return Version to pass to Validate
+        inline uint64_t ReadVersion()
+        {
+            uint64_t version = version_.load(std::memory_order_acquire);
+            while ((version & 1) != 0)
+            {
+                WaitUnlocked();
+                version = version_.load(std::memory_order_acquire);
+            }
+            return version;
+        }
+
+        /// @brief Ends an optimistic read. Data read since ReadVersion is only meaningful if this
+        /// returns true
+        /// @param version From ReadVersion
+        /// @return False if a writer took the latch in between
+        inline bool Validate(uint64_t version)
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return version_.load(std::memory_order_relaxed) == version;
+        }
+
+        /// @brief Gets the current version, odd while write-latched
+        inline uint64_t GetVersion()
+        {
+            return version_.load(std::memory_order_acquire);
+        }
+
+    private:
+        std::atomic<uint64_t> version_{0};
+        std::atomic<uint32_t> readers_{0};
+
+        /// @brief Spins, then yields, until no writer holds the latch
+        void WaitUnlocked();
+
+        /// @brief Spins, then yields, until shared holders are gone. Caller made the version odd
+        void WaitForReaders();
+    };
+}
@@ -0,0 +1,98 @@
+#include <cstdint>       // int32_t, uint64_t
+#include <vector>        // std::vector
+#include <memory>        // std::unique_ptr
+#include <stdexcept>     // std::runtime_error
+#include "common.h"
+#include "page.h"
+#include "disk_manager.h"
+#include "buffer_pool.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Buffer pool split into independent shards. A page always lives in the shard chosen by
+    /// hashing its page ID, and each shard has its own latch, page table, free list and LRU, so
+    /// fetches of different pages on different cores rarely contend
+    class parallel_buffer_pool
+    {
+    public:
+        /// @brief Splits frames as evenly as possible across num_shards buffer pools
+        /// @param frames Total number of frames
+        /// @param num_shards Number of independent shards (at least 1)
+        /// @param dm Disk manager shared by every shard
+        /// @param policy Page replacement policy of each shard
+        parallel_buffer_pool(int frames, size_t num_shards, DiskManager *dm,
+                             ReplacerPolicy policy = ReplacerPolicy::LRU);
+
+        /// @brief Gets page from its shard's cache or disk (pins it)
+        /// @param page_id Page ID to retrieve
+        /// @return Page with ID page_id
+        Page *FetchPage(page_id_t page_id);
+
+        /// @brief Allocates a page on disk and creates it in the owning shard
+        /// @param page_id page ID to assign
+        /// @return Created Page
+        Page *NewPage(page_id_t *page_id);
+
+        /// @brief Decrements the page count and sets dirty flag
+        /// @param page_id Page ID to decrement pin
+        /// @param isDirty Set dirty
+        void UnpinPage(page_id_t page_id, bool isDirty);
+
+        /// @brief Drops a page from its shard and frees it on disk
+        /// @param page_id Page to delete
+        /// @return False if the page is pinned
+        bool DeletePage(page_id_t page_id);
+
+        /// @brief Manually flush page
+        /// @param page_id Page to flush
+        void FlushPage(page_id_t page_id);
+
+        /// @brief Flush all pages of every shard
+        void FlushAllPages();
+
+        /// @brief Checkpoints every shard, then syncs the file once
+        /// @param options Batching, sync and rate limiting
+        /// @return Totals across shards
+        WriteBackResult Checkpoint(const CheckpointOptions &options = CheckpointOptions());
+
+        /// @brief Gets the shards, e.g. to hand to a PageCleaner
+        /// @return Shard pointers, valid for the pool's lifetime
+        std::vector<buffer_pool *> GetShards();
+
+        /// @brief Gets number of shards
+        /// @return Shard count
+        inline size_t GetNumShards()
+        {
+            return shards_.size();
+        }
+
+        /// @brief Gets total number of frames across shards
+        /// @return Pool size
+        inline size_t GetPoolSize()
+        {
+            return pool_size_;
+        }
+
+    private:
+        /// @brief Independent buffer pools. Never resized after construction
+        std::vector<std::unique_ptr<buffer_pool>> shards_;
+
+        /// @brief Total frames across shards
+        size_t pool_size_;
+
+        /// @brief Disk manager used to allocate page IDs before picking a shard
+        DiskManager *disk_manager_;
+
+        /// @brief Picks the shard that owns page_id
+        /// @param page_id Page to locate
+        /// @return Owning shard
+        inline buffer_pool *ShardOf(page_id_t page_id)
+        {
+            // Fibonacci hashing spreads neighbouring IDs, the high bits are the best mixed
+            uint64_t hash = static_cast<uint64_t>(page_id) * 0x9E3779B97F4A7C15ull;
+            return shards_[(hash >> 32) % shards_.size()].get();
+        }
+    };
+}
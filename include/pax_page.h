@@ -0,0 +1,209 @@
+#include <cstdint>       // uint8_t, uint32_t, uint64_t, int64_t
+#include <cstring>       // memcpy
+#include <vector>        // std::vector
+#include "common.h"
+#include "page.h"
+#include "scan_kernels.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Fixed-width column types of a PAX page
+    enum class PaxType : uint8_t
+    {
+        INT32,
+        INT64,
+        DOUBLE
+    };
+
+    /// @brief Column value or constant: i for INT32 and INT64 columns, d for DOUBLE ones
+    struct PaxValue
+    {
+        int64_t i = 0;
+        double d = 0;
+    };
+
+    /// @brief Per-page summary of a column. min and max cover the non-null values, NaN excluded;
+    /// with none they are the type's max and lowest
+    struct PaxZoneMap
+    {
+        PaxValue min;
+        PaxValue max;
+        uint32_t rows = 0;
+        uint32_t nulls = 0;
+        bool has_nan = false;
+
+        /// @brief Checks if any row of the page can satisfy value <op> operand. Null values never do
+        /// @param type Column type
+        /// @param op Comparison
+        /// @param operand Constant to compare with
+        /// @return False if the page can be skipped
+        bool MayMatch(PaxType type, CompareOp op, PaxValue operand) const;
+    };
+
+    /// @brief Runs ScanKernels::Filter over a column of any PAX type
+    /// @param type Column type; an INT32 column compares with operand.i narrowed to int32_t
+    /// @param values Column values
+    /// @param count Number of values
+    /// @param op Comparison
+    /// @param operand Constant to compare with
+    /// @param selection Receives (count + 63) / 64 words, nulls not yet masked out
+    /// @return Number of values that pass
+    uint64_t FilterPaxColumn(PaxType type, const char *values, size_t count, CompareOp op, PaxValue operand,
+                             uint64_t *selection);
+
+    /// @brief PAX layout over a page's data: the rows of the page split into one minipage per
+    /// column, so a scan of one column reads contiguous values. After the page header come the
+    /// row count, capacity and column count, then a descriptor per column with its type, null
+    /// count, minipage offsets and zone map. Each column has a value minipage and a validity
+    /// bitmap (bit set = not null), both 64-byte aligned; a null value is stored as 0. Rows are
+    /// only appended. A view only: the caller pins the page and marks it dirty
+    /// @tparam PageSize Bytes per page
+    template <int32_t PageSize>
+    class BasicPaxPage
+    {
+    public:
+        /// @brief Views page data as a PAX page
+        /// @param data PageSize bytes of a pinned frame
+        explicit BasicPaxPage(char *data) : data_(data) {}
+
+        /// @brief Formats an empty page for a schema, keeping the page LSN
+        /// @param schema Column types, Capacity(schema) > 0
+        void Init(const std::vector<PaxType> &schema);
+
+        /// @brief Appends a row
+        /// @param record Column values packed in schema order, ValueSize bytes each
+        /// @param null_mask Bit c set if column c is null; its bytes in record are ignored
+        /// @return False if the page is full
+        bool Append(const char *record, uint64_t null_mask);
+
+        /// @brief Gets the number of rows
+        /// @return Rows
+        inline uint32_t GetRowCount()
+        {
+            return Read<uint32_t>(ROW_COUNT_OFFSET);
+        }
+
+        /// @brief Gets the number of rows the page holds
+        /// @return Rows
+        inline uint32_t GetCapacity()
+        {
+            return Read<uint32_t>(CAPACITY_OFFSET);
+        }
+
+        /// @brief Gets the number of columns
+        /// @return Columns
+        inline uint32_t GetColumnCount()
+        {
+            return Read<uint32_t>(COLUMN_COUNT_OFFSET);
+        }
+
+        /// @brief Gets a column's type
+        /// @param column Column index
+        /// @return Type
+        inline PaxType GetType(uint32_t column)
+        {
+            return static_cast<PaxType>(Read<uint8_t>(Descriptor(column) + TYPE_OFFSET));
+        }
+
+        /// @brief Gets a column's values, GetRowCount of them, valid while the page is pinned
+        /// @tparam T int32_t, int64_t or double, matching the column type
+        /// @param column Column index
+        /// @return 64-byte aligned values
+        template <typename T>
+        inline const T *GetColumn(uint32_t column)
+        {
+            return reinterpret_cast<const T *>(data_ + Read<uint32_t>(Descriptor(column) + VALUES_OFFSET));
+        }
+
+        /// @brief Gets a column's validity bitmap in the selection format of ScanKernels
+        /// @param column Column index
+        /// @return (GetRowCount() + 63) / 64 words, bits past the row count clear
+        inline const uint64_t *GetValidity(uint32_t column)
+        {
+            return reinterpret_cast<const uint64_t *>(data_ + Read<uint32_t>(Descriptor(column) + VALIDITY_OFFSET));
+        }
+
+        /// @brief Gets a column's zone map
+        /// @param column Column index
+        /// @return Row count, nulls and value range of the column on this page
+        PaxZoneMap GetZoneMap(uint32_t column);
+
+        /// @brief Gets the bytes a column value takes in a record and a minipage
+        /// @param type Column type
+        /// @return 4 or 8
+        static inline uint32_t ValueSize(PaxType type)
+        {
+            return type == PaxType::INT32 ? 4 : 8;
+        }
+
+        /// @brief Gets the bytes of a packed record
+        /// @param schema Column types
+        /// @return Sum of the value sizes
+        static uint32_t RecordSize(const std::vector<PaxType> &schema);
+
+        /// @brief Gets the rows a page of this size holds
+        /// @param schema Column types
+        /// @return Rows, 0 if the schema has no columns, more than MAX_COLUMNS or is too wide
+        static uint32_t Capacity(const std::vector<PaxType> &schema);
+
+        /// @brief Most columns a page holds
+        static constexpr uint32_t MAX_COLUMNS = 16;
+
+        /// @brief Bytes per column descriptor
+        static constexpr uint32_t DESCRIPTOR_SIZE = 32;
+
+        /// @brief First byte after the PAX page header, where the descriptors start
+        static constexpr uint32_t HEADER_SIZE = BasicPage<PageSize>::HEADER_SIZE + 16;
+
+    private:
+        static constexpr uint32_t ROW_COUNT_OFFSET = BasicPage<PageSize>::HEADER_SIZE;
+        static constexpr uint32_t CAPACITY_OFFSET = ROW_COUNT_OFFSET + sizeof(uint32_t);
+        static constexpr uint32_t COLUMN_COUNT_OFFSET = CAPACITY_OFFSET + sizeof(uint32_t);
+        static_assert(COLUMN_COUNT_OFFSET + 2 * sizeof(uint32_t) == HEADER_SIZE, "PAX page header layout changed");
+
+        // Within a descriptor
+        static constexpr uint32_t TYPE_OFFSET = 0;
+        static constexpr uint32_t FLAGS_OFFSET = 1;
+        static constexpr uint32_t NULLS_OFFSET = 4;
+        static constexpr uint32_t VALUES_OFFSET = 8;
+        static constexpr uint32_t VALIDITY_OFFSET = 12;
+        static constexpr uint32_t MIN_OFFSET = 16;
+        static constexpr uint32_t MAX_OFFSET = 24;
+        static_assert(MAX_OFFSET + 8 == DESCRIPTOR_SIZE, "PAX column descriptor layout changed");
+
+        /// @brief Descriptor flag: a NaN was appended
+        static constexpr uint8_t FLAG_HAS_NAN = 1;
+
+        char *data_;
+
+        template <typename T>
+        inline T Read(uint32_t offset)
+        {
+            T value;
+            memcpy(&value, data_ + offset, sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        inline void Write(uint32_t offset, T value)
+        {
+            memcpy(data_ + offset, &value, sizeof(T));
+        }
+
+        /// @brief Gets the offset of a column descriptor
+        static inline uint32_t Descriptor(uint32_t column)
+        {
+            return HEADER_SIZE + column * DESCRIPTOR_SIZE;
+        }
+
+        /// @brief Lays out the minipages for a row capacity
+        /// @param offsets Receives value and validity offsets per column if not nullptr
+        /// @return Bytes used up to the end of the last minipage
+        static uint64_t Layout(const std::vector<PaxType> &schema, uint32_t capacity, uint32_t *offsets);
+    };
+
+    /// @brief PAX page of the default PAGE_SIZE
+    using PaxPage = BasicPaxPage<PAGE_SIZE>;
+}
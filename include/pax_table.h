@@ -0,0 +1,159 @@
+#include <cstdint>       // uint32_t, uint64_t
+#include <vector>        // std::vector
+#include "common.h"
+#include "page.h"
+#include "buffer_pool.h"
+#include "buffer_access_strategy.h"
+#include "pax_page.h"
+#include "scan_kernels.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Predicate column <op> operand of a scan. INT32 operands must fit in an int32_t
+    struct PaxPredicate
+    {
+        uint32_t column;
+        CompareOp op;
+        PaxValue operand;
+    };
+
+    /// @brief Result of an aggregate scan: COUNT, SUM, MIN and MAX of the non-null values of a
+    /// column in the rows that pass every predicate. sum wraps like int64_t for integer columns
+    /// and is sum.d for doubles; min and max are meaningless while count is 0
+    struct PaxAggregate
+    {
+        uint64_t count = 0;
+        PaxValue sum;
+        PaxValue min;
+        PaxValue max;
+        /// @brief Pages fetched and scanned
+        uint64_t pages_scanned = 0;
+        /// @brief Pages a zone map ruled out, never fetched
+        uint64_t pages_skipped = 0;
+    };
+
+    /// @brief Append-only table of fixed-width records stored as PAX pages in a buffer pool. A
+    /// header page holds the schema and the head of a chain of directory pages, which list every
+    /// data page with its row count and per-column zone maps. The directory is also kept in
+    /// memory, so a scan rules out pages from their zone maps without fetching them. A directory
+    /// entry is written when its page is created and again when it fills; the entry of the last
+    /// page is refreshed from the page itself on open. Not synchronized: callers keep writers
+    /// and scans of one table apart
+    /// @tparam PageSize Bytes per page, matching the pool
+    template <int32_t PageSize>
+    class BasicPaxTable
+    {
+    public:
+        /// @brief Creates an empty table
+        /// @param pool Pool to keep the pages in
+        /// @param schema Column types
+        /// @throws std::invalid_argument if a page cannot hold a row of the schema
+        BasicPaxTable(basic_buffer_pool<PageSize> *pool, const std::vector<PaxType> &schema);
+
+        /// @brief Opens an existing table
+        /// @param pool Pool over the table's database
+        /// @param header_page_id GetHeaderPageId of the table when it was created
+        /// @throws std::runtime_error if the page is not a PAX table header
+        BasicPaxTable(basic_buffer_pool<PageSize> *pool, page_id_t header_page_id);
+
+        /// @brief Gets the page that identifies the table
+        /// @return Header page ID
+        inline page_id_t GetHeaderPageId()
+        {
+            return header_page_id_;
+        }
+
+        /// @brief Gets the column types
+        /// @return Schema
+        inline const std::vector<PaxType> &GetSchema()
+        {
+            return schema_;
+        }
+
+        /// @brief Gets the number of rows
+        /// @return Rows
+        inline uint64_t GetRowCount()
+        {
+            return row_count_;
+        }
+
+        /// @brief Gets the number of data pages
+        /// @return Pages
+        inline uint64_t GetPageCount()
+        {
+            return entries_.size();
+        }
+
+        /// @brief Gets a data page, e.g. to split a scan into page ranges
+        /// @param index Page index in append order, below GetPageCount
+        /// @return Page ID
+        inline page_id_t GetPageId(size_t index)
+        {
+            return entries_[index].page_id;
+        }
+
+        /// @brief Appends a row to the last page or a new one
+        /// @param record Column values packed in schema order, see BasicPaxPage::Append
+        /// @param null_mask Bit c set if column c is null
+        void Append(const char *record, uint64_t null_mask = 0);
+
+        /// @brief Aggregates a column over the rows that pass every predicate. Pages whose zone
+        /// maps rule out a predicate, or hold only nulls in the column, are skipped unread; the
+        /// rest run through ScanKernels
+        /// @param predicates Conjunction of predicates, empty for every row
+        /// @param column Column to aggregate
+        /// @param strategy Optional ring (e.g. BULK_READ) so a large scan does not flush the pool
+        /// @return Aggregate and page counts
+        /// @throws std::invalid_argument for an unknown column or an INT32 operand out of range
+        PaxAggregate Aggregate(const std::vector<PaxPredicate> &predicates, uint32_t column,
+                               BufferAccessStrategy *strategy = nullptr);
+
+    private:
+        struct Entry
+        {
+            page_id_t page_id;
+            uint32_t rows;
+            std::vector<PaxZoneMap> zones;
+        };
+
+        basic_buffer_pool<PageSize> *pool_;
+        page_id_t header_page_id_;
+        std::vector<PaxType> schema_;
+        uint32_t capacity_;
+        uint64_t row_count_ = 0;
+        std::vector<Entry> entries_;
+        std::vector<page_id_t> directory_pages_;
+
+        /// @brief Bytes of a directory entry for the schema
+        inline uint32_t EntrySize()
+        {
+            return ENTRY_HEADER_SIZE + static_cast<uint32_t>(schema_.size()) * ZONE_SIZE;
+        }
+
+        /// @brief Directory entries per directory page
+        inline uint32_t EntriesPerPage()
+        {
+            return (PageSize - DIRECTORY_HEADER_SIZE) / EntrySize();
+        }
+
+        /// @brief Writes entries_[index] to its directory page, chaining a new one if needed
+        void WriteEntry(size_t index);
+
+        /// @brief Reads the directory chain into entries_
+        void ReadDirectory(page_id_t first_directory_page_id);
+
+        /// @brief Aggregate for a column holding T
+        template <typename T>
+        PaxAggregate AggregateAs(const std::vector<PaxPredicate> &predicates, uint32_t column,
+                                 BufferAccessStrategy *strategy);
+
+        static constexpr uint32_t DIRECTORY_HEADER_SIZE = BasicPage<PageSize>::HEADER_SIZE + 16;
+        static constexpr uint32_t ENTRY_HEADER_SIZE = 16;
+        static constexpr uint32_t ZONE_SIZE = 24;
+    };
+
+    /// @brief PAX table of the default PAGE_SIZE
+    using PaxTable = BasicPaxTable<PAGE_SIZE>;
+}
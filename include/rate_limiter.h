@@ -0,0 +1,40 @@
+#include <chrono>        // std::chrono
+#include <cstdint>       // uint64_t
+#include <mutex>         // std::mutex
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Token bucket on bytes. Callers that overdraw the bucket sleep until it refills, so
+    /// background writers stay under a bandwidth budget and leave the device to foreground I/O
+    class RateLimiter
+    {
+    public:
+        /// @brief Creates limiter with a one second burst
+        /// @param bytes_per_sec Budget, 0 disables limiting
+        explicit RateLimiter(uint64_t bytes_per_sec);
+
+        /// @brief Takes bytes from the bucket, sleeping if the budget is exceeded
+        /// @param bytes Bytes about to be (or just) written
+        void Acquire(uint64_t bytes);
+
+        /// @brief Gets configured budget
+        /// @return Bytes per second, 0 if unlimited
+        inline uint64_t GetRate()
+        {
+            return bytes_per_sec_;
+        }
+
+    private:
+        uint64_t bytes_per_sec_;
+
+        /// @brief Guards available_ and last_refill_
+        std::mutex latch_;
+
+        /// @brief Tokens left, negative while callers are paying off debt
+        double available_;
+
+        std::chrono::steady_clock::time_point last_refill_;
+    };
+}
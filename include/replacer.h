@@ -0,0 +1,67 @@
+#include <cstdint>       // int32_t
+#include <memory>        // std::unique_ptr
+#include <vector>        // std::vector
+#include "common.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Page replacement policies a buffer_pool can be built with
+    enum class ReplacerPolicy
+    {
+        LRU,   ///< Least recently used (unpinned) frame
+        CLOCK, ///< Second chance, one reference bit per frame
+        LRU_K, ///< Largest backward K-distance (K=2 by default), scan resistant
+        ARC    ///< Adaptive replacement cache, balances recency and frequency
+    };
+
+    /// @brief Chooses which frame to evict. Not internally synchronized, the owning buffer_pool
+    /// calls it with its latch held. A frame is tracked from RecordAccess until Evict or Remove,
+    /// and only evictable (unpinned) tracked frames can be chosen as victims
+    class Replacer
+    {
+    public:
+        virtual ~Replacer() = default;
+
+        /// @brief Records that frame was accessed. Starts tracking the frame (not evictable) if new
+        /// @param frame_id Frame that was used
+        /// @param page_id Page held by the frame
+        virtual void RecordAccess(frame_id_t frame_id, page_id_t page_id) = 0;
+
+        /// @brief Marks a tracked frame as evictable (pin count 0) or not
+        /// @param frame_id Frame to update
+        /// @param evictable If frame may be evicted
+        virtual void SetEvictable(frame_id_t frame_id, bool evictable) = 0;
+
+        /// @brief Chooses a victim among evictable frames and stops tracking it
+        /// @param frame_id_ptr Victim frame
+        /// @return True if found, false if all pinned
+        virtual bool Evict(frame_id_t *frame_id_ptr) = 0;
+
+        /// @brief Stops tracking a frame without treating it as an eviction
+        /// @param frame_id Frame to forget
+        virtual void Remove(frame_id_t frame_id) = 0;
+
+        /// @brief Lists the next evictable frames in the order Evict would pick them, without
+        /// changing any replacement state. Used to clean frames before they are evicted
+        /// @param count Maximum frames to list
+        /// @param candidates Appended with frames
+        virtual void GetCandidates(size_t count, std::vector<frame_id_t> *candidates) = 0;
+
+        /// @brief Gets number of evictable frames
+        /// @return Evictable frame count
+        virtual size_t Size() = 0;
+    };
+
+    /// @brief Creates a replacer for a pool
+    /// @param policy Replacement policy
+    /// @param num_frames Number of frames in the pool
+    /// @return New replacer
+    std::unique_ptr<Replacer> MakeReplacer(ReplacerPolicy policy, size_t num_frames);
+
+    /// @brief Gets display name of a policy
+    /// @param policy Replacement policy
+    /// @return Policy name
+    const char *ReplacerPolicyName(ReplacerPolicy policy);
+}
@@ -0,0 +1,107 @@
+#include <cstddef>       // size_t
+#include <cstdint>       // int32_t, int64_t, uint64_t
+#include <limits>        // std::numeric_limits
+#include <type_traits>   // std::conditional, std::is_floating_point
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Comparison of a column value against a constant. LE, GE and NE are the negations
+    /// of GT, LT and EQ, so a NaN passes them
+    enum class CompareOp
+    {
+        EQ,
+        NE,
+        LT,
+        LE,
+        GT,
+        GE
+    };
+
+    /// @brief Instruction set the scan kernels run on
+    enum class SimdLevel
+    {
+        SCALAR,
+        SSE42,
+        AVX2
+    };
+
+    /// @brief Count, sum and extremes of the selected values of a column. Integers sum into a
+    /// wrapping int64_t, doubles into a double
+    /// @tparam T int32_t, int64_t or double
+    template <typename T>
+    struct ColumnAggregate
+    {
+        using SumType = typename std::conditional<std::is_floating_point<T>::value, double, int64_t>::type;
+
+        uint64_t count = 0;
+        SumType sum = 0;
+        /// @brief Meaningless while count is 0
+        T min = std::numeric_limits<T>::max();
+        T max = std::numeric_limits<T>::lowest();
+
+        /// @brief Adds another partial aggregate, e.g. of another page
+        inline void Merge(const ColumnAggregate &other)
+        {
+            count += other.count;
+            if constexpr (std::is_floating_point<T>::value)
+            {
+                sum += other.sum;
+            }
+            else
+            {
+                sum = static_cast<int64_t>(static_cast<uint64_t>(sum) + static_cast<uint64_t>(other.sum));
+            }
+            min = other.min < min ? other.min : min;
+            max = other.max > max ? other.max : max;
+        }
+    };
+
+    /// @brief Column kernels for scans: predicates that produce selection bitmaps, and
+    /// aggregates over the selected values. A selection has one bit per value, value i at bit
+    /// i % 64 of word i / 64, and bits past the count are always clear. Each kernel has AVX2 and
+    /// SSE4.2 versions chosen at run time by what the CPU supports, and a scalar fallback that
+    /// also handles the last partial word. Compiled for int32_t, int64_t and double
+    class ScanKernels
+    {
+    public:
+        /// @brief Evaluates value <op> operand over a column
+        /// @param values Column values
+        /// @param count Number of values
+        /// @param op Comparison
+        /// @param operand Constant to compare with
+        /// @param selection Receives (count + 63) / 64 words
+        /// @return Number of values that pass
+        template <typename T>
+        static uint64_t Filter(const T *values, size_t count, CompareOp op, T operand, uint64_t *selection);
+
+        /// @brief Aggregates the selected values of a column into result
+        /// @param values Column values
+        /// @param count Number of values
+        /// @param selection Values to include, nullptr for all
+        /// @param result Partial aggregate to add to
+        template <typename T>
+        static void Aggregate(const T *values, size_t count, const uint64_t *selection, ColumnAggregate<T> *result);
+
+        /// @brief Intersects two selections in place
+        /// @param selection Selection to narrow
+        /// @param other Selection or validity bitmap to intersect with
+        /// @param count Number of values
+        /// @return Number of values left selected
+        static uint64_t And(uint64_t *selection, const uint64_t *other, size_t count);
+
+        /// @brief Gets the instruction set the kernels use
+        /// @return The best the CPU supports, unless lowered by SetSimdLevel
+        static SimdLevel GetSimdLevel();
+
+        /// @brief Caps the instruction set, for benchmarks and tests. Levels the CPU lacks are
+        /// lowered to the best it has
+        /// @param level Highest level to use
+        static void SetSimdLevel(SimdLevel level);
+
+        /// @brief Detects what the CPU supports
+        /// @return Best level available
+        static SimdLevel DetectSimdLevel();
+    };
+}
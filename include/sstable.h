@@ -0,0 +1,268 @@
+#include <atomic>        // std::atomic
+#include <cstdint>       // int32_t, uint16_t, uint64_t
+#include <memory>        // std::shared_ptr
+#include <string>        // std::string
+#include <string_view>   // std::string_view
+#include <vector>        // std::vector
+#include "common.h"
+#include "disk_manager.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Immutable sorted table of an LSM tree, stored in pages of a disk manager. Each data
+    /// page is a block: an entry count, a u16 offset per entry, then the entries, each a u16 key
+    /// size, a u16 value size whose top bit marks a tombstone, the key and the value. A blob of
+    /// the smallest key, a Bloom filter over all keys and a block index (last key and page ID of
+    /// every block) follows in pages of its own, and a meta page lists the blob pages; the meta
+    /// page ID names the table. Opening loads the blob, so a point lookup reads at most one block,
+    /// none when the filter rules the key out. Blocks are read straight from the disk manager,
+    /// without a cache. Tables are shared through shared_ptr; one marked obsolete frees its pages
+    /// when the last reference goes
+    /// @tparam PageSize Bytes per page, matching the disk manager
+    template <int32_t PageSize>
+    class BasicSSTable
+    {
+    public:
+        /// @brief Writes a table from keys in increasing order. Full blocks are batched into
+        /// vectored writes of consecutive pages
+        class Builder
+        {
+        public:
+            /// @param disk_manager Where to allocate and write pages
+            /// @param bits_per_key Bloom filter size per key
+            Builder(BasicDiskManager<PageSize> *disk_manager, int bits_per_key);
+
+            Builder(const Builder &) = delete;
+            Builder &operator=(const Builder &) = delete;
+
+            /// @brief Frees the pages of an unfinished table
+            ~Builder();
+
+            /// @brief Appends an entry
+            /// @param key Key, greater than every key added before
+            /// @param value Value, ignored for a tombstone
+            /// @param deleted Write a tombstone
+            /// @throws std::runtime_error if the entry does not fit in a block
+            void Add(std::string_view key, std::string_view value, bool deleted);
+
+            /// @brief Gets the bytes the table occupies so far, counting the open block as full
+            /// @return Bytes
+            inline uint64_t GetFileBytes() const
+            {
+                return (static_cast<uint64_t>(index_.size()) + 1) * PageSize;
+            }
+
+            /// @brief Gets the number of entries added
+            inline uint64_t GetCount() const
+            {
+                return hashes_.size();
+            }
+
+            /// @brief Writes the last block, the blob and the meta page
+            /// @return The table, nullptr if nothing was added
+            std::shared_ptr<BasicSSTable> Finish();
+
+        private:
+            BasicDiskManager<PageSize> *disk_manager_;
+            int bits_per_key_;
+            std::vector<uint64_t> hashes_;
+            std::string smallest_;
+            std::string last_key_;
+
+            /// @brief Block being filled and its entry offsets
+            std::vector<char> block_;
+            std::vector<uint16_t> offsets_;
+
+            /// @brief Last key and page ID of each written block
+            std::vector<std::pair<std::string, page_id_t>> index_;
+
+            /// @brief Pages allocated, in order, for cleanup if never finished
+            std::vector<page_id_t> pages_;
+
+            /// @brief Consecutive pages waiting to be written together
+            char *batch_;
+            page_id_t batch_first_ = INVALID_PAGE_ID;
+            size_t batch_count_ = 0;
+
+            /// @brief Completes the open block into the next page
+            void FinishBlock();
+
+            /// @brief Allocates the next page and gets its buffer in the batch
+            char *NextPage(page_id_t *page_id);
+
+            /// @brief Writes the batch
+            void FlushBatch();
+        };
+
+        /// @brief Forward iterator in key order, one block in memory at a time. The table must
+        /// outlive it
+        class Iterator
+        {
+        public:
+            /// @brief Starts unpositioned; call SeekToFirst or Seek
+            /// @param table Table to iterate
+            explicit Iterator(const BasicSSTable *table);
+
+            Iterator(const Iterator &) = delete;
+            Iterator &operator=(const Iterator &) = delete;
+
+            ~Iterator();
+
+            /// @brief Checks for a current entry
+            /// @return False past the last key
+            inline bool Valid() const
+            {
+                return block_index_ < table_->index_.size();
+            }
+
+            /// @brief Moves to the smallest key
+            void SeekToFirst();
+
+            /// @brief Moves to the first key not less than key
+            /// @param key Lower bound
+            void Seek(std::string_view key);
+
+            /// @brief Moves to the next key
+            void Next();
+
+            /// @brief Gets the current key, valid until the iterator moves
+            inline std::string_view GetKey() const
+            {
+                return key_;
+            }
+
+            /// @brief Gets the current value, empty for a tombstone
+            inline std::string_view GetValue() const
+            {
+                return value_;
+            }
+
+            /// @brief Checks if the current entry is a tombstone
+            inline bool IsDeleted() const
+            {
+                return deleted_;
+            }
+
+        private:
+            /// @brief Reads a block and positions on one of its entries, moving on to the next
+            /// block if past its end
+            void LoadBlock(size_t block_index, uint16_t entry);
+
+            /// @brief Decodes the current entry
+            void Decode();
+
+            const BasicSSTable *table_;
+            char *block_;
+            size_t block_index_;
+            uint16_t entry_ = 0;
+            uint16_t count_ = 0;
+            std::string_view key_;
+            std::string_view value_;
+            bool deleted_ = false;
+        };
+
+        /// @brief Loads a table's meta page and blob
+        /// @param disk_manager Disk manager the table was written to
+        /// @param meta_page_id Table's GetMetaPageId
+        /// @return Table
+        /// @throws std::runtime_error if the page is not a table's meta page
+        static std::shared_ptr<BasicSSTable> Open(BasicDiskManager<PageSize> *disk_manager, page_id_t meta_page_id);
+
+        BasicSSTable(const BasicSSTable &) = delete;
+        BasicSSTable &operator=(const BasicSSTable &) = delete;
+
+        /// @brief Frees the table's pages if it was marked obsolete
+        ~BasicSSTable();
+
+        /// @brief Point lookup
+        /// @param key Key to find
+        /// @param value Receives the value if it is live
+        /// @param deleted Set if the key's entry is a tombstone
+        /// @return False if the table holds no entry for the key
+        bool Get(std::string_view key, std::string *value, bool *deleted) const;
+
+        /// @brief Checks if any key of [smallest, largest] may be in the table
+        /// @return False if the ranges are disjoint
+        inline bool Overlaps(std::string_view smallest, std::string_view largest) const
+        {
+            return !(std::string_view(largest_) < smallest || largest < std::string_view(smallest_));
+        }
+
+        /// @brief Has the pages freed once the last reference is dropped
+        inline void MarkObsolete()
+        {
+            obsolete_.store(true, std::memory_order_release);
+        }
+
+        /// @brief Gets the page that names the table
+        inline page_id_t GetMetaPageId() const
+        {
+            return meta_page_id_;
+        }
+
+        inline const std::string &GetSmallest() const
+        {
+            return smallest_;
+        }
+
+        inline const std::string &GetLargest() const
+        {
+            return largest_;
+        }
+
+        /// @brief Gets bytes of every page of the table, blob and meta page included
+        inline uint64_t GetFileBytes() const
+        {
+            return static_cast<uint64_t>(index_.size() + blob_pages_.size() + 1) * PageSize;
+        }
+
+        /// @brief Gets the number of entries, tombstones included
+        inline uint64_t GetCount() const
+        {
+            return count_;
+        }
+
+        /// @brief Largest key plus value an entry may have: a block always fits one, and sizes fit
+        /// in 15 bits
+        static constexpr size_t MAX_ENTRY_BYTES = PageSize - 8 < 32767 ? PageSize - 8 : 32767;
+
+    private:
+        BasicSSTable(BasicDiskManager<PageSize> *disk_manager, page_id_t meta_page_id);
+
+        static constexpr uint16_t DELETED_FLAG = 0x8000;
+
+        BasicDiskManager<PageSize> *disk_manager_;
+        page_id_t meta_page_id_;
+        std::vector<page_id_t> blob_pages_;
+        uint64_t count_ = 0;
+        std::string smallest_;
+        std::string largest_;
+        std::string bloom_;
+        /// @brief Last key and page ID of each block
+        std::vector<std::pair<std::string, page_id_t>> index_;
+        std::atomic<bool> obsolete_{false};
+
+        /// @brief Serializes smallest_, bloom_ and index_
+        std::string EncodeBlob() const;
+
+        /// @brief Parses the blob written by EncodeBlob
+        void DecodeBlob(const std::string &blob);
+
+        /// @brief Finds the block that may hold a key
+        /// @return Position in index_, index_.size() if the key is past the largest
+        size_t FindBlock(std::string_view key) const;
+
+        /// @brief Binary search inside a block
+        /// @return First entry whose key is not less than key, the count if none
+        static uint16_t SeekInBlock(const char *block, std::string_view key);
+
+        /// @brief Decodes one entry of a block
+        static void DecodeEntry(const char *block, uint16_t entry, std::string_view *key, std::string_view *value,
+                                bool *deleted);
+    };
+
+    /// @brief Sorted table of the default PAGE_SIZE
+    using SSTable = BasicSSTable<PAGE_SIZE>;
+}
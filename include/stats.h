@@ -0,0 +1,178 @@
+#include <atomic>        // std::atomic
+#include <chrono>        // std::chrono::steady_clock
+#include <cstddef>       // size_t
+#include <cstdint>       // uint64_t
+#include <vector>        // std::vector
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Size of the cache lines counters are padded to
+    constexpr size_t CACHE_LINE_SIZE = 64;
+
+    /// @brief Gets a small per-thread number, assigned on first use, for striping counters
+    /// @return Stable index of the calling thread
+    inline size_t ThreadStripe()
+    {
+        static std::atomic<size_t> next_stripe{0};
+        thread_local size_t stripe = next_stripe.fetch_add(1, std::memory_order_relaxed);
+        return stripe;
+    }
+
+    /// @brief Monotonic event counter split into cache-line-sized stripes. A thread adds to the
+    /// stripe of its ThreadStripe with a relaxed add, so threads on different cores do not bounce
+    /// one line between them; Load sums the stripes. Threads beyond STRIPES share stripes, which
+    /// costs contention but never loses counts
+    class StripedCounter
+    {
+    public:
+        static constexpr size_t STRIPES = 16;
+
+        inline void Add(uint64_t count = 1)
+        {
+            stripes_[ThreadStripe() % STRIPES].value.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        /// @brief Sums the stripes. Concurrent adds may or may not be seen
+        /// @return Count
+        uint64_t Load() const;
+
+    private:
+        struct alignas(CACHE_LINE_SIZE) Stripe
+        {
+            std::atomic<uint64_t> value{0};
+        };
+
+        Stripe stripes_[STRIPES];
+    };
+
+    /// @brief Log-linear latency histogram in the style of HdrHistogram: values below 16 get a
+    /// bucket each, above that every power of two is split into 16 buckets, so any recorded value
+    /// is reported within 1/16 (6.25%) of itself. Plain counts, not synchronized; used for
+    /// snapshots and single-threaded recording
+    class LatencyHistogram
+    {
+    public:
+        LatencyHistogram() : counts_(BUCKETS, 0) {}
+
+        /// @brief Records one sample
+        /// @param nanos Latency
+        inline void Record(uint64_t nanos)
+        {
+            counts_[BucketOf(nanos)]++;
+            total_++;
+            sum_ += nanos;
+        }
+
+        /// @brief Adds another histogram's samples
+        /// @param other Histogram to add
+        void Merge(const LatencyHistogram &other);
+
+        /// @brief Gets a percentile
+        /// @param fraction In [0, 1], e.g. 0.999
+        /// @return Upper bound of the bucket holding it, in nanoseconds; 0 without samples
+        uint64_t Percentile(double fraction) const;
+
+        /// @brief Gets the largest sample, rounded up to its bucket
+        /// @return Nanoseconds, 0 without samples
+        uint64_t Max() const;
+
+        /// @brief Gets the exact mean
+        /// @return Nanoseconds, 0 without samples
+        inline double Mean() const
+        {
+            return total_ == 0 ? 0.0 : static_cast<double>(sum_) / total_;
+        }
+
+        inline uint64_t Count() const
+        {
+            return total_;
+        }
+
+        /// @brief Number of buckets, covering every uint64_t value
+        static constexpr size_t BUCKETS = 61 * 16;
+
+        static inline size_t BucketOf(uint64_t nanos)
+        {
+            if (nanos < SUB_BUCKETS)
+            {
+                return static_cast<size_t>(nanos);
+            }
+            int exponent = 63 - __builtin_clzll(nanos);
+            uint64_t sub = (nanos >> (exponent - 4)) & (SUB_BUCKETS - 1);
+            return static_cast<size_t>((exponent - 3) * SUB_BUCKETS + sub);
+        }
+
+        /// @brief Largest value that falls in a bucket
+        static uint64_t UpperBound(size_t bucket);
+
+    private:
+        friend class ConcurrentLatencyHistogram;
+
+        static constexpr uint64_t SUB_BUCKETS = 16;
+
+        std::vector<uint64_t> counts_;
+        uint64_t total_ = 0;
+        uint64_t sum_ = 0;
+    };
+
+    /// @brief LatencyHistogram that many threads record into: one relaxed add on the sample's
+    /// bucket and one on a striped sum. Meant for paths that already take microseconds (disk
+    /// I/O, buffer misses), where two threads rarely land in the same bucket at once
+    class ConcurrentLatencyHistogram
+    {
+    public:
+        ConcurrentLatencyHistogram() : counts_(new std::atomic<uint64_t>[LatencyHistogram::BUCKETS]())
+        {
+        }
+
+        ~ConcurrentLatencyHistogram()
+        {
+            delete[] counts_;
+        }
+
+        ConcurrentLatencyHistogram(const ConcurrentLatencyHistogram &) = delete;
+        ConcurrentLatencyHistogram &operator=(const ConcurrentLatencyHistogram &) = delete;
+
+        /// @brief Records one sample
+        /// @param nanos Latency
+        inline void Record(uint64_t nanos)
+        {
+            counts_[LatencyHistogram::BucketOf(nanos)].fetch_add(1, std::memory_order_relaxed);
+            sum_.Add(nanos);
+        }
+
+        /// @brief Copies the counts. Samples recorded meanwhile may be partly included
+        /// @return Snapshot
+        LatencyHistogram Snapshot() const;
+
+    private:
+        std::atomic<uint64_t> *counts_;
+        StripedCounter sum_;
+    };
+
+    /// @brief Measures one operation into a ConcurrentLatencyHistogram when it goes out of scope
+    class ScopedLatency
+    {
+    public:
+        explicit ScopedLatency(ConcurrentLatencyHistogram *histogram)
+            : histogram_(histogram), start_(std::chrono::steady_clock::now())
+        {
+        }
+
+        ~ScopedLatency()
+        {
+            histogram_->Record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                                         std::chrono::steady_clock::now() - start_)
+                                                         .count()));
+        }
+
+        ScopedLatency(const ScopedLatency &) = delete;
+        ScopedLatency &operator=(const ScopedLatency &) = delete;
+
+    private:
+        ConcurrentLatencyHistogram *histogram_;
+        std::chrono::steady_clock::time_point start_;
+    };
+}
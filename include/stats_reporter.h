@@ -0,0 +1,82 @@
+#include <chrono>             // std::chrono::milliseconds
+#include <condition_variable> // std::condition_variable
+#include <mutex>              // std::mutex
+#include <ostream>            // std::ostream
+#include <string>             // std::string
+#include <thread>             // std::thread
+#include "common.h"
+#include "stats.h"
+#include "buffer_pool.h"
+#include "disk_manager.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief How StatsReporter renders a snapshot
+    enum class StatsFormat
+    {
+        /// @brief One human-readable line per snapshot
+        TEXT,
+        /// @brief One JSON object per line (JSON Lines)
+        JSON
+    };
+
+    /// @brief What StatsReporter dumps and how often
+    struct ReporterOptions
+    {
+        /// @brief Time between dumps
+        std::chrono::milliseconds interval{1000};
+
+        StatsFormat format = StatsFormat::TEXT;
+    };
+
+    /// @brief Renders one pool and disk snapshot on a single line, without a trailing newline.
+    /// Latencies are in nanoseconds: p50, p99, p999 and max of each histogram
+    /// @param pool Buffer pool counters
+    /// @param disk Disk manager counters, nullptr to leave them out
+    /// @param format Text or JSON
+    /// @return Rendered snapshot
+    std::string FormatStats(const BufferPoolStats &pool, const DiskStats *disk, StatsFormat format);
+
+    /// @brief Background thread that periodically writes GetStats snapshots of a pool and its
+    /// disk manager to a stream, one line each. Starts on construction, stops on destruction
+    class StatsReporter
+    {
+    public:
+        /// @brief Starts reporting
+        /// @param pool Pool to report, must outlive the reporter
+        /// @param disk_manager The pool's disk manager, nullptr to report the pool only
+        /// @param out Stream to write to, must outlive the reporter
+        /// @param options Interval and format
+        StatsReporter(buffer_pool *pool, DiskManager *disk_manager, std::ostream *out,
+                      const ReporterOptions &options = ReporterOptions());
+
+        /// @brief Stops the thread
+        ~StatsReporter();
+
+        StatsReporter(const StatsReporter &) = delete;
+        StatsReporter &operator=(const StatsReporter &) = delete;
+
+        /// @brief Writes one snapshot now
+        void Report();
+
+        /// @brief Stops the thread, idempotent
+        void Stop();
+
+    private:
+        buffer_pool *pool_;
+        DiskManager *disk_manager_;
+        std::ostream *out_;
+        ReporterOptions options_;
+
+        /// @brief Guards stop_ and writes to out_
+        std::mutex latch_;
+        std::condition_variable stop_cv_;
+        bool stop_ = false;
+        std::thread thread_;
+
+        /// @brief Reporter loop
+        void Run();
+    };
+}
@@ -0,0 +1,129 @@
+#include <cstdint>       // uint32_t
+#include <string>        // std::string
+#include "common.h"
+#include "page.h"
+#include "buffer_pool.h"
+#include "buffer_access_strategy.h"
+#include "table_page.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Unordered tuple storage: a chain of table pages in a buffer pool, appended to at
+    /// the last page. Updates stay in their slot when the page has room. Not synchronized:
+    /// callers keep writers and scans of one heap apart
+    /// @tparam PageSize Bytes per page, matching the pool
+    template <int32_t PageSize>
+    class BasicTableHeap
+    {
+    public:
+        /// @brief Forward scan over live tuples in page and slot order. Keeps the current page
+        /// pinned, so tuple views point straight into the frame with no copy. Move-only
+        class Iterator
+        {
+        public:
+            Iterator(Iterator &&other) noexcept;
+            Iterator(const Iterator &) = delete;
+            Iterator &operator=(const Iterator &) = delete;
+            Iterator &operator=(Iterator &&) = delete;
+
+            /// @brief Unpins the current page
+            ~Iterator();
+
+            /// @brief Checks for a current tuple
+            /// @return False past the last tuple
+            inline bool Valid() const
+            {
+                return page_ != nullptr;
+            }
+
+            /// @brief Gets the current tuple's RID
+            /// @return RID
+            inline const RID &GetRID() const
+            {
+                return rid_;
+            }
+
+            /// @brief Gets the current tuple, valid until Next
+            /// @return View into the pinned frame
+            inline TupleView GetTuple() const
+            {
+                return view_;
+            }
+
+            /// @brief Moves to the next live tuple, crossing pages as needed
+            void Next();
+
+        private:
+            friend class BasicTableHeap;
+
+            /// @brief Starts at the first live tuple at or after slot 0 of a page
+            Iterator(basic_buffer_pool<PageSize> *pool, page_id_t first_page_id, BufferAccessStrategy *strategy);
+
+            /// @brief Settles on the first live tuple at or after rid_, or becomes invalid
+            void SeekLive();
+
+            basic_buffer_pool<PageSize> *pool_;
+            BufferAccessStrategy *strategy_;
+            BasicPage<PageSize> *page_ = nullptr;
+            RID rid_;
+            TupleView view_;
+        };
+
+        /// @brief Creates an empty heap with one page
+        /// @param pool Pool to keep the pages in
+        explicit BasicTableHeap(basic_buffer_pool<PageSize> *pool);
+
+        /// @brief Opens an existing heap, walking the chain to find its last page
+        /// @param pool Pool over the heap's database
+        /// @param first_page_id GetFirstPageId of the heap when it was created
+        BasicTableHeap(basic_buffer_pool<PageSize> *pool, page_id_t first_page_id);
+
+        /// @brief Gets the page that identifies the heap
+        /// @return First page ID
+        inline page_id_t GetFirstPageId()
+        {
+            return first_page_id_;
+        }
+
+        /// @brief Appends a tuple, to the last page or a new one linked after it
+        /// @param tuple Tuple bytes
+        /// @param size Number of bytes, at most TablePage::MAX_TUPLE_SIZE
+        /// @return Where the tuple was stored
+        /// @throws std::out_of_range if the tuple is larger than a page holds
+        RID Insert(const char *tuple, uint32_t size);
+
+        /// @brief Copies a tuple out
+        /// @param rid Tuple to read
+        /// @param tuple Receives the bytes
+        /// @return False if there is no tuple at rid
+        bool Get(const RID &rid, std::string *tuple);
+
+        /// @brief Replaces a tuple in its slot
+        /// @param rid Tuple to replace
+        /// @param tuple New bytes
+        /// @param size Number of bytes
+        /// @return False if there is no tuple at rid or its page has no room; the caller can
+        /// Delete and Insert instead, which moves the tuple
+        bool Update(const RID &rid, const char *tuple, uint32_t size);
+
+        /// @brief Removes a tuple
+        /// @param rid Tuple to remove
+        /// @return False if there is no tuple at rid
+        bool Delete(const RID &rid);
+
+        /// @brief Starts a scan
+        /// @param strategy Optional ring (e.g. BULK_READ) so a large scan does not flush the pool
+        /// @return Iterator at the first live tuple
+        Iterator Begin(BufferAccessStrategy *strategy = nullptr);
+
+    private:
+        basic_buffer_pool<PageSize> *pool_;
+        page_id_t first_page_id_;
+        page_id_t last_page_id_;
+    };
+
+    /// @brief Table heap of the default PAGE_SIZE
+    using TableHeap = BasicTableHeap<PAGE_SIZE>;
+}
@@ -0,0 +1,151 @@
+#include <cstdint>       // uint32_t
+#include <cstring>       // memcpy
+#include "common.h"
+#include "page.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Tuple bytes inside a frame, valid while the page stays pinned and unchanged
+    struct TupleView
+    {
+        const char *data = nullptr;
+        uint32_t size = 0;
+    };
+
+    /// @brief Slotted-page layout over a page's data. After the page header come the next page
+    /// of the heap, the slot count, where tuple data starts and the live tuple bytes; then the
+    /// slot directory growing forward, each slot an (offset, size) pair with offset 0 for a free
+    /// slot, while tuple data grows backward from the end of the page. Deleting leaves a hole
+    /// that Compact closes; slots never move, so RIDs stay valid. A view only: the caller pins
+    /// the page and marks it dirty
+    /// @tparam PageSize Bytes per page
+    template <int32_t PageSize>
+    class BasicTablePage
+    {
+    public:
+        /// @brief Views page data as a table page
+        /// @param data PageSize bytes of a pinned frame
+        explicit BasicTablePage(char *data) : data_(data) {}
+
+        /// @brief Formats an empty table page, keeping the page LSN
+        void Init();
+
+        /// @brief Gets the next page of the heap
+        /// @return Page ID, INVALID_PAGE_ID for the last page
+        inline page_id_t GetNextPageId()
+        {
+            return Read<page_id_t>(NEXT_PAGE_OFFSET);
+        }
+
+        /// @brief Links the next page of the heap
+        /// @param page_id Page ID
+        inline void SetNextPageId(page_id_t page_id)
+        {
+            Write<page_id_t>(NEXT_PAGE_OFFSET, page_id);
+        }
+
+        /// @brief Gets the number of slots, free ones included
+        /// @return Slot count
+        inline uint32_t GetSlotCount()
+        {
+            return Read<uint32_t>(SLOT_COUNT_OFFSET);
+        }
+
+        /// @brief Gets bytes available for tuples and their slots once holes are compacted
+        /// @return Free bytes
+        inline uint32_t GetFreeSpace()
+        {
+            return PageSize - HEADER_SIZE - GetSlotCount() * SLOT_SIZE - Read<uint32_t>(TUPLE_BYTES_OFFSET);
+        }
+
+        /// @brief Stores a tuple, reusing a free slot if there is one and compacting if the free
+        /// space is fragmented
+        /// @param tuple Tuple bytes
+        /// @param size Number of bytes
+        /// @param slot_ptr Slot of the tuple
+        /// @return False if the tuple does not fit
+        bool Insert(const char *tuple, uint32_t size, uint32_t *slot_ptr);
+
+        /// @brief Looks up a tuple without copying it
+        /// @param slot Slot to read
+        /// @param view Points into the page on success
+        /// @return False if the slot is free or out of range
+        bool Get(uint32_t slot, TupleView *view);
+
+        /// @brief Replaces a tuple in place, keeping its slot. Shrinking always fits
+        /// @param slot Slot to replace
+        /// @param tuple New bytes
+        /// @param size Number of bytes
+        /// @return False if the slot is free or the page has no room for the new size
+        bool Update(uint32_t slot, const char *tuple, uint32_t size);
+
+        /// @brief Frees a slot. Its bytes become a hole until the next compaction
+        /// @param slot Slot to free
+        /// @return False if already free or out of range
+        bool Delete(uint32_t slot);
+
+        /// @brief Moves every tuple to the end of the page, closing holes
+        void Compact();
+
+        /// @brief First byte after the table page header
+        static constexpr uint32_t HEADER_SIZE = BasicPage<PageSize>::HEADER_SIZE + 24;
+
+        /// @brief Bytes per slot directory entry
+        static constexpr uint32_t SLOT_SIZE = 2 * sizeof(uint32_t);
+
+        /// @brief Largest tuple a page holds
+        static constexpr uint32_t MAX_TUPLE_SIZE = PageSize - HEADER_SIZE - SLOT_SIZE;
+
+    private:
+        static constexpr uint32_t NEXT_PAGE_OFFSET = BasicPage<PageSize>::HEADER_SIZE;
+        static constexpr uint32_t SLOT_COUNT_OFFSET = NEXT_PAGE_OFFSET + sizeof(page_id_t);
+        static constexpr uint32_t FREE_END_OFFSET = SLOT_COUNT_OFFSET + sizeof(uint32_t);
+        static constexpr uint32_t TUPLE_BYTES_OFFSET = FREE_END_OFFSET + sizeof(uint32_t);
+        static_assert(TUPLE_BYTES_OFFSET + 2 * sizeof(uint32_t) == HEADER_SIZE, "Table page header layout changed");
+
+        char *data_;
+
+        template <typename T>
+        inline T Read(uint32_t offset)
+        {
+            T value;
+            memcpy(&value, data_ + offset, sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        inline void Write(uint32_t offset, T value)
+        {
+            memcpy(data_ + offset, &value, sizeof(T));
+        }
+
+        /// @brief Reads a slot directory entry
+        inline void GetSlot(uint32_t slot, uint32_t *offset, uint32_t *size)
+        {
+            *offset = Read<uint32_t>(HEADER_SIZE + slot * SLOT_SIZE);
+            *size = Read<uint32_t>(HEADER_SIZE + slot * SLOT_SIZE + sizeof(uint32_t));
+        }
+
+        /// @brief Writes a slot directory entry
+        inline void SetSlot(uint32_t slot, uint32_t offset, uint32_t size)
+        {
+            Write<uint32_t>(HEADER_SIZE + slot * SLOT_SIZE, offset);
+            Write<uint32_t>(HEADER_SIZE + slot * SLOT_SIZE + sizeof(uint32_t), size);
+        }
+
+        /// @brief Gets contiguous bytes between the slot directory and the tuple data
+        inline uint32_t GetContiguousSpace()
+        {
+            return Read<uint32_t>(FREE_END_OFFSET) - HEADER_SIZE - GetSlotCount() * SLOT_SIZE;
+        }
+
+        /// @brief Copies a tuple into the contiguous space. Caller checked that it fits
+        /// @return Offset of the tuple
+        uint32_t Place(const char *tuple, uint32_t size);
+    };
+
+    /// @brief Table page of the default PAGE_SIZE
+    using TablePage = BasicTablePage<PAGE_SIZE>;
+}
@@ -0,0 +1,200 @@
+#include <coroutine>     // std::coroutine_handle, std::suspend_always, std::noop_coroutine
+#include <exception>     // std::exception_ptr, std::rethrow_exception
+#include <optional>      // std::optional
+#include <utility>       // std::move, std::exchange, std::forward
+
+#pragma once
+
+namespace minidb
+{
+    template <typename T>
+    class Task;
+
+    namespace detail
+    {
+        /// @brief Promise parts shared by every Task: the awaiting coroutine to resume at the end,
+        /// and the exception the body threw
+        struct TaskPromiseBase
+        {
+            std::coroutine_handle<> continuation;
+            std::exception_ptr error;
+
+            /// @brief Resumes the awaiting coroutine, if any, by symmetric transfer so chains of
+            /// tasks never grow the stack
+            struct FinalAwaiter
+            {
+                bool await_ready() noexcept
+                {
+                    return false;
+                }
+
+                template <typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+                {
+                    std::coroutine_handle<> continuation = handle.promise().continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+
+                void await_resume() noexcept {}
+            };
+
+            std::suspend_always initial_suspend() noexcept
+            {
+                return {};
+            }
+
+            FinalAwaiter final_suspend() noexcept
+            {
+                return {};
+            }
+
+            void unhandled_exception() noexcept
+            {
+                error = std::current_exception();
+            }
+        };
+
+        template <typename T>
+        struct TaskPromise : public TaskPromiseBase
+        {
+            std::optional<T> value;
+
+            Task<T> get_return_object() noexcept;
+
+            template <typename U>
+            void return_value(U &&result)
+            {
+                value.emplace(std::forward<U>(result));
+            }
+
+            T Result()
+            {
+                if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+                return std::move(*value);
+            }
+        };
+
+        template <>
+        struct TaskPromise<void> : public TaskPromiseBase
+        {
+            Task<void> get_return_object() noexcept;
+
+            void return_void() noexcept {}
+
+            void Result()
+            {
+                if (error)
+                {
+                    std::rethrow_exception(error);
+                }
+            }
+        };
+    }
+
+    /// @brief Lazily started coroutine producing a T. The body runs when the task is first
+    /// awaited (or started by an AsyncContext) and the awaiting coroutine resumes when it ends,
+    /// getting its result or exception. Move-only; destroying a task destroys its frame, so a task
+    /// must not be destroyed while suspended inside an unfinished operation
+    /// @tparam T Result type
+    template <typename T = void>
+    class Task
+    {
+    public:
+        using promise_type = detail::TaskPromise<T>;
+
+        Task() = default;
+
+        explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle)
+        {
+        }
+
+        Task(Task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr))
+        {
+        }
+
+        Task &operator=(Task &&other) noexcept
+        {
+            if (this != &other)
+            {
+                if (handle_)
+                {
+                    handle_.destroy();
+                }
+                handle_ = std::exchange(other.handle_, nullptr);
+            }
+            return *this;
+        }
+
+        Task(const Task &) = delete;
+        Task &operator=(const Task &) = delete;
+
+        ~Task()
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+            }
+        }
+
+        /// @brief Checks whether the body ran to its end
+        /// @return True once finished, false for an empty task too
+        inline bool IsDone() const
+        {
+            return handle_ && handle_.done();
+        }
+
+        /// @brief Gets the coroutine, e.g. to start it from a scheduler
+        /// @return Handle, empty for an empty task
+        inline std::coroutine_handle<> GetHandle() const
+        {
+            return handle_;
+        }
+
+        /// @brief Awaiting a task starts it and suspends the awaiter until it ends
+        struct Awaiter
+        {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() noexcept
+            {
+                return false;
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume()
+            {
+                return handle.promise().Result();
+            }
+        };
+
+        Awaiter operator co_await() const &noexcept
+        {
+            return Awaiter{handle_};
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    namespace detail
+    {
+        template <typename T>
+        inline Task<T> TaskPromise<T>::get_return_object() noexcept
+        {
+            return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+        }
+
+        inline Task<void> TaskPromise<void>::get_return_object() noexcept
+        {
+            return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#include <condition_variable> // std::condition_variable
+#include <cstdint>            // uint64_t
+#include <deque>              // std::deque
+#include <mutex>              // std::mutex
+#include <thread>             // std::thread
+#include <vector>             // std::vector
+#include "common.h"
+#include "io_engine.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Portable fallback when io_uring is unavailable. Submit hands the whole batch to a
+    /// pool of workers under one lock; each worker issues blocking pread/pwrite calls
+    class ThreadPoolIOEngine : public IOEngine
+    {
+    public:
+        /// @brief Starts the workers
+        /// @param queue_depth Maximum requests in flight
+        /// @param num_threads Worker threads, 0 picks min(queue_depth, 16)
+        explicit ThreadPoolIOEngine(size_t queue_depth, size_t num_threads = 0);
+
+        /// @brief Finishes queued requests and joins the workers
+        ~ThreadPoolIOEngine();
+
+        bool PrepareRead(int fd, char *buffer, size_t length, off_t offset, uint64_t user_data) override;
+        bool PrepareWrite(int fd, const char *buffer, size_t length, off_t offset, uint64_t user_data) override;
+        size_t Submit() override;
+        size_t Complete(std::vector<IOCompletion> *completions, size_t min_complete) override;
+        bool RegisterBuffers(const std::vector<iovec> &buffers) override;
+        size_t InFlight() override;
+        size_t QueueDepth() override;
+        const char *Name() override;
+
+    private:
+        /// @brief One queued transfer
+        struct Request
+        {
+            int fd;
+            bool is_write;
+            char *buffer;
+            size_t length;
+            off_t offset;
+            uint64_t user_data;
+        };
+
+        size_t queue_depth_;
+
+        /// @brief Prepared by the submitting thread, not yet visible to workers
+        std::vector<Request> prepared_;
+
+        /// @brief Prepared or submitted, not yet reaped
+        size_t in_flight_ = 0;
+
+        /// @brief Guards queue_, completed_ and stop_
+        std::mutex latch_;
+        std::condition_variable work_cv_;
+        std::condition_variable done_cv_;
+        std::deque<Request> queue_;
+        std::vector<IOCompletion> completed_;
+        bool stop_ = false;
+
+        std::vector<std::thread> workers_;
+
+        /// @brief Worker loop
+        void Run();
+    };
+}
@@ -0,0 +1,81 @@
+#include <atomic>        // std::atomic
+#include <cstdint>       // uint32_t
+#include "common.h"
+#include "page.h"
+#include "buffer_pool.h"
+#include "log_manager.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Lifecycle of a transaction
+    enum class TransactionState
+    {
+        RUNNING,
+        COMMITTED,
+        ABORTED
+    };
+
+    /// @brief Transaction handle: its ID and the chain of log records it wrote
+    struct Transaction
+    {
+        txn_id_t txn_id = INVALID_TXN_ID;
+        /// @brief Last record written, the head of the undo chain
+        lsn_t prev_lsn = INVALID_LSN;
+        TransactionState state = TransactionState::RUNNING;
+    };
+
+    /// @brief Runs logged transactions over a buffer pool. Every page change is logged with its
+    /// before and after image and stamped with the record's LSN; commit appends a COMMIT record
+    /// and waits for the group flush, abort undoes the chain writing compensation records. No
+    /// locking: callers keep concurrent transactions off each other's bytes
+    /// @tparam PageSize Bytes per page, matching the pool
+    template <int32_t PageSize>
+    class BasicTransactionManager
+    {
+    public:
+        /// @brief Attaches to a pool and log, and makes the pool follow the write-ahead rule
+        /// @param pool Pool holding the pages, see buffer_pool::SetLogManager
+        /// @param log_manager Log to write
+        /// @param next_txn_id First ID to hand out, RecoveryStats::next_txn_id after recovery
+        BasicTransactionManager(basic_buffer_pool<PageSize> *pool, LogManager *log_manager, txn_id_t next_txn_id = 0);
+
+        /// @brief Starts a transaction, logging BEGIN
+        /// @return Running transaction
+        Transaction Begin();
+
+        /// @brief Changes bytes of a page: logs before and after images, copies data in and sets
+        /// the page LSN. The caller holds a pin and unpins the page dirty
+        /// @param txn Running transaction
+        /// @param page Pinned page
+        /// @param offset First byte to change, at least Page::HEADER_SIZE
+        /// @param data New bytes
+        /// @param size Number of bytes
+        /// @throws std::out_of_range if the range overlaps the page header or end
+        void Update(Transaction *txn, BasicPage<PageSize> *page, uint32_t offset, const char *data, uint32_t size);
+
+        /// @brief Logs COMMIT and waits until it is durable
+        /// @param txn Running transaction
+        void Commit(Transaction *txn);
+
+        /// @brief Rolls back every update of the transaction, newest first, writing a compensation
+        /// record for each, then logs ABORT
+        /// @param txn Running transaction
+        void Abort(Transaction *txn);
+
+    private:
+        basic_buffer_pool<PageSize> *pool_;
+        LogManager *log_manager_;
+        std::atomic<txn_id_t> next_txn_id_;
+
+        /// @brief Appends a record without page data for a transaction
+        /// @param txn Transaction, prev_lsn is advanced
+        /// @param type BEGIN, COMMIT or ABORT
+        /// @return LSN of the record
+        lsn_t AppendControl(Transaction *txn, LogRecordType type);
+    };
+
+    /// @brief Transaction manager of the default PAGE_SIZE
+    using TransactionManager = BasicTransactionManager<PAGE_SIZE>;
+}
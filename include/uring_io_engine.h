@@ -0,0 +1,87 @@
+#include <cstdint>       // uint64_t
+#include <vector>        // std::vector
+#include <linux/io_uring.h>
+#include "common.h"
+#include "io_engine.h"
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief io_uring backend using the raw syscalls (no liburing dependency). Prepared requests
+    /// are written straight into the shared submission ring and published by Submit with one
+    /// io_uring_enter; buffers inside registered regions use the READ_FIXED/WRITE_FIXED opcodes
+    class UringIOEngine : public IOEngine
+    {
+    public:
+        /// @brief Sets up a ring. Throws std::runtime_error when io_uring is unavailable
+        /// @param queue_depth Submission queue entries
+        explicit UringIOEngine(size_t queue_depth);
+
+        /// @brief Unmaps and closes the ring. Outstanding requests must be completed first
+        ~UringIOEngine();
+
+        UringIOEngine(const UringIOEngine &) = delete;
+        UringIOEngine &operator=(const UringIOEngine &) = delete;
+
+        bool PrepareRead(int fd, char *buffer, size_t length, off_t offset, uint64_t user_data) override;
+        bool PrepareWrite(int fd, const char *buffer, size_t length, off_t offset, uint64_t user_data) override;
+        size_t Submit() override;
+        size_t Complete(std::vector<IOCompletion> *completions, size_t min_complete) override;
+        bool RegisterBuffers(const std::vector<iovec> &buffers) override;
+        size_t InFlight() override;
+        size_t QueueDepth() override;
+        const char *Name() override;
+
+    private:
+        /// @brief Registered region and its index for *_FIXED opcodes
+        struct RegisteredBuffer
+        {
+            char *base;
+            size_t length;
+            uint16_t index;
+        };
+
+        int ring_fd_ = -1;
+        unsigned sq_entries_ = 0;
+        unsigned cq_entries_ = 0;
+
+        /// @brief Mapped ring memory
+        void *sq_ring_ = nullptr;
+        size_t sq_ring_size_ = 0;
+        void *cq_ring_ = nullptr;
+        size_t cq_ring_size_ = 0;
+        io_uring_sqe *sqes_ = nullptr;
+        size_t sqes_size_ = 0;
+
+        /// @brief Pointers into the shared rings
+        unsigned *sq_head_ = nullptr;
+        unsigned *sq_tail_ = nullptr;
+        unsigned *sq_mask_ = nullptr;
+        unsigned *sq_array_ = nullptr;
+        unsigned *cq_head_ = nullptr;
+        unsigned *cq_tail_ = nullptr;
+        unsigned *cq_mask_ = nullptr;
+        io_uring_cqe *cqes_ = nullptr;
+
+        /// @brief Tail including prepared but unpublished entries
+        unsigned local_tail_ = 0;
+
+        /// @brief Prepared, not yet submitted
+        unsigned pending_ = 0;
+
+        /// @brief Prepared or submitted, not yet completed
+        size_t in_flight_ = 0;
+
+        /// @brief Registered regions sorted by base
+        std::vector<RegisteredBuffer> registered_;
+
+        /// @brief Fills the next submission entry
+        /// @return False if the queue depth is exhausted
+        bool Prepare(uint8_t opcode, int fd, const char *buffer, size_t length, off_t offset, uint64_t user_data);
+
+        /// @brief Finds the registered region containing [buffer, buffer + length)
+        /// @return Region or nullptr
+        const RegisteredBuffer *FindRegistered(const char *buffer, size_t length) const;
+    };
+}
@@ -0,0 +1,94 @@
+#include <atomic>             // std::atomic
+#include <condition_variable> // std::condition_variable
+#include <cstddef>            // size_t
+#include <cstdint>            // uint64_t
+#include <deque>              // std::deque
+#include <exception>          // std::exception_ptr
+#include <functional>         // std::function
+#include <memory>             // std::unique_ptr
+#include <mutex>              // std::mutex
+#include <thread>             // std::thread
+#include <vector>             // std::vector
+
+#pragma once
+
+namespace minidb
+{
+    /// @brief Fixed set of worker threads that run batches of indexed tasks. A batch is dealt
+    /// out in contiguous blocks, one deque per worker, so neighbouring tasks (e.g. adjacent
+    /// morsels of a scan) stay on one thread. A worker takes its own tasks from the front and,
+    /// once out, steals from the back of another worker's deque, which keeps every thread busy
+    /// when tasks are uneven
+    class WorkStealingPool
+    {
+    public:
+        /// @brief Starts the workers
+        /// @param threads Number of workers, at least 1
+        explicit WorkStealingPool(size_t threads);
+
+        /// @brief Stops and joins the workers
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool &) = delete;
+        WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+        /// @brief Runs fn(index, worker) for every index in [0, count) and waits for all of them.
+        /// worker identifies the thread, in [0, GetThreadCount()), e.g. to pick thread-local
+        /// state. One batch runs at a time; concurrent callers queue up
+        /// @param count Number of tasks
+        /// @param fn Task body, called concurrently from every worker
+        /// @throws The first exception a task threw; tasks not yet started are then skipped
+        void ParallelFor(size_t count, const std::function<void(size_t index, size_t worker)> &fn);
+
+        /// @brief Gets the number of workers
+        /// @return Threads
+        inline size_t GetThreadCount() const
+        {
+            return workers_.size();
+        }
+
+        /// @brief Gets how many tasks ran on a worker other than the one they were dealt to
+        /// @return Steals since construction
+        inline uint64_t GetSteals() const
+        {
+            return steals_.load(std::memory_order_relaxed);
+        }
+
+    private:
+        /// @brief Tasks of one worker, on its own cache lines
+        struct alignas(64) Queue
+        {
+            std::mutex latch;
+            std::deque<size_t> tasks;
+        };
+
+        std::vector<std::unique_ptr<Queue>> queues_;
+        std::vector<std::thread> workers_;
+
+        /// @brief Serializes ParallelFor callers
+        std::mutex batch_latch_;
+
+        /// @brief Guards the fields below
+        std::mutex latch_;
+        std::condition_variable work_cv_;
+        std::condition_variable done_cv_;
+        const std::function<void(size_t, size_t)> *fn_ = nullptr;
+        /// @brief Bumped per batch, so a worker runs each batch once
+        uint64_t generation_ = 0;
+        /// @brief Workers still in the current batch
+        size_t active_ = 0;
+        bool stop_ = false;
+        std::exception_ptr error_;
+
+        /// @brief Set once a task of the batch threw
+        std::atomic<bool> failed_{false};
+        std::atomic<uint64_t> steals_{0};
+
+        /// @brief Worker loop: wait for a batch, drain it, report done
+        void Run(size_t worker);
+
+        /// @brief Takes the next task for a worker, its own or a stolen one
+        /// @return False when every deque is empty
+        bool Next(size_t worker, size_t *index);
+    };
+}
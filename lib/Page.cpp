@@ -1,15 +1,52 @@
 #include "common.h"
 #include "../include/page.h"
 
+#include <new> // std::align_val_t
+
 namespace minidb
 {
+    template <int32_t PageSize>
+    BasicPage<PageSize>::BasicPage()
+        : data_(static_cast<char *>(operator new[](PageSize, std::align_val_t(PAGE_ALIGNMENT))))
+    {
+        memset(data_, 0, PageSize);
+    }
 
-    void Page::Reset()
+    template <int32_t PageSize>
+    BasicPage<PageSize>::BasicPage(char *data) : data_(data), owns_data_(false)
     {
-        memset(data_, 0, PAGE_SIZE);
+    }
+
+    template <int32_t PageSize>
+    BasicPage<PageSize>::BasicPage(BasicPage &&other) noexcept
+        : data_(other.data_), page_id_(other.page_id_), pin_count_(other.pin_count_.load(std::memory_order_acquire)),
+          is_dirty_(other.is_dirty_), owns_data_(other.owns_data_)
+    {
+        other.data_ = nullptr;
+        other.owns_data_ = false;
+    }
+
+    template <int32_t PageSize>
+    BasicPage<PageSize>::~BasicPage()
+    {
+        if (owns_data_)
+        {
+            operator delete[](data_, std::align_val_t(PAGE_ALIGNMENT));
+        }
+    }
+
+    template <int32_t PageSize>
+    void BasicPage<PageSize>::Reset()
+    {
+        memset(data_, 0, PageSize);
         page_id_ = INVALID_PAGE_ID;
-        pin_count_ = 0;
+        pin_count_.store(0, std::memory_order_release);
         is_dirty_ = false;
     }
 
-}
\ No newline at end of file
+    template class BasicPage<4096>;
+    template class BasicPage<8192>;
+    template class BasicPage<16384>;
+    template class BasicPage<65536>;
+
+}
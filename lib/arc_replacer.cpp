@@ -0,0 +1,180 @@
+#include "../include/arc_replacer.h"
+
+namespace minidb
+{
+    ARCReplacer::ARCReplacer(size_t num_frames)
+        : capacity_(num_frames), t1_(num_frames), t2_(num_frames),
+          frame_page_(num_frames, INVALID_PAGE_ID), evictable_(num_frames, false)
+    {
+    }
+
+    void ARCReplacer::RecordAccess(frame_id_t frame_id, page_id_t page_id)
+    {
+        // Hit on a resident page, it is now frequent
+        if (t1_.Contains(frame_id))
+        {
+            t1_.Erase(frame_id);
+            t2_.PushFront(frame_id);
+            return;
+        }
+        if (t2_.Contains(frame_id))
+        {
+            t2_.MoveToFront(frame_id);
+            return;
+        }
+
+        // Frame was just filled with page_id after a miss
+        frame_page_[frame_id] = page_id;
+        evictable_[frame_id] = false;
+
+        auto ghost = b1_index_.find(page_id);
+        if (ghost != b1_index_.end())
+        {
+            // Evicted from T1 too early, grow T1
+            size_t delta = b1_.size() >= b2_.size() ? 1 : b2_.size() / b1_.size();
+            target_t1_ = std::min(capacity_, target_t1_ + delta);
+            b1_.erase(ghost->second);
+            b1_index_.erase(ghost);
+            t2_.PushFront(frame_id);
+            return;
+        }
+
+        ghost = b2_index_.find(page_id);
+        if (ghost != b2_index_.end())
+        {
+            // Evicted from T2 too early, shrink T1
+            size_t delta = b2_.size() >= b1_.size() ? 1 : b1_.size() / b2_.size();
+            target_t1_ = target_t1_ > delta ? target_t1_ - delta : 0;
+            b2_.erase(ghost->second);
+            b2_index_.erase(ghost);
+            t2_.PushFront(frame_id);
+            return;
+        }
+
+        t1_.PushFront(frame_id);
+        TrimGhosts();
+    }
+
+    void ARCReplacer::SetEvictable(frame_id_t frame_id, bool evictable)
+    {
+        if ((!t1_.Contains(frame_id) && !t2_.Contains(frame_id)) || evictable_[frame_id] == evictable)
+        {
+            return;
+        }
+        evictable_[frame_id] = evictable;
+        if (evictable)
+        {
+            evictable_count_++;
+        }
+        else
+        {
+            evictable_count_--;
+        }
+    }
+
+    bool ARCReplacer::Evict(frame_id_t *frame_id_ptr)
+    {
+        if (evictable_count_ == 0)
+        {
+            return false;
+        }
+
+        // REPLACE: take from T1 while it is above target, otherwise from T2.
+        // Fall back to the other list when every frame in the preferred one is pinned
+        bool from_t1 = t1_.Size() > 0 && t1_.Size() > target_t1_;
+        frame_id_t victim = OldestEvictable(from_t1 ? t1_ : t2_);
+        if (victim == INVALID_FRAME_ID)
+        {
+            from_t1 = !from_t1;
+            victim = OldestEvictable(from_t1 ? t1_ : t2_);
+        }
+        if (victim == INVALID_FRAME_ID)
+        {
+            return false;
+        }
+
+        page_id_t page_id = frame_page_[victim];
+        if (from_t1)
+        {
+            t1_.Erase(victim);
+            b1_.push_front(page_id);
+            b1_index_[page_id] = b1_.begin();
+        }
+        else
+        {
+            t2_.Erase(victim);
+            b2_.push_front(page_id);
+            b2_index_[page_id] = b2_.begin();
+        }
+        evictable_[victim] = false;
+        evictable_count_--;
+        frame_page_[victim] = INVALID_PAGE_ID;
+        TrimGhosts();
+
+        *frame_id_ptr = victim;
+        return true;
+    }
+
+    void ARCReplacer::Remove(frame_id_t frame_id)
+    {
+        if (!t1_.Erase(frame_id) && !t2_.Erase(frame_id))
+        {
+            return;
+        }
+        if (evictable_[frame_id])
+        {
+            evictable_count_--;
+        }
+        evictable_[frame_id] = false;
+        frame_page_[frame_id] = INVALID_PAGE_ID;
+    }
+
+    void ARCReplacer::GetCandidates(size_t count, std::vector<frame_id_t> *candidates)
+    {
+        // Same list preference as Evict, without adapting the target
+        bool t1_first = t1_.Size() > target_t1_;
+        for (const FrameList *list : {t1_first ? &t1_ : &t2_, t1_first ? &t2_ : &t1_})
+        {
+            for (frame_id_t frame_id = list->Back(); frame_id != INVALID_FRAME_ID && count > 0; frame_id = list->Prev(frame_id))
+            {
+                if (evictable_[frame_id])
+                {
+                    candidates->push_back(frame_id);
+                    count--;
+                }
+            }
+        }
+    }
+
+    size_t ARCReplacer::Size()
+    {
+        return evictable_count_;
+    }
+
+    frame_id_t ARCReplacer::OldestEvictable(const FrameList &list) const
+    {
+        for (frame_id_t frame_id = list.Back(); frame_id != INVALID_FRAME_ID; frame_id = list.Prev(frame_id))
+        {
+            if (evictable_[frame_id])
+            {
+                return frame_id;
+            }
+        }
+        return INVALID_FRAME_ID;
+    }
+
+    void ARCReplacer::TrimGhosts()
+    {
+        while (!b1_.empty() && t1_.Size() + b1_.size() > capacity_)
+        {
+            b1_index_.erase(b1_.back());
+            b1_.pop_back();
+        }
+        while (!b2_.empty() && t1_.Size() + t2_.Size() + b1_.size() + b2_.size() > 2 * capacity_)
+        {
+            b2_index_.erase(b2_.back());
+            b2_.pop_back();
+        }
+    }
+
+} // namespace minidb
@@ -0,0 +1,163 @@
+#include "../include/async_context.h"
+
+#include <cerrno>  // EIO, ECANCELED
+#include <utility> // std::move, std::exchange
+
+namespace minidb
+{
+    template <int32_t PageSize>
+    BasicAsyncContext<PageSize>::BasicAsyncContext(basic_buffer_pool<PageSize> *pool, size_t queue_depth,
+                                                   IOEngineType engine_type)
+        : pool_(pool), engine_(MakeIOEngine(engine_type, queue_depth == 0 ? 1 : queue_depth))
+    {
+    }
+
+    template <int32_t PageSize>
+    BasicAsyncContext<PageSize>::~BasicAsyncContext()
+    {
+        // Frames and the fd must outlive every request; their waiters, if any, are never resumed
+        engine_->Submit();
+        completions_.clear();
+        engine_->Complete(&completions_, engine_->InFlight());
+        for (const IOCompletion &completion : completions_)
+        {
+            pool_->FinishFetchAsync(static_cast<page_id_t>(completion.user_data), -ECANCELED);
+        }
+        while (!queued_.empty())
+        {
+            page_id_t page_id = queued_.front().page_id;
+            queued_.pop_front();
+            pool_->FinishFetchAsync(page_id, -ECANCELED);
+        }
+    }
+
+    template <int32_t PageSize>
+    void BasicAsyncContext<PageSize>::Spawn(Task<void> task)
+    {
+        tasks_.push_back(Track(std::move(task)));
+        active_++;
+        Post(tasks_.back().GetHandle());
+    }
+
+    template <int32_t PageSize>
+    void BasicAsyncContext<PageSize>::Run()
+    {
+        std::deque<std::coroutine_handle<>> ready;
+        while (active_ > 0)
+        {
+            {
+                std::lock_guard<std::mutex> guard(ready_latch_);
+                ready.swap(ready_);
+            }
+            for (std::coroutine_handle<> handle : ready)
+            {
+                handle.resume();
+            }
+            ready.clear();
+            SubmitQueued();
+            if (active_ == 0)
+            {
+                break;
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(ready_latch_);
+                if (!ready_.empty())
+                {
+                    continue;
+                }
+                if (engine_->InFlight() == 0)
+                {
+                    // Every task waits on reads other contexts drive
+                    ready_cv_.wait(lock, [&]()
+                                   { return !ready_.empty(); });
+                    continue;
+                }
+            }
+
+            completions_.clear();
+            engine_->Complete(&completions_, 1);
+            for (const IOCompletion &completion : completions_)
+            {
+                pool_->FinishFetchAsync(static_cast<page_id_t>(completion.user_data), completion.result);
+            }
+        }
+        tasks_.clear();
+        if (error_)
+        {
+            std::rethrow_exception(std::exchange(error_, nullptr));
+        }
+    }
+
+    template <int32_t PageSize>
+    Task<void> BasicAsyncContext<PageSize>::Track(Task<void> task)
+    {
+        try
+        {
+            co_await task;
+        }
+        catch (...)
+        {
+            if (!error_)
+            {
+                error_ = std::current_exception();
+            }
+        }
+        active_--;
+    }
+
+    template <int32_t PageSize>
+    void BasicAsyncContext<PageSize>::QueueRead(page_id_t page_id, char *data)
+    {
+        queued_.push_back({page_id, data});
+    }
+
+    template <int32_t PageSize>
+    void BasicAsyncContext<PageSize>::SubmitQueued()
+    {
+        size_t prepared = 0;
+        while (!queued_.empty() && engine_->InFlight() < engine_->QueueDepth())
+        {
+            QueuedRead read = queued_.front();
+            int fd = -1;
+            off_t offset = 0;
+            try
+            {
+                pool_->disk_manager_->LocatePage(read.page_id, &fd, &offset);
+            }
+            catch (const std::exception &)
+            {
+                // The segment cannot be opened: fail the waiters like a failed read
+                queued_.pop_front();
+                pool_->FinishFetchAsync(read.page_id, -EIO);
+                continue;
+            }
+            if (!engine_->PrepareRead(fd, read.data, PageSize, offset, static_cast<uint64_t>(read.page_id)))
+            {
+                break;
+            }
+            queued_.pop_front();
+            prepared++;
+        }
+        if (prepared > 0)
+        {
+            engine_->Submit();
+            reads_ += prepared;
+        }
+    }
+
+    template <int32_t PageSize>
+    void BasicAsyncContext<PageSize>::Post(std::coroutine_handle<> handle)
+    {
+        {
+            std::lock_guard<std::mutex> guard(ready_latch_);
+            ready_.push_back(handle);
+        }
+        ready_cv_.notify_one();
+    }
+
+    template class BasicAsyncContext<4096>;
+    template class BasicAsyncContext<8192>;
+    template class BasicAsyncContext<16384>;
+    template class BasicAsyncContext<65536>;
+}
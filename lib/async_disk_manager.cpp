@@ -0,0 +1,60 @@
+#include "../include/async_disk_manager.h"
+
+namespace minidb
+{
+    AsyncDiskManager::AsyncDiskManager(const std::string &db_file, size_t queue_depth, bool direct_io,
+                                       IOEngineType engine_type)
+        : DiskManager(db_file, direct_io), engine_(MakeIOEngine(engine_type, queue_depth))
+    {
+    }
+
+    AsyncDiskManager::~AsyncDiskManager()
+    {
+        // Buffers and fd must outlive every request
+        engine_->Submit();
+        std::vector<IOCompletion> drained;
+        engine_->Complete(&drained, engine_->InFlight());
+    }
+
+    bool AsyncDiskManager::SubmitRead(page_id_t page_id, char *page_data, uint64_t user_data)
+    {
+        CheckPageId(page_id);
+        int fd = -1;
+        off_t offset = 0;
+        LocatePage(page_id, &fd, &offset);
+        return engine_->PrepareRead(fd, page_data, PAGE_SIZE, offset, user_data);
+    }
+
+    bool AsyncDiskManager::SubmitWrite(page_id_t page_id, const char *page_data, uint64_t user_data)
+    {
+        CheckPageId(page_id);
+        int fd = -1;
+        off_t offset = 0;
+        LocatePage(page_id, &fd, &offset);
+        return engine_->PrepareWrite(fd, page_data, PAGE_SIZE, offset, user_data);
+    }
+
+    size_t AsyncDiskManager::Submit()
+    {
+        return engine_->Submit();
+    }
+
+    size_t AsyncDiskManager::Complete(std::vector<IOCompletion> *completions, size_t min_complete)
+    {
+        return engine_->Complete(completions, min_complete);
+    }
+
+    bool AsyncDiskManager::RegisterBuffers(const std::vector<iovec> &buffers)
+    {
+        return engine_->RegisterBuffers(buffers);
+    }
+
+    void AsyncDiskManager::CheckPageId(page_id_t page_id)
+    {
+        if (page_id < 0 || page_id >= GetNumPages())
+        {
+            throw std::out_of_range("Invalid page id " + std::to_string(page_id));
+        }
+    }
+
+} // namespace minidb
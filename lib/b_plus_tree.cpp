@@ -0,0 +1,453 @@
+#include "../include/b_plus_tree.h"
+
+#include <algorithm> // std::lower_bound
+
+namespace minidb
+{
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    BasicBPlusTree<KeyType, KeyComparator, PageSize>::Iterator::Iterator(basic_buffer_pool<PageSize> *pool,
+                                                                         BasicPage<PageSize> *leaf, int index)
+        : pool_(pool), page_(leaf), index_(index)
+    {
+        SeekValid();
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    BasicBPlusTree<KeyType, KeyComparator, PageSize>::Iterator::Iterator(Iterator &&other) noexcept
+        : pool_(other.pool_), page_(other.page_), index_(other.index_)
+    {
+        other.page_ = nullptr;
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    BasicBPlusTree<KeyType, KeyComparator, PageSize>::Iterator::~Iterator()
+    {
+        if (page_ != nullptr)
+        {
+            pool_->UnpinPage(page_->GetPageId(), false);
+        }
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    void BasicBPlusTree<KeyType, KeyComparator, PageSize>::Iterator::Next()
+    {
+        if (page_ == nullptr)
+        {
+            return;
+        }
+        index_++;
+        SeekValid();
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    void BasicBPlusTree<KeyType, KeyComparator, PageSize>::Iterator::SeekValid()
+    {
+        while (page_ != nullptr)
+        {
+            LeafNode leaf(page_->GetData());
+            if (index_ < leaf.GetSize())
+            {
+                return;
+            }
+
+            // Leaf done, hand it back before pinning its sibling
+            page_id_t next = leaf.GetNextPageId();
+            pool_->UnpinPage(page_->GetPageId(), false);
+            page_ = nullptr;
+            if (next != INVALID_PAGE_ID)
+            {
+                page_ = pool_->FetchPage(next);
+                index_ = 0;
+            }
+        }
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    BasicBPlusTree<KeyType, KeyComparator, PageSize>::BasicBPlusTree(basic_buffer_pool<PageSize> *pool,
+                                                                     const KeyComparator &comparator)
+        : pool_(pool), comparator_(comparator)
+    {
+        pool_->NewPage(&header_page_id_);
+        pool_->UnpinPage(header_page_id_, true);
+
+        BasicPage<PageSize> *root = pool_->NewPage(&root_page_id_);
+        LeafNode(root->GetData()).Init();
+        pool_->UnpinPage(root_page_id_, true);
+        SetRoot(root_page_id_);
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    BasicBPlusTree<KeyType, KeyComparator, PageSize>::BasicBPlusTree(basic_buffer_pool<PageSize> *pool,
+                                                                     page_id_t header_page_id,
+                                                                     const KeyComparator &comparator)
+        : pool_(pool), comparator_(comparator), header_page_id_(header_page_id)
+    {
+        BasicPage<PageSize> *header = pool_->FetchPage(header_page_id_);
+        memcpy(&root_page_id_, header->GetData() + BasicPage<PageSize>::HEADER_SIZE, sizeof(page_id_t));
+        pool_->UnpinPage(header_page_id_, false);
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    bool BasicBPlusTree<KeyType, KeyComparator, PageSize>::GetValue(const KeyType &key, RID *value)
+    {
+        BasicPage<PageSize> *page = FindLeaf(key, nullptr);
+        LeafNode leaf(page->GetData());
+        int index = LowerBound(&leaf, key);
+        bool found = index < leaf.GetSize() && comparator_(leaf.KeyAt(index), key) == 0;
+        if (found)
+        {
+            *value = leaf.ValueAt(index);
+        }
+        pool_->UnpinPage(page->GetPageId(), false);
+        return found;
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    bool BasicBPlusTree<KeyType, KeyComparator, PageSize>::Insert(const KeyType &key, const RID &value)
+    {
+        Path path;
+        BasicPage<PageSize> *page = FindLeaf(key, &path);
+        page_id_t leaf_id = page->GetPageId();
+        LeafNode leaf(page->GetData());
+        int index = LowerBound(&leaf, key);
+        if (index < leaf.GetSize() && comparator_(leaf.KeyAt(index), key) == 0)
+        {
+            pool_->UnpinPage(leaf_id, false);
+            return false;
+        }
+
+        leaf.InsertAt(index, key, value);
+        if (leaf.GetSize() <= LeafNode::MAX_SIZE)
+        {
+            pool_->UnpinPage(leaf_id, true);
+            return true;
+        }
+
+        // Overflow: upper half to a new right sibling
+        page_id_t right_id;
+        BasicPage<PageSize> *right_page;
+        try
+        {
+            right_page = pool_->NewPage(&right_id);
+        }
+        catch (...)
+        {
+            leaf.RemoveAt(index);
+            pool_->UnpinPage(leaf_id, false);
+            throw;
+        }
+        LeafNode right(right_page->GetData());
+        right.Init();
+        leaf.MoveTail(&right, leaf.GetSize() / 2);
+        right.SetNextPageId(leaf.GetNextPageId());
+        leaf.SetNextPageId(right_id);
+        KeyType separator = right.KeyAt(0);
+        pool_->UnpinPage(right_id, true);
+        pool_->UnpinPage(leaf_id, true);
+
+        InsertIntoParent(&path, leaf_id, separator, right_id);
+        return true;
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    bool BasicBPlusTree<KeyType, KeyComparator, PageSize>::Remove(const KeyType &key)
+    {
+        Path path;
+        BasicPage<PageSize> *page = FindLeaf(key, &path);
+        page_id_t leaf_id = page->GetPageId();
+        LeafNode leaf(page->GetData());
+        int index = LowerBound(&leaf, key);
+        if (index == leaf.GetSize() || comparator_(leaf.KeyAt(index), key) != 0)
+        {
+            pool_->UnpinPage(leaf_id, false);
+            return false;
+        }
+
+        leaf.RemoveAt(index);
+        // A root leaf may shrink to nothing
+        bool underfull = !path.empty() && leaf.GetSize() < LeafNode::MAX_SIZE / 2;
+        pool_->UnpinPage(leaf_id, true);
+        if (underfull)
+        {
+            Rebalance(&path, leaf_id);
+        }
+        return true;
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    typename BasicBPlusTree<KeyType, KeyComparator, PageSize>::Iterator
+    BasicBPlusTree<KeyType, KeyComparator, PageSize>::Begin()
+    {
+        page_id_t page_id = root_page_id_;
+        BasicPage<PageSize> *page = pool_->FetchPage(page_id);
+        while (InternalNode(page->GetData()).GetType() == BPlusTreeNodeType::INTERNAL)
+        {
+            page_id_t child = InternalNode(page->GetData()).ChildAt(0);
+            pool_->UnpinPage(page_id, false);
+            page_id = child;
+            page = pool_->FetchPage(page_id);
+        }
+        return Iterator(pool_, page, 0);
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    typename BasicBPlusTree<KeyType, KeyComparator, PageSize>::Iterator
+    BasicBPlusTree<KeyType, KeyComparator, PageSize>::Begin(const KeyType &key)
+    {
+        BasicPage<PageSize> *page = FindLeaf(key, nullptr);
+        LeafNode leaf(page->GetData());
+        return Iterator(pool_, page, LowerBound(&leaf, key));
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    int BasicBPlusTree<KeyType, KeyComparator, PageSize>::GetHeight()
+    {
+        int height = 1;
+        page_id_t page_id = root_page_id_;
+        while (true)
+        {
+            BasicPage<PageSize> *page = pool_->FetchPage(page_id);
+            InternalNode node(page->GetData());
+            bool internal = node.GetType() == BPlusTreeNodeType::INTERNAL;
+            page_id_t child = internal ? node.ChildAt(0) : INVALID_PAGE_ID;
+            pool_->UnpinPage(page_id, false);
+            if (!internal)
+            {
+                return height;
+            }
+            page_id = child;
+            height++;
+        }
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    BasicPage<PageSize> *BasicBPlusTree<KeyType, KeyComparator, PageSize>::FindLeaf(const KeyType &key, Path *path)
+    {
+        page_id_t page_id = root_page_id_;
+        BasicPage<PageSize> *page = pool_->FetchPage(page_id);
+        while (true)
+        {
+            InternalNode node(page->GetData());
+            if (node.GetType() != BPlusTreeNodeType::INTERNAL)
+            {
+                return page;
+            }
+            int index = node.ChildIndex(key, comparator_);
+            page_id_t child = node.ChildAt(index);
+            if (path != nullptr)
+            {
+                path->emplace_back(page_id, index);
+            }
+            pool_->UnpinPage(page_id, false);
+            page_id = child;
+            page = pool_->FetchPage(page_id);
+        }
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    int BasicBPlusTree<KeyType, KeyComparator, PageSize>::LowerBound(LeafNode *leaf, const KeyType &key)
+    {
+        KeyType *keys = leaf->Keys();
+        KeyType *it = std::lower_bound(keys, keys + leaf->GetSize(), key,
+                                       [this](const KeyType &a, const KeyType &b) { return comparator_(a, b) < 0; });
+        return static_cast<int>(it - keys);
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    void BasicBPlusTree<KeyType, KeyComparator, PageSize>::InsertIntoParent(Path *path, page_id_t left,
+                                                                           const KeyType &key, page_id_t right)
+    {
+        if (path->empty())
+        {
+            // The root split, grow a level
+            page_id_t root_id;
+            BasicPage<PageSize> *page = pool_->NewPage(&root_id);
+            InternalNode root(page->GetData());
+            root.Init();
+            KeyType keys[2] = {key, key};
+            page_id_t children[2] = {left, right};
+            root.Store(keys, children, 2);
+            pool_->UnpinPage(root_id, true);
+            SetRoot(root_id);
+            return;
+        }
+
+        page_id_t parent_id = path->back().first;
+        int index = path->back().second;
+        path->pop_back();
+
+        BasicPage<PageSize> *page = pool_->FetchPage(parent_id);
+        std::vector<KeyType> keys;
+        std::vector<page_id_t> children;
+        InternalNode(page->GetData()).Load(&keys, &children);
+        keys.insert(keys.begin() + index + 1, key);
+        children.insert(children.begin() + index + 1, right);
+        WriteInternal(path, parent_id, page, keys, children);
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    void BasicBPlusTree<KeyType, KeyComparator, PageSize>::WriteInternal(Path *path, page_id_t page_id,
+                                                                        BasicPage<PageSize> *page,
+                                                                        const std::vector<KeyType> &keys,
+                                                                        const std::vector<page_id_t> &children)
+    {
+        InternalNode node(page->GetData());
+        int count = static_cast<int>(keys.size());
+        if (node.Store(keys.data(), children.data(), count))
+        {
+            pool_->UnpinPage(page_id, true);
+            return;
+        }
+
+        // Overflow: the key at the split moves up, the children from it go to a new sibling
+        page_id_t sibling_id;
+        BasicPage<PageSize> *sibling_page = pool_->NewPage(&sibling_id);
+        InternalNode sibling(sibling_page->GetData());
+        sibling.Init();
+        int split = InternalNode::SplitPoint(keys.data(), count);
+        sibling.Store(keys.data() + split, children.data() + split, count - split);
+        node.Store(keys.data(), children.data(), split);
+        pool_->UnpinPage(sibling_id, true);
+        pool_->UnpinPage(page_id, true);
+
+        InsertIntoParent(path, page_id, keys[split], sibling_id);
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    void BasicBPlusTree<KeyType, KeyComparator, PageSize>::Rebalance(Path *path, page_id_t page_id)
+    {
+        page_id_t parent_id = path->back().first;
+        int index = path->back().second;
+        path->pop_back();
+
+        // Pair the node with its left sibling, or its right one if it is the first child
+        BasicPage<PageSize> *parent_page = pool_->FetchPage(parent_id);
+        InternalNode parent(parent_page->GetData());
+        std::vector<KeyType> keys;
+        std::vector<page_id_t> children;
+        parent.Load(&keys, &children);
+        int right_index = index > 0 ? index : 1;
+        page_id_t left_id = children[right_index - 1];
+        page_id_t right_id = children[right_index];
+        BasicPage<PageSize> *left_page = pool_->FetchPage(left_id);
+        BasicPage<PageSize> *right_page = pool_->FetchPage(right_id);
+        bool node_is_left = left_id == page_id;
+        bool merged = false;
+
+        if (LeafNode(left_page->GetData()).GetType() == BPlusTreeNodeType::LEAF)
+        {
+            LeafNode left(left_page->GetData());
+            LeafNode right(right_page->GetData());
+            if (left.GetSize() + right.GetSize() <= LeafNode::MAX_SIZE)
+            {
+                right.MoveTail(&left, 0);
+                left.SetNextPageId(right.GetNextPageId());
+                merged = true;
+            }
+            else if (node_is_left)
+            {
+                left.InsertAt(left.GetSize(), right.KeyAt(0), right.ValueAt(0));
+                right.RemoveAt(0);
+                keys[right_index] = right.KeyAt(0);
+            }
+            else
+            {
+                int last = left.GetSize() - 1;
+                right.InsertAt(0, left.KeyAt(last), left.ValueAt(last));
+                left.RemoveAt(last);
+                keys[right_index] = right.KeyAt(0);
+            }
+        }
+        else
+        {
+            // Internal nodes rotate through the parent: the separator comes down between the two
+            // nodes' entries, then either they fit in one node or are split again evenly and the
+            // key at the split goes up
+            InternalNode left(left_page->GetData());
+            InternalNode right(right_page->GetData());
+            std::vector<KeyType> both_keys;
+            std::vector<page_id_t> both_children;
+            std::vector<KeyType> right_keys;
+            std::vector<page_id_t> right_children;
+            left.Load(&both_keys, &both_children);
+            right.Load(&right_keys, &right_children);
+            right_keys[0] = keys[right_index];
+            both_keys.insert(both_keys.end(), right_keys.begin(), right_keys.end());
+            both_children.insert(both_children.end(), right_children.begin(), right_children.end());
+            int count = static_cast<int>(both_keys.size());
+            if (left.Store(both_keys.data(), both_children.data(), count))
+            {
+                merged = true;
+            }
+            else
+            {
+                int split = InternalNode::SplitPoint(both_keys.data(), count);
+                left.Store(both_keys.data(), both_children.data(), split);
+                right.Store(both_keys.data() + split, both_children.data() + split, count - split);
+                keys[right_index] = both_keys[split];
+            }
+        }
+
+        pool_->UnpinPage(left_id, true);
+        pool_->UnpinPage(right_id, !merged);
+        if (!merged)
+        {
+            // The new separator may be longer than the old one
+            WriteInternal(path, parent_id, parent_page, keys, children);
+            return;
+        }
+
+        // Dropping an entry never lengthens the others, so the parent still fits
+        pool_->DeletePage(right_id);
+        keys.erase(keys.begin() + right_index);
+        children.erase(children.begin() + right_index);
+        int count = static_cast<int>(keys.size());
+        parent.Store(keys.data(), children.data(), count);
+        if (path->empty())
+        {
+            // Parent is the root: drop a level once it has a single child
+            if (count == 1)
+            {
+                pool_->UnpinPage(parent_id, true);
+                pool_->DeletePage(parent_id);
+                SetRoot(left_id);
+                return;
+            }
+            pool_->UnpinPage(parent_id, true);
+            return;
+        }
+
+        bool underfull = InternalNode::Bytes(keys.data(), count) < static_cast<size_t>(PageSize) / 2;
+        pool_->UnpinPage(parent_id, true);
+        if (underfull)
+        {
+            Rebalance(path, parent_id);
+        }
+    }
+
+    template <typename KeyType, typename KeyComparator, int32_t PageSize>
+    void BasicBPlusTree<KeyType, KeyComparator, PageSize>::SetRoot(page_id_t page_id)
+    {
+        root_page_id_ = page_id;
+        BasicPage<PageSize> *header = pool_->FetchPage(header_page_id_);
+        memcpy(header->GetData() + BasicPage<PageSize>::HEADER_SIZE, &page_id, sizeof(page_id_t));
+        pool_->UnpinPage(header_page_id_, true);
+    }
+
+    template class BasicBPlusTree<int64_t, Int64Comparator, 4096>;
+    template class BasicBPlusTree<int64_t, Int64Comparator, 8192>;
+    template class BasicBPlusTree<int64_t, Int64Comparator, 16384>;
+    template class BasicBPlusTree<int64_t, Int64Comparator, 65536>;
+    template class BasicBPlusTree<GenericKey<16>, GenericComparator<16>, 4096>;
+    template class BasicBPlusTree<GenericKey<16>, GenericComparator<16>, 8192>;
+    template class BasicBPlusTree<GenericKey<16>, GenericComparator<16>, 16384>;
+    template class BasicBPlusTree<GenericKey<16>, GenericComparator<16>, 65536>;
+    template class BasicBPlusTree<GenericKey<32>, GenericComparator<32>, 4096>;
+    template class BasicBPlusTree<GenericKey<32>, GenericComparator<32>, 8192>;
+    template class BasicBPlusTree<GenericKey<32>, GenericComparator<32>, 16384>;
+    template class BasicBPlusTree<GenericKey<32>, GenericComparator<32>, 65536>;
+    template class BasicBPlusTree<GenericKey<64>, GenericComparator<64>, 4096>;
+    template class BasicBPlusTree<GenericKey<64>, GenericComparator<64>, 8192>;
+    template class BasicBPlusTree<GenericKey<64>, GenericComparator<64>, 16384>;
+    template class BasicBPlusTree<GenericKey<64>, GenericComparator<64>, 65536>;
+}
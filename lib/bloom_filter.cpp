@@ -0,0 +1,81 @@
+#include "../include/bloom_filter.h"
+
+#include <cstring> // memcpy
+#include "../include/index_key.h"
+
+namespace minidb
+{
+    uint64_t BloomFilter::Hash(std::string_view key)
+    {
+        // Word at a time like GenericHash, tail zero-padded, length mixed in
+        uint64_t hash = key.size();
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= key.size(); i += sizeof(uint64_t))
+        {
+            uint64_t word;
+            memcpy(&word, key.data() + i, sizeof(word));
+            hash = (hash ^ word) * 0x9e3779b97f4a7c15ull;
+            hash ^= hash >> 29;
+        }
+        if (i < key.size())
+        {
+            uint64_t word = 0;
+            memcpy(&word, key.data() + i, key.size() - i);
+            hash = (hash ^ word) * 0x9e3779b97f4a7c15ull;
+            hash ^= hash >> 29;
+        }
+        return HashMix64(hash);
+    }
+
+    std::string BloomFilter::Build(const std::vector<uint64_t> &hashes, int bits_per_key)
+    {
+        // k = bits_per_key * ln 2 minimizes false positives; blocking favours a slightly smaller k
+        int probes = bits_per_key * 69 / 100;
+        probes = probes < 1 ? 1 : (probes > 16 ? 16 : probes);
+
+        uint64_t bits = static_cast<uint64_t>(hashes.size()) * bits_per_key;
+        uint64_t blocks = (bits + BLOCK_BYTES * 8 - 1) / (BLOCK_BYTES * 8);
+        blocks = blocks == 0 ? 1 : blocks;
+
+        std::string filter(blocks * BLOCK_BYTES + 1, '\0');
+        for (uint64_t hash : hashes)
+        {
+            char *block = &filter[(hash >> 32) % blocks * BLOCK_BYTES];
+            uint32_t probe = static_cast<uint32_t>(hash);
+            uint32_t delta = (probe >> 17) | (probe << 15);
+            for (int i = 0; i < probes; i++)
+            {
+                uint32_t bit = probe % (BLOCK_BYTES * 8);
+                block[bit / 8] |= static_cast<char>(1 << (bit % 8));
+                probe += delta;
+            }
+        }
+        filter.back() = static_cast<char>(probes);
+        return filter;
+    }
+
+    bool BloomFilter::MayContain(std::string_view filter, uint64_t hash)
+    {
+        if (filter.size() < BLOCK_BYTES + 1 || (filter.size() - 1) % BLOCK_BYTES != 0)
+        {
+            return true;
+        }
+        uint64_t blocks = (filter.size() - 1) / BLOCK_BYTES;
+        int probes = static_cast<unsigned char>(filter.back());
+
+        const char *block = filter.data() + (hash >> 32) % blocks * BLOCK_BYTES;
+        uint32_t probe = static_cast<uint32_t>(hash);
+        uint32_t delta = (probe >> 17) | (probe << 15);
+        for (int i = 0; i < probes; i++)
+        {
+            uint32_t bit = probe % (BLOCK_BYTES * 8);
+            if ((block[bit / 8] & (1 << (bit % 8))) == 0)
+            {
+                return false;
+            }
+            probe += delta;
+        }
+        return true;
+    }
+
+} // namespace minidb
@@ -0,0 +1,28 @@
+#include "../include/buffer_access_strategy.h"
+
+namespace minidb
+{
+    std::atomic<uint64_t> BufferAccessStrategy::next_id_{1};
+
+    BufferAccessStrategy::BufferAccessStrategy(AccessType type, size_t ring_size)
+        : type_(type), ring_size_(ring_size),
+          id_(next_id_.fetch_add(1, std::memory_order_relaxed))
+    {
+    }
+
+    size_t BufferAccessStrategy::DefaultRingSize(AccessType type, int32_t page_size)
+    {
+        switch (type)
+        {
+        case AccessType::BULK_READ:
+        case AccessType::VACUUM:
+            return (256 * 1024) / page_size;
+        case AccessType::BULK_WRITE:
+            return (16 * 1024 * 1024) / page_size;
+        case AccessType::NORMAL:
+        default:
+            return 0;
+        }
+    }
+
+} // namespace minidb
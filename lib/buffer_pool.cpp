@@ -1,143 +1,1369 @@
 #include "../include/buffer_pool.h"
 
+#include <algorithm> // std::sort, std::min, std::max, std::find_if
+#include <climits>   // IOV_MAX
+#include <new>       // std::align_val_t
+#include "../include/async_context.h"
+
 namespace minidb
 {
-    buffer_pool::buffer_pool(int frames, DiskManager *dm)
-        : pool_size_(frames), disk_manager_(dm), pages_(frames)
+    template <int32_t PageSize>
+    basic_buffer_pool<PageSize>::basic_buffer_pool(int frames, BasicDiskManager<PageSize> *dm, ReplacerPolicy policy,
+                                                   bool huge_pages)
+        : arena_(frames, huge_pages), replacer_(MakeReplacer(policy, frames)), pool_size_(frames), disk_manager_(dm),
+          prefetched_(frames, false), frame_ring_(frames, 0)
     {
+        pages_.reserve(frames);
         for (int i = 0; i < frames; i++)
         {
+            pages_.emplace_back(arena_.GetFrame(i));
             free_list.push_front(i);
         }
     }
 
-    Page *buffer_pool::FetchPage(page_id_t page_id)
+    template <int32_t PageSize>
+    basic_buffer_pool<PageSize>::~basic_buffer_pool()
     {
-        // If cache hit
-        if (page_table_.find(page_id) != page_table_.end())
         {
-            // Get page and pin for use
-            Page *page = &pages_[page_table_[page_id]];
+            std::lock_guard<std::mutex> guard(prefetch_latch_);
+            prefetch_stop_ = true;
+        }
+        prefetch_cv_.notify_all();
+        if (prefetch_thread_.joinable())
+        {
+            prefetch_thread_.join();
+        }
+    }
+
+    template <int32_t PageSize>
+    BasicPage<PageSize> *basic_buffer_pool<PageSize>::FetchPage(page_id_t page_id, BufferAccessStrategy *strategy)
+    {
+        if (strategy != nullptr && strategy->GetType() == AccessType::NORMAL)
+        {
+            strategy = nullptr;
+        }
+
+        std::unique_lock<std::mutex> lock(latch_);
+        TrackSequential(page_id);
+
+        // Get page and pin for use
+        auto pin_hit = [&](frame_id_t frame_id)
+        {
+            BasicPage<PageSize> *page = &pages_[frame_id];
             page->IncrementPinCount();
+            hits_.Add();
+            if (prefetched_[frame_id])
+            {
+                prefetched_[frame_id] = false;
+                read_ahead_stats_.prefetch_hits++;
+            }
 
-            // Update LRU
-            buffer_pool::UpdateLRU(page_table_[page_id]);
+            // Update replacer. A normal access takes a ring frame into the shared pool; strategy
+            // hits on ring frames are not recorded, so the scan never looks hot
+            if (strategy == nullptr)
+            {
+                frame_ring_[frame_id] = 0;
+            }
+            if (frame_ring_[frame_id] == 0)
+            {
+                replacer_->RecordAccess(frame_id, page_id);
+            }
+            replacer_->SetEvictable(frame_id, false);
             return page;
+        };
+
+        // If cache hit
+        auto entry = page_table_.find(page_id);
+        if (entry != page_table_.end())
+        {
+            return pin_hit(entry->second);
         }
 
         // Get available frame_id for page from disk
         // If cache miss
-        // Get a frame if any are available in free list, else evict
+        // Get a frame from the strategy ring, or from the free list, else evict
+        ScopedLatency miss_latency(&fetch_miss_latency_);
         frame_id_t frame_id = 0;
-        if (!free_list.empty())
+        bool acquired =
+            strategy != nullptr ? AcquireRingFrame(strategy, &frame_id, lock) : AcquireFrame(&frame_id, lock);
+        if (!acquired)
         {
-            // Find free frame
-            frame_id = free_list.front();
-            free_list.pop_front();
+            pin_failures_.Add();
+            throw std::runtime_error("Failed to fetch page, No free and no victim");
         }
-        else // No free frame, evict page to free a frame
+
+        // Writing a dirty victim releases the latch, and another thread may have loaded the page
+        entry = page_table_.find(page_id);
+        if (entry != page_table_.end())
         {
-            bool foundVictim = FindVictim(&frame_id);
-            if (foundVictim)
-            {
-                Page victim = pages_[frame_id];
-                if (victim.IsDirty())
-                {
-                    FlushPage(victim.GetPageId());
-                    page_table_.erase(victim.GetPageId());
-                    pages_[frame_id].Reset();
-                    RemoveFromLRU(frame_id);
-                }
-            }
-            else
+            free_list.push_front(frame_id);
+            return pin_hit(entry->second);
+        }
+
+        // Read page straight into the (aligned) frame, from the compressed tier if it has it
+        try
+        {
+            BasicCompressedCache<PageSize> *cache = secondary_cache_.load(std::memory_order_acquire);
+            if (cache == nullptr || !cache->Get(page_id, pages_[frame_id].GetData()))
             {
-                throw std::runtime_error("Failed to fetch page, No free and no victim");
+                disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
             }
         }
-        // Read page into memory
-        char page_data[PAGE_SIZE] = {0};
-        disk_manager_->ReadPage(page_id, page_data);
+        catch (...)
+        {
+            pages_[frame_id].Reset();
+            free_list.push_front(frame_id);
+            throw;
+        }
 
-        // Overwrite free page in cache
         // Update Page settings
-        memcpy(pages_[frame_id].GetData(), page_data, PAGE_SIZE);
         pages_[frame_id].SetPageId(page_id);
         pages_[frame_id].IncrementPinCount();
+        misses_.Add();
 
         page_table_[page_id] = frame_id;
-        AddToLRU(frame_id);
+        DropPendingReads(page_id);
+        frame_ring_[frame_id] = strategy != nullptr ? strategy->id_ : 0;
+        replacer_->RecordAccess(frame_id, page_id);
+        replacer_->SetEvictable(frame_id, false);
         return &pages_[frame_id];
     }
 
-    Page *buffer_pool::NewPage(page_id_t *page_id)
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::FetchPages(const page_id_t *page_ids, size_t count, BasicPage<PageSize> **pages)
+    {
+        std::unique_lock<std::mutex> lock(latch_);
+
+        // Pin hits, remember misses with their position in the request
+        std::vector<std::pair<page_id_t, size_t>> misses;
+        std::vector<bool> hit(count, false);
+        for (size_t i = 0; i < count; i++)
+        {
+            auto entry = page_table_.find(page_ids[i]);
+            if (entry == page_table_.end())
+            {
+                misses.push_back({page_ids[i], i});
+                continue;
+            }
+            hit[i] = true;
+            pages[i] = &pages_[entry->second];
+            pages[i]->IncrementPinCount();
+            if (prefetched_[entry->second])
+            {
+                prefetched_[entry->second] = false;
+                read_ahead_stats_.prefetch_hits++;
+            }
+            frame_ring_[entry->second] = 0;
+            replacer_->RecordAccess(entry->second, page_ids[i]);
+            replacer_->SetEvictable(entry->second, false);
+        }
+        hits_.Add(count - misses.size());
+        if (misses.empty())
+        {
+            return;
+        }
+
+        // Unpins the hits again if the misses cannot be served
+        auto release_hits = [&]()
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                if (!hit[i])
+                {
+                    continue;
+                }
+                pages[i]->DecrementPinCount();
+                if (pages[i]->GetPinCount() == 0)
+                {
+                    replacer_->SetEvictable(page_table_[page_ids[i]], true);
+                }
+            }
+        };
+
+        // One frame per distinct missing page, reserved before any read
+        std::sort(misses.begin(), misses.end());
+        std::vector<page_id_t> miss_ids;
+        std::vector<frame_id_t> frames;
+        for (const auto &miss : misses)
+        {
+            if (!miss_ids.empty() && miss_ids.back() == miss.first)
+            {
+                continue;
+            }
+            frame_id_t frame_id = 0;
+            bool acquired = false;
+            try
+            {
+                acquired = AcquireFrame(&frame_id, lock);
+            }
+            catch (...)
+            {
+                for (frame_id_t reserved : frames)
+                {
+                    free_list.push_front(reserved);
+                }
+                release_hits();
+                throw;
+            }
+            if (!acquired)
+            {
+                for (frame_id_t reserved : frames)
+                {
+                    free_list.push_front(reserved);
+                }
+                release_hits();
+                pin_failures_.Add();
+                throw std::runtime_error("Failed to fetch pages, No free and no victim");
+            }
+            miss_ids.push_back(miss.first);
+            frames.push_back(frame_id);
+        }
+
+        // Writing dirty victims releases the latch: pages another thread loaded meanwhile give
+        // their reserved frame back and are pinned where they are
+        std::vector<bool> loaded(miss_ids.size(), false);
+        for (size_t i = 0; i < miss_ids.size(); i++)
+        {
+            if (page_table_.count(miss_ids[i]) != 0)
+            {
+                free_list.push_front(frames[i]);
+                frames[i] = INVALID_FRAME_ID;
+                loaded[i] = true;
+            }
+        }
+
+        // Take what the compressed tier has, then read runs of consecutive page IDs with one
+        // preadv each
+        page_id_t num_pages = disk_manager_->GetNumPages();
+        BasicCompressedCache<PageSize> *cache = secondary_cache_.load(std::memory_order_acquire);
+        try
+        {
+            for (size_t i = 0; cache != nullptr && i < miss_ids.size(); i++)
+            {
+                if (frames[i] != INVALID_FRAME_ID)
+                {
+                    loaded[i] = cache->Get(miss_ids[i], pages_[frames[i]].GetData());
+                }
+            }
+
+            std::vector<iovec> run;
+            size_t start = 0;
+            while (start < miss_ids.size())
+            {
+                if (loaded[start])
+                {
+                    start++;
+                    continue;
+                }
+                size_t end = start + 1;
+                while (end < miss_ids.size() && end - start < IOV_MAX && !loaded[end] &&
+                       miss_ids[end] == miss_ids[end - 1] + 1)
+                {
+                    end++;
+                }
+
+                if (miss_ids[start] < 0 || miss_ids[end - 1] >= num_pages)
+                {
+                    // Outside the file, keep FetchPage's behaviour for each page
+                    for (size_t i = start; i < end; i++)
+                    {
+                        disk_manager_->ReadPage(miss_ids[i], pages_[frames[i]].GetData());
+                    }
+                }
+                else
+                {
+                    run.clear();
+                    for (size_t i = start; i < end; i++)
+                    {
+                        run.push_back({pages_[frames[i]].GetData(), static_cast<size_t>(PageSize)});
+                    }
+                    disk_manager_->ReadPages(miss_ids[start], run.data(), run.size());
+                }
+                start = end;
+            }
+        }
+        catch (...)
+        {
+            for (frame_id_t frame_id : frames)
+            {
+                if (frame_id != INVALID_FRAME_ID)
+                {
+                    pages_[frame_id].Reset();
+                    free_list.push_front(frame_id);
+                }
+            }
+            release_hits();
+            throw;
+        }
+
+        // Map the frames and pin once per requested occurrence
+        for (size_t i = 0; i < miss_ids.size(); i++)
+        {
+            if (frames[i] == INVALID_FRAME_ID)
+            {
+                frame_id_t frame_id = page_table_[miss_ids[i]];
+                frame_ring_[frame_id] = 0;
+                replacer_->RecordAccess(frame_id, miss_ids[i]);
+                replacer_->SetEvictable(frame_id, false);
+                continue;
+            }
+            pages_[frames[i]].SetPageId(miss_ids[i]);
+            page_table_[miss_ids[i]] = frames[i];
+            DropPendingReads(miss_ids[i]);
+            frame_ring_[frames[i]] = 0;
+            replacer_->RecordAccess(frames[i], miss_ids[i]);
+            replacer_->SetEvictable(frames[i], false);
+        }
+        for (const auto &miss : misses)
+        {
+            pages[miss.second] = &pages_[page_table_[miss.first]];
+            pages[miss.second]->IncrementPinCount();
+        }
+        misses_.Add(misses.size());
+    }
+
+    template <int32_t PageSize>
+    BasicFetchAwaiter<PageSize> basic_buffer_pool<PageSize>::FetchPageAsync(page_id_t page_id,
+                                                                            BasicAsyncContext<PageSize> *context)
     {
-        // Get a frame
+        return BasicFetchAwaiter<PageSize>(this, page_id, context);
+    }
+
+    template <int32_t PageSize>
+    bool basic_buffer_pool<PageSize>::StartFetchAsync(page_id_t page_id, BasicFetchWaiter<PageSize> *waiter)
+    {
+        std::unique_lock<std::mutex> lock(latch_);
+
+        // Pins the page if resident, or joins the read someone already started
+        auto find_existing = [&](bool *suspend)
+        {
+            auto entry = page_table_.find(page_id);
+            if (entry != page_table_.end())
+            {
+                waiter->page = PinResident(entry->second, page_id);
+                hits_.Add();
+                *suspend = false;
+                return true;
+            }
+            auto read = async_reads_.find(page_id);
+            if (read != async_reads_.end())
+            {
+                waiter->next = read->second.waiters;
+                read->second.waiters = waiter;
+                coalesced_.Add();
+                *suspend = true;
+                return true;
+            }
+            return false;
+        };
+
+        bool suspend = false;
+        if (find_existing(&suspend))
+        {
+            return suspend;
+        }
+
         frame_id_t frame_id = 0;
-        if (!free_list.empty())
+        bool acquired = false;
+        try
+        {
+            acquired = AcquireFrame(&frame_id, lock);
+        }
+        catch (...)
+        {
+            waiter->error = std::current_exception();
+            return false;
+        }
+        if (!acquired)
+        {
+            pin_failures_.Add();
+            waiter->error = std::make_exception_ptr(std::runtime_error("Failed to fetch page, No free and no victim"));
+            return false;
+        }
+
+        // Writing a dirty victim releases the latch, and the page may have been loaded or requested
+        // meanwhile
+        if (find_existing(&suspend))
+        {
+            free_list.push_front(frame_id);
+            return suspend;
+        }
+        misses_.Add();
+
+        // The compressed tier and pages outside the file are served on the spot, as FetchPage does
+        BasicCompressedCache<PageSize> *cache = secondary_cache_.load(std::memory_order_acquire);
+        bool cached = false;
+        try
+        {
+            cached = cache != nullptr && cache->Get(page_id, pages_[frame_id].GetData());
+        }
+        catch (...)
+        {
+            pages_[frame_id].Reset();
+            free_list.push_front(frame_id);
+            waiter->error = std::current_exception();
+            return false;
+        }
+        if (cached || page_id < 0 || page_id >= disk_manager_->GetNumPages())
         {
-            // Find free frame
-            frame_id = free_list.front();
-            free_list.pop_front();
+            pages_[frame_id].SetPageId(page_id);
+            pages_[frame_id].IncrementPinCount();
+            page_table_[page_id] = frame_id;
+            DropPendingReads(page_id);
+            frame_ring_[frame_id] = 0;
+            replacer_->RecordAccess(frame_id, page_id);
+            replacer_->SetEvictable(frame_id, false);
+            waiter->page = &pages_[frame_id];
+            return false;
         }
-        else // No free frame, evict page to free a frame
+
+        waiter->next = nullptr;
+        async_reads_[page_id] = AsyncRead{frame_id, waiter, waiter->context, false};
+        waiter->context->QueueRead(page_id, pages_[frame_id].GetData());
+        return true;
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::FinishFetchAsync(page_id_t page_id, int32_t result)
+    {
+        BasicFetchWaiter<PageSize> *waiters = nullptr;
         {
-            bool foundVictim = FindVictim(&frame_id);
-            if (foundVictim)
+            std::lock_guard<std::mutex> guard(latch_);
+            auto entry = async_reads_.find(page_id);
+            AsyncRead &read = entry->second;
+            frame_id_t frame_id = read.frame_id;
+            waiters = read.waiters;
+
+            if (result < 0)
             {
-                Page victim = pages_[frame_id];
-                if (victim.IsDirty())
+                pages_[frame_id].Reset();
+                free_list.push_front(frame_id);
+                async_reads_.erase(entry);
+                std::exception_ptr error = std::make_exception_ptr(std::runtime_error(
+                    "Failed to read page " + std::to_string(page_id) + ": " + strerror(-result)));
+                for (BasicFetchWaiter<PageSize> *waiter = waiters; waiter != nullptr; waiter = waiter->next)
                 {
-                    FlushPage(victim.GetPageId());
+                    waiter->error = error;
+                }
+            }
+            else if (read.stale)
+            {
+                auto resident = page_table_.find(page_id);
+                if (resident == page_table_.end())
+                {
+                    // Loaded and evicted, or deleted, while the read ran: the data may predate a
+                    // write, so read it again
+                    read.stale = false;
+                    read.context->QueueRead(page_id, pages_[frame_id].GetData());
+                    return;
                 }
-                page_table_.erase(victim.GetPageId());
                 pages_[frame_id].Reset();
-                RemoveFromLRU(frame_id);
+                free_list.push_front(frame_id);
+                async_reads_.erase(entry);
+                for (BasicFetchWaiter<PageSize> *waiter = waiters; waiter != nullptr; waiter = waiter->next)
+                {
+                    waiter->page = PinResident(resident->second, page_id);
+                }
             }
             else
             {
-                throw std::runtime_error("Failed to create new page, No free and no victim");
+                // Short reads stop at the end of the file, whose unwritten tail reads as zeros
+                if (result < PageSize)
+                {
+                    memset(pages_[frame_id].GetData() + result, 0, PageSize - result);
+                }
+                BasicPage<PageSize> *page = &pages_[frame_id];
+                page->SetPageId(page_id);
+                page_table_[page_id] = frame_id;
+                frame_ring_[frame_id] = 0;
+                replacer_->RecordAccess(frame_id, page_id);
+                replacer_->SetEvictable(frame_id, false);
+                async_reads_.erase(entry);
+                for (BasicFetchWaiter<PageSize> *waiter = waiters; waiter != nullptr; waiter = waiter->next)
+                {
+                    page->IncrementPinCount();
+                    waiter->page = page;
+                }
             }
         }
+
+        // A posted coroutine may run and end on another thread at once, taking its waiter along
+        while (waiters != nullptr)
+        {
+            BasicFetchWaiter<PageSize> *next = waiters->next;
+            waiters->context->Post(waiters->handle);
+            waiters = next;
+        }
+    }
+
+    template <int32_t PageSize>
+    BasicPage<PageSize> *basic_buffer_pool<PageSize>::PinResident(frame_id_t frame_id, page_id_t page_id)
+    {
+        BasicPage<PageSize> *page = &pages_[frame_id];
+        page->IncrementPinCount();
+        if (prefetched_[frame_id])
+        {
+            prefetched_[frame_id] = false;
+            read_ahead_stats_.prefetch_hits++;
+        }
+        frame_ring_[frame_id] = 0;
+        replacer_->RecordAccess(frame_id, page_id);
+        replacer_->SetEvictable(frame_id, false);
+        return page;
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::DropPendingReads(page_id_t page_id)
+    {
+        prefetch_pending_.erase(page_id);
+        auto read = async_reads_.find(page_id);
+        if (read != async_reads_.end())
+        {
+            read->second.stale = true;
+        }
+    }
+
+    template <int32_t PageSize>
+    BasicPage<PageSize> *basic_buffer_pool<PageSize>::NewPage(page_id_t *page_id, BufferAccessStrategy *strategy)
+    {
+        if (strategy != nullptr && strategy->GetType() == AccessType::NORMAL)
+        {
+            strategy = nullptr;
+        }
+
+        std::unique_lock<std::mutex> lock(latch_);
+
+        // Get a frame before allocating so a full pool does not grow the file
+        frame_id_t frame_id = 0;
+        bool acquired =
+            strategy != nullptr ? AcquireRingFrame(strategy, &frame_id, lock) : AcquireFrame(&frame_id, lock);
+        if (!acquired)
+        {
+            pin_failures_.Add();
+            throw std::runtime_error("Failed to create new page, No free and no victim");
+        }
+
         // New page
-        *page_id = disk_manager_->AllocatePage();
+        try
+        {
+            *page_id = disk_manager_->AllocatePage();
+        }
+        catch (...)
+        {
+            free_list.push_front(frame_id);
+            throw;
+        }
+        BasicPage<PageSize> *page = InitNewFrame(frame_id, *page_id);
+        frame_ring_[frame_id] = strategy != nullptr ? strategy->id_ : 0;
+        return page;
+    }
+
+    template <int32_t PageSize>
+    BasicPage<PageSize> *basic_buffer_pool<PageSize>::InstallNewPage(page_id_t page_id)
+    {
+        std::unique_lock<std::mutex> lock(latch_);
 
+        frame_id_t frame_id = 0;
+        if (!AcquireFrame(&frame_id, lock))
+        {
+            pin_failures_.Add();
+            throw std::runtime_error("Failed to create new page, No free and no victim");
+        }
+        return InitNewFrame(frame_id, page_id);
+    }
+
+    template <int32_t PageSize>
+    BasicPage<PageSize> *basic_buffer_pool<PageSize>::InitNewFrame(frame_id_t frame_id, page_id_t page_id)
+    {
         // erase page from cache
         pages_[frame_id].Reset();
 
         // Setup new page
-        pages_[frame_id].SetPageId(*page_id); // ID
+        pages_[frame_id].SetPageId(page_id); // ID
 
-        // Update page table and LRU
-        page_table_[*page_id] = frame_id;
-        AddToLRU(frame_id);
+        // Update page table and replacer. A reused page ID must not be served from the compressed
+        // tier later
+        page_table_[page_id] = frame_id;
+        DropPendingReads(page_id);
+        EraseFromSecondary(page_id);
+        replacer_->RecordAccess(frame_id, page_id);
+        replacer_->SetEvictable(frame_id, false);
         pages_[frame_id].IncrementPinCount();
         return &pages_[frame_id];
     }
 
-    void buffer_pool::UnpinPage(page_id_t page_id, bool isDirty)
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::UnpinPage(page_id_t page_id, bool isDirty)
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+
+        auto entry = page_table_.find(page_id);
+        if (entry == page_table_.end())
+        {
+            return;
+        }
+
+        BasicPage<PageSize> &page = pages_[entry->second];
+        if (page.GetPinCount() > 0)
+        {
+            page.DecrementPinCount();
+            if (page.GetPinCount() == 0)
+            {
+                replacer_->SetEvictable(entry->second, true);
+            }
+        }
+        // A clean unpin must not hide another user's modification
+        if (isDirty)
+        {
+            page.SetDirty(true);
+        }
+    }
+
+    template <int32_t PageSize>
+    bool basic_buffer_pool<PageSize>::DeletePage(page_id_t page_id)
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+
+        auto entry = page_table_.find(page_id);
+        if (entry != page_table_.end())
+        {
+            frame_id_t frame_id = entry->second;
+            if (pages_[frame_id].GetPinCount() > 0)
+            {
+                return false;
+            }
+            replacer_->Remove(frame_id);
+            page_table_.erase(entry);
+            prefetched_[frame_id] = false;
+            frame_ring_[frame_id] = 0;
+            pages_[frame_id].Reset();
+            free_list.push_back(frame_id);
+        }
+
+        // Reads still in flight must not install the freed page
+        DropPendingReads(page_id);
+        EraseFromSecondary(page_id);
+        disk_manager_->DeallocatePage(page_id);
+        return true;
+    }
+
+    template <int32_t PageSize>
+    BasicReadPageGuard<PageSize> basic_buffer_pool<PageSize>::FetchPageRead(page_id_t page_id)
+    {
+        return BasicReadPageGuard<PageSize>(this, FetchPage(page_id));
+    }
+
+    template <int32_t PageSize>
+    BasicWritePageGuard<PageSize> basic_buffer_pool<PageSize>::FetchPageWrite(page_id_t page_id)
+    {
+        return BasicWritePageGuard<PageSize>(this, FetchPage(page_id));
+    }
+
+    template <int32_t PageSize>
+    BasicOptimisticPageGuard<PageSize> basic_buffer_pool<PageSize>::FetchPageOptimistic(page_id_t page_id)
+    {
+        return BasicOptimisticPageGuard<PageSize>(this, FetchPage(page_id));
+    }
+
+    template <int32_t PageSize>
+    BasicWritePageGuard<PageSize> basic_buffer_pool<PageSize>::NewPageGuarded(page_id_t *page_id)
+    {
+        return BasicWritePageGuard<PageSize>(this, NewPage(page_id));
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::FlushPage(page_id_t page_id)
+    {
+        // Pinned and written like a checkpoint of one page, so the log sync and the write happen
+        // without latch_ and under the page's shared latch
+        std::vector<WriteBackFrame> frames;
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            auto entry = page_table_.find(page_id);
+            if (entry == page_table_.end())
+            {
+                return;
+            }
+            PinForWriteBack(entry->second, &frames);
+        }
+
+        CheckpointOptions options;
+        options.sync = false;
+        WriteBack(&frames, options, nullptr);
+    }
+
+    template <int32_t PageSize>
+    bool basic_buffer_pool<PageSize>::WriteBackVictim(frame_id_t frame_id, std::unique_lock<std::mutex> &lock)
+    {
+        BasicPage<PageSize> &page = pages_[frame_id];
+        page_id_t page_id = page.GetPageId();
+        page.IncrementPinCount();
+        page.SetDirty(false);
+        lock.unlock();
+
+        // Never wait for the page latch: its holder pinned the page after the victim was chosen and
+        // may itself be waiting for this thread. The victim is given up instead
+        bool written = false;
+        std::exception_ptr error;
+        if (page.GetLatch().TryLockShared())
+        {
+            try
+            {
+                // Write-ahead rule: the log describing the page goes first
+                LogManager *log_manager = log_manager_.load(std::memory_order_acquire);
+                if (log_manager != nullptr)
+                {
+                    log_manager->Flush(page.GetLSN());
+                }
+                disk_manager_->WritePage(page_id, page.GetData());
+                written = true;
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+            page.GetLatch().UnlockShared();
+        }
+        if (written)
+        {
+            writebacks_.Add();
+            EraseFromSecondary(page_id);
+        }
+
+        lock.lock();
+        page.DecrementPinCount();
+        if (!written)
+        {
+            page.SetDirty(true);
+        }
+        if (error)
+        {
+            if (page.GetPinCount() == 0)
+            {
+                replacer_->RecordAccess(frame_id, page_id);
+                replacer_->SetEvictable(frame_id, true);
+            }
+            std::rethrow_exception(error);
+        }
+        return written && page.GetPinCount() == 0 && !page.IsDirty();
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::FlushAllPages()
+    {
+        Checkpoint();
+    }
+
+    template <int32_t PageSize>
+    WriteBackResult basic_buffer_pool<PageSize>::Checkpoint(const CheckpointOptions &options)
+    {
+        std::vector<WriteBackFrame> frames;
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            for (size_t i = 0; i < pool_size_; i++)
+            {
+                if (pages_[i].GetPageId() != INVALID_PAGE_ID && pages_[i].IsDirty())
+                {
+                    PinForWriteBack(static_cast<frame_id_t>(i), &frames);
+                }
+            }
+        }
+
+        RateLimiter limiter(options.max_bytes_per_sec);
+        return WriteBack(&frames, options, &limiter);
+    }
+
+    template <int32_t PageSize>
+    WriteBackResult basic_buffer_pool<PageSize>::CleanCandidates(size_t count, RateLimiter *limiter)
+    {
+        std::vector<WriteBackFrame> frames;
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            std::vector<frame_id_t> candidates;
+            replacer_->GetCandidates(count, &candidates);
+            for (frame_id_t frame_id : candidates)
+            {
+                if (pages_[frame_id].IsDirty())
+                {
+                    PinForWriteBack(frame_id, &frames);
+                }
+            }
+        }
+
+        CheckpointOptions options;
+        options.sync = false;
+        return WriteBack(&frames, options, limiter);
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::PinForWriteBack(frame_id_t frame_id, std::vector<WriteBackFrame> *frames)
+    {
+        BasicPage<PageSize> &page = pages_[frame_id];
+        page.IncrementPinCount();
+        replacer_->SetEvictable(frame_id, false);
+        page.SetDirty(false);
+        frames->push_back({page.GetPageId(), frame_id});
+    }
+
+    template <int32_t PageSize>
+    WriteBackResult basic_buffer_pool<PageSize>::WriteBack(std::vector<WriteBackFrame> *frames,
+                                                           const CheckpointOptions &options, RateLimiter *limiter)
+    {
+        WriteBackResult result;
+        if (frames->empty())
+        {
+            return result;
+        }
+
+        std::sort(frames->begin(), frames->end(), [](const WriteBackFrame &a, const WriteBackFrame &b)
+                  { return a.page_id < b.page_id; });
+        size_t max_run = std::max<size_t>(1, std::min<size_t>(options.max_pages_per_write, IOV_MAX));
+
+        try
+        {
+            LogManager *log_manager = log_manager_.load(std::memory_order_acquire);
+            std::vector<iovec> run;
+            size_t pages_since_sync = 0;
+            size_t start = 0;
+            while (start < frames->size())
+            {
+                // Extend the run while page IDs stay consecutive
+                size_t end = start + 1;
+                while (end < frames->size() && end - start < max_run &&
+                       (*frames)[end].page_id == (*frames)[end - 1].page_id + 1)
+                {
+                    end++;
+                }
+
+                // Shared latches keep writers out while frames go to disk. Only the first is waited
+                // for; a write-latched frame later in the run ends it early, so write-back never
+                // waits while holding a latch and cannot deadlock with a writer holding several
+                pages_[(*frames)[start].frame_id].GetLatch().LockShared();
+                size_t latched = start + 1;
+                while (latched < end && pages_[(*frames)[latched].frame_id].GetLatch().TryLockShared())
+                {
+                    latched++;
+                }
+                end = latched;
+
+                run.clear();
+                try
+                {
+                    // Write-ahead rule, one log flush per run. The LSNs are read under the latches,
+                    // so no update the log does not cover yet can slip in before the write
+                    lsn_t max_lsn = INVALID_LSN;
+                    for (size_t i = start; i < end; i++)
+                    {
+                        BasicPage<PageSize> &page = pages_[(*frames)[i].frame_id];
+                        max_lsn = std::max(max_lsn, page.GetLSN());
+                        run.push_back({page.GetData(), static_cast<size_t>(PageSize)});
+                    }
+                    if (log_manager != nullptr)
+                    {
+                        log_manager->Flush(max_lsn);
+                    }
+                    disk_manager_->WritePages((*frames)[start].page_id, run.data(), run.size());
+                }
+                catch (...)
+                {
+                    UnlatchRun(*frames, start, end);
+                    throw;
+                }
+                UnlatchRun(*frames, start, end);
+                if (limiter != nullptr)
+                {
+                    limiter->Acquire(run.size() * PageSize);
+                }
+                result.write_calls++;
+                result.pages_written += run.size();
+                writebacks_.Add(run.size());
+                for (size_t i = start; i < end; i++)
+                {
+                    EraseFromSecondary((*frames)[i].page_id);
+                }
+                pages_since_sync += run.size();
+
+                if (options.sync && options.pages_per_sync > 0 && pages_since_sync >= options.pages_per_sync)
+                {
+                    disk_manager_->Sync();
+                    result.syncs++;
+                    pages_since_sync = 0;
+                }
+                start = end;
+            }
+            if (options.sync && pages_since_sync > 0)
+            {
+                disk_manager_->Sync();
+                result.syncs++;
+            }
+        }
+        catch (...)
+        {
+            UnpinAfterWriteBack(*frames, true);
+            throw;
+        }
+
+        UnpinAfterWriteBack(*frames, false);
+        return result;
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::UnlatchRun(const std::vector<WriteBackFrame> &frames, size_t start, size_t end)
+    {
+        for (size_t i = start; i < end; i++)
+        {
+            pages_[frames[i].frame_id].GetLatch().UnlockShared();
+        }
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::UnpinAfterWriteBack(const std::vector<WriteBackFrame> &frames, bool redirty)
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        for (const WriteBackFrame &frame : frames)
+        {
+            BasicPage<PageSize> &page = pages_[frame.frame_id];
+            if (redirty)
+            {
+                page.SetDirty(true);
+            }
+            page.DecrementPinCount();
+            if (page.GetPinCount() == 0)
+            {
+                replacer_->SetEvictable(frame.frame_id, true);
+            }
+        }
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::Prefetch(page_id_t first, size_t count)
+    {
+        if (count > 0)
+        {
+            QueuePrefetch(first, count);
+        }
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::SetReadAhead(const ReadAheadOptions &options)
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        read_ahead_ = options;
+        read_ahead_window_ = std::max<size_t>(1, options.initial_window);
+        read_ahead_next_ = INVALID_PAGE_ID;
+    }
+
+    template <int32_t PageSize>
+    ReadAheadStats basic_buffer_pool<PageSize>::GetReadAheadStats()
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        return read_ahead_stats_;
+    }
+
+    template <int32_t PageSize>
+    BufferPoolStats basic_buffer_pool<PageSize>::GetStats()
+    {
+        BufferPoolStats stats;
+        stats.hits = hits_.Load();
+        stats.misses = misses_.Load();
+        stats.evictions = evictions_.Load();
+        stats.dirty_evictions = dirty_evictions_.Load();
+        stats.writebacks = writebacks_.Load();
+        stats.pin_failures = pin_failures_.Load();
+        stats.coalesced_misses = coalesced_.Load();
+        stats.fetch_miss_latency = fetch_miss_latency_.Snapshot();
+        std::lock_guard<std::mutex> guard(latch_);
+        stats.free_frames = free_list.size();
+        return stats;
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::WaitForPrefetch()
+    {
+        std::unique_lock<std::mutex> lock(prefetch_latch_);
+        prefetch_cv_.wait(lock, [this]()
+                          { return prefetch_queue_.empty() && prefetch_active_ == 0; });
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::TrackSequential(page_id_t page_id)
+    {
+        bool sequential = last_fetched_ != INVALID_PAGE_ID && page_id == last_fetched_ + 1;
+        last_fetched_ = page_id;
+        if (!read_ahead_.enabled)
+        {
+            return;
+        }
+        if (!sequential)
+        {
+            read_ahead_window_ = std::max<size_t>(1, read_ahead_.initial_window);
+            read_ahead_next_ = INVALID_PAGE_ID;
+            return;
+        }
+
+        // Start a stream, or restart one the reader overtook
+        if (read_ahead_next_ == INVALID_PAGE_ID || read_ahead_next_ <= page_id)
+        {
+            read_ahead_next_ = page_id + 1;
+        }
+
+        // Issue the next window once half of the pages already requested are consumed
+        size_t ahead = static_cast<size_t>(read_ahead_next_ - page_id - 1);
+        page_id_t num_pages = disk_manager_->GetNumPages();
+        if (ahead <= read_ahead_window_ / 2 && read_ahead_next_ < num_pages)
+        {
+            size_t count = std::min<size_t>(read_ahead_window_, num_pages - read_ahead_next_);
+            QueuePrefetch(read_ahead_next_, count);
+            read_ahead_next_ += static_cast<page_id_t>(count);
+            read_ahead_stats_.windows_issued++;
+            read_ahead_window_ = std::min(read_ahead_window_ * 2, std::max<size_t>(1, read_ahead_.max_window));
+        }
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::QueuePrefetch(page_id_t first, size_t count)
     {
-        pages_[page_table_[page_id]].DecrementPinCount();
-        pages_[page_table_[page_id]].SetDirty(isDirty);
+        {
+            std::lock_guard<std::mutex> guard(prefetch_latch_);
+            if (prefetch_stop_)
+            {
+                return;
+            }
+            if (!prefetch_thread_.joinable())
+            {
+                prefetch_thread_ = std::thread(&basic_buffer_pool::RunPrefetcher, this);
+            }
+            prefetch_queue_.push_back({first, count});
+        }
+        prefetch_cv_.notify_all();
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::RunPrefetcher()
+    {
+        // Requests are read in chunks through one aligned scratch buffer
+        const size_t chunk_pages = 64;
+        char *buffer = static_cast<char *>(operator new[](chunk_pages * PageSize, std::align_val_t(PAGE_ALIGNMENT)));
+
+        std::unique_lock<std::mutex> lock(prefetch_latch_);
+        while (true)
+        {
+            prefetch_cv_.wait(lock, [this]()
+                              { return prefetch_stop_ || !prefetch_queue_.empty(); });
+            if (prefetch_stop_)
+            {
+                break;
+            }
+            auto request = prefetch_queue_.front();
+            prefetch_queue_.pop_front();
+            prefetch_active_++;
+            lock.unlock();
+
+            for (size_t done = 0; done < request.second; done += chunk_pages)
+            {
+                LoadPrefetch(request.first + static_cast<page_id_t>(done),
+                             std::min(chunk_pages, request.second - done), buffer);
+            }
+
+            lock.lock();
+            prefetch_active_--;
+            prefetch_cv_.notify_all();
+        }
+
+        operator delete[](buffer, std::align_val_t(PAGE_ALIGNMENT));
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::LoadPrefetch(page_id_t first, size_t count, char *buffer)
+    {
+        page_id_t num_pages = disk_manager_->GetNumPages();
+        if (first < 0 || first >= num_pages)
+        {
+            return;
+        }
+        count = std::min<size_t>(count, num_pages - first);
+
+        // Claim the pages that are neither resident nor already being read
+        std::vector<bool> wanted(count, false);
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            for (size_t i = 0; i < count; i++)
+            {
+                page_id_t page_id = first + static_cast<page_id_t>(i);
+                if (page_table_.count(page_id) == 0 && async_reads_.count(page_id) == 0 &&
+                    prefetch_pending_.insert(page_id).second)
+                {
+                    wanted[i] = true;
+                }
+            }
+        }
+
+        // One vectored read per run of wanted pages, without the latch
+        bool read_ok = true;
+        std::vector<iovec> run;
+        for (size_t i = 0; i < count && read_ok;)
+        {
+            if (!wanted[i])
+            {
+                i++;
+                continue;
+            }
+            size_t start = i;
+            run.clear();
+            for (; i < count && wanted[i]; i++)
+            {
+                run.push_back({buffer + i * PageSize, static_cast<size_t>(PageSize)});
+            }
+            try
+            {
+                disk_manager_->ReadPages(first + static_cast<page_id_t>(start), run.data(), run.size());
+            }
+            catch (const std::exception &)
+            {
+                // Prefetch is only a hint, the reader will hit the error itself
+                read_ok = false;
+            }
+        }
+
+        // Install pages nobody loaded or changed meanwhile, unpinned and ready for eviction. The
+        // frame is taken first: taking it may release the latch, and the checks must follow that
+        std::unique_lock<std::mutex> lock(latch_);
+        for (size_t i = 0; i < count; i++)
+        {
+            if (!wanted[i])
+            {
+                continue;
+            }
+            page_id_t page_id = first + static_cast<page_id_t>(i);
+            frame_id_t frame_id = 0;
+            bool acquired = false;
+            try
+            {
+                // Prefetch is only a hint: it takes free frames and clean victims, never pays for a
+                // write, and gives up on any error
+                acquired = read_ok && AcquireFrame(&frame_id, lock, false);
+            }
+            catch (const std::exception &)
+            {
+                acquired = false;
+            }
+            if (prefetch_pending_.erase(page_id) == 0 || page_table_.count(page_id) != 0)
+            {
+                if (acquired)
+                {
+                    free_list.push_front(frame_id);
+                }
+                continue;
+            }
+            if (!acquired)
+            {
+                continue;
+            }
+            memcpy(pages_[frame_id].GetData(), buffer + i * PageSize, PageSize);
+            pages_[frame_id].SetPageId(page_id);
+            page_table_[page_id] = frame_id;
+            DropPendingReads(page_id);
+            replacer_->RecordAccess(frame_id, page_id);
+            replacer_->SetEvictable(frame_id, true);
+            prefetched_[frame_id] = true;
+            read_ahead_stats_.pages_prefetched++;
+        }
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::SetLogManager(LogManager *log_manager)
+    {
+        log_manager_.store(log_manager, std::memory_order_release);
+    }
+
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::SetSecondaryCache(BasicCompressedCache<PageSize> *cache)
+    {
+        secondary_cache_.store(cache, std::memory_order_release);
     }
 
-    void buffer_pool::FlushPage(page_id_t page_id)
+    template <int32_t PageSize>
+    void basic_buffer_pool<PageSize>::EraseFromSecondary(page_id_t page_id)
     {
-        disk_manager_->WritePage(page_id, pages_[page_table_[page_id]].GetData());
-        pages_[page_table_[page_id]].SetDirty(false);
+        BasicCompressedCache<PageSize> *cache = secondary_cache_.load(std::memory_order_acquire);
+        if (cache != nullptr)
+        {
+            cache->Erase(page_id);
+        }
     }
 
-    void buffer_pool::FlushAllPages()
+    template <int32_t PageSize>
+    bool basic_buffer_pool<PageSize>::IsResident(page_id_t page_id)
     {
-        for (size_t i = 0; i < pool_size_; i++)
+        std::lock_guard<std::mutex> guard(latch_);
+        return page_table_.count(page_id) != 0;
+    }
+
+    template <int32_t PageSize>
+    std::vector<iovec> basic_buffer_pool<PageSize>::GetFrameBuffers()
+    {
+        std::vector<iovec> buffers;
+        buffers.reserve(pool_size_);
+        for (BasicPage<PageSize> &page : pages_)
+        {
+            buffers.push_back({page.GetData(), static_cast<size_t>(PageSize)});
+        }
+        return buffers;
+    }
+
+    template <int32_t PageSize>
+    bool basic_buffer_pool<PageSize>::AcquireFrame(frame_id_t *frame_id_ptr, std::unique_lock<std::mutex> &lock,
+                                                   bool write_dirty)
+    {
+        // Eviction candidates looked at for a clean victim
+        const size_t clean_candidates = 16;
+
+        // A dirty victim taken back while it was written is passed over for the next one
+        for (size_t attempt = 0; attempt <= pool_size_; attempt++)
         {
-            Page page = pages_.at(i);
-            if (page.GetPageId() != INVALID_PAGE_ID)
+            if (!free_list.empty())
             {
-                page_id_t page_id = page.GetPageId();
-                disk_manager_->WritePage(page_id, pages_[page_table_[page_id]].GetData());
-                pages_[page_table_[page_id]].SetDirty(false);
+                // Find free frame
+                *frame_id_ptr = free_list.front();
+                free_list.pop_front();
+                return true;
+            }
+
+            // No free frame, evict page to free a frame
+            if (write_dirty)
+            {
+                if (!replacer_->Evict(frame_id_ptr))
+                {
+                    return false;
+                }
+            }
+            else
+            {
+                std::vector<frame_id_t> candidates;
+                replacer_->GetCandidates(clean_candidates, &candidates);
+                auto clean = std::find_if(candidates.begin(), candidates.end(), [&](frame_id_t frame_id)
+                                          { return !pages_[frame_id].IsDirty(); });
+                if (clean == candidates.end())
+                {
+                    return false;
+                }
+                *frame_id_ptr = *clean;
+                replacer_->Remove(*frame_id_ptr);
+            }
+
+            BasicPage<PageSize> &victim = pages_[*frame_id_ptr];
+            if (victim.IsDirty())
+            {
+                if (!WriteBackVictim(*frame_id_ptr, lock))
+                {
+                    if (victim.GetPinCount() == 0)
+                    {
+                        replacer_->RecordAccess(*frame_id_ptr, victim.GetPageId());
+                        replacer_->SetEvictable(*frame_id_ptr, true);
+                    }
+                    continue;
+                }
+                // Fetched and released again during the write, so tracked once more
+                replacer_->Remove(*frame_id_ptr);
+                dirty_evictions_.Add();
             }
+
+            if (prefetched_[*frame_id_ptr])
+            {
+                prefetched_[*frame_id_ptr] = false;
+                read_ahead_stats_.prefetch_wasted++;
+            }
+            evictions_.Add();
+            page_id_t victim_id = victim.GetPageId();
+            page_table_.erase(victim_id);
+            frame_ring_[*frame_id_ptr] = 0;
+
+            // Now clean; the compressed tier may still hold this very version from an earlier
+            // eviction. Otherwise it is compressed without latch_: the frame is in neither the page
+            // table, the free list nor the replacer, so nobody else touches it, and a write-back of
+            // the page meanwhile voids the Put
+            BasicCompressedCache<PageSize> *cache = secondary_cache_.load(std::memory_order_acquire);
+            if (cache != nullptr && !cache->Touch(victim_id))
+            {
+                uint64_t ticket = cache->BeginPut(victim_id);
+                lock.unlock();
+                try
+                {
+                    cache->Put(victim_id, victim.GetData(), ticket);
+                }
+                catch (const std::exception &)
+                {
+                    // The tier only holds copies, the page is safe on disk
+                }
+                lock.lock();
+            }
+            victim.Reset();
+            return true;
         }
+        return false;
     }
 
+    template <int32_t PageSize>
+    bool basic_buffer_pool<PageSize>::AcquireRingFrame(BufferAccessStrategy *strategy, frame_id_t *frame_id_ptr,
+                                                       std::unique_lock<std::mutex> &lock)
+    {
+        // Like PostgreSQL, a ring never takes more than an eighth of the pool
+        size_t requested = strategy->ring_size_ != 0 ? strategy->ring_size_
+                                                      : BufferAccessStrategy::DefaultRingSize(strategy->type_, PageSize);
+        size_t ring_size = std::min(std::max<size_t>(1, requested), std::max<size_t>(1, pool_size_ / 8));
+        if (strategy->ring_.size() != ring_size)
+        {
+            strategy->ring_.assign(ring_size, INVALID_FRAME_ID);
+            strategy->current_ = 0;
+        }
+
+        frame_id_t &slot = strategy->ring_[strategy->current_];
+        strategy->current_ = (strategy->current_ + 1) % ring_size;
+
+        // Recycle the slot's frame if the ring still owns it and nobody uses it
+        if (slot != INVALID_FRAME_ID && frame_ring_[slot] == strategy->id_ && pages_[slot].GetPinCount() == 0)
+        {
+            frame_id_t frame_id = slot;
+            BasicPage<PageSize> &page = pages_[frame_id];
+            // A bulk read leaves dirty frames to normal write-back rather than paying for the write
+            if (!page.IsDirty() || strategy->type_ != AccessType::BULK_READ)
+            {
+                bool reusable = true;
+                if (page.IsDirty())
+                {
+                    replacer_->SetEvictable(frame_id, false);
+                    reusable = WriteBackVictim(frame_id, lock) && frame_ring_[frame_id] == strategy->id_;
+                    if (!reusable && page.GetPinCount() == 0)
+                    {
+                        replacer_->SetEvictable(frame_id, true);
+                    }
+                }
+                if (reusable)
+                {
+                    replacer_->Remove(frame_id);
+                    page_table_.erase(page.GetPageId());
+                    page.Reset();
+                    prefetched_[frame_id] = false;
+                    frame_ring_[frame_id] = 0;
+                    *frame_id_ptr = frame_id;
+                    return true;
+                }
+            }
+            frame_ring_[frame_id] = 0;
+        }
+
+        // Ring not full yet, or the slot was taken away: grow the ring with a shared frame
+        if (!AcquireFrame(frame_id_ptr, lock))
+        {
+            return false;
+        }
+        slot = *frame_id_ptr;
+        return true;
+    }
+
+    template class basic_buffer_pool<4096>;
+    template class basic_buffer_pool<8192>;
+    template class basic_buffer_pool<16384>;
+    template class basic_buffer_pool<65536>;
+
 } // namespace minidb
@@ -0,0 +1,97 @@
+#include "../include/clock_replacer.h"
+
+namespace minidb
+{
+    ClockReplacer::ClockReplacer(size_t num_frames)
+        : state_(num_frames, 0)
+    {
+    }
+
+    void ClockReplacer::RecordAccess(frame_id_t frame_id, page_id_t)
+    {
+        state_[frame_id] |= TRACKED | REFERENCED;
+    }
+
+    void ClockReplacer::SetEvictable(frame_id_t frame_id, bool evictable)
+    {
+        uint8_t &state = state_[frame_id];
+        if (!(state & TRACKED))
+        {
+            return;
+        }
+        if (evictable && !(state & EVICTABLE))
+        {
+            state |= EVICTABLE;
+            evictable_count_++;
+        }
+        else if (!evictable && (state & EVICTABLE))
+        {
+            state &= ~EVICTABLE;
+            evictable_count_--;
+        }
+    }
+
+    bool ClockReplacer::Evict(frame_id_t *frame_id_ptr)
+    {
+        if (evictable_count_ == 0)
+        {
+            return false;
+        }
+
+        // At most two sweeps: the first clears every reference bit it passes
+        for (size_t step = 0; step < 2 * state_.size(); step++)
+        {
+            frame_id_t frame_id = static_cast<frame_id_t>(hand_);
+            hand_ = (hand_ + 1) % state_.size();
+
+            uint8_t &state = state_[frame_id];
+            if ((state & (TRACKED | EVICTABLE)) != (TRACKED | EVICTABLE))
+            {
+                continue;
+            }
+            if (state & REFERENCED)
+            {
+                state &= ~REFERENCED;
+                continue;
+            }
+
+            state = 0;
+            evictable_count_--;
+            *frame_id_ptr = frame_id;
+            return true;
+        }
+        return false;
+    }
+
+    void ClockReplacer::Remove(frame_id_t frame_id)
+    {
+        if (state_[frame_id] & EVICTABLE)
+        {
+            evictable_count_--;
+        }
+        state_[frame_id] = 0;
+    }
+
+    void ClockReplacer::GetCandidates(size_t count, std::vector<frame_id_t> *candidates)
+    {
+        // Unreferenced frames ahead of the hand go first, referenced ones after a full sweep
+        for (uint8_t referenced : {uint8_t(0), uint8_t(REFERENCED)})
+        {
+            for (size_t step = 0; step < state_.size() && count > 0; step++)
+            {
+                size_t frame_id = (hand_ + step) % state_.size();
+                if ((state_[frame_id] & (TRACKED | EVICTABLE | REFERENCED)) == (TRACKED | EVICTABLE | referenced))
+                {
+                    candidates->push_back(static_cast<frame_id_t>(frame_id));
+                    count--;
+                }
+            }
+        }
+    }
+
+    size_t ClockReplacer::Size()
+    {
+        return evictable_count_;
+    }
+
+} // namespace minidb
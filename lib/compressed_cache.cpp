@@ -0,0 +1,260 @@
+#include "../include/compressed_cache.h"
+
+#include <cstring>   // memcpy
+#include <stdexcept> // std::runtime_error
+#include <string>    // std::to_string
+
+namespace minidb
+{
+    template <int32_t PageSize>
+    BasicCompressedCache<PageSize>::BasicCompressedCache(uint64_t capacity_bytes)
+        : capacity_bytes_(capacity_bytes / SLAB_BYTES * SLAB_BYTES),
+          arena_(new char[capacity_bytes / SLAB_BYTES * SLAB_BYTES]), slabs_(capacity_bytes / SLAB_BYTES),
+          partial_(NUM_CLASSES, NO_SLAB)
+    {
+        for (size_t slab = slabs_.size(); slab > 0; slab--)
+        {
+            free_slabs_.push_back(static_cast<uint32_t>(slab - 1));
+        }
+        stats_.capacity_bytes = capacity_bytes_;
+    }
+
+    template <int32_t PageSize>
+    uint64_t BasicCompressedCache<PageSize>::BeginPut(page_id_t page_id)
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        pending_[page_id].count++;
+        return ++sequence_;
+    }
+
+    template <int32_t PageSize>
+    bool BasicCompressedCache<PageSize>::Put(page_id_t page_id, const char *data, uint64_t ticket)
+    {
+        // Compress before taking the latch. Pages that need more than MAX_STORED_BYTES fail
+        // inside the codec
+        char buffer[MAX_STORED_BYTES];
+        size_t size = LzCodec::Compress(data, PageSize, buffer, sizeof(buffer));
+
+        std::lock_guard<std::mutex> guard(latch_);
+        if (ticket != 0)
+        {
+            auto pending = pending_.find(page_id);
+            bool erased = pending != pending_.end() && pending->second.erased_at > ticket;
+            if (pending != pending_.end() && --pending->second.count == 0)
+            {
+                pending_.erase(pending);
+            }
+            if (erased)
+            {
+                stats_.invalidations++;
+                return false;
+            }
+        }
+
+        auto existing = entries_.find(page_id);
+        if (existing != entries_.end())
+        {
+            RemoveEntry(existing);
+        }
+        if (size == 0)
+        {
+            stats_.rejected++;
+            return false;
+        }
+
+        int size_class = static_cast<int>((size - 1) / CLASS_GRANULE);
+        uint32_t slab = 0;
+        uint16_t slot = 0;
+        if (!AllocateSlot(size_class, &slab, &slot))
+        {
+            stats_.rejected++;
+            return false;
+        }
+        memcpy(SlotData(slab, slot), buffer, size);
+
+        lru_.push_front(page_id);
+        entries_[page_id] = Entry{slab, slot, static_cast<uint32_t>(size), lru_.begin()};
+        stats_.stores++;
+        stats_.compressed_bytes += size;
+        return true;
+    }
+
+    template <int32_t PageSize>
+    bool BasicCompressedCache<PageSize>::Get(page_id_t page_id, char *data)
+    {
+        // Copy the block out, then decompress without the latch
+        char buffer[MAX_STORED_BYTES];
+        size_t size = 0;
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            auto entry = entries_.find(page_id);
+            if (entry == entries_.end())
+            {
+                stats_.misses++;
+                return false;
+            }
+            size = entry->second.size;
+            memcpy(buffer, SlotData(entry->second.slab, entry->second.slot), size);
+            stats_.hits++;
+        }
+
+        if (!LzCodec::Decompress(buffer, size, data, PageSize))
+        {
+            throw std::runtime_error("Corrupt compressed page " + std::to_string(page_id));
+        }
+        return true;
+    }
+
+    template <int32_t PageSize>
+    bool BasicCompressedCache<PageSize>::Touch(page_id_t page_id)
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        auto entry = entries_.find(page_id);
+        if (entry == entries_.end())
+        {
+            return false;
+        }
+        lru_.splice(lru_.begin(), lru_, entry->second.lru);
+        stats_.touches++;
+        return true;
+    }
+
+    template <int32_t PageSize>
+    void BasicCompressedCache<PageSize>::Erase(page_id_t page_id)
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        auto pending = pending_.find(page_id);
+        if (pending != pending_.end())
+        {
+            pending->second.erased_at = ++sequence_;
+        }
+        auto entry = entries_.find(page_id);
+        if (entry != entries_.end())
+        {
+            RemoveEntry(entry);
+            stats_.invalidations++;
+        }
+    }
+
+    template <int32_t PageSize>
+    CompressedCacheStats BasicCompressedCache<PageSize>::GetStats()
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        CompressedCacheStats stats = stats_;
+        stats.pages = entries_.size();
+        stats.slab_bytes = (slabs_.size() - free_slabs_.size()) * SLAB_BYTES;
+        return stats;
+    }
+
+    template <int32_t PageSize>
+    bool BasicCompressedCache<PageSize>::AllocateSlot(int size_class, uint32_t *slab_ptr, uint16_t *slot_ptr)
+    {
+        while (true)
+        {
+            // A slab of this class with room
+            uint32_t slab_id = partial_[size_class];
+            if (slab_id != NO_SLAB)
+            {
+                Slab &slab = slabs_[slab_id];
+                *slab_ptr = slab_id;
+                *slot_ptr = slab.free_slots.back();
+                slab.free_slots.pop_back();
+                slab.used++;
+                if (slab.free_slots.empty())
+                {
+                    UnlinkPartial(slab_id);
+                }
+                return true;
+            }
+
+            // An empty slab, carved into slots of this class
+            if (!free_slabs_.empty())
+            {
+                slab_id = free_slabs_.back();
+                free_slabs_.pop_back();
+                Slab &slab = slabs_[slab_id];
+                slab.size_class = size_class;
+                uint32_t slots = static_cast<uint32_t>(SLAB_BYTES / ClassSize(size_class));
+                for (uint32_t slot = slots; slot > 0; slot--)
+                {
+                    slab.free_slots.push_back(static_cast<uint16_t>(slot - 1));
+                }
+                LinkPartial(slab_id);
+                continue;
+            }
+
+            // Drop the oldest page. It frees a slot of its own class, and once a slab empties,
+            // a slab for any class
+            if (lru_.empty())
+            {
+                return false;
+            }
+            RemoveEntry(entries_.find(lru_.back()));
+            stats_.evictions++;
+        }
+    }
+
+    template <int32_t PageSize>
+    void BasicCompressedCache<PageSize>::RemoveEntry(typename std::unordered_map<page_id_t, Entry>::iterator entry)
+    {
+        uint32_t slab_id = entry->second.slab;
+        Slab &slab = slabs_[slab_id];
+        if (slab.free_slots.empty())
+        {
+            LinkPartial(slab_id);
+        }
+        slab.free_slots.push_back(entry->second.slot);
+        slab.used--;
+        if (slab.used == 0)
+        {
+            UnlinkPartial(slab_id);
+            slab.size_class = -1;
+            slab.free_slots.clear();
+            free_slabs_.push_back(slab_id);
+        }
+
+        stats_.compressed_bytes -= entry->second.size;
+        lru_.erase(entry->second.lru);
+        entries_.erase(entry);
+    }
+
+    template <int32_t PageSize>
+    void BasicCompressedCache<PageSize>::LinkPartial(uint32_t slab_id)
+    {
+        Slab &slab = slabs_[slab_id];
+        uint32_t &head = partial_[slab.size_class];
+        slab.prev = NO_SLAB;
+        slab.next = head;
+        if (head != NO_SLAB)
+        {
+            slabs_[head].prev = slab_id;
+        }
+        head = slab_id;
+    }
+
+    template <int32_t PageSize>
+    void BasicCompressedCache<PageSize>::UnlinkPartial(uint32_t slab_id)
+    {
+        Slab &slab = slabs_[slab_id];
+        if (slab.prev != NO_SLAB)
+        {
+            slabs_[slab.prev].next = slab.next;
+        }
+        else
+        {
+            partial_[slab.size_class] = slab.next;
+        }
+        if (slab.next != NO_SLAB)
+        {
+            slabs_[slab.next].prev = slab.prev;
+        }
+        slab.prev = NO_SLAB;
+        slab.next = NO_SLAB;
+    }
+
+    template class BasicCompressedCache<4096>;
+    template class BasicCompressedCache<8192>;
+    template class BasicCompressedCache<16384>;
+    template class BasicCompressedCache<65536>;
+
+} // namespace minidb
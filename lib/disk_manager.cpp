@@ -1,79 +1,764 @@
 #include "../include/disk_manager.h"
 
+#include <algorithm> // std::min, std::max
+#include <cerrno>    // errno
+#include <fcntl.h>   // open, O_DIRECT, fallocate
+#include <new>       // std::align_val_t
+#include <sys/stat.h> // fstat
+#include <unistd.h>  // pread, pwrite, fdatasync, ftruncate, close
+
 namespace minidb
 {
-    DiskManager::DiskManager(const std::string &db_file)
+    namespace
+    {
+        /// @brief Page-sized buffer aligned so O_DIRECT accepts it
+        template <int32_t PageSize>
+        struct alignas(PAGE_ALIGNMENT) AlignedPage
+        {
+            char data[PageSize];
+        };
+
+        /// @brief Zeroed page written over reused pages
+        template <int32_t PageSize>
+        const AlignedPage<PageSize> ZERO_PAGE = {};
+
+        /// @brief "MINI-DB\0" read as a little-endian integer
+        const uint64_t FILE_MAGIC = 0x0042442D494E494DULL;
+
+        /// @brief Bumped on incompatible layout changes
+        const uint32_t FILE_VERSION = 2;
+
+        /// @brief Smallest file extension, larger files grow by an eighth of their size up to
+        /// MAX_EXTENT_BYTES
+        const uint64_t MIN_EXTENT_BYTES = 1024 * 1024;
+        const uint64_t MAX_EXTENT_BYTES = 64 * 1024 * 1024;
+
+        /// @brief Start of physical page 0
+        struct FileHeader
+        {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t page_size;
+            uint64_t segment_bytes;
+            uint64_t page_count;
+            uint64_t free_pages;
+            uint64_t free_hint;
+            uint64_t file_pages;
+            /// @brief Zero in files written before reservations, read as page_count
+            uint64_t reserved_pages;
+        };
+
+        /// @brief Checks if a buffer can be handed to O_DIRECT as is
+        inline bool IsAligned(const char *buffer)
+        {
+            return reinterpret_cast<uintptr_t>(buffer) % PAGE_ALIGNMENT == 0;
+        }
+
+        /// @brief Aligned staging buffer for callers passing unaligned memory in O_DIRECT mode
+        template <int32_t PageSize>
+        inline char *BounceBuffer()
+        {
+            static thread_local AlignedPage<PageSize> buffer;
+            return buffer.data;
+        }
+    }
+
+    template <int32_t PageSize>
+    BasicDiskManager<PageSize>::BasicDiskManager(const std::string &db_file, bool direct_io,
+                                                 const StorageOptions &options)
+        : file_name_(db_file), direct_io_(direct_io), next_page_id_(0), segment_bytes_(options.segment_bytes),
+          segment_pages_(options.segment_bytes / PageSize), preallocate_(options.preallocate),
+          fds_(new std::atomic<int>[MAX_SEGMENTS])
+    {
+        if (segment_pages_ == 0 || segment_bytes_ % PageSize != 0)
+        {
+            throw std::runtime_error("Segment size must be a multiple of " + std::to_string(PageSize) + " bytes");
+        }
+        for (size_t i = 0; i < MAX_SEGMENTS; i++)
+        {
+            fds_[i].store(-1, std::memory_order_relaxed);
+        }
+
+        // Creates file if it does not exist
+        struct stat st;
+        if (fstat(SegmentFd(0), &st) != 0)
+        {
+            CloseSegments();
+            ThrowIOError("Failed to stat file");
+        }
+
+        std::lock_guard<std::mutex> guard(alloc_latch_);
+        if (st.st_size == 0)
+        {
+            // New database, header only
+            file_pages_ = 1;
+            header_dirty_ = true;
+            WriteMetadata();
+            return;
+        }
+
+        AlignedPage<PageSize> page;
+        ReadAt(0, page.data);
+        FileHeader header;
+        memcpy(&header, page.data, sizeof(header));
+        if (header.magic != FILE_MAGIC || header.version != FILE_VERSION ||
+            header.page_size != static_cast<uint32_t>(PageSize) || header.segment_bytes == 0 ||
+            header.segment_bytes % PageSize != 0)
+        {
+            CloseSegments();
+            throw std::runtime_error("Not a DB file with " + std::to_string(PageSize) + " byte pages: " + file_name_);
+        }
+        segment_bytes_ = header.segment_bytes;
+        segment_pages_ = header.segment_bytes / PageSize;
+        next_page_id_.store(static_cast<page_id_t>(header.page_count), std::memory_order_release);
+        free_pages_ = static_cast<page_id_t>(header.free_pages);
+        free_hint_ = static_cast<page_id_t>(header.free_hint);
+        file_pages_ = header.file_pages;
+        reserved_pages_ = static_cast<page_id_t>(std::max(header.reserved_pages, header.page_count));
+
+        // Not closed cleanly: pages past the count may have been handed out and written, so they
+        // stay allocated. At most one extension's worth, the reopen stays O(1)
+        page_id_t page_count = static_cast<page_id_t>(header.page_count);
+        if (reserved_pages_ > page_count)
+        {
+            for (page_id_t page_id = page_count; page_id < reserved_pages_; page_id++)
+            {
+                Bitmap &bitmap = GetBitmap(page_id / PAGES_PER_GROUP);
+                size_t bit = page_id % PAGES_PER_GROUP;
+                bitmap.data[bit / 8] |= static_cast<char>(1 << (bit % 8));
+                bitmap.dirty = true;
+            }
+            next_page_id_.store(reserved_pages_, std::memory_order_release);
+            header_dirty_ = true;
+        }
+    }
+
+    template <int32_t PageSize>
+    BasicDiskManager<PageSize>::~BasicDiskManager()
     {
-        db_file_.open(db_file, std::ios::in | std::ios::out | std::ios::binary);
+        std::lock_guard<std::mutex> guard(alloc_latch_);
+        try
+        {
+            // Closed cleanly, the page count is exact again
+            if (reserved_pages_ != next_page_id_.load(std::memory_order_acquire))
+            {
+                reserved_pages_ = next_page_id_.load(std::memory_order_acquire);
+                header_dirty_ = true;
+            }
+            WriteMetadata();
+        }
+        catch (const std::exception &)
+        {
+            // Nothing to report to from a destructor, Sync surfaces these errors
+        }
+        for (Bitmap &bitmap : bitmaps_)
+        {
+            if (bitmap.data != nullptr)
+            {
+                operator delete[](bitmap.data, std::align_val_t(PAGE_ALIGNMENT));
+            }
+        }
+        CloseSegments();
+    }
 
-        // If file is not open, then file does not exist
-        if (!db_file_.is_open())
+    template <int32_t PageSize>
+    int BasicDiskManager<PageSize>::SegmentFd(uint64_t segment)
+    {
+        if (segment >= MAX_SEGMENTS)
         {
-            // Creates file
-            db_file_.open(db_file, std::ios::out | std::ios::binary);
-            db_file_.close();
+            throw std::out_of_range("Segment " + std::to_string(segment) + " beyond limit of " + file_name_);
+        }
+        int fd = fds_[segment].load(std::memory_order_acquire);
+        if (fd >= 0)
+        {
+            return fd;
+        }
 
-            // Retry open
-            db_file_.open(db_file, std::ios::in | std::ios::out | std::ios::binary);
+        std::lock_guard<std::mutex> guard(segment_latch_);
+        fd = fds_[segment].load(std::memory_order_acquire);
+        if (fd >= 0)
+        {
+            return fd;
         }
 
-        if (!db_file_.is_open())
+        int flags = O_RDWR | O_CREAT;
+        if (direct_io_)
+        {
+            flags |= O_DIRECT;
+        }
+        std::string name = segment == 0 ? file_name_ : file_name_ + "." + std::to_string(segment);
+        fd = open(name.c_str(), flags, 0644);
+        if (fd < 0)
         {
-            throw std::runtime_error("Failed to open file " + db_file);
+            ThrowIOError("Failed to open segment " + std::to_string(segment) + " of");
         }
+        open_segments_.push_back(segment);
+        fds_[segment].store(fd, std::memory_order_release);
+        return fd;
+    }
+
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::LocatePage(page_id_t page_id, int *fd_ptr, off_t *offset_ptr)
+    {
+        uint64_t page_number = PhysicalPage(page_id);
+        *fd_ptr = SegmentFd(page_number / segment_pages_);
+        *offset_ptr = static_cast<off_t>(page_number % segment_pages_) * PageSize;
+    }
 
-        next_page_id_ = 0;
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::CloseSegments()
+    {
+        std::lock_guard<std::mutex> guard(segment_latch_);
+        for (uint64_t segment : open_segments_)
+        {
+            int fd = fds_[segment].exchange(-1);
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+        }
+        open_segments_.clear();
     }
 
-    DiskManager::~DiskManager()
+    template <int32_t PageSize>
+    std::vector<uint64_t> BasicDiskManager<PageSize>::GetOpenSegments()
     {
-        db_file_.close();
+        std::lock_guard<std::mutex> guard(segment_latch_);
+        return open_segments_;
     }
 
-    void DiskManager::ReadPage(page_id_t page_id, char *page_data)
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::ReadPage(page_id_t page_id, char *page_data)
     {
         // Validate that page_id request is valid
-        if (page_id < next_page_id_ && page_id >= 0)
+        if (page_id >= GetNumPages() || page_id < 0)
         {
-            // Seek to read position
-            int read_position = page_id * PAGE_SIZE;
-            db_file_.seekg(read_position, std::ios::beg);
+            return;
+        }
 
-            // Read file
-            db_file_.read(page_data, PAGE_SIZE);
-            std::cout << page_data << std::endl;
+        ScopedLatency latency(&read_page_latency_);
+        char *target = (direct_io_ && !IsAligned(page_data)) ? BounceBuffer<PageSize>() : page_data;
+        ReadAt(PhysicalPage(page_id), target);
+        if (target != page_data)
+        {
+            memcpy(page_data, target, PageSize);
         }
     }
 
-    void DiskManager::WritePage(page_id_t page_id, const char *page_data)
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::WritePage(page_id_t page_id, const char *page_data)
     {
         // Validate write position
-        if (page_id < next_page_id_ && page_id >= 0)
+        if (page_id >= GetNumPages() || page_id < 0)
+        {
+            return;
+        }
+
+        ScopedLatency latency(&write_page_latency_);
+        const char *source = page_data;
+        if (direct_io_ && !IsAligned(page_data))
+        {
+            memcpy(BounceBuffer<PageSize>(), page_data, PageSize);
+            source = BounceBuffer<PageSize>();
+        }
+        WriteAt(PhysicalPage(page_id), source);
+    }
+
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::ReadAt(uint64_t page_number, char *buffer)
+    {
+        int fd = SegmentFd(page_number / segment_pages_);
+        off_t offset = static_cast<off_t>(page_number % segment_pages_) * PageSize;
+
+        // pread may return short counts, the tail of a never-written page reads as zeros
+        size_t done = 0;
+        while (done < static_cast<size_t>(PageSize))
+        {
+            ssize_t n = pread(fd, buffer + done, PageSize - done, offset + done);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                ThrowIOError("Failed to read page " + std::to_string(page_number) + " of");
+            }
+            if (n == 0)
+            {
+                memset(buffer + done, 0, PageSize - done);
+                break;
+            }
+            done += n;
+        }
+        reads_.Add();
+        bytes_read_.Add(done);
+    }
+
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::WriteAt(uint64_t page_number, const char *buffer)
+    {
+        int fd = SegmentFd(page_number / segment_pages_);
+        off_t offset = static_cast<off_t>(page_number % segment_pages_) * PageSize;
+
+        size_t done = 0;
+        while (done < static_cast<size_t>(PageSize))
+        {
+            ssize_t n = pwrite(fd, buffer + done, PageSize - done, offset + done);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                ThrowIOError("Failed to write page " + std::to_string(page_number) + " of");
+            }
+            done += n;
+        }
+        writes_.Add();
+        bytes_written_.Add(done);
+    }
+
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::ReadPages(page_id_t first_page_id, const iovec *pages, size_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        if (first_page_id < 0 || first_page_id + static_cast<page_id_t>(count) > GetNumPages())
+        {
+            throw std::out_of_range("Invalid page range starting at " + std::to_string(first_page_id));
+        }
+
+        bool aligned = true;
+        for (size_t i = 0; i < count && direct_io_; i++)
+        {
+            aligned = aligned && IsAligned(static_cast<const char *>(pages[i].iov_base));
+        }
+
+        // Pages are only adjacent on disk within a bitmap group and a segment
+        for (size_t done = 0; done < count;)
+        {
+            page_id_t page_id = first_page_id + static_cast<page_id_t>(done);
+            size_t run = std::min<uint64_t>({count - done, static_cast<uint64_t>(PAGES_PER_GROUP - page_id % PAGES_PER_GROUP),
+                                             segment_pages_ - PhysicalPage(page_id) % segment_pages_});
+            int fd = -1;
+            off_t offset = 0;
+            LocatePage(page_id, &fd, &offset);
+
+            ssize_t n = -1;
+            if (aligned)
+            {
+                do
+                {
+                    n = preadv(fd, pages + done, static_cast<int>(run), offset);
+                } while (n < 0 && errno == EINTR);
+                if (n < 0)
+                {
+                    ThrowIOError("Failed to read pages at " + std::to_string(page_id));
+                }
+                reads_.Add();
+                bytes_read_.Add(n);
+            }
+
+            // Short vectored read (end of file, or unaligned O_DIRECT buffers), finish page by page
+            if (n != static_cast<ssize_t>(run) * PageSize)
+            {
+                for (size_t i = (n < 0 ? 0 : n / PageSize); i < run; i++)
+                {
+                    ReadPage(page_id + static_cast<page_id_t>(i), static_cast<char *>(pages[done + i].iov_base));
+                }
+            }
+            done += run;
+        }
+    }
+
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::WritePages(page_id_t first_page_id, const iovec *pages, size_t count)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        if (first_page_id < 0 || first_page_id + static_cast<page_id_t>(count) > GetNumPages())
+        {
+            throw std::out_of_range("Invalid page range starting at " + std::to_string(first_page_id));
+        }
+
+        bool aligned = true;
+        for (size_t i = 0; i < count && direct_io_; i++)
+        {
+            aligned = aligned && IsAligned(static_cast<const char *>(pages[i].iov_base));
+        }
+
+        for (size_t done = 0; done < count;)
+        {
+            page_id_t page_id = first_page_id + static_cast<page_id_t>(done);
+            size_t run = std::min<uint64_t>({count - done, static_cast<uint64_t>(PAGES_PER_GROUP - page_id % PAGES_PER_GROUP),
+                                             segment_pages_ - PhysicalPage(page_id) % segment_pages_});
+            int fd = -1;
+            off_t offset = 0;
+            LocatePage(page_id, &fd, &offset);
+
+            ssize_t n = -1;
+            if (aligned)
+            {
+                do
+                {
+                    n = pwritev(fd, pages + done, static_cast<int>(run), offset);
+                } while (n < 0 && errno == EINTR);
+                if (n < 0)
+                {
+                    ThrowIOError("Failed to write pages at " + std::to_string(page_id));
+                }
+                writes_.Add();
+                bytes_written_.Add(n);
+            }
+
+            // Short vectored write (or unaligned O_DIRECT buffers), finish page by page
+            if (n != static_cast<ssize_t>(run) * PageSize)
+            {
+                for (size_t i = (n < 0 ? 0 : n / PageSize); i < run; i++)
+                {
+                    WritePage(page_id + static_cast<page_id_t>(i),
+                              static_cast<const char *>(pages[done + i].iov_base));
+                }
+            }
+            done += run;
+        }
+    }
+
+    template <int32_t PageSize>
+    page_id_t BasicDiskManager<PageSize>::AllocatePage(bool zero)
+    {
+        std::lock_guard<std::mutex> guard(alloc_latch_);
+        header_dirty_ = true;
+
+        // Reuse freed pages first, they may still hold old contents
+        page_id_t page_id = INVALID_PAGE_ID;
+        if (ClaimFreePage(&page_id))
+        {
+            if (zero)
+            {
+                WriteAt(PhysicalPage(page_id), ZERO_PAGE<PageSize>.data);
+            }
+            return page_id;
+        }
+
+        // Append. Extended file space reads as zeros
+        page_id = next_page_id_.load(std::memory_order_acquire);
+        ExtendFile(PhysicalPage(page_id));
+        if (page_id >= reserved_pages_)
+        {
+            ReservePages(page_id);
+        }
+        Bitmap &bitmap = GetBitmap(page_id / PAGES_PER_GROUP);
+        size_t bit = page_id % PAGES_PER_GROUP;
+        bitmap.data[bit / 8] |= static_cast<char>(1 << (bit % 8));
+        bitmap.dirty = true;
+        next_page_id_.store(page_id + 1, std::memory_order_release);
+        return page_id;
+    }
+
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::DeallocatePage(page_id_t page_id)
+    {
+        if (page_id < 0 || page_id >= GetNumPages())
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> guard(alloc_latch_);
+        Bitmap &bitmap = GetBitmap(page_id / PAGES_PER_GROUP);
+        size_t bit = page_id % PAGES_PER_GROUP;
+        char mask = static_cast<char>(1 << (bit % 8));
+        if ((bitmap.data[bit / 8] & mask) == 0)
+        {
+            return;
+        }
+        bitmap.data[bit / 8] &= static_cast<char>(~mask);
+        bitmap.dirty = true;
+        free_pages_++;
+        free_hint_ = std::min(free_hint_, page_id);
+        header_dirty_ = true;
+
+        // Bitmap before header: a crash between them leaks the page rather than reusing a live one
+        WriteMetadata();
+    }
+
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::MarkAllocated(page_id_t page_id)
+    {
+        if (page_id < 0)
+        {
+            throw std::out_of_range("Invalid page ID " + std::to_string(page_id));
+        }
+
+        std::lock_guard<std::mutex> guard(alloc_latch_);
+        page_id_t num_pages = next_page_id_.load(std::memory_order_acquire);
+        Bitmap &bitmap = GetBitmap(page_id / PAGES_PER_GROUP);
+        size_t bit = page_id % PAGES_PER_GROUP;
+        char mask = static_cast<char>(1 << (bit % 8));
+        if (page_id < num_pages)
+        {
+            if ((bitmap.data[bit / 8] & mask) == 0)
+            {
+                bitmap.data[bit / 8] |= mask;
+                bitmap.dirty = true;
+                free_pages_--;
+                header_dirty_ = true;
+                WriteBitmap(page_id / PAGES_PER_GROUP);
+            }
+            return;
+        }
+
+        ExtendFile(PhysicalPage(page_id));
+        if (page_id >= reserved_pages_)
+        {
+            ReservePages(page_id);
+        }
+        bitmap.data[bit / 8] |= mask;
+        bitmap.dirty = true;
+        if (page_id > num_pages)
+        {
+            free_pages_ += page_id - num_pages;
+            free_hint_ = std::min(free_hint_, num_pages);
+        }
+        next_page_id_.store(page_id + 1, std::memory_order_release);
+        header_dirty_ = true;
+    }
+
+    template <int32_t PageSize>
+    page_id_t BasicDiskManager<PageSize>::GetFreePages()
+    {
+        std::lock_guard<std::mutex> guard(alloc_latch_);
+        return free_pages_;
+    }
+
+    template <int32_t PageSize>
+    DiskStats BasicDiskManager<PageSize>::GetStats()
+    {
+        DiskStats stats;
+        stats.reads = reads_.Load();
+        stats.writes = writes_.Load();
+        stats.bytes_read = bytes_read_.Load();
+        stats.bytes_written = bytes_written_.Load();
+        stats.read_page_latency = read_page_latency_.Snapshot();
+        stats.write_page_latency = write_page_latency_.Snapshot();
+        return stats;
+    }
+
+    template <int32_t PageSize>
+    bool BasicDiskManager<PageSize>::ClaimFreePage(page_id_t *page_id_ptr)
+    {
+        page_id_t num_pages = next_page_id_.load(std::memory_order_acquire);
+        if (free_pages_ == 0)
+        {
+            return false;
+        }
+
+        for (page_id_t page_id = free_hint_; page_id < num_pages;)
+        {
+            size_t group = page_id / PAGES_PER_GROUP;
+            page_id_t group_start = static_cast<page_id_t>(group) * PAGES_PER_GROUP;
+            size_t limit = std::min<page_id_t>(PAGES_PER_GROUP, num_pages - group_start);
+            Bitmap &bitmap = GetBitmap(group);
+
+            for (size_t bit = page_id - group_start; bit < limit;)
+            {
+                unsigned char byte = static_cast<unsigned char>(bitmap.data[bit / 8]);
+                if (bit % 8 == 0 && byte == 0xFF)
+                {
+                    bit += 8;
+                    continue;
+                }
+                if ((byte & (1 << (bit % 8))) == 0)
+                {
+                    // On disk before the page is handed out, or a crash would free it again
+                    bitmap.data[bit / 8] |= static_cast<char>(1 << (bit % 8));
+                    bitmap.dirty = true;
+                    try
+                    {
+                        WriteBitmap(group);
+                    }
+                    catch (...)
+                    {
+                        bitmap.data[bit / 8] &= static_cast<char>(~(1 << (bit % 8)));
+                        throw;
+                    }
+                    free_pages_--;
+                    *page_id_ptr = group_start + static_cast<page_id_t>(bit);
+                    free_hint_ = *page_id_ptr + 1;
+                    return true;
+                }
+                bit++;
+            }
+            page_id = group_start + PAGES_PER_GROUP;
+        }
+
+        // Count disagreed with the bitmaps, trust the bitmaps
+        free_pages_ = 0;
+        free_hint_ = num_pages;
+        return false;
+    }
+
+    template <int32_t PageSize>
+    typename BasicDiskManager<PageSize>::Bitmap &BasicDiskManager<PageSize>::GetBitmap(size_t group)
+    {
+        if (group >= bitmaps_.size())
         {
-            // Seek
-            int write_position = page_id * PAGE_SIZE;
-            db_file_.seekp(write_position, std::ios::beg);
+            bitmaps_.resize(group + 1);
+        }
+        Bitmap &bitmap = bitmaps_[group];
+        if (bitmap.data == nullptr)
+        {
+            bitmap.data = static_cast<char *>(operator new[](PageSize, std::align_val_t(PAGE_ALIGNMENT)));
+            ReadAt(BitmapPageNumber(group), bitmap.data);
+        }
+        return bitmap;
+    }
 
-            // Write to the file
-            db_file_.write(page_data, PAGE_SIZE);
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::ExtendFile(uint64_t page_number)
+    {
+        if (page_number < file_pages_)
+        {
+            return;
+        }
+
+        uint64_t extent = std::max(MIN_EXTENT_BYTES, std::min(MAX_EXTENT_BYTES, file_pages_ * PageSize / 8)) / PageSize;
+        uint64_t new_pages = std::max(page_number + 1, file_pages_ + extent);
+
+        // Grow every segment the new range touches
+        for (uint64_t segment = file_pages_ / segment_pages_; segment * segment_pages_ < new_pages; segment++)
+        {
+            uint64_t segment_start = segment * segment_pages_;
+            uint64_t from = std::max(file_pages_, segment_start) - segment_start;
+            uint64_t to = std::min(new_pages, segment_start + segment_pages_) - segment_start;
+            GrowSegment(segment, from, to);
+        }
+        file_pages_ = new_pages;
+    }
+
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::GrowSegment(uint64_t segment, uint64_t from, uint64_t pages)
+    {
+        int fd = SegmentFd(segment);
+
+        // Reserve blocks up front; filesystems without fallocate get a sparse extension
+        if (preallocate_)
+        {
+            off_t offset = static_cast<off_t>(from) * PageSize;
+            if (fallocate(fd, 0, offset, static_cast<off_t>(pages - from) * PageSize) == 0)
+            {
+                return;
+            }
+            if (errno != EOPNOTSUPP && errno != ENOSYS)
+            {
+                ThrowIOError("Failed to extend segment " + std::to_string(segment) + " of");
+            }
+        }
+
+        // The header may be older than the segment after a crash, never cut written pages off
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            ThrowIOError("Failed to stat segment " + std::to_string(segment) + " of");
+        }
+        off_t length = static_cast<off_t>(pages) * PageSize;
+        if (st.st_size < length && ftruncate(fd, length) != 0)
+        {
+            ThrowIOError("Failed to extend segment " + std::to_string(segment) + " of");
+        }
+    }
 
-            db_file_.flush();
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::ReservePages(page_id_t page_id)
+    {
+        // Everything the file has room for, so this runs once per extension
+        page_id_t previous = reserved_pages_;
+        reserved_pages_ = std::max(page_id + 1, DataPages(file_pages_));
+        header_dirty_ = true;
+        try
+        {
+            WriteMetadata();
+            if (fdatasync(SegmentFd(0)) != 0)
+            {
+                ThrowIOError("Failed to sync header of");
+            }
+        }
+        catch (...)
+        {
+            reserved_pages_ = previous;
+            header_dirty_ = true;
+            throw;
         }
     }
 
-    page_id_t DiskManager::AllocatePage()
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::WriteBitmap(size_t group)
     {
-        // Return the created page ID and increment next ID
-        int created_page_id = next_page_id_;
-        next_page_id_++;
+        WriteAt(BitmapPageNumber(group), bitmaps_[group].data);
+        bitmaps_[group].dirty = false;
+    }
 
-        // Create empty buffer and extend file
-        char emptyBuffer[PAGE_SIZE];
-        memset(emptyBuffer, 0, PAGE_SIZE);
-        db_file_.seekp(std::ios::end);
-        db_file_.write(emptyBuffer, PAGE_SIZE);
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::WriteMetadata()
+    {
+        for (size_t group = 0; group < bitmaps_.size(); group++)
+        {
+            if (bitmaps_[group].dirty)
+            {
+                WriteAt(BitmapPageNumber(group), bitmaps_[group].data);
+                bitmaps_[group].dirty = false;
+            }
+        }
 
-        return created_page_id;
+        if (header_dirty_)
+        {
+            AlignedPage<PageSize> page = {};
+            FileHeader header = {FILE_MAGIC,
+                                 FILE_VERSION,
+                                 static_cast<uint32_t>(PageSize),
+                                 segment_bytes_,
+                                 static_cast<uint64_t>(next_page_id_.load(std::memory_order_acquire)),
+                                 static_cast<uint64_t>(free_pages_),
+                                 static_cast<uint64_t>(free_hint_),
+                                 file_pages_,
+                                 static_cast<uint64_t>(reserved_pages_)};
+            memcpy(page.data, &header, sizeof(header));
+            WriteAt(0, page.data);
+            header_dirty_ = false;
+        }
+    }
+
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::Sync()
+    {
+        {
+            std::lock_guard<std::mutex> guard(alloc_latch_);
+            WriteMetadata();
+        }
+        // Segments opened meanwhile have nothing of this Sync's to write yet
+        for (uint64_t segment : GetOpenSegments())
+        {
+            int fd = fds_[segment].load(std::memory_order_acquire);
+            if (fd >= 0 && fdatasync(fd) != 0)
+            {
+                ThrowIOError("Failed to sync segment " + std::to_string(segment) + " of");
+            }
+        }
+    }
+
+    template <int32_t PageSize>
+    void BasicDiskManager<PageSize>::ThrowIOError(const std::string &what)
+    {
+        throw std::runtime_error(what + " " + file_name_ + ": " + strerror(errno));
     }
 
-}
\ No newline at end of file
+    template class BasicDiskManager<4096>;
+    template class BasicDiskManager<8192>;
+    template class BasicDiskManager<16384>;
+    template class BasicDiskManager<65536>;
+
+}
@@ -0,0 +1,263 @@
+#include "../include/executor.h"
+
+#include <algorithm> // std::fill, std::min
+#include <cstring>   // memcpy
+#include <limits>    // std::numeric_limits
+#include <stdexcept> // std::invalid_argument
+#include <string>    // std::to_string
+#include <utility>   // std::move
+
+namespace minidb
+{
+    namespace
+    {
+        struct FilterState : public OperatorState
+        {
+            std::vector<uint64_t> selection;
+            std::vector<uint64_t> scratch;
+        };
+
+        /// @brief Operator and sink states of one worker, created on its first morsel
+        struct WorkerState
+        {
+            std::vector<std::unique_ptr<OperatorState>> operators;
+            std::unique_ptr<OperatorState> sink;
+            uint64_t sink_chunks = 0;
+        };
+    }
+
+    PaxValue DataChunk::GetValue(size_t column, size_t row) const
+    {
+        PaxValue value;
+        switch (types[column])
+        {
+        case PaxType::INT32:
+            value.i = GetColumn<int32_t>(column)[row];
+            break;
+        case PaxType::INT64:
+            value.i = GetColumn<int64_t>(column)[row];
+            break;
+        default:
+            value.d = GetColumn<double>(column)[row];
+        }
+        return value;
+    }
+
+    void DataChunk::GetSelectedRows(std::vector<uint32_t> *rows) const
+    {
+        rows->clear();
+        if (selection == nullptr)
+        {
+            for (size_t row = 0; row < count; row++)
+            {
+                rows->push_back(static_cast<uint32_t>(row));
+            }
+            return;
+        }
+        for (size_t w = 0; w < (count + 63) / 64; w++)
+        {
+            for (uint64_t bits = selection[w]; bits != 0; bits &= bits - 1)
+            {
+                rows->push_back(static_cast<uint32_t>(w * 64 + __builtin_ctzll(bits)));
+            }
+        }
+    }
+
+    template <int32_t PageSize>
+    BasicPaxScan<PageSize>::BasicPaxScan(BasicPaxTable<PageSize> *table, basic_buffer_pool<PageSize> *pool,
+                                         size_t pages_per_morsel)
+        : table_(table), pool_(pool), pages_per_morsel_(pages_per_morsel == 0 ? 1 : pages_per_morsel)
+    {
+    }
+
+    template <int32_t PageSize>
+    size_t BasicPaxScan<PageSize>::GetMorselCount()
+    {
+        return (table_->GetPageCount() + pages_per_morsel_ - 1) / pages_per_morsel_;
+    }
+
+    template <int32_t PageSize>
+    void BasicPaxScan<PageSize>::Scan(size_t morsel, const std::function<void(DataChunk &)> &consumer)
+    {
+        size_t first = morsel * pages_per_morsel_;
+        size_t count = std::min<size_t>(pages_per_morsel_, table_->GetPageCount() - first);
+        std::vector<page_id_t> page_ids(count);
+        std::vector<BasicPage<PageSize> *> pages(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            page_ids[i] = table_->GetPageId(first + i);
+        }
+        pool_->FetchPages(page_ids.data(), count, pages.data());
+
+        const std::vector<PaxType> &schema = table_->GetSchema();
+        DataChunk chunk;
+        size_t i = 0;
+        try
+        {
+            for (; i < count; i++)
+            {
+                BasicPaxPage<PageSize> page(pages[i]->GetData());
+                // Operators may rearrange the chunk, so it is rebuilt for every page
+                chunk.count = page.GetRowCount();
+                chunk.types = schema;
+                chunk.columns.resize(schema.size());
+                chunk.validity.resize(schema.size());
+                chunk.selection = nullptr;
+                for (uint32_t c = 0; c < schema.size(); c++)
+                {
+                    chunk.columns[c] = page.template GetColumn<char>(c);
+                    chunk.validity[c] = page.GetZoneMap(c).nulls > 0 ? page.GetValidity(c) : nullptr;
+                }
+                consumer(chunk);
+                pool_->UnpinPage(page_ids[i], false);
+            }
+        }
+        catch (...)
+        {
+            for (; i < count; i++)
+            {
+                pool_->UnpinPage(page_ids[i], false);
+            }
+            throw;
+        }
+    }
+
+    Filter::Filter(std::vector<PaxPredicate> predicates) : predicates_(std::move(predicates))
+    {
+    }
+
+    std::unique_ptr<OperatorState> Filter::NewState()
+    {
+        return std::unique_ptr<OperatorState>(new FilterState());
+    }
+
+    DataChunk *Filter::Execute(DataChunk *input, OperatorState *state)
+    {
+        if (input->count == 0)
+        {
+            return nullptr;
+        }
+        FilterState *filter = static_cast<FilterState *>(state);
+        size_t words = (input->count + 63) / 64;
+        filter->selection.resize(words);
+        filter->scratch.resize(words);
+        if (input->selection != nullptr)
+        {
+            memcpy(filter->selection.data(), input->selection, words * sizeof(uint64_t));
+        }
+        else
+        {
+            std::fill(filter->selection.begin(), filter->selection.end(), ~0ull);
+            if (input->count % 64 != 0)
+            {
+                filter->selection[words - 1] = (uint64_t(1) << (input->count % 64)) - 1;
+            }
+        }
+
+        for (const PaxPredicate &predicate : predicates_)
+        {
+            if (predicate.column >= input->types.size())
+            {
+                throw std::invalid_argument("No column " + std::to_string(predicate.column));
+            }
+            if (input->types[predicate.column] == PaxType::INT32 &&
+                (predicate.operand.i < std::numeric_limits<int32_t>::lowest() ||
+                 predicate.operand.i > std::numeric_limits<int32_t>::max()))
+            {
+                throw std::invalid_argument("Operand " + std::to_string(predicate.operand.i) +
+                                            " out of range of INT32 column " + std::to_string(predicate.column));
+            }
+            FilterPaxColumn(input->types[predicate.column], input->columns[predicate.column], input->count,
+                            predicate.op, predicate.operand, filter->scratch.data());
+            if (input->validity[predicate.column] != nullptr)
+            {
+                ScanKernels::And(filter->scratch.data(), input->validity[predicate.column], input->count);
+            }
+            if (ScanKernels::And(filter->selection.data(), filter->scratch.data(), input->count) == 0)
+            {
+                return nullptr;
+            }
+        }
+        input->selection = filter->selection.data();
+        return input;
+    }
+
+    Project::Project(std::vector<uint32_t> columns) : columns_(std::move(columns))
+    {
+    }
+
+    DataChunk *Project::Execute(DataChunk *input, OperatorState *)
+    {
+        std::vector<PaxType> types(columns_.size());
+        std::vector<const char *> columns(columns_.size());
+        std::vector<const uint64_t *> validity(columns_.size());
+        for (size_t i = 0; i < columns_.size(); i++)
+        {
+            uint32_t column = columns_[i];
+            if (column >= input->types.size())
+            {
+                throw std::invalid_argument("No column " + std::to_string(column));
+            }
+            types[i] = input->types[column];
+            columns[i] = input->columns[column];
+            validity[i] = input->validity[column];
+        }
+        input->types.swap(types);
+        input->columns.swap(columns);
+        input->validity.swap(validity);
+        return input;
+    }
+
+    Pipeline::Pipeline(ChunkSource *source, std::vector<Operator *> operators, Sink *sink)
+        : source_(source), operators_(std::move(operators)), sink_(sink)
+    {
+    }
+
+    void Pipeline::Execute(WorkStealingPool *pool)
+    {
+        std::vector<WorkerState> workers(pool->GetThreadCount());
+        auto run_morsel = [&](size_t morsel, size_t worker)
+        {
+            WorkerState &state = workers[worker];
+            if (state.sink == nullptr)
+            {
+                for (Operator *op : operators_)
+                {
+                    state.operators.push_back(op->NewState());
+                }
+                state.sink = sink_->NewState();
+            }
+            auto push = [&](DataChunk &input)
+            {
+                DataChunk *chunk = &input;
+                for (size_t i = 0; chunk != nullptr && i < operators_.size(); i++)
+                {
+                    chunk = operators_[i]->Execute(chunk, state.operators[i].get());
+                }
+                if (chunk != nullptr)
+                {
+                    sink_->Consume(*chunk, state.sink.get());
+                    state.sink_chunks++;
+                }
+            };
+            source_->Scan(morsel, push);
+        };
+        pool->ParallelFor(source_->GetMorselCount(), run_morsel);
+
+        sink_chunks_ = 0;
+        for (WorkerState &state : workers)
+        {
+            if (state.sink != nullptr)
+            {
+                sink_->Combine(state.sink.get());
+                sink_chunks_ += state.sink_chunks;
+            }
+        }
+        sink_->Finalize();
+    }
+
+    template class BasicPaxScan<4096>;
+    template class BasicPaxScan<8192>;
+    template class BasicPaxScan<16384>;
+    template class BasicPaxScan<65536>;
+}
@@ -0,0 +1,349 @@
+#include "../include/extendible_hash_table.h"
+
+#include <algorithm> // std::min
+#include <stdexcept> // std::runtime_error
+#include <string>    // std::to_string
+
+namespace minidb
+{
+    /// @brief Header page layout after the page header: global depth, directory page count, then
+    /// the directory page IDs
+    static constexpr uint32_t HEADER_DEPTH_OFFSET = Page::HEADER_SIZE;
+    static constexpr uint32_t HEADER_COUNT_OFFSET = HEADER_DEPTH_OFFSET + sizeof(uint32_t);
+    static constexpr uint32_t HEADER_PAGES_OFFSET = HEADER_COUNT_OFFSET + sizeof(uint32_t);
+
+    template <typename KeyType, typename KeyComparator, typename KeyHasher, int32_t PageSize>
+    BasicExtendibleHashTable<KeyType, KeyComparator, KeyHasher, PageSize>::BasicExtendibleHashTable(
+        basic_buffer_pool<PageSize> *pool, const KeyComparator &comparator, const KeyHasher &hasher)
+        : pool_(pool), comparator_(comparator), hasher_(hasher)
+    {
+        pool_->NewPage(&header_page_id_);
+        pool_->UnpinPage(header_page_id_, true);
+
+        page_id_t bucket_id;
+        BasicPage<PageSize> *bucket = pool_->NewPage(&bucket_id);
+        Bucket(bucket->GetData()).Init();
+        pool_->UnpinPage(bucket_id, true);
+
+        buckets_.resize(1);
+        local_depths_.resize(1);
+        SetSlot(0, bucket_id, 0);
+        FlushDirectory();
+    }
+
+    template <typename KeyType, typename KeyComparator, typename KeyHasher, int32_t PageSize>
+    BasicExtendibleHashTable<KeyType, KeyComparator, KeyHasher, PageSize>::BasicExtendibleHashTable(
+        basic_buffer_pool<PageSize> *pool, page_id_t header_page_id, const KeyComparator &comparator,
+        const KeyHasher &hasher)
+        : pool_(pool), comparator_(comparator), hasher_(hasher), header_page_id_(header_page_id)
+    {
+        BasicPage<PageSize> *header = pool_->FetchPage(header_page_id_);
+        uint32_t count;
+        memcpy(&global_depth_, header->GetData() + HEADER_DEPTH_OFFSET, sizeof(uint32_t));
+        memcpy(&count, header->GetData() + HEADER_COUNT_OFFSET, sizeof(uint32_t));
+        directory_pages_.resize(count);
+        memcpy(directory_pages_.data(), header->GetData() + HEADER_PAGES_OFFSET, count * sizeof(page_id_t));
+        pool_->UnpinPage(header_page_id_, false);
+        directory_dirty_.assign(count, false);
+
+        size_t slots = size_t(1) << global_depth_;
+        buckets_.resize(slots);
+        local_depths_.resize(slots);
+        for (size_t first = 0; first < slots; first += SLOTS_PER_DIRECTORY_PAGE)
+        {
+            size_t n = std::min(SLOTS_PER_DIRECTORY_PAGE, slots - first);
+            page_id_t page_id = directory_pages_[first / SLOTS_PER_DIRECTORY_PAGE];
+            BasicPage<PageSize> *page = pool_->FetchPage(page_id);
+            const char *data = page->GetData() + BasicPage<PageSize>::HEADER_SIZE;
+            memcpy(&buckets_[first], data, n * sizeof(page_id_t));
+            memcpy(&local_depths_[first], data + SLOTS_PER_DIRECTORY_PAGE * sizeof(page_id_t), n);
+            pool_->UnpinPage(page_id, false);
+        }
+    }
+
+    template <typename KeyType, typename KeyComparator, typename KeyHasher, int32_t PageSize>
+    bool BasicExtendibleHashTable<KeyType, KeyComparator, KeyHasher, PageSize>::GetValue(const KeyType &key,
+                                                                                         RID *value)
+    {
+        uint64_t hash = hasher_(key);
+        page_id_t bucket_id = buckets_[SlotOf(hash)];
+        BasicPage<PageSize> *page = pool_->FetchPage(bucket_id);
+        Bucket bucket(page->GetData());
+        int index = bucket.Find(key, Fingerprint(hash), comparator_);
+        if (index >= 0)
+        {
+            *value = bucket.ValueAt(index);
+        }
+        pool_->UnpinPage(bucket_id, false);
+        return index >= 0;
+    }
+
+    template <typename KeyType, typename KeyComparator, typename KeyHasher, int32_t PageSize>
+    bool BasicExtendibleHashTable<KeyType, KeyComparator, KeyHasher, PageSize>::Insert(const KeyType &key,
+                                                                                       const RID &value)
+    {
+        uint64_t hash = hasher_(key);
+        while (true)
+        {
+            size_t slot = SlotOf(hash);
+            page_id_t bucket_id = buckets_[slot];
+            BasicPage<PageSize> *page = pool_->FetchPage(bucket_id);
+            Bucket bucket(page->GetData());
+            if (bucket.Find(key, Fingerprint(hash), comparator_) >= 0)
+            {
+                pool_->UnpinPage(bucket_id, false);
+                return false;
+            }
+            if (!bucket.IsFull())
+            {
+                bucket.Append(Fingerprint(hash), key, value);
+                pool_->UnpinPage(bucket_id, true);
+                return true;
+            }
+
+            // Full: split and retry, the entries may all land on the key's side again
+            pool_->UnpinPage(bucket_id, false);
+            SplitBucket(slot);
+        }
+    }
+
+    template <typename KeyType, typename KeyComparator, typename KeyHasher, int32_t PageSize>
+    bool BasicExtendibleHashTable<KeyType, KeyComparator, KeyHasher, PageSize>::Remove(const KeyType &key)
+    {
+        uint64_t hash = hasher_(key);
+        page_id_t bucket_id = buckets_[SlotOf(hash)];
+        BasicPage<PageSize> *page = pool_->FetchPage(bucket_id);
+        Bucket bucket(page->GetData());
+        int index = bucket.Find(key, Fingerprint(hash), comparator_);
+        if (index < 0)
+        {
+            pool_->UnpinPage(bucket_id, false);
+            return false;
+        }
+        bucket.RemoveAt(index);
+        bool empty = bucket.GetSize() == 0;
+        pool_->UnpinPage(bucket_id, true);
+        if (!empty)
+        {
+            return true;
+        }
+
+        // Fold the bucket and its split image together while one of the pair is empty
+        bool merged = false;
+        while (true)
+        {
+            size_t slot = SlotOf(hash);
+            uint8_t depth = local_depths_[slot];
+            if (depth == 0)
+            {
+                break;
+            }
+            size_t image_slot = slot ^ (size_t(1) << (depth - 1));
+            if (local_depths_[image_slot] != depth)
+            {
+                break;
+            }
+
+            page_id_t ids[2] = {buckets_[slot], buckets_[image_slot]};
+            int sizes[2];
+            for (int i = 0; i < 2; i++)
+            {
+                BasicPage<PageSize> *bucket_page = pool_->FetchPage(ids[i]);
+                sizes[i] = Bucket(bucket_page->GetData()).GetSize();
+                pool_->UnpinPage(ids[i], false);
+            }
+            if (sizes[0] != 0 && sizes[1] != 0)
+            {
+                break;
+            }
+            page_id_t keep = sizes[0] == 0 ? ids[1] : ids[0];
+            page_id_t drop = sizes[0] == 0 ? ids[0] : ids[1];
+
+            size_t stride = size_t(1) << (depth - 1);
+            for (size_t s = slot & (stride - 1); s < buckets_.size(); s += stride)
+            {
+                SetSlot(s, keep, static_cast<uint8_t>(depth - 1));
+            }
+            pool_->DeletePage(drop);
+            merged = true;
+        }
+
+        if (merged)
+        {
+            ShrinkDirectory();
+            FlushDirectory();
+        }
+        return true;
+    }
+
+    template <typename KeyType, typename KeyComparator, typename KeyHasher, int32_t PageSize>
+    size_t BasicExtendibleHashTable<KeyType, KeyComparator, KeyHasher, PageSize>::GetBucketCount()
+    {
+        // Each bucket owns exactly one slot below 2^local_depth
+        size_t count = 0;
+        for (size_t slot = 0; slot < buckets_.size(); slot++)
+        {
+            if (slot < (size_t(1) << local_depths_[slot]))
+            {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    template <typename KeyType, typename KeyComparator, typename KeyHasher, int32_t PageSize>
+    void BasicExtendibleHashTable<KeyType, KeyComparator, KeyHasher, PageSize>::SetSlot(size_t slot,
+                                                                                        page_id_t bucket,
+                                                                                        uint8_t local_depth)
+    {
+        buckets_[slot] = bucket;
+        local_depths_[slot] = local_depth;
+        size_t page = slot / SLOTS_PER_DIRECTORY_PAGE;
+        if (page >= directory_dirty_.size())
+        {
+            directory_dirty_.resize(page + 1, true);
+        }
+        directory_dirty_[page] = true;
+    }
+
+    template <typename KeyType, typename KeyComparator, typename KeyHasher, int32_t PageSize>
+    void BasicExtendibleHashTable<KeyType, KeyComparator, KeyHasher, PageSize>::GrowDirectory()
+    {
+        if (global_depth_ == MAX_GLOBAL_DEPTH)
+        {
+            throw std::runtime_error("Hash index directory is at its maximum depth of " +
+                                     std::to_string(MAX_GLOBAL_DEPTH));
+        }
+        size_t slots = buckets_.size();
+        buckets_.resize(2 * slots);
+        local_depths_.resize(2 * slots);
+        for (size_t slot = 0; slot < slots; slot++)
+        {
+            SetSlot(slot + slots, buckets_[slot], local_depths_[slot]);
+        }
+        global_depth_++;
+    }
+
+    template <typename KeyType, typename KeyComparator, typename KeyHasher, int32_t PageSize>
+    void BasicExtendibleHashTable<KeyType, KeyComparator, KeyHasher, PageSize>::ShrinkDirectory()
+    {
+        while (global_depth_ > 0)
+        {
+            for (uint8_t depth : local_depths_)
+            {
+                if (depth == global_depth_)
+                {
+                    return;
+                }
+            }
+            global_depth_--;
+            buckets_.resize(buckets_.size() / 2);
+            local_depths_.resize(local_depths_.size() / 2);
+        }
+    }
+
+    template <typename KeyType, typename KeyComparator, typename KeyHasher, int32_t PageSize>
+    void BasicExtendibleHashTable<KeyType, KeyComparator, KeyHasher, PageSize>::SplitBucket(size_t slot)
+    {
+        uint8_t depth = local_depths_[slot];
+        if (depth == global_depth_)
+        {
+            GrowDirectory();
+        }
+
+        page_id_t old_id = buckets_[slot];
+        page_id_t new_id;
+        BasicPage<PageSize> *old_page = pool_->FetchPage(old_id);
+        BasicPage<PageSize> *new_page;
+        try
+        {
+            new_page = pool_->NewPage(&new_id);
+        }
+        catch (...)
+        {
+            pool_->UnpinPage(old_id, false);
+            throw;
+        }
+
+        // Entries with the next hash bit set move, the rest stay
+        Bucket old_bucket(old_page->GetData());
+        Bucket new_bucket(new_page->GetData());
+        new_bucket.Init();
+        uint64_t bit = uint64_t(1) << depth;
+        for (int i = 0; i < old_bucket.GetSize();)
+        {
+            if ((hasher_(old_bucket.KeyAt(i)) & bit) != 0)
+            {
+                new_bucket.Append(old_bucket.FingerprintAt(i), old_bucket.KeyAt(i), old_bucket.ValueAt(i));
+                old_bucket.RemoveAt(i);
+            }
+            else
+            {
+                i++;
+            }
+        }
+        pool_->UnpinPage(new_id, true);
+        pool_->UnpinPage(old_id, true);
+
+        for (size_t s = slot & (bit - 1); s < buckets_.size(); s += bit)
+        {
+            SetSlot(s, (s & bit) != 0 ? new_id : old_id, static_cast<uint8_t>(depth + 1));
+        }
+        FlushDirectory();
+    }
+
+    template <typename KeyType, typename KeyComparator, typename KeyHasher, int32_t PageSize>
+    void BasicExtendibleHashTable<KeyType, KeyComparator, KeyHasher, PageSize>::FlushDirectory()
+    {
+        size_t slots = buckets_.size();
+        size_t needed = (slots + SLOTS_PER_DIRECTORY_PAGE - 1) / SLOTS_PER_DIRECTORY_PAGE;
+        while (directory_pages_.size() < needed)
+        {
+            page_id_t page_id;
+            pool_->NewPage(&page_id);
+            pool_->UnpinPage(page_id, true);
+            directory_pages_.push_back(page_id);
+        }
+
+        for (size_t page_index = 0; page_index < needed && page_index < directory_dirty_.size(); page_index++)
+        {
+            if (!directory_dirty_[page_index])
+            {
+                continue;
+            }
+            size_t first = page_index * SLOTS_PER_DIRECTORY_PAGE;
+            size_t n = std::min(SLOTS_PER_DIRECTORY_PAGE, slots - first);
+            BasicPage<PageSize> *page = pool_->FetchPage(directory_pages_[page_index]);
+            char *data = page->GetData() + BasicPage<PageSize>::HEADER_SIZE;
+            memcpy(data, &buckets_[first], n * sizeof(page_id_t));
+            memcpy(data + SLOTS_PER_DIRECTORY_PAGE * sizeof(page_id_t), &local_depths_[first], n);
+            pool_->UnpinPage(directory_pages_[page_index], true);
+            directory_dirty_[page_index] = false;
+        }
+
+        // Directory pages past a shrunken directory stay listed for the next growth
+        BasicPage<PageSize> *header = pool_->FetchPage(header_page_id_);
+        uint32_t count = static_cast<uint32_t>(directory_pages_.size());
+        memcpy(header->GetData() + HEADER_DEPTH_OFFSET, &global_depth_, sizeof(uint32_t));
+        memcpy(header->GetData() + HEADER_COUNT_OFFSET, &count, sizeof(uint32_t));
+        memcpy(header->GetData() + HEADER_PAGES_OFFSET, directory_pages_.data(), count * sizeof(page_id_t));
+        pool_->UnpinPage(header_page_id_, true);
+    }
+
+    template class BasicExtendibleHashTable<int64_t, Int64Comparator, Int64Hash, 4096>;
+    template class BasicExtendibleHashTable<int64_t, Int64Comparator, Int64Hash, 8192>;
+    template class BasicExtendibleHashTable<int64_t, Int64Comparator, Int64Hash, 16384>;
+    template class BasicExtendibleHashTable<int64_t, Int64Comparator, Int64Hash, 65536>;
+    template class BasicExtendibleHashTable<GenericKey<16>, GenericComparator<16>, GenericHash<16>, 4096>;
+    template class BasicExtendibleHashTable<GenericKey<16>, GenericComparator<16>, GenericHash<16>, 8192>;
+    template class BasicExtendibleHashTable<GenericKey<16>, GenericComparator<16>, GenericHash<16>, 16384>;
+    template class BasicExtendibleHashTable<GenericKey<16>, GenericComparator<16>, GenericHash<16>, 65536>;
+    template class BasicExtendibleHashTable<GenericKey<32>, GenericComparator<32>, GenericHash<32>, 4096>;
+    template class BasicExtendibleHashTable<GenericKey<32>, GenericComparator<32>, GenericHash<32>, 8192>;
+    template class BasicExtendibleHashTable<GenericKey<32>, GenericComparator<32>, GenericHash<32>, 16384>;
+    template class BasicExtendibleHashTable<GenericKey<32>, GenericComparator<32>, GenericHash<32>, 65536>;
+    template class BasicExtendibleHashTable<GenericKey<64>, GenericComparator<64>, GenericHash<64>, 4096>;
+    template class BasicExtendibleHashTable<GenericKey<64>, GenericComparator<64>, GenericHash<64>, 8192>;
+    template class BasicExtendibleHashTable<GenericKey<64>, GenericComparator<64>, GenericHash<64>, 16384>;
+    template class BasicExtendibleHashTable<GenericKey<64>, GenericComparator<64>, GenericHash<64>, 65536>;
+}
@@ -0,0 +1,65 @@
+#include "../include/frame_arena.h"
+
+#include <algorithm> // std::max
+#include <cerrno>    // errno
+#include <cstring>   // strerror
+#include <stdexcept> // std::runtime_error
+#include <string>    // std::string
+#include <sys/mman.h> // mmap, munmap, madvise
+
+namespace minidb
+{
+    static const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    template <int32_t PageSize>
+    BasicFrameArena<PageSize>::BasicFrameArena(size_t frames, bool use_hugetlb)
+    {
+        size_t bytes = std::max<size_t>(1, frames) * PageSize;
+        void *memory = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+        if (use_hugetlb)
+        {
+            size_t huge_bytes = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+            memory = mmap(nullptr, huge_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (memory != MAP_FAILED)
+            {
+                size_ = huge_bytes;
+                huge_tlb_ = true;
+            }
+        }
+#else
+        (void)use_hugetlb;
+#endif
+
+        if (memory == MAP_FAILED)
+        {
+            memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (memory == MAP_FAILED)
+            {
+                throw std::runtime_error("Failed to map frame arena: " + std::string(strerror(errno)));
+            }
+            size_ = bytes;
+#ifdef MADV_HUGEPAGE
+            // Only a hint, kernels without THP just keep small pages
+            if (bytes >= HUGE_PAGE_SIZE)
+            {
+                madvise(memory, bytes, MADV_HUGEPAGE);
+            }
+#endif
+        }
+        base_ = static_cast<char *>(memory);
+    }
+
+    template <int32_t PageSize>
+    BasicFrameArena<PageSize>::~BasicFrameArena()
+    {
+        munmap(base_, size_);
+    }
+
+    template class BasicFrameArena<4096>;
+    template class BasicFrameArena<8192>;
+    template class BasicFrameArena<16384>;
+    template class BasicFrameArena<65536>;
+
+} // namespace minidb
@@ -0,0 +1,662 @@
+#include "../include/hash_operators.h"
+
+#include <algorithm>   // std::sort
+#include <cstring>     // memcpy
+#include <functional>  // std::function
+#include <limits>      // std::numeric_limits
+#include <stdexcept>   // std::invalid_argument, std::runtime_error
+#include <string>      // std::to_string
+#include <type_traits> // std::is_floating_point
+#include <utility>     // std::move
+#include "../include/index_key.h"
+
+namespace minidb
+{
+    namespace
+    {
+        constexpr size_t INITIAL_SLOTS = 64;
+
+        /// @brief Partial aggregates of one worker, or of the whole query once merged
+        struct AggregateState : public OperatorState
+        {
+            KeyIndex groups;
+            /// @brief Accumulator per group and aggregate, group-major
+            std::vector<PaxValue> values;
+            /// @brief Non-null inputs per group and aggregate
+            std::vector<uint64_t> counts;
+            /// @brief Input type per aggregate, empty until the first chunk
+            std::vector<PaxType> types;
+            std::vector<uint32_t> rows;
+            std::vector<uint32_t> group_ids;
+        };
+
+        /// @brief Build rows of one worker
+        struct BuildState : public OperatorState
+        {
+            std::vector<PaxType> types;
+            std::vector<int64_t> keys;
+            std::vector<uint64_t> payload;
+            std::vector<uint64_t> null_masks;
+            std::vector<uint32_t> rows;
+        };
+
+        struct ProbeState : public OperatorState
+        {
+            std::vector<uint32_t> rows;
+            std::vector<uint32_t> probe_rows;
+            std::vector<uint32_t> build_rows;
+            /// @brief Values per output column, in uint64_t words to keep them aligned
+            std::vector<std::vector<uint64_t>> buffers;
+            std::vector<std::vector<uint64_t>> validity;
+            DataChunk output;
+        };
+
+        void CheckColumn(const DataChunk &chunk, uint32_t column)
+        {
+            if (column >= chunk.types.size())
+            {
+                throw std::invalid_argument("No column " + std::to_string(column));
+            }
+        }
+
+        void CheckKeyColumn(const DataChunk &chunk, uint32_t column)
+        {
+            CheckColumn(chunk, column);
+            if (chunk.types[column] == PaxType::DOUBLE)
+            {
+                throw std::invalid_argument("Key column " + std::to_string(column) + " must be INT32 or INT64");
+            }
+        }
+
+        inline int64_t GetKey(const DataChunk &chunk, uint32_t column, uint32_t row)
+        {
+            return chunk.types[column] == PaxType::INT32 ? chunk.GetColumn<int32_t>(column)[row]
+                                                         : chunk.GetColumn<int64_t>(column)[row];
+        }
+
+        inline uint64_t GetBits(const DataChunk &chunk, uint32_t column, uint32_t row)
+        {
+            uint64_t bits;
+            if (chunk.types[column] == PaxType::INT32)
+            {
+                bits = static_cast<uint64_t>(static_cast<int64_t>(chunk.GetColumn<int32_t>(column)[row]));
+            }
+            else
+            {
+                memcpy(&bits, chunk.columns[column] + static_cast<size_t>(row) * 8, sizeof(bits));
+            }
+            return bits;
+        }
+
+        PaxValue InitialValue(AggregateFunc func, PaxType type)
+        {
+            PaxValue value;
+            bool is_double = type == PaxType::DOUBLE;
+            switch (func)
+            {
+            case AggregateFunc::MIN:
+                if (is_double)
+                {
+                    value.d = std::numeric_limits<double>::max();
+                }
+                else
+                {
+                    value.i = std::numeric_limits<int64_t>::max();
+                }
+                break;
+            case AggregateFunc::MAX:
+                if (is_double)
+                {
+                    value.d = std::numeric_limits<double>::lowest();
+                }
+                else
+                {
+                    value.i = std::numeric_limits<int64_t>::lowest();
+                }
+                break;
+            default:
+                if (is_double)
+                {
+                    value.d = 0;
+                }
+                else
+                {
+                    value.i = 0;
+                }
+            }
+            return value;
+        }
+
+        /// @brief Folds one value into an accumulator; integer sums wrap
+        template <AggregateFunc Func, typename T>
+        inline void Fold(PaxValue &acc, T v)
+        {
+            if constexpr (std::is_floating_point<T>::value)
+            {
+                if constexpr (Func == AggregateFunc::SUM)
+                {
+                    acc.d += v;
+                }
+                else if constexpr (Func == AggregateFunc::MIN)
+                {
+                    acc.d = v < acc.d ? v : acc.d;
+                }
+                else if constexpr (Func == AggregateFunc::MAX)
+                {
+                    acc.d = v > acc.d ? v : acc.d;
+                }
+            }
+            else
+            {
+                int64_t wide = v;
+                if constexpr (Func == AggregateFunc::SUM)
+                {
+                    acc.i = static_cast<int64_t>(static_cast<uint64_t>(acc.i) + static_cast<uint64_t>(wide));
+                }
+                else if constexpr (Func == AggregateFunc::MIN)
+                {
+                    acc.i = wide < acc.i ? wide : acc.i;
+                }
+                else if constexpr (Func == AggregateFunc::MAX)
+                {
+                    acc.i = wide > acc.i ? wide : acc.i;
+                }
+            }
+        }
+
+        /// @brief Updates one aggregate for every row of a chunk whose group is known
+        template <AggregateFunc Func, typename T>
+        void UpdateColumn(const DataChunk &chunk, uint32_t column, size_t aggregate, AggregateState *state)
+        {
+            const T *data = chunk.GetColumn<T>(column);
+            const uint64_t *validity = chunk.validity[column];
+            size_t stride = state->types.size();
+            PaxValue *values = state->values.data() + aggregate;
+            uint64_t *counts = state->counts.data() + aggregate;
+            for (size_t k = 0; k < state->rows.size(); k++)
+            {
+                uint32_t row = state->rows[k];
+                if (validity != nullptr && ((validity[row / 64] >> (row % 64)) & 1) == 0)
+                {
+                    continue;
+                }
+                size_t slot = static_cast<size_t>(state->group_ids[k]) * stride;
+                counts[slot]++;
+                Fold<Func, T>(values[slot], data[row]);
+            }
+        }
+
+        template <typename T>
+        void UpdateAggregate(AggregateFunc func, const DataChunk &chunk, uint32_t column, size_t aggregate,
+                             AggregateState *state)
+        {
+            switch (func)
+            {
+            case AggregateFunc::COUNT:
+                UpdateColumn<AggregateFunc::COUNT, T>(chunk, column, aggregate, state);
+                break;
+            case AggregateFunc::SUM:
+                UpdateColumn<AggregateFunc::SUM, T>(chunk, column, aggregate, state);
+                break;
+            case AggregateFunc::MIN:
+                UpdateColumn<AggregateFunc::MIN, T>(chunk, column, aggregate, state);
+                break;
+            default:
+                UpdateColumn<AggregateFunc::MAX, T>(chunk, column, aggregate, state);
+            }
+        }
+
+        void MergeValue(AggregateFunc func, PaxType type, PaxValue &acc, PaxValue v)
+        {
+            bool is_double = type == PaxType::DOUBLE;
+            switch (func)
+            {
+            case AggregateFunc::COUNT:
+                break;
+            case AggregateFunc::SUM:
+                if (is_double)
+                {
+                    Fold<AggregateFunc::SUM, double>(acc, v.d);
+                }
+                else
+                {
+                    Fold<AggregateFunc::SUM, int64_t>(acc, v.i);
+                }
+                break;
+            case AggregateFunc::MIN:
+                if (is_double)
+                {
+                    Fold<AggregateFunc::MIN, double>(acc, v.d);
+                }
+                else
+                {
+                    Fold<AggregateFunc::MIN, int64_t>(acc, v.i);
+                }
+                break;
+            default:
+                if (is_double)
+                {
+                    Fold<AggregateFunc::MAX, double>(acc, v.d);
+                }
+                else
+                {
+                    Fold<AggregateFunc::MAX, int64_t>(acc, v.i);
+                }
+            }
+        }
+    }
+
+    KeyIndex::KeyIndex() : slots_(INITIAL_SLOTS, 0)
+    {
+    }
+
+    uint32_t KeyIndex::Insert(int64_t key, bool *inserted)
+    {
+        size_t mask = slots_.size() - 1;
+        for (size_t slot = HashMix64(static_cast<uint64_t>(key)) & mask;; slot = (slot + 1) & mask)
+        {
+            uint32_t entry = slots_[slot];
+            if (entry == 0)
+            {
+                uint32_t index = static_cast<uint32_t>(keys_.size());
+                keys_.push_back(key);
+                slots_[slot] = index + 1;
+                if (keys_.size() * 2 > slots_.size())
+                {
+                    Grow();
+                }
+                *inserted = true;
+                return index;
+            }
+            if (keys_[entry - 1] == key)
+            {
+                *inserted = false;
+                return entry - 1;
+            }
+        }
+    }
+
+    uint32_t KeyIndex::Find(int64_t key) const
+    {
+        size_t mask = slots_.size() - 1;
+        for (size_t slot = HashMix64(static_cast<uint64_t>(key)) & mask;; slot = (slot + 1) & mask)
+        {
+            uint32_t entry = slots_[slot];
+            if (entry == 0)
+            {
+                return NOT_FOUND;
+            }
+            if (keys_[entry - 1] == key)
+            {
+                return entry - 1;
+            }
+        }
+    }
+
+    void KeyIndex::Grow()
+    {
+        std::vector<uint32_t> slots(slots_.size() * 2, 0);
+        size_t mask = slots.size() - 1;
+        for (size_t index = 0; index < keys_.size(); index++)
+        {
+            size_t slot = HashMix64(static_cast<uint64_t>(keys_[index])) & mask;
+            while (slots[slot] != 0)
+            {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = static_cast<uint32_t>(index + 1);
+        }
+        slots_.swap(slots);
+    }
+
+    HashAggregate::HashAggregate(uint32_t group_column, std::vector<AggregateSpec> aggregates)
+        : group_column_(group_column), aggregates_(std::move(aggregates)), merged_(new AggregateState())
+    {
+    }
+
+    HashAggregate::~HashAggregate() = default;
+
+    std::unique_ptr<OperatorState> HashAggregate::NewState()
+    {
+        return std::unique_ptr<OperatorState>(new AggregateState());
+    }
+
+    void HashAggregate::Consume(const DataChunk &chunk, OperatorState *state)
+    {
+        AggregateState *local = static_cast<AggregateState *>(state);
+        CheckKeyColumn(chunk, group_column_);
+        if (local->types.empty())
+        {
+            for (const AggregateSpec &aggregate : aggregates_)
+            {
+                CheckColumn(chunk, aggregate.column);
+                local->types.push_back(chunk.types[aggregate.column]);
+            }
+        }
+
+        // Pass 1: the group of every selected row with a key, new groups starting from the
+        // initial accumulators
+        chunk.GetSelectedRows(&local->rows);
+        local->group_ids.clear();
+        size_t kept = 0;
+        for (uint32_t row : local->rows)
+        {
+            if (!chunk.IsValid(group_column_, row))
+            {
+                continue;
+            }
+            bool inserted;
+            uint32_t group = local->groups.Insert(GetKey(chunk, group_column_, row), &inserted);
+            if (inserted)
+            {
+                for (size_t a = 0; a < aggregates_.size(); a++)
+                {
+                    local->values.push_back(InitialValue(aggregates_[a].func, local->types[a]));
+                    local->counts.push_back(0);
+                }
+            }
+            local->rows[kept++] = row;
+            local->group_ids.push_back(group);
+        }
+        local->rows.resize(kept);
+
+        // Pass 2: one loop per aggregate
+        for (size_t a = 0; a < aggregates_.size(); a++)
+        {
+            const AggregateSpec &aggregate = aggregates_[a];
+            switch (local->types[a])
+            {
+            case PaxType::INT32:
+                UpdateAggregate<int32_t>(aggregate.func, chunk, aggregate.column, a, local);
+                break;
+            case PaxType::INT64:
+                UpdateAggregate<int64_t>(aggregate.func, chunk, aggregate.column, a, local);
+                break;
+            default:
+                UpdateAggregate<double>(aggregate.func, chunk, aggregate.column, a, local);
+            }
+        }
+    }
+
+    void HashAggregate::Combine(OperatorState *state)
+    {
+        AggregateState *local = static_cast<AggregateState *>(state);
+        std::lock_guard<std::mutex> guard(latch_);
+        AggregateState *merged = static_cast<AggregateState *>(merged_.get());
+        if (merged->types.empty())
+        {
+            merged->types = local->types;
+        }
+        size_t stride = aggregates_.size();
+        for (uint32_t g = 0; g < local->groups.GetCount(); g++)
+        {
+            bool inserted;
+            uint32_t group = merged->groups.Insert(local->groups.GetKey(g), &inserted);
+            if (inserted)
+            {
+                for (size_t a = 0; a < stride; a++)
+                {
+                    merged->values.push_back(InitialValue(aggregates_[a].func, merged->types[a]));
+                    merged->counts.push_back(0);
+                }
+            }
+            for (size_t a = 0; a < stride; a++)
+            {
+                size_t from = static_cast<size_t>(g) * stride + a;
+                size_t to = static_cast<size_t>(group) * stride + a;
+                merged->counts[to] += local->counts[from];
+                MergeValue(aggregates_[a].func, merged->types[a], merged->values[to], local->values[from]);
+            }
+        }
+    }
+
+    void HashAggregate::Finalize()
+    {
+        AggregateState *merged = static_cast<AggregateState *>(merged_.get());
+        size_t stride = aggregates_.size();
+        results_.clear();
+        results_.reserve(merged->groups.GetCount());
+        for (uint32_t g = 0; g < merged->groups.GetCount(); g++)
+        {
+            AggregateRow row;
+            row.key = merged->groups.GetKey(g);
+            row.values.resize(stride);
+            for (size_t a = 0; a < stride; a++)
+            {
+                size_t slot = static_cast<size_t>(g) * stride + a;
+                if (aggregates_[a].func == AggregateFunc::COUNT)
+                {
+                    row.values[a].i = static_cast<int64_t>(merged->counts[slot]);
+                }
+                else
+                {
+                    row.values[a] = merged->values[slot];
+                }
+            }
+            results_.push_back(std::move(row));
+        }
+        std::sort(results_.begin(), results_.end(), [](const AggregateRow &a, const AggregateRow &b)
+                  { return a.key < b.key; });
+        merged_.reset(new AggregateState());
+    }
+
+    HashJoinBuild::HashJoinBuild(uint32_t key_column, std::vector<uint32_t> payload_columns)
+        : key_column_(key_column), payload_columns_(std::move(payload_columns))
+    {
+        if (payload_columns_.size() > 64)
+        {
+            throw std::invalid_argument("At most 64 payload columns");
+        }
+    }
+
+    std::unique_ptr<OperatorState> HashJoinBuild::NewState()
+    {
+        return std::unique_ptr<OperatorState>(new BuildState());
+    }
+
+    void HashJoinBuild::Consume(const DataChunk &chunk, OperatorState *state)
+    {
+        BuildState *local = static_cast<BuildState *>(state);
+        CheckKeyColumn(chunk, key_column_);
+        if (local->types.empty())
+        {
+            for (uint32_t column : payload_columns_)
+            {
+                CheckColumn(chunk, column);
+                local->types.push_back(chunk.types[column]);
+            }
+        }
+
+        chunk.GetSelectedRows(&local->rows);
+        for (uint32_t row : local->rows)
+        {
+            if (!chunk.IsValid(key_column_, row))
+            {
+                continue;
+            }
+            local->keys.push_back(GetKey(chunk, key_column_, row));
+            uint64_t null_mask = 0;
+            for (size_t p = 0; p < payload_columns_.size(); p++)
+            {
+                uint32_t column = payload_columns_[p];
+                if (chunk.IsValid(column, row))
+                {
+                    local->payload.push_back(GetBits(chunk, column, row));
+                }
+                else
+                {
+                    local->payload.push_back(0);
+                    null_mask |= uint64_t(1) << p;
+                }
+            }
+            local->null_masks.push_back(null_mask);
+        }
+    }
+
+    void HashJoinBuild::Combine(OperatorState *state)
+    {
+        BuildState *local = static_cast<BuildState *>(state);
+        std::lock_guard<std::mutex> guard(latch_);
+        if (payload_types_.empty())
+        {
+            payload_types_ = local->types;
+        }
+        keys_.insert(keys_.end(), local->keys.begin(), local->keys.end());
+        payload_.insert(payload_.end(), local->payload.begin(), local->payload.end());
+        null_masks_.insert(null_masks_.end(), local->null_masks.begin(), local->null_masks.end());
+        for (uint64_t null_mask : local->null_masks)
+        {
+            any_nulls_ |= null_mask;
+        }
+    }
+
+    void HashJoinBuild::Finalize()
+    {
+        // Chains are linked in one pass after every worker's rows are in; a probe walks a key's
+        // rows newest first
+        if (keys_.size() >= KeyIndex::NOT_FOUND)
+        {
+            throw std::runtime_error("Too many build rows");
+        }
+        index_ = KeyIndex();
+        heads_.clear();
+        next_.assign(keys_.size(), KeyIndex::NOT_FOUND);
+        for (uint32_t row = 0; row < keys_.size(); row++)
+        {
+            bool inserted;
+            uint32_t index = index_.Insert(keys_[row], &inserted);
+            if (inserted)
+            {
+                heads_.push_back(KeyIndex::NOT_FOUND);
+            }
+            next_[row] = heads_[index];
+            heads_[index] = row;
+        }
+    }
+
+    HashJoinProbe::HashJoinProbe(const HashJoinBuild *build, uint32_t key_column)
+        : build_(build), key_column_(key_column)
+    {
+    }
+
+    std::unique_ptr<OperatorState> HashJoinProbe::NewState()
+    {
+        return std::unique_ptr<OperatorState>(new ProbeState());
+    }
+
+    DataChunk *HashJoinProbe::Execute(DataChunk *input, OperatorState *state)
+    {
+        ProbeState *probe = static_cast<ProbeState *>(state);
+        CheckKeyColumn(*input, key_column_);
+
+        input->GetSelectedRows(&probe->rows);
+        probe->probe_rows.clear();
+        probe->build_rows.clear();
+        for (uint32_t row : probe->rows)
+        {
+            if (!input->IsValid(key_column_, row))
+            {
+                continue;
+            }
+            for (uint32_t match = build_->Find(GetKey(*input, key_column_, row)); match != KeyIndex::NOT_FOUND;
+                 match = build_->GetNext(match))
+            {
+                probe->probe_rows.push_back(row);
+                probe->build_rows.push_back(match);
+            }
+        }
+        size_t count = probe->probe_rows.size();
+        if (count == 0)
+        {
+            return nullptr;
+        }
+
+        const std::vector<PaxType> &payload_types = build_->GetPayloadTypes();
+        size_t input_columns = input->types.size();
+        size_t output_columns = input_columns + payload_types.size();
+        size_t words = (count + 63) / 64;
+        DataChunk &output = probe->output;
+        output.count = count;
+        output.types = input->types;
+        output.types.insert(output.types.end(), payload_types.begin(), payload_types.end());
+        output.columns.resize(output_columns);
+        output.validity.resize(output_columns);
+        output.selection = nullptr;
+        probe->buffers.resize(output_columns);
+        probe->validity.resize(output_columns);
+
+        auto gather_validity = [&](size_t column, const std::function<bool(size_t)> &is_valid)
+        {
+            std::vector<uint64_t> &bits = probe->validity[column];
+            bits.assign(words, 0);
+            for (size_t k = 0; k < count; k++)
+            {
+                if (is_valid(k))
+                {
+                    bits[k / 64] |= uint64_t(1) << (k % 64);
+                }
+            }
+            output.validity[column] = bits.data();
+        };
+
+        for (size_t c = 0; c < input_columns; c++)
+        {
+            std::vector<uint64_t> &buffer = probe->buffers[c];
+            buffer.resize(count);
+            if (input->types[c] == PaxType::INT32)
+            {
+                const int32_t *from = input->GetColumn<int32_t>(c);
+                int32_t *to = reinterpret_cast<int32_t *>(buffer.data());
+                for (size_t k = 0; k < count; k++)
+                {
+                    to[k] = from[probe->probe_rows[k]];
+                }
+            }
+            else
+            {
+                const uint64_t *from = input->GetColumn<uint64_t>(c);
+                for (size_t k = 0; k < count; k++)
+                {
+                    buffer[k] = from[probe->probe_rows[k]];
+                }
+            }
+            output.columns[c] = reinterpret_cast<const char *>(buffer.data());
+            output.validity[c] = nullptr;
+            if (input->validity[c] != nullptr)
+            {
+                gather_validity(c, [&](size_t k)
+                                { return input->IsValid(c, probe->probe_rows[k]); });
+            }
+        }
+
+        for (size_t p = 0; p < payload_types.size(); p++)
+        {
+            size_t c = input_columns + p;
+            std::vector<uint64_t> &buffer = probe->buffers[c];
+            buffer.resize(count);
+            if (payload_types[p] == PaxType::INT32)
+            {
+                int32_t *to = reinterpret_cast<int32_t *>(buffer.data());
+                for (size_t k = 0; k < count; k++)
+                {
+                    to[k] = static_cast<int32_t>(build_->GetPayload(probe->build_rows[k], p));
+                }
+            }
+            else
+            {
+                for (size_t k = 0; k < count; k++)
+                {
+                    buffer[k] = build_->GetPayload(probe->build_rows[k], p);
+                }
+            }
+            output.columns[c] = reinterpret_cast<const char *>(buffer.data());
+            output.validity[c] = nullptr;
+            if (build_->HasNulls(p))
+            {
+                gather_validity(c, [&](size_t k)
+                                { return !build_->IsPayloadNull(probe->build_rows[k], p); });
+            }
+        }
+        return &output;
+    }
+}
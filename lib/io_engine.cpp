@@ -0,0 +1,31 @@
+#include "../include/io_engine.h"
+#include "../include/uring_io_engine.h"
+#include "../include/thread_pool_io_engine.h"
+
+#include <stdexcept> // std::runtime_error
+
+namespace minidb
+{
+    std::unique_ptr<IOEngine> MakeIOEngine(IOEngineType type, size_t queue_depth)
+    {
+        switch (type)
+        {
+        case IOEngineType::IO_URING:
+            return std::make_unique<UringIOEngine>(queue_depth);
+        case IOEngineType::THREAD_POOL:
+            return std::make_unique<ThreadPoolIOEngine>(queue_depth);
+        case IOEngineType::AUTO:
+        default:
+            try
+            {
+                return std::make_unique<UringIOEngine>(queue_depth);
+            }
+            catch (const std::runtime_error &)
+            {
+                // Old kernel, seccomp filter or io_uring_disabled sysctl
+                return std::make_unique<ThreadPoolIOEngine>(queue_depth);
+            }
+        }
+    }
+
+} // namespace minidb
@@ -0,0 +1,342 @@
+#include "../include/log_manager.h"
+
+#include <algorithm> // std::min, std::max
+#include <cerrno>    // errno
+#include <cstring>   // strerror
+#include <fcntl.h>   // open
+#include <limits>    // std::numeric_limits
+#include <stdexcept> // std::runtime_error
+#include <sys/stat.h> // fstat
+#include <unistd.h>  // pread, pwrite, fdatasync, ftruncate, close
+#include <vector>    // std::vector
+
+namespace minidb
+{
+    namespace
+    {
+        /// @brief "MDB-WAL\0" read as a little-endian integer
+        const uint64_t LOG_MAGIC = 0x004C41572D42444DULL;
+
+        /// @brief Bumped on incompatible record format changes
+        const uint32_t LOG_VERSION = 1;
+
+        /// @brief Start of the log file. Records follow, so the first LSN is sizeof(LogHeader)
+        /// and zero (the LSN of a never logged page) is older than every record
+        struct LogHeader
+        {
+            uint64_t magic;
+            uint32_t version;
+            uint32_t reserved;
+        };
+
+        /// @brief pread until size bytes are read
+        /// @return False on end of file or error
+        bool ReadFully(int fd, char *buffer, size_t size, off_t offset)
+        {
+            size_t done = 0;
+            while (done < size)
+            {
+                ssize_t n = pread(fd, buffer + done, size - done, offset + static_cast<off_t>(done));
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (n <= 0)
+                {
+                    return false;
+                }
+                done += static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        /// @brief pwrite until size bytes are written
+        /// @return False on error
+        bool WriteFully(int fd, const char *buffer, size_t size, off_t offset)
+        {
+            size_t done = 0;
+            while (done < size)
+            {
+                ssize_t n = pwrite(fd, buffer + done, size - done, offset + static_cast<off_t>(done));
+                if (n < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (n <= 0)
+                {
+                    return false;
+                }
+                done += static_cast<size_t>(n);
+            }
+            return true;
+        }
+    }
+
+    LogManager::LogManager(const std::string &log_file, const LogOptions &options)
+        : file_name_(log_file), options_(options), buffer_(new char[options.buffer_bytes]),
+          flush_buffer_(new char[options.buffer_bytes])
+    {
+        fd_ = open(log_file.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0)
+        {
+            ThrowIOError("Failed to open log");
+        }
+
+        try
+        {
+            struct stat st;
+            if (fstat(fd_, &st) != 0)
+            {
+                ThrowIOError("Failed to stat log");
+            }
+
+            LogHeader header;
+            if (st.st_size == 0)
+            {
+                header = {LOG_MAGIC, LOG_VERSION, 0};
+                if (!WriteFully(fd_, reinterpret_cast<const char *>(&header), sizeof(header), 0) ||
+                    fdatasync(fd_) != 0)
+                {
+                    ThrowIOError("Failed to write header of log");
+                }
+                st.st_size = sizeof(header);
+            }
+            else if (!ReadFully(fd_, reinterpret_cast<char *>(&header), sizeof(header), 0) ||
+                     header.magic != LOG_MAGIC || header.version != LOG_VERSION)
+            {
+                throw std::runtime_error("Not a log file: " + file_name_);
+            }
+
+            next_lsn_ = Scan(static_cast<lsn_t>(st.st_size));
+        }
+        catch (...)
+        {
+            close(fd_);
+            throw;
+        }
+        buffer_lsn_ = next_lsn_;
+        flush_lsn_ = next_lsn_;
+        persistent_lsn_ = next_lsn_;
+        flusher_ = std::thread(&LogManager::RunFlusher, this);
+    }
+
+    LogManager::~LogManager()
+    {
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            stop_ = true;
+        }
+        flush_cv_.notify_one();
+        flusher_.join();
+        close(fd_);
+    }
+
+    lsn_t LogManager::Append(LogRecord *record)
+    {
+        size_t size = record->GetSize();
+        if (size > options_.buffer_bytes)
+        {
+            throw std::runtime_error("Log record of " + std::to_string(size) + " bytes exceeds log buffer of " +
+                                     file_name_);
+        }
+
+        std::unique_lock<std::mutex> lock(latch_);
+        while (io_error_.empty() && static_cast<size_t>(next_lsn_ - buffer_lsn_) + size > options_.buffer_bytes)
+        {
+            // Buffer full, have it written and wait for the swap
+            flush_requested_ = std::max(flush_requested_, next_lsn_ - 1);
+            flush_cv_.notify_one();
+            done_cv_.wait(lock);
+        }
+        if (!io_error_.empty())
+        {
+            throw std::runtime_error(io_error_);
+        }
+
+        record->lsn = next_lsn_;
+        record->Serialize(buffer_.get() + (next_lsn_ - buffer_lsn_));
+        next_lsn_ += static_cast<lsn_t>(size);
+        stats_.records++;
+        return record->lsn;
+    }
+
+    void LogManager::Flush(lsn_t lsn)
+    {
+        std::unique_lock<std::mutex> lock(latch_);
+        lsn = std::min(lsn, next_lsn_ - 1);
+        if (lsn < persistent_lsn_)
+        {
+            return;
+        }
+
+        // Every committer waiting here when the flusher swaps buffers shares one sync
+        if (lsn > flush_requested_)
+        {
+            flush_requested_ = lsn;
+            flush_cv_.notify_one();
+        }
+        done_cv_.wait(lock, [&]()
+                      { return persistent_lsn_ > lsn || !io_error_.empty(); });
+        if (persistent_lsn_ <= lsn)
+        {
+            throw std::runtime_error(io_error_);
+        }
+    }
+
+    void LogManager::FlushAll()
+    {
+        Flush(std::numeric_limits<lsn_t>::max());
+    }
+
+    bool LogManager::ReadRecord(lsn_t lsn, LogRecord *record)
+    {
+        std::unique_lock<std::mutex> lock(latch_);
+        if (lsn < GetFirstLSN() || lsn >= next_lsn_)
+        {
+            return false;
+        }
+
+        // Not written yet: parse straight from the buffers
+        const char *source = nullptr;
+        size_t available = 0;
+        if (lsn >= buffer_lsn_)
+        {
+            source = buffer_.get() + (lsn - buffer_lsn_);
+            available = static_cast<size_t>(next_lsn_ - lsn);
+        }
+        else if (lsn >= flush_lsn_)
+        {
+            source = flush_buffer_.get() + (lsn - flush_lsn_);
+            available = static_cast<size_t>(buffer_lsn_ - lsn);
+        }
+        if (source != nullptr)
+        {
+            return LogRecord::Deserialize(source, available, record) && record->lsn == lsn;
+        }
+
+        lsn_t end = flush_lsn_;
+        lock.unlock();
+        return ReadFromFile(lsn, end, record);
+    }
+
+    lsn_t LogManager::GetFirstLSN()
+    {
+        return static_cast<lsn_t>(sizeof(LogHeader));
+    }
+
+    lsn_t LogManager::GetNextLSN()
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        return next_lsn_;
+    }
+
+    lsn_t LogManager::GetPersistentLSN()
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        return persistent_lsn_;
+    }
+
+    LogStats LogManager::GetStats()
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        return stats_;
+    }
+
+    void LogManager::RunFlusher()
+    {
+        std::unique_lock<std::mutex> lock(latch_);
+        while (true)
+        {
+            flush_cv_.wait(lock, [&]()
+                           { return stop_ || (flush_requested_ >= buffer_lsn_ && next_lsn_ > buffer_lsn_); });
+            if (next_lsn_ == buffer_lsn_)
+            {
+                if (stop_)
+                {
+                    break;
+                }
+                continue;
+            }
+
+            // Linger so more committers join this sync, unless the buffer is filling up
+            if (options_.group_commit_delay.count() > 0 && !stop_)
+            {
+                flush_cv_.wait_for(lock, options_.group_commit_delay, [&]()
+                                   { return stop_ || static_cast<size_t>(next_lsn_ - buffer_lsn_) > options_.buffer_bytes / 2; });
+            }
+
+            // Swap buffers so appends continue while this one is written
+            std::swap(buffer_, flush_buffer_);
+            flush_lsn_ = buffer_lsn_;
+            buffer_lsn_ = next_lsn_;
+            lsn_t end = buffer_lsn_;
+            done_cv_.notify_all();
+            lock.unlock();
+
+            size_t size = static_cast<size_t>(end - flush_lsn_);
+            bool written = WriteFully(fd_, flush_buffer_.get(), size, static_cast<off_t>(flush_lsn_));
+            bool synced = written && (!options_.sync || fdatasync(fd_) == 0);
+            std::string error = synced ? "" : std::string("Failed to write log ") + file_name_ + ": " + strerror(errno);
+
+            lock.lock();
+            flush_lsn_ = end;
+            if (!synced)
+            {
+                io_error_ = error;
+                done_cv_.notify_all();
+                break;
+            }
+            persistent_lsn_ = end;
+            stats_.flushes++;
+            stats_.syncs += options_.sync ? 1 : 0;
+            stats_.bytes_written += size;
+            done_cv_.notify_all();
+        }
+    }
+
+    lsn_t LogManager::Scan(lsn_t file_size)
+    {
+        lsn_t lsn = GetFirstLSN();
+        LogRecord record;
+        while (ReadFromFile(lsn, file_size, &record))
+        {
+            lsn += static_cast<lsn_t>(record.GetSize());
+        }
+
+        // Torn or garbage tail from a crash mid-write
+        if (lsn < file_size && ftruncate(fd_, static_cast<off_t>(lsn)) != 0)
+        {
+            ThrowIOError("Failed to truncate log");
+        }
+        return lsn;
+    }
+
+    bool LogManager::ReadFromFile(lsn_t lsn, lsn_t end, LogRecord *record)
+    {
+        char header[LogRecord::HEADER_SIZE];
+        if (lsn + static_cast<lsn_t>(sizeof(header)) > end ||
+            !ReadFully(fd_, header, sizeof(header), static_cast<off_t>(lsn)))
+        {
+            return false;
+        }
+        uint32_t size = LogRecord::PeekSize(header);
+        if (size < sizeof(header) || lsn + static_cast<lsn_t>(size) > end)
+        {
+            return false;
+        }
+
+        std::vector<char> bytes(size);
+        memcpy(bytes.data(), header, sizeof(header));
+        if (size > sizeof(header) &&
+            !ReadFully(fd_, bytes.data() + sizeof(header), size - sizeof(header), static_cast<off_t>(lsn) + sizeof(header)))
+        {
+            return false;
+        }
+        return LogRecord::Deserialize(bytes.data(), size, record) && record->lsn == lsn;
+    }
+
+    void LogManager::ThrowIOError(const std::string &what)
+    {
+        throw std::runtime_error(what + " " + file_name_ + ": " + strerror(errno));
+    }
+}
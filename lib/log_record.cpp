@@ -0,0 +1,103 @@
+#include "../include/log_record.h"
+
+namespace minidb
+{
+    namespace
+    {
+        /// @brief Fixed part of a record as laid out on disk, HEADER_SIZE bytes
+        struct RecordHeader
+        {
+            uint32_t size;
+            uint32_t checksum;
+            uint32_t type;
+            uint32_t offset;
+            int64_t lsn;
+            int64_t txn_id;
+            int64_t prev_lsn;
+            int64_t page_id;
+            int64_t undo_next_lsn;
+            uint32_t before_size;
+            uint32_t after_size;
+        };
+        static_assert(sizeof(RecordHeader) == LogRecord::HEADER_SIZE, "Log record header layout changed");
+
+        /// @brief FNV-1a over a byte range
+        uint32_t Checksum(const char *data, size_t size)
+        {
+            uint32_t hash = 2166136261u;
+            for (size_t i = 0; i < size; i++)
+            {
+                hash ^= static_cast<unsigned char>(data[i]);
+                hash *= 16777619u;
+            }
+            return hash;
+        }
+
+        /// @brief Bytes covered by the checksum: everything after the checksum field
+        const size_t CHECKSUM_START = 2 * sizeof(uint32_t);
+    }
+
+    void LogRecord::Serialize(char *out) const
+    {
+        RecordHeader header;
+        header.size = static_cast<uint32_t>(GetSize());
+        header.checksum = 0;
+        header.type = static_cast<uint32_t>(type);
+        header.offset = offset;
+        header.lsn = lsn;
+        header.txn_id = txn_id;
+        header.prev_lsn = prev_lsn;
+        header.page_id = page_id;
+        header.undo_next_lsn = undo_next_lsn;
+        header.before_size = static_cast<uint32_t>(before_image.size());
+        header.after_size = static_cast<uint32_t>(after_image.size());
+        memcpy(out, &header, HEADER_SIZE);
+        if (!before_image.empty())
+        {
+            memcpy(out + HEADER_SIZE, before_image.data(), before_image.size());
+        }
+        if (!after_image.empty())
+        {
+            memcpy(out + HEADER_SIZE + before_image.size(), after_image.data(), after_image.size());
+        }
+
+        uint32_t checksum = Checksum(out + CHECKSUM_START, header.size - CHECKSUM_START);
+        memcpy(out + sizeof(uint32_t), &checksum, sizeof(checksum));
+    }
+
+    uint32_t LogRecord::PeekSize(const char *header)
+    {
+        uint32_t size;
+        memcpy(&size, header, sizeof(size));
+        return size;
+    }
+
+    bool LogRecord::Deserialize(const char *in, size_t available, LogRecord *record)
+    {
+        if (available < HEADER_SIZE)
+        {
+            return false;
+        }
+        RecordHeader header;
+        memcpy(&header, in, HEADER_SIZE);
+        if (header.size < HEADER_SIZE || header.size > available ||
+            static_cast<uint64_t>(header.before_size) + header.after_size != header.size - HEADER_SIZE ||
+            header.type == static_cast<uint32_t>(LogRecordType::INVALID) ||
+            header.type > static_cast<uint32_t>(LogRecordType::CLR) ||
+            Checksum(in + CHECKSUM_START, header.size - CHECKSUM_START) != header.checksum)
+        {
+            return false;
+        }
+
+        record->type = static_cast<LogRecordType>(header.type);
+        record->lsn = header.lsn;
+        record->txn_id = header.txn_id;
+        record->prev_lsn = header.prev_lsn;
+        record->page_id = header.page_id;
+        record->offset = header.offset;
+        record->undo_next_lsn = header.undo_next_lsn;
+        record->before_image.assign(in + HEADER_SIZE, in + HEADER_SIZE + header.before_size);
+        record->after_image.assign(in + HEADER_SIZE + header.before_size, in + header.size);
+        return true;
+    }
+}
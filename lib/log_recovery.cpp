@@ -0,0 +1,138 @@
+#include "../include/log_recovery.h"
+
+#include <algorithm>     // std::max
+#include <queue>         // std::priority_queue
+#include <stdexcept>     // std::runtime_error
+#include <unordered_map> // std::unordered_map
+#include <utility>       // std::pair
+
+namespace minidb
+{
+    template <int32_t PageSize>
+    BasicLogRecovery<PageSize>::BasicLogRecovery(BasicDiskManager<PageSize> *dm, basic_buffer_pool<PageSize> *pool,
+                                                 LogManager *log_manager)
+        : disk_manager_(dm), pool_(pool), log_manager_(log_manager)
+    {
+        // Compensation records written by undo must reach the log before the pages they change
+        pool_->SetLogManager(log_manager_);
+    }
+
+    template <int32_t PageSize>
+    RecoveryStats BasicLogRecovery<PageSize>::Recover()
+    {
+        RecoveryStats stats;
+        txn_id_t max_txn_id = INVALID_TXN_ID;
+
+        // Analysis and redo: repeat history, remembering the last record of unfinished transactions
+        std::unordered_map<txn_id_t, lsn_t> losers;
+        LogRecord record;
+        lsn_t end = log_manager_->GetNextLSN();
+        for (lsn_t lsn = log_manager_->GetFirstLSN(); lsn < end && log_manager_->ReadRecord(lsn, &record);
+             lsn += static_cast<lsn_t>(record.GetSize()))
+        {
+            stats.records++;
+            max_txn_id = std::max(max_txn_id, record.txn_id);
+            switch (record.type)
+            {
+            case LogRecordType::COMMIT:
+            case LogRecordType::ABORT:
+                losers.erase(record.txn_id);
+                break;
+            case LogRecordType::UPDATE:
+            case LogRecordType::CLR:
+                if (Redo(record))
+                {
+                    stats.redone++;
+                }
+                losers[record.txn_id] = lsn;
+                break;
+            default:
+                losers[record.txn_id] = lsn;
+                break;
+            }
+        }
+        stats.losers = losers.size();
+
+        // Undo: always the newest record still to undo across all losers
+        std::priority_queue<std::pair<lsn_t, txn_id_t>> to_undo;
+        for (const auto &loser : losers)
+        {
+            to_undo.push({loser.second, loser.first});
+        }
+        while (!to_undo.empty())
+        {
+            lsn_t lsn = to_undo.top().first;
+            txn_id_t txn_id = to_undo.top().second;
+            to_undo.pop();
+            if (!log_manager_->ReadRecord(lsn, &record))
+            {
+                throw std::runtime_error("Missing log record " + std::to_string(lsn) + " of transaction " +
+                                         std::to_string(txn_id));
+            }
+
+            if (record.type == LogRecordType::UPDATE)
+            {
+                LogRecord clr;
+                clr.type = LogRecordType::CLR;
+                clr.txn_id = txn_id;
+                clr.prev_lsn = losers[txn_id];
+                clr.page_id = record.page_id;
+                clr.offset = record.offset;
+                clr.undo_next_lsn = record.prev_lsn;
+                clr.after_image = record.before_image;
+
+                BasicPage<PageSize> *page = pool_->FetchPage(record.page_id);
+                losers[txn_id] = log_manager_->Append(&clr);
+                memcpy(page->GetData() + clr.offset, clr.after_image.data(), clr.after_image.size());
+                page->SetLSN(losers[txn_id]);
+                pool_->UnpinPage(record.page_id, true);
+                stats.undone++;
+            }
+
+            lsn_t next = record.type == LogRecordType::CLR ? record.undo_next_lsn : record.prev_lsn;
+            if (next != INVALID_LSN)
+            {
+                to_undo.push({next, txn_id});
+                continue;
+            }
+
+            LogRecord abort;
+            abort.type = LogRecordType::ABORT;
+            abort.txn_id = txn_id;
+            abort.prev_lsn = losers[txn_id];
+            log_manager_->Append(&abort);
+        }
+
+        log_manager_->FlushAll();
+        stats.next_txn_id = max_txn_id + 1;
+        return stats;
+    }
+
+    template <int32_t PageSize>
+    bool BasicLogRecovery<PageSize>::Redo(const LogRecord &record)
+    {
+        if (record.offset < BasicPage<PageSize>::HEADER_SIZE ||
+            record.offset + record.after_image.size() > static_cast<size_t>(PageSize))
+        {
+            throw std::runtime_error("Log record " + std::to_string(record.lsn) + " outside page data");
+        }
+
+        // Allocation is not logged, the page may be missing from metadata that was never synced
+        disk_manager_->MarkAllocated(record.page_id);
+
+        BasicPage<PageSize> *page = pool_->FetchPage(record.page_id);
+        bool apply = page->GetLSN() < record.lsn;
+        if (apply)
+        {
+            memcpy(page->GetData() + record.offset, record.after_image.data(), record.after_image.size());
+            page->SetLSN(record.lsn);
+        }
+        pool_->UnpinPage(record.page_id, apply);
+        return apply;
+    }
+
+    template class BasicLogRecovery<4096>;
+    template class BasicLogRecovery<8192>;
+    template class BasicLogRecovery<16384>;
+    template class BasicLogRecovery<65536>;
+}
@@ -0,0 +1,147 @@
+#include "../include/lru_k_replacer.h"
+
+namespace minidb
+{
+    LRUKReplacer::LRUKReplacer(size_t num_frames, size_t k)
+        : k_(k == 0 ? 1 : k), history_(num_frames * k_, 0), access_count_(num_frames, 0),
+          tracked_(num_frames, false), evictable_(num_frames, false), young_(num_frames)
+    {
+    }
+
+    void LRUKReplacer::RecordAccess(frame_id_t frame_id, page_id_t)
+    {
+        if (!tracked_[frame_id])
+        {
+            tracked_[frame_id] = true;
+            access_count_[frame_id] = 0;
+            young_.PushFront(frame_id);
+        }
+
+        uint64_t count = access_count_[frame_id];
+        if (count >= k_)
+        {
+            old_.erase({KthTimestamp(frame_id), frame_id});
+        }
+
+        history_[frame_id * k_ + count % k_] = ++current_timestamp_;
+        access_count_[frame_id] = ++count;
+
+        if (count == k_)
+        {
+            young_.Erase(frame_id);
+        }
+        if (count >= k_)
+        {
+            old_.insert({KthTimestamp(frame_id), frame_id});
+        }
+    }
+
+    void LRUKReplacer::SetEvictable(frame_id_t frame_id, bool evictable)
+    {
+        if (!tracked_[frame_id] || evictable_[frame_id] == evictable)
+        {
+            return;
+        }
+        evictable_[frame_id] = evictable;
+        if (evictable)
+        {
+            evictable_count_++;
+        }
+        else
+        {
+            evictable_count_--;
+        }
+    }
+
+    bool LRUKReplacer::Evict(frame_id_t *frame_id_ptr)
+    {
+        if (evictable_count_ == 0)
+        {
+            return false;
+        }
+
+        // Infinite distance first, oldest first access first. Pinned frames are skipped in place
+        frame_id_t victim = INVALID_FRAME_ID;
+        for (frame_id_t frame_id = young_.Back(); frame_id != INVALID_FRAME_ID; frame_id = young_.Prev(frame_id))
+        {
+            if (evictable_[frame_id])
+            {
+                victim = frame_id;
+                break;
+            }
+        }
+        if (victim == INVALID_FRAME_ID)
+        {
+            for (const auto &entry : old_)
+            {
+                if (evictable_[entry.second])
+                {
+                    victim = entry.second;
+                    break;
+                }
+            }
+        }
+        if (victim == INVALID_FRAME_ID)
+        {
+            return false;
+        }
+
+        Remove(victim);
+        *frame_id_ptr = victim;
+        return true;
+    }
+
+    void LRUKReplacer::Remove(frame_id_t frame_id)
+    {
+        if (!tracked_[frame_id])
+        {
+            return;
+        }
+        Unlink(frame_id);
+        if (evictable_[frame_id])
+        {
+            evictable_count_--;
+        }
+        tracked_[frame_id] = false;
+        evictable_[frame_id] = false;
+        access_count_[frame_id] = 0;
+    }
+
+    void LRUKReplacer::Unlink(frame_id_t frame_id)
+    {
+        if (access_count_[frame_id] >= k_)
+        {
+            old_.erase({KthTimestamp(frame_id), frame_id});
+        }
+        else
+        {
+            young_.Erase(frame_id);
+        }
+    }
+
+    void LRUKReplacer::GetCandidates(size_t count, std::vector<frame_id_t> *candidates)
+    {
+        for (frame_id_t frame_id = young_.Back(); frame_id != INVALID_FRAME_ID && count > 0; frame_id = young_.Prev(frame_id))
+        {
+            if (evictable_[frame_id])
+            {
+                candidates->push_back(frame_id);
+                count--;
+            }
+        }
+        for (auto entry = old_.begin(); entry != old_.end() && count > 0; ++entry)
+        {
+            if (evictable_[entry->second])
+            {
+                candidates->push_back(entry->second);
+                count--;
+            }
+        }
+    }
+
+    size_t LRUKReplacer::Size()
+    {
+        return evictable_count_;
+    }
+
+} // namespace minidb
@@ -0,0 +1,73 @@
+#include "../include/lru_replacer.h"
+
+namespace minidb
+{
+    LRUReplacer::LRUReplacer(size_t num_frames)
+        : lru_list_(num_frames), tracked_(num_frames, false)
+    {
+    }
+
+    void LRUReplacer::RecordAccess(frame_id_t frame_id, page_id_t)
+    {
+        if (!tracked_[frame_id])
+        {
+            tracked_[frame_id] = true;
+            return;
+        }
+        // Pinned frames are not linked, they move to the head once unpinned
+        if (lru_list_.Contains(frame_id))
+        {
+            lru_list_.MoveToFront(frame_id);
+        }
+    }
+
+    void LRUReplacer::SetEvictable(frame_id_t frame_id, bool evictable)
+    {
+        if (!tracked_[frame_id])
+        {
+            return;
+        }
+        if (evictable && !lru_list_.Contains(frame_id))
+        {
+            lru_list_.PushFront(frame_id);
+        }
+        else if (!evictable)
+        {
+            lru_list_.Erase(frame_id);
+        }
+    }
+
+    bool LRUReplacer::Evict(frame_id_t *frame_id_ptr)
+    {
+        frame_id_t victim = lru_list_.Back();
+        if (victim == INVALID_FRAME_ID)
+        {
+            return false;
+        }
+        lru_list_.Erase(victim);
+        tracked_[victim] = false;
+        *frame_id_ptr = victim;
+        return true;
+    }
+
+    void LRUReplacer::Remove(frame_id_t frame_id)
+    {
+        lru_list_.Erase(frame_id);
+        tracked_[frame_id] = false;
+    }
+
+    void LRUReplacer::GetCandidates(size_t count, std::vector<frame_id_t> *candidates)
+    {
+        for (frame_id_t frame_id = lru_list_.Back(); frame_id != INVALID_FRAME_ID && count > 0;
+             frame_id = lru_list_.Prev(frame_id), count--)
+        {
+            candidates->push_back(frame_id);
+        }
+    }
+
+    size_t LRUReplacer::Size()
+    {
+        return lru_list_.Size();
+    }
+
+} // namespace minidb
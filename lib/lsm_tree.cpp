@@ -0,0 +1,925 @@
+#include "../include/lsm_tree.h"
+
+#include <algorithm> // std::sort, std::lower_bound, std::find
+#include <chrono>    // std::chrono::steady_clock
+#include <cstring>   // memcpy, memset
+#include <stdexcept> // std::runtime_error
+
+namespace minidb
+{
+    class LsmSource
+    {
+    public:
+        virtual ~LsmSource() = default;
+        virtual bool Valid() const = 0;
+        virtual void SeekToFirst() = 0;
+        virtual void Seek(std::string_view key) = 0;
+        virtual void Next() = 0;
+        virtual std::string_view GetKey() const = 0;
+        virtual std::string_view GetValue() const = 0;
+        virtual bool IsDeleted() const = 0;
+    };
+
+    namespace
+    {
+        /// @brief "MINILSM\0"
+        const uint64_t MANIFEST_MAGIC = 0x004D534C494E494DULL;
+
+        struct ManifestHeader
+        {
+            uint64_t magic;
+            uint32_t blob_size;
+            uint32_t blob_pages;
+        };
+
+        class MemSource : public LsmSource
+        {
+        public:
+            explicit MemSource(const MemTable *table) : iterator_(table)
+            {
+            }
+
+            bool Valid() const override
+            {
+                return iterator_.Valid();
+            }
+
+            void SeekToFirst() override
+            {
+                iterator_.SeekToFirst();
+            }
+
+            void Seek(std::string_view key) override
+            {
+                iterator_.Seek(key);
+            }
+
+            void Next() override
+            {
+                iterator_.Next();
+            }
+
+            std::string_view GetKey() const override
+            {
+                return iterator_.GetKey();
+            }
+
+            std::string_view GetValue() const override
+            {
+                return iterator_.GetValue();
+            }
+
+            bool IsDeleted() const override
+            {
+                return iterator_.IsDeleted();
+            }
+
+        private:
+            MemTable::Iterator iterator_;
+        };
+
+        /// @brief Tables of one level >= 1, disjoint and sorted, read one after another
+        template <int32_t PageSize>
+        class LevelSource : public LsmSource
+        {
+            using Table = BasicSSTable<PageSize>;
+
+        public:
+            explicit LevelSource(std::vector<const Table *> tables) : tables_(std::move(tables))
+            {
+            }
+
+            bool Valid() const override
+            {
+                return iterator_ != nullptr && iterator_->Valid();
+            }
+
+            void SeekToFirst() override
+            {
+                Open(0);
+                if (iterator_ != nullptr)
+                {
+                    iterator_->SeekToFirst();
+                }
+                SkipExhausted();
+            }
+
+            void Seek(std::string_view key) override
+            {
+                auto table = std::lower_bound(tables_.begin(), tables_.end(), key,
+                                              [](const Table *table, std::string_view target)
+                                              { return std::string_view(table->GetLargest()) < target; });
+                Open(static_cast<size_t>(table - tables_.begin()));
+                if (iterator_ != nullptr)
+                {
+                    iterator_->Seek(key);
+                }
+                SkipExhausted();
+            }
+
+            void Next() override
+            {
+                iterator_->Next();
+                SkipExhausted();
+            }
+
+            std::string_view GetKey() const override
+            {
+                return iterator_->GetKey();
+            }
+
+            std::string_view GetValue() const override
+            {
+                return iterator_->GetValue();
+            }
+
+            bool IsDeleted() const override
+            {
+                return iterator_->IsDeleted();
+            }
+
+        private:
+            std::vector<const Table *> tables_;
+            size_t index_ = 0;
+            std::unique_ptr<typename Table::Iterator> iterator_;
+
+            void Open(size_t index)
+            {
+                index_ = index;
+                iterator_.reset(index < tables_.size() ? new typename Table::Iterator(tables_[index]) : nullptr);
+            }
+
+            void SkipExhausted()
+            {
+                while (iterator_ != nullptr && !iterator_->Valid())
+                {
+                    Open(index_ + 1);
+                    if (iterator_ != nullptr)
+                    {
+                        iterator_->SeekToFirst();
+                    }
+                }
+            }
+        };
+
+        /// @brief Merges sources ordered newest first. Of entries with equal keys only the newest
+        /// is returned, tombstones included
+        class MergingSource : public LsmSource
+        {
+        public:
+            explicit MergingSource(std::vector<std::unique_ptr<LsmSource>> children) : children_(std::move(children))
+            {
+            }
+
+            bool Valid() const override
+            {
+                return current_ != nullptr;
+            }
+
+            void SeekToFirst() override
+            {
+                for (auto &child : children_)
+                {
+                    child->SeekToFirst();
+                }
+                FindSmallest();
+            }
+
+            void Seek(std::string_view key) override
+            {
+                for (auto &child : children_)
+                {
+                    child->Seek(key);
+                }
+                FindSmallest();
+            }
+
+            void Next() override
+            {
+                // Older versions of the key sit at the front of the other children; skip them too
+                key_.assign(current_->GetKey());
+                for (auto &child : children_)
+                {
+                    if (child->Valid() && child->GetKey() == std::string_view(key_))
+                    {
+                        child->Next();
+                    }
+                }
+                FindSmallest();
+            }
+
+            std::string_view GetKey() const override
+            {
+                return current_->GetKey();
+            }
+
+            std::string_view GetValue() const override
+            {
+                return current_->GetValue();
+            }
+
+            bool IsDeleted() const override
+            {
+                return current_->IsDeleted();
+            }
+
+        private:
+            std::vector<std::unique_ptr<LsmSource>> children_;
+            LsmSource *current_ = nullptr;
+            std::string key_;
+
+            void FindSmallest()
+            {
+                // Strictly less, so the newest child wins ties
+                current_ = nullptr;
+                for (auto &child : children_)
+                {
+                    if (child->Valid() && (current_ == nullptr || child->GetKey() < current_->GetKey()))
+                    {
+                        current_ = child.get();
+                    }
+                }
+            }
+        };
+
+        template <int32_t PageSize>
+        std::unique_ptr<LsmSource> NewTableSource(const BasicSSTable<PageSize> *table)
+        {
+            return std::unique_ptr<LsmSource>(new LevelSource<PageSize>(std::vector<const BasicSSTable<PageSize> *>{table}));
+        }
+
+        template <int32_t PageSize>
+        std::unique_ptr<LsmSource> NewLevelSource(const std::vector<std::shared_ptr<BasicSSTable<PageSize>>> &tables)
+        {
+            std::vector<const BasicSSTable<PageSize> *> raw;
+            for (const auto &table : tables)
+            {
+                raw.push_back(table.get());
+            }
+            return std::unique_ptr<LsmSource>(new LevelSource<PageSize>(std::move(raw)));
+        }
+
+        template <int32_t PageSize>
+        bool BySmallest(const std::shared_ptr<BasicSSTable<PageSize>> &a, const std::shared_ptr<BasicSSTable<PageSize>> &b)
+        {
+            return a->GetSmallest() < b->GetSmallest();
+        }
+    }
+
+    template <int32_t PageSize>
+    BasicLsmTree<PageSize>::Iterator::Iterator(std::shared_ptr<MemTable> mem, std::shared_ptr<MemTable> imm,
+                                               std::shared_ptr<const Version> version)
+        : mem_(std::move(mem)), imm_(std::move(imm)), version_(std::move(version))
+    {
+        std::vector<std::unique_ptr<LsmSource>> children;
+        children.emplace_back(new MemSource(mem_.get()));
+        if (imm_ != nullptr)
+        {
+            children.emplace_back(new MemSource(imm_.get()));
+        }
+        for (const auto &table : version_->levels[0])
+        {
+            children.push_back(NewTableSource<PageSize>(table.get()));
+        }
+        for (int level = 1; level < NUM_LEVELS; level++)
+        {
+            if (!version_->levels[level].empty())
+            {
+                children.push_back(NewLevelSource<PageSize>(version_->levels[level]));
+            }
+        }
+        merged_.reset(new MergingSource(std::move(children)));
+    }
+
+    template <int32_t PageSize>
+    BasicLsmTree<PageSize>::Iterator::Iterator(Iterator &&other) noexcept = default;
+
+    template <int32_t PageSize>
+    BasicLsmTree<PageSize>::Iterator::~Iterator() = default;
+
+    template <int32_t PageSize>
+    bool BasicLsmTree<PageSize>::Iterator::Valid() const
+    {
+        return merged_->Valid();
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::Iterator::SeekToFirst()
+    {
+        merged_->SeekToFirst();
+        SkipDeleted();
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::Iterator::Seek(std::string_view key)
+    {
+        merged_->Seek(key);
+        SkipDeleted();
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::Iterator::Next()
+    {
+        merged_->Next();
+        SkipDeleted();
+    }
+
+    template <int32_t PageSize>
+    std::string_view BasicLsmTree<PageSize>::Iterator::GetKey() const
+    {
+        return merged_->GetKey();
+    }
+
+    template <int32_t PageSize>
+    std::string_view BasicLsmTree<PageSize>::Iterator::GetValue() const
+    {
+        return merged_->GetValue();
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::Iterator::SkipDeleted()
+    {
+        while (merged_->Valid() && merged_->IsDeleted())
+        {
+            merged_->Next();
+        }
+    }
+
+    template <int32_t PageSize>
+    BasicLsmTree<PageSize>::BasicLsmTree(BasicDiskManager<PageSize> *disk_manager, const LsmOptions &options)
+        : disk_manager_(disk_manager), options_(options), header_page_id_(disk_manager->AllocatePage())
+    {
+        Install(std::make_shared<Version>());
+        Start();
+    }
+
+    template <int32_t PageSize>
+    BasicLsmTree<PageSize>::BasicLsmTree(BasicDiskManager<PageSize> *disk_manager, page_id_t header_page_id,
+                                         const LsmOptions &options)
+        : disk_manager_(disk_manager), options_(options), header_page_id_(header_page_id)
+    {
+        Recover();
+        Start();
+    }
+
+    template <int32_t PageSize>
+    BasicLsmTree<PageSize>::~BasicLsmTree()
+    {
+        try
+        {
+            Flush();
+        }
+        catch (const std::exception &)
+        {
+            // A failed background thread already lost the memtable's chance to be written
+        }
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            stop_ = true;
+        }
+        work_cv_.notify_one();
+        thread_.join();
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::Start()
+    {
+        mem_ = std::make_shared<MemTable>();
+        stats_.level_tables.assign(NUM_LEVELS, 0);
+        stats_.level_bytes.assign(NUM_LEVELS, 0);
+        thread_ = std::thread(&BasicLsmTree::Run, this);
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::Put(std::string_view key, std::string_view value)
+    {
+        Write(key, value, false);
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::Delete(std::string_view key)
+    {
+        Write(key, std::string_view(), true);
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::Write(std::string_view key, std::string_view value, bool deleted)
+    {
+        if (key.size() + value.size() > MAX_ENTRY_BYTES)
+        {
+            throw std::runtime_error("Entry of " + std::to_string(key.size() + value.size()) +
+                                     " bytes exceeds the LSM tree limit of " + std::to_string(MAX_ENTRY_BYTES));
+        }
+
+        std::lock_guard<std::mutex> writer(write_latch_);
+        {
+            std::unique_lock<std::mutex> lock(latch_);
+            MakeRoomForWrite(lock);
+        }
+        // Only writers replace mem_, and they hold write_latch_
+        mem_->Put(key, value, deleted);
+        user_bytes_.fetch_add(key.size() + value.size(), std::memory_order_relaxed);
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::MakeRoomForWrite(std::unique_lock<std::mutex> &lock)
+    {
+        bool stalled = false;
+        auto start = std::chrono::steady_clock::now();
+        while (true)
+        {
+            if (!bg_error_.empty())
+            {
+                throw std::runtime_error("LSM tree background thread failed: " + bg_error_);
+            }
+            if (mem_->GetMemoryUsage() < options_.memtable_bytes)
+            {
+                break;
+            }
+            if (imm_ != nullptr ||
+                version_->levels[0].size() >= static_cast<size_t>(options_.l0_stop_writes_trigger))
+            {
+                stalled = true;
+                done_cv_.wait(lock);
+                continue;
+            }
+            imm_ = mem_;
+            mem_ = std::make_shared<MemTable>();
+            work_cv_.notify_one();
+        }
+        if (stalled)
+        {
+            stats_.stalls++;
+            stats_.stall_micros += static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+    }
+
+    template <int32_t PageSize>
+    bool BasicLsmTree<PageSize>::Get(std::string_view key, std::string *value)
+    {
+        std::shared_ptr<MemTable> mem, imm;
+        std::shared_ptr<const Version> version;
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            mem = mem_;
+            imm = imm_;
+            version = version_;
+        }
+
+        bool deleted = false;
+        if (mem->Get(key, value, &deleted) || (imm != nullptr && imm->Get(key, value, &deleted)))
+        {
+            return !deleted;
+        }
+        for (const auto &table : version->levels[0])
+        {
+            if (table->Overlaps(key, key) && table->Get(key, value, &deleted))
+            {
+                return !deleted;
+            }
+        }
+        for (int level = 1; level < NUM_LEVELS; level++)
+        {
+            const auto &tables = version->levels[level];
+            auto table = std::lower_bound(tables.begin(), tables.end(), key,
+                                          [](const std::shared_ptr<Table> &table, std::string_view target)
+                                          { return std::string_view(table->GetLargest()) < target; });
+            if (table != tables.end() && (*table)->Overlaps(key, key) && (*table)->Get(key, value, &deleted))
+            {
+                return !deleted;
+            }
+        }
+        return false;
+    }
+
+    template <int32_t PageSize>
+    typename BasicLsmTree<PageSize>::Iterator BasicLsmTree<PageSize>::NewIterator()
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        return Iterator(mem_, imm_, version_);
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::Flush()
+    {
+        std::lock_guard<std::mutex> writer(write_latch_);
+        std::unique_lock<std::mutex> lock(latch_);
+        auto flushed = [this]
+        { return imm_ == nullptr || !bg_error_.empty(); };
+        done_cv_.wait(lock, flushed);
+        if (bg_error_.empty() && mem_->GetCount() > 0)
+        {
+            imm_ = mem_;
+            mem_ = std::make_shared<MemTable>();
+            work_cv_.notify_one();
+            done_cv_.wait(lock, flushed);
+        }
+        if (!bg_error_.empty())
+        {
+            throw std::runtime_error("LSM tree background thread failed: " + bg_error_);
+        }
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::WaitForCompaction()
+    {
+        std::unique_lock<std::mutex> lock(latch_);
+        done_cv_.wait(lock, [this]
+                      { return !bg_error_.empty() || (!busy_ && imm_ == nullptr && PickLevel(*version_) < 0); });
+        if (!bg_error_.empty())
+        {
+            throw std::runtime_error("LSM tree background thread failed: " + bg_error_);
+        }
+    }
+
+    template <int32_t PageSize>
+    LsmStats BasicLsmTree<PageSize>::GetStats()
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        LsmStats stats = stats_;
+        stats.user_bytes = user_bytes_.load(std::memory_order_relaxed);
+        for (int level = 0; level < NUM_LEVELS; level++)
+        {
+            stats.level_tables[level] = version_->levels[level].size();
+            stats.level_bytes[level] = LevelBytes(*version_, level);
+        }
+        return stats;
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::Run()
+    {
+        std::unique_lock<std::mutex> lock(latch_);
+        while (true)
+        {
+            int level = -1;
+            while (!stop_ && (!bg_error_.empty() || (imm_ == nullptr && (level = PickLevel(*version_)) < 0)))
+            {
+                work_cv_.wait(lock);
+            }
+            // On stop, a pending memtable is still written; compactions wait for the next open
+            if (!bg_error_.empty() || (stop_ && imm_ == nullptr))
+            {
+                return;
+            }
+
+            busy_ = true;
+            try
+            {
+                if (imm_ != nullptr)
+                {
+                    FlushImmutable(lock);
+                }
+                else
+                {
+                    Compact(lock, level);
+                }
+            }
+            catch (const std::exception &e)
+            {
+                if (!lock.owns_lock())
+                {
+                    lock.lock();
+                }
+                bg_error_ = e.what();
+            }
+            busy_ = false;
+            done_cv_.notify_all();
+        }
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::FlushImmutable(std::unique_lock<std::mutex> &lock)
+    {
+        std::shared_ptr<MemTable> imm = imm_;
+        std::shared_ptr<const Version> base = version_;
+        lock.unlock();
+
+        // Tombstones are kept: older tables may still hold the key
+        typename Table::Builder builder(disk_manager_, options_.bloom_bits_per_key);
+        MemTable::Iterator entry(imm.get());
+        for (entry.SeekToFirst(); entry.Valid(); entry.Next())
+        {
+            builder.Add(entry.GetKey(), entry.GetValue(), entry.IsDeleted());
+        }
+        std::shared_ptr<Table> table = builder.Finish();
+
+        auto version = std::make_shared<Version>(*base);
+        if (table != nullptr)
+        {
+            version->levels[0].insert(version->levels[0].begin(), table);
+        }
+        Install(version);
+
+        lock.lock();
+        imm_ = nullptr;
+        stats_.flushes++;
+        stats_.flush_bytes += table != nullptr ? table->GetFileBytes() : 0;
+    }
+
+    template <int32_t PageSize>
+    int BasicLsmTree<PageSize>::PickLevel(const Version &version)
+    {
+        int best_level = -1;
+        double best_score = 1.0;
+        double score = static_cast<double>(version.levels[0].size()) / options_.l0_compaction_trigger;
+        if (score >= best_score)
+        {
+            best_level = 0;
+            best_score = score;
+        }
+        // The last level has nowhere to go
+        for (int level = 1; level < NUM_LEVELS - 1; level++)
+        {
+            score = static_cast<double>(LevelBytes(version, level)) / MaxBytesForLevel(level);
+            if (score > best_score || (score >= 1.0 && best_level < 0))
+            {
+                best_level = level;
+                best_score = score;
+            }
+        }
+        return best_level;
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::Compact(std::unique_lock<std::mutex> &lock, int level)
+    {
+        std::shared_ptr<const Version> base = version_;
+        std::string pointer = compact_pointer_[level];
+        lock.unlock();
+
+        // Level 0 tables overlap, so all of them go; a deeper level gives the table after the
+        // last one compacted, wrapping around
+        std::vector<std::shared_ptr<Table>> inputs;
+        const auto &tables = base->levels[level];
+        if (level == 0)
+        {
+            inputs = tables;
+        }
+        else
+        {
+            auto next = std::find_if(tables.begin(), tables.end(),
+                                     [&pointer](const std::shared_ptr<Table> &table)
+                                     { return table->GetSmallest() > pointer; });
+            inputs.push_back(next != tables.end() ? *next : tables.front());
+        }
+        std::string smallest = inputs.front()->GetSmallest();
+        std::string largest = inputs.front()->GetLargest();
+        for (const auto &table : inputs)
+        {
+            smallest = std::min(smallest, table->GetSmallest());
+            largest = std::max(largest, table->GetLargest());
+        }
+        std::vector<std::shared_ptr<Table>> overlapping;
+        for (const auto &table : base->levels[level + 1])
+        {
+            if (table->Overlaps(smallest, largest))
+            {
+                overlapping.push_back(table);
+            }
+        }
+
+        auto version = std::make_shared<Version>(*base);
+        auto &from = version->levels[level];
+        auto &to = version->levels[level + 1];
+        for (const auto &table : inputs)
+        {
+            from.erase(std::find(from.begin(), from.end(), table));
+        }
+        for (const auto &table : overlapping)
+        {
+            to.erase(std::find(to.begin(), to.end(), table));
+        }
+
+        bool trivial = inputs.size() == 1 && overlapping.empty();
+        uint64_t bytes_read = 0;
+        uint64_t bytes_written = 0;
+        if (trivial)
+        {
+            to.push_back(inputs.front());
+        }
+        else
+        {
+            std::vector<std::unique_ptr<LsmSource>> children;
+            for (const auto &table : inputs)
+            {
+                children.push_back(NewTableSource<PageSize>(table.get()));
+                bytes_read += table->GetFileBytes();
+            }
+            children.push_back(NewLevelSource<PageSize>(overlapping));
+            for (const auto &table : overlapping)
+            {
+                bytes_read += table->GetFileBytes();
+            }
+            MergingSource merged(std::move(children));
+
+            std::unique_ptr<typename Table::Builder> builder;
+            auto finish = [&]()
+            {
+                std::shared_ptr<Table> output = builder->Finish();
+                builder.reset();
+                if (output != nullptr)
+                {
+                    bytes_written += output->GetFileBytes();
+                    to.push_back(output);
+                }
+            };
+            for (merged.SeekToFirst(); merged.Valid(); merged.Next())
+            {
+                if (merged.IsDeleted() && IsBaseLevelForKey(*base, level + 1, merged.GetKey()))
+                {
+                    continue;
+                }
+                if (builder == nullptr)
+                {
+                    builder.reset(new typename Table::Builder(disk_manager_, options_.bloom_bits_per_key));
+                }
+                builder->Add(merged.GetKey(), merged.GetValue(), merged.IsDeleted());
+                if (builder->GetFileBytes() >= options_.table_bytes)
+                {
+                    finish();
+                }
+            }
+            if (builder != nullptr)
+            {
+                finish();
+            }
+        }
+        std::sort(to.begin(), to.end(), BySmallest<PageSize>);
+        Install(version);
+
+        if (!trivial)
+        {
+            // Freed once the last version or iterator that reads them lets go
+            for (const auto &table : inputs)
+            {
+                table->MarkObsolete();
+            }
+            for (const auto &table : overlapping)
+            {
+                table->MarkObsolete();
+            }
+        }
+
+        lock.lock();
+        compact_pointer_[level] = largest;
+        if (trivial)
+        {
+            stats_.trivial_moves++;
+        }
+        else
+        {
+            stats_.compactions++;
+            stats_.compaction_bytes_read += bytes_read;
+            stats_.compaction_bytes_written += bytes_written;
+        }
+    }
+
+    template <int32_t PageSize>
+    uint64_t BasicLsmTree<PageSize>::MaxBytesForLevel(int level)
+    {
+        uint64_t bytes = options_.level1_bytes;
+        for (int i = 1; i < level; i++)
+        {
+            bytes *= options_.level_multiplier;
+        }
+        return bytes;
+    }
+
+    template <int32_t PageSize>
+    bool BasicLsmTree<PageSize>::IsBaseLevelForKey(const Version &version, int output_level, std::string_view key)
+    {
+        for (int level = output_level + 1; level < NUM_LEVELS; level++)
+        {
+            const auto &tables = version.levels[level];
+            auto table = std::lower_bound(tables.begin(), tables.end(), key,
+                                          [](const std::shared_ptr<Table> &table, std::string_view target)
+                                          { return std::string_view(table->GetLargest()) < target; });
+            if (table != tables.end() && (*table)->Overlaps(key, key))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::Install(std::shared_ptr<const Version> version)
+    {
+        std::string blob;
+        for (int level = 0; level < NUM_LEVELS; level++)
+        {
+            uint32_t count = static_cast<uint32_t>(version->levels[level].size());
+            blob.append(reinterpret_cast<const char *>(&count), sizeof(count));
+            for (const auto &table : version->levels[level])
+            {
+                page_id_t page_id = table->GetMetaPageId();
+                blob.append(reinterpret_cast<const char *>(&page_id), sizeof(page_id));
+            }
+        }
+
+        size_t blob_pages = (blob.size() + PageSize - 1) / PageSize;
+        if (sizeof(ManifestHeader) + blob_pages * sizeof(page_id_t) > static_cast<size_t>(PageSize))
+        {
+            throw std::runtime_error("LSM manifest does not fit one header page");
+        }
+        alignas(PAGE_ALIGNMENT) char page[PageSize];
+        std::vector<page_id_t> pages;
+        for (size_t i = 0; i < blob_pages; i++)
+        {
+            size_t chunk = std::min<size_t>(PageSize, blob.size() - i * PageSize);
+            memcpy(page, blob.data() + i * PageSize, chunk);
+            memset(page + chunk, 0, PageSize - chunk);
+            pages.push_back(disk_manager_->AllocatePage(false));
+            disk_manager_->WritePage(pages.back(), page);
+        }
+        // New tables and blob reach the disk before the header refers to them, and the header
+        // before the tables it replaces can be freed and overwritten
+        disk_manager_->Sync();
+
+        memset(page, 0, PageSize);
+        ManifestHeader header{MANIFEST_MAGIC, static_cast<uint32_t>(blob.size()), static_cast<uint32_t>(blob_pages)};
+        memcpy(page, &header, sizeof(header));
+        memcpy(page + sizeof(header), pages.data(), blob_pages * sizeof(page_id_t));
+        disk_manager_->WritePage(header_page_id_, page);
+        disk_manager_->Sync();
+
+        for (page_id_t page_id : manifest_pages_)
+        {
+            disk_manager_->DeallocatePage(page_id);
+        }
+        manifest_pages_ = std::move(pages);
+
+        std::lock_guard<std::mutex> guard(latch_);
+        version_ = std::move(version);
+        stats_.manifest_bytes += (blob_pages + 1) * PageSize;
+    }
+
+    template <int32_t PageSize>
+    void BasicLsmTree<PageSize>::Recover()
+    {
+        alignas(PAGE_ALIGNMENT) char page[PageSize];
+        disk_manager_->ReadPage(header_page_id_, page);
+        ManifestHeader header;
+        memcpy(&header, page, sizeof(header));
+        if (header.magic != MANIFEST_MAGIC ||
+            sizeof(header) + header.blob_pages * sizeof(page_id_t) > static_cast<size_t>(PageSize) ||
+            header.blob_size > static_cast<uint64_t>(header.blob_pages) * PageSize)
+        {
+            throw std::runtime_error("Page " + std::to_string(header_page_id_) + " is not an LSM tree header");
+        }
+        manifest_pages_.resize(header.blob_pages);
+        memcpy(manifest_pages_.data(), page + sizeof(header), header.blob_pages * sizeof(page_id_t));
+
+        std::string blob;
+        for (page_id_t page_id : manifest_pages_)
+        {
+            disk_manager_->ReadPage(page_id, page);
+            blob.append(page, PageSize);
+        }
+        blob.resize(header.blob_size);
+
+        auto version = std::make_shared<Version>();
+        size_t pos = 0;
+        for (int level = 0; level < NUM_LEVELS; level++)
+        {
+            uint32_t count;
+            if (pos + sizeof(count) > blob.size())
+            {
+                throw std::runtime_error("Corrupt LSM manifest");
+            }
+            memcpy(&count, blob.data() + pos, sizeof(count));
+            pos += sizeof(count);
+            if (pos + count * sizeof(page_id_t) > blob.size())
+            {
+                throw std::runtime_error("Corrupt LSM manifest");
+            }
+            for (uint32_t i = 0; i < count; i++)
+            {
+                page_id_t page_id;
+                memcpy(&page_id, blob.data() + pos, sizeof(page_id));
+                pos += sizeof(page_id);
+                version->levels[level].push_back(Table::Open(disk_manager_, page_id));
+            }
+        }
+        version_ = std::move(version);
+    }
+
+    template <int32_t PageSize>
+    uint64_t BasicLsmTree<PageSize>::LevelBytes(const Version &version, int level)
+    {
+        uint64_t bytes = 0;
+        for (const auto &table : version.levels[level])
+        {
+            bytes += table->GetFileBytes();
+        }
+        return bytes;
+    }
+
+    template class BasicLsmTree<4096>;
+    template class BasicLsmTree<8192>;
+    template class BasicLsmTree<16384>;
+    template class BasicLsmTree<65536>;
+
+} // namespace minidb
@@ -0,0 +1,256 @@
+#include "../include/lz_codec.h"
+
+#include <cstring> // memcpy, memset
+
+namespace minidb
+{
+    namespace
+    {
+        inline uint32_t Load32(const uint8_t *p)
+        {
+            uint32_t value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        inline uint64_t Load64(const uint8_t *p)
+        {
+            uint64_t value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        /// @brief Writes length - 15 as a run of 255 bytes and a final byte below 255
+        /// @return False if out of room
+        inline bool PutLength(uint8_t **out, uint8_t *end, size_t length)
+        {
+            while (length >= 255)
+            {
+                if (*out == end)
+                {
+                    return false;
+                }
+                *(*out)++ = 255;
+                length -= 255;
+            }
+            if (*out == end)
+            {
+                return false;
+            }
+            *(*out)++ = static_cast<uint8_t>(length);
+            return true;
+        }
+
+        /// @brief Reads a length continuation written by PutLength
+        /// @return False if the input ends inside it
+        inline bool GetLength(const uint8_t **in, const uint8_t *end, size_t *length)
+        {
+            uint8_t byte;
+            do
+            {
+                if (*in == end)
+                {
+                    return false;
+                }
+                byte = *(*in)++;
+                *length += byte;
+            } while (byte == 255);
+            return true;
+        }
+
+        /// @brief Emits one sequence: literals [literal, literal + literal_length), then a match
+        /// unless match_length is 0
+        /// @return False if out of room
+        inline bool PutSequence(uint8_t **out, uint8_t *end, const uint8_t *literal, size_t literal_length,
+                                size_t offset, size_t match_length)
+        {
+            if (*out == end)
+            {
+                return false;
+            }
+            uint8_t *token = (*out)++;
+            *token = static_cast<uint8_t>((literal_length < 15 ? literal_length : 15) << 4);
+            if (literal_length >= 15 && !PutLength(out, end, literal_length - 15))
+            {
+                return false;
+            }
+            if (static_cast<size_t>(end - *out) < literal_length)
+            {
+                return false;
+            }
+            memcpy(*out, literal, literal_length);
+            *out += literal_length;
+            if (match_length == 0)
+            {
+                return true;
+            }
+
+            if (end - *out < 2)
+            {
+                return false;
+            }
+            *(*out)++ = static_cast<uint8_t>(offset);
+            *(*out)++ = static_cast<uint8_t>(offset >> 8);
+            size_t extra = match_length - 4;
+            *token |= static_cast<uint8_t>(extra < 15 ? extra : 15);
+            return extra < 15 || PutLength(out, end, extra - 15);
+        }
+    }
+
+    size_t LzCodec::Compress(const char *src, size_t size, char *dst, size_t capacity)
+    {
+        if (size > MAX_BLOCK_SIZE)
+        {
+            return 0;
+        }
+        const uint8_t *in = reinterpret_cast<const uint8_t *>(src);
+        uint8_t *out = reinterpret_cast<uint8_t *>(dst);
+        uint8_t *out_end = out + capacity;
+
+        // Position + 1 of the last occurrence of each hashed 4-byte sequence, 0 for none
+        uint32_t table[1 << HASH_BITS];
+        memset(table, 0, sizeof(table));
+
+        size_t anchor = 0;
+        size_t pos = 0;
+        while (size >= MIN_MATCH && pos <= size - MIN_MATCH)
+        {
+            uint32_t sequence = Load32(in + pos);
+            uint32_t &slot = table[Hash(sequence)];
+            size_t candidate = slot;
+            slot = static_cast<uint32_t>(pos + 1);
+            if (candidate == 0 || pos - (candidate - 1) > MAX_OFFSET || Load32(in + candidate - 1) != sequence)
+            {
+                // Step further the longer nothing matched, so incompressible data is given up fast
+                pos += 1 + ((pos - anchor) >> 5);
+                continue;
+            }
+            candidate--;
+
+            // Extend forward 8 bytes at a time, then byte by byte
+            size_t length = MIN_MATCH;
+            while (pos + length + 8 <= size)
+            {
+                uint64_t diff = Load64(in + pos + length) ^ Load64(in + candidate + length);
+                if (diff != 0)
+                {
+                    length += static_cast<size_t>(__builtin_ctzll(diff)) / 8;
+                    break;
+                }
+                length += 8;
+            }
+            if (pos + length + 8 > size)
+            {
+                while (pos + length < size && in[pos + length] == in[candidate + length])
+                {
+                    length++;
+                }
+            }
+
+            // Extend backward into the pending literals
+            while (pos > anchor && candidate > 0 && in[pos - 1] == in[candidate - 1])
+            {
+                pos--;
+                candidate--;
+                length++;
+            }
+
+            if (!PutSequence(&out, out_end, in + anchor, pos - anchor, pos - candidate, length))
+            {
+                return 0;
+            }
+            pos += length;
+            anchor = pos;
+            if (pos >= 2 && pos - 2 + MIN_MATCH <= size)
+            {
+                table[Hash(Load32(in + pos - 2))] = static_cast<uint32_t>(pos - 2 + 1);
+            }
+        }
+
+        if (!PutSequence(&out, out_end, in + anchor, size - anchor, 0, 0))
+        {
+            return 0;
+        }
+        return static_cast<size_t>(out - reinterpret_cast<uint8_t *>(dst));
+    }
+
+    bool LzCodec::Decompress(const char *src, size_t size, char *dst, size_t original_size)
+    {
+        const uint8_t *in = reinterpret_cast<const uint8_t *>(src);
+        const uint8_t *in_end = in + size;
+        uint8_t *out = reinterpret_cast<uint8_t *>(dst);
+        uint8_t *out_begin = out;
+        uint8_t *out_end = out + original_size;
+
+        while (in < in_end)
+        {
+            uint8_t token = *in++;
+            size_t literal_length = token >> 4;
+            if (literal_length == 15 && !GetLength(&in, in_end, &literal_length))
+            {
+                return false;
+            }
+            if (static_cast<size_t>(in_end - in) < literal_length ||
+                static_cast<size_t>(out_end - out) < literal_length)
+            {
+                return false;
+            }
+            if (literal_length <= 16 && in_end - in >= 16 && out_end - out >= 16)
+            {
+                // Short run with room to spare: one fixed-size copy, the excess is overwritten later
+                memcpy(out, in, 16);
+            }
+            else
+            {
+                memcpy(out, in, literal_length);
+            }
+            in += literal_length;
+            out += literal_length;
+            if (in == in_end)
+            {
+                break;
+            }
+
+            if (in_end - in < 2)
+            {
+                return false;
+            }
+            size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+            in += 2;
+            size_t match_length = token & 15;
+            if (match_length == 15 && !GetLength(&in, in_end, &match_length))
+            {
+                return false;
+            }
+            match_length += MIN_MATCH;
+            if (offset == 0 || offset > static_cast<size_t>(out - out_begin) ||
+                static_cast<size_t>(out_end - out) < match_length)
+            {
+                return false;
+            }
+
+            // A match may overlap its own output (offset < length) to repeat a pattern. Copying
+            // what lies between match and out never overlaps, and doubles the span each time
+            const uint8_t *match = out - offset;
+            if (offset >= 16 && static_cast<size_t>(out_end - out) >= match_length + 16)
+            {
+                for (size_t copied = 0; copied < match_length; copied += 16)
+                {
+                    memcpy(out + copied, match + copied, 16);
+                }
+                out += match_length;
+                continue;
+            }
+            while (match_length > 0)
+            {
+                size_t span = static_cast<size_t>(out - match);
+                size_t chunk = span < match_length ? span : match_length;
+                memcpy(out, match, chunk);
+                out += chunk;
+                match_length -= chunk;
+            }
+        }
+        return out == out_end;
+    }
+
+} // namespace minidb
@@ -0,0 +1,185 @@
+#include "../include/mem_table.h"
+
+#include <cstring> // memcpy
+#include <new>     // placement new
+
+namespace minidb
+{
+    void MemTable::Iterator::SeekToFirst()
+    {
+        node_ = table_->head_->next[0].load(std::memory_order_acquire);
+        Load();
+    }
+
+    void MemTable::Iterator::Seek(std::string_view key)
+    {
+        node_ = table_->FindGreaterOrEqual(key, nullptr);
+        Load();
+    }
+
+    void MemTable::Iterator::Next()
+    {
+        node_ = node_->next[0].load(std::memory_order_acquire);
+        Load();
+    }
+
+    void MemTable::Iterator::Load()
+    {
+        value_ = node_ != nullptr ? node_->value.load(std::memory_order_acquire) : nullptr;
+    }
+
+    MemTable::MemTable()
+    {
+        head_ = NewNode(std::string_view(), MAX_HEIGHT);
+    }
+
+    void MemTable::Put(std::string_view key, std::string_view value, bool deleted)
+    {
+        const Value *record = NewValue(deleted ? std::string_view() : value, deleted);
+
+        Node *prev[MAX_HEIGHT];
+        Node *node = FindGreaterOrEqual(key, prev);
+        if (node != nullptr && Compare(node->GetKey(), key) == 0)
+        {
+            // The old value stays in the arena for readers that already loaded it
+            node->value.store(record, std::memory_order_release);
+            return;
+        }
+
+        int height = RandomHeight();
+        int current_height = height_.load(std::memory_order_relaxed);
+        if (height > current_height)
+        {
+            for (int level = current_height; level < height; level++)
+            {
+                prev[level] = head_;
+            }
+            // Readers that see the new height before the node find head_ pointing past it, fine
+            height_.store(height, std::memory_order_relaxed);
+        }
+
+        node = NewNode(key, height);
+        node->value.store(record, std::memory_order_relaxed);
+        for (int level = 0; level < height; level++)
+        {
+            // Link bottom up: a reader that finds the node on a level can always go down from it
+            node->next[level].store(prev[level]->next[level].load(std::memory_order_relaxed),
+                                    std::memory_order_relaxed);
+            prev[level]->next[level].store(node, std::memory_order_release);
+        }
+        count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool MemTable::Get(std::string_view key, std::string *value, bool *deleted) const
+    {
+        Node *node = FindGreaterOrEqual(key, nullptr);
+        if (node == nullptr || Compare(node->GetKey(), key) != 0)
+        {
+            return false;
+        }
+        const Value *record = node->value.load(std::memory_order_acquire);
+        *deleted = record->deleted;
+        if (!record->deleted)
+        {
+            value->assign(record->data, record->size);
+        }
+        return true;
+    }
+
+    char *MemTable::Allocate(size_t bytes)
+    {
+        bytes = (bytes + alignof(void *) - 1) & ~(alignof(void *) - 1);
+        memory_usage_.fetch_add(bytes, std::memory_order_relaxed);
+        if (bytes > alloc_remaining_)
+        {
+            size_t block_bytes = bytes > BLOCK_BYTES / 4 ? bytes : BLOCK_BYTES;
+            blocks_.emplace_back(new char[block_bytes]);
+            if (block_bytes != BLOCK_BYTES)
+            {
+                // Oversized request: keep carving from the current block afterwards
+                return blocks_.back().get();
+            }
+            alloc_ptr_ = blocks_.back().get();
+            alloc_remaining_ = block_bytes;
+        }
+        char *result = alloc_ptr_;
+        alloc_ptr_ += bytes;
+        alloc_remaining_ -= bytes;
+        return result;
+    }
+
+    MemTable::Node *MemTable::NewNode(std::string_view key, int height)
+    {
+        size_t node_bytes = sizeof(Node) + sizeof(std::atomic<Node *>) * (height - 1);
+        char *memory = Allocate(node_bytes + key.size());
+        Node *node = new (memory) Node();
+        for (int level = 1; level < height; level++)
+        {
+            new (&node->next[level]) std::atomic<Node *>(nullptr);
+        }
+        node->next[0].store(nullptr, std::memory_order_relaxed);
+        char *key_copy = memory + node_bytes;
+        if (!key.empty())
+        {
+            memcpy(key_copy, key.data(), key.size());
+        }
+        node->key = key_copy;
+        node->key_size = static_cast<uint32_t>(key.size());
+        node->height = height;
+        node->value.store(nullptr, std::memory_order_relaxed);
+        return node;
+    }
+
+    const MemTable::Value *MemTable::NewValue(std::string_view value, bool deleted)
+    {
+        Value *record = reinterpret_cast<Value *>(Allocate(offsetof(Value, data) + value.size()));
+        record->size = static_cast<uint32_t>(value.size());
+        record->deleted = deleted;
+        if (!value.empty())
+        {
+            memcpy(record->data, value.data(), value.size());
+        }
+        return record;
+    }
+
+    int MemTable::RandomHeight()
+    {
+        // xorshift64*, two bits per level
+        random_state_ ^= random_state_ >> 12;
+        random_state_ ^= random_state_ << 25;
+        random_state_ ^= random_state_ >> 27;
+        uint64_t bits = random_state_ * 0x2545f4914f6cdd1dull;
+        int height = 1;
+        while (height < MAX_HEIGHT && (bits & 3) == 0)
+        {
+            height++;
+            bits >>= 2;
+        }
+        return height;
+    }
+
+    MemTable::Node *MemTable::FindGreaterOrEqual(std::string_view key, Node **prev) const
+    {
+        Node *node = head_;
+        int level = height_.load(std::memory_order_relaxed) - 1;
+        while (true)
+        {
+            Node *next = node->next[level].load(std::memory_order_acquire);
+            if (next != nullptr && Compare(next->GetKey(), key) < 0)
+            {
+                node = next;
+                continue;
+            }
+            if (prev != nullptr)
+            {
+                prev[level] = node;
+            }
+            if (level == 0)
+            {
+                return next;
+            }
+            level--;
+        }
+    }
+
+} // namespace minidb
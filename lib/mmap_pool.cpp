@@ -0,0 +1,364 @@
+#include "../include/mmap_pool.h"
+
+#include <algorithm>    // std::sort, std::min, std::find
+#include <cerrno>       // errno
+#include <cstring>      // strerror
+#include <stdexcept>    // std::runtime_error, std::out_of_range
+#include <string>       // std::string, std::to_string
+#include <sys/mman.h>   // mmap, munmap, msync, madvise, mincore
+#include <sys/stat.h>   // fstat
+#include <unistd.h>     // ftruncate, sysconf
+
+namespace minidb
+{
+    namespace
+    {
+        int AdviceFlag(MmapAdvice advice)
+        {
+            switch (advice)
+            {
+            case MmapAdvice::RANDOM:
+                return MADV_RANDOM;
+            case MmapAdvice::SEQUENTIAL:
+                return MADV_SEQUENTIAL;
+            default:
+                return MADV_NORMAL;
+            }
+        }
+
+        [[noreturn]] void ThrowMmapError(const std::string &what)
+        {
+            throw std::runtime_error(what + ": " + strerror(errno));
+        }
+    }
+
+    template <int32_t PageSize>
+    basic_mmap_pool<PageSize>::basic_mmap_pool(BasicDiskManager<PageSize> *dm, const MmapOptions &options)
+        : disk_manager_(dm), writable_(options.writable), page_count_(static_cast<size_t>(dm->GetNumPages())),
+          segment_pages_(dm->GetSegmentBytes() / PageSize)
+    {
+        size_t chunk_count = (page_count_ + CHUNK_PAGES - 1) / CHUNK_PAGES;
+        chunks_.reset(new std::atomic<BasicPage<PageSize> *>[chunk_count]);
+        for (size_t i = 0; i < chunk_count; i++)
+        {
+            chunks_[i].store(nullptr, std::memory_order_relaxed);
+        }
+        chunk_storage_.reserve(chunk_count);
+        if (page_count_ == 0)
+        {
+            return;
+        }
+
+        int prot = writable_ ? PROT_READ | PROT_WRITE : PROT_READ;
+        int flags = MAP_SHARED | (options.populate ? MAP_POPULATE : 0);
+        uint64_t last = BasicDiskManager<PageSize>::PhysicalPage(static_cast<page_id_t>(page_count_ - 1));
+
+        // Any data page of a segment opens it; a segment holding only bitmap pages has none
+        std::vector<page_id_t> probes(last / segment_pages_ + 1, INVALID_PAGE_ID);
+        for (page_id_t page_id = static_cast<page_id_t>(page_count_) - 1; page_id >= 0; page_id--)
+        {
+            probes[BasicDiskManager<PageSize>::PhysicalPage(page_id) / segment_pages_] = page_id;
+        }
+
+        try
+        {
+            for (uint64_t segment = 0; segment < probes.size(); segment++)
+            {
+                if (probes[segment] == INVALID_PAGE_ID)
+                {
+                    segments_.push_back({});
+                    continue;
+                }
+
+                // Every segment but the last is mapped whole, so page offsets stay simple
+                uint64_t pages = segment < last / segment_pages_ ? segment_pages_ : last % segment_pages_ + 1;
+                size_t length = static_cast<size_t>(pages * PageSize);
+                int fd = -1;
+                off_t offset = 0;
+                dm->LocatePage(probes[segment], &fd, &offset);
+
+                // Touching a mapped page past the end of the file raises SIGBUS; allocated pages
+                // never written read as zeros, like ReadPage
+                struct stat st;
+                if (fstat(fd, &st) != 0)
+                {
+                    ThrowMmapError("Failed to stat segment " + std::to_string(segment));
+                }
+                if (static_cast<size_t>(st.st_size) < length && ftruncate(fd, static_cast<off_t>(length)) != 0)
+                {
+                    ThrowMmapError("Failed to extend segment " + std::to_string(segment));
+                }
+
+                void *data = mmap(nullptr, length, prot, flags, fd, 0);
+                if (data == MAP_FAILED)
+                {
+                    ThrowMmapError("Failed to map segment " + std::to_string(segment));
+                }
+                segments_.push_back({static_cast<char *>(data), length});
+                madvise(data, length, AdviceFlag(options.advice));
+            }
+        }
+        catch (...)
+        {
+            for (const Segment &segment : segments_)
+            {
+                if (segment.data != nullptr)
+                {
+                    munmap(segment.data, segment.length);
+                }
+            }
+            throw;
+        }
+    }
+
+    template <int32_t PageSize>
+    basic_mmap_pool<PageSize>::~basic_mmap_pool()
+    {
+        if (writable_)
+        {
+            try
+            {
+                FlushAllPages();
+            }
+            catch (const std::exception &)
+            {
+                // Unmapping still hands dirty pages to the kernel, which writes them back later
+            }
+        }
+        for (const Segment &segment : segments_)
+        {
+            if (segment.data != nullptr)
+            {
+                munmap(segment.data, segment.length);
+            }
+        }
+    }
+
+    template <int32_t PageSize>
+    BasicPage<PageSize> *basic_mmap_pool<PageSize>::FetchPage(page_id_t page_id)
+    {
+        if (page_id < 0 || static_cast<size_t>(page_id) >= page_count_)
+        {
+            throw std::out_of_range("Page " + std::to_string(page_id) + " is outside the mapping");
+        }
+        size_t chunk = static_cast<size_t>(page_id) / CHUNK_PAGES;
+        BasicPage<PageSize> *pages = chunks_[chunk].load(std::memory_order_acquire);
+        if (pages == nullptr)
+        {
+            pages = LoadChunk(chunk);
+        }
+        BasicPage<PageSize> *page = &pages[static_cast<size_t>(page_id) % CHUNK_PAGES];
+        page->IncrementPinCount();
+        fetches_.Add();
+        return page;
+    }
+
+    template <int32_t PageSize>
+    void basic_mmap_pool<PageSize>::UnpinPage(page_id_t page_id, bool is_dirty)
+    {
+        if (page_id < 0 || static_cast<size_t>(page_id) >= page_count_)
+        {
+            return;
+        }
+        BasicPage<PageSize> *pages = chunks_[static_cast<size_t>(page_id) / CHUNK_PAGES].load(std::memory_order_acquire);
+        if (pages == nullptr)
+        {
+            return;
+        }
+        BasicPage<PageSize> *page = &pages[static_cast<size_t>(page_id) % CHUNK_PAGES];
+        if (page->GetPinCount() <= 0)
+        {
+            return;
+        }
+        if (is_dirty)
+        {
+            if (!writable_)
+            {
+                throw std::runtime_error("Page " + std::to_string(page_id) + " changed in a read-only mapping");
+            }
+            std::lock_guard<std::mutex> guard(latch_);
+            if (!page->IsDirty())
+            {
+                page->SetDirty(true);
+                dirty_.push_back(page_id);
+            }
+        }
+        page->DecrementPinCount();
+    }
+
+    template <int32_t PageSize>
+    void basic_mmap_pool<PageSize>::FlushPage(page_id_t page_id)
+    {
+        std::vector<page_id_t> page_ids;
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            auto it = std::find(dirty_.begin(), dirty_.end(), page_id);
+            if (it == dirty_.end())
+            {
+                return;
+            }
+            *it = dirty_.back();
+            dirty_.pop_back();
+            page_ids.push_back(page_id);
+        }
+        SyncPages(page_ids);
+    }
+
+    template <int32_t PageSize>
+    void basic_mmap_pool<PageSize>::FlushAllPages()
+    {
+        std::vector<page_id_t> page_ids;
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            page_ids.swap(dirty_);
+        }
+        std::sort(page_ids.begin(), page_ids.end());
+        SyncPages(page_ids);
+    }
+
+    template <int32_t PageSize>
+    void basic_mmap_pool<PageSize>::Advise(MmapAdvice advice, page_id_t first, size_t count)
+    {
+        AdviseRange(AdviceFlag(advice), first, count);
+    }
+
+    template <int32_t PageSize>
+    void basic_mmap_pool<PageSize>::Prefetch(page_id_t first, size_t count)
+    {
+        AdviseRange(MADV_WILLNEED, first, count);
+    }
+
+    template <int32_t PageSize>
+    bool basic_mmap_pool<PageSize>::IsResident(page_id_t page_id)
+    {
+        if (page_id < 0 || static_cast<size_t>(page_id) >= page_count_)
+        {
+            return false;
+        }
+        static const size_t os_page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        unsigned char resident[PageSize / PAGE_ALIGNMENT];
+        if (mincore(PageAddress(page_id), PageSize, resident) != 0)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < PageSize / os_page; i++)
+        {
+            if ((resident[i] & 1) == 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <int32_t PageSize>
+    MmapPoolStats basic_mmap_pool<PageSize>::GetStats()
+    {
+        MmapPoolStats stats;
+        stats.fetches = fetches_.Load();
+        stats.pages_synced = pages_synced_.Load();
+        stats.msync_calls = msync_calls_.Load();
+        std::lock_guard<std::mutex> guard(latch_);
+        for (const std::vector<BasicPage<PageSize>> &chunk : chunk_storage_)
+        {
+            stats.pages_touched += chunk.size();
+        }
+        return stats;
+    }
+
+    template <int32_t PageSize>
+    char *basic_mmap_pool<PageSize>::PageAddress(page_id_t page_id)
+    {
+        uint64_t physical = BasicDiskManager<PageSize>::PhysicalPage(page_id);
+        return segments_[physical / segment_pages_].data + (physical % segment_pages_) * PageSize;
+    }
+
+    template <int32_t PageSize>
+    BasicPage<PageSize> *basic_mmap_pool<PageSize>::LoadChunk(size_t chunk)
+    {
+        std::lock_guard<std::mutex> guard(latch_);
+        BasicPage<PageSize> *pages = chunks_[chunk].load(std::memory_order_acquire);
+        if (pages != nullptr)
+        {
+            return pages;
+        }
+
+        size_t first = chunk * CHUNK_PAGES;
+        size_t count = std::min(CHUNK_PAGES, page_count_ - first);
+        std::vector<BasicPage<PageSize>> descriptors;
+        descriptors.reserve(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            page_id_t page_id = static_cast<page_id_t>(first + i);
+            descriptors.emplace_back(PageAddress(page_id));
+            descriptors.back().SetPageId(page_id);
+        }
+        // Moving the vector keeps its buffer, so the pointer published stays valid
+        chunk_storage_.push_back(std::move(descriptors));
+        pages = chunk_storage_.back().data();
+        chunks_[chunk].store(pages, std::memory_order_release);
+        return pages;
+    }
+
+    template <int32_t PageSize>
+    void basic_mmap_pool<PageSize>::SyncPages(const std::vector<page_id_t> &page_ids)
+    {
+        size_t i = 0;
+        while (i < page_ids.size())
+        {
+            // Extend the run while the next page follows on disk: same bitmap group and segment
+            char *start = PageAddress(page_ids[i]);
+            size_t run = 1;
+            while (i + run < page_ids.size() && page_ids[i + run] == page_ids[i] + static_cast<page_id_t>(run) &&
+                   PageAddress(page_ids[i + run]) == start + run * PageSize)
+            {
+                run++;
+            }
+
+            // Cleared before the sync, so a change racing with it marks the page dirty again
+            {
+                std::lock_guard<std::mutex> guard(latch_);
+                for (size_t j = 0; j < run; j++)
+                {
+                    size_t index = static_cast<size_t>(page_ids[i + j]);
+                    chunks_[index / CHUNK_PAGES].load(std::memory_order_acquire)[index % CHUNK_PAGES].SetDirty(false);
+                }
+            }
+            if (msync(start, run * PageSize, MS_SYNC) != 0)
+            {
+                ThrowMmapError("Failed to sync page " + std::to_string(page_ids[i]));
+            }
+            msync_calls_.Add();
+            pages_synced_.Add(run);
+            i += run;
+        }
+    }
+
+    template <int32_t PageSize>
+    void basic_mmap_pool<PageSize>::AdviseRange(int advice, page_id_t first, size_t count)
+    {
+        if (first < 0 || static_cast<size_t>(first) >= page_count_)
+        {
+            return;
+        }
+        count = std::min(count, page_count_ - static_cast<size_t>(first));
+        size_t i = 0;
+        while (i < count)
+        {
+            // One call per stretch of pages adjacent in the mapping
+            char *start = PageAddress(static_cast<page_id_t>(first + i));
+            size_t run = 1;
+            while (i + run < count && PageAddress(static_cast<page_id_t>(first + i + run)) == start + run * PageSize)
+            {
+                run++;
+            }
+            madvise(start, run * PageSize, advice);
+            i += run;
+        }
+    }
+
+    template class basic_mmap_pool<4096>;
+    template class basic_mmap_pool<8192>;
+    template class basic_mmap_pool<16384>;
+    template class basic_mmap_pool<65536>;
+}
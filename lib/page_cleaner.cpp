@@ -0,0 +1,54 @@
+#include "../include/page_cleaner.h"
+
+namespace minidb
+{
+    PageCleaner::PageCleaner(buffer_pool *pool, const CleanerOptions &options)
+        : PageCleaner(std::vector<buffer_pool *>{pool}, options)
+    {
+    }
+
+    PageCleaner::PageCleaner(std::vector<buffer_pool *> pools, const CleanerOptions &options)
+        : pools_(std::move(pools)), options_(options), limiter_(options.max_bytes_per_sec)
+    {
+        thread_ = std::thread(&PageCleaner::Run, this);
+    }
+
+    PageCleaner::~PageCleaner()
+    {
+        Stop();
+    }
+
+    void PageCleaner::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            stop_ = true;
+        }
+        stop_cv_.notify_all();
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    void PageCleaner::Run()
+    {
+        std::unique_lock<std::mutex> lock(latch_);
+        while (!stop_)
+        {
+            lock.unlock();
+            for (buffer_pool *pool : pools_)
+            {
+                size_t count = static_cast<size_t>(options_.clean_fraction * pool->GetPoolSize());
+                if (count > 0)
+                {
+                    pages_cleaned_ += pool->CleanCandidates(count, &limiter_).pages_written;
+                }
+            }
+            lock.lock();
+            stop_cv_.wait_for(lock, options_.interval, [this]()
+                              { return stop_; });
+        }
+    }
+
+} // namespace minidb
@@ -0,0 +1,168 @@
+#include "../include/page_guard.h"
+#include "../include/buffer_pool.h"
+
+namespace minidb
+{
+    template <int32_t PageSize>
+    BasicReadPageGuard<PageSize>::BasicReadPageGuard(basic_buffer_pool<PageSize> *pool, BasicPage<PageSize> *page)
+        : pool_(pool), page_(page)
+    {
+        page_->GetLatch().LockShared();
+    }
+
+    template <int32_t PageSize>
+    BasicReadPageGuard<PageSize>::BasicReadPageGuard(BasicReadPageGuard &&other) noexcept
+        : pool_(other.pool_), page_(other.page_)
+    {
+        other.page_ = nullptr;
+    }
+
+    template <int32_t PageSize>
+    BasicReadPageGuard<PageSize> &BasicReadPageGuard<PageSize>::operator=(BasicReadPageGuard &&other) noexcept
+    {
+        if (this != &other)
+        {
+            Release();
+            pool_ = other.pool_;
+            page_ = other.page_;
+            other.page_ = nullptr;
+        }
+        return *this;
+    }
+
+    template <int32_t PageSize>
+    BasicReadPageGuard<PageSize>::~BasicReadPageGuard()
+    {
+        Release();
+    }
+
+    template <int32_t PageSize>
+    void BasicReadPageGuard<PageSize>::Release()
+    {
+        if (page_ == nullptr)
+        {
+            return;
+        }
+        page_->GetLatch().UnlockShared();
+        pool_->UnpinPage(page_->GetPageId(), false);
+        page_ = nullptr;
+    }
+
+    template <int32_t PageSize>
+    BasicWritePageGuard<PageSize>::BasicWritePageGuard(basic_buffer_pool<PageSize> *pool, BasicPage<PageSize> *page)
+        : pool_(pool), page_(page)
+    {
+        page_->GetLatch().LockExclusive();
+    }
+
+    template <int32_t PageSize>
+    BasicWritePageGuard<PageSize>::BasicWritePageGuard(BasicWritePageGuard &&other) noexcept
+        : pool_(other.pool_), page_(other.page_)
+    {
+        other.page_ = nullptr;
+    }
+
+    template <int32_t PageSize>
+    BasicWritePageGuard<PageSize> &BasicWritePageGuard<PageSize>::operator=(BasicWritePageGuard &&other) noexcept
+    {
+        if (this != &other)
+        {
+            Release();
+            pool_ = other.pool_;
+            page_ = other.page_;
+            other.page_ = nullptr;
+        }
+        return *this;
+    }
+
+    template <int32_t PageSize>
+    BasicWritePageGuard<PageSize>::~BasicWritePageGuard()
+    {
+        Release();
+    }
+
+    template <int32_t PageSize>
+    void BasicWritePageGuard<PageSize>::Release()
+    {
+        if (page_ == nullptr)
+        {
+            return;
+        }
+        page_->GetLatch().UnlockExclusive();
+        pool_->UnpinPage(page_->GetPageId(), true);
+        page_ = nullptr;
+    }
+
+    template <int32_t PageSize>
+    BasicOptimisticPageGuard<PageSize>::BasicOptimisticPageGuard(basic_buffer_pool<PageSize> *pool,
+                                                                 BasicPage<PageSize> *page)
+        : pool_(pool), page_(page), version_(page->GetLatch().ReadVersion())
+    {
+    }
+
+    template <int32_t PageSize>
+    BasicOptimisticPageGuard<PageSize>::BasicOptimisticPageGuard(BasicOptimisticPageGuard &&other) noexcept
+        : pool_(other.pool_), page_(other.page_), version_(other.version_)
+    {
+        other.page_ = nullptr;
+    }
+
+    template <int32_t PageSize>
+    BasicOptimisticPageGuard<PageSize> &
+    BasicOptimisticPageGuard<PageSize>::operator=(BasicOptimisticPageGuard &&other) noexcept
+    {
+        if (this != &other)
+        {
+            Release();
+            pool_ = other.pool_;
+            page_ = other.page_;
+            version_ = other.version_;
+            other.page_ = nullptr;
+        }
+        return *this;
+    }
+
+    template <int32_t PageSize>
+    BasicOptimisticPageGuard<PageSize>::~BasicOptimisticPageGuard()
+    {
+        Release();
+    }
+
+    template <int32_t PageSize>
+    void BasicOptimisticPageGuard<PageSize>::Release()
+    {
+        if (page_ == nullptr)
+        {
+            return;
+        }
+        pool_->UnpinPage(page_->GetPageId(), false);
+        page_ = nullptr;
+    }
+
+    template <int32_t PageSize>
+    bool BasicOptimisticPageGuard<PageSize>::TryUpgrade(BasicWritePageGuard<PageSize> *write)
+    {
+        if (!page_->GetLatch().TryLockExclusive(version_))
+        {
+            return false;
+        }
+        write->Release();
+        write->pool_ = pool_;
+        write->page_ = page_;
+        page_ = nullptr;
+        return true;
+    }
+
+    template class BasicReadPageGuard<4096>;
+    template class BasicReadPageGuard<8192>;
+    template class BasicReadPageGuard<16384>;
+    template class BasicReadPageGuard<65536>;
+    template class BasicWritePageGuard<4096>;
+    template class BasicWritePageGuard<8192>;
+    template class BasicWritePageGuard<16384>;
+    template class BasicWritePageGuard<65536>;
+    template class BasicOptimisticPageGuard<4096>;
+    template class BasicOptimisticPageGuard<8192>;
+    template class BasicOptimisticPageGuard<16384>;
+    template class BasicOptimisticPageGuard<65536>;
+}
@@ -0,0 +1,62 @@
+#include "../include/page_latch.h"
+
+#include <thread> // std::this_thread::yield
+
+namespace minidb
+{
+    /// @brief Spins before yielding the CPU to the latch holder
+    static constexpr int SPINS_BEFORE_YIELD = 64;
+
+    static inline void Backoff(int *spins)
+    {
+        if (++*spins > SPINS_BEFORE_YIELD)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void PageLatch::LockExclusive()
+    {
+        int spins = 0;
+        uint64_t version = version_.load(std::memory_order_relaxed);
+        while ((version & 1) != 0 ||
+               !version_.compare_exchange_weak(version, version + 1, std::memory_order_seq_cst))
+        {
+            if ((version & 1) != 0)
+            {
+                Backoff(&spins);
+                version = version_.load(std::memory_order_relaxed);
+            }
+        }
+
+        WaitForReaders();
+    }
+
+    bool PageLatch::TryLockExclusive(uint64_t version)
+    {
+        if ((version & 1) != 0 || !version_.compare_exchange_strong(version, version + 1, std::memory_order_seq_cst))
+        {
+            return false;
+        }
+        WaitForReaders();
+        return true;
+    }
+
+    void PageLatch::WaitForReaders()
+    {
+        int spins = 0;
+        while (readers_.load(std::memory_order_seq_cst) != 0)
+        {
+            Backoff(&spins);
+        }
+    }
+
+    void PageLatch::WaitUnlocked()
+    {
+        int spins = 0;
+        while ((version_.load(std::memory_order_acquire) & 1) != 0)
+        {
+            Backoff(&spins);
+        }
+    }
+}
@@ -0,0 +1,98 @@
+#include "../include/parallel_buffer_pool.h"
+
+namespace minidb
+{
+    parallel_buffer_pool::parallel_buffer_pool(int frames, size_t num_shards, DiskManager *dm,
+                                               ReplacerPolicy policy)
+        : pool_size_(frames), disk_manager_(dm)
+    {
+        if (num_shards == 0 || static_cast<size_t>(frames) < num_shards)
+        {
+            throw std::runtime_error("Invalid shard count for parallel buffer pool");
+        }
+
+        // Spread the remainder over the first shards
+        for (size_t i = 0; i < num_shards; i++)
+        {
+            int shard_frames = frames / static_cast<int>(num_shards);
+            if (i < frames % num_shards)
+            {
+                shard_frames++;
+            }
+            shards_.push_back(std::make_unique<buffer_pool>(shard_frames, dm, policy));
+        }
+    }
+
+    Page *parallel_buffer_pool::FetchPage(page_id_t page_id)
+    {
+        return ShardOf(page_id)->FetchPage(page_id);
+    }
+
+    Page *parallel_buffer_pool::NewPage(page_id_t *page_id)
+    {
+        // The ID decides the shard, so it has to be allocated first. Freed again if the shard has
+        // no frame, so a full pool does not grow the file
+        *page_id = disk_manager_->AllocatePage();
+        try
+        {
+            return ShardOf(*page_id)->InstallNewPage(*page_id);
+        }
+        catch (...)
+        {
+            disk_manager_->DeallocatePage(*page_id);
+            throw;
+        }
+    }
+
+    void parallel_buffer_pool::UnpinPage(page_id_t page_id, bool isDirty)
+    {
+        ShardOf(page_id)->UnpinPage(page_id, isDirty);
+    }
+
+    bool parallel_buffer_pool::DeletePage(page_id_t page_id)
+    {
+        return ShardOf(page_id)->DeletePage(page_id);
+    }
+
+    void parallel_buffer_pool::FlushPage(page_id_t page_id)
+    {
+        ShardOf(page_id)->FlushPage(page_id);
+    }
+
+    void parallel_buffer_pool::FlushAllPages()
+    {
+        Checkpoint();
+    }
+
+    WriteBackResult parallel_buffer_pool::Checkpoint(const CheckpointOptions &options)
+    {
+        // Shards only write, one sync covers all of them
+        CheckpointOptions shard_options = options;
+        shard_options.sync = false;
+
+        WriteBackResult total;
+        for (auto &shard : shards_)
+        {
+            WriteBackResult result = shard->Checkpoint(shard_options);
+            total.pages_written += result.pages_written;
+            total.write_calls += result.write_calls;
+        }
+        if (options.sync && total.pages_written > 0)
+        {
+            disk_manager_->Sync();
+            total.syncs++;
+        }
+        return total;
+    }
+
+    std::vector<buffer_pool *> parallel_buffer_pool::GetShards()
+    {
+        std::vector<buffer_pool *> shards;
+        for (auto &shard : shards_)
+        {
+            shards.push_back(shard.get());
+        }
+        return shards;
+    }
+
+} // namespace minidb
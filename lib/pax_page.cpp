@@ -0,0 +1,254 @@
+#include "../include/pax_page.h"
+
+#include <cmath>  // std::isnan
+#include <limits> // std::numeric_limits
+
+namespace minidb
+{
+    namespace
+    {
+        inline uint64_t AlignLine(uint64_t offset)
+        {
+            return (offset + 63) & ~uint64_t(63);
+        }
+
+        template <typename T>
+        bool RangeMayMatch(T min, T max, bool has_nan, CompareOp op, T operand)
+        {
+            switch (op)
+            {
+            case CompareOp::EQ:
+                return min <= operand && operand <= max;
+            case CompareOp::NE:
+                return has_nan || !(min == operand && max == operand);
+            case CompareOp::LT:
+                return min < operand;
+            case CompareOp::LE:
+                return has_nan || min <= operand;
+            case CompareOp::GT:
+                return max > operand;
+            default:
+                return has_nan || max >= operand;
+            }
+        }
+    }
+
+    bool PaxZoneMap::MayMatch(PaxType type, CompareOp op, PaxValue operand) const
+    {
+        if (nulls == rows)
+        {
+            return false;
+        }
+        if (type != PaxType::DOUBLE)
+        {
+            return RangeMayMatch<int64_t>(min.i, max.i, false, op, operand.i);
+        }
+        if (std::isnan(operand.d))
+        {
+            // Every comparison with NaN is false, so only the negated ones pass
+            return op == CompareOp::NE || op == CompareOp::LE || op == CompareOp::GE;
+        }
+        return RangeMayMatch<double>(min.d, max.d, has_nan, op, operand.d);
+    }
+
+    uint64_t FilterPaxColumn(PaxType type, const char *values, size_t count, CompareOp op, PaxValue operand,
+                             uint64_t *selection)
+    {
+        switch (type)
+        {
+        case PaxType::INT32:
+            return ScanKernels::Filter<int32_t>(reinterpret_cast<const int32_t *>(values), count, op,
+                                                static_cast<int32_t>(operand.i), selection);
+        case PaxType::INT64:
+            return ScanKernels::Filter<int64_t>(reinterpret_cast<const int64_t *>(values), count, op, operand.i,
+                                                selection);
+        default:
+            return ScanKernels::Filter<double>(reinterpret_cast<const double *>(values), count, op, operand.d,
+                                               selection);
+        }
+    }
+
+    template <int32_t PageSize>
+    void BasicPaxPage<PageSize>::Init(const std::vector<PaxType> &schema)
+    {
+        uint32_t capacity = Capacity(schema);
+        uint32_t offsets[2 * MAX_COLUMNS];
+        Layout(schema, capacity, offsets);
+
+        memset(data_ + ROW_COUNT_OFFSET, 0, PageSize - ROW_COUNT_OFFSET);
+        Write<uint32_t>(CAPACITY_OFFSET, capacity);
+        Write<uint32_t>(COLUMN_COUNT_OFFSET, static_cast<uint32_t>(schema.size()));
+        for (uint32_t c = 0; c < schema.size(); c++)
+        {
+            uint32_t descriptor = Descriptor(c);
+            Write<uint8_t>(descriptor + TYPE_OFFSET, static_cast<uint8_t>(schema[c]));
+            Write<uint32_t>(descriptor + VALUES_OFFSET, offsets[2 * c]);
+            Write<uint32_t>(descriptor + VALIDITY_OFFSET, offsets[2 * c + 1]);
+            if (schema[c] == PaxType::DOUBLE)
+            {
+                Write<double>(descriptor + MIN_OFFSET, std::numeric_limits<double>::max());
+                Write<double>(descriptor + MAX_OFFSET, std::numeric_limits<double>::lowest());
+            }
+            else
+            {
+                int64_t min = schema[c] == PaxType::INT32 ? std::numeric_limits<int32_t>::max()
+                                                          : std::numeric_limits<int64_t>::max();
+                int64_t max = schema[c] == PaxType::INT32 ? std::numeric_limits<int32_t>::lowest()
+                                                          : std::numeric_limits<int64_t>::lowest();
+                Write<int64_t>(descriptor + MIN_OFFSET, min);
+                Write<int64_t>(descriptor + MAX_OFFSET, max);
+            }
+        }
+    }
+
+    template <int32_t PageSize>
+    bool BasicPaxPage<PageSize>::Append(const char *record, uint64_t null_mask)
+    {
+        uint32_t row = GetRowCount();
+        if (row >= GetCapacity())
+        {
+            return false;
+        }
+
+        uint32_t column_count = GetColumnCount();
+        for (uint32_t c = 0; c < column_count; c++)
+        {
+            uint32_t descriptor = Descriptor(c);
+            PaxType type = GetType(c);
+            uint32_t size = ValueSize(type);
+            char *value = data_ + Read<uint32_t>(descriptor + VALUES_OFFSET) + static_cast<uint64_t>(row) * size;
+            if ((null_mask >> c) & 1)
+            {
+                // Init zeroed the value and its validity bit
+                Write<uint32_t>(descriptor + NULLS_OFFSET, Read<uint32_t>(descriptor + NULLS_OFFSET) + 1);
+                record += size;
+                continue;
+            }
+
+            memcpy(value, record, size);
+            uint32_t validity = Read<uint32_t>(descriptor + VALIDITY_OFFSET) + row / 64 * 8;
+            Write<uint64_t>(validity, Read<uint64_t>(validity) | (uint64_t(1) << (row % 64)));
+
+            if (type == PaxType::DOUBLE)
+            {
+                double v;
+                memcpy(&v, record, sizeof(v));
+                if (std::isnan(v))
+                {
+                    Write<uint8_t>(descriptor + FLAGS_OFFSET, Read<uint8_t>(descriptor + FLAGS_OFFSET) | FLAG_HAS_NAN);
+                }
+                else
+                {
+                    if (v < Read<double>(descriptor + MIN_OFFSET))
+                    {
+                        Write<double>(descriptor + MIN_OFFSET, v);
+                    }
+                    if (v > Read<double>(descriptor + MAX_OFFSET))
+                    {
+                        Write<double>(descriptor + MAX_OFFSET, v);
+                    }
+                }
+            }
+            else
+            {
+                int64_t v;
+                if (type == PaxType::INT32)
+                {
+                    int32_t narrow;
+                    memcpy(&narrow, record, sizeof(narrow));
+                    v = narrow;
+                }
+                else
+                {
+                    memcpy(&v, record, sizeof(v));
+                }
+                if (v < Read<int64_t>(descriptor + MIN_OFFSET))
+                {
+                    Write<int64_t>(descriptor + MIN_OFFSET, v);
+                }
+                if (v > Read<int64_t>(descriptor + MAX_OFFSET))
+                {
+                    Write<int64_t>(descriptor + MAX_OFFSET, v);
+                }
+            }
+            record += size;
+        }
+        Write<uint32_t>(ROW_COUNT_OFFSET, row + 1);
+        return true;
+    }
+
+    template <int32_t PageSize>
+    PaxZoneMap BasicPaxPage<PageSize>::GetZoneMap(uint32_t column)
+    {
+        uint32_t descriptor = Descriptor(column);
+        PaxZoneMap zone;
+        if (GetType(column) == PaxType::DOUBLE)
+        {
+            zone.min.d = Read<double>(descriptor + MIN_OFFSET);
+            zone.max.d = Read<double>(descriptor + MAX_OFFSET);
+        }
+        else
+        {
+            zone.min.i = Read<int64_t>(descriptor + MIN_OFFSET);
+            zone.max.i = Read<int64_t>(descriptor + MAX_OFFSET);
+        }
+        zone.rows = GetRowCount();
+        zone.nulls = Read<uint32_t>(descriptor + NULLS_OFFSET);
+        zone.has_nan = (Read<uint8_t>(descriptor + FLAGS_OFFSET) & FLAG_HAS_NAN) != 0;
+        return zone;
+    }
+
+    template <int32_t PageSize>
+    uint32_t BasicPaxPage<PageSize>::RecordSize(const std::vector<PaxType> &schema)
+    {
+        uint32_t size = 0;
+        for (PaxType type : schema)
+        {
+            size += ValueSize(type);
+        }
+        return size;
+    }
+
+    template <int32_t PageSize>
+    uint32_t BasicPaxPage<PageSize>::Capacity(const std::vector<PaxType> &schema)
+    {
+        if (schema.empty() || schema.size() > MAX_COLUMNS)
+        {
+            return 0;
+        }
+        // Start from the value and validity bits alone, then give back rows until the padded
+        // layout fits
+        uint64_t bits = uint64_t(8) * RecordSize(schema) + schema.size();
+        uint64_t capacity = uint64_t(8) * PageSize / bits;
+        while (capacity > 0 && Layout(schema, static_cast<uint32_t>(capacity), nullptr) > PageSize)
+        {
+            capacity--;
+        }
+        return static_cast<uint32_t>(capacity);
+    }
+
+    template <int32_t PageSize>
+    uint64_t BasicPaxPage<PageSize>::Layout(const std::vector<PaxType> &schema, uint32_t capacity, uint32_t *offsets)
+    {
+        uint64_t offset = AlignLine(HEADER_SIZE + schema.size() * DESCRIPTOR_SIZE);
+        for (size_t c = 0; c < schema.size(); c++)
+        {
+            if (offsets != nullptr)
+            {
+                offsets[2 * c] = static_cast<uint32_t>(offset);
+            }
+            offset = AlignLine(offset + static_cast<uint64_t>(capacity) * ValueSize(schema[c]));
+            if (offsets != nullptr)
+            {
+                offsets[2 * c + 1] = static_cast<uint32_t>(offset);
+            }
+            offset = AlignLine(offset + (capacity + 63) / 64 * 8);
+        }
+        return offset;
+    }
+
+    template class BasicPaxPage<4096>;
+    template class BasicPaxPage<8192>;
+    template class BasicPaxPage<16384>;
+    template class BasicPaxPage<65536>;
+}
@@ -0,0 +1,352 @@
+#include "../include/pax_table.h"
+
+#include <algorithm>   // std::max
+#include <cstring>     // memcpy
+#include <limits>      // std::numeric_limits
+#include <stdexcept>   // std::invalid_argument, std::runtime_error
+#include <string>      // std::to_string
+#include <type_traits> // std::is_floating_point
+#include <utility>     // std::move
+
+namespace minidb
+{
+    namespace
+    {
+        const uint64_t PAX_MAGIC = 0x00584150494e494dULL; // "MINIPAX\0"
+
+        // Header page, after the page LSN
+        const uint32_t MAGIC_OFFSET = 8;
+        const uint32_t COLUMN_COUNT_OFFSET = 16;
+        const uint32_t FIRST_DIRECTORY_OFFSET = 24;
+        const uint32_t TYPES_OFFSET = 32;
+
+        // Directory page, after the page LSN
+        const uint32_t NEXT_DIRECTORY_OFFSET = 8;
+        const uint32_t ENTRY_COUNT_OFFSET = 16;
+
+        /// @brief Zone map flag: the column holds a NaN
+        const uint32_t ZONE_HAS_NAN = 1;
+
+        template <typename T>
+        inline T Read(const char *data, uint32_t offset)
+        {
+            T value;
+            memcpy(&value, data + offset, sizeof(T));
+            return value;
+        }
+
+        template <typename T>
+        inline void Write(char *data, uint32_t offset, T value)
+        {
+            memcpy(data + offset, &value, sizeof(T));
+        }
+
+        inline void InitDirectory(char *data)
+        {
+            Write<page_id_t>(data, NEXT_DIRECTORY_OFFSET, INVALID_PAGE_ID);
+            Write<uint32_t>(data, ENTRY_COUNT_OFFSET, 0);
+        }
+    }
+
+    template <int32_t PageSize>
+    BasicPaxTable<PageSize>::BasicPaxTable(basic_buffer_pool<PageSize> *pool, const std::vector<PaxType> &schema)
+        : pool_(pool), schema_(schema), capacity_(BasicPaxPage<PageSize>::Capacity(schema))
+    {
+        if (capacity_ == 0)
+        {
+            throw std::invalid_argument("PAX schema of " + std::to_string(schema.size()) +
+                                        " columns does not fit in a page");
+        }
+
+        page_id_t directory_page_id;
+        BasicPage<PageSize> *directory = pool_->NewPage(&directory_page_id);
+        InitDirectory(directory->GetData());
+        pool_->UnpinPage(directory_page_id, true);
+        directory_pages_.push_back(directory_page_id);
+
+        BasicPage<PageSize> *header = pool_->NewPage(&header_page_id_);
+        char *data = header->GetData();
+        Write<uint64_t>(data, MAGIC_OFFSET, PAX_MAGIC);
+        Write<uint32_t>(data, COLUMN_COUNT_OFFSET, static_cast<uint32_t>(schema_.size()));
+        Write<page_id_t>(data, FIRST_DIRECTORY_OFFSET, directory_page_id);
+        for (size_t c = 0; c < schema_.size(); c++)
+        {
+            Write<uint8_t>(data, TYPES_OFFSET + static_cast<uint32_t>(c), static_cast<uint8_t>(schema_[c]));
+        }
+        pool_->UnpinPage(header_page_id_, true);
+    }
+
+    template <int32_t PageSize>
+    BasicPaxTable<PageSize>::BasicPaxTable(basic_buffer_pool<PageSize> *pool, page_id_t header_page_id)
+        : pool_(pool), header_page_id_(header_page_id)
+    {
+        BasicPage<PageSize> *header = pool_->FetchPage(header_page_id_);
+        const char *data = header->GetData();
+        uint32_t column_count = Read<uint32_t>(data, COLUMN_COUNT_OFFSET);
+        bool valid = Read<uint64_t>(data, MAGIC_OFFSET) == PAX_MAGIC && column_count > 0 &&
+                     column_count <= BasicPaxPage<PageSize>::MAX_COLUMNS;
+        page_id_t first_directory_page_id = Read<page_id_t>(data, FIRST_DIRECTORY_OFFSET);
+        for (uint32_t c = 0; valid && c < column_count; c++)
+        {
+            schema_.push_back(static_cast<PaxType>(Read<uint8_t>(data, TYPES_OFFSET + c)));
+        }
+        pool_->UnpinPage(header_page_id_, false);
+        if (!valid)
+        {
+            throw std::runtime_error("Page " + std::to_string(header_page_id) + " is not a PAX table header");
+        }
+
+        capacity_ = BasicPaxPage<PageSize>::Capacity(schema_);
+        ReadDirectory(first_directory_page_id);
+    }
+
+    template <int32_t PageSize>
+    void BasicPaxTable<PageSize>::Append(const char *record, uint64_t null_mask)
+    {
+        if (entries_.empty() || entries_.back().rows == capacity_)
+        {
+            page_id_t page_id;
+            BasicPage<PageSize> *page = pool_->NewPage(&page_id);
+            BasicPaxPage<PageSize> pax_page(page->GetData());
+            pax_page.Init(schema_);
+            Entry entry{page_id, 0, {}};
+            for (uint32_t c = 0; c < schema_.size(); c++)
+            {
+                entry.zones.push_back(pax_page.GetZoneMap(c));
+            }
+            pool_->UnpinPage(page_id, true);
+            entries_.push_back(std::move(entry));
+            WriteEntry(entries_.size() - 1);
+        }
+
+        Entry &entry = entries_.back();
+        BasicPage<PageSize> *page = pool_->FetchPage(entry.page_id);
+        BasicPaxPage<PageSize> pax_page(page->GetData());
+        pax_page.Append(record, null_mask);
+        entry.rows = pax_page.GetRowCount();
+        for (uint32_t c = 0; c < schema_.size(); c++)
+        {
+            entry.zones[c] = pax_page.GetZoneMap(c);
+        }
+        pool_->UnpinPage(entry.page_id, true);
+        row_count_++;
+
+        if (entry.rows == capacity_)
+        {
+            // Sealed: the directory now has its final zone maps
+            WriteEntry(entries_.size() - 1);
+        }
+    }
+
+    template <int32_t PageSize>
+    PaxAggregate BasicPaxTable<PageSize>::Aggregate(const std::vector<PaxPredicate> &predicates, uint32_t column,
+                                                    BufferAccessStrategy *strategy)
+    {
+        if (column >= schema_.size())
+        {
+            throw std::invalid_argument("No column " + std::to_string(column));
+        }
+        for (const PaxPredicate &predicate : predicates)
+        {
+            if (predicate.column >= schema_.size())
+            {
+                throw std::invalid_argument("No column " + std::to_string(predicate.column));
+            }
+            if (schema_[predicate.column] == PaxType::INT32 &&
+                (predicate.operand.i < std::numeric_limits<int32_t>::lowest() ||
+                 predicate.operand.i > std::numeric_limits<int32_t>::max()))
+            {
+                throw std::invalid_argument("Operand " + std::to_string(predicate.operand.i) +
+                                            " out of range of INT32 column " + std::to_string(predicate.column));
+            }
+        }
+
+        switch (schema_[column])
+        {
+        case PaxType::INT32:
+            return AggregateAs<int32_t>(predicates, column, strategy);
+        case PaxType::INT64:
+            return AggregateAs<int64_t>(predicates, column, strategy);
+        default:
+            return AggregateAs<double>(predicates, column, strategy);
+        }
+    }
+
+    template <int32_t PageSize>
+    template <typename T>
+    PaxAggregate BasicPaxTable<PageSize>::AggregateAs(const std::vector<PaxPredicate> &predicates, uint32_t column,
+                                                      BufferAccessStrategy *strategy)
+    {
+        PaxAggregate result;
+        ColumnAggregate<T> total;
+        std::vector<uint64_t> selection((capacity_ + 63) / 64);
+        std::vector<uint64_t> scratch(selection.size());
+        for (const Entry &entry : entries_)
+        {
+            // Nothing to aggregate on a page whose column is all null
+            bool skip = entry.zones[column].nulls == entry.rows;
+            for (size_t p = 0; !skip && p < predicates.size(); p++)
+            {
+                const PaxPredicate &predicate = predicates[p];
+                skip = !entry.zones[predicate.column].MayMatch(schema_[predicate.column], predicate.op,
+                                                               predicate.operand);
+            }
+            if (skip)
+            {
+                result.pages_skipped++;
+                continue;
+            }
+
+            BasicPage<PageSize> *page = pool_->FetchPage(entry.page_id, strategy);
+            BasicPaxPage<PageSize> pax_page(page->GetData());
+            uint32_t rows = pax_page.GetRowCount();
+            const uint64_t *filter = nullptr;
+            uint64_t selected = rows;
+            if (!predicates.empty() || entry.zones[column].nulls > 0)
+            {
+                memcpy(selection.data(), pax_page.GetValidity(column), (rows + 63) / 64 * sizeof(uint64_t));
+                for (size_t p = 0; selected > 0 && p < predicates.size(); p++)
+                {
+                    const PaxPredicate &predicate = predicates[p];
+                    FilterPaxColumn(schema_[predicate.column], pax_page.template GetColumn<char>(predicate.column),
+                                    rows, predicate.op, predicate.operand, scratch.data());
+                    ScanKernels::And(scratch.data(), pax_page.GetValidity(predicate.column), rows);
+                    selected = ScanKernels::And(selection.data(), scratch.data(), rows);
+                }
+                filter = selection.data();
+            }
+            if (selected > 0)
+            {
+                ScanKernels::Aggregate<T>(pax_page.template GetColumn<T>(column), rows, filter, &total);
+            }
+            pool_->UnpinPage(entry.page_id, false);
+            result.pages_scanned++;
+        }
+
+        result.count = total.count;
+        if constexpr (std::is_floating_point<T>::value)
+        {
+            result.sum.d = total.sum;
+            result.min.d = total.min;
+            result.max.d = total.max;
+        }
+        else
+        {
+            result.sum.i = total.sum;
+            result.min.i = total.min;
+            result.max.i = total.max;
+        }
+        return result;
+    }
+
+    template <int32_t PageSize>
+    void BasicPaxTable<PageSize>::WriteEntry(size_t index)
+    {
+        size_t per_page = EntriesPerPage();
+        size_t directory_index = index / per_page;
+        while (directory_index >= directory_pages_.size())
+        {
+            page_id_t page_id;
+            BasicPage<PageSize> *page = pool_->NewPage(&page_id);
+            InitDirectory(page->GetData());
+            pool_->UnpinPage(page_id, true);
+
+            BasicPage<PageSize> *last = pool_->FetchPage(directory_pages_.back());
+            Write<page_id_t>(last->GetData(), NEXT_DIRECTORY_OFFSET, page_id);
+            pool_->UnpinPage(directory_pages_.back(), true);
+            directory_pages_.push_back(page_id);
+        }
+
+        const Entry &entry = entries_[index];
+        page_id_t directory_page_id = directory_pages_[directory_index];
+        BasicPage<PageSize> *page = pool_->FetchPage(directory_page_id);
+        char *data = page->GetData();
+        uint32_t slot = static_cast<uint32_t>(index % per_page);
+        uint32_t offset = DIRECTORY_HEADER_SIZE + slot * EntrySize();
+        Write<page_id_t>(data, offset, entry.page_id);
+        Write<uint32_t>(data, offset + 8, entry.rows);
+        offset += ENTRY_HEADER_SIZE;
+        for (size_t c = 0; c < schema_.size(); c++, offset += ZONE_SIZE)
+        {
+            const PaxZoneMap &zone = entry.zones[c];
+            if (schema_[c] == PaxType::DOUBLE)
+            {
+                Write<double>(data, offset, zone.min.d);
+                Write<double>(data, offset + 8, zone.max.d);
+            }
+            else
+            {
+                Write<int64_t>(data, offset, zone.min.i);
+                Write<int64_t>(data, offset + 8, zone.max.i);
+            }
+            Write<uint32_t>(data, offset + 16, zone.nulls);
+            Write<uint32_t>(data, offset + 20, zone.has_nan ? ZONE_HAS_NAN : 0);
+        }
+        Write<uint32_t>(data, ENTRY_COUNT_OFFSET, std::max(Read<uint32_t>(data, ENTRY_COUNT_OFFSET), slot + 1));
+        pool_->UnpinPage(directory_page_id, true);
+    }
+
+    template <int32_t PageSize>
+    void BasicPaxTable<PageSize>::ReadDirectory(page_id_t first_directory_page_id)
+    {
+        page_id_t directory_page_id = first_directory_page_id;
+        while (directory_page_id != INVALID_PAGE_ID)
+        {
+            directory_pages_.push_back(directory_page_id);
+            BasicPage<PageSize> *page = pool_->FetchPage(directory_page_id);
+            const char *data = page->GetData();
+            uint32_t count = Read<uint32_t>(data, ENTRY_COUNT_OFFSET);
+            for (uint32_t slot = 0; slot < count; slot++)
+            {
+                uint32_t offset = DIRECTORY_HEADER_SIZE + slot * EntrySize();
+                Entry entry{Read<page_id_t>(data, offset), Read<uint32_t>(data, offset + 8), {}};
+                offset += ENTRY_HEADER_SIZE;
+                for (size_t c = 0; c < schema_.size(); c++, offset += ZONE_SIZE)
+                {
+                    PaxZoneMap zone;
+                    if (schema_[c] == PaxType::DOUBLE)
+                    {
+                        zone.min.d = Read<double>(data, offset);
+                        zone.max.d = Read<double>(data, offset + 8);
+                    }
+                    else
+                    {
+                        zone.min.i = Read<int64_t>(data, offset);
+                        zone.max.i = Read<int64_t>(data, offset + 8);
+                    }
+                    zone.rows = entry.rows;
+                    zone.nulls = Read<uint32_t>(data, offset + 16);
+                    zone.has_nan = (Read<uint32_t>(data, offset + 20) & ZONE_HAS_NAN) != 0;
+                    entry.zones.push_back(zone);
+                }
+                entries_.push_back(std::move(entry));
+            }
+            page_id_t next = Read<page_id_t>(data, NEXT_DIRECTORY_OFFSET);
+            pool_->UnpinPage(directory_page_id, false);
+            directory_page_id = next;
+        }
+
+        if (!entries_.empty())
+        {
+            // The last page may have grown since its entry was written
+            Entry &last = entries_.back();
+            BasicPage<PageSize> *page = pool_->FetchPage(last.page_id);
+            BasicPaxPage<PageSize> pax_page(page->GetData());
+            last.rows = pax_page.GetRowCount();
+            for (uint32_t c = 0; c < schema_.size(); c++)
+            {
+                last.zones[c] = pax_page.GetZoneMap(c);
+            }
+            pool_->UnpinPage(last.page_id, false);
+        }
+        for (const Entry &entry : entries_)
+        {
+            row_count_ += entry.rows;
+        }
+    }
+
+    template class BasicPaxTable<4096>;
+    template class BasicPaxTable<8192>;
+    template class BasicPaxTable<16384>;
+    template class BasicPaxTable<65536>;
+}
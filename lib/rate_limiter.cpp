@@ -0,0 +1,42 @@
+#include "../include/rate_limiter.h"
+
+#include <algorithm> // std::min
+#include <thread>    // std::this_thread::sleep_for
+
+namespace minidb
+{
+    RateLimiter::RateLimiter(uint64_t bytes_per_sec)
+        : bytes_per_sec_(bytes_per_sec), available_(static_cast<double>(bytes_per_sec)),
+          last_refill_(std::chrono::steady_clock::now())
+    {
+    }
+
+    void RateLimiter::Acquire(uint64_t bytes)
+    {
+        if (bytes_per_sec_ == 0)
+        {
+            return;
+        }
+
+        double wait_seconds = 0;
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            auto now = std::chrono::steady_clock::now();
+            double elapsed = std::chrono::duration<double>(now - last_refill_).count();
+            last_refill_ = now;
+
+            available_ = std::min(available_ + elapsed * bytes_per_sec_, static_cast<double>(bytes_per_sec_));
+            available_ -= static_cast<double>(bytes);
+            if (available_ < 0)
+            {
+                wait_seconds = -available_ / bytes_per_sec_;
+            }
+        }
+
+        if (wait_seconds > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<double>(wait_seconds));
+        }
+    }
+
+} // namespace minidb
@@ -0,0 +1,41 @@
+#include "../include/replacer.h"
+#include "../include/lru_replacer.h"
+#include "../include/clock_replacer.h"
+#include "../include/lru_k_replacer.h"
+#include "../include/arc_replacer.h"
+
+namespace minidb
+{
+    std::unique_ptr<Replacer> MakeReplacer(ReplacerPolicy policy, size_t num_frames)
+    {
+        switch (policy)
+        {
+        case ReplacerPolicy::CLOCK:
+            return std::make_unique<ClockReplacer>(num_frames);
+        case ReplacerPolicy::LRU_K:
+            return std::make_unique<LRUKReplacer>(num_frames, 2);
+        case ReplacerPolicy::ARC:
+            return std::make_unique<ARCReplacer>(num_frames);
+        case ReplacerPolicy::LRU:
+        default:
+            return std::make_unique<LRUReplacer>(num_frames);
+        }
+    }
+
+    const char *ReplacerPolicyName(ReplacerPolicy policy)
+    {
+        switch (policy)
+        {
+        case ReplacerPolicy::CLOCK:
+            return "CLOCK";
+        case ReplacerPolicy::LRU_K:
+            return "LRU-K";
+        case ReplacerPolicy::ARC:
+            return "ARC";
+        case ReplacerPolicy::LRU:
+        default:
+            return "LRU";
+        }
+    }
+
+} // namespace minidb
@@ -0,0 +1,730 @@
+#include "../include/scan_kernels.h"
+
+#include <atomic> // std::atomic
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h> // SSE4.2 and AVX2 intrinsics, enabled per function
+#define MINIDB_SCAN_X86 1
+#endif
+
+namespace minidb
+{
+    namespace
+    {
+        /// @brief Comparison a kernel evaluates; NE, LE and GE negate EQ, GT and LT
+        enum class Base
+        {
+            EQ,
+            GT,
+            LT
+        };
+
+        inline void Decompose(CompareOp op, Base *base, bool *negate)
+        {
+            switch (op)
+            {
+            case CompareOp::EQ:
+            case CompareOp::NE:
+                *base = Base::EQ;
+                break;
+            case CompareOp::GT:
+            case CompareOp::LE:
+                *base = Base::GT;
+                break;
+            default:
+                *base = Base::LT;
+            }
+            *negate = op == CompareOp::NE || op == CompareOp::LE || op == CompareOp::GE;
+        }
+
+        /// @brief SimdLevel in use, -1 until first asked
+        std::atomic<int> simd_level{-1};
+
+        template <typename T>
+        inline typename ColumnAggregate<T>::SumType AddToSum(typename ColumnAggregate<T>::SumType sum, T value)
+        {
+            if constexpr (std::is_floating_point<T>::value)
+            {
+                return sum + value;
+            }
+            else
+            {
+                return static_cast<int64_t>(static_cast<uint64_t>(sum) + static_cast<uint64_t>(value));
+            }
+        }
+
+        template <typename T, Base B>
+        inline bool Test(T value, T operand)
+        {
+            if constexpr (B == Base::EQ)
+            {
+                return value == operand;
+            }
+            else if constexpr (B == Base::GT)
+            {
+                return value > operand;
+            }
+            else
+            {
+                return value < operand;
+            }
+        }
+
+        /// @brief Filters values from word first_word on, one bit at a time
+        template <typename T, Base B>
+        uint64_t FilterScalar(const T *values, size_t first_word, size_t count, T operand, bool negate,
+                              uint64_t *selection)
+        {
+            uint64_t selected = 0;
+            for (size_t start = first_word * 64; start < count; start += 64)
+            {
+                size_t n = count - start < 64 ? count - start : 64;
+                uint64_t word = 0;
+                for (size_t i = 0; i < n; i++)
+                {
+                    word |= static_cast<uint64_t>(Test<T, B>(values[start + i], operand) != negate) << i;
+                }
+                selection[start / 64] = word;
+                selected += static_cast<uint64_t>(__builtin_popcountll(word));
+            }
+            return selected;
+        }
+
+        /// @brief Aggregates values from index begin on, one at a time
+        template <typename T>
+        void AggregateScalar(const T *values, size_t begin, size_t count, const uint64_t *selection,
+                             ColumnAggregate<T> *result)
+        {
+            ColumnAggregate<T> partial;
+            for (size_t i = begin; i < count; i++)
+            {
+                if (selection != nullptr && ((selection[i / 64] >> (i % 64)) & 1) == 0)
+                {
+                    continue;
+                }
+                T value = values[i];
+                partial.count++;
+                partial.sum = AddToSum<T>(partial.sum, value);
+                partial.min = value < partial.min ? value : partial.min;
+                partial.max = value > partial.max ? value : partial.max;
+            }
+            result->Merge(partial);
+        }
+
+#ifdef MINIDB_SCAN_X86
+        // Whole 64-value words only; the scalar versions finish the tail. Each word of selection
+        // is assembled from the movemask of its vectors
+
+        template <Base B>
+        __attribute__((target("avx2,popcnt"))) uint64_t FilterAvx2(const int32_t *values, size_t words,
+                                                                    int32_t operand, bool negate, uint64_t *selection)
+        {
+            const __m256i constant = _mm256_set1_epi32(operand);
+            uint64_t selected = 0;
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t word = 0;
+                for (int j = 0; j < 8; j++)
+                {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + w * 64 + j * 8));
+                    __m256i mask;
+                    if constexpr (B == Base::EQ)
+                    {
+                        mask = _mm256_cmpeq_epi32(v, constant);
+                    }
+                    else if constexpr (B == Base::GT)
+                    {
+                        mask = _mm256_cmpgt_epi32(v, constant);
+                    }
+                    else
+                    {
+                        mask = _mm256_cmpgt_epi32(constant, v);
+                    }
+                    word |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask))))
+                            << (j * 8);
+                }
+                word = negate ? ~word : word;
+                selection[w] = word;
+                selected += static_cast<uint64_t>(__builtin_popcountll(word));
+            }
+            return selected;
+        }
+
+        template <Base B>
+        __attribute__((target("avx2,popcnt"))) uint64_t FilterAvx2(const int64_t *values, size_t words,
+                                                                    int64_t operand, bool negate, uint64_t *selection)
+        {
+            const __m256i constant = _mm256_set1_epi64x(operand);
+            uint64_t selected = 0;
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t word = 0;
+                for (int j = 0; j < 16; j++)
+                {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + w * 64 + j * 4));
+                    __m256i mask;
+                    if constexpr (B == Base::EQ)
+                    {
+                        mask = _mm256_cmpeq_epi64(v, constant);
+                    }
+                    else if constexpr (B == Base::GT)
+                    {
+                        mask = _mm256_cmpgt_epi64(v, constant);
+                    }
+                    else
+                    {
+                        mask = _mm256_cmpgt_epi64(constant, v);
+                    }
+                    word |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(mask))))
+                            << (j * 4);
+                }
+                word = negate ? ~word : word;
+                selection[w] = word;
+                selected += static_cast<uint64_t>(__builtin_popcountll(word));
+            }
+            return selected;
+        }
+
+        template <Base B>
+        __attribute__((target("avx2,popcnt"))) uint64_t FilterAvx2(const double *values, size_t words, double operand,
+                                                                    bool negate, uint64_t *selection)
+        {
+            const __m256d constant = _mm256_set1_pd(operand);
+            uint64_t selected = 0;
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t word = 0;
+                for (int j = 0; j < 16; j++)
+                {
+                    __m256d v = _mm256_loadu_pd(values + w * 64 + j * 4);
+                    __m256d mask;
+                    if constexpr (B == Base::EQ)
+                    {
+                        mask = _mm256_cmp_pd(v, constant, _CMP_EQ_OQ);
+                    }
+                    else if constexpr (B == Base::GT)
+                    {
+                        mask = _mm256_cmp_pd(v, constant, _CMP_GT_OQ);
+                    }
+                    else
+                    {
+                        mask = _mm256_cmp_pd(v, constant, _CMP_LT_OQ);
+                    }
+                    word |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_pd(mask))) << (j * 4);
+                }
+                word = negate ? ~word : word;
+                selection[w] = word;
+                selected += static_cast<uint64_t>(__builtin_popcountll(word));
+            }
+            return selected;
+        }
+
+        template <Base B>
+        __attribute__((target("sse4.2,popcnt"))) uint64_t FilterSse42(const int32_t *values, size_t words,
+                                                                       int32_t operand, bool negate, uint64_t *selection)
+        {
+            const __m128i constant = _mm_set1_epi32(operand);
+            uint64_t selected = 0;
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t word = 0;
+                for (int j = 0; j < 16; j++)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + w * 64 + j * 4));
+                    __m128i mask;
+                    if constexpr (B == Base::EQ)
+                    {
+                        mask = _mm_cmpeq_epi32(v, constant);
+                    }
+                    else if constexpr (B == Base::GT)
+                    {
+                        mask = _mm_cmpgt_epi32(v, constant);
+                    }
+                    else
+                    {
+                        mask = _mm_cmplt_epi32(v, constant);
+                    }
+                    word |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(mask))))
+                            << (j * 4);
+                }
+                word = negate ? ~word : word;
+                selection[w] = word;
+                selected += static_cast<uint64_t>(__builtin_popcountll(word));
+            }
+            return selected;
+        }
+
+        template <Base B>
+        __attribute__((target("sse4.2,popcnt"))) uint64_t FilterSse42(const int64_t *values, size_t words,
+                                                                       int64_t operand, bool negate, uint64_t *selection)
+        {
+            const __m128i constant = _mm_set1_epi64x(operand);
+            uint64_t selected = 0;
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t word = 0;
+                for (int j = 0; j < 32; j++)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + w * 64 + j * 2));
+                    __m128i mask;
+                    if constexpr (B == Base::EQ)
+                    {
+                        mask = _mm_cmpeq_epi64(v, constant);
+                    }
+                    else if constexpr (B == Base::GT)
+                    {
+                        mask = _mm_cmpgt_epi64(v, constant);
+                    }
+                    else
+                    {
+                        mask = _mm_cmpgt_epi64(constant, v);
+                    }
+                    word |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_pd(_mm_castsi128_pd(mask))))
+                            << (j * 2);
+                }
+                word = negate ? ~word : word;
+                selection[w] = word;
+                selected += static_cast<uint64_t>(__builtin_popcountll(word));
+            }
+            return selected;
+        }
+
+        template <Base B>
+        __attribute__((target("sse4.2,popcnt"))) uint64_t FilterSse42(const double *values, size_t words,
+                                                                       double operand, bool negate, uint64_t *selection)
+        {
+            const __m128d constant = _mm_set1_pd(operand);
+            uint64_t selected = 0;
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t word = 0;
+                for (int j = 0; j < 32; j++)
+                {
+                    __m128d v = _mm_loadu_pd(values + w * 64 + j * 2);
+                    __m128d mask;
+                    if constexpr (B == Base::EQ)
+                    {
+                        mask = _mm_cmpeq_pd(v, constant);
+                    }
+                    else if constexpr (B == Base::GT)
+                    {
+                        mask = _mm_cmpgt_pd(v, constant);
+                    }
+                    else
+                    {
+                        mask = _mm_cmplt_pd(v, constant);
+                    }
+                    word |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_pd(mask))) << (j * 2);
+                }
+                word = negate ? ~word : word;
+                selection[w] = word;
+                selected += static_cast<uint64_t>(__builtin_popcountll(word));
+            }
+            return selected;
+        }
+
+        // Aggregates expand each selection byte or nibble into a lane mask: lane i is kept when
+        // its bit is set. Masked-out lanes add 0 and offer the identity to min and max
+
+        __attribute__((target("avx2,popcnt"))) void AggregateAvx2(const int32_t *values, size_t words,
+                                                                   const uint64_t *selection,
+                                                                   ColumnAggregate<int32_t> *result)
+        {
+            const __m256i lanes = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+            const __m256i top = _mm256_set1_epi32(INT32_MAX);
+            const __m256i bottom = _mm256_set1_epi32(INT32_MIN);
+            __m256i sum = _mm256_setzero_si256();
+            __m256i low = top;
+            __m256i high = bottom;
+            uint64_t count = 0;
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t bits = selection != nullptr ? selection[w] : ~0ull;
+                if (bits == 0)
+                {
+                    continue;
+                }
+                count += static_cast<uint64_t>(__builtin_popcountll(bits));
+                for (int j = 0; j < 8; j++, bits >>= 8)
+                {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + w * 64 + j * 8));
+                    __m256i mask = _mm256_cmpeq_epi32(
+                        _mm256_and_si256(_mm256_set1_epi32(static_cast<int>(bits & 0xff)), lanes), lanes);
+                    __m256i kept = _mm256_and_si256(v, mask);
+                    sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(kept)));
+                    sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(kept, 1)));
+                    low = _mm256_min_epi32(low, _mm256_blendv_epi8(top, v, mask));
+                    high = _mm256_max_epi32(high, _mm256_blendv_epi8(bottom, v, mask));
+                }
+            }
+
+            alignas(32) int64_t sums[4];
+            alignas(32) int32_t lows[8], highs[8];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(sums), sum);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lows), low);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(highs), high);
+            ColumnAggregate<int32_t> partial;
+            partial.count = count;
+            for (int i = 0; i < 4; i++)
+            {
+                partial.sum = AddToSum<int64_t>(partial.sum, sums[i]);
+            }
+            for (int i = 0; i < 8; i++)
+            {
+                partial.min = lows[i] < partial.min ? lows[i] : partial.min;
+                partial.max = highs[i] > partial.max ? highs[i] : partial.max;
+            }
+            result->Merge(partial);
+        }
+
+        __attribute__((target("avx2,popcnt"))) void AggregateAvx2(const int64_t *values, size_t words,
+                                                                   const uint64_t *selection,
+                                                                   ColumnAggregate<int64_t> *result)
+        {
+            const __m256i lanes = _mm256_setr_epi64x(1, 2, 4, 8);
+            const __m256i top = _mm256_set1_epi64x(INT64_MAX);
+            const __m256i bottom = _mm256_set1_epi64x(INT64_MIN);
+            __m256i sum = _mm256_setzero_si256();
+            __m256i low = top;
+            __m256i high = bottom;
+            uint64_t count = 0;
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t bits = selection != nullptr ? selection[w] : ~0ull;
+                if (bits == 0)
+                {
+                    continue;
+                }
+                count += static_cast<uint64_t>(__builtin_popcountll(bits));
+                for (int j = 0; j < 16; j++, bits >>= 4)
+                {
+                    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values + w * 64 + j * 4));
+                    __m256i mask = _mm256_cmpeq_epi64(
+                        _mm256_and_si256(_mm256_set1_epi64x(static_cast<int64_t>(bits & 0xf)), lanes), lanes);
+                    sum = _mm256_add_epi64(sum, _mm256_and_si256(v, mask));
+                    __m256i low_candidate = _mm256_blendv_epi8(top, v, mask);
+                    low = _mm256_blendv_epi8(low, low_candidate, _mm256_cmpgt_epi64(low, low_candidate));
+                    __m256i high_candidate = _mm256_blendv_epi8(bottom, v, mask);
+                    high = _mm256_blendv_epi8(high, high_candidate, _mm256_cmpgt_epi64(high_candidate, high));
+                }
+            }
+
+            alignas(32) int64_t sums[4], lows[4], highs[4];
+            _mm256_store_si256(reinterpret_cast<__m256i *>(sums), sum);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lows), low);
+            _mm256_store_si256(reinterpret_cast<__m256i *>(highs), high);
+            ColumnAggregate<int64_t> partial;
+            partial.count = count;
+            for (int i = 0; i < 4; i++)
+            {
+                partial.sum = AddToSum<int64_t>(partial.sum, sums[i]);
+                partial.min = lows[i] < partial.min ? lows[i] : partial.min;
+                partial.max = highs[i] > partial.max ? highs[i] : partial.max;
+            }
+            result->Merge(partial);
+        }
+
+        __attribute__((target("avx2,popcnt"))) void AggregateAvx2(const double *values, size_t words,
+                                                                   const uint64_t *selection,
+                                                                   ColumnAggregate<double> *result)
+        {
+            const __m256i lanes = _mm256_setr_epi64x(1, 2, 4, 8);
+            const __m256d top = _mm256_set1_pd(std::numeric_limits<double>::max());
+            const __m256d bottom = _mm256_set1_pd(std::numeric_limits<double>::lowest());
+            __m256d sum = _mm256_setzero_pd();
+            __m256d low = top;
+            __m256d high = bottom;
+            uint64_t count = 0;
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t bits = selection != nullptr ? selection[w] : ~0ull;
+                if (bits == 0)
+                {
+                    continue;
+                }
+                count += static_cast<uint64_t>(__builtin_popcountll(bits));
+                for (int j = 0; j < 16; j++, bits >>= 4)
+                {
+                    __m256d v = _mm256_loadu_pd(values + w * 64 + j * 4);
+                    __m256d mask = _mm256_castsi256_pd(_mm256_cmpeq_epi64(
+                        _mm256_and_si256(_mm256_set1_epi64x(static_cast<int64_t>(bits & 0xf)), lanes), lanes));
+                    sum = _mm256_add_pd(sum, _mm256_and_pd(v, mask));
+                    // min/max return their second operand if either is NaN: the candidate goes
+                    // first, so a NaN is skipped like in AggregateScalar
+                    low = _mm256_min_pd(_mm256_blendv_pd(top, v, mask), low);
+                    high = _mm256_max_pd(_mm256_blendv_pd(bottom, v, mask), high);
+                }
+            }
+
+            alignas(32) double sums[4], lows[4], highs[4];
+            _mm256_store_pd(sums, sum);
+            _mm256_store_pd(lows, low);
+            _mm256_store_pd(highs, high);
+            ColumnAggregate<double> partial;
+            partial.count = count;
+            partial.sum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+            for (int i = 0; i < 4; i++)
+            {
+                partial.min = lows[i] < partial.min ? lows[i] : partial.min;
+                partial.max = highs[i] > partial.max ? highs[i] : partial.max;
+            }
+            result->Merge(partial);
+        }
+
+        __attribute__((target("sse4.2,popcnt"))) void AggregateSse42(const int32_t *values, size_t words,
+                                                                      const uint64_t *selection,
+                                                                      ColumnAggregate<int32_t> *result)
+        {
+            const __m128i lanes = _mm_setr_epi32(1, 2, 4, 8);
+            const __m128i top = _mm_set1_epi32(INT32_MAX);
+            const __m128i bottom = _mm_set1_epi32(INT32_MIN);
+            __m128i sum = _mm_setzero_si128();
+            __m128i low = top;
+            __m128i high = bottom;
+            uint64_t count = 0;
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t bits = selection != nullptr ? selection[w] : ~0ull;
+                if (bits == 0)
+                {
+                    continue;
+                }
+                count += static_cast<uint64_t>(__builtin_popcountll(bits));
+                for (int j = 0; j < 16; j++, bits >>= 4)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + w * 64 + j * 4));
+                    __m128i mask =
+                        _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(static_cast<int>(bits & 0xf)), lanes), lanes);
+                    __m128i kept = _mm_and_si128(v, mask);
+                    sum = _mm_add_epi64(sum, _mm_cvtepi32_epi64(kept));
+                    sum = _mm_add_epi64(sum, _mm_cvtepi32_epi64(_mm_srli_si128(kept, 8)));
+                    low = _mm_min_epi32(low, _mm_blendv_epi8(top, v, mask));
+                    high = _mm_max_epi32(high, _mm_blendv_epi8(bottom, v, mask));
+                }
+            }
+
+            alignas(16) int64_t sums[2];
+            alignas(16) int32_t lows[4], highs[4];
+            _mm_store_si128(reinterpret_cast<__m128i *>(sums), sum);
+            _mm_store_si128(reinterpret_cast<__m128i *>(lows), low);
+            _mm_store_si128(reinterpret_cast<__m128i *>(highs), high);
+            ColumnAggregate<int32_t> partial;
+            partial.count = count;
+            partial.sum = AddToSum<int64_t>(sums[0], sums[1]);
+            for (int i = 0; i < 4; i++)
+            {
+                partial.min = lows[i] < partial.min ? lows[i] : partial.min;
+                partial.max = highs[i] > partial.max ? highs[i] : partial.max;
+            }
+            result->Merge(partial);
+        }
+
+        __attribute__((target("sse4.2,popcnt"))) void AggregateSse42(const int64_t *values, size_t words,
+                                                                      const uint64_t *selection,
+                                                                      ColumnAggregate<int64_t> *result)
+        {
+            const __m128i lanes = _mm_set_epi64x(2, 1);
+            const __m128i top = _mm_set1_epi64x(INT64_MAX);
+            const __m128i bottom = _mm_set1_epi64x(INT64_MIN);
+            __m128i sum = _mm_setzero_si128();
+            __m128i low = top;
+            __m128i high = bottom;
+            uint64_t count = 0;
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t bits = selection != nullptr ? selection[w] : ~0ull;
+                if (bits == 0)
+                {
+                    continue;
+                }
+                count += static_cast<uint64_t>(__builtin_popcountll(bits));
+                for (int j = 0; j < 32; j++, bits >>= 2)
+                {
+                    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(values + w * 64 + j * 2));
+                    __m128i mask = _mm_cmpeq_epi64(
+                        _mm_and_si128(_mm_set1_epi64x(static_cast<int64_t>(bits & 0x3)), lanes), lanes);
+                    sum = _mm_add_epi64(sum, _mm_and_si128(v, mask));
+                    __m128i low_candidate = _mm_blendv_epi8(top, v, mask);
+                    low = _mm_blendv_epi8(low, low_candidate, _mm_cmpgt_epi64(low, low_candidate));
+                    __m128i high_candidate = _mm_blendv_epi8(bottom, v, mask);
+                    high = _mm_blendv_epi8(high, high_candidate, _mm_cmpgt_epi64(high_candidate, high));
+                }
+            }
+
+            alignas(16) int64_t sums[2], lows[2], highs[2];
+            _mm_store_si128(reinterpret_cast<__m128i *>(sums), sum);
+            _mm_store_si128(reinterpret_cast<__m128i *>(lows), low);
+            _mm_store_si128(reinterpret_cast<__m128i *>(highs), high);
+            ColumnAggregate<int64_t> partial;
+            partial.count = count;
+            for (int i = 0; i < 2; i++)
+            {
+                partial.sum = AddToSum<int64_t>(partial.sum, sums[i]);
+                partial.min = lows[i] < partial.min ? lows[i] : partial.min;
+                partial.max = highs[i] > partial.max ? highs[i] : partial.max;
+            }
+            result->Merge(partial);
+        }
+
+        __attribute__((target("sse4.2,popcnt"))) void AggregateSse42(const double *values, size_t words,
+                                                                      const uint64_t *selection,
+                                                                      ColumnAggregate<double> *result)
+        {
+            const __m128i lanes = _mm_set_epi64x(2, 1);
+            const __m128d top = _mm_set1_pd(std::numeric_limits<double>::max());
+            const __m128d bottom = _mm_set1_pd(std::numeric_limits<double>::lowest());
+            __m128d sum = _mm_setzero_pd();
+            __m128d low = top;
+            __m128d high = bottom;
+            uint64_t count = 0;
+            for (size_t w = 0; w < words; w++)
+            {
+                uint64_t bits = selection != nullptr ? selection[w] : ~0ull;
+                if (bits == 0)
+                {
+                    continue;
+                }
+                count += static_cast<uint64_t>(__builtin_popcountll(bits));
+                for (int j = 0; j < 32; j++, bits >>= 2)
+                {
+                    __m128d v = _mm_loadu_pd(values + w * 64 + j * 2);
+                    __m128d mask = _mm_castsi128_pd(_mm_cmpeq_epi64(
+                        _mm_and_si128(_mm_set1_epi64x(static_cast<int64_t>(bits & 0x3)), lanes), lanes));
+                    sum = _mm_add_pd(sum, _mm_and_pd(v, mask));
+                    // Candidate first, so a NaN is skipped like in AggregateScalar
+                    low = _mm_min_pd(_mm_blendv_pd(top, v, mask), low);
+                    high = _mm_max_pd(_mm_blendv_pd(bottom, v, mask), high);
+                }
+            }
+
+            alignas(16) double sums[2], lows[2], highs[2];
+            _mm_store_pd(sums, sum);
+            _mm_store_pd(lows, low);
+            _mm_store_pd(highs, high);
+            ColumnAggregate<double> partial;
+            partial.count = count;
+            partial.sum = sums[0] + sums[1];
+            for (int i = 0; i < 2; i++)
+            {
+                partial.min = lows[i] < partial.min ? lows[i] : partial.min;
+                partial.max = highs[i] > partial.max ? highs[i] : partial.max;
+            }
+            result->Merge(partial);
+        }
+#endif
+
+        /// @brief Runs the widest filter available over whole words, then the scalar tail
+        template <typename T, Base B>
+        uint64_t FilterAll(const T *values, size_t count, T operand, bool negate, uint64_t *selection)
+        {
+            size_t words = 0;
+            uint64_t selected = 0;
+#ifdef MINIDB_SCAN_X86
+            SimdLevel level = ScanKernels::GetSimdLevel();
+            if (level == SimdLevel::AVX2)
+            {
+                words = count / 64;
+                selected = FilterAvx2<B>(values, words, operand, negate, selection);
+            }
+            else if (level == SimdLevel::SSE42)
+            {
+                words = count / 64;
+                selected = FilterSse42<B>(values, words, operand, negate, selection);
+            }
+#endif
+            return selected + FilterScalar<T, B>(values, words, count, operand, negate, selection);
+        }
+    }
+
+    template <typename T>
+    uint64_t ScanKernels::Filter(const T *values, size_t count, CompareOp op, T operand, uint64_t *selection)
+    {
+        Base base;
+        bool negate;
+        Decompose(op, &base, &negate);
+        switch (base)
+        {
+        case Base::EQ:
+            return FilterAll<T, Base::EQ>(values, count, operand, negate, selection);
+        case Base::GT:
+            return FilterAll<T, Base::GT>(values, count, operand, negate, selection);
+        default:
+            return FilterAll<T, Base::LT>(values, count, operand, negate, selection);
+        }
+    }
+
+    template <typename T>
+    void ScanKernels::Aggregate(const T *values, size_t count, const uint64_t *selection, ColumnAggregate<T> *result)
+    {
+        size_t words = 0;
+#ifdef MINIDB_SCAN_X86
+        SimdLevel level = GetSimdLevel();
+        if (level == SimdLevel::AVX2)
+        {
+            words = count / 64;
+            AggregateAvx2(values, words, selection, result);
+        }
+        else if (level == SimdLevel::SSE42)
+        {
+            words = count / 64;
+            AggregateSse42(values, words, selection, result);
+        }
+#endif
+        AggregateScalar(values, words * 64, count, selection, result);
+    }
+
+    uint64_t ScanKernels::And(uint64_t *selection, const uint64_t *other, size_t count)
+    {
+        uint64_t selected = 0;
+        for (size_t w = 0; w < (count + 63) / 64; w++)
+        {
+            selection[w] &= other[w];
+            selected += static_cast<uint64_t>(__builtin_popcountll(selection[w]));
+        }
+        return selected;
+    }
+
+    SimdLevel ScanKernels::GetSimdLevel()
+    {
+        int level = simd_level.load(std::memory_order_relaxed);
+        if (level < 0)
+        {
+            level = static_cast<int>(DetectSimdLevel());
+            simd_level.store(level, std::memory_order_relaxed);
+        }
+        return static_cast<SimdLevel>(level);
+    }
+
+    void ScanKernels::SetSimdLevel(SimdLevel level)
+    {
+        SimdLevel best = DetectSimdLevel();
+        simd_level.store(static_cast<int>(level < best ? level : best), std::memory_order_relaxed);
+    }
+
+    SimdLevel ScanKernels::DetectSimdLevel()
+    {
+#ifdef MINIDB_SCAN_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("popcnt"))
+        {
+            if (__builtin_cpu_supports("avx2"))
+            {
+                return SimdLevel::AVX2;
+            }
+            if (__builtin_cpu_supports("sse4.2"))
+            {
+                return SimdLevel::SSE42;
+            }
+        }
+#endif
+        return SimdLevel::SCALAR;
+    }
+
+    template uint64_t ScanKernels::Filter<int32_t>(const int32_t *, size_t, CompareOp, int32_t, uint64_t *);
+    template uint64_t ScanKernels::Filter<int64_t>(const int64_t *, size_t, CompareOp, int64_t, uint64_t *);
+    template uint64_t ScanKernels::Filter<double>(const double *, size_t, CompareOp, double, uint64_t *);
+    template void ScanKernels::Aggregate<int32_t>(const int32_t *, size_t, const uint64_t *, ColumnAggregate<int32_t> *);
+    template void ScanKernels::Aggregate<int64_t>(const int64_t *, size_t, const uint64_t *, ColumnAggregate<int64_t> *);
+    template void ScanKernels::Aggregate<double>(const double *, size_t, const uint64_t *, ColumnAggregate<double> *);
+
+} // namespace minidb
@@ -0,0 +1,497 @@
+#include "../include/sstable.h"
+
+#include <algorithm> // std::lower_bound
+#include <cstring>   // memcpy, memset
+#include <new>       // std::align_val_t
+#include <stdexcept> // std::runtime_error
+#include "../include/bloom_filter.h"
+
+namespace minidb
+{
+    namespace
+    {
+        /// @brief "MINISST\0"
+        const uint64_t TABLE_MAGIC = 0x00545353494E494DULL;
+
+        /// @brief Most pages per vectored write while building
+        const size_t BATCH_PAGES = 32;
+
+        /// @brief Meta page layout, followed by the blob's page IDs
+        struct MetaHeader
+        {
+            uint64_t magic;
+            uint64_t count;
+            uint32_t blob_size;
+            uint32_t blob_pages;
+        };
+
+        inline uint16_t Load16(const char *p)
+        {
+            uint16_t value;
+            memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        inline void Store16(char *p, uint16_t value)
+        {
+            memcpy(p, &value, sizeof(value));
+        }
+
+        template <typename T>
+        inline void Append(std::string *out, T value)
+        {
+            out->append(reinterpret_cast<const char *>(&value), sizeof(value));
+        }
+
+        template <typename T>
+        inline T Take(const std::string &in, size_t *pos)
+        {
+            if (*pos + sizeof(T) > in.size())
+            {
+                throw std::runtime_error("Corrupt table blob");
+            }
+            T value;
+            memcpy(&value, in.data() + *pos, sizeof(T));
+            *pos += sizeof(T);
+            return value;
+        }
+
+        inline std::string TakeBytes(const std::string &in, size_t *pos, size_t size)
+        {
+            if (*pos + size > in.size())
+            {
+                throw std::runtime_error("Corrupt table blob");
+            }
+            std::string bytes = in.substr(*pos, size);
+            *pos += size;
+            return bytes;
+        }
+
+        /// @brief Page buffers aligned for O_DIRECT
+        inline char *AllocatePages(size_t pages, size_t page_size)
+        {
+            return static_cast<char *>(operator new[](pages * page_size, std::align_val_t(PAGE_ALIGNMENT)));
+        }
+
+        inline void FreePages(char *buffer)
+        {
+            operator delete[](buffer, std::align_val_t(PAGE_ALIGNMENT));
+        }
+    }
+
+    template <int32_t PageSize>
+    BasicSSTable<PageSize>::Builder::Builder(BasicDiskManager<PageSize> *disk_manager, int bits_per_key)
+        : disk_manager_(disk_manager), bits_per_key_(bits_per_key), batch_(AllocatePages(BATCH_PAGES, PageSize))
+    {
+        block_.reserve(PageSize);
+    }
+
+    template <int32_t PageSize>
+    BasicSSTable<PageSize>::Builder::~Builder()
+    {
+        for (page_id_t page_id : pages_)
+        {
+            disk_manager_->DeallocatePage(page_id);
+        }
+        FreePages(batch_);
+    }
+
+    template <int32_t PageSize>
+    void BasicSSTable<PageSize>::Builder::Add(std::string_view key, std::string_view value, bool deleted)
+    {
+        if (deleted)
+        {
+            value = std::string_view();
+        }
+        if (key.size() + value.size() > MAX_ENTRY_BYTES)
+        {
+            throw std::runtime_error("Entry of " + std::to_string(key.size() + value.size()) +
+                                     " bytes does not fit in a table block");
+        }
+
+        size_t entry_bytes = 4 + key.size() + value.size();
+        if (2 + 2 * (offsets_.size() + 1) + block_.size() + entry_bytes > static_cast<size_t>(PageSize))
+        {
+            FinishBlock();
+        }
+        if (hashes_.empty())
+        {
+            smallest_.assign(key);
+        }
+
+        offsets_.push_back(static_cast<uint16_t>(block_.size()));
+        size_t at = block_.size();
+        block_.resize(at + entry_bytes);
+        Store16(&block_[at], static_cast<uint16_t>(key.size()));
+        Store16(&block_[at + 2], static_cast<uint16_t>(value.size() | (deleted ? DELETED_FLAG : 0)));
+        memcpy(&block_[at + 4], key.data(), key.size());
+        if (!value.empty())
+        {
+            memcpy(&block_[at + 4 + key.size()], value.data(), value.size());
+        }
+        last_key_.assign(key);
+        hashes_.push_back(BloomFilter::Hash(key));
+    }
+
+    template <int32_t PageSize>
+    std::shared_ptr<BasicSSTable<PageSize>> BasicSSTable<PageSize>::Builder::Finish()
+    {
+        if (hashes_.empty())
+        {
+            return nullptr;
+        }
+        if (!offsets_.empty())
+        {
+            FinishBlock();
+        }
+
+        std::shared_ptr<BasicSSTable> table(new BasicSSTable(disk_manager_, INVALID_PAGE_ID));
+        table->count_ = hashes_.size();
+        table->smallest_ = std::move(smallest_);
+        table->largest_ = last_key_;
+        table->bloom_ = BloomFilter::Build(hashes_, bits_per_key_);
+        table->index_ = std::move(index_);
+
+        std::string blob = table->EncodeBlob();
+        size_t blob_pages = (blob.size() + PageSize - 1) / PageSize;
+        if (sizeof(MetaHeader) + blob_pages * sizeof(page_id_t) > static_cast<size_t>(PageSize))
+        {
+            throw std::runtime_error("Table index does not fit one meta page");
+        }
+        for (size_t i = 0; i < blob_pages; i++)
+        {
+            page_id_t page_id;
+            char *page = NextPage(&page_id);
+            size_t chunk = std::min<size_t>(PageSize, blob.size() - i * PageSize);
+            memcpy(page, blob.data() + i * PageSize, chunk);
+            memset(page + chunk, 0, PageSize - chunk);
+            table->blob_pages_.push_back(page_id);
+        }
+
+        char *meta = NextPage(&table->meta_page_id_);
+        memset(meta, 0, PageSize);
+        MetaHeader header{TABLE_MAGIC, table->count_, static_cast<uint32_t>(blob.size()),
+                          static_cast<uint32_t>(blob_pages)};
+        memcpy(meta, &header, sizeof(header));
+        memcpy(meta + sizeof(header), table->blob_pages_.data(), blob_pages * sizeof(page_id_t));
+        FlushBatch();
+
+        // The pages belong to the table now
+        pages_.clear();
+        hashes_.clear();
+        return table;
+    }
+
+    template <int32_t PageSize>
+    void BasicSSTable<PageSize>::Builder::FinishBlock()
+    {
+        page_id_t page_id;
+        char *page = NextPage(&page_id);
+        size_t header = 2 + 2 * offsets_.size();
+        Store16(page, static_cast<uint16_t>(offsets_.size()));
+        for (size_t i = 0; i < offsets_.size(); i++)
+        {
+            Store16(page + 2 + 2 * i, static_cast<uint16_t>(header + offsets_[i]));
+        }
+        memcpy(page + header, block_.data(), block_.size());
+        memset(page + header + block_.size(), 0, PageSize - header - block_.size());
+
+        index_.emplace_back(last_key_, page_id);
+        block_.clear();
+        offsets_.clear();
+    }
+
+    template <int32_t PageSize>
+    char *BasicSSTable<PageSize>::Builder::NextPage(page_id_t *page_id)
+    {
+        // Every byte is written, so a reused page needs no zeroing first
+        *page_id = disk_manager_->AllocatePage(false);
+        pages_.push_back(*page_id);
+        if (batch_count_ > 0 && (*page_id != batch_first_ + static_cast<page_id_t>(batch_count_) ||
+                                 batch_count_ == BATCH_PAGES))
+        {
+            FlushBatch();
+        }
+        if (batch_count_ == 0)
+        {
+            batch_first_ = *page_id;
+        }
+        return batch_ + PageSize * batch_count_++;
+    }
+
+    template <int32_t PageSize>
+    void BasicSSTable<PageSize>::Builder::FlushBatch()
+    {
+        if (batch_count_ == 0)
+        {
+            return;
+        }
+        iovec pages[BATCH_PAGES];
+        for (size_t i = 0; i < batch_count_; i++)
+        {
+            pages[i].iov_base = batch_ + PageSize * i;
+            pages[i].iov_len = PageSize;
+        }
+        disk_manager_->WritePages(batch_first_, pages, batch_count_);
+        batch_count_ = 0;
+    }
+
+    template <int32_t PageSize>
+    BasicSSTable<PageSize>::Iterator::Iterator(const BasicSSTable *table)
+        : table_(table), block_(AllocatePages(1, PageSize)), block_index_(table->index_.size())
+    {
+    }
+
+    template <int32_t PageSize>
+    BasicSSTable<PageSize>::Iterator::~Iterator()
+    {
+        FreePages(block_);
+    }
+
+    template <int32_t PageSize>
+    void BasicSSTable<PageSize>::Iterator::SeekToFirst()
+    {
+        LoadBlock(0, 0);
+    }
+
+    template <int32_t PageSize>
+    void BasicSSTable<PageSize>::Iterator::Seek(std::string_view key)
+    {
+        size_t block_index = table_->FindBlock(key);
+        if (block_index == table_->index_.size())
+        {
+            block_index_ = block_index;
+            return;
+        }
+        if (block_index != block_index_ || count_ == 0)
+        {
+            LoadBlock(block_index, 0);
+        }
+        entry_ = SeekInBlock(block_, key);
+        Decode();
+    }
+
+    template <int32_t PageSize>
+    void BasicSSTable<PageSize>::Iterator::Next()
+    {
+        if (++entry_ < count_)
+        {
+            Decode();
+            return;
+        }
+        LoadBlock(block_index_ + 1, 0);
+    }
+
+    template <int32_t PageSize>
+    void BasicSSTable<PageSize>::Iterator::LoadBlock(size_t block_index, uint16_t entry)
+    {
+        block_index_ = block_index;
+        count_ = 0;
+        if (block_index_ >= table_->index_.size())
+        {
+            return;
+        }
+        table_->disk_manager_->ReadPage(table_->index_[block_index_].second, block_);
+        count_ = Load16(block_);
+        entry_ = entry;
+        Decode();
+    }
+
+    template <int32_t PageSize>
+    void BasicSSTable<PageSize>::Iterator::Decode()
+    {
+        if (entry_ >= count_)
+        {
+            // Only a Seek past a block's last key gets here; its successor starts the next block
+            LoadBlock(block_index_ + 1, 0);
+            return;
+        }
+        DecodeEntry(block_, entry_, &key_, &value_, &deleted_);
+    }
+
+    template <int32_t PageSize>
+    BasicSSTable<PageSize>::BasicSSTable(BasicDiskManager<PageSize> *disk_manager, page_id_t meta_page_id)
+        : disk_manager_(disk_manager), meta_page_id_(meta_page_id)
+    {
+    }
+
+    template <int32_t PageSize>
+    std::shared_ptr<BasicSSTable<PageSize>> BasicSSTable<PageSize>::Open(BasicDiskManager<PageSize> *disk_manager,
+                                                                        page_id_t meta_page_id)
+    {
+        std::shared_ptr<BasicSSTable> table(new BasicSSTable(disk_manager, meta_page_id));
+        char *page = AllocatePages(1, PageSize);
+        try
+        {
+            disk_manager->ReadPage(meta_page_id, page);
+            MetaHeader header;
+            memcpy(&header, page, sizeof(header));
+            if (header.magic != TABLE_MAGIC ||
+                sizeof(header) + header.blob_pages * sizeof(page_id_t) > static_cast<size_t>(PageSize) ||
+                header.blob_size > static_cast<uint64_t>(header.blob_pages) * PageSize)
+            {
+                throw std::runtime_error("Page " + std::to_string(meta_page_id) + " is not a table");
+            }
+            table->count_ = header.count;
+            table->blob_pages_.resize(header.blob_pages);
+            memcpy(table->blob_pages_.data(), page + sizeof(header), header.blob_pages * sizeof(page_id_t));
+
+            std::string blob;
+            blob.reserve(static_cast<size_t>(header.blob_pages) * PageSize);
+            for (page_id_t blob_page : table->blob_pages_)
+            {
+                disk_manager->ReadPage(blob_page, page);
+                blob.append(page, PageSize);
+            }
+            blob.resize(header.blob_size);
+            table->DecodeBlob(blob);
+        }
+        catch (...)
+        {
+            FreePages(page);
+            throw;
+        }
+        FreePages(page);
+        return table;
+    }
+
+    template <int32_t PageSize>
+    BasicSSTable<PageSize>::~BasicSSTable()
+    {
+        if (!obsolete_.load(std::memory_order_acquire))
+        {
+            return;
+        }
+        for (const auto &block : index_)
+        {
+            disk_manager_->DeallocatePage(block.second);
+        }
+        for (page_id_t page_id : blob_pages_)
+        {
+            disk_manager_->DeallocatePage(page_id);
+        }
+        disk_manager_->DeallocatePage(meta_page_id_);
+    }
+
+    template <int32_t PageSize>
+    bool BasicSSTable<PageSize>::Get(std::string_view key, std::string *value, bool *deleted) const
+    {
+        if (!BloomFilter::MayContain(bloom_, BloomFilter::Hash(key)))
+        {
+            return false;
+        }
+        size_t block_index = FindBlock(key);
+        if (block_index == index_.size())
+        {
+            return false;
+        }
+
+        alignas(PAGE_ALIGNMENT) char block[PageSize];
+        disk_manager_->ReadPage(index_[block_index].second, block);
+        uint16_t entry = SeekInBlock(block, key);
+        if (entry == Load16(block))
+        {
+            return false;
+        }
+        std::string_view found_key, found_value;
+        DecodeEntry(block, entry, &found_key, &found_value, deleted);
+        if (found_key != key)
+        {
+            return false;
+        }
+        if (!*deleted)
+        {
+            value->assign(found_value);
+        }
+        return true;
+    }
+
+    template <int32_t PageSize>
+    std::string BasicSSTable<PageSize>::EncodeBlob() const
+    {
+        std::string blob;
+        Append<uint16_t>(&blob, static_cast<uint16_t>(smallest_.size()));
+        blob += smallest_;
+        Append<uint32_t>(&blob, static_cast<uint32_t>(bloom_.size()));
+        blob += bloom_;
+        Append<uint32_t>(&blob, static_cast<uint32_t>(index_.size()));
+        for (const auto &block : index_)
+        {
+            Append<page_id_t>(&blob, block.second);
+            Append<uint16_t>(&blob, static_cast<uint16_t>(block.first.size()));
+            blob += block.first;
+        }
+        return blob;
+    }
+
+    template <int32_t PageSize>
+    void BasicSSTable<PageSize>::DecodeBlob(const std::string &blob)
+    {
+        size_t pos = 0;
+        smallest_ = TakeBytes(blob, &pos, Take<uint16_t>(blob, &pos));
+        bloom_ = TakeBytes(blob, &pos, Take<uint32_t>(blob, &pos));
+        uint32_t blocks = Take<uint32_t>(blob, &pos);
+        index_.reserve(blocks);
+        for (uint32_t i = 0; i < blocks; i++)
+        {
+            page_id_t page_id = Take<page_id_t>(blob, &pos);
+            index_.emplace_back(TakeBytes(blob, &pos, Take<uint16_t>(blob, &pos)), page_id);
+        }
+        if (index_.empty())
+        {
+            throw std::runtime_error("Corrupt table blob");
+        }
+        largest_ = index_.back().first;
+    }
+
+    template <int32_t PageSize>
+    size_t BasicSSTable<PageSize>::FindBlock(std::string_view key) const
+    {
+        auto block = std::lower_bound(index_.begin(), index_.end(), key,
+                                      [](const std::pair<std::string, page_id_t> &entry, std::string_view target)
+                                      { return std::string_view(entry.first) < target; });
+        return static_cast<size_t>(block - index_.begin());
+    }
+
+    template <int32_t PageSize>
+    uint16_t BasicSSTable<PageSize>::SeekInBlock(const char *block, std::string_view key)
+    {
+        uint16_t low = 0;
+        uint16_t high = Load16(block);
+        while (low < high)
+        {
+            uint16_t middle = static_cast<uint16_t>(low + (high - low) / 2);
+            std::string_view middle_key, value;
+            bool deleted;
+            DecodeEntry(block, middle, &middle_key, &value, &deleted);
+            if (middle_key < key)
+            {
+                low = static_cast<uint16_t>(middle + 1);
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+        return low;
+    }
+
+    template <int32_t PageSize>
+    void BasicSSTable<PageSize>::DecodeEntry(const char *block, uint16_t entry, std::string_view *key,
+                                             std::string_view *value, bool *deleted)
+    {
+        const char *at = block + Load16(block + 2 + 2 * entry);
+        uint16_t key_size = Load16(at);
+        uint16_t value_size = Load16(at + 2);
+        *deleted = (value_size & DELETED_FLAG) != 0;
+        value_size &= static_cast<uint16_t>(~DELETED_FLAG);
+        *key = std::string_view(at + 4, key_size);
+        *value = std::string_view(at + 4 + key_size, value_size);
+    }
+
+    template class BasicSSTable<4096>;
+    template class BasicSSTable<8192>;
+    template class BasicSSTable<16384>;
+    template class BasicSSTable<65536>;
+
+} // namespace minidb
@@ -0,0 +1,76 @@
+#include "../include/stats.h"
+
+namespace minidb
+{
+    uint64_t StripedCounter::Load() const
+    {
+        uint64_t total = 0;
+        for (const Stripe &stripe : stripes_)
+        {
+            total += stripe.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void LatencyHistogram::Merge(const LatencyHistogram &other)
+    {
+        for (size_t i = 0; i < BUCKETS; i++)
+        {
+            counts_[i] += other.counts_[i];
+        }
+        total_ += other.total_;
+        sum_ += other.sum_;
+    }
+
+    uint64_t LatencyHistogram::Percentile(double fraction) const
+    {
+        uint64_t target = static_cast<uint64_t>(fraction * total_);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; i++)
+        {
+            seen += counts_[i];
+            if (seen > target || (seen == total_ && seen > 0))
+            {
+                return UpperBound(i);
+            }
+        }
+        return 0;
+    }
+
+    uint64_t LatencyHistogram::Max() const
+    {
+        for (size_t i = BUCKETS; i > 0; i--)
+        {
+            if (counts_[i - 1] != 0)
+            {
+                return UpperBound(i - 1);
+            }
+        }
+        return 0;
+    }
+
+    uint64_t LatencyHistogram::UpperBound(size_t bucket)
+    {
+        if (bucket < SUB_BUCKETS)
+        {
+            return bucket;
+        }
+        uint64_t exponent = bucket / SUB_BUCKETS + 3;
+        uint64_t sub = bucket % SUB_BUCKETS;
+        // The last bucket ends at UINT64_MAX, where the shift wraps to 0
+        return ((SUB_BUCKETS + sub + 1) << (exponent - 4)) - 1;
+    }
+
+    LatencyHistogram ConcurrentLatencyHistogram::Snapshot() const
+    {
+        LatencyHistogram snapshot;
+        for (size_t i = 0; i < LatencyHistogram::BUCKETS; i++)
+        {
+            snapshot.counts_[i] = counts_[i].load(std::memory_order_relaxed);
+            snapshot.total_ += snapshot.counts_[i];
+        }
+        snapshot.sum_ = sum_.Load();
+        return snapshot;
+    }
+
+} // namespace minidb
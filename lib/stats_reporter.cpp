@@ -0,0 +1,151 @@
+#include "../include/stats_reporter.h"
+
+#include <cstdio> // std::snprintf
+
+namespace minidb
+{
+    namespace
+    {
+        /// @brief Appends "name":{"count":..,"mean":..,"p50":..,...} or name=count/p50/p99/p999/max
+        void AppendHistogram(std::string *out, const char *name, const LatencyHistogram &histogram,
+                             StatsFormat format)
+        {
+            char buffer[256];
+            if (format == StatsFormat::JSON)
+            {
+                std::snprintf(buffer, sizeof(buffer),
+                              "\"%s\":{\"count\":%llu,\"mean\":%.0f,\"p50\":%llu,\"p99\":%llu,\"p999\":%llu,"
+                              "\"max\":%llu}",
+                              name, static_cast<unsigned long long>(histogram.Count()), histogram.Mean(),
+                              static_cast<unsigned long long>(histogram.Percentile(0.5)),
+                              static_cast<unsigned long long>(histogram.Percentile(0.99)),
+                              static_cast<unsigned long long>(histogram.Percentile(0.999)),
+                              static_cast<unsigned long long>(histogram.Max()));
+            }
+            else
+            {
+                std::snprintf(buffer, sizeof(buffer), "%s_ns=%llu/%llu/%llu/%llu/%llu", name,
+                              static_cast<unsigned long long>(histogram.Count()),
+                              static_cast<unsigned long long>(histogram.Percentile(0.5)),
+                              static_cast<unsigned long long>(histogram.Percentile(0.99)),
+                              static_cast<unsigned long long>(histogram.Percentile(0.999)),
+                              static_cast<unsigned long long>(histogram.Max()));
+            }
+            *out += buffer;
+        }
+
+        /// @brief Appends "name":value or name=value
+        void AppendCounter(std::string *out, const char *name, uint64_t value, StatsFormat format)
+        {
+            char buffer[96];
+            std::snprintf(buffer, sizeof(buffer), format == StatsFormat::JSON ? "\"%s\":%llu" : "%s=%llu", name,
+                          static_cast<unsigned long long>(value));
+            *out += buffer;
+        }
+    }
+
+    std::string FormatStats(const BufferPoolStats &pool, const DiskStats *disk, StatsFormat format)
+    {
+        bool json = format == StatsFormat::JSON;
+        const char *separator = json ? "," : " ";
+        std::string out = json ? "{\"pool\":{" : "pool: ";
+
+        AppendCounter(&out, "hits", pool.hits, format);
+        out += separator;
+        AppendCounter(&out, "misses", pool.misses, format);
+        out += separator;
+        AppendCounter(&out, "evictions", pool.evictions, format);
+        out += separator;
+        AppendCounter(&out, "dirty_evictions", pool.dirty_evictions, format);
+        out += separator;
+        AppendCounter(&out, "writebacks", pool.writebacks, format);
+        out += separator;
+        AppendCounter(&out, "pin_failures", pool.pin_failures, format);
+        out += separator;
+        AppendCounter(&out, "free_frames", pool.free_frames, format);
+        out += separator;
+        AppendHistogram(&out, "fetch_miss", pool.fetch_miss_latency, format);
+        out += json ? "}" : "";
+
+        if (disk != nullptr)
+        {
+            out += json ? ",\"disk\":{" : " | disk: ";
+            AppendCounter(&out, "reads", disk->reads, format);
+            out += separator;
+            AppendCounter(&out, "writes", disk->writes, format);
+            out += separator;
+            AppendCounter(&out, "bytes_read", disk->bytes_read, format);
+            out += separator;
+            AppendCounter(&out, "bytes_written", disk->bytes_written, format);
+            out += separator;
+            AppendHistogram(&out, "read_page", disk->read_page_latency, format);
+            out += separator;
+            AppendHistogram(&out, "write_page", disk->write_page_latency, format);
+            out += json ? "}" : "";
+        }
+        out += json ? "}" : "";
+        return out;
+    }
+
+    StatsReporter::StatsReporter(buffer_pool *pool, DiskManager *disk_manager, std::ostream *out,
+                                 const ReporterOptions &options)
+        : pool_(pool), disk_manager_(disk_manager), out_(out), options_(options)
+    {
+        thread_ = std::thread(&StatsReporter::Run, this);
+    }
+
+    StatsReporter::~StatsReporter()
+    {
+        Stop();
+    }
+
+    void StatsReporter::Report()
+    {
+        BufferPoolStats pool = pool_->GetStats();
+        std::string line;
+        if (disk_manager_ != nullptr)
+        {
+            DiskStats disk = disk_manager_->GetStats();
+            line = FormatStats(pool, &disk, options_.format);
+        }
+        else
+        {
+            line = FormatStats(pool, nullptr, options_.format);
+        }
+
+        std::lock_guard<std::mutex> guard(latch_);
+        *out_ << line << '\n';
+        out_->flush();
+    }
+
+    void StatsReporter::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            stop_ = true;
+        }
+        stop_cv_.notify_all();
+        if (thread_.joinable())
+        {
+            thread_.join();
+        }
+    }
+
+    void StatsReporter::Run()
+    {
+        std::unique_lock<std::mutex> lock(latch_);
+        while (!stop_)
+        {
+            stop_cv_.wait_for(lock, options_.interval, [this]()
+                              { return stop_; });
+            if (stop_)
+            {
+                break;
+            }
+            lock.unlock();
+            Report();
+            lock.lock();
+        }
+    }
+
+} // namespace minidb
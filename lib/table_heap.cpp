@@ -0,0 +1,182 @@
+#include "../include/table_heap.h"
+
+#include <stdexcept> // std::out_of_range
+
+namespace minidb
+{
+    template <int32_t PageSize>
+    BasicTableHeap<PageSize>::Iterator::Iterator(basic_buffer_pool<PageSize> *pool, page_id_t first_page_id,
+                                                 BufferAccessStrategy *strategy)
+        : pool_(pool), strategy_(strategy)
+    {
+        page_ = pool_->FetchPage(first_page_id, strategy_);
+        rid_ = {first_page_id, 0};
+        SeekLive();
+    }
+
+    template <int32_t PageSize>
+    BasicTableHeap<PageSize>::Iterator::Iterator(Iterator &&other) noexcept
+        : pool_(other.pool_), strategy_(other.strategy_), page_(other.page_), rid_(other.rid_), view_(other.view_)
+    {
+        other.page_ = nullptr;
+    }
+
+    template <int32_t PageSize>
+    BasicTableHeap<PageSize>::Iterator::~Iterator()
+    {
+        if (page_ != nullptr)
+        {
+            pool_->UnpinPage(rid_.page_id, false);
+        }
+    }
+
+    template <int32_t PageSize>
+    void BasicTableHeap<PageSize>::Iterator::Next()
+    {
+        if (page_ == nullptr)
+        {
+            return;
+        }
+        rid_.slot++;
+        SeekLive();
+    }
+
+    template <int32_t PageSize>
+    void BasicTableHeap<PageSize>::Iterator::SeekLive()
+    {
+        while (page_ != nullptr)
+        {
+            BasicTablePage<PageSize> table_page(page_->GetData());
+            uint32_t slot_count = table_page.GetSlotCount();
+            for (; rid_.slot < slot_count; rid_.slot++)
+            {
+                if (table_page.Get(rid_.slot, &view_))
+                {
+                    return;
+                }
+            }
+
+            // Page done, hand it back before pinning the next
+            page_id_t next = table_page.GetNextPageId();
+            pool_->UnpinPage(rid_.page_id, false);
+            page_ = nullptr;
+            if (next != INVALID_PAGE_ID)
+            {
+                page_ = pool_->FetchPage(next, strategy_);
+                rid_ = {next, 0};
+            }
+        }
+        view_ = TupleView();
+    }
+
+    template <int32_t PageSize>
+    BasicTableHeap<PageSize>::BasicTableHeap(basic_buffer_pool<PageSize> *pool) : pool_(pool)
+    {
+        BasicPage<PageSize> *page = pool_->NewPage(&first_page_id_);
+        BasicTablePage<PageSize>(page->GetData()).Init();
+        pool_->UnpinPage(first_page_id_, true);
+        last_page_id_ = first_page_id_;
+    }
+
+    template <int32_t PageSize>
+    BasicTableHeap<PageSize>::BasicTableHeap(basic_buffer_pool<PageSize> *pool, page_id_t first_page_id)
+        : pool_(pool), first_page_id_(first_page_id), last_page_id_(first_page_id)
+    {
+        while (true)
+        {
+            BasicPage<PageSize> *page = pool_->FetchPage(last_page_id_);
+            page_id_t next = BasicTablePage<PageSize>(page->GetData()).GetNextPageId();
+            pool_->UnpinPage(last_page_id_, false);
+            if (next == INVALID_PAGE_ID)
+            {
+                break;
+            }
+            last_page_id_ = next;
+        }
+    }
+
+    template <int32_t PageSize>
+    RID BasicTableHeap<PageSize>::Insert(const char *tuple, uint32_t size)
+    {
+        if (size > BasicTablePage<PageSize>::MAX_TUPLE_SIZE)
+        {
+            throw std::out_of_range("Tuple of " + std::to_string(size) + " bytes does not fit in a page");
+        }
+
+        RID rid;
+        BasicPage<PageSize> *last = pool_->FetchPage(last_page_id_);
+        BasicTablePage<PageSize> last_page(last->GetData());
+        if (last_page.Insert(tuple, size, &rid.slot))
+        {
+            pool_->UnpinPage(last_page_id_, true);
+            rid.page_id = last_page_id_;
+            return rid;
+        }
+
+        // Last page full, chain a new one
+        page_id_t new_page_id;
+        BasicPage<PageSize> *page;
+        try
+        {
+            page = pool_->NewPage(&new_page_id);
+        }
+        catch (...)
+        {
+            pool_->UnpinPage(last_page_id_, false);
+            throw;
+        }
+        BasicTablePage<PageSize> new_page(page->GetData());
+        new_page.Init();
+        new_page.Insert(tuple, size, &rid.slot);
+        last_page.SetNextPageId(new_page_id);
+        pool_->UnpinPage(new_page_id, true);
+        pool_->UnpinPage(last_page_id_, true);
+
+        last_page_id_ = new_page_id;
+        rid.page_id = new_page_id;
+        return rid;
+    }
+
+    template <int32_t PageSize>
+    bool BasicTableHeap<PageSize>::Get(const RID &rid, std::string *tuple)
+    {
+        BasicPage<PageSize> *page = pool_->FetchPage(rid.page_id);
+        TupleView view;
+        bool found = BasicTablePage<PageSize>(page->GetData()).Get(rid.slot, &view);
+        if (found)
+        {
+            tuple->assign(view.data, view.size);
+        }
+        pool_->UnpinPage(rid.page_id, false);
+        return found;
+    }
+
+    template <int32_t PageSize>
+    bool BasicTableHeap<PageSize>::Update(const RID &rid, const char *tuple, uint32_t size)
+    {
+        BasicPage<PageSize> *page = pool_->FetchPage(rid.page_id);
+        bool updated = BasicTablePage<PageSize>(page->GetData()).Update(rid.slot, tuple, size);
+        pool_->UnpinPage(rid.page_id, updated);
+        return updated;
+    }
+
+    template <int32_t PageSize>
+    bool BasicTableHeap<PageSize>::Delete(const RID &rid)
+    {
+        BasicPage<PageSize> *page = pool_->FetchPage(rid.page_id);
+        bool deleted = BasicTablePage<PageSize>(page->GetData()).Delete(rid.slot);
+        pool_->UnpinPage(rid.page_id, deleted);
+        return deleted;
+    }
+
+    template <int32_t PageSize>
+    typename BasicTableHeap<PageSize>::Iterator BasicTableHeap<PageSize>::Begin(BufferAccessStrategy *strategy)
+    {
+        return Iterator(pool_, first_page_id_, strategy);
+    }
+
+    template class BasicTableHeap<4096>;
+    template class BasicTableHeap<8192>;
+    template class BasicTableHeap<16384>;
+    template class BasicTableHeap<65536>;
+}
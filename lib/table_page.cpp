@@ -0,0 +1,186 @@
+#include "../include/table_page.h"
+
+#include <algorithm> // std::sort
+#include <utility>   // std::pair
+#include <vector>    // std::vector
+
+namespace minidb
+{
+    template <int32_t PageSize>
+    void BasicTablePage<PageSize>::Init()
+    {
+        memset(data_ + NEXT_PAGE_OFFSET, 0, PageSize - NEXT_PAGE_OFFSET);
+        SetNextPageId(INVALID_PAGE_ID);
+        Write<uint32_t>(SLOT_COUNT_OFFSET, 0);
+        Write<uint32_t>(FREE_END_OFFSET, PageSize);
+        Write<uint32_t>(TUPLE_BYTES_OFFSET, 0);
+    }
+
+    template <int32_t PageSize>
+    bool BasicTablePage<PageSize>::Insert(const char *tuple, uint32_t size, uint32_t *slot_ptr)
+    {
+        // Reuse the first free slot, else grow the directory
+        uint32_t slot_count = GetSlotCount();
+        uint32_t slot = 0;
+        for (; slot < slot_count; slot++)
+        {
+            uint32_t offset, old_size;
+            GetSlot(slot, &offset, &old_size);
+            if (offset == 0)
+            {
+                break;
+            }
+        }
+        uint32_t needed = size + (slot == slot_count ? SLOT_SIZE : 0);
+        if (needed > GetFreeSpace())
+        {
+            return false;
+        }
+
+        if (needed > GetContiguousSpace())
+        {
+            Compact();
+        }
+        if (slot == slot_count)
+        {
+            Write<uint32_t>(SLOT_COUNT_OFFSET, slot_count + 1);
+        }
+        SetSlot(slot, Place(tuple, size), size);
+        *slot_ptr = slot;
+        return true;
+    }
+
+    template <int32_t PageSize>
+    bool BasicTablePage<PageSize>::Get(uint32_t slot, TupleView *view)
+    {
+        if (slot >= GetSlotCount())
+        {
+            return false;
+        }
+        uint32_t offset, size;
+        GetSlot(slot, &offset, &size);
+        if (offset == 0)
+        {
+            return false;
+        }
+        view->data = data_ + offset;
+        view->size = size;
+        return true;
+    }
+
+    template <int32_t PageSize>
+    bool BasicTablePage<PageSize>::Update(uint32_t slot, const char *tuple, uint32_t size)
+    {
+        if (slot >= GetSlotCount())
+        {
+            return false;
+        }
+        uint32_t offset, old_size;
+        GetSlot(slot, &offset, &old_size);
+        if (offset == 0)
+        {
+            return false;
+        }
+
+        // Shrinking stays in place, the tail becomes a hole
+        uint32_t tuple_bytes = Read<uint32_t>(TUPLE_BYTES_OFFSET);
+        if (size <= old_size)
+        {
+            memmove(data_ + offset, tuple, size);
+            SetSlot(slot, offset, size);
+            Write<uint32_t>(TUPLE_BYTES_OFFSET, tuple_bytes - old_size + size);
+            return true;
+        }
+        if (size - old_size > GetFreeSpace())
+        {
+            return false;
+        }
+
+        // Growing: free the old bytes, then place the tuple like an insert
+        SetSlot(slot, 0, 0);
+        Write<uint32_t>(TUPLE_BYTES_OFFSET, tuple_bytes - old_size);
+        if (size > GetContiguousSpace())
+        {
+            Compact();
+        }
+        SetSlot(slot, Place(tuple, size), size);
+        return true;
+    }
+
+    template <int32_t PageSize>
+    bool BasicTablePage<PageSize>::Delete(uint32_t slot)
+    {
+        uint32_t slot_count = GetSlotCount();
+        if (slot >= slot_count)
+        {
+            return false;
+        }
+        uint32_t offset, size;
+        GetSlot(slot, &offset, &size);
+        if (offset == 0)
+        {
+            return false;
+        }
+        SetSlot(slot, 0, 0);
+        Write<uint32_t>(TUPLE_BYTES_OFFSET, Read<uint32_t>(TUPLE_BYTES_OFFSET) - size);
+
+        // Trailing free slots can go, earlier ones must stay so RIDs keep their meaning
+        while (slot_count > 0)
+        {
+            GetSlot(slot_count - 1, &offset, &size);
+            if (offset != 0)
+            {
+                break;
+            }
+            slot_count--;
+        }
+        Write<uint32_t>(SLOT_COUNT_OFFSET, slot_count);
+        return true;
+    }
+
+    template <int32_t PageSize>
+    void BasicTablePage<PageSize>::Compact()
+    {
+        // Highest tuple first, so every move goes up into space already vacated
+        uint32_t slot_count = GetSlotCount();
+        std::vector<std::pair<uint32_t, uint32_t>> live;
+        live.reserve(slot_count);
+        for (uint32_t slot = 0; slot < slot_count; slot++)
+        {
+            uint32_t offset, size;
+            GetSlot(slot, &offset, &size);
+            if (offset != 0)
+            {
+                live.push_back({offset, slot});
+            }
+        }
+        std::sort(live.begin(), live.end(), [](const std::pair<uint32_t, uint32_t> &a, const std::pair<uint32_t, uint32_t> &b)
+                  { return a.first > b.first; });
+
+        uint32_t end = PageSize;
+        for (const auto &entry : live)
+        {
+            uint32_t offset, size;
+            GetSlot(entry.second, &offset, &size);
+            end -= size;
+            memmove(data_ + end, data_ + offset, size);
+            SetSlot(entry.second, end, size);
+        }
+        Write<uint32_t>(FREE_END_OFFSET, end);
+    }
+
+    template <int32_t PageSize>
+    uint32_t BasicTablePage<PageSize>::Place(const char *tuple, uint32_t size)
+    {
+        uint32_t offset = Read<uint32_t>(FREE_END_OFFSET) - size;
+        memcpy(data_ + offset, tuple, size);
+        Write<uint32_t>(FREE_END_OFFSET, offset);
+        Write<uint32_t>(TUPLE_BYTES_OFFSET, Read<uint32_t>(TUPLE_BYTES_OFFSET) + size);
+        return offset;
+    }
+
+    template class BasicTablePage<4096>;
+    template class BasicTablePage<8192>;
+    template class BasicTablePage<16384>;
+    template class BasicTablePage<65536>;
+}
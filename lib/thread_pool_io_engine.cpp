@@ -0,0 +1,143 @@
+#include "../include/thread_pool_io_engine.h"
+
+#include <algorithm> // std::min
+#include <cerrno>    // errno
+#include <unistd.h>  // pread, pwrite
+
+namespace minidb
+{
+    ThreadPoolIOEngine::ThreadPoolIOEngine(size_t queue_depth, size_t num_threads)
+        : queue_depth_(queue_depth == 0 ? 1 : queue_depth)
+    {
+        if (num_threads == 0)
+        {
+            num_threads = std::min<size_t>(queue_depth_, 16);
+        }
+        for (size_t i = 0; i < num_threads; i++)
+        {
+            workers_.emplace_back(&ThreadPoolIOEngine::Run, this);
+        }
+    }
+
+    ThreadPoolIOEngine::~ThreadPoolIOEngine()
+    {
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            stop_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto &worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    bool ThreadPoolIOEngine::PrepareRead(int fd, char *buffer, size_t length, off_t offset, uint64_t user_data)
+    {
+        if (in_flight_ >= queue_depth_)
+        {
+            return false;
+        }
+        prepared_.push_back({fd, false, buffer, length, offset, user_data});
+        in_flight_++;
+        return true;
+    }
+
+    bool ThreadPoolIOEngine::PrepareWrite(int fd, const char *buffer, size_t length, off_t offset, uint64_t user_data)
+    {
+        if (in_flight_ >= queue_depth_)
+        {
+            return false;
+        }
+        prepared_.push_back({fd, true, const_cast<char *>(buffer), length, offset, user_data});
+        in_flight_++;
+        return true;
+    }
+
+    size_t ThreadPoolIOEngine::Submit()
+    {
+        size_t submitted = prepared_.size();
+        if (submitted == 0)
+        {
+            return 0;
+        }
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            queue_.insert(queue_.end(), prepared_.begin(), prepared_.end());
+        }
+        prepared_.clear();
+        work_cv_.notify_all();
+        return submitted;
+    }
+
+    size_t ThreadPoolIOEngine::Complete(std::vector<IOCompletion> *completions, size_t min_complete)
+    {
+        min_complete = std::min(min_complete, in_flight_ - prepared_.size());
+
+        std::unique_lock<std::mutex> lock(latch_);
+        done_cv_.wait(lock, [&]()
+                      { return completed_.size() >= min_complete; });
+        size_t reaped = completed_.size();
+        completions->insert(completions->end(), completed_.begin(), completed_.end());
+        completed_.clear();
+        lock.unlock();
+
+        in_flight_ -= reaped;
+        return reaped;
+    }
+
+    bool ThreadPoolIOEngine::RegisterBuffers(const std::vector<iovec> &)
+    {
+        // Nothing to pin for plain pread/pwrite
+        return true;
+    }
+
+    size_t ThreadPoolIOEngine::InFlight()
+    {
+        return in_flight_;
+    }
+
+    size_t ThreadPoolIOEngine::QueueDepth()
+    {
+        return queue_depth_;
+    }
+
+    const char *ThreadPoolIOEngine::Name()
+    {
+        return "thread pool";
+    }
+
+    void ThreadPoolIOEngine::Run()
+    {
+        while (true)
+        {
+            Request request;
+            {
+                std::unique_lock<std::mutex> lock(latch_);
+                work_cv_.wait(lock, [this]()
+                              { return stop_ || !queue_.empty(); });
+                if (queue_.empty())
+                {
+                    return;
+                }
+                request = queue_.front();
+                queue_.pop_front();
+            }
+
+            ssize_t n;
+            do
+            {
+                n = request.is_write ? pwrite(request.fd, request.buffer, request.length, request.offset)
+                                     : pread(request.fd, request.buffer, request.length, request.offset);
+            } while (n < 0 && errno == EINTR);
+            int32_t result = n < 0 ? -errno : static_cast<int32_t>(n);
+
+            {
+                std::lock_guard<std::mutex> guard(latch_);
+                completed_.push_back({request.user_data, result});
+            }
+            done_cv_.notify_one();
+        }
+    }
+
+} // namespace minidb
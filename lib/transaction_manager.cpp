@@ -0,0 +1,111 @@
+#include "../include/transaction_manager.h"
+
+#include <stdexcept> // std::out_of_range, std::runtime_error
+
+namespace minidb
+{
+    template <int32_t PageSize>
+    BasicTransactionManager<PageSize>::BasicTransactionManager(basic_buffer_pool<PageSize> *pool,
+                                                               LogManager *log_manager, txn_id_t next_txn_id)
+        : pool_(pool), log_manager_(log_manager), next_txn_id_(next_txn_id)
+    {
+        pool_->SetLogManager(log_manager_);
+    }
+
+    template <int32_t PageSize>
+    Transaction BasicTransactionManager<PageSize>::Begin()
+    {
+        Transaction txn;
+        txn.txn_id = next_txn_id_.fetch_add(1, std::memory_order_relaxed);
+        AppendControl(&txn, LogRecordType::BEGIN);
+        return txn;
+    }
+
+    template <int32_t PageSize>
+    void BasicTransactionManager<PageSize>::Update(Transaction *txn, BasicPage<PageSize> *page, uint32_t offset,
+                                                   const char *data, uint32_t size)
+    {
+        if (offset < BasicPage<PageSize>::HEADER_SIZE || static_cast<uint64_t>(offset) + size > PageSize)
+        {
+            throw std::out_of_range("Update of bytes [" + std::to_string(offset) + ", " +
+                                    std::to_string(static_cast<uint64_t>(offset) + size) + ") outside page data");
+        }
+
+        LogRecord record;
+        record.type = LogRecordType::UPDATE;
+        record.txn_id = txn->txn_id;
+        record.prev_lsn = txn->prev_lsn;
+        record.page_id = page->GetPageId();
+        record.offset = offset;
+        record.before_image.assign(page->GetData() + offset, page->GetData() + offset + size);
+        record.after_image.assign(data, data + size);
+        lsn_t lsn = log_manager_->Append(&record);
+
+        memcpy(page->GetData() + offset, data, size);
+        page->SetLSN(lsn);
+        txn->prev_lsn = lsn;
+    }
+
+    template <int32_t PageSize>
+    void BasicTransactionManager<PageSize>::Commit(Transaction *txn)
+    {
+        lsn_t lsn = AppendControl(txn, LogRecordType::COMMIT);
+        log_manager_->Flush(lsn);
+        txn->state = TransactionState::COMMITTED;
+    }
+
+    template <int32_t PageSize>
+    void BasicTransactionManager<PageSize>::Abort(Transaction *txn)
+    {
+        LogRecord record;
+        lsn_t undo_lsn = txn->prev_lsn;
+        while (undo_lsn != INVALID_LSN)
+        {
+            if (!log_manager_->ReadRecord(undo_lsn, &record))
+            {
+                throw std::runtime_error("Missing log record " + std::to_string(undo_lsn) + " of transaction " +
+                                         std::to_string(txn->txn_id));
+            }
+
+            if (record.type == LogRecordType::UPDATE)
+            {
+                // Compensation record: redo-only, restores the before image
+                LogRecord clr;
+                clr.type = LogRecordType::CLR;
+                clr.txn_id = txn->txn_id;
+                clr.prev_lsn = txn->prev_lsn;
+                clr.page_id = record.page_id;
+                clr.offset = record.offset;
+                clr.undo_next_lsn = record.prev_lsn;
+                clr.after_image = record.before_image;
+
+                BasicPage<PageSize> *page = pool_->FetchPage(record.page_id);
+                lsn_t lsn = log_manager_->Append(&clr);
+                memcpy(page->GetData() + clr.offset, clr.after_image.data(), clr.after_image.size());
+                page->SetLSN(lsn);
+                pool_->UnpinPage(record.page_id, true);
+                txn->prev_lsn = lsn;
+            }
+            undo_lsn = record.type == LogRecordType::CLR ? record.undo_next_lsn : record.prev_lsn;
+        }
+
+        AppendControl(txn, LogRecordType::ABORT);
+        txn->state = TransactionState::ABORTED;
+    }
+
+    template <int32_t PageSize>
+    lsn_t BasicTransactionManager<PageSize>::AppendControl(Transaction *txn, LogRecordType type)
+    {
+        LogRecord record;
+        record.type = type;
+        record.txn_id = txn->txn_id;
+        record.prev_lsn = txn->prev_lsn;
+        txn->prev_lsn = log_manager_->Append(&record);
+        return txn->prev_lsn;
+    }
+
+    template class BasicTransactionManager<4096>;
+    template class BasicTransactionManager<8192>;
+    template class BasicTransactionManager<16384>;
+    template class BasicTransactionManager<65536>;
+}
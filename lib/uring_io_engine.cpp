@@ -0,0 +1,276 @@
+#include "../include/uring_io_engine.h"
+
+#include <algorithm>    // std::sort, std::upper_bound
+#include <cerrno>       // errno
+#include <cstring>      // memset, strerror
+#include <stdexcept>    // std::runtime_error
+#include <string>       // std::string
+#include <sys/mman.h>   // mmap, munmap
+#include <sys/syscall.h>
+#include <unistd.h>     // syscall, close
+
+namespace minidb
+{
+    namespace
+    {
+        inline int SysSetup(unsigned entries, io_uring_params *params)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+        }
+
+        inline int SysEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+        }
+
+        inline int SysRegister(int ring_fd, unsigned opcode, const void *arg, unsigned nr_args)
+        {
+            return static_cast<int>(syscall(__NR_io_uring_register, ring_fd, opcode, arg, nr_args));
+        }
+
+        template <typename T>
+        inline T *RingField(void *ring, uint32_t offset)
+        {
+            return reinterpret_cast<T *>(static_cast<char *>(ring) + offset);
+        }
+    }
+
+    UringIOEngine::UringIOEngine(size_t queue_depth)
+    {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        ring_fd_ = SysSetup(static_cast<unsigned>(queue_depth == 0 ? 1 : queue_depth), &params);
+        if (ring_fd_ < 0)
+        {
+            throw std::runtime_error(std::string("io_uring_setup failed: ") + strerror(errno));
+        }
+        sq_entries_ = params.sq_entries;
+        cq_entries_ = params.cq_entries;
+
+        // Map submission ring, completion ring (shared on newer kernels) and the SQE array
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_mmap)
+        {
+            sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+        }
+
+        sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        ring_fd_, IORING_OFF_SQ_RING);
+        if (sq_ring_ == MAP_FAILED)
+        {
+            close(ring_fd_);
+            throw std::runtime_error(std::string("io_uring ring mmap failed: ") + strerror(errno));
+        }
+        cq_ring_ = single_mmap ? sq_ring_
+                               : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                      ring_fd_, IORING_OFF_CQ_RING);
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        void *sqes = cq_ring_ == MAP_FAILED
+                         ? MAP_FAILED
+                         : mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                ring_fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+        {
+            int saved = errno;
+            munmap(sq_ring_, sq_ring_size_);
+            if (!single_mmap && cq_ring_ != MAP_FAILED)
+            {
+                munmap(cq_ring_, cq_ring_size_);
+            }
+            close(ring_fd_);
+            throw std::runtime_error(std::string("io_uring ring mmap failed: ") + strerror(saved));
+        }
+        sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+        sq_head_ = RingField<unsigned>(sq_ring_, params.sq_off.head);
+        sq_tail_ = RingField<unsigned>(sq_ring_, params.sq_off.tail);
+        sq_mask_ = RingField<unsigned>(sq_ring_, params.sq_off.ring_mask);
+        sq_array_ = RingField<unsigned>(sq_ring_, params.sq_off.array);
+        cq_head_ = RingField<unsigned>(cq_ring_, params.cq_off.head);
+        cq_tail_ = RingField<unsigned>(cq_ring_, params.cq_off.tail);
+        cq_mask_ = RingField<unsigned>(cq_ring_, params.cq_off.ring_mask);
+        cqes_ = RingField<io_uring_cqe>(cq_ring_, params.cq_off.cqes);
+
+        local_tail_ = *sq_tail_;
+    }
+
+    UringIOEngine::~UringIOEngine()
+    {
+        munmap(sqes_, sqes_size_);
+        if (cq_ring_ != sq_ring_)
+        {
+            munmap(cq_ring_, cq_ring_size_);
+        }
+        munmap(sq_ring_, sq_ring_size_);
+        close(ring_fd_);
+    }
+
+    bool UringIOEngine::PrepareRead(int fd, char *buffer, size_t length, off_t offset, uint64_t user_data)
+    {
+        return Prepare(IORING_OP_READ, fd, buffer, length, offset, user_data);
+    }
+
+    bool UringIOEngine::PrepareWrite(int fd, const char *buffer, size_t length, off_t offset, uint64_t user_data)
+    {
+        return Prepare(IORING_OP_WRITE, fd, buffer, length, offset, user_data);
+    }
+
+    bool UringIOEngine::Prepare(uint8_t opcode, int fd, const char *buffer, size_t length, off_t offset,
+                                uint64_t user_data)
+    {
+        // Never have more requests out than the completion ring can hold
+        unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+        if (local_tail_ - head >= sq_entries_ || in_flight_ >= cq_entries_)
+        {
+            return false;
+        }
+
+        unsigned index = local_tail_ & *sq_mask_;
+        io_uring_sqe *sqe = &sqes_[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = opcode;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(buffer);
+        sqe->len = static_cast<uint32_t>(length);
+        sqe->off = static_cast<uint64_t>(offset);
+        sqe->user_data = user_data;
+
+        const RegisteredBuffer *fixed = FindRegistered(buffer, length);
+        if (fixed != nullptr)
+        {
+            sqe->opcode = opcode == IORING_OP_READ ? IORING_OP_READ_FIXED : IORING_OP_WRITE_FIXED;
+            sqe->buf_index = fixed->index;
+        }
+
+        sq_array_[index] = index;
+        local_tail_++;
+        pending_++;
+        in_flight_++;
+        return true;
+    }
+
+    size_t UringIOEngine::Submit()
+    {
+        if (pending_ == 0)
+        {
+            return 0;
+        }
+
+        // Publish every prepared entry, then one syscall for the whole batch
+        __atomic_store_n(sq_tail_, local_tail_, __ATOMIC_RELEASE);
+        size_t submitted = 0;
+        while (pending_ > 0)
+        {
+            int ret = SysEnter(ring_fd_, pending_, 0, 0);
+            if (ret < 0)
+            {
+                if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+                {
+                    continue;
+                }
+                throw std::runtime_error(std::string("io_uring_enter failed: ") + strerror(errno));
+            }
+            pending_ -= ret;
+            submitted += ret;
+        }
+        return submitted;
+    }
+
+    size_t UringIOEngine::Complete(std::vector<IOCompletion> *completions, size_t min_complete)
+    {
+        min_complete = std::min(min_complete, in_flight_ - pending_);
+        size_t reaped = 0;
+        while (true)
+        {
+            unsigned head = *cq_head_;
+            unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            while (head != tail)
+            {
+                const io_uring_cqe &cqe = cqes_[head & *cq_mask_];
+                completions->push_back({cqe.user_data, cqe.res});
+                head++;
+                reaped++;
+            }
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+
+            if (reaped >= min_complete)
+            {
+                break;
+            }
+            int ret = SysEnter(ring_fd_, 0, static_cast<unsigned>(min_complete - reaped), IORING_ENTER_GETEVENTS);
+            if (ret < 0 && errno != EINTR && errno != EAGAIN)
+            {
+                throw std::runtime_error(std::string("io_uring_enter failed: ") + strerror(errno));
+            }
+        }
+        in_flight_ -= reaped;
+        return reaped;
+    }
+
+    bool UringIOEngine::RegisterBuffers(const std::vector<iovec> &buffers)
+    {
+        if (!registered_.empty())
+        {
+            SysRegister(ring_fd_, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+            registered_.clear();
+        }
+        if (buffers.empty() || buffers.size() > UINT16_MAX)
+        {
+            return false;
+        }
+        // Fails with ENOMEM under a small RLIMIT_MEMLOCK; plain READ/WRITE keep working
+        if (SysRegister(ring_fd_, IORING_REGISTER_BUFFERS, buffers.data(), static_cast<unsigned>(buffers.size())) < 0)
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < buffers.size(); i++)
+        {
+            registered_.push_back({static_cast<char *>(buffers[i].iov_base), buffers[i].iov_len, static_cast<uint16_t>(i)});
+        }
+        std::sort(registered_.begin(), registered_.end(),
+                  [](const RegisteredBuffer &a, const RegisteredBuffer &b)
+                  { return a.base < b.base; });
+        return true;
+    }
+
+    const UringIOEngine::RegisteredBuffer *UringIOEngine::FindRegistered(const char *buffer, size_t length) const
+    {
+        if (registered_.empty())
+        {
+            return nullptr;
+        }
+        // Last region starting at or before buffer
+        auto it = std::upper_bound(registered_.begin(), registered_.end(), buffer,
+                                   [](const char *address, const RegisteredBuffer &region)
+                                   { return address < region.base; });
+        if (it == registered_.begin())
+        {
+            return nullptr;
+        }
+        --it;
+        if (buffer + length <= it->base + it->length)
+        {
+            return &*it;
+        }
+        return nullptr;
+    }
+
+    size_t UringIOEngine::InFlight()
+    {
+        return in_flight_;
+    }
+
+    size_t UringIOEngine::QueueDepth()
+    {
+        return std::min(sq_entries_, cq_entries_);
+    }
+
+    const char *UringIOEngine::Name()
+    {
+        return "io_uring";
+    }
+
+} // namespace minidb
@@ -0,0 +1,148 @@
+#include "../include/work_stealing_pool.h"
+
+namespace minidb
+{
+    WorkStealingPool::WorkStealingPool(size_t threads)
+    {
+        threads = threads == 0 ? 1 : threads;
+        for (size_t i = 0; i < threads; i++)
+        {
+            queues_.emplace_back(new Queue());
+        }
+        for (size_t i = 0; i < threads; i++)
+        {
+            workers_.emplace_back(&WorkStealingPool::Run, this, i);
+        }
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> guard(latch_);
+            stop_ = true;
+        }
+        work_cv_.notify_all();
+        for (auto &worker : workers_)
+        {
+            worker.join();
+        }
+    }
+
+    void WorkStealingPool::ParallelFor(size_t count, const std::function<void(size_t, size_t)> &fn)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> batch(batch_latch_);
+
+        // Contiguous blocks, the first count % threads workers taking one extra
+        size_t threads = queues_.size();
+        size_t next = 0;
+        for (size_t w = 0; w < threads; w++)
+        {
+            size_t share = count / threads + (w < count % threads ? 1 : 0);
+            std::lock_guard<std::mutex> guard(queues_[w]->latch);
+            for (size_t i = 0; i < share; i++)
+            {
+                queues_[w]->tasks.push_back(next++);
+            }
+        }
+
+        std::exception_ptr error;
+        {
+            std::unique_lock<std::mutex> lock(latch_);
+            fn_ = &fn;
+            active_ = threads;
+            error_ = nullptr;
+            failed_.store(false, std::memory_order_relaxed);
+            generation_++;
+            work_cv_.notify_all();
+            done_cv_.wait(lock, [&]()
+                          { return active_ == 0; });
+            fn_ = nullptr;
+            error = error_;
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    void WorkStealingPool::Run(size_t worker)
+    {
+        uint64_t seen = 0;
+        while (true)
+        {
+            const std::function<void(size_t, size_t)> *fn;
+            {
+                std::unique_lock<std::mutex> lock(latch_);
+                work_cv_.wait(lock, [&]()
+                              { return stop_ || generation_ != seen; });
+                if (stop_)
+                {
+                    return;
+                }
+                seen = generation_;
+                fn = fn_;
+            }
+
+            size_t index;
+            while (Next(worker, &index))
+            {
+                if (failed_.load(std::memory_order_relaxed))
+                {
+                    continue;
+                }
+                try
+                {
+                    (*fn)(index, worker);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> guard(latch_);
+                    if (!error_)
+                    {
+                        error_ = std::current_exception();
+                    }
+                    failed_.store(true, std::memory_order_relaxed);
+                }
+            }
+
+            // Every task was dealt before the batch started, so empty deques mean no more work
+            std::lock_guard<std::mutex> guard(latch_);
+            if (--active_ == 0)
+            {
+                done_cv_.notify_all();
+            }
+        }
+    }
+
+    bool WorkStealingPool::Next(size_t worker, size_t *index)
+    {
+        {
+            Queue &own = *queues_[worker];
+            std::lock_guard<std::mutex> guard(own.latch);
+            if (!own.tasks.empty())
+            {
+                *index = own.tasks.front();
+                own.tasks.pop_front();
+                return true;
+            }
+        }
+        for (size_t i = 1; i < queues_.size(); i++)
+        {
+            Queue &victim = *queues_[(worker + i) % queues_.size()];
+            std::lock_guard<std::mutex> guard(victim.latch);
+            if (!victim.tasks.empty())
+            {
+                // The far end of the victim's block, away from where it is working
+                *index = victim.tasks.back();
+                victim.tasks.pop_back();
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+}
@@ -1,16 +1,66 @@
 #include <iostream>
+#include <cstdio>
 #include <cstring>
 #include <cassert>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <map>
+#include <atomic>
+#include <string>
+#include <random>
+#include <sstream>
+#include <fstream>
+#include <sys/stat.h>
 
 #include "common.h"
 #include "page.h"
 #include "disk_manager.h"
 #include "buffer_pool.h"
+#include "parallel_buffer_pool.h"
+#include "replacer.h"
+#include "async_disk_manager.h"
+#include "page_cleaner.h"
+#include "log_manager.h"
+#include "transaction_manager.h"
+#include "log_recovery.h"
+#include "table_page.h"
+#include "table_heap.h"
+#include "b_plus_tree.h"
+#include "extendible_hash_table.h"
+#include "stats_reporter.h"
+#include "compressed_cache.h"
+#include "lsm_tree.h"
+#include "bloom_filter.h"
+#include "scan_kernels.h"
+#include "pax_table.h"
+#include "executor.h"
+#include "hash_operators.h"
+#include "async_context.h"
+#include "mmap_pool.h"
 
 void test_common();
 void test_page();
 void test_disk_manager();
 void test_buffer_pool();
+void test_parallel_buffer_pool();
+void test_replacer();
+void test_async_disk_manager();
+void test_checkpoint();
+void test_read_ahead();
+void test_access_strategy();
+void test_wal();
+void test_table_heap();
+void test_b_plus_tree();
+void test_page_guard();
+void test_extendible_hash_table();
+void test_stats();
+void test_compressed_cache();
+void test_lsm_tree();
+void test_pax_scan();
+void test_executor();
+void test_async_fetch();
+void test_mmap_pool();
 
 int main()
 {
@@ -24,6 +74,24 @@ int main()
         test_page();
         test_disk_manager();
         test_buffer_pool();
+        test_parallel_buffer_pool();
+        test_replacer();
+        test_async_disk_manager();
+        test_checkpoint();
+        test_read_ahead();
+        test_access_strategy();
+        test_wal();
+        test_table_heap();
+        test_b_plus_tree();
+        test_page_guard();
+        test_extendible_hash_table();
+        test_stats();
+        test_compressed_cache();
+        test_lsm_tree();
+        test_pax_scan();
+        test_executor();
+        test_async_fetch();
+        test_mmap_pool();
 
         std::cout << "\n==================================" << std::endl;
         std::cout << "  ✓ All Tests Passed!            " << std::endl;
@@ -40,7 +108,7 @@ int main()
 
 void test_common()
 {
-    std::cout << "\n[1/4] Testing common.h" << std::endl;
+    std::cout << "\n[1/22] Testing common.h" << std::endl;
     std::cout << "-------------------------------" << std::endl;
 
     std::cout << "  PAGE_SIZE: " << minidb::PAGE_SIZE << " bytes" << std::endl;
@@ -57,7 +125,7 @@ void test_common()
 
 void test_page()
 {
-    std::cout << "\n[2/4] Testing Page" << std::endl;
+    std::cout << "\n[2/22] Testing Page" << std::endl;
     std::cout << "-------------------------------" << std::endl;
 
     // Test default initialization
@@ -99,9 +167,10 @@ void test_page()
 
 void test_disk_manager()
 {
-    std::cout << "\n[3/4] Testing DiskManager" << std::endl;
+    std::cout << "\n[3/22] Testing DiskManager" << std::endl;
     std::cout << "-------------------------------" << std::endl;
 
+    std::remove("data/test.db");
     minidb::DiskManager dm("data/test.db");
 
     // Test page allocation
@@ -132,13 +201,213 @@ void test_disk_manager()
     dm.ReadPage(p2, read_buf);
     assert(strcmp(read_buf, "Page 2 content") == 0);
     std::cout << "  ✓ Multiple page persistence" << std::endl;
+
+    // Test O_DIRECT with aligned frame memory and with an unaligned caller buffer
+    std::remove("data/test_direct.db");
+    minidb::DiskManager direct_dm("data/test_direct.db", true);
+    assert(direct_dm.IsDirectIO());
+    minidb::page_id_t d0 = direct_dm.AllocatePage();
+    minidb::page_id_t d1 = direct_dm.AllocatePage();
+    minidb::Page frame;
+    assert(reinterpret_cast<uintptr_t>(frame.GetData()) % minidb::PAGE_ALIGNMENT == 0);
+    strcpy(frame.GetData(), "Direct aligned");
+    direct_dm.WritePage(d0, frame.GetData());
+    strcpy(write_buf + 1, "Direct unaligned");
+    direct_dm.WritePage(d1, write_buf + 1);
+    direct_dm.Sync();
+
+    memset(frame.GetData(), 0, minidb::PAGE_SIZE);
+    direct_dm.ReadPage(d0, frame.GetData());
+    assert(strcmp(frame.GetData(), "Direct aligned") == 0);
+    direct_dm.ReadPage(d1, read_buf + 1);
+    assert(strcmp(read_buf + 1, "Direct unaligned") == 0);
+    std::cout << "  ✓ O_DIRECT read/write (aligned and bounced)" << std::endl;
+
+    // Test reopen keeps allocated pages
+    std::remove("data/test_reopen.db");
+    {
+        minidb::DiskManager first("data/test_reopen.db");
+        for (int i = 0; i < 5; i++)
+        {
+            minidb::page_id_t pid = first.AllocatePage();
+            sprintf(write_buf, "Reopen page %lld", (long long)pid);
+            first.WritePage(pid, write_buf);
+        }
+        first.DeallocatePage(2);
+    }
+    {
+        minidb::DiskManager reopened("data/test_reopen.db");
+        assert(reopened.GetNumPages() == 5 && reopened.GetFreePages() == 1);
+        reopened.ReadPage(4, read_buf);
+        assert(strcmp(read_buf, "Reopen page 4") == 0);
+        assert(reopened.AllocatePage() == 2);
+        reopened.ReadPage(2, read_buf);
+        assert(read_buf[0] == '\0');
+        assert(reopened.AllocatePage() == 5);
+    }
+    bool rejected = false;
+    try
+    {
+        minidb::BasicDiskManager<16384> wrong_size("data/test_reopen.db");
+    }
+    catch (const std::runtime_error &)
+    {
+        rejected = true;
+    }
+    assert(rejected);
+    std::cout << "  ✓ Reopen keeps page count, freed page reused zeroed, page size checked" << std::endl;
+
+    // Test free-page reuse and vectored I/O across a bitmap group boundary
+    std::remove("data/test_bitmap.db");
+    minidb::DiskManager bitmap_dm("data/test_bitmap.db");
+    const minidb::page_id_t group = minidb::DiskManager::PAGES_PER_GROUP;
+    for (minidb::page_id_t i = 0; i < group + 8; i++)
+    {
+        bitmap_dm.AllocatePage();
+    }
+    bitmap_dm.DeallocatePage(group + 3);
+    bitmap_dm.DeallocatePage(7);
+    bitmap_dm.DeallocatePage(7);
+    assert(bitmap_dm.GetFreePages() == 2);
+    assert(bitmap_dm.AllocatePage() == 7 && bitmap_dm.AllocatePage() == group + 3);
+    assert(bitmap_dm.AllocatePage() == group + 8);
+
+    minidb::Page cross[4];
+    iovec cross_io[4];
+    for (int i = 0; i < 4; i++)
+    {
+        sprintf(cross[i].GetData(), "Cross page %lld", (long long)(group - 2 + i));
+        cross_io[i] = {cross[i].GetData(), static_cast<size_t>(minidb::PAGE_SIZE)};
+    }
+    bitmap_dm.WritePages(group - 2, cross_io, 4);
+    for (int i = 0; i < 4; i++)
+    {
+        char expected[64];
+        sprintf(expected, "Cross page %lld", (long long)(group - 2 + i));
+        bitmap_dm.ReadPage(group - 2 + i, read_buf);
+        assert(strcmp(read_buf, expected) == 0);
+        memset(cross[i].GetData(), 0, minidb::PAGE_SIZE);
+    }
+    bitmap_dm.ReadPages(group - 2, cross_io, 4);
+    char last_expected[64];
+    sprintf(last_expected, "Cross page %lld", (long long)(group + 1));
+    assert(strcmp(cross[3].GetData(), last_expected) == 0);
+    std::cout << "  ✓ Freed pages reused lowest first, vectored I/O across bitmap pages" << std::endl;
+    std::remove("data/test_bitmap.db");
+
+    // Test reopening after a crash, i.e. the file as a running manager left it: pages appended or
+    // reused since the last Sync are not handed out again, pages freed since are reused
+    std::remove("data/test_crash.db");
+    std::remove("data/test_crash_copy.db");
+    {
+        minidb::DiskManager live("data/test_crash.db");
+        for (int i = 0; i < 8; i++)
+        {
+            live.AllocatePage();
+        }
+        live.DeallocatePage(5);
+        live.Sync();
+        assert(live.AllocatePage() == 5);
+        for (int i = 0; i < 4; i++)
+        {
+            live.AllocatePage();
+        }
+        for (minidb::page_id_t pid = 2; pid <= 4; pid++)
+        {
+            live.DeallocatePage(pid);
+        }
+        const minidb::page_id_t written_ids[] = {5, 10};
+        for (minidb::page_id_t pid : written_ids)
+        {
+            sprintf(write_buf, "Live page %lld", (long long)pid);
+            live.WritePage(pid, write_buf);
+        }
+        std::ifstream from("data/test_crash.db", std::ios::binary);
+        std::ofstream to("data/test_crash_copy.db", std::ios::binary);
+        to << from.rdbuf();
+    }
+    {
+        minidb::DiskManager recovered("data/test_crash_copy.db");
+        assert(recovered.GetNumPages() >= 12);
+        const minidb::page_id_t written_ids[] = {5, 10};
+        for (minidb::page_id_t pid : written_ids)
+        {
+            char expected[64];
+            sprintf(expected, "Live page %lld", (long long)pid);
+            recovered.ReadPage(pid, read_buf);
+            assert(strcmp(read_buf, expected) == 0);
+        }
+        assert(recovered.GetFreePages() == 3);
+        for (minidb::page_id_t pid = 2; pid <= 4; pid++)
+        {
+            assert(recovered.AllocatePage() == pid);
+        }
+        for (int i = 0; i < 2; i++)
+        {
+            assert(recovered.AllocatePage() >= 12);
+        }
+    }
+    std::remove("data/test_crash.db");
+    std::remove("data/test_crash_copy.db");
+    std::cout << "  ✓ No page ID handed out twice across a crash" << std::endl;
+
+    // Test 64-bit page IDs in sparse 1 GiB segments, past the 4 GiB and 16 GiB marks
+    const char *big_file = "data/test_segments.db";
+    const uint64_t gib = 1ULL << 30;
+    minidb::StorageOptions sparse;
+    sparse.preallocate = false;
+    const minidb::page_id_t past_4g = static_cast<minidb::page_id_t>(4 * gib / minidb::PAGE_SIZE);
+    const minidb::page_id_t past_16g = static_cast<minidb::page_id_t>(16 * gib / minidb::PAGE_SIZE);
+    auto remove_segments = [&]()
+    {
+        std::remove(big_file);
+        for (int i = 1; i <= 17; i++)
+        {
+            std::remove((std::string(big_file) + "." + std::to_string(i)).c_str());
+        }
+    };
+    remove_segments();
+    {
+        minidb::DiskManager big_dm(big_file, false, sparse);
+        assert(big_dm.GetSegmentBytes() == gib);
+        while (big_dm.GetNumPages() <= past_16g)
+        {
+            big_dm.AllocatePage();
+        }
+        const minidb::page_id_t far_ids[] = {0, past_4g, past_16g};
+        for (minidb::page_id_t pid : far_ids)
+        {
+            sprintf(write_buf, "Far page %lld", (long long)pid);
+            big_dm.WritePage(pid, write_buf);
+        }
+    }
+    {
+        minidb::DiskManager big_dm(big_file, false, sparse);
+        assert(big_dm.GetNumPages() == past_16g + 1);
+        const minidb::page_id_t far_ids[] = {0, past_4g, past_16g};
+        for (minidb::page_id_t pid : far_ids)
+        {
+            char expected[64];
+            sprintf(expected, "Far page %lld", (long long)pid);
+            big_dm.ReadPage(pid, read_buf);
+            assert(strcmp(read_buf, expected) == 0);
+        }
+        big_dm.ReadPage(past_16g - 1, read_buf);
+        assert(read_buf[0] == '\0');
+    }
+    struct stat seg_stat;
+    assert(stat((std::string(big_file) + ".16").c_str(), &seg_stat) == 0);
+    assert(static_cast<uint64_t>(seg_stat.st_blocks) * 512 < static_cast<uint64_t>(seg_stat.st_size));
+    remove_segments();
+    std::cout << "  ✓ Pages past 4 GiB and 16 GiB in sparse segment files" << std::endl;
 }
 
 void test_buffer_pool()
 {
-    std::cout << "\n[4/4] Testing BufferPool" << std::endl;
+    std::cout << "\n[4/22] Testing BufferPool" << std::endl;
     std::cout << "-------------------------------" << std::endl;
 
+    std::remove("data/test_bp.db");
     minidb::DiskManager dm("data/test_bp.db");
     minidb::buffer_pool pool(3, &dm);
 
@@ -241,4 +510,2595 @@ void test_buffer_pool()
         }
     }
     std::cout << "    ✓ Accessed " << access_count << " pages in random order" << std::endl;
-}
\ No newline at end of file
+
+    // Test 10: Frame data lives in one aligned arena
+    std::cout << "  [4.10] Frame arena..." << std::endl;
+    std::vector<iovec> frames = pool.GetFrameBuffers();
+    for (size_t i = 0; i < frames.size(); i++)
+    {
+        assert(reinterpret_cast<uintptr_t>(frames[i].iov_base) % minidb::PAGE_ALIGNMENT == 0);
+        assert(static_cast<char *>(frames[i].iov_base) ==
+               static_cast<char *>(frames[0].iov_base) + i * minidb::PAGE_SIZE);
+    }
+    minidb::buffer_pool huge_pool(1024, &dm, minidb::ReplacerPolicy::LRU, true);
+    minidb::page_id_t huge_pid;
+    minidb::Page *huge_page = huge_pool.NewPage(&huge_pid);
+    strcpy(huge_page->GetData(), "Huge page frame");
+    huge_pool.UnpinPage(huge_pid, true);
+    huge_pool.FlushPage(huge_pid);
+    char huge_buf[minidb::PAGE_SIZE];
+    dm.ReadPage(huge_pid, huge_buf);
+    assert(strcmp(huge_buf, "Huge page frame") == 0);
+    std::cout << "    ✓ " << frames.size() << " contiguous aligned frames, huge page request falls back cleanly"
+              << std::endl;
+
+    // Test 11: Larger page sizes in the same process
+    std::cout << "  [4.11] 16 KiB and 64 KiB pages..." << std::endl;
+    std::remove("data/test_bp_16k.db");
+    minidb::BasicDiskManager<16384> dm16("data/test_bp_16k.db");
+    minidb::basic_buffer_pool<16384> pool16(2, &dm16);
+    std::remove("data/test_bp_64k.db");
+    minidb::BasicDiskManager<65536> dm64("data/test_bp_64k.db");
+    minidb::basic_buffer_pool<65536> pool64(2, &dm64);
+    minidb::page_id_t big_ids[3];
+    for (int i = 0; i < 3; i++)
+    {
+        minidb::BasicPage<16384> *p16 = pool16.NewPage(&big_ids[i]);
+        memset(p16->GetData(), 'a' + i, 16384);
+        pool16.UnpinPage(big_ids[i], true);
+        minidb::page_id_t pid64;
+        minidb::BasicPage<65536> *p64 = pool64.NewPage(&pid64);
+        assert(pid64 == big_ids[i]);
+        memset(p64->GetData(), 'A' + i, 65536);
+        pool64.UnpinPage(pid64, true);
+    }
+    // Page 0 was evicted from both 2-frame pools, read it back
+    minidb::BasicPage<16384> *back16 = pool16.FetchPage(big_ids[0]);
+    assert(back16->GetData()[0] == 'a' && back16->GetData()[16383] == 'a');
+    pool16.UnpinPage(big_ids[0], false);
+    minidb::BasicPage<65536> *back64 = pool64.FetchPage(big_ids[0]);
+    assert(back64->GetData()[0] == 'A' && back64->GetData()[65535] == 'A');
+    pool64.UnpinPage(big_ids[0], false);
+    assert(dm64.GetPageSize() == 65536);
+    std::cout << "    ✓ 16 KiB and 64 KiB pools evict and reload full pages" << std::endl;
+
+    // Test 12: Batched fetch
+    std::cout << "  [4.12] FetchPages..." << std::endl;
+    std::remove("data/test_fetch_pages.db");
+    minidb::DiskManager batch_dm("data/test_fetch_pages.db");
+    char batch_buf[minidb::PAGE_SIZE] = {0};
+    for (int i = 0; i < 32; i++)
+    {
+        minidb::page_id_t pid = batch_dm.AllocatePage();
+        sprintf(batch_buf, "Batch page %lld", (long long)pid);
+        batch_dm.WritePage(pid, batch_buf);
+    }
+    minidb::buffer_pool batch_pool(8, &batch_dm);
+    minidb::Page *resident = batch_pool.FetchPage(5);
+    minidb::page_id_t batch_ids[] = {9, 5, 7, 6, 20, 8, 7};
+    minidb::Page *batch[7];
+    batch_pool.FetchPages(batch_ids, 7, batch);
+    for (int i = 0; i < 7; i++)
+    {
+        char expected[64];
+        sprintf(expected, "Batch page %lld", (long long)batch_ids[i]);
+        assert(strcmp(batch[i]->GetData(), expected) == 0);
+    }
+    assert(batch[1] == resident && resident->GetPinCount() == 2);
+    assert(batch[2] == batch[6] && batch[2]->GetPinCount() == 2);
+    for (int i = 0; i < 7; i++)
+    {
+        batch_pool.UnpinPage(batch_ids[i], false);
+    }
+    batch_pool.UnpinPage(5, false);
+
+    // 6 distinct pages are pinned, 3 more misses do not fit in 8 frames
+    batch_pool.FetchPages(batch_ids, 6, batch);
+    minidb::page_id_t too_many[] = {5, 1, 2, 3};
+    bool threw = false;
+    try
+    {
+        batch_pool.FetchPages(too_many, 4, batch);
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    assert(threw);
+    assert(batch_pool.FetchPage(5)->GetPinCount() == 2);
+    std::cout << "    ✓ hits, duplicates and coalesced misses pinned; failed batch released its pins" << std::endl;
+}
+void test_parallel_buffer_pool()
+{
+    std::cout << "\n[5/22] Testing ParallelBufferPool" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    std::remove("data/test_pbp.db");
+    minidb::DiskManager dm("data/test_pbp.db");
+    minidb::parallel_buffer_pool pool(16, 4, &dm);
+    assert(pool.GetNumShards() == 4);
+    assert(pool.GetPoolSize() == 16);
+
+    // Test 1: Pages are created across shards
+    std::cout << "  [5.1] New pages across shards..." << std::endl;
+    const int num_pages = 8;
+    minidb::page_id_t pids[num_pages];
+    for (int i = 0; i < num_pages; i++)
+    {
+        minidb::Page *page = pool.NewPage(&pids[i]);
+        sprintf(page->GetData(), "Shard page %d", i);
+        pool.UnpinPage(pids[i], true);
+    }
+    std::cout << "    ✓ Created " << num_pages << " pages" << std::endl;
+
+    // Test 2: Concurrent fetch/unpin of a cache-resident set
+    std::cout << "  [5.2] Concurrent fetch (8 threads)..." << std::endl;
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < 8; t++)
+    {
+        workers.emplace_back([&, t]()
+                             {
+            char expected[64];
+            for (int i = 0; i < 2000; i++)
+            {
+                int idx = (i * 7 + t) % num_pages;
+                minidb::Page *page = pool.FetchPage(pids[idx]);
+                sprintf(expected, "Shard page %d", idx);
+                if (strcmp(page->GetData(), expected) != 0)
+                {
+                    mismatches++;
+                }
+                pool.UnpinPage(pids[idx], false);
+            } });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+    assert(mismatches == 0);
+    std::cout << "    ✓ 16000 concurrent fetches returned correct data" << std::endl;
+
+    // Test 3: Pins balanced after concurrent use
+    std::cout << "  [5.3] Pin counts after concurrent use..." << std::endl;
+    for (int i = 0; i < num_pages; i++)
+    {
+        minidb::Page *page = pool.FetchPage(pids[i]);
+        assert(page->GetPinCount() == 1);
+        pool.UnpinPage(pids[i], false);
+    }
+    std::cout << "    ✓ All pin counts back to zero" << std::endl;
+
+    // Test 4: Dirty pages survive eviction through their shard
+    std::cout << "  [5.4] Eviction across shards..." << std::endl;
+    for (int i = 0; i < 32; i++)
+    {
+        minidb::page_id_t pid;
+        pool.NewPage(&pid);
+        pool.UnpinPage(pid, true);
+    }
+    minidb::Page *evicted = pool.FetchPage(pids[0]);
+    assert(strcmp(evicted->GetData(), "Shard page 0") == 0);
+    pool.UnpinPage(pids[0], false);
+    pool.FlushAllPages();
+    std::cout << "    ✓ Re-fetched evicted page: \"" << evicted->GetData() << "\"" << std::endl;
+
+    // Test 5: NewPage into a shard with every frame pinned frees the ID it took, so repeated
+    // failures keep reusing it instead of growing the file
+    std::cout << "  [5.5] NewPage with a full shard..." << std::endl;
+    std::vector<minidb::page_id_t> pinned;
+    int failures = 0;
+    minidb::page_id_t pages_before = 0;
+    while (failures < 5)
+    {
+        minidb::page_id_t pid;
+        try
+        {
+            pool.NewPage(&pid);
+            pinned.push_back(pid);
+        }
+        catch (const std::runtime_error &)
+        {
+            pages_before = failures == 0 ? dm.GetNumPages() : pages_before;
+            assert(dm.GetNumPages() == pages_before && dm.GetFreePages() == 1);
+            failures++;
+        }
+    }
+    for (minidb::page_id_t pid : pinned)
+    {
+        pool.UnpinPage(pid, false);
+    }
+    std::cout << "    ✓ " << failures << " failed NewPage calls after " << pinned.size()
+              << " pinned pages left the file at " << pages_before << " pages" << std::endl;
+}
+
+void test_replacer()
+{
+    std::cout << "\n[6/22] Testing Replacers" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    using minidb::ReplacerPolicy;
+    minidb::frame_id_t victim;
+
+    // Test 1: LRU evicts least recently unpinned/accessed frame
+    std::cout << "  [6.1] LRU order..." << std::endl;
+    auto lru = minidb::MakeReplacer(ReplacerPolicy::LRU, 4);
+    for (int f = 0; f < 3; f++)
+    {
+        lru->RecordAccess(f, f);
+        lru->SetEvictable(f, true);
+    }
+    lru->RecordAccess(0, 0);
+    assert(lru->Size() == 3);
+    assert(lru->Evict(&victim) && victim == 1);
+    assert(lru->Evict(&victim) && victim == 2);
+    assert(lru->Evict(&victim) && victim == 0);
+    assert(!lru->Evict(&victim));
+    std::cout << "    ✓ Evicted 1, 2, then re-used 0" << std::endl;
+
+    // Test 2: CLOCK gives referenced frames a second chance and skips pinned ones
+    std::cout << "  [6.2] CLOCK second chance..." << std::endl;
+    auto clock = minidb::MakeReplacer(ReplacerPolicy::CLOCK, 3);
+    for (int f = 0; f < 3; f++)
+    {
+        clock->RecordAccess(f, f);
+        clock->SetEvictable(f, true);
+    }
+    clock->SetEvictable(0, false);
+    assert(clock->Evict(&victim) && victim == 1);
+    clock->RecordAccess(1, 7);
+    clock->SetEvictable(1, true);
+    assert(clock->Evict(&victim) && victim == 2);
+    assert(clock->Size() == 1);
+    std::cout << "    ✓ Pinned frame skipped, bits cleared on sweep" << std::endl;
+
+    // Test 3: LRU-K keeps twice-accessed frames over a scan
+    std::cout << "  [6.3] LRU-K scan resistance..." << std::endl;
+    auto lru_k = minidb::MakeReplacer(ReplacerPolicy::LRU_K, 4);
+    lru_k->RecordAccess(0, 0);
+    lru_k->RecordAccess(0, 0);
+    for (int f = 1; f < 4; f++)
+    {
+        lru_k->RecordAccess(f, f);
+    }
+    for (int f = 0; f < 4; f++)
+    {
+        lru_k->SetEvictable(f, true);
+    }
+    assert(lru_k->Evict(&victim) && victim == 1);
+    assert(lru_k->Evict(&victim) && victim == 2);
+    assert(lru_k->Evict(&victim) && victim == 3);
+    assert(lru_k->Evict(&victim) && victim == 0);
+    std::cout << "    ✓ Hot frame evicted last" << std::endl;
+
+    // Test 4: ARC prefers T1 victims and learns from ghost hits
+    std::cout << "  [6.4] ARC recency/frequency..." << std::endl;
+    auto arc = minidb::MakeReplacer(ReplacerPolicy::ARC, 3);
+    arc->RecordAccess(0, 100);
+    arc->RecordAccess(0, 100);
+    arc->RecordAccess(1, 101);
+    arc->RecordAccess(2, 102);
+    for (int f = 0; f < 3; f++)
+    {
+        arc->SetEvictable(f, true);
+    }
+    assert(arc->Evict(&victim) && victim == 1);
+    arc->RecordAccess(1, 101); // Ghost hit in B1 goes straight to T2 and grows T1's target
+    arc->SetEvictable(1, true);
+    assert(arc->Evict(&victim) && victim == 0); // T1 is at target, so T2's LRU frame goes
+    assert(arc->Evict(&victim) && victim == 1);
+    assert(arc->Size() == 1);
+    std::cout << "    ✓ Once-seen page evicted first, ghost hit adapted target" << std::endl;
+
+    // Test 5: Every policy keeps the buffer pool correct under eviction
+    std::cout << "  [6.5] Buffer pool with each policy..." << std::endl;
+    for (ReplacerPolicy policy : {ReplacerPolicy::LRU, ReplacerPolicy::CLOCK, ReplacerPolicy::LRU_K, ReplacerPolicy::ARC})
+    {
+        std::remove("data/test_replacer.db");
+        minidb::DiskManager dm("data/test_replacer.db");
+        minidb::buffer_pool pool(3, &dm, policy);
+        minidb::page_id_t pids[8];
+        for (int i = 0; i < 8; i++)
+        {
+            minidb::Page *page = pool.NewPage(&pids[i]);
+            sprintf(page->GetData(), "Replacer page %d", i);
+            pool.UnpinPage(pids[i], true);
+        }
+        minidb::Page *pinned = pool.FetchPage(pids[7]);
+        for (int i = 0; i < 8; i++)
+        {
+            char expected[64];
+            sprintf(expected, "Replacer page %d", i);
+            minidb::Page *page = pool.FetchPage(pids[i]);
+            assert(strcmp(page->GetData(), expected) == 0);
+            pool.UnpinPage(pids[i], false);
+        }
+        assert(strcmp(pinned->GetData(), "Replacer page 7") == 0);
+        pool.UnpinPage(pids[7], false);
+        std::cout << "    ✓ " << minidb::ReplacerPolicyName(policy) << std::endl;
+    }
+}
+
+void test_async_disk_manager()
+{
+    std::cout << "\n[7/22] Testing AsyncDiskManager" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    for (minidb::IOEngineType type : {minidb::IOEngineType::AUTO, minidb::IOEngineType::THREAD_POOL})
+    {
+        std::remove("data/test_async.db");
+        minidb::AsyncDiskManager dm("data/test_async.db", 8, false, type);
+        std::cout << "  [7.1] Engine: " << dm.GetEngineName() << std::endl;
+
+        // Test 1: Batched writes, one submission
+        const int num_pages = 16;
+        std::vector<minidb::Page> frames(num_pages);
+        for (int i = 0; i < num_pages; i++)
+        {
+            dm.AllocatePage();
+            sprintf(frames[i].GetData(), "Async page %d", i);
+        }
+        std::vector<minidb::IOCompletion> completions;
+        int next = 0;
+        while (next < num_pages || dm.InFlight() > 0)
+        {
+            while (next < num_pages && dm.SubmitWrite(next, frames[next].GetData(), next))
+            {
+                next++;
+            }
+            dm.Submit();
+            dm.Complete(&completions, 1);
+        }
+        assert(completions.size() == num_pages);
+        for (const auto &completion : completions)
+        {
+            assert(completion.result == minidb::PAGE_SIZE);
+        }
+        std::cout << "    ✓ " << num_pages << " writes with queue depth " << dm.GetQueueDepth() << std::endl;
+
+        // Test 2: Batched reads come back tagged
+        char read_bufs[num_pages][minidb::PAGE_SIZE];
+        completions.clear();
+        next = 0;
+        while (next < num_pages || dm.InFlight() > 0)
+        {
+            while (next < num_pages && dm.SubmitRead(next, read_bufs[next], next))
+            {
+                next++;
+            }
+            dm.Submit();
+            dm.Complete(&completions, 1);
+        }
+        assert(completions.size() == num_pages);
+        for (const auto &completion : completions)
+        {
+            char expected[64];
+            sprintf(expected, "Async page %d", static_cast<int>(completion.user_data));
+            assert(strcmp(read_bufs[completion.user_data], expected) == 0);
+        }
+        std::cout << "    ✓ " << num_pages << " reads matched by user_data" << std::endl;
+    }
+
+    // Test 3: Registered buffer pool frames take the fixed-buffer path
+    std::cout << "  [7.2] Registered buffer pool frames..." << std::endl;
+    std::remove("data/test_async_fixed.db");
+    minidb::AsyncDiskManager dm("data/test_async_fixed.db", 4);
+    minidb::buffer_pool pool(4, &dm);
+    bool registered = dm.RegisterBuffers(pool.GetFrameBuffers());
+    minidb::page_id_t pid;
+    minidb::Page *page = pool.NewPage(&pid);
+    strcpy(page->GetData(), "Written from a registered frame");
+    std::vector<minidb::IOCompletion> completions;
+    assert(dm.SubmitWrite(pid, page->GetData(), 1));
+    dm.Submit();
+    dm.Complete(&completions, 1);
+    assert(completions[0].result == minidb::PAGE_SIZE);
+    pool.UnpinPage(pid, false);
+
+    char check[minidb::PAGE_SIZE];
+    dm.ReadPage(pid, check);
+    assert(strcmp(check, "Written from a registered frame") == 0);
+    std::cout << "    ✓ Frame write round-trip (registered=" << (registered ? "yes" : "no") << ")" << std::endl;
+}
+
+void test_checkpoint()
+{
+    std::cout << "\n[8/22] Testing Checkpoint and PageCleaner" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    std::remove("data/test_checkpoint.db");
+    minidb::DiskManager dm("data/test_checkpoint.db");
+    minidb::buffer_pool pool(16, &dm);
+
+    // Test 1: Adjacent dirty pages coalesce, clean pages are skipped
+    std::cout << "  [8.1] Coalesced checkpoint..." << std::endl;
+    minidb::page_id_t pids[10];
+    for (int i = 0; i < 10; i++)
+    {
+        minidb::Page *page = pool.NewPage(&pids[i]);
+        sprintf(page->GetData(), "Checkpoint page %d", i);
+        pool.UnpinPage(pids[i], i != 5); // page 5 stays clean
+    }
+    minidb::WriteBackResult result = pool.Checkpoint();
+    assert(result.pages_written == 9);
+    assert(result.write_calls == 2); // [0, 4] and [6, 9]
+    assert(result.syncs == 1);
+    std::cout << "    ✓ 9 dirty pages in " << result.write_calls << " writes, 1 fdatasync" << std::endl;
+
+    char check[minidb::PAGE_SIZE];
+    dm.ReadPage(pids[7], check);
+    assert(strcmp(check, "Checkpoint page 7") == 0);
+    result = pool.Checkpoint();
+    assert(result.pages_written == 0 && result.syncs == 0);
+    std::cout << "    ✓ Second checkpoint writes nothing" << std::endl;
+
+    // Test 2: Batching and rate limiting options
+    std::cout << "  [8.2] Batched, rate limited checkpoint..." << std::endl;
+    for (int i = 0; i < 10; i++)
+    {
+        pool.FetchPage(pids[i]);
+        pool.UnpinPage(pids[i], true);
+    }
+    minidb::CheckpointOptions options;
+    options.max_pages_per_write = 4;
+    options.pages_per_sync = 4;
+    options.max_bytes_per_sec = 1 << 30;
+    result = pool.Checkpoint(options);
+    assert(result.pages_written == 10);
+    assert(result.write_calls == 3);
+    assert(result.syncs == 3);
+    std::cout << "    ✓ 10 pages in " << result.write_calls << " writes, " << result.syncs << " syncs" << std::endl;
+
+    // Test 3: Background cleaner writes replacement candidates
+    std::cout << "  [8.3] Background cleaner..." << std::endl;
+    for (int i = 0; i < 10; i++)
+    {
+        minidb::Page *page = pool.FetchPage(pids[i]);
+        sprintf(page->GetData(), "Cleaned page %d", i);
+        pool.UnpinPage(pids[i], true);
+    }
+    minidb::CleanerOptions cleaner_options;
+    cleaner_options.clean_fraction = 1.0;
+    cleaner_options.interval = std::chrono::milliseconds(5);
+    {
+        minidb::PageCleaner cleaner(&pool, cleaner_options);
+        for (int wait = 0; wait < 200 && cleaner.GetPagesCleaned() < 10; wait++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        assert(cleaner.GetPagesCleaned() >= 10);
+    }
+    for (int i = 0; i < 10; i++)
+    {
+        minidb::Page *page = pool.FetchPage(pids[i]);
+        assert(!page->IsDirty());
+        pool.UnpinPage(pids[i], false);
+    }
+    dm.ReadPage(pids[3], check);
+    assert(strcmp(check, "Cleaned page 3") == 0);
+    std::cout << "    ✓ Cleaner wrote all dirty candidates" << std::endl;
+}
+
+void test_read_ahead()
+{
+    std::cout << "\n[9/22] Testing Prefetch and Read-Ahead" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    std::remove("data/test_read_ahead.db");
+    minidb::DiskManager dm("data/test_read_ahead.db");
+    char write_buf[minidb::PAGE_SIZE] = {0};
+    const int num_pages = 64;
+    for (int i = 0; i < num_pages; i++)
+    {
+        minidb::page_id_t pid = dm.AllocatePage();
+        sprintf(write_buf, "Scan page %lld", (long long)pid);
+        dm.WritePage(pid, write_buf);
+    }
+
+    // Test 1: Explicit prefetch loads pages unpinned
+    std::cout << "  [9.1] Prefetch hint..." << std::endl;
+    minidb::buffer_pool pool(16, &dm);
+    pool.Prefetch(0, 8);
+    pool.WaitForPrefetch();
+    minidb::ReadAheadStats stats = pool.GetReadAheadStats();
+    assert(stats.pages_prefetched == 8);
+    minidb::Page *page = pool.FetchPage(3);
+    assert(strcmp(page->GetData(), "Scan page 3") == 0);
+    assert(page->GetPinCount() == 1);
+    pool.UnpinPage(3, false);
+    assert(pool.GetReadAheadStats().prefetch_hits == 1);
+    std::cout << "    ✓ 8 pages prefetched, fetch of page 3 hit" << std::endl;
+
+    // Test 2: Unused prefetched pages are counted as waste when evicted
+    std::cout << "  [9.2] Readahead waste..." << std::endl;
+    pool.Prefetch(40, 16);
+    pool.WaitForPrefetch();
+    stats = pool.GetReadAheadStats();
+    assert(stats.prefetch_wasted >= 7);
+    std::cout << "    ✓ " << stats.prefetch_wasted << " unused prefetched pages evicted" << std::endl;
+
+    // Test 3: Sequential scan triggers growing read-ahead windows
+    std::cout << "  [9.3] Sequential read-ahead..." << std::endl;
+    minidb::buffer_pool scan_pool(32, &dm);
+    minidb::ReadAheadOptions options;
+    options.enabled = true;
+    options.initial_window = 2;
+    options.max_window = 8;
+    scan_pool.SetReadAhead(options);
+    for (int i = 0; i < num_pages; i++)
+    {
+        char expected[64];
+        sprintf(expected, "Scan page %d", i);
+        minidb::Page *scan = scan_pool.FetchPage(i);
+        assert(strcmp(scan->GetData(), expected) == 0);
+        scan_pool.UnpinPage(i, false);
+        scan_pool.WaitForPrefetch();
+    }
+    stats = scan_pool.GetReadAheadStats();
+    assert(stats.windows_issued >= 4);
+    assert(stats.prefetch_hits > num_pages / 2);
+    std::cout << "    ✓ " << stats.windows_issued << " windows, " << stats.prefetch_hits << "/" << num_pages
+              << " fetches served by read-ahead" << std::endl;
+
+    // Test 4: Prefetch never writes a dirty victim, it only takes free frames and clean pages
+    std::cout << "  [9.4] Prefetch into a dirty pool..." << std::endl;
+    minidb::buffer_pool dirty_pool(4, &dm);
+    for (minidb::page_id_t pid = 0; pid < 4; pid++)
+    {
+        dirty_pool.FetchPage(pid);
+        dirty_pool.UnpinPage(pid, true);
+    }
+    uint64_t writes_before = dm.GetStats().writes;
+    dirty_pool.Prefetch(20, 8);
+    dirty_pool.WaitForPrefetch();
+    assert(dirty_pool.GetReadAheadStats().pages_prefetched == 0 && dm.GetStats().writes == writes_before);
+    for (minidb::page_id_t pid = 0; pid < 4; pid++)
+    {
+        assert(dirty_pool.IsResident(pid));
+    }
+    dirty_pool.FlushPage(1);
+    dirty_pool.Prefetch(20, 8);
+    dirty_pool.WaitForPrefetch();
+    assert(dirty_pool.GetReadAheadStats().pages_prefetched > 0 && !dirty_pool.IsResident(1));
+    assert(dirty_pool.IsResident(0) && dirty_pool.IsResident(2) && dirty_pool.IsResident(3));
+    assert(dm.GetStats().writes == writes_before + 1);
+    std::cout << "    ✓ Dirty frames kept, only the flushed page's frame reused" << std::endl;
+}
+
+void test_access_strategy()
+{
+    std::cout << "\n[10/22] Testing Buffer Access Strategies" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    std::remove("data/test_access_strategy.db");
+    minidb::DiskManager dm("data/test_access_strategy.db");
+    char write_buf[minidb::PAGE_SIZE] = {0};
+    const int num_pages = 256;
+    for (int i = 0; i < num_pages; i++)
+    {
+        minidb::page_id_t pid = dm.AllocatePage();
+        sprintf(write_buf, "Strategy page %lld", (long long)pid);
+        dm.WritePage(pid, write_buf);
+    }
+
+    // Test 1: A bulk-read scan stays in its ring and leaves the hot set alone
+    std::cout << "  [10.1] Bulk-read ring..." << std::endl;
+    minidb::buffer_pool pool(64, &dm);
+    const int hot_pages = 32;
+    for (int i = 0; i < hot_pages; i++)
+    {
+        pool.FetchPage(i);
+        pool.UnpinPage(i, false);
+    }
+    minidb::BufferAccessStrategy scan(minidb::AccessType::BULK_READ);
+    for (int i = hot_pages; i < num_pages; i++)
+    {
+        char expected[64];
+        sprintf(expected, "Strategy page %d", i);
+        minidb::Page *page = pool.FetchPage(i, &scan);
+        assert(strcmp(page->GetData(), expected) == 0);
+        pool.UnpinPage(i, false);
+    }
+    for (int i = 0; i < hot_pages; i++)
+    {
+        assert(pool.IsResident(i));
+    }
+    int scan_resident = 0;
+    for (int i = hot_pages; i < num_pages; i++)
+    {
+        scan_resident += pool.IsResident(i) ? 1 : 0;
+    }
+    // 64 frames: 32 hot, ring capped at 64 / 8
+    assert(scan_resident == 8);
+    std::cout << "    ✓ hot set resident, scan confined to " << scan_resident << " frames" << std::endl;
+
+    // Test 2: Without a strategy the same scan evicts the hot set
+    std::cout << "  [10.2] Scan without strategy..." << std::endl;
+    minidb::buffer_pool plain(64, &dm);
+    for (int i = 0; i < hot_pages; i++)
+    {
+        plain.FetchPage(i);
+        plain.UnpinPage(i, false);
+    }
+    for (int i = hot_pages; i < num_pages; i++)
+    {
+        plain.FetchPage(i);
+        plain.UnpinPage(i, false);
+    }
+    int hot_resident = 0;
+    for (int i = 0; i < hot_pages; i++)
+    {
+        hot_resident += plain.IsResident(i) ? 1 : 0;
+    }
+    assert(hot_resident == 0);
+    std::cout << "    ✓ hot set flushed by plain scan" << std::endl;
+
+    // Test 3: A normal access takes a ring frame into the shared pool
+    std::cout << "  [10.3] Normal access leaves the ring..." << std::endl;
+    minidb::page_id_t last = num_pages - 1;
+    assert(pool.IsResident(last));
+    pool.FetchPage(last);
+    pool.UnpinPage(last, false);
+    for (int i = hot_pages; i < hot_pages + 16; i++)
+    {
+        pool.FetchPage(i, &scan);
+        pool.UnpinPage(i, false);
+    }
+    assert(pool.IsResident(last));
+    std::cout << "    ✓ page " << last << " survived the next ring cycle" << std::endl;
+
+    // Test 4: A bulk-write ring writes its dirty frames back when recycling them
+    std::cout << "  [10.4] Bulk-write ring..." << std::endl;
+    minidb::buffer_pool load_pool(64, &dm);
+    minidb::BufferAccessStrategy load(minidb::AccessType::BULK_WRITE);
+    std::vector<minidb::page_id_t> loaded;
+    for (int i = 0; i < 40; i++)
+    {
+        minidb::page_id_t pid;
+        minidb::Page *page = load_pool.NewPage(&pid, &load);
+        sprintf(page->GetData(), "Loaded page %lld", (long long)pid);
+        load_pool.UnpinPage(pid, true);
+        loaded.push_back(pid);
+    }
+    assert(load_pool.IsResident(loaded.back()));
+    assert(!load_pool.IsResident(loaded.front()));
+    char read_buf[minidb::PAGE_SIZE];
+    char expected[64];
+    dm.ReadPage(loaded.front(), read_buf);
+    sprintf(expected, "Loaded page %lld", (long long)loaded.front());
+    assert(strcmp(read_buf, expected) == 0);
+    std::cout << "    ✓ 40 pages loaded through an 8-frame ring, recycled pages on disk" << std::endl;
+}
+
+void test_wal()
+{
+    std::cout << "\n[11/22] Testing Write-Ahead Log and Recovery" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    // Test 1: Records round-trip, reopen drops a torn tail
+    std::cout << "  [11.1] Log records and torn tail..." << std::endl;
+    std::remove("data/test_wal.log");
+    minidb::lsn_t end_lsn;
+    minidb::lsn_t update_lsn;
+    {
+        minidb::LogManager log("data/test_wal.log");
+        minidb::LogRecord begin;
+        begin.type = minidb::LogRecordType::BEGIN;
+        begin.txn_id = 7;
+        log.Append(&begin);
+        assert(begin.lsn == log.GetFirstLSN());
+
+        minidb::LogRecord update;
+        update.type = minidb::LogRecordType::UPDATE;
+        update.txn_id = 7;
+        update.prev_lsn = begin.lsn;
+        update.page_id = 3;
+        update.offset = 16;
+        update.before_image.assign(4, 'a');
+        update.after_image.assign(4, 'b');
+        update_lsn = log.Append(&update);
+
+        minidb::LogRecord read_back;
+        assert(log.ReadRecord(update_lsn, &read_back));
+        assert(read_back.prev_lsn == begin.lsn && read_back.page_id == 3 && read_back.after_image == update.after_image);
+        log.FlushAll();
+        assert(log.GetPersistentLSN() == log.GetNextLSN());
+        end_lsn = log.GetNextLSN();
+    }
+    FILE *torn = fopen("data/test_wal.log", "ab");
+    assert(torn != nullptr);
+    char garbage[100];
+    memset(garbage, 0xAB, sizeof(garbage));
+    fwrite(garbage, 1, sizeof(garbage), torn);
+    fclose(torn);
+    {
+        minidb::LogManager reopened("data/test_wal.log");
+        assert(reopened.GetNextLSN() == end_lsn);
+        minidb::LogRecord read_back;
+        assert(reopened.ReadRecord(update_lsn, &read_back));
+        assert(read_back.type == minidb::LogRecordType::UPDATE && read_back.before_image.size() == 4);
+        assert(!reopened.ReadRecord(update_lsn + 1, &read_back));
+    }
+    std::cout << "    ✓ records read back, 100 garbage bytes dropped on reopen" << std::endl;
+
+    // Test 2: Concurrent commits share syncs
+    std::cout << "  [11.2] Group commit..." << std::endl;
+    std::remove("data/test_wal.log");
+    {
+        minidb::LogOptions options;
+        options.group_commit_delay = std::chrono::microseconds(1000);
+        minidb::LogManager log("data/test_wal.log", options);
+        const int committers = 8;
+        const int commits_each = 25;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < committers; t++)
+        {
+            threads.emplace_back([&log, t]()
+                                 {
+                for (int i = 0; i < commits_each; i++)
+                {
+                    minidb::LogRecord commit;
+                    commit.type = minidb::LogRecordType::COMMIT;
+                    commit.txn_id = t * commits_each + i;
+                    minidb::lsn_t lsn = log.Append(&commit);
+                    log.Flush(lsn);
+                    assert(log.GetPersistentLSN() > lsn);
+                } });
+        }
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+        minidb::LogStats stats = log.GetStats();
+        assert(stats.records == static_cast<size_t>(committers * commits_each));
+        assert(stats.syncs < stats.records);
+        std::cout << "    ✓ " << stats.records << " commits in " << stats.syncs << " syncs" << std::endl;
+    }
+
+    // Test 3: Evicting a dirty page flushes the log up to its LSN first
+    std::cout << "  [11.3] Write-ahead rule on eviction..." << std::endl;
+    std::remove("data/test_wal.db");
+    std::remove("data/test_wal.log");
+    {
+        minidb::DiskManager dm("data/test_wal.db");
+        minidb::buffer_pool pool(2, &dm);
+        minidb::LogManager log("data/test_wal.log");
+        minidb::TransactionManager txns(&pool, &log);
+
+        minidb::Transaction txn = txns.Begin();
+        minidb::page_id_t pid;
+        minidb::Page *page = pool.NewPage(&pid);
+        txns.Update(&txn, page, minidb::Page::HEADER_SIZE, "logged", 7);
+        minidb::lsn_t page_lsn = page->GetLSN();
+        assert(page_lsn == txn.prev_lsn);
+        pool.UnpinPage(pid, true);
+        assert(log.GetPersistentLSN() <= page_lsn);
+
+        for (int i = 0; i < 2; i++)
+        {
+            minidb::page_id_t other;
+            pool.NewPage(&other);
+            pool.UnpinPage(other, false);
+        }
+        assert(!pool.IsResident(pid));
+        assert(log.GetPersistentLSN() > page_lsn);
+
+        bool rejected = false;
+        try
+        {
+            page = pool.FetchPage(pid);
+            txns.Update(&txn, page, 0, "x", 1);
+        }
+        catch (const std::out_of_range &)
+        {
+            rejected = true;
+        }
+        pool.UnpinPage(pid, false);
+        assert(rejected);
+        std::cout << "    ✓ log durable past page LSN " << page_lsn << " before the page was written" << std::endl;
+
+        // Test 4: Abort restores before images through compensation records
+        std::cout << "  [11.4] Abort..." << std::endl;
+        page = pool.FetchPage(pid);
+        txns.Update(&txn, page, minidb::Page::HEADER_SIZE, "change", 7);
+        txns.Update(&txn, page, minidb::Page::HEADER_SIZE + 100, "more", 5);
+        pool.UnpinPage(pid, true);
+        txns.Abort(&txn);
+        assert(txn.state == minidb::TransactionState::ABORTED);
+        page = pool.FetchPage(pid);
+        assert(page->GetData()[minidb::Page::HEADER_SIZE] == '\0' && page->GetData()[minidb::Page::HEADER_SIZE + 100] == '\0');
+        minidb::LogRecord clr;
+        assert(log.ReadRecord(page->GetLSN(), &clr) && clr.type == minidb::LogRecordType::CLR);
+        pool.UnpinPage(pid, false);
+        std::cout << "    ✓ all three updates undone, page LSN points at a CLR" << std::endl;
+    }
+
+    // Test 5: Crash with a committed change only in memory and a loser's change on disk
+    std::cout << "  [11.5] Crash recovery..." << std::endl;
+    std::remove("data/test_wal.db");
+    std::remove("data/test_wal.log");
+    minidb::page_id_t committed_pid;
+    minidb::page_id_t stolen_pid;
+    {
+        minidb::DiskManager dm("data/test_wal.db");
+        minidb::buffer_pool pool(4, &dm);
+        minidb::LogManager log("data/test_wal.log");
+        minidb::TransactionManager txns(&pool, &log);
+
+        minidb::Page *committed = pool.NewPage(&committed_pid);
+        minidb::Page *stolen = pool.NewPage(&stolen_pid);
+
+        minidb::Transaction winner = txns.Begin();
+        txns.Update(&winner, committed, 8, "committed", 10);
+        txns.Commit(&winner);
+        assert(winner.state == minidb::TransactionState::COMMITTED);
+
+        minidb::Transaction loser = txns.Begin();
+        txns.Update(&loser, stolen, 8, "loser", 6);
+        txns.Update(&loser, committed, 64, "loser too", 10);
+        pool.UnpinPage(committed_pid, true);
+        pool.UnpinPage(stolen_pid, true);
+        pool.FlushPage(stolen_pid);
+        // Crash: the pool is dropped without writing the committed page
+    }
+    {
+        minidb::DiskManager dm("data/test_wal.db");
+        char raw[minidb::PAGE_SIZE];
+        dm.ReadPage(committed_pid, raw);
+        assert(raw[8] == '\0');
+        dm.ReadPage(stolen_pid, raw);
+        assert(strcmp(raw + 8, "loser") == 0);
+
+        minidb::buffer_pool pool(4, &dm);
+        minidb::LogManager log("data/test_wal.log");
+        minidb::LogRecovery recovery(&dm, &pool, &log);
+        minidb::RecoveryStats stats = recovery.Recover();
+        assert(stats.losers == 1 && stats.undone == 2 && stats.next_txn_id == 2);
+
+        minidb::Page *page = pool.FetchPage(committed_pid);
+        assert(strcmp(page->GetData() + 8, "committed") == 0);
+        assert(page->GetData()[64] == '\0');
+        pool.UnpinPage(committed_pid, false);
+        page = pool.FetchPage(stolen_pid);
+        assert(page->GetData()[8] == '\0');
+        pool.UnpinPage(stolen_pid, false);
+        std::cout << "    ✓ " << stats.records << " records, " << stats.redone << " redone, " << stats.undone
+                  << " undone for " << stats.losers << " loser" << std::endl;
+
+        // Recovery is repeatable: the loser is now aborted and every page is current
+        pool.FlushAllPages();
+        minidb::LogRecovery again(&dm, &pool, &log);
+        minidb::RecoveryStats second = again.Recover();
+        assert(second.losers == 0 && second.redone == 0 && second.undone == 0);
+        std::cout << "    ✓ second pass finds nothing to do" << std::endl;
+    }
+    std::remove("data/test_wal.db");
+    std::remove("data/test_wal.log");
+}
+
+void test_table_heap()
+{
+    std::cout << "\n[12/22] Testing TablePage and TableHeap" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    // Test 1: Slotted page fills up, reuses slots and compacts holes
+    std::cout << "  [12.1] Slotted page..." << std::endl;
+    minidb::Page raw;
+    minidb::TablePage table_page(raw.GetData());
+    table_page.Init();
+    char tuple[200];
+    std::vector<uint32_t> slots;
+    for (int i = 0;; i++)
+    {
+        memset(tuple, 'a' + i % 26, 100);
+        uint32_t slot;
+        if (!table_page.Insert(tuple, 100, &slot))
+        {
+            break;
+        }
+        assert(slot == slots.size());
+        slots.push_back(slot);
+    }
+    const size_t per_page = (minidb::PAGE_SIZE - minidb::TablePage::HEADER_SIZE) / (100 + minidb::TablePage::SLOT_SIZE);
+    assert(slots.size() == per_page);
+
+    for (size_t i = 0; i < slots.size(); i += 2)
+    {
+        assert(table_page.Delete(slots[i]));
+    }
+    assert(!table_page.Delete(slots[0]));
+    minidb::TupleView view;
+    assert(!table_page.Get(slots[0], &view));
+
+    // 150 bytes only fit once the 100-byte holes are merged
+    memset(tuple, 'Z', 150);
+    uint32_t big_slot;
+    assert(table_page.Insert(tuple, 150, &big_slot) && big_slot == 0);
+    assert(table_page.Get(big_slot, &view) && view.size == 150 && view.data[149] == 'Z');
+    for (size_t i = 1; i < slots.size(); i += 2)
+    {
+        assert(table_page.Get(slots[i], &view) && view.size == 100 && view.data[0] == 'a' + static_cast<char>(i % 26));
+    }
+
+    // Grow one tuple in place past its old size, shrink another
+    memset(tuple, 'G', 180);
+    assert(table_page.Update(slots[1], tuple, 180));
+    assert(table_page.Get(slots[1], &view) && view.size == 180 && view.data[179] == 'G');
+    assert(table_page.Update(slots[3], "short", 6));
+    assert(table_page.Get(slots[3], &view) && strcmp(view.data, "short") == 0);
+    assert(!table_page.Update(slots[2], "free slot", 10));
+    std::cout << "    ✓ " << per_page << " tuples per page, holes compacted, slots stable" << std::endl;
+
+    // Test 2: Heap across pages: insert, get, update, delete, reopen
+    std::cout << "  [12.2] Table heap..." << std::endl;
+    std::remove("data/test_table_heap.db");
+    minidb::DiskManager dm("data/test_table_heap.db");
+    minidb::buffer_pool pool(8, &dm);
+    minidb::TableHeap heap(&pool);
+    const int num_tuples = 1000;
+    std::vector<minidb::RID> rids;
+    for (int i = 0; i < num_tuples; i++)
+    {
+        int size = sprintf(tuple, "Tuple %d", i);
+        rids.push_back(heap.Insert(tuple, size + 1));
+    }
+    assert(rids.back().page_id != rids.front().page_id);
+    std::string out;
+    assert(heap.Get(rids[500], &out) && strcmp(out.c_str(), "Tuple 500") == 0);
+    assert(heap.Update(rids[500], "Tuple five hundred", 19));
+    assert(heap.Get(rids[500], &out) && strcmp(out.c_str(), "Tuple five hundred") == 0);
+    for (int i = 0; i < num_tuples; i += 3)
+    {
+        assert(heap.Delete(rids[i]));
+    }
+    assert(!heap.Get(rids[0], &out));
+
+    bool rejected = false;
+    try
+    {
+        std::string huge(minidb::TablePage::MAX_TUPLE_SIZE + 1, 'x');
+        heap.Insert(huge.data(), static_cast<uint32_t>(huge.size()));
+    }
+    catch (const std::out_of_range &)
+    {
+        rejected = true;
+    }
+    assert(rejected);
+    minidb::RID appended = heap.Insert("appended", 9);
+    std::cout << "    ✓ " << num_tuples << " tuples over " << rids.back().page_id - rids.front().page_id + 1
+              << " pages, updates in place, deletes leave RIDs stable" << std::endl;
+
+    // Test 3: Scan yields live tuples in order, views point into pool frames
+    std::cout << "  [12.3] Zero-copy scan..." << std::endl;
+    std::vector<iovec> frames = pool.GetFrameBuffers();
+    auto in_frame = [&frames](const char *p)
+    {
+        for (const iovec &frame : frames)
+        {
+            const char *base = static_cast<const char *>(frame.iov_base);
+            if (p >= base && p < base + frame.iov_len)
+            {
+                return true;
+            }
+        }
+        return false;
+    };
+    std::vector<minidb::RID> expected_rids;
+    for (int i = 0; i < num_tuples; i++)
+    {
+        if (i % 3 != 0)
+        {
+            expected_rids.push_back(rids[i]);
+        }
+    }
+    expected_rids.push_back(appended);
+    auto rid_less = [](const minidb::RID &a, const minidb::RID &b)
+    {
+        return a.page_id < b.page_id || (a.page_id == b.page_id && a.slot < b.slot);
+    };
+    std::sort(expected_rids.begin(), expected_rids.end(), rid_less);
+
+    std::vector<minidb::RID> scanned;
+    for (auto it = heap.Begin(); it.Valid(); it.Next())
+    {
+        minidb::TupleView tuple_view = it.GetTuple();
+        assert(in_frame(tuple_view.data));
+        std::string copy;
+        assert(heap.Get(it.GetRID(), &copy) && copy == std::string(tuple_view.data, tuple_view.size));
+        scanned.push_back(it.GetRID());
+    }
+    assert(scanned == expected_rids);
+    int seen = static_cast<int>(scanned.size());
+
+    // Reopening by first page finds the same tuples, and the scan left nothing pinned
+    minidb::TableHeap reopened(&pool, heap.GetFirstPageId());
+    minidb::BufferAccessStrategy bulk(minidb::AccessType::BULK_READ);
+    int reseen = 0;
+    for (auto it = reopened.Begin(&bulk); it.Valid(); it.Next())
+    {
+        reseen++;
+    }
+    assert(reseen == seen);
+    minidb::RID after_reopen = reopened.Insert("after reopen", 13);
+    assert(after_reopen.page_id == appended.page_id);
+    pool.FlushAllPages();
+    std::cout << "    ✓ " << seen << " live tuples scanned without copies, heap reopened" << std::endl;
+    std::remove("data/test_table_heap.db");
+}
+
+void test_b_plus_tree()
+{
+    std::cout << "\n[13/22] Testing BPlusTree" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    // Test 1: Shuffled inserts through a pool far smaller than the tree, lookups and range scan
+    std::cout << "  [13.1] Insert, lookup and range scan..." << std::endl;
+    std::remove("data/test_b_plus_tree.db");
+    minidb::DiskManager dm("data/test_b_plus_tree.db");
+    minidb::buffer_pool pool(32, &dm);
+    minidb::BPlusTree<int64_t, minidb::Int64Comparator> tree(&pool);
+    const int num_keys = 10000;
+    std::vector<int64_t> keys(num_keys);
+    for (int i = 0; i < num_keys; i++)
+    {
+        keys[i] = i;
+    }
+    std::mt19937 rng(42);
+    std::shuffle(keys.begin(), keys.end(), rng);
+    for (int64_t key : keys)
+    {
+        minidb::RID rid{key / 100, static_cast<uint32_t>(key % 100)};
+        assert(tree.Insert(key, rid));
+    }
+    assert(!tree.Insert(1234, minidb::RID{0, 0}));
+    for (int64_t key = 0; key < num_keys; key++)
+    {
+        minidb::RID rid;
+        assert(tree.GetValue(key, &rid));
+        assert(rid.page_id == key / 100 && rid.slot == key % 100);
+    }
+    minidb::RID missing;
+    assert(!tree.GetValue(-1, &missing) && !tree.GetValue(num_keys, &missing));
+    int height = tree.GetHeight();
+    assert(height > 1);
+
+    int64_t expected = 5000;
+    for (auto it = tree.Begin(5000); it.Valid(); it.Next())
+    {
+        assert(it.GetKey() == expected && it.GetValue().page_id == expected / 100);
+        expected++;
+    }
+    assert(expected == num_keys);
+    std::cout << "    ✓ " << num_keys << " keys in " << height << " levels, " << dm.GetNumPages()
+              << " pages through 32 frames" << std::endl;
+
+    // Test 2: Deletes merge and redistribute nodes, freed pages are reused
+    std::cout << "  [13.2] Remove with merge and redistribute..." << std::endl;
+    std::vector<int64_t> evens;
+    for (int64_t key = 0; key < num_keys; key += 2)
+    {
+        evens.push_back(key);
+    }
+    std::shuffle(evens.begin(), evens.end(), rng);
+    for (int64_t key : evens)
+    {
+        assert(tree.Remove(key));
+    }
+    assert(!tree.Remove(0));
+    int survivors = 0;
+    for (auto it = tree.Begin(); it.Valid(); it.Next())
+    {
+        assert(it.GetKey() == 2 * survivors + 1);
+        survivors++;
+    }
+    assert(survivors == num_keys / 2);
+    for (int64_t key = 1; key < num_keys; key += 2)
+    {
+        assert(tree.Remove(key));
+    }
+    assert(!tree.Begin().Valid() && tree.GetHeight() == 1);
+    minidb::page_id_t freed = dm.GetFreePages();
+    assert(freed > 0);
+    for (int64_t key : keys)
+    {
+        assert(tree.Insert(key, minidb::RID{key, 0}));
+    }
+    assert(dm.GetFreePages() < freed);
+    std::cout << "    ✓ Tree emptied back to one leaf, freed pages reused on refill" << std::endl;
+
+    // Test 3: Variable-length keys in fixed slots, reopened by header page
+    std::cout << "  [13.3] String keys and reopen..." << std::endl;
+    using Key = minidb::GenericKey<32>;
+    minidb::page_id_t header_page_id;
+    {
+        minidb::BPlusTree<Key, minidb::GenericComparator<32>> names(&pool);
+        header_page_id = names.GetHeaderPageId();
+        char name[32];
+        for (int i = 0; i < 2000; i++)
+        {
+            sprintf(name, "user-%d", i);
+            assert(names.Insert(Key::FromString(name), minidb::RID{i, 0}));
+        }
+    }
+    minidb::BPlusTree<Key, minidb::GenericComparator<32>> names(&pool, header_page_id);
+    minidb::RID rid;
+    assert(names.GetValue(Key::FromString("user-1999"), &rid) && rid.page_id == 1999);
+    assert(!names.GetValue(Key::FromString("user-2000"), &rid));
+    std::string previous;
+    int scanned = 0;
+    for (auto it = names.Begin(Key::FromString("user-1")); it.Valid(); it.Next())
+    {
+        std::string name = it.GetKey().ToString();
+        assert(name > previous);
+        previous = name;
+        scanned++;
+    }
+    assert(scanned == 2000 - 1);
+
+    // Keys are exact: trailing zeros count, a prefix orders first, oversize keys are refused
+    Key plain = Key::FromString("user-7");
+    Key zeroed = Key::FromString(std::string("user-7\0", 7));
+    minidb::GenericComparator<32> compare;
+    assert(compare(plain, zeroed) < 0 && compare(zeroed, Key::FromString("user-70")) < 0);
+    assert(names.Insert(zeroed, minidb::RID{-7, 0}) && names.GetValue(plain, &rid) && rid.page_id == 7);
+    assert(zeroed.ToString().size() == 7 && names.GetValue(zeroed, &rid) && rid.page_id == -7);
+    bool refused = false;
+    try
+    {
+        Key::FromString(std::string(Key::MAX_LENGTH + 1, 'x'));
+    }
+    catch (const std::out_of_range &)
+    {
+        refused = true;
+    }
+    assert(refused && Key::FromString(std::string(Key::MAX_LENGTH, 'x')).GetLength() == Key::MAX_LENGTH);
+    pool.FlushAllPages();
+    std::cout << "    ✓ " << scanned << " string keys scanned in lexical order after reopen" << std::endl;
+
+    // Test 4: Internal nodes store the shared prefix once, so long keys that differ only in their
+    // tail keep a wide fanout. Fixed 64-byte slots would fit 59 children a node and need 3 levels
+    std::cout << "  [13.4] Prefix-compressed internal nodes..." << std::endl;
+    using LongKey = minidb::GenericKey<64>;
+    using LongTree = minidb::BPlusTree<LongKey, minidb::GenericComparator<64>>;
+    LongTree accounts(&pool);
+    std::vector<std::string> account_names;
+    for (int i = 0; i < 8000; i++)
+    {
+        char name[64];
+        sprintf(name, "tenant-0042/region-eu-west/customer-account-%06d", i);
+        account_names.push_back(name);
+    }
+    std::shuffle(account_names.begin(), account_names.end(), rng);
+    for (size_t i = 0; i < account_names.size(); i++)
+    {
+        assert(accounts.Insert(LongKey::FromString(account_names[i]), minidb::RID{static_cast<int64_t>(i), 0}));
+    }
+    assert(accounts.GetHeight() == 2);
+    for (size_t i = 0; i < account_names.size(); i++)
+    {
+        assert(accounts.GetValue(LongKey::FromString(account_names[i]), &rid) && rid.page_id == static_cast<int64_t>(i));
+    }
+
+    // Keys of random bytes and lengths share no prefix, so the tree gets deep and removing them
+    // merges and redistributes internal nodes whose entries differ in size
+    LongTree mixed(&pool);
+    std::map<std::string, int64_t> expected_keys;
+    while (expected_keys.size() < 6000)
+    {
+        std::string key(1 + rng() % LongKey::MAX_LENGTH, '\0');
+        for (char &byte : key)
+        {
+            byte = static_cast<char>(rng() % 4 == 0 ? 0 : rng());
+        }
+        int64_t value = static_cast<int64_t>(expected_keys.size());
+        if (expected_keys.emplace(key, value).second)
+        {
+            assert(mixed.Insert(LongKey::FromString(key), minidb::RID{value, 0}));
+        }
+    }
+    int mixed_height = mixed.GetHeight();
+    assert(mixed_height >= 3);
+    std::vector<std::string> removal;
+    auto expected_it = expected_keys.begin();
+    for (auto it = mixed.Begin(); it.Valid(); it.Next(), expected_it++)
+    {
+        assert(it.GetKey().ToString() == expected_it->first && it.GetValue().page_id == expected_it->second);
+        removal.push_back(expected_it->first);
+    }
+    assert(expected_it == expected_keys.end());
+    std::shuffle(removal.begin(), removal.end(), rng);
+    for (size_t i = 0; i < removal.size(); i++)
+    {
+        assert(mixed.Remove(LongKey::FromString(removal[i])));
+        if (i % 500 == 0)
+        {
+            for (size_t j = i + 1; j < removal.size(); j += 97)
+            {
+                assert(mixed.GetValue(LongKey::FromString(removal[j]), &rid));
+                assert(rid.page_id == expected_keys[removal[j]]);
+            }
+        }
+    }
+    assert(!mixed.Begin().Valid() && mixed.GetHeight() == 1);
+    std::cout << "    ✓ " << account_names.size() << " 50-byte keys in 2 levels, " << expected_keys.size()
+              << " random keys in " << mixed_height << " levels removed" << std::endl;
+    std::remove("data/test_b_plus_tree.db");
+}
+
+void test_page_guard()
+{
+    std::cout << "\n[14/22] Testing page latches and guards" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    std::remove("data/test_page_guard.db");
+    minidb::DiskManager dm("data/test_page_guard.db");
+    minidb::buffer_pool pool(8, &dm);
+
+    // Test 1: Guards unlatch and unpin on scope exit and when moved over
+    std::cout << "  [14.1] Read and write guards..." << std::endl;
+    minidb::page_id_t pid;
+    {
+        minidb::WritePageGuard guard = pool.NewPageGuarded(&pid);
+        strcpy(guard.GetData() + minidb::Page::HEADER_SIZE, "guarded");
+        assert(guard.GetPage()->GetLatch().GetVersion() % 2 == 1);
+    }
+    {
+        minidb::ReadPageGuard first = pool.FetchPageRead(pid);
+        minidb::ReadPageGuard second = pool.FetchPageRead(pid);
+        assert(strcmp(first.GetData() + minidb::Page::HEADER_SIZE, "guarded") == 0);
+        minidb::ReadPageGuard moved = std::move(first);
+        assert(!first.Valid() && moved.Valid() && moved.GetPageId() == pid);
+        second = std::move(moved);
+        assert(!moved.Valid());
+    }
+    minidb::Page *page = pool.FetchPage(pid);
+    assert(page->GetPinCount() == 1 && page->IsDirty());
+    pool.UnpinPage(pid, false);
+    std::cout << "    ✓ Shared guards coexist, moves transfer the pin, nothing left pinned" << std::endl;
+
+    // Test 2: Optimistic reads fail validation across a write, upgrades only if unchanged
+    std::cout << "  [14.2] Optimistic guard..." << std::endl;
+    {
+        minidb::OptimisticPageGuard reader = pool.FetchPageOptimistic(pid);
+        assert(reader.Validate());
+        {
+            minidb::WritePageGuard writer = pool.FetchPageWrite(pid);
+            writer.GetData()[minidb::Page::HEADER_SIZE] = 'G';
+        }
+        assert(!reader.Validate());
+        minidb::WritePageGuard upgraded;
+        assert(!reader.TryUpgrade(&upgraded) && !upgraded.Valid());
+        reader.Restart();
+        assert(reader.GetData()[minidb::Page::HEADER_SIZE] == 'G' && reader.Validate());
+        assert(reader.TryUpgrade(&upgraded) && upgraded.Valid() && !reader.Valid());
+        upgraded.GetData()[minidb::Page::HEADER_SIZE] = 'g';
+    }
+    page = pool.FetchPage(pid);
+    assert(page->GetPinCount() == 1 && page->GetLatch().GetVersion() == 6);
+    pool.UnpinPage(pid, false);
+    std::cout << "    ✓ Writes invalidate optimistic reads, upgrade checks the version" << std::endl;
+
+    // Test 3: Writers keep two counters equal; no validated or shared read sees them differ
+    std::cout << "  [14.3] Concurrent readers and writers..." << std::endl;
+    const int writes_per_thread = 2000;
+    const int reads_per_thread = 5000;
+    std::atomic<int> torn{0};
+    std::atomic<int> retries{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; t++)
+    {
+        threads.emplace_back([&]()
+                             {
+            for (int i = 0; i < writes_per_thread; i++)
+            {
+                minidb::WritePageGuard guard = pool.FetchPageWrite(pid);
+                int64_t counters[2];
+                memcpy(counters, guard.GetData() + 64, sizeof(counters));
+                counters[0]++;
+                memcpy(guard.GetData() + 64, &counters[0], sizeof(int64_t));
+                std::this_thread::yield();
+                counters[1]++;
+                memcpy(guard.GetData() + 64 + sizeof(int64_t), &counters[1], sizeof(int64_t));
+            } });
+    }
+    for (int t = 0; t < 2; t++)
+    {
+        threads.emplace_back([&, t]()
+                             {
+            for (int i = 0; i < reads_per_thread; i++)
+            {
+                int64_t counters[2];
+                if (t == 0)
+                {
+                    minidb::ReadPageGuard guard = pool.FetchPageRead(pid);
+                    memcpy(counters, guard.GetData() + 64, sizeof(counters));
+                }
+                else
+                {
+                    minidb::OptimisticPageGuard guard = pool.FetchPageOptimistic(pid);
+                    memcpy(counters, guard.GetData() + 64, sizeof(counters));
+                    while (!guard.Validate())
+                    {
+                        retries++;
+                        guard.Restart();
+                        memcpy(counters, guard.GetData() + 64, sizeof(counters));
+                    }
+                }
+                if (counters[0] != counters[1])
+                {
+                    torn++;
+                }
+            } });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    assert(torn == 0);
+    {
+        minidb::ReadPageGuard guard = pool.FetchPageRead(pid);
+        int64_t counters[2];
+        memcpy(counters, guard.GetData() + 64, sizeof(counters));
+        assert(counters[0] == 2 * writes_per_thread && counters[1] == 2 * writes_per_thread);
+    }
+    pool.FlushAllPages();
+    std::cout << "    ✓ " << 2 * writes_per_thread << " writes, " << 2 * reads_per_thread
+              << " reads never torn, " << retries << " optimistic retries" << std::endl;
+
+    // Test 4: FlushPage latches the page shared, so a half-done change is never written out, and
+    // waits without holding the pool latch
+    std::cout << "  [14.4] FlushPage waits for the writer..." << std::endl;
+    {
+        minidb::page_id_t other_pid;
+        pool.NewPageGuarded(&other_pid).Release();
+        minidb::WritePageGuard writer = pool.FetchPageWrite(pid);
+        memcpy(writer.GetData() + 256, "half", 4);
+        std::atomic<bool> flushed{false};
+        std::thread flusher([&]()
+                            {
+                                pool.FlushPage(pid);
+                                flushed = true;
+                            });
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        assert(!flushed);
+        minidb::Page *other = pool.FetchPage(other_pid);
+        pool.UnpinPage(other->GetPageId(), false);
+        memcpy(writer.GetData() + 260, "done", 4);
+        writer.Release();
+        flusher.join();
+
+        char on_disk[minidb::PAGE_SIZE];
+        dm.ReadPage(pid, on_disk);
+        assert(memcmp(on_disk + 256, "halfdone", 8) == 0);
+    }
+    std::cout << "    ✓ Flush waited for the write guard and wrote the whole change" << std::endl;
+    std::remove("data/test_page_guard.db");
+}
+
+void test_extendible_hash_table()
+{
+    std::cout << "\n[15/22] Testing ExtendibleHashTable" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    // Test 1: Buckets split and the directory doubles as keys arrive, through a small pool
+    std::cout << "  [15.1] Insert and lookup..." << std::endl;
+    std::remove("data/test_hash_table.db");
+    minidb::DiskManager dm("data/test_hash_table.db");
+    minidb::buffer_pool pool(16, &dm);
+    using HashTable = minidb::ExtendibleHashTable<int64_t, minidb::Int64Comparator, minidb::Int64Hash>;
+    HashTable table(&pool);
+    const int num_keys = 20000;
+    for (int64_t key = 0; key < num_keys; key++)
+    {
+        assert(table.Insert(key * 7, minidb::RID{key, static_cast<uint32_t>(key % 13)}));
+    }
+    assert(!table.Insert(7, minidb::RID{0, 0}));
+    for (int64_t key = 0; key < num_keys; key++)
+    {
+        minidb::RID rid;
+        assert(table.GetValue(key * 7, &rid) && rid.page_id == key && rid.slot == key % 13);
+        assert(!table.GetValue(key * 7 + 1, &rid));
+    }
+    size_t buckets = table.GetBucketCount();
+    assert(table.GetGlobalDepth() > 0 && buckets >= num_keys / HashTable::BUCKET_CAPACITY);
+    assert(buckets <= (size_t(1) << table.GetGlobalDepth()));
+    std::cout << "    ✓ " << num_keys << " keys in " << buckets << " buckets, global depth "
+              << table.GetGlobalDepth() << std::endl;
+
+    // Test 2: Reopen reads the directory back from its pages
+    std::cout << "  [15.2] Reopen..." << std::endl;
+    HashTable reopened(&pool, table.GetHeaderPageId());
+    assert(reopened.GetGlobalDepth() == table.GetGlobalDepth() && reopened.GetBucketCount() == buckets);
+    minidb::RID rid;
+    assert(reopened.GetValue(7 * 12345, &rid) && rid.page_id == 12345);
+    std::cout << "    ✓ Directory and buckets found from the header page" << std::endl;
+
+    // Test 3: Removing everything merges buckets and shrinks the directory back
+    std::cout << "  [15.3] Remove, merge and shrink..." << std::endl;
+    for (int64_t key = 0; key < num_keys; key += 2)
+    {
+        assert(table.Remove(key * 7));
+    }
+    assert(!table.Remove(0));
+    for (int64_t key = 0; key < num_keys; key++)
+    {
+        assert(table.GetValue(key * 7, &rid) == (key % 2 == 1));
+    }
+    for (int64_t key = 1; key < num_keys; key += 2)
+    {
+        assert(table.Remove(key * 7));
+    }
+    assert(table.GetGlobalDepth() == 0 && table.GetBucketCount() == 1);
+    assert(dm.GetFreePages() > 0);
+    assert(table.Insert(42, minidb::RID{42, 0}) && table.GetValue(42, &rid) && rid.page_id == 42);
+
+    // String keys share the same code path
+    minidb::ExtendibleHashTable<minidb::GenericKey<32>, minidb::GenericComparator<32>, minidb::GenericHash<32>>
+        names(&pool);
+    char name[32];
+    for (int i = 0; i < 3000; i++)
+    {
+        sprintf(name, "user-%d", i);
+        assert(names.Insert(minidb::GenericKey<32>::FromString(name), minidb::RID{i, 0}));
+    }
+    assert(names.GetValue(minidb::GenericKey<32>::FromString("user-2999"), &rid) && rid.page_id == 2999);
+    assert(!names.GetValue(minidb::GenericKey<32>::FromString("user-3000"), &rid));
+    pool.FlushAllPages();
+    std::cout << "    ✓ Emptied back to one bucket at depth 0, freed pages, string keys" << std::endl;
+    std::remove("data/test_hash_table.db");
+}
+
+void test_stats()
+{
+    std::cout << "\n[16/22] Testing Stats" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    // Test 1: Striped counters lose nothing across threads, histograms report within a bucket
+    std::cout << "  [16.1] Counters and histograms..." << std::endl;
+    minidb::StripedCounter counter;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++)
+    {
+        threads.emplace_back([&counter]()
+                             {
+                                 for (int i = 0; i < 10000; i++)
+                                 {
+                                     counter.Add();
+                                 } });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    assert(counter.Load() == 80000);
+
+    minidb::ConcurrentLatencyHistogram concurrent;
+    for (uint64_t nanos = 1; nanos <= 1000; nanos++)
+    {
+        concurrent.Record(nanos * 1000);
+    }
+    minidb::LatencyHistogram histogram = concurrent.Snapshot();
+    assert(histogram.Count() == 1000 && histogram.Mean() == 500500.0);
+    uint64_t p50 = histogram.Percentile(0.5);
+    uint64_t p99 = histogram.Percentile(0.99);
+    assert(p50 >= 500000 && p50 <= 500000 + 500000 / 16);
+    assert(p99 >= 990000 && p99 <= 990000 + 990000 / 16);
+    assert(histogram.Max() >= 1000000 && histogram.Max() <= 1000000 + 1000000 / 16);
+    histogram.Merge(histogram);
+    assert(histogram.Count() == 2000 && histogram.Percentile(0.5) == p50);
+    assert(minidb::LatencyHistogram().Percentile(0.5) == 0 && minidb::LatencyHistogram().Max() == 0);
+    std::cout << "    ✓ 80000 striped adds counted, p50 " << p50 << "ns, p99 " << p99 << "ns" << std::endl;
+
+    // Test 2: Pool and disk counters follow what the pool did
+    std::cout << "  [16.2] Pool and disk stats..." << std::endl;
+    std::remove("data/test_stats.db");
+    minidb::DiskManager dm("data/test_stats.db");
+    minidb::buffer_pool pool(4, &dm);
+    assert(pool.GetStats().free_frames == 4);
+    minidb::page_id_t ids[8];
+    for (int i = 0; i < 8; i++)
+    {
+        pool.NewPage(&ids[i]);
+        pool.UnpinPage(ids[i], true);
+    }
+    minidb::BufferPoolStats stats = pool.GetStats();
+    assert(stats.evictions == 4 && stats.dirty_evictions == 4 && stats.writebacks == 4);
+    assert(stats.free_frames == 0 && stats.hits == 0 && stats.misses == 0);
+
+    pool.UnpinPage(pool.FetchPage(ids[7])->GetPageId(), false);
+    pool.UnpinPage(pool.FetchPage(ids[0])->GetPageId(), false);
+    for (int i = 0; i < 4; i++)
+    {
+        pool.FetchPage(ids[i]);
+    }
+    bool threw = false;
+    try
+    {
+        pool.FetchPage(ids[5]);
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    assert(threw);
+    for (int i = 0; i < 4; i++)
+    {
+        pool.UnpinPage(ids[i], false);
+    }
+    pool.FlushAllPages();
+
+    stats = pool.GetStats();
+    // Hits on 7 and on 0 after its miss; every miss evicted a dirty page
+    assert(stats.hits == 2 && stats.misses == 4 && stats.pin_failures == 1);
+    assert(stats.fetch_miss_latency.Count() == 5);
+    assert(stats.writebacks == 8 && stats.dirty_evictions == 8);
+    minidb::DiskStats disk = dm.GetStats();
+    assert(disk.read_page_latency.Count() == 4 && disk.write_page_latency.Count() == 8);
+    assert(disk.bytes_read >= 4 * minidb::PAGE_SIZE && disk.reads >= 4);
+    std::cout << "    ✓ " << stats.hits << " hits, " << stats.misses << " misses, " << stats.evictions
+              << " evictions, " << stats.writebacks << " writebacks, " << stats.pin_failures << " pin failure"
+              << std::endl;
+
+    // Test 3: Snapshots render as text and JSON, and the reporter dumps them periodically
+    std::cout << "  [16.3] Dumps..." << std::endl;
+    std::string text = minidb::FormatStats(stats, &disk, minidb::StatsFormat::TEXT);
+    assert(text.find("hits=2 misses=4") != std::string::npos && text.find("| disk: ") != std::string::npos);
+    std::string json = minidb::FormatStats(stats, nullptr, minidb::StatsFormat::JSON);
+    assert(json.front() == '{' && json.back() == '}' && json.find("\"pin_failures\":1") != std::string::npos);
+    assert(json.find("\"fetch_miss\":{\"count\":5,") != std::string::npos && json.find("disk") == std::string::npos);
+
+    std::ostringstream out;
+    {
+        minidb::ReporterOptions options;
+        options.interval = std::chrono::milliseconds(5);
+        options.format = minidb::StatsFormat::JSON;
+        minidb::StatsReporter reporter(&pool, &dm, &out, options);
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        reporter.Report();
+    }
+    std::string dumped = out.str();
+    size_t lines = std::count(dumped.begin(), dumped.end(), '\n');
+    assert(lines >= 2 && dumped.compare(0, 9, "{\"pool\":{") == 0);
+    std::cout << "    ✓ " << lines << " JSON lines dumped, text: " << text.substr(0, 40) << "..." << std::endl;
+    std::remove("data/test_stats.db");
+}
+
+void test_compressed_cache()
+{
+    std::cout << "\n[17/22] Testing CompressedCache" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    // Test 1: The codec round-trips repetitive, text-like and random data, and rejects damage
+    std::cout << "  [17.1] LZ codec..." << std::endl;
+    std::mt19937_64 rng(17);
+    std::vector<char> input(minidb::PAGE_SIZE), packed(minidb::PAGE_SIZE * 2), output(minidb::PAGE_SIZE);
+    size_t text_size = 0;
+    for (int kind = 0; kind < 4; kind++)
+    {
+        for (size_t i = 0; i < input.size(); i++)
+        {
+            switch (kind)
+            {
+            case 0:
+                input[i] = 0;
+                break;
+            case 1:
+                input[i] = "name=user;age=42;city=Springfield;"[i % 34] + (i % 97 == 0 ? 1 : 0);
+                break;
+            case 2:
+                input[i] = static_cast<char>(rng() % 8 == 0 ? rng() : i / 64);
+                break;
+            default:
+                input[i] = static_cast<char>(rng());
+            }
+        }
+        size_t size = minidb::LzCodec::Compress(input.data(), input.size(), packed.data(), packed.size());
+        assert(size > 0 && minidb::LzCodec::Decompress(packed.data(), size, output.data(), output.size()));
+        assert(memcmp(input.data(), output.data(), input.size()) == 0);
+        if (kind == 1)
+        {
+            text_size = size;
+        }
+        if (kind == 3)
+        {
+            // Incompressible data does not fit a smaller buffer, and truncation is caught
+            assert(minidb::LzCodec::Compress(input.data(), input.size(), packed.data(), input.size() / 2) == 0);
+            assert(!minidb::LzCodec::Decompress(packed.data(), size - 1, output.data(), output.size()));
+        }
+    }
+    for (size_t size : {0, 1, 3, 4, 5, 17, 100})
+    {
+        size_t packed_size = minidb::LzCodec::Compress(input.data(), size, packed.data(), packed.size());
+        assert(minidb::LzCodec::Decompress(packed.data(), packed_size, output.data(), size));
+        assert(size == 0 || memcmp(input.data(), output.data(), size) == 0);
+    }
+    std::cout << "    ✓ Round trips exact, text-like page packed to " << text_size << " bytes" << std::endl;
+
+    // Test 2: The cache keeps pages within its budget, evicting the oldest, and gives them back once
+    std::cout << "  [17.2] Slabs and eviction..." << std::endl;
+    using Cache = minidb::CompressedCache;
+    Cache cache(4 * Cache::SLAB_BYTES);
+    auto fill = [](char *data, int64_t seed, int variety)
+    {
+        for (int i = 0; i < minidb::PAGE_SIZE; i++)
+        {
+            data[i] = static_cast<char>((i / variety + seed) % 251);
+        }
+    };
+    std::vector<char> page(minidb::PAGE_SIZE);
+    int stored = 0;
+    for (int64_t id = 0; id < 2000; id++)
+    {
+        fill(page.data(), id, id % 2 == 0 ? 64 : 8);
+        stored += cache.Put(id, page.data()) ? 1 : 0;
+    }
+    for (char &byte : page)
+    {
+        byte = static_cast<char>(rng());
+    }
+    assert(!cache.Put(5000, page.data()));
+    minidb::CompressedCacheStats cache_stats = cache.GetStats();
+    assert(stored == 2000 && cache_stats.rejected == 1 && cache_stats.evictions > 0);
+    assert(cache_stats.slab_bytes <= cache_stats.capacity_bytes && cache_stats.pages < 2000);
+    assert(cache_stats.pages * minidb::PAGE_SIZE > cache_stats.capacity_bytes);
+    assert(!cache.Get(0, page.data()));
+    fill(output.data(), 1999, 8);
+    assert(cache.Get(1999, page.data()) && memcmp(page.data(), output.data(), minidb::PAGE_SIZE) == 0);
+    assert(cache.Touch(1999) && !cache.Touch(0));
+    cache.Erase(1999);
+    assert(!cache.Get(1999, page.data()));
+
+    // A Put announced before an Erase stores nothing, one announced after it does
+    uint64_t stale_ticket = cache.BeginPut(1999);
+    cache.Erase(1999);
+    uint64_t fresh_ticket = cache.BeginPut(1999);
+    assert(!cache.Put(1999, output.data(), stale_ticket) && !cache.Get(1999, page.data()));
+    assert(cache.Put(1999, output.data(), fresh_ticket) && cache.Get(1999, page.data()));
+    std::cout << "    ✓ " << cache_stats.pages << " pages in " << cache_stats.capacity_bytes / 1024 << " KiB ("
+              << cache_stats.compressed_bytes / cache_stats.pages << " bytes each), oldest evicted" << std::endl;
+
+    // Test 3: A pool with a compressed tier serves re-fetches of evicted pages without the disk
+    std::cout << "  [17.3] Second tier under a pool..." << std::endl;
+    std::remove("data/test_compressed_cache.db");
+    minidb::DiskManager dm("data/test_compressed_cache.db");
+    minidb::buffer_pool pool(8, &dm);
+    Cache tier(64 * Cache::SLAB_BYTES);
+    pool.SetSecondaryCache(&tier);
+    const int num_pages = 64;
+    minidb::page_id_t ids[num_pages];
+    for (int i = 0; i < num_pages; i++)
+    {
+        minidb::Page *new_page = pool.NewPage(&ids[i]);
+        fill(new_page->GetData(), ids[i], 32);
+        pool.UnpinPage(ids[i], true);
+    }
+    uint64_t reads_before = dm.GetStats().read_page_latency.Count();
+    for (int i = 0; i < num_pages; i++)
+    {
+        minidb::Page *fetched = pool.FetchPage(ids[i]);
+        fill(output.data(), ids[i], 32);
+        assert(memcmp(fetched->GetData(), output.data(), minidb::PAGE_SIZE) == 0);
+        pool.UnpinPage(ids[i], false);
+    }
+    assert(dm.GetStats().read_page_latency.Count() == reads_before);
+    assert(tier.GetStats().hits == num_pages);
+
+    // Batched fetches use it too, and pages evicted again unchanged are not recompressed
+    std::vector<minidb::Page *> batch(8);
+    pool.FetchPages(ids, 8, batch.data());
+    for (int i = 0; i < 8; i++)
+    {
+        fill(output.data(), ids[i], 32);
+        assert(memcmp(batch[i]->GetData(), output.data(), minidb::PAGE_SIZE) == 0);
+        pool.UnpinPage(ids[i], false);
+    }
+    assert(dm.GetStats().read_page_latency.Count() == reads_before);
+    assert(tier.GetStats().touches > 0);
+
+    // A change written back by FlushPage replaces the tier's copy rather than being shadowed by it
+    minidb::Page *changed = pool.FetchPage(ids[20]);
+    changed->GetData()[100] = 'X';
+    pool.UnpinPage(ids[20], true);
+    pool.FlushPage(ids[20]);
+    for (int i = 0; i < 8; i++)
+    {
+        pool.UnpinPage(pool.FetchPage(ids[40 + i])->GetPageId(), false);
+    }
+    assert(!pool.IsResident(ids[20]) && pool.FetchPage(ids[20])->GetData()[100] == 'X');
+    pool.UnpinPage(ids[20], false);
+    assert(!pool.IsResident(ids[8]) && pool.DeletePage(ids[8]));
+    assert(!tier.Get(ids[8], page.data()));
+    pool.SetSecondaryCache(nullptr);
+    std::cout << "    ✓ " << tier.GetStats().hits << " re-fetches from the tier, no page reads" << std::endl;
+    std::remove("data/test_compressed_cache.db");
+}
+
+void test_lsm_tree()
+{
+    std::cout << "\n[18/22] Testing LsmTree" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    // Test 1: The memtable keeps keys sorted with the latest value, and filters never miss a key
+    std::cout << "  [18.1] MemTable and BloomFilter..." << std::endl;
+    minidb::MemTable mem;
+    mem.Put("banana", "yellow", false);
+    mem.Put("apple", "red", false);
+    mem.Put("cherry", "dark", false);
+    mem.Put("apple", "green", false);
+    mem.Put("banana", "", true);
+    std::string value;
+    bool deleted = false;
+    assert(mem.Get("apple", &value, &deleted) && !deleted && value == "green");
+    assert(mem.Get("banana", &value, &deleted) && deleted);
+    assert(!mem.Get("blueberry", &value, &deleted) && mem.GetCount() == 3);
+    minidb::MemTable::Iterator mem_it(&mem);
+    std::string order;
+    for (mem_it.SeekToFirst(); mem_it.Valid(); mem_it.Next())
+    {
+        order += std::string(mem_it.GetKey()) + (mem_it.IsDeleted() ? "- " : " ");
+    }
+    assert(order == "apple banana- cherry ");
+    mem_it.Seek("b");
+    assert(mem_it.Valid() && mem_it.GetKey() == "banana");
+
+    std::vector<uint64_t> hashes;
+    for (int i = 0; i < 10000; i++)
+    {
+        hashes.push_back(minidb::BloomFilter::Hash("key" + std::to_string(i)));
+    }
+    std::string filter = minidb::BloomFilter::Build(hashes, 10);
+    int false_positives = 0;
+    for (int i = 0; i < 10000; i++)
+    {
+        assert(minidb::BloomFilter::MayContain(filter, hashes[i]));
+        false_positives += minidb::BloomFilter::MayContain(filter, minidb::BloomFilter::Hash("other" + std::to_string(i)));
+    }
+    assert(false_positives < 300);
+    std::cout << "    ✓ Sorted with overwrites and tombstones, filter " << false_positives / 100.0
+              << "% false positives" << std::endl;
+
+    // Test 2: Puts, overwrites and deletes through flushes and compactions match a std::map
+    std::cout << "  [18.2] Flush, compaction, point and range reads..." << std::endl;
+    std::remove("data/test_lsm.db");
+    minidb::page_id_t header_page_id;
+    std::map<std::string, std::string> expected;
+    minidb::LsmOptions options;
+    options.memtable_bytes = 64 * 1024;
+    options.table_bytes = 32 * 1024;
+    options.level1_bytes = 128 * 1024;
+    options.level_multiplier = 4;
+    auto key_of = [](uint64_t n)
+    {
+        char key[16];
+        std::snprintf(key, sizeof(key), "k%08llu", static_cast<unsigned long long>(n));
+        return std::string(key);
+    };
+    {
+        minidb::DiskManager dm("data/test_lsm.db");
+        minidb::LsmTree tree(&dm, options);
+        header_page_id = tree.GetHeaderPageId();
+        std::mt19937_64 rng(18);
+        for (int i = 0; i < 30000; i++)
+        {
+            std::string key = key_of(rng() % 8000);
+            if (rng() % 10 == 0)
+            {
+                tree.Delete(key);
+                expected.erase(key);
+            }
+            else
+            {
+                std::string new_value = key + "#" + std::to_string(i) + std::string(rng() % 40, 'v');
+                tree.Put(key, new_value);
+                expected[key] = new_value;
+            }
+        }
+        tree.WaitForCompaction();
+        minidb::LsmStats lsm_stats = tree.GetStats();
+        assert(lsm_stats.flushes > 0 && lsm_stats.compactions > 0);
+        assert(lsm_stats.level_tables[0] < static_cast<size_t>(options.l0_compaction_trigger));
+        assert(lsm_stats.WriteAmplification() > 1.0);
+
+        for (uint64_t n = 0; n < 8000; n++)
+        {
+            std::string key = key_of(n);
+            auto found = expected.find(key);
+            bool present = tree.Get(key, &value);
+            assert(present == (found != expected.end()));
+            assert(!present || value == found->second);
+        }
+        minidb::LsmTree::Iterator it = tree.NewIterator();
+        auto next = expected.begin();
+        for (it.SeekToFirst(); it.Valid(); it.Next(), ++next)
+        {
+            assert(next != expected.end() && it.GetKey() == next->first && it.GetValue() == next->second);
+        }
+        assert(next == expected.end());
+
+        // Range scan from the middle. An iterator outlives the tables it started on being
+        // compacted away
+        it.Seek(key_of(4000));
+        next = expected.lower_bound(key_of(4000));
+        assert(it.Valid() && it.GetKey() == next->first && it.GetValue() == next->second);
+        tree.Delete(key_of(0));
+        expected.erase(key_of(0));
+        tree.Flush();
+        tree.WaitForCompaction();
+        for (int i = 0; i < 50 && it.Valid(); i++, it.Next(), ++next)
+        {
+            assert(it.GetKey() == next->first);
+        }
+        std::cout << "    ✓ " << expected.size() << " live keys match after " << lsm_stats.flushes << " flushes and "
+                  << lsm_stats.compactions << " compactions, write amplification "
+                  << lsm_stats.WriteAmplification() << std::endl;
+    }
+
+    // Test 3: Reopening finds every table through the manifest, including the last memtable
+    std::cout << "  [18.3] Reopen..." << std::endl;
+    {
+        minidb::DiskManager dm("data/test_lsm.db");
+        minidb::LsmTree tree(&dm, header_page_id, options);
+        assert(!tree.Get(key_of(0), &value));
+        size_t count = 0;
+        minidb::LsmTree::Iterator it = tree.NewIterator();
+        for (it.SeekToFirst(); it.Valid(); it.Next())
+        {
+            assert(expected.at(std::string(it.GetKey())) == it.GetValue());
+            count++;
+        }
+        assert(count == expected.size());
+
+        // Entries must fit a table block
+        bool threw = false;
+        try
+        {
+            tree.Put("big", std::string(minidb::LsmTree::MAX_ENTRY_BYTES, 'x'));
+        }
+        catch (const std::runtime_error &)
+        {
+            threw = true;
+        }
+        assert(threw);
+        std::cout << "    ✓ " << count << " keys back from header page " << header_page_id << std::endl;
+    }
+    std::remove("data/test_lsm.db");
+}
+
+/// @brief Checks every kernel of one type at one SIMD level against plain loops, over lengths
+/// around the 64-value word boundaries
+template <typename T>
+static void check_scan_kernels(std::mt19937_64 &rng)
+{
+    const minidb::CompareOp ops[] = {minidb::CompareOp::EQ, minidb::CompareOp::NE, minidb::CompareOp::LT,
+                                     minidb::CompareOp::LE, minidb::CompareOp::GT, minidb::CompareOp::GE};
+    for (size_t count : {0, 1, 63, 64, 65, 200, 1000})
+    {
+        // Halves keep double sums exact, so every order of adding gives the same total
+        std::vector<T> values(count);
+        for (T &v : values)
+        {
+            v = static_cast<T>(static_cast<int64_t>(rng() % 101) - 50) / (std::is_floating_point<T>::value ? 2 : 1);
+        }
+        T operand = count > 0 ? values[count / 2] : T(0);
+        std::vector<uint64_t> selection((count + 63) / 64 + 1, ~0ull);
+        for (minidb::CompareOp op : ops)
+        {
+            uint64_t selected = minidb::ScanKernels::Filter<T>(values.data(), count, op, operand, selection.data());
+            uint64_t expected_selected = 0;
+            for (size_t i = 0; i < count; i++)
+            {
+                T v = values[i];
+                bool pass = op == minidb::CompareOp::EQ   ? v == operand
+                            : op == minidb::CompareOp::NE ? v != operand
+                            : op == minidb::CompareOp::LT ? v < operand
+                            : op == minidb::CompareOp::LE ? v <= operand
+                            : op == minidb::CompareOp::GT ? v > operand
+                                                          : v >= operand;
+                assert(((selection[i / 64] >> (i % 64)) & 1) == pass);
+                expected_selected += pass;
+            }
+            assert(selected == expected_selected);
+            if (count % 64 != 0)
+            {
+                assert((selection[count / 64] >> (count % 64)) == 0);
+            }
+
+            for (const uint64_t *filter : {static_cast<const uint64_t *>(nullptr), static_cast<const uint64_t *>(selection.data())})
+            {
+                minidb::ColumnAggregate<T> result;
+                minidb::ScanKernels::Aggregate<T>(values.data(), count, filter, &result);
+                minidb::ColumnAggregate<T> expected;
+                for (size_t i = 0; i < count; i++)
+                {
+                    if (filter == nullptr || ((filter[i / 64] >> (i % 64)) & 1))
+                    {
+                        expected.count++;
+                        expected.sum += values[i];
+                        expected.min = std::min(expected.min, values[i]);
+                        expected.max = std::max(expected.max, values[i]);
+                    }
+                }
+                assert(result.count == expected.count && result.sum == expected.sum);
+                assert(result.min == expected.min && result.max == expected.max);
+            }
+        }
+    }
+}
+
+void test_pax_scan()
+{
+    std::cout << "\n[19/22] Testing PAX pages and scan kernels" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    // Test 1: Each SIMD level gives the scalar answers, NaN included
+    std::cout << "  [19.1] Scan kernels..." << std::endl;
+    minidb::SimdLevel best = minidb::ScanKernels::DetectSimdLevel();
+    std::mt19937_64 rng(19);
+    for (minidb::SimdLevel level : {minidb::SimdLevel::SCALAR, minidb::SimdLevel::SSE42, minidb::SimdLevel::AVX2})
+    {
+        minidb::ScanKernels::SetSimdLevel(level);
+        check_scan_kernels<int32_t>(rng);
+        check_scan_kernels<int64_t>(rng);
+        check_scan_kernels<double>(rng);
+
+        std::vector<double> with_nan(130, 1.0);
+        with_nan[3] = with_nan[100] = std::numeric_limits<double>::quiet_NaN();
+        std::vector<uint64_t> selection(3);
+        assert(minidb::ScanKernels::Filter<double>(with_nan.data(), 130, minidb::CompareOp::EQ, 1.0,
+                                                   selection.data()) == 128);
+        assert(minidb::ScanKernels::Filter<double>(with_nan.data(), 130, minidb::CompareOp::GE, 1.0,
+                                                   selection.data()) == 130);
+        assert(minidb::ScanKernels::Filter<double>(with_nan.data(), 130, minidb::CompareOp::LT, 2.0,
+                                                   selection.data()) == 128);
+        std::vector<uint64_t> other = {~0ull, 0, ~0ull};
+        assert(minidb::ScanKernels::And(selection.data(), other.data(), 130) == 64 - 1 + 2);
+
+        // Aggregates skip NaN for min and max wherever it falls in a vector
+        std::vector<double> spread(130, 100.0);
+        spread[0] = 1.0;
+        spread[4] = spread[65] = std::numeric_limits<double>::quiet_NaN();
+        spread[8] = 50.0;
+        spread[70] = 200.0;
+        minidb::ColumnAggregate<double> nan_result;
+        minidb::ScanKernels::Aggregate<double>(spread.data(), 130, nullptr, &nan_result);
+        assert(nan_result.count == 130 && nan_result.min == 1.0 && nan_result.max == 200.0);
+        std::vector<uint64_t> all = {~0ull, ~0ull, 0x3};
+        minidb::ColumnAggregate<double> selected_result;
+        minidb::ScanKernels::Aggregate<double>(with_nan.data(), 130, all.data(), &selected_result);
+        assert(selected_result.min == 1.0 && selected_result.max == 1.0);
+    }
+    minidb::ScanKernels::SetSimdLevel(minidb::SimdLevel::AVX2);
+    assert(minidb::ScanKernels::GetSimdLevel() == best);
+    std::cout << "    ✓ Filter, Aggregate and And agree at every level up to "
+              << (best == minidb::SimdLevel::AVX2 ? "AVX2" : best == minidb::SimdLevel::SSE42 ? "SSE4.2" : "scalar")
+              << std::endl;
+
+    // Test 2: A page fills its minipages, tracking nulls and zone maps
+    std::cout << "  [19.2] PaxPage..." << std::endl;
+    const std::vector<minidb::PaxType> schema = {minidb::PaxType::INT32, minidb::PaxType::INT64,
+                                                 minidb::PaxType::DOUBLE};
+    assert(minidb::PaxPage::RecordSize(schema) == 20);
+    assert(minidb::PaxPage::Capacity(std::vector<minidb::PaxType>(17, minidb::PaxType::INT32)) == 0);
+    minidb::Page raw;
+    minidb::PaxPage pax_page(raw.GetData());
+    pax_page.Init(schema);
+    char record[20];
+    uint32_t rows = 0;
+    for (;; rows++)
+    {
+        int32_t a = static_cast<int32_t>(rows) - 100;
+        int64_t b = static_cast<int64_t>(rows) * 1000000007LL;
+        double c = rows * 0.5;
+        memcpy(record, &a, 4);
+        memcpy(record + 4, &b, 8);
+        memcpy(record + 12, &c, 8);
+        if (!pax_page.Append(record, rows % 7 == 0 ? 4 : 0))
+        {
+            break;
+        }
+    }
+    assert(rows == pax_page.GetCapacity() && rows == minidb::PaxPage::Capacity(schema) && rows > 150);
+    for (uint32_t column = 0; column < 3; column++)
+    {
+        assert(reinterpret_cast<uintptr_t>(pax_page.GetColumn<char>(column)) % 64 == 0);
+    }
+    assert(pax_page.GetColumn<int32_t>(0)[5] == -95 && pax_page.GetColumn<int64_t>(1)[5] == 5000000035LL);
+    assert(pax_page.GetColumn<double>(2)[7] == 0 && (pax_page.GetValidity(2)[0] & 0x81) == 0);
+    minidb::PaxZoneMap zone = pax_page.GetZoneMap(0);
+    assert(zone.min.i == -100 && zone.max.i == static_cast<int64_t>(rows) - 101 && zone.nulls == 0);
+    zone = pax_page.GetZoneMap(2);
+    assert(zone.nulls == (rows + 6) / 7 && zone.min.d == 0.5 && zone.rows == rows);
+    assert(zone.MayMatch(minidb::PaxType::DOUBLE, minidb::CompareOp::LT, {0, 1.0}));
+    assert(!zone.MayMatch(minidb::PaxType::DOUBLE, minidb::CompareOp::LT, {0, 0.5}));
+    assert(!zone.MayMatch(minidb::PaxType::DOUBLE, minidb::CompareOp::GT, {0, 1e9}));
+    std::cout << "    ✓ " << rows << " rows of " << minidb::PaxPage::RecordSize(schema) << " bytes per page, "
+              << zone.nulls << " nulls in column 2" << std::endl;
+
+    // Test 3: Table scans skip pages by zone map and match a row-at-a-time answer, after reopening too
+    std::cout << "  [19.3] PaxTable aggregates..." << std::endl;
+    std::remove("data/test_pax.db");
+    const int32_t table_rows = 20000;
+    auto row_b = [](int32_t i) { return static_cast<int64_t>((i * 7919) % 1000) - 500; };
+    auto row_c = [](int32_t i) { return (i % 1000) * 0.25; };
+    int64_t expected_sum = 0;
+    uint64_t expected_count = 0;
+    int64_t expected_min = INT64_MAX, expected_max = INT64_MIN;
+    for (int32_t i = 5000; i < 7000; i++)
+    {
+        if (i % 10 != 0 && row_c(i) > 100.0)
+        {
+            expected_count++;
+            expected_sum += row_b(i);
+            expected_min = std::min(expected_min, row_b(i));
+            expected_max = std::max(expected_max, row_b(i));
+        }
+    }
+    const std::vector<minidb::PaxPredicate> predicates = {{0, minidb::CompareOp::GE, {5000, 0}},
+                                                          {0, minidb::CompareOp::LT, {7000, 0}},
+                                                          {2, minidb::CompareOp::GT, {0, 100.0}}};
+    minidb::page_id_t header_page_id;
+    {
+        minidb::DiskManager dm("data/test_pax.db");
+        minidb::buffer_pool pool(16, &dm);
+        minidb::PaxTable table(&pool, schema);
+        header_page_id = table.GetHeaderPageId();
+        for (int32_t i = 0; i < table_rows; i++)
+        {
+            int64_t b = row_b(i);
+            double c = row_c(i);
+            memcpy(record, &i, 4);
+            memcpy(record + 4, &b, 8);
+            memcpy(record + 12, &c, 8);
+            table.Append(record, i % 10 == 0 ? 2 : 0);
+        }
+        assert(table.GetRowCount() == static_cast<uint64_t>(table_rows));
+
+        minidb::PaxAggregate result = table.Aggregate(predicates, 1);
+        assert(result.count == expected_count && result.sum.i == expected_sum);
+        assert(result.min.i == expected_min && result.max.i == expected_max);
+        assert(result.pages_skipped > 0 && result.pages_scanned + result.pages_skipped == table.GetPageCount());
+        assert(result.pages_scanned <= 2000 / rows + 2);
+
+        minidb::PaxAggregate all = table.Aggregate({}, 0);
+        assert(all.count == static_cast<uint64_t>(table_rows) && all.sum.i == int64_t(table_rows) * (table_rows - 1) / 2);
+        assert(all.min.i == 0 && all.max.i == table_rows - 1 && all.pages_skipped == 0);
+
+        bool threw = false;
+        try
+        {
+            table.Aggregate({{0, minidb::CompareOp::LT, {int64_t(1) << 40, 0}}}, 0);
+        }
+        catch (const std::invalid_argument &)
+        {
+            threw = true;
+        }
+        assert(threw);
+        pool.FlushAllPages();
+        std::cout << "    ✓ " << result.count << " rows match, " << result.pages_skipped << " of "
+                  << table.GetPageCount() << " pages skipped by zone map" << std::endl;
+    }
+    {
+        minidb::DiskManager dm("data/test_pax.db");
+        minidb::buffer_pool pool(16, &dm);
+        minidb::PaxTable table(&pool, header_page_id);
+        assert(table.GetRowCount() == static_cast<uint64_t>(table_rows) && table.GetSchema() == schema);
+        minidb::PaxAggregate result = table.Aggregate(predicates, 1);
+        assert(result.count == expected_count && result.sum.i == expected_sum && result.pages_skipped > 0);
+        minidb::PaxAggregate doubles = table.Aggregate({{2, minidb::CompareOp::GE, {0, 249.0}}}, 2);
+        assert(doubles.count == static_cast<uint64_t>(table_rows / 1000 * 4) && doubles.max.d == 249.75);
+        std::cout << "    ✓ " << table.GetRowCount() << " rows back from header page " << header_page_id << std::endl;
+    }
+    std::remove("data/test_pax.db");
+}
+
+void test_executor()
+{
+    std::cout << "\n[20/22] Testing the morsel-driven executor" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    // Test 1: Every task runs once on some worker, and the first failure reaches the caller
+    std::cout << "  [20.1] WorkStealingPool..." << std::endl;
+    minidb::WorkStealingPool workers(4);
+    assert(workers.GetThreadCount() == 4);
+    std::atomic<uint64_t> sum{0};
+    std::atomic<bool> bad_worker{false};
+    workers.ParallelFor(1000, [&](size_t index, size_t worker)
+                        {
+                            sum += index;
+                            if (worker >= 4)
+                            {
+                                bad_worker = true;
+                            }
+                        });
+    assert(sum == 999 * 1000 / 2 && !bad_worker);
+    bool threw = false;
+    try
+    {
+        workers.ParallelFor(100, [](size_t index, size_t)
+                            {
+                                if (index == 50)
+                                {
+                                    throw std::runtime_error("task 50");
+                                }
+                            });
+    }
+    catch (const std::runtime_error &e)
+    {
+        threw = std::string(e.what()) == "task 50";
+    }
+    assert(threw);
+    sum = 0;
+    workers.ParallelFor(10, [&](size_t index, size_t) { sum += index; });
+    assert(sum == 45);
+    std::cout << "    ✓ ParallelFor ran every task, " << workers.GetSteals() << " stolen" << std::endl;
+
+    // Test 2: Scan -> filter -> project -> group by on 4 workers matches a row-at-a-time answer
+    std::cout << "  [20.2] Filter, project and hash aggregate..." << std::endl;
+    std::remove("data/test_executor.db");
+    minidb::DiskManager dm("data/test_executor.db");
+    minidb::buffer_pool pool(64, &dm);
+    const std::vector<minidb::PaxType> fact_schema = {minidb::PaxType::INT32, minidb::PaxType::INT64,
+                                                      minidb::PaxType::DOUBLE, minidb::PaxType::INT32};
+    const int32_t fact_rows = 30000;
+    auto fact_b = [](int32_t i) { return static_cast<int64_t>((i * 7919) % 1000) - 500; };
+    auto fact_c = [](int32_t i) { return (i % 97) * 1.0; };
+    auto fact_g = [](int32_t i) { return i % 37; };
+    minidb::PaxTable fact(&pool, fact_schema);
+    char record[24];
+    for (int32_t i = 0; i < fact_rows; i++)
+    {
+        int64_t b = fact_b(i);
+        double c = fact_c(i);
+        int32_t g = fact_g(i);
+        memcpy(record, &i, 4);
+        memcpy(record + 4, &b, 8);
+        memcpy(record + 12, &c, 8);
+        memcpy(record + 20, &g, 4);
+        fact.Append(record, i % 13 == 0 ? 2 : 0);
+    }
+
+    struct Expected
+    {
+        int64_t count = 0, sum = 0, max = INT64_MIN;
+        double min = std::numeric_limits<double>::max();
+    };
+    std::map<int64_t, Expected> expected;
+    for (int32_t i = 1000; i < fact_rows; i++)
+    {
+        if (fact_c(i) < 50.0)
+        {
+            Expected &group = expected[fact_g(i)];
+            group.min = std::min(group.min, fact_c(i));
+            if (i % 13 != 0)
+            {
+                group.count++;
+                group.sum += fact_b(i);
+                group.max = std::max(group.max, fact_b(i));
+            }
+        }
+    }
+
+    minidb::PaxScan fact_scan(&fact, &pool, 4);
+    minidb::Filter filter({{0, minidb::CompareOp::GE, {1000, 0}}, {2, minidb::CompareOp::LT, {0, 50.0}}});
+    minidb::Project project({3, 1, 2});
+    minidb::HashAggregate aggregate(0, {{minidb::AggregateFunc::COUNT, 1},
+                                        {minidb::AggregateFunc::SUM, 1},
+                                        {minidb::AggregateFunc::MIN, 2},
+                                        {minidb::AggregateFunc::MAX, 1}});
+    minidb::Pipeline pipeline(&fact_scan, {&filter, &project}, &aggregate);
+    pipeline.Execute(&workers);
+    assert(pipeline.GetSinkChunks() > 0 && aggregate.GetResults().size() == expected.size());
+    for (const minidb::AggregateRow &row : aggregate.GetResults())
+    {
+        const Expected &group = expected.at(row.key);
+        assert(row.values[0].i == group.count && row.values[1].i == group.sum);
+        assert(row.values[2].d == group.min && row.values[3].i == group.max);
+    }
+    // Reruns start from empty groups
+    pipeline.Execute(&workers);
+    assert(aggregate.GetResults().size() == expected.size() &&
+           aggregate.GetResults()[0].values[0].i == expected.begin()->second.count);
+
+    minidb::HashAggregate by_double(2, {{minidb::AggregateFunc::COUNT, 0}});
+    minidb::Pipeline bad_pipeline(&fact_scan, {}, &by_double);
+    threw = false;
+    try
+    {
+        bad_pipeline.Execute(&workers);
+    }
+    catch (const std::invalid_argument &)
+    {
+        threw = true;
+    }
+    assert(threw);
+    std::cout << "    ✓ " << aggregate.GetResults().size() << " groups from " << fact.GetPageCount() << " pages in "
+              << fact_scan.GetMorselCount() << " morsels" << std::endl;
+
+    // Test 3: Hash join build and probe, duplicate build keys included, then a group by
+    std::cout << "  [20.3] Hash join..." << std::endl;
+    const std::vector<minidb::PaxType> dim_schema = {minidb::PaxType::INT32, minidb::PaxType::INT32};
+    minidb::PaxTable dim(&pool, dim_schema);
+    std::multimap<int32_t, int32_t> dim_rows;
+    for (int32_t key = 0; key < 30; key++)
+    {
+        for (int32_t copy = 0; copy < (key % 2 == 0 ? 2 : 1); copy++)
+        {
+            int32_t category = (key + copy) % 5;
+            memcpy(record, &key, 4);
+            memcpy(record + 4, &category, 4);
+            dim.Append(record, 0);
+            dim_rows.emplace(key, category);
+        }
+    }
+    minidb::PaxScan dim_scan(&dim, &pool, 1);
+    minidb::HashJoinBuild build(0, {1});
+    minidb::Pipeline build_pipeline(&dim_scan, {}, &build);
+    build_pipeline.Execute(&workers);
+    assert(build.GetRowCount() == dim_rows.size());
+
+    std::map<int64_t, std::pair<int64_t, int64_t>> expected_join;
+    for (int32_t i = 0; i < 5000; i++)
+    {
+        auto range = dim_rows.equal_range(fact_g(i));
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            std::pair<int64_t, int64_t> &group = expected_join[it->second];
+            group.first++;
+            group.second += i % 13 == 0 ? 0 : fact_b(i);
+        }
+    }
+
+    minidb::Filter fact_filter({{0, minidb::CompareOp::LT, {5000, 0}}});
+    minidb::HashJoinProbe probe(&build, 3);
+    minidb::HashAggregate by_category(4, {{minidb::AggregateFunc::COUNT, 0}, {minidb::AggregateFunc::SUM, 1}});
+    minidb::Pipeline probe_pipeline(&fact_scan, {&fact_filter, &probe}, &by_category);
+    probe_pipeline.Execute(&workers);
+    assert(by_category.GetResults().size() == expected_join.size());
+    int64_t joined = 0;
+    for (const minidb::AggregateRow &row : by_category.GetResults())
+    {
+        const std::pair<int64_t, int64_t> &group = expected_join.at(row.key);
+        assert(row.values[0].i == group.first && row.values[1].i == group.second);
+        joined += row.values[0].i;
+    }
+    std::cout << "    ✓ " << joined << " joined rows in " << by_category.GetResults().size() << " categories"
+              << std::endl;
+    std::remove("data/test_executor.db");
+}
+
+/// Fetches a page from a coroutine, reads the tag at its start and unpins it
+minidb::Task<int32_t> async_read_tag(minidb::buffer_pool *pool, minidb::AsyncContext *context,
+                                     minidb::page_id_t page_id)
+{
+    minidb::Page *page = co_await pool->FetchPageAsync(page_id, context);
+    int32_t tag;
+    memcpy(&tag, page->GetData(), sizeof(tag));
+    pool->UnpinPage(page_id, false);
+    co_return tag;
+}
+
+/// Looks up count pages first, first + stride, ... and counts pages whose tag is not their ID
+minidb::Task<void> async_lookups(minidb::buffer_pool *pool, minidb::AsyncContext *context, int32_t first,
+                                 int32_t count, int32_t stride, int32_t pages, std::atomic<int> *mismatches)
+{
+    for (int32_t i = 0; i < count; i++)
+    {
+        minidb::page_id_t page_id = (first + i * stride) % pages;
+        if (co_await async_read_tag(pool, context, page_id) != page_id)
+        {
+            (*mismatches)++;
+        }
+    }
+}
+
+/// Fetches a page from a coroutine and keeps it pinned
+minidb::Task<void> async_hold(minidb::buffer_pool *pool, minidb::AsyncContext *context, minidb::page_id_t page_id,
+                              std::vector<minidb::Page *> *held)
+{
+    held->push_back(co_await pool->FetchPageAsync(page_id, context));
+}
+
+/// Changes a page through the blocking FetchPage, from inside a coroutine
+minidb::Task<void> sync_stamp(minidb::buffer_pool *pool, minidb::page_id_t page_id)
+{
+    minidb::Page *page = pool->FetchPage(page_id);
+    memcpy(page->GetData() + 4, "sync", 4);
+    pool->UnpinPage(page_id, true);
+    co_return;
+}
+
+void test_async_fetch()
+{
+    std::cout << "\n[21/22] Testing coroutine FetchPageAsync" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    std::remove("data/test_async_fetch.db");
+    const int32_t num_pages = 256;
+    minidb::DiskManager dm("data/test_async_fetch.db");
+    {
+        minidb::Page page;
+        for (int32_t i = 0; i < num_pages; i++)
+        {
+            assert(dm.AllocatePage() == i);
+            memcpy(page.GetData(), &i, sizeof(i));
+            dm.WritePage(i, page.GetData());
+        }
+    }
+    minidb::buffer_pool pool(32, &dm);
+
+    // Test 1: Concurrent misses on one page share a single read and all resume with it
+    std::cout << "  [21.1] Miss deduplication..." << std::endl;
+    minidb::AsyncContext context(&pool, 16);
+    std::cout << "    Engine: " << context.GetEngineName() << std::endl;
+    std::vector<minidb::Page *> held;
+    for (int i = 0; i < 10; i++)
+    {
+        context.Spawn(async_hold(&pool, &context, 7, &held));
+    }
+    context.Run();
+    minidb::BufferPoolStats stats = pool.GetStats();
+    assert(held.size() == 10 && context.GetReads() == 1);
+    assert(stats.misses == 1 && stats.coalesced_misses == 9 && stats.hits == 0);
+    for (minidb::Page *page : held)
+    {
+        int32_t tag;
+        memcpy(&tag, page->GetData(), sizeof(tag));
+        assert(page == held[0] && tag == 7);
+    }
+    assert(held[0]->GetPinCount() == 10 && pool.IsResident(7));
+    for (size_t i = 0; i < held.size(); i++)
+    {
+        pool.UnpinPage(7, false);
+    }
+    std::cout << "    ✓ 10 waiters, 1 read, " << stats.coalesced_misses << " coalesced" << std::endl;
+
+    // Test 2: Lookups in flight on one thread, over 8x more pages than frames. Each coroutine
+    // holds at most one frame, so there are fewer of them than frames
+    std::cout << "  [21.2] Many lookups per thread..." << std::endl;
+    std::atomic<int> mismatches{0};
+    uint64_t reads_before = context.GetReads();
+    for (int32_t c = 0; c < 24; c++)
+    {
+        context.Spawn(async_lookups(&pool, &context, c * 7, 100, 13, num_pages, &mismatches));
+    }
+    context.Run();
+    assert(mismatches == 0 && context.GetReads() > reads_before);
+    for (minidb::page_id_t page_id = 0; page_id < num_pages; page_id++)
+    {
+        minidb::Page *page = pool.FetchPage(page_id);
+        int32_t tag;
+        memcpy(&tag, page->GetData(), sizeof(tag));
+        assert(tag == page_id && page->GetPinCount() == 1);
+        pool.UnpinPage(page_id, false);
+    }
+    std::cout << "    ✓ 2400 lookups by 24 coroutines, " << context.GetReads() - reads_before << " reads" << std::endl;
+
+    // Test 3: A page loaded by the blocking path during the read wins over the older copy
+    std::cout << "  [21.3] Read racing a blocking fetch..." << std::endl;
+    minidb::page_id_t raced = 0;
+    while (pool.IsResident(raced))
+    {
+        raced++;
+    }
+    held.clear();
+    context.Spawn(async_hold(&pool, &context, raced, &held));
+    context.Spawn(sync_stamp(&pool, raced));
+    context.Run();
+    assert(held.size() == 1 && memcmp(held[0]->GetData() + 4, "sync", 4) == 0 && held[0]->GetPinCount() == 1);
+    pool.UnpinPage(raced, false);
+    std::cout << "    ✓ Stale read of page " << raced << " dropped for the resident copy" << std::endl;
+
+    // Test 4: Contexts on several threads share reads of the same pages
+    std::cout << "  [21.4] Contexts on 4 threads..." << std::endl;
+    stats = pool.GetStats();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([&]()
+                             {
+                                 minidb::AsyncContext local(&pool, 32);
+                                 for (int32_t c = 0; c < 6; c++)
+                                 {
+                                     local.Spawn(async_lookups(&pool, &local, c * 16, 100, 5, num_pages, &mismatches));
+                                 }
+                                 local.Run();
+                             });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    assert(mismatches == 0);
+    std::cout << "    ✓ 2400 lookups, " << pool.GetStats().coalesced_misses - stats.coalesced_misses
+              << " coalesced across threads" << std::endl;
+
+    // Test 5: Errors reach the coroutine, then Run, and no frame leaks
+    std::cout << "  [21.5] Pin failure..." << std::endl;
+    minidb::buffer_pool small(4, &dm);
+    minidb::AsyncContext small_context(&small);
+    held.clear();
+    for (minidb::page_id_t page_id = 0; page_id < 5; page_id++)
+    {
+        small_context.Spawn(async_hold(&small, &small_context, page_id, &held));
+    }
+    bool threw = false;
+    try
+    {
+        small_context.Run();
+    }
+    catch (const std::runtime_error &)
+    {
+        threw = true;
+    }
+    assert(threw && held.size() == 4 && small.GetStats().pin_failures == 1);
+    for (minidb::Page *page : held)
+    {
+        small.UnpinPage(page->GetPageId(), false);
+    }
+    held.clear();
+    small_context.Spawn(async_hold(&small, &small_context, 4, &held));
+    small_context.Run();
+    assert(held.size() == 1);
+    small.UnpinPage(4, false);
+    std::cout << "    ✓ 4 of 5 pinned, the fifth threw" << std::endl;
+    std::remove("data/test_async_fetch.db");
+}
+
+void test_mmap_pool()
+{
+    std::cout << "\n[22/22] Testing mmap-backed page store" << std::endl;
+    std::cout << "-------------------------------" << std::endl;
+
+    // 64-page segments, so the mapping spans several segment files
+    const char *file = "data/test_mmap_pool.db";
+    auto remove_segments = [&]()
+    {
+        std::remove(file);
+        for (int i = 1; i <= 8; i++)
+        {
+            std::remove((std::string(file) + "." + std::to_string(i)).c_str());
+        }
+    };
+    remove_segments();
+    minidb::StorageOptions small_segments;
+    small_segments.segment_bytes = 64 * minidb::PAGE_SIZE;
+    small_segments.preallocate = false;
+    const int32_t num_pages = 300;
+    minidb::DiskManager dm(file, false, small_segments);
+    {
+        minidb::Page page;
+        for (int32_t i = 0; i < num_pages; i++)
+        {
+            assert(dm.AllocatePage() == i);
+            memcpy(page.GetData(), &i, sizeof(i));
+            dm.WritePage(i, page.GetData());
+        }
+    }
+
+    // Test 1: Pages read in place, one descriptor per page, writes refused
+    std::cout << "  [22.1] Read-only mapping..." << std::endl;
+    {
+        minidb::mmap_pool pool(&dm);
+        assert(pool.GetPageCount() == num_pages && !pool.IsWritable());
+        for (int32_t i = 0; i < num_pages; i++)
+        {
+            minidb::Page *page = pool.FetchPage(i);
+            int32_t tag;
+            memcpy(&tag, page->GetData(), sizeof(tag));
+            assert(tag == i && page->GetPageId() == i && page->GetPinCount() == 1);
+            assert(reinterpret_cast<uintptr_t>(page->GetData()) % minidb::PAGE_ALIGNMENT == 0);
+            assert(pool.IsResident(i));
+            pool.UnpinPage(i, false);
+        }
+        minidb::Page *first = pool.FetchPage(42);
+        assert(pool.FetchPage(42) == first && first->GetPinCount() == 2);
+        pool.UnpinPage(42, false);
+        bool threw = false;
+        try
+        {
+            pool.UnpinPage(42, true);
+        }
+        catch (const std::runtime_error &)
+        {
+            threw = true;
+        }
+        assert(threw && first->GetPinCount() == 1);
+        pool.UnpinPage(42, false);
+        threw = false;
+        try
+        {
+            pool.FetchPage(num_pages);
+        }
+        catch (const std::out_of_range &)
+        {
+            threw = true;
+        }
+        assert(threw);
+        minidb::MmapPoolStats stats = pool.GetStats();
+        assert(stats.fetches == num_pages + 2 && stats.pages_touched == num_pages);
+    }
+    std::cout << "    ✓ " << num_pages << " pages over 5 segments, dirty unpin and page " << num_pages
+              << " rejected" << std::endl;
+
+    // Test 2: Threads racing to create descriptors, with scan and lookup hints
+    std::cout << "  [22.2] Concurrent fetches..." << std::endl;
+    {
+        minidb::MmapOptions options;
+        options.populate = true;
+        minidb::mmap_pool pool(&dm, options);
+        pool.Advise(minidb::MmapAdvice::SEQUENTIAL, 0, num_pages);
+        pool.Prefetch(200, 1000);
+        std::atomic<int> mismatches{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; t++)
+        {
+            threads.emplace_back([&, t]()
+                                 {
+                                     for (int32_t n = 0; n < 1000; n++)
+                                     {
+                                         int32_t page_id = (n * 37 + t * 11) % num_pages;
+                                         minidb::Page *page = pool.FetchPage(page_id);
+                                         int32_t tag;
+                                         memcpy(&tag, page->GetData(), sizeof(tag));
+                                         if (tag != page_id)
+                                         {
+                                             mismatches++;
+                                         }
+                                         pool.UnpinPage(page_id, false);
+                                     }
+                                 });
+        }
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        assert(mismatches == 0 && pool.GetStats().fetches == 4000);
+        for (int32_t i = 0; i < num_pages; i++)
+        {
+            minidb::Page *page = pool.FetchPage(i);
+            assert(page->GetPinCount() == 1);
+            pool.UnpinPage(i, false);
+        }
+    }
+    std::cout << "    ✓ 4000 lookups on 4 threads" << std::endl;
+
+    // Test 3: Writes go to the file on flush, adjacent pages in one msync
+    std::cout << "  [22.3] Writable mapping..." << std::endl;
+    {
+        minidb::MmapOptions options;
+        options.writable = true;
+        minidb::mmap_pool pool(&dm, options);
+        const int32_t changed[] = {5, 6, 7, 100};
+        for (int32_t page_id : changed)
+        {
+            minidb::Page *page = pool.FetchPage(page_id);
+            memcpy(page->GetData() + 4, "mmap", 4);
+            pool.UnpinPage(page_id, true);
+        }
+        pool.FlushAllPages();
+        minidb::MmapPoolStats stats = pool.GetStats();
+        assert(stats.msync_calls == 2 && stats.pages_synced == 4);
+        minidb::Page page;
+        for (int32_t page_id : changed)
+        {
+            dm.ReadPage(page_id, page.GetData());
+            int32_t tag;
+            memcpy(&tag, page.GetData(), sizeof(tag));
+            assert(tag == page_id && memcmp(page.GetData() + 4, "mmap", 4) == 0);
+        }
+        dm.ReadPage(8, page.GetData());
+        assert(memcmp(page.GetData() + 4, "mmap", 4) != 0);
+
+        minidb::Page *again = pool.FetchPage(6);
+        assert(!again->IsDirty());
+        memcpy(again->GetData() + 4, "next", 4);
+        pool.UnpinPage(6, true);
+        pool.FlushPage(6);
+        pool.FlushPage(6);
+        assert(pool.GetStats().msync_calls == 3);
+        dm.ReadPage(6, page.GetData());
+        assert(memcmp(page.GetData() + 4, "next", 4) == 0);
+    }
+    std::cout << "    ✓ 4 pages written back in 2 msync calls, re-flush skipped when clean" << std::endl;
+    remove_segments();
+}